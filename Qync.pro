@@ -1,6 +1,10 @@
 QT += widgets
 CONFIG += c++1z
 
+equals(QT_MAJOR_VERSION, 5):lessThan(QT_MINOR_VERSION, 10) {
+    error("Qync requires Qt 5.10 or later")
+}
+
 #QMAKE_CXXFLAGS += -std=c++1z
 DEFINES += QT_NO_KEYWORDS QT_DEPRECATED_WARNINGS QT_DISABLE_DEPRECATED_BEFORE=0x050701
 
@@ -13,15 +17,52 @@ HEADERS += \
     src/preferencesdialogue.h \
     src/preset.h \
     src/process.h \
+    src/rsyncoutputparser.h \
+    src/processworker.h \
+    src/logfilewriter.h \
+    src/shardplanner.h \
+    src/sourcescanner.h \
+    src/sourceindex.h \
+    src/presetwatcher.h \
+    src/presetindex.h \
+    src/rsynccapabilities.h \
+    src/rsyncprobe.h \
+    src/transfertelemetry.h \
+    src/telemetrywriter.h \
+    src/instrumentation.h \
+    src/eventloopmonitor.h \
+    src/bandwidthschedule.h \
+    src/adaptivebandwidth.h \
+    src/snapshotpruner.h \
+    src/snapshotset.h \
+    src/localcopier.h \
+    src/pathstore.h \
+    src/directorylister.h \
+    src/remoteshell.h \
+    src/remotelister.h \
+    src/presetproperties.h \
+    src/presetbundlereader.h \
+    src/presetbundlewriter.h \
+    src/jobscheduler.h \
+    src/cliapplication.h \
+    src/applicationinfo.h \
+    src/spscqueue.h \
     src/processdialogue.h \
+    src/transferlogmodel.h \
+    src/changesetmodel.h \
     src/aboutdialogue.h \
     src/sourcedestinationwidget.h \
+    src/pathcompleter.h \
     src/units.h \
     src/synchronisewhatcombo.h \
     src/processwidget.h \
+    src/progressaggregator.h \
     src/presetcombo.h \
     src/presetmenu.h \
+    src/presetlistmodel.h \
     src/notificationwidget.h \
+    src/transferreportdialogue.h \
+    src/diagnosticsdialogue.h \
     src/types.h
 
 SOURCES += \
@@ -34,14 +75,48 @@ SOURCES += \
     src/preferencesdialogue.cpp \
     src/preset.cpp \
     src/process.cpp \
+    src/rsyncoutputparser.cpp \
+    src/processworker.cpp \
+    src/logfilewriter.cpp \
+    src/shardplanner.cpp \
+    src/sourcescanner.cpp \
+    src/sourceindex.cpp \
+    src/presetwatcher.cpp \
+    src/presetindex.cpp \
+    src/rsynccapabilities.cpp \
+    src/rsyncprobe.cpp \
+    src/transfertelemetry.cpp \
+    src/telemetrywriter.cpp \
+    src/instrumentation.cpp \
+    src/eventloopmonitor.cpp \
+    src/bandwidthschedule.cpp \
+    src/adaptivebandwidth.cpp \
+    src/snapshotpruner.cpp \
+    src/snapshotset.cpp \
+    src/localcopier.cpp \
+    src/pathstore.cpp \
+    src/directorylister.cpp \
+    src/remoteshell.cpp \
+    src/remotelister.cpp \
+    src/presetbundlereader.cpp \
+    src/presetbundlewriter.cpp \
+    src/jobscheduler.cpp \
+    src/cliapplication.cpp \
     src/processdialogue.cpp \
+    src/transferlogmodel.cpp \
+    src/changesetmodel.cpp \
     src/aboutdialogue.cpp \
     src/sourcedestinationwidget.cpp \
+    src/pathcompleter.cpp \
     src/synchronisewhatcombo.cpp \
     src/processwidget.cpp \
+    src/progressaggregator.cpp \
     src/presetcombo.cpp \
     src/presetmenu.cpp \
-    src/notificationwidget.cpp
+    src/presetlistmodel.cpp \
+    src/notificationwidget.cpp \
+    src/transferreportdialogue.cpp \
+    src/diagnosticsdialogue.cpp
 
 RESOURCES += resources/icons.qrc
 
@@ -73,4 +148,6 @@ FORMS += \
     ui/aboutdialogue.ui \
     ui/sourcedestinationwidget.ui \
     ui/processwidget.ui \
-    ui/notificationwidget.ui
+    ui/notificationwidget.ui \
+    ui/transferreportdialogue.ui \
+    ui/diagnosticsdialogue.ui
@@ -0,0 +1,148 @@
+/**
+ * @file fakersync.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief A stand-in for rsync that produces output without transferring
+ * anything.
+ *
+ * Give Process (or Qync itself, as its rsync path) this program instead of
+ * rsync to time a whole run, from starting the process to the last signal,
+ * without the source or destination being read or written. Whatever arguments
+ * it is given, it writes synthetic output for a made up synchronisation to its
+ * standard output as fast as the pipe will take it and exits with status 0. If
+ * the arguments include @b --info=progress2 the output is in the shape rsync
+ * produces for Process::OutputFormat::Structured; otherwise it is the text
+ * output. With @b --version it prints a version text like that of rsync 3.2.
+ *
+ * What it pretends to synchronise is read from the environment, since the
+ * arguments are Process's to choose:
+ * - @b QYNC_FAKE_RSYNC_SCENARIO: @b tiny (the default), @b huge or @b grouped
+ *   (see QyncBench::Scenario), or @b replay to write a captured output file
+ * - @b QYNC_FAKE_RSYNC_ITEMS: the number of files
+ * - @b QYNC_FAKE_RSYNC_UPDATES: the number of progress lines for each huge file
+ *   (default 10000)
+ * - @b QYNC_FAKE_RSYNC_CAPTURE: the file to replay
+ */
+
+#include <cstdio>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+
+#include "syntheticoutput.h"
+
+namespace {
+    // as much as a pipe typically holds, so each write fills it
+    constexpr const int ChunkSize = 64 * 1024;
+
+    constexpr const char * VersionText =
+      "rsync  version 3.2.7  protocol version 31\n"
+      "Copyright (C) 1996-2022 by Andrew Tridgell, Wayne Davison, and others.\n"
+      "Web site: https://rsync.samba.org/\n"
+      "Capabilities:\n"
+      "    64-bit files, 64-bit inums, 64-bit timestamps, 64-bit long ints,\n"
+      "    socketpairs, symlinks, symtimes, hardlinks, hardlink-specials,\n"
+      "    hardlink-symlinks, IPv6, atimes, batchfiles, inplace, append, ACLs,\n"
+      "    xattrs, optional secluded-args, iconv, prealloc, stop-at, no crtimes\n"
+      "Optimizations:\n"
+      "    SIMD-roll, no asm-roll, openssl-crypto, no asm-MD5\n"
+      "Checksum list:\n"
+      "    xxh128 xxh3 xxh64 (xxhash) md5 md4 sha1 none\n"
+      "Compress list:\n"
+      "    zstd lz4 zlibx zlib none\n"
+      "\n"
+      "(fake rsync for benchmarking Qync)\n";
+
+    bool writeAll(const QByteArray & data)
+    {
+        return 1 == std::fwrite(data.constData(), static_cast<std::size_t>(data.size()), 1, stdout) || data.isEmpty();
+    }
+
+    int replay(const QString & fileName)
+    {
+        QFile file(fileName);
+
+        if(!file.open(QIODevice::ReadOnly)) {
+            std::fprintf(stderr, "fake rsync: can't open capture file %s\n", qPrintable(fileName));
+            return 11;
+        }
+
+        while(!file.atEnd()) {
+            if(!writeAll(file.read(ChunkSize))) {
+                return 12;
+            }
+        }
+
+        return 0;
+    }
+}  // namespace
+
+/**
+ * @brief Entry point for the fake rsync.
+ *
+ * @return 0 on success, or one of rsync's exit codes if the output can't be
+ * produced.
+ */
+int main(int argc, char ** argv)
+{
+    bool structured = false;
+
+    for(int index = 1; index < argc; ++index) {
+        const QByteArray arg(argv[index]);
+
+        if("--version" == arg) {
+            std::fputs(VersionText, stdout);
+            return 0;
+        }
+
+        if(arg.startsWith("--info=") && arg.contains("progress2")) {
+            structured = true;
+        }
+    }
+
+    const auto scenarioName = qEnvironmentVariable("QYNC_FAKE_RSYNC_SCENARIO", QStringLiteral("tiny"));
+
+    if(QStringLiteral("replay") == scenarioName) {
+        return replay(qEnvironmentVariable("QYNC_FAKE_RSYNC_CAPTURE"));
+    }
+
+    QyncBench::Scenario scenario;
+
+    if(!QyncBench::parseScenario(scenarioName, scenario)) {
+        std::fprintf(stderr, "fake rsync: unknown scenario %s\n", qPrintable(scenarioName));
+        return 1;
+    }
+
+    bool ok;
+    auto items = qEnvironmentVariable("QYNC_FAKE_RSYNC_ITEMS").toULongLong(&ok);
+
+    if(!ok) {
+        items = QyncBench::defaultItemCount(scenario);
+    }
+
+    auto updates = qEnvironmentVariableIntValue("QYNC_FAKE_RSYNC_UPDATES", &ok);
+
+    if(!ok) {
+        updates = 10000;
+    }
+
+    QyncBench::SyntheticOutput output(scenario, items, updates, structured);
+    QByteArray chunk;
+    chunk.reserve(ChunkSize + 4096);
+
+    while(output.generate(chunk, ChunkSize)) {
+        if(!writeAll(chunk)) {
+            // the reader has gone away
+            return 12;
+        }
+
+        chunk.resize(0);
+    }
+
+    std::fflush(stdout);
+    return 0;
+}
@@ -0,0 +1,217 @@
+/**
+ * @file parserbenchmark.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Micro-benchmark for parsing the standard output of rsync.
+ *
+ * Replays captured rsync output through both the regular expression based
+ * parsing that Process::parseStdout() used to do and the RsyncOutputParser that
+ * replaced it, and reports the throughput of each in lines per second.
+ *
+ * Usage: qync-parserbench [capture-file] [iterations] [chunk-size]
+ *
+ * The capture file should contain the standard output of an rsync command run
+ * with the same options that Process uses, for example:
+ *
+ *     rsync --recursive --progress --verbose --out-format='f%n %l' src/ dest/ > capture.txt
+ *
+ * If no capture file is given, the sample in bench/data is used. The output is
+ * fed to the parsers in chunks of chunk-size bytes (default 4096, a typical
+ * amount of data available per read of the pipe) and the whole capture is
+ * replayed the given number of times (default 200).
+ */
+
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+
+#include "rsyncoutputparser.h"
+
+#ifndef QYNC_BENCHMARK_DATA_DIR
+#define QYNC_BENCHMARK_DATA_DIR "bench/data"
+#endif
+
+namespace {
+    // the approach taken by Process::parseStdout() before the streaming parser: the
+    // whole line cache is re-scanned for '\r', split into a new list and each line is
+    // tried against up to three regular expressions
+    class RegexParser {
+    public:
+        int feed(const QByteArray & bytes)
+        {
+            static QRegularExpression progressLine(" *(\\d+|\\d+(?:,\\d{3})*) *(\\d+)% *(\\d+\\.\\d{2})(.)B/s *(\\d+):(\\d{2}):(\\d{2})(?: +\\(xfr#(\\d+), (?:to|ir)-chk.(\\d+)\\/(\\d+)\\))?");
+            static QRegularExpression newItemLine("f(.*) (\\d+)");
+            static QRegularExpression completedLine("sent (\\d+|\\d+(?:,\\d{3})*) bytes *received (\\d+|\\d+(?:,\\d{3})*) bytes *((?:\\d+|\\d+(?:,\\d{3})*)(?:\\.(\\d{2}))?) bytes/sec");
+
+            QString data = bytes;
+            int recognised = 0;
+            m_outputCache.append(data);
+            m_outputCache = m_outputCache.replace('\r', '\n');
+            QStringList lines(m_outputCache.split("\n"));
+            int n = lines.size() - 1;
+
+            for(int i = 0; i < n; i++) {
+                data = lines[i];
+
+                if(data.isEmpty()) {
+                    continue;
+                }
+
+                if(QRegularExpressionMatch match = progressLine.match(data); match.hasMatch()) {
+                    QStringList caps = match.capturedTexts();
+                    m_checksum += caps[1].remove("[^0-9]+").toInt() + caps[2].toInt();
+                    ++recognised;
+                }
+                else if(QRegularExpressionMatch match = newItemLine.match(data); match.hasMatch()) {
+                    m_checksum += match.captured(1).size();
+                    ++recognised;
+                }
+                else if(QRegularExpressionMatch match = completedLine.match(data); match.hasMatch()) {
+                    ++recognised;
+                }
+            }
+
+            if(!lines.empty()) {
+                m_outputCache = lines[lines.size() - 1];
+            }
+
+            return recognised;
+        }
+
+        [[nodiscard]] qint64 checksum() const
+        {
+            return m_checksum;
+        }
+
+    private:
+        QString m_outputCache;
+        qint64 m_checksum = 0;
+    };
+
+    // the streaming parser, consuming the lines the same way Process does
+    class StreamingParser {
+    public:
+        int feed(const QByteArray & bytes)
+        {
+            int recognised = 0;
+            Qync::RsyncOutputParser::Line line;
+            m_parser.append(bytes);
+
+            while(m_parser.nextLine(line)) {
+                switch(line.type) {
+                    case Qync::RsyncOutputParser::LineType::Progress:
+                        m_checksum += static_cast<qint64>(line.itemBytes) + line.itemPercent;
+                        break;
+
+                    case Qync::RsyncOutputParser::LineType::NewItem:
+                        // Process converts to QString for its signal, so the benchmark does too
+                        m_checksum += QString::fromUtf8(line.itemPath.data(), static_cast<int>(line.itemPath.size())).size();
+                        break;
+
+                    default:
+                        break;
+                }
+
+                ++recognised;
+            }
+
+            return recognised;
+        }
+
+        [[nodiscard]] qint64 checksum() const
+        {
+            return m_checksum;
+        }
+
+    private:
+        Qync::RsyncOutputParser m_parser;
+        qint64 m_checksum = 0;
+    };
+
+    struct Result {
+        qint64 nsecs = 0;
+        qint64 recognisedLines = 0;
+        qint64 checksum = 0;
+    };
+
+    template<class Parser>
+    Result run(const QList<QByteArray> & chunks, int iterations)
+    {
+        Parser parser;
+        Result result;
+        QElapsedTimer timer;
+        timer.start();
+
+        for(int iteration = 0; iteration < iterations; ++iteration) {
+            for(const auto & chunk : chunks) {
+                result.recognisedLines += parser.feed(chunk);
+            }
+        }
+
+        result.nsecs = timer.nsecsElapsed();
+        result.checksum = parser.checksum();
+        return result;
+    }
+
+    void report(QTextStream & out, const char * name, const Result & result, qint64 totalLines, qint64 totalBytes)
+    {
+        double secs = static_cast<double>(result.nsecs) / 1.0e9;
+        out << QString("%1 %2 s  %3 lines/s  %4 MiB/s  (%5 recognised lines, checksum %6)")
+                 .arg(name, -10)
+                 .arg(secs, 8, 'f', 3)
+                 .arg(static_cast<double>(totalLines) / secs, 12, 'f', 0)
+                 .arg(static_cast<double>(totalBytes) / secs / (1024.0 * 1024.0), 8, 'f', 1)
+                 .arg(result.recognisedLines)
+                 .arg(result.checksum)
+            << "\n";
+    }
+}  // namespace
+
+/**
+ * @brief Entry point for the parser benchmark.
+ *
+ * @return 0 on success, non-0 if the capture file can't be read.
+ */
+int main(int argc, char ** argv)
+{
+    QTextStream out(stdout);
+    QString fileName = (1 < argc ? QString::fromLocal8Bit(argv[1]) : QStringLiteral(QYNC_BENCHMARK_DATA_DIR "/rsync-progress-sample.txt"));
+    int iterations = (2 < argc ? QByteArray(argv[2]).toInt() : 200);
+    int chunkSize = (3 < argc ? QByteArray(argv[3]).toInt() : 4096);
+
+    if(0 >= iterations || 0 >= chunkSize) {
+        out << "iterations and chunk-size must be positive\n";
+        return 1;
+    }
+
+    QFile file(fileName);
+
+    if(!file.open(QIODevice::ReadOnly)) {
+        out << "failed to open capture file " << fileName << "\n";
+        return 1;
+    }
+
+    const QByteArray capture = file.readAll();
+    QList<QByteArray> chunks;
+
+    for(int offset = 0; offset < capture.size(); offset += chunkSize) {
+        chunks.append(capture.mid(offset, chunkSize));
+    }
+
+    qint64 linesPerIteration = capture.count('\n') + capture.count('\r');
+    qint64 totalLines = linesPerIteration * iterations;
+    qint64 totalBytes = static_cast<qint64>(capture.size()) * iterations;
+
+    out << "capture: " << fileName << " (" << capture.size() << " bytes, " << linesPerIteration << " lines)\n"
+        << "replaying " << iterations << " times in " << chunkSize << " byte chunks\n";
+
+    report(out, "regex", run<RegexParser>(chunks, iterations), totalLines, totalBytes);
+    report(out, "streaming", run<StreamingParser>(chunks, iterations), totalLines, totalBytes);
+    return 0;
+}
@@ -0,0 +1,494 @@
+/**
+ * @file pipelinebenchmark.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Benchmark for the whole path from rsync's output to Process's signals.
+ *
+ * Pushes synthetic rsync output - or a captured output file - through Qync and
+ * reports the throughput, the number of allocations made and the peak memory
+ * used. There are two stages, run one after the other unless --stage says
+ * otherwise:
+ * - @b parse feeds the output straight to a RsyncOutputParser, converting the
+ *   item paths to QString as Process does, and shows what parsing alone costs
+ * - @b pipeline runs a real Process with qync-fakersync as its rsync, so the
+ *   output goes through the pipe, the ProcessWorker (on its own thread with
+ *   --worker-thread), the event queue and out through the signals
+ *
+ * Usage: qync-pipelinebench [options]
+ *
+ *     --scenario tiny|huge|grouped  what the output describes (default tiny):
+ *                                   a million tiny files, 20 huge files with
+ *                                   dense '\r' progress or 100,000 files with
+ *                                   comma-grouped sizes
+ *     --items n                     how many files, instead of the default
+ *     --updates n                   progress lines per huge file (10000)
+ *     --capture file                replay a captured output file instead
+ *     --structured                  produce output for OutputFormat::Structured
+ *     --worker-thread               parse on Process's worker thread
+ *     --stage parse|pipeline|all    which stages to run (all)
+ *     --chunk-size n                bytes per read in the parse stage (65536)
+ *     --fake-rsync path             the fake rsync to run
+ *
+ * A capture for --capture is made by running rsync with the options Process
+ * uses and redirecting its standard output, for example:
+ *
+ *     rsync --recursive --progress --verbose --out-format='f%n %l' src/ dest/ > capture.txt
+ *
+ * Allocations are counted by replacing the global operator new and delete, so
+ * memory Qt's containers allocate with malloc() directly (QByteArray and
+ * QString data, for example) is not counted; the count is best read as a
+ * comparison between runs. Peak memory is the maximum resident set size of
+ * the benchmark itself, which the pipeline stage's fake rsync is not part of.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QString>
+#include <QtCore/QTextStream>
+#include <QtCore/QTimer>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+#include "preset.h"
+#include "process.h"
+#include "rsyncoutputparser.h"
+#include "syntheticoutput.h"
+
+#ifndef QYNC_FAKE_RSYNC_PATH
+#define QYNC_FAKE_RSYNC_PATH ""
+#endif
+
+namespace {
+    std::atomic<quint64> allocationCount{0};
+    std::atomic<quint64> allocatedBytes{0};
+
+    void * allocate(std::size_t size)
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+        if(auto * memory = std::malloc(0 == size ? 1 : size); memory) {
+            return memory;
+        }
+
+        throw std::bad_alloc();
+    }
+
+    struct Options {
+        QyncBench::Scenario scenario = QyncBench::Scenario::TinyFiles;
+        quint64 items = 0;
+        int updates = 10000;
+        QString capture;
+        bool structured = false;
+        bool workerThread = false;
+        bool parseStage = true;
+        bool pipelineStage = true;
+        int chunkSize = 65536;
+        QString fakeRsync;
+    };
+
+    struct Result {
+        qint64 nsecs = 0;
+        quint64 lines = 0;
+        quint64 bytes = 0;
+        quint64 items = 0;
+        quint64 signalCount = 0;
+        qint64 checksum = 0;
+        quint64 allocations = 0;
+        quint64 allocatedBytes = 0;
+        bool ok = true;
+    };
+
+    // the counters are read before and after each stage
+    class AllocationScope {
+    public:
+        AllocationScope()
+        : m_count(allocationCount.load()),
+          m_bytes(allocatedBytes.load()) {
+        }
+
+        void finish(Result & result) const
+        {
+            result.allocations = allocationCount.load() - m_count;
+            result.allocatedBytes = allocatedBytes.load() - m_bytes;
+        }
+
+    private:
+        quint64 m_count;
+        quint64 m_bytes;
+    };
+
+    // the maximum resident set size so far, in KiB, or -1 if it's not known
+    qint64 peakMemory()
+    {
+#ifdef Q_OS_UNIX
+        rusage usage = {};
+
+        if(0 == getrusage(RUSAGE_SELF, &usage)) {
+#ifdef Q_OS_MACOS
+            // macOS reports bytes, everything else KiB
+            return usage.ru_maxrss / 1024;
+#else
+            return usage.ru_maxrss;
+#endif
+        }
+#endif
+        return -1;
+    }
+
+    // hands out the output a chunk at a time, from a capture or the generator
+    class OutputSource {
+    public:
+        explicit OutputSource(const Options & options)
+        : m_capture(),
+          m_generator(options.scenario, (0 == options.items ? QyncBench::defaultItemCount(options.scenario) : options.items), options.updates, options.structured),
+          m_chunkSize(options.chunkSize)
+        {
+            if(!options.capture.isEmpty()) {
+                m_capture = std::make_unique<QFile>(options.capture);
+                m_capture->open(QIODevice::ReadOnly);
+            }
+        }
+
+        [[nodiscard]] bool isValid() const
+        {
+            return !m_capture || m_capture->isOpen();
+        }
+
+        bool next(QByteArray & chunk)
+        {
+            chunk.resize(0);
+
+            if(m_capture) {
+                if(m_capture->atEnd()) {
+                    return false;
+                }
+
+                chunk = m_capture->read(m_chunkSize);
+                return true;
+            }
+
+            return m_generator.generate(chunk, m_chunkSize);
+        }
+
+    private:
+        std::unique_ptr<QFile> m_capture;
+        QyncBench::SyntheticOutput m_generator;
+        int m_chunkSize;
+    };
+
+    Result runParse(const Options & options)
+    {
+        using Qync::RsyncOutputParser;
+        Result result;
+        OutputSource source(options);
+
+        if(!source.isValid()) {
+            result.ok = false;
+            return result;
+        }
+
+        RsyncOutputParser parser(options.structured ? RsyncOutputParser::Format::Structured : RsyncOutputParser::Format::Text);
+        RsyncOutputParser::Line line;
+        QByteArray chunk;
+        chunk.reserve(options.chunkSize + 4096);
+        qint64 checksum = 0;
+        AllocationScope allocations;
+        QElapsedTimer timer;
+        timer.start();
+
+        while(source.next(chunk)) {
+            result.bytes += static_cast<quint64>(chunk.size());
+            parser.append(chunk);
+
+            while(parser.nextLine(line)) {
+                ++result.lines;
+
+                if(RsyncOutputParser::LineType::NewItem == line.type) {
+                    // Process converts to QString for its signals, so the benchmark does too
+                    checksum += QString::fromUtf8(line.itemPath.data(), static_cast<int>(line.itemPath.size())).size();
+                    ++result.items;
+                }
+                else {
+                    checksum += line.itemPercent;
+                }
+            }
+        }
+
+        result.nsecs = timer.nsecsElapsed();
+        allocations.finish(result);
+        // keeps the conversions from being optimised away
+        result.checksum = checksum;
+        return result;
+    }
+
+    Result runPipeline(const Options & options)
+    {
+        using Qync::Process;
+        Result result;
+
+        qputenv("QYNC_FAKE_RSYNC_SCENARIO", options.capture.isEmpty() ? QByteArray(options.scenario == QyncBench::Scenario::TinyFiles ? "tiny" : (options.scenario == QyncBench::Scenario::HugeFiles ? "huge" : "grouped")) : QByteArray("replay"));
+        qputenv("QYNC_FAKE_RSYNC_ITEMS", QByteArray::number(0 == options.items ? QyncBench::defaultItemCount(options.scenario) : options.items));
+        qputenv("QYNC_FAKE_RSYNC_UPDATES", QByteArray::number(options.updates));
+        qputenv("QYNC_FAKE_RSYNC_CAPTURE", QFile::encodeName(options.capture));
+
+        // the fake rsync ignores these, but Process wants a preset that would make sense to rsync
+        Qync::Preset preset(QStringLiteral("Pipeline benchmark"));
+        preset.setSource(QDir::tempPath() + QStringLiteral("/qync-pipelinebench-source/"));
+        preset.setDestination(QDir::tempPath() + QStringLiteral("/qync-pipelinebench-destination/"));
+
+        AllocationScope allocations;
+        QElapsedTimer timer;
+        timer.start();
+
+        Process process(options.fakeRsync, preset, Process::RunType::Normal);
+        process.setUseWorkerThread(options.workerThread);
+        process.setOutputFormat(options.structured ? Process::OutputFormat::Structured : Process::OutputFormat::Text);
+
+        const auto count = [&result]() {
+            ++result.signalCount;
+        };
+
+        QObject::connect(&process, &Process::newItemStarted, [&result]() {
+            ++result.signalCount;
+            ++result.items;
+        });
+
+        QObject::connect(&process, &Process::itemProgress, count);
+        QObject::connect(&process, &Process::itemProgressBytes, count);
+        QObject::connect(&process, &Process::itemSecondsRemaining, count);
+        QObject::connect(&process, &Process::overallProgress, count);
+        QObject::connect(&process, &Process::overallSecondsRemaining, count);
+        QObject::connect(&process, &Process::transferSpeed, count);
+        QObject::connect(&process, &Process::bytesTransferred, count);
+
+        QEventLoop loop;
+
+        QObject::connect(&process, qOverload<Process::ExitCode>(&Process::finished), &loop, [&result, &loop](Process::ExitCode code) {
+            result.ok = (Process::ExitCode::Success == code);
+            loop.quit();
+        });
+
+        QObject::connect(&process, &Process::failed, &loop, [&result, &loop]() {
+            result.ok = false;
+            loop.quit();
+        });
+
+        QTimer::singleShot(0, &process, &Process::start);
+        loop.exec();
+
+        result.nsecs = timer.nsecsElapsed();
+        allocations.finish(result);
+        return result;
+    }
+
+    void report(QTextStream & out, const char * name, const Result & result)
+    {
+        if(!result.ok) {
+            out << QString("%1 failed").arg(name, -10) << "\n";
+            return;
+        }
+
+        const double secs = static_cast<double>(result.nsecs) / 1.0e9;
+        out << QString("%1 %2 s  %3 items/s  %4 signals/s  %5 allocations (%6 MiB)")
+                 .arg(name, -10)
+                 .arg(secs, 8, 'f', 3)
+                 .arg(static_cast<double>(result.items) / secs, 12, 'f', 0)
+                 .arg(static_cast<double>(result.signalCount) / secs, 12, 'f', 0)
+                 .arg(result.allocations)
+                 .arg(static_cast<double>(result.allocatedBytes) / (1024.0 * 1024.0), 0, 'f', 1)
+            << "\n";
+
+        if(0 < result.lines) {
+            out << QString("%1 %2 lines/s  %3 MiB/s  (%4 lines, %5 bytes, checksum %6)")
+                     .arg("", -10)
+                     .arg(static_cast<double>(result.lines) / secs, 12, 'f', 0)
+                     .arg(static_cast<double>(result.bytes) / secs / (1024.0 * 1024.0), 8, 'f', 1)
+                     .arg(result.lines)
+                     .arg(result.bytes)
+                     .arg(result.checksum)
+                << "\n";
+        }
+    }
+
+    bool readOptions(const QCoreApplication & app, Options & options, QString & error)
+    {
+        QCommandLineParser parser;
+        parser.addHelpOption();
+        parser.addOptions({
+          {QStringLiteral("scenario"), QStringLiteral("What the output describes: tiny, huge or grouped."), QStringLiteral("name"), QStringLiteral("tiny")},
+          {QStringLiteral("items"), QStringLiteral("The number of files."), QStringLiteral("n")},
+          {QStringLiteral("updates"), QStringLiteral("Progress lines per huge file."), QStringLiteral("n"), QStringLiteral("10000")},
+          {QStringLiteral("capture"), QStringLiteral("Replay a captured output file."), QStringLiteral("file")},
+          {QStringLiteral("structured"), QStringLiteral("Produce output for the structured output format.")},
+          {QStringLiteral("worker-thread"), QStringLiteral("Parse on the process's worker thread.")},
+          {QStringLiteral("stage"), QStringLiteral("The stages to run: parse, pipeline or all."), QStringLiteral("stage"), QStringLiteral("all")},
+          {QStringLiteral("chunk-size"), QStringLiteral("Bytes per read in the parse stage."), QStringLiteral("n"), QStringLiteral("65536")},
+          {QStringLiteral("fake-rsync"), QStringLiteral("The fake rsync to run."), QStringLiteral("path")},
+        });
+
+        parser.process(app);
+
+        if(!QyncBench::parseScenario(parser.value(QStringLiteral("scenario")), options.scenario)) {
+            error = QStringLiteral("unknown scenario %1").arg(parser.value(QStringLiteral("scenario")));
+            return false;
+        }
+
+        bool ok = true;
+
+        if(parser.isSet(QStringLiteral("items"))) {
+            options.items = parser.value(QStringLiteral("items")).toULongLong(&ok);
+        }
+
+        if(ok) {
+            options.updates = parser.value(QStringLiteral("updates")).toInt(&ok);
+        }
+
+        if(ok) {
+            options.chunkSize = parser.value(QStringLiteral("chunk-size")).toInt(&ok);
+        }
+
+        if(!ok || 0 >= options.updates || 0 >= options.chunkSize) {
+            error = QStringLiteral("items, updates and chunk-size must be positive numbers");
+            return false;
+        }
+
+        const auto stage = parser.value(QStringLiteral("stage"));
+
+        if(QStringLiteral("parse") == stage) {
+            options.pipelineStage = false;
+        }
+        else if(QStringLiteral("pipeline") == stage) {
+            options.parseStage = false;
+        }
+        else if(QStringLiteral("all") != stage) {
+            error = QStringLiteral("unknown stage %1").arg(stage);
+            return false;
+        }
+
+        options.capture = parser.value(QStringLiteral("capture"));
+        options.structured = parser.isSet(QStringLiteral("structured"));
+        options.workerThread = parser.isSet(QStringLiteral("worker-thread"));
+        options.fakeRsync = parser.value(QStringLiteral("fake-rsync"));
+
+        if(options.fakeRsync.isEmpty()) {
+            options.fakeRsync = QStringLiteral(QYNC_FAKE_RSYNC_PATH);
+        }
+
+        if(options.fakeRsync.isEmpty()) {
+            options.fakeRsync = QDir(QCoreApplication::applicationDirPath()).absoluteFilePath(QStringLiteral("qync-fakersync"));
+        }
+
+        return true;
+    }
+}  // namespace
+
+void * operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void * operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void * operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    try {
+        return allocate(size);
+    } catch(const std::bad_alloc &) {
+        return nullptr;
+    }
+}
+
+void * operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    try {
+        return allocate(size);
+    } catch(const std::bad_alloc &) {
+        return nullptr;
+    }
+}
+
+void operator delete(void * memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void * memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void * memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void * memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+/**
+ * @brief Entry point for the pipeline benchmark.
+ *
+ * @return 0 on success, non-0 if the options are not valid or a stage fails.
+ */
+int main(int argc, char ** argv)
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    Options options;
+
+    if(QString error; !readOptions(app, options, error)) {
+        out << error << "\n";
+        return 1;
+    }
+
+    // keeps the pipeline stage's transfer telemetry out of the user's data
+    QStandardPaths::setTestModeEnabled(true);
+    out << "scenario: " << (options.capture.isEmpty() ? QStringLiteral("synthetic") : options.capture)
+        << (options.structured ? "  structured output" : "  text output")
+        << (options.workerThread ? "  worker thread" : "") << "\n";
+
+    int exitCode = 0;
+
+    if(options.parseStage) {
+        const auto result = runParse(options);
+        report(out, "parse", result);
+        exitCode |= (result.ok ? 0 : 1);
+        out.flush();
+    }
+
+    if(options.pipelineStage) {
+        const auto result = runPipeline(options);
+        report(out, "pipeline", result);
+        exitCode |= (result.ok ? 0 : 2);
+    }
+
+    if(const auto peak = peakMemory(); 0 <= peak) {
+        out << QString("peak memory %1 MiB").arg(static_cast<double>(peak) / 1024.0, 0, 'f', 1) << "\n";
+    }
+    else {
+        out << "peak memory not available on this platform\n";
+    }
+
+    return exitCode;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file presetbenchmark.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Benchmark for loading and saving presets in each file format.
+ *
+ * Saves a set of presets to a temporary directory and loads them back, first
+ * as XML and then in the binary format, and reports the throughput of each in
+ * presets per second. This is the work Application::loadPresets() does for the
+ * presets that aren't in the preset index.
+ *
+ * Usage: qync-presetbench [presets] [iterations]
+ *
+ * The default is 5000 presets, saved and loaded 5 times.
+ */
+
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QString>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTextStream>
+
+#include "preset.h"
+
+namespace {
+    struct Result {
+        qint64 saveNsecs = 0;
+        qint64 loadNsecs = 0;
+        qint64 bytes = 0;
+        qint64 checksum = 0;
+        int failures = 0;
+    };
+
+    std::vector<QString> makeFileNames(const QDir & dir, int count)
+    {
+        std::vector<QString> fileNames;
+        fileNames.reserve(static_cast<std::size_t>(count));
+
+        for(int index = 0; index < count; ++index) {
+            fileNames.push_back(dir.absoluteFilePath(QStringLiteral("preset%1").arg(index)));
+        }
+
+        return fileNames;
+    }
+
+    // presets with every kind of property set to something other than the default
+    void fillPreset(Qync::Preset & preset, int index)
+    {
+        preset.setName(QStringLiteral("Benchmark preset %1").arg(index));
+        preset.setSource(QStringLiteral("/home/user/Documents/projects/%1/").arg(index));
+        preset.setDestination(QStringLiteral("backup.example.com:/srv/backups/user/projects/%1/").arg(index));
+        preset.setHonourDeletions(0 == index % 2);
+        preset.setUseTransferCompression(true);
+        preset.setShowItemisedChanges(0 == index % 3);
+        preset.setLogFile(QStringLiteral("/home/user/.local/share/qync/logs/%1.log").arg(index));
+        preset.setLogRotationSize(16);
+        preset.setShardCount(1 + index % 4);
+    }
+
+    Result run(const std::vector<QString> & fileNames, Qync::Preset::FileFormat format, int iterations)
+    {
+        Result result;
+        QElapsedTimer timer;
+        const int count = static_cast<int>(fileNames.size());
+
+        for(int iteration = 0; iteration < iterations; ++iteration) {
+            timer.start();
+
+            for(int index = 0; index < count; ++index) {
+                Qync::Preset preset;
+                fillPreset(preset, index);
+                preset.setFileFormat(format);
+
+                if(!preset.saveCopyAs(fileNames[static_cast<std::size_t>(index)])) {
+                    ++result.failures;
+                }
+            }
+
+            result.saveNsecs += timer.nsecsElapsed();
+            timer.start();
+
+            for(const auto & fileName : fileNames) {
+                Qync::Preset preset;
+
+                if(!preset.load(fileName)) {
+                    ++result.failures;
+                    continue;
+                }
+
+                result.checksum += preset.name().size() + preset.shardCount();
+            }
+
+            result.loadNsecs += timer.nsecsElapsed();
+        }
+
+        for(const auto & fileName : fileNames) {
+            result.bytes += QFileInfo(fileName).size();
+        }
+
+        return result;
+    }
+
+    void report(QTextStream & out, const char * name, const Result & result, qint64 totalPresets)
+    {
+        double saveSecs = static_cast<double>(result.saveNsecs) / 1.0e9;
+        double loadSecs = static_cast<double>(result.loadNsecs) / 1.0e9;
+        out << QString("%1 save %2 s %3 presets/s  load %4 s %5 presets/s  (%6 bytes on disk, checksum %7, %8 failures)")
+                 .arg(name, -7)
+                 .arg(saveSecs, 7, 'f', 3)
+                 .arg(static_cast<double>(totalPresets) / saveSecs, 9, 'f', 0)
+                 .arg(loadSecs, 7, 'f', 3)
+                 .arg(static_cast<double>(totalPresets) / loadSecs, 9, 'f', 0)
+                 .arg(result.bytes)
+                 .arg(result.checksum)
+                 .arg(result.failures)
+            << "\n";
+    }
+}  // namespace
+
+/**
+ * @brief Entry point for the preset benchmark.
+ *
+ * @return 0 on success, non-0 if the arguments are not valid or the temporary
+ * directory can't be created.
+ */
+int main(int argc, char ** argv)
+{
+    QTextStream out(stdout);
+    int count = (1 < argc ? QByteArray(argv[1]).toInt() : 5000);
+    int iterations = (2 < argc ? QByteArray(argv[2]).toInt() : 5);
+
+    if(0 >= count || 0 >= iterations) {
+        out << "presets and iterations must be positive\n";
+        return 1;
+    }
+
+    QTemporaryDir dir;
+
+    if(!dir.isValid()) {
+        out << "failed to create a temporary directory\n";
+        return 1;
+    }
+
+    out << "saving and loading " << count << " presets " << iterations << " times in " << dir.path() << "\n";
+    out.flush();
+
+    const auto fileNames = makeFileNames(QDir(dir.path()), count);
+    const qint64 totalPresets = static_cast<qint64>(count) * iterations;
+    report(out, "xml", run(fileNames, Qync::Preset::FileFormat::Xml, iterations), totalPresets);
+    report(out, "binary", run(fileNames, Qync::Preset::FileFormat::Binary, iterations), totalPresets);
+    return 0;
+}
@@ -0,0 +1,283 @@
+/**
+ * @file syntheticoutput.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Generator of synthetic rsync output for the benchmarks.
+ *
+ * Produces the standard output rsync would for a synchronisation of a made up
+ * source, in the shape Process asks for, so that the benchmarks can push as
+ * much output through Qync as they like without rsync or any disks being
+ * involved. The output is generated a chunk at a time, so a scenario with
+ * millions of items does not need to be held in memory.
+ */
+
+#ifndef QYNC_BENCH_SYNTHETICOUTPUT_H
+#define QYNC_BENCH_SYNTHETICOUTPUT_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+namespace QyncBench {
+
+	enum class Scenario {
+		// lots of small files, with one progress line each
+		TinyFiles = 0,
+		// a few very large files, with many progress updates each separated by '\r'
+		HugeFiles,
+		// medium-sized files whose sizes rsync groups with ','
+		GroupedSizes,
+	};
+
+	/**
+	 * @brief Work out the scenario named on a command line.
+	 *
+	 * @param name The name: @b tiny, @b huge or @b grouped.
+	 * @param scenario Set to the scenario if the name is recognised.
+	 *
+	 * @return @b true if the name is recognised, @b false if not.
+	 */
+	inline bool parseScenario(const QString & name, Scenario & scenario)
+	{
+		if(QStringLiteral("tiny") == name) {
+			scenario = Scenario::TinyFiles;
+		}
+		else if(QStringLiteral("huge") == name) {
+			scenario = Scenario::HugeFiles;
+		}
+		else if(QStringLiteral("grouped") == name) {
+			scenario = Scenario::GroupedSizes;
+		}
+		else {
+			return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Fetch the number of items a scenario has unless told otherwise.
+	 */
+	inline quint64 defaultItemCount(Scenario scenario)
+	{
+		switch(scenario) {
+			case Scenario::TinyFiles:
+				return 1000000;
+
+			case Scenario::HugeFiles:
+				return 20;
+
+			case Scenario::GroupedSizes:
+				return 100000;
+		}
+
+		return 0;
+	}
+
+	class SyntheticOutput final {
+	public:
+		/**
+		 * @param scenario What to synchronise.
+		 * @param items How many files to synchronise.
+		 * @param updates How many progress lines to produce for each large file.
+		 * @param structured @b true to produce the output rsync produces for
+		 * Process::OutputFormat::Structured, @b false for the text output.
+		 */
+		SyntheticOutput(Scenario scenario, quint64 items, int updates, bool structured)
+		: m_scenario(scenario),
+		  m_items(items),
+		  m_updates(1 > updates ? 1 : updates),
+		  m_structured(structured) {
+		}
+
+		[[nodiscard]] inline bool isFinished() const {
+			return m_finished;
+		}
+
+		[[nodiscard]] inline quint64 lines() const {
+			return m_lines;
+		}
+
+		/**
+		 * @brief Append the next part of the output to a buffer.
+		 *
+		 * @param out The buffer.
+		 * @param minimumBytes Output is appended until the buffer holds at least
+		 * this many bytes, or the output is finished.
+		 *
+		 * @return @b false if the output had already finished.
+		 */
+		bool generate(QByteArray & out, int minimumBytes)
+		{
+			if(m_finished) {
+				return false;
+			}
+
+			if(!m_started) {
+				m_started = true;
+				appendLine(out, "sending incremental file list", '\n');
+			}
+
+			while(out.size() < minimumBytes && m_item < m_items) {
+				appendItem(out);
+				++m_item;
+			}
+
+			if(m_item == m_items) {
+				appendSummary(out);
+				m_finished = true;
+			}
+
+			return true;
+		}
+
+	private:
+		[[nodiscard]] quint64 itemSize(quint64 item) const
+		{
+			switch(m_scenario) {
+				case Scenario::TinyFiles:
+					return (item * 7919) % 1000;
+
+				case Scenario::HugeFiles:
+					return (Q_UINT64_C(8) << 30) + (item * 4096);
+
+				case Scenario::GroupedSizes:
+					return 1000 + ((item * Q_UINT64_C(2654435761)) % Q_UINT64_C(999999000));
+			}
+
+			return 0;
+		}
+
+		static void appendNumber(QByteArray & out, quint64 value, bool grouped, int width = 0)
+		{
+			// built backwards, least significant digit first
+			char digits[32];
+			int length = 0;
+			int digitCount = 0;
+
+			do {
+				if(grouped && 0 < digitCount && 0 == digitCount % 3) {
+					digits[length++] = ',';
+				}
+
+				digits[length++] = static_cast<char>('0' + (value % 10));
+				++digitCount;
+				value /= 10;
+			} while(0 != value);
+
+			for(; length < width; --width) {
+				out.append(' ');
+			}
+
+			while(0 < length) {
+				out.append(digits[--length]);
+			}
+		}
+
+		void appendLine(QByteArray & out, const char * text, char terminator)
+		{
+			out.append(text);
+			out.append(terminator);
+			++m_lines;
+		}
+
+		// "     1,234,567  45%   12.34MB/s    0:01:23 (xfr#12, to-chk=34/567)"
+		void appendProgress(QByteArray & out, quint64 bytes, int percent, bool last)
+		{
+			appendNumber(out, bytes, !m_structured, 14);
+			out.append(' ');
+			appendNumber(out, static_cast<quint64>(percent), false, 3);
+			out.append("%  110.25MB/s    0:00:");
+			appendNumber(out, static_cast<quint64>(percent % 60) / 10, false);
+			appendNumber(out, static_cast<quint64>(percent % 10), false);
+
+			if(last) {
+				out.append(" (xfr#");
+				appendNumber(out, m_item + 1, false);
+				out.append(", to-chk=");
+				appendNumber(out, m_items - m_item - 1, false);
+				out.append('/');
+				appendNumber(out, m_items, false);
+				out.append(')');
+			}
+
+			out.append(last && !m_structured ? '\n' : '\r');
+			++m_lines;
+		}
+
+		void appendItem(QByteArray & out)
+		{
+			const auto size = itemSize(m_item);
+			const auto updates = (Scenario::HugeFiles == m_scenario ? m_updates : (Scenario::GroupedSizes == m_scenario ? 3 : 1));
+
+			if(m_structured) {
+				// the whole-transfer progress comes before rsync logs the item it has finished
+				for(int update = 1; update <= updates; ++update) {
+					appendProgress(out, m_transferred + size / static_cast<quint64>(updates) * static_cast<quint64>(update), static_cast<int>((m_item * 100) / m_items), update == updates);
+				}
+
+				out.append("F>f+++++++++\t");
+				appendNumber(out, size, false);
+				out.append('\t');
+				appendNumber(out, size, false);
+				out.append("\t \t");
+				appendPath(out);
+				out.append('\n');
+				++m_lines;
+			}
+			else {
+				out.append('f');
+				appendPath(out);
+				out.append(' ');
+				appendNumber(out, size, false);
+				out.append('\n');
+				++m_lines;
+
+				for(int update = 1; update <= updates; ++update) {
+					appendProgress(out, size / static_cast<quint64>(updates) * static_cast<quint64>(update), (update * 100) / updates, update == updates);
+				}
+			}
+
+			m_transferred += size;
+		}
+
+		void appendPath(QByteArray & out) const
+		{
+			out.append("bench/dir");
+			appendNumber(out, m_item / 1000, false);
+			out.append("/file");
+			appendNumber(out, m_item, false);
+			out.append(".dat");
+		}
+
+		void appendSummary(QByteArray & out)
+		{
+			const bool grouped = !m_structured;
+			out.append("\nsent ");
+			appendNumber(out, m_transferred + m_items * 100, grouped);
+			out.append(" bytes  received ");
+			appendNumber(out, m_items * 35, grouped);
+			out.append(" bytes  ");
+			appendNumber(out, m_transferred / 10, grouped);
+			out.append(".00 bytes/sec\ntotal size is ");
+			appendNumber(out, m_transferred, grouped);
+			out.append("  speedup is 1.00\n");
+			m_lines += 3;
+		}
+
+		Scenario m_scenario;
+		quint64 m_items;
+		int m_updates;
+		bool m_structured;
+
+		bool m_started = false;
+		bool m_finished = false;
+		quint64 m_item = 0;
+		quint64 m_transferred = 0;
+		quint64 m_lines = 0;
+	};
+
+}  // namespace QyncBench
+
+#endif  // QYNC_BENCH_SYNTHETICOUTPUT_H
@@ -0,0 +1,223 @@
+/**
+ * @file adaptivebandwidth.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the AdaptiveBandwidth class.
+ */
+
+#include "adaptivebandwidth.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::AdaptiveBandwidth class.
+ */
+namespace Qync::Detail::AdaptiveBandwidth {
+    // how quickly the smoothed speed follows the samples, in milliseconds
+    static constexpr const double SmoothingTime = 20000.0;
+
+    // how long the highest speed seen takes to halve, in milliseconds, so that a
+    // link that has become permanently slower is eventually recognised as such
+    static constexpr const double PeakHalfLife = 30.0 * 60.0 * 1000.0;
+
+    // samples are ignored for this long after a change, while the new rsync builds
+    // its file list and gets up to speed
+    static constexpr const qint64 SettleTime = 60 * 1000;
+
+    // below this fraction of the limit, something else is using the link
+    static constexpr const double BackOffThreshold = 0.7;
+
+    // the new limit when backing off, as a fraction of the speed being achieved
+    static constexpr const double BackOffFactor = 0.8;
+
+    // at or above this fraction of the limit, the limit is what's holding rsync back
+    static constexpr const double ProbeThreshold = 0.9;
+    static constexpr const double ProbeFactor = 1.25;
+
+    // smaller changes aren't worth restarting rsync for
+    static constexpr const double MinimumChange = 0.2;
+}  // namespace Qync::Detail::AdaptiveBandwidth
+
+/**
+ * @class AdaptiveBandwidth
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Works out a bandwidth limit that leaves room for other traffic.
+ *
+ * The controller is given the transfer speed rsync reports with addSample(),
+ * which it smooths, and keeps track of the highest smoothed speed seen. When
+ * update() is called it compares the smoothed speed with the current limit (or,
+ * with no limit, with the highest speed seen). A transfer that is getting well
+ * below that is taken to be sharing the link with other traffic, so the limit
+ * is lowered to a little below what it is getting; one that is using all of
+ * its limit has the limit raised a step, and once the limit is above the
+ * highest speed seen it is removed altogether. The limit never goes above the
+ * ceiling, which is whatever limit applies anyway.
+ *
+ * Changing the limit means restarting rsync, so the limit is changed at most
+ * once every DecisionInterval milliseconds, and not at all for small changes.
+ * rsync is slower for reasons other than the network too (when it is checking
+ * many small files that haven't changed, for example), which also lowers the
+ * limit; that costs no more than the time it takes to raise it again.
+ *
+ * The limit is 0 when the controller isn't limiting the transfer.
+ */
+
+/**
+ * @brief Forget everything measured and remove the limit.
+ *
+ * @param msecs The time now, in milliseconds, on the clock used for the
+ * samples.
+ */
+void AdaptiveBandwidth::reset(qint64 msecs)
+{
+    m_limit = 0;
+    m_speed = 0.0;
+    m_peakSpeed = 0.0;
+    m_lastSample = -1;
+    m_lastChange = msecs;
+}
+
+/**
+ * @brief Set the highest limit the controller may choose.
+ *
+ * @param ceiling The limit in KiB per second, 0 for none.
+ *
+ * The limit is lowered straight away if it is above the new ceiling.
+ */
+void AdaptiveBandwidth::setCeiling(int ceiling)
+{
+    m_ceiling = std::max(ceiling, 0);
+
+    if(0 < m_ceiling && m_limit > m_ceiling) {
+        m_limit = m_ceiling;
+    }
+}
+
+/**
+ * @brief Add a measurement of the transfer speed.
+ *
+ * @param msecs The time of the measurement, in milliseconds.
+ * @param bytesPerSecond The speed.
+ */
+void AdaptiveBandwidth::addSample(qint64 msecs, double bytesPerSecond)
+{
+    using namespace Detail::AdaptiveBandwidth;
+
+    if(msecs - m_lastChange < SettleTime) {
+        return;
+    }
+
+    if(0 > m_lastSample) {
+        m_speed = bytesPerSecond;
+    }
+    else {
+        const auto elapsed = static_cast<double>(std::max<qint64>(msecs - m_lastSample, 0));
+        m_speed += (1.0 - std::exp(-elapsed / SmoothingTime)) * (bytesPerSecond - m_speed);
+        m_peakSpeed *= std::exp2(-elapsed / PeakHalfLife);
+    }
+
+    m_peakSpeed = std::max(m_peakSpeed, m_speed);
+    m_lastSample = msecs;
+}
+
+/**
+ * @brief Ignore the transfer speed for a while because rsync has been
+ * restarted for some other reason.
+ *
+ * @param msecs The time now, in milliseconds.
+ *
+ * The speed is ignored as it is after the controller changes the limit, and
+ * the limit won't change until DecisionInterval milliseconds from now.
+ */
+void AdaptiveBandwidth::settle(qint64 msecs)
+{
+    m_lastChange = msecs;
+    m_lastSample = -1;
+}
+
+/**
+ * @brief Decide whether the limit should change.
+ *
+ * @param msecs The time now, in milliseconds.
+ *
+ * Nothing changes until DecisionInterval milliseconds after the last change.
+ *
+ * @return @b true if the limit has changed, @b false if not.
+ */
+bool AdaptiveBandwidth::update(qint64 msecs)
+{
+    using namespace Detail::AdaptiveBandwidth;
+
+    if(msecs - m_lastChange < DecisionInterval || 0 > m_lastSample) {
+        return false;
+    }
+
+    double reference = m_peakSpeed;
+
+    if(0 < m_limit) {
+        reference = m_limit * 1024.0;
+    }
+    else if(0 < m_ceiling) {
+        reference = std::min(reference, m_ceiling * 1024.0);
+    }
+
+    if(0.0 >= reference) {
+        return false;
+    }
+
+    int limit = m_limit;
+
+    if(m_speed < BackOffThreshold * reference) {
+        limit = std::max(MinimumLimit, static_cast<int>(m_speed * BackOffFactor / 1024.0));
+
+        if(0 < m_ceiling) {
+            limit = std::min(limit, m_ceiling);
+        }
+    }
+    else if(0 < m_limit && m_speed >= ProbeThreshold * reference) {
+        limit = static_cast<int>(m_limit * ProbeFactor);
+
+        if((0 < m_ceiling && limit >= m_ceiling) || limit * 1024.0 >= m_peakSpeed) {
+            // nothing to gain from limiting any more
+            limit = 0;
+        }
+    }
+
+    if(limit == m_limit) {
+        return false;
+    }
+
+    if(0 < limit && 0 < m_limit && std::abs(limit - m_limit) < MinimumChange * m_limit) {
+        return false;
+    }
+
+    m_limit = limit;
+    m_lastChange = msecs;
+
+    // the speed history is for an rsync that is about to be replaced
+    m_lastSample = -1;
+    return true;
+}
+
+/**
+ * @fn AdaptiveBandwidth::limit()
+ * @brief Fetch the limit the controller has chosen.
+ *
+ * @return The limit in KiB per second, or 0 if the transfer is not limited.
+ */
+
+/**
+ * @fn AdaptiveBandwidth::ceiling()
+ * @brief Fetch the highest limit the controller may choose.
+ *
+ * @return The limit in KiB per second, 0 for none.
+ */
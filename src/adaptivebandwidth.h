@@ -0,0 +1,50 @@
+/**
+ * @file adaptivebandwidth.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the AdaptiveBandwidth class.
+ */
+
+#ifndef QYNC_ADAPTIVEBANDWIDTH_H
+#define QYNC_ADAPTIVEBANDWIDTH_H
+
+#include <QtCore/QtGlobal>
+
+namespace Qync {
+
+	class AdaptiveBandwidth {
+	public:
+		AdaptiveBandwidth() = default;
+
+		void reset(qint64 msecs);
+
+		[[nodiscard]] inline int limit() const {
+			return m_limit;
+		}
+
+		[[nodiscard]] inline int ceiling() const {
+			return m_ceiling;
+		}
+
+		void setCeiling(int ceiling);
+		void addSample(qint64 msecs, double bytesPerSecond);
+		void settle(qint64 msecs);
+		bool update(qint64 msecs);
+
+		static constexpr const int MinimumLimit = 64;
+		static constexpr const qint64 DecisionInterval = 5 * 60 * 1000;
+
+	private:
+		int m_limit = 0;
+		int m_ceiling = 0;
+		double m_speed = 0.0;
+		double m_peakSpeed = 0.0;
+		qint64 m_lastSample = -1;
+		qint64 m_lastChange = 0;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_ADAPTIVEBANDWIDTH_H
@@ -13,22 +13,29 @@
 #include <QtCore/QStringBuilder>
 #include <QtCore/QDebug>
 #include <QtCore/QDir>
+#include <QtCore/QEvent>
+#include <QtCore/QFile>
 #include <QtCore/QFileInfo>
-#include <QtCore/QProcess>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
 #include <QtCore/QStandardPaths>
+#include <QtCore/QTimer>
 
+#include "applicationinfo.h"
+#include "eventloopmonitor.h"
+#include "instrumentation.h"
+#include "jobscheduler.h"
 #include "mainwindow.h"
 #include "preset.h"
+#include "presetbundlereader.h"
+#include "presetbundlewriter.h"
+#include "presetindex.h"
+#include "presetlistmodel.h"
 #include "process.h"
 #include "preferences.h"
-
-static constexpr const char * const QyncAppName = "Qync";
-static constexpr const char * const QyncAppVersionString = "1.1.1";
-static constexpr const char * const QyncAppVersionDate = "April 2020";
-static constexpr const char * const QyncAppBuildId = "ac4e7d5";
-static constexpr const char * const QyncAppWebsite = "https://www.equituk.net/";
-static constexpr const char * const QyncOrgName = "BitCraft";
-static constexpr const char * const QyncOrgDomain = "bitcraft.eu";
+#include "remoteshell.h"
+#include "rsynccapabilities.h"
+#include "rsyncprobe.h"
 
 using namespace Qync;
 
@@ -51,6 +58,11 @@ using namespace Qync;
  * The application stores all of its configuration details in a hidden directory in the user's home directory. The
  * @b preferences file stores the application preferences as XML, and the presets folder stores each preset in its
  * own XML file.
+ *
+ * Startup does as little as possible before the main window appears. Presets that are in the preset index are not
+ * read until they are needed (see loadPresets()), the main window creates its secondary dialogues the first time
+ * they are opened, and rsync is not probed for its capabilities until the main window has been shown. How long each
+ * phase took is recorded, and available from startupPhases() for the diagnostics.
  */
 
 /**
@@ -63,22 +75,28 @@ using namespace Qync;
  */
 Application::Application(int & argc, char ** argv)
 :   QApplication(argc, argv),
-    m_rsyncVersionText(),
     m_configPath(),
     m_presetsPath(),
     m_presets(),
     m_prefs(),
+    m_jobScheduler(std::make_unique<JobScheduler>()),
+    m_rsyncProbe(nullptr),
+    m_eventLoopMonitor(std::make_unique<EventLoopMonitor>()),
+    m_presetModel(std::make_unique<PresetListModel>(*this)),
     m_mainWindow(nullptr),
-    m_lastError()
+    m_lastError(),
+    m_startupTimer(),
+    m_startupPhases()
 {
-    setApplicationName(QyncAppName);
-    setApplicationDisplayName(QyncAppName);
-    setApplicationVersion(QyncAppVersionString);
-    setOrganizationName(QyncOrgName);
-    setOrganizationDomain(QyncOrgDomain);
-    setProperty("ReleaseDate", QyncAppVersionDate);
-    setProperty("BuildId", QyncAppBuildId);
-    setProperty("ApplicationWebsite", QyncAppWebsite);
+    m_startupTimer.start();
+    setApplicationName(ApplicationInfo::Name);
+    setApplicationDisplayName(ApplicationInfo::Name);
+    setApplicationVersion(ApplicationInfo::VersionString);
+    setOrganizationName(ApplicationInfo::OrganisationName);
+    setOrganizationDomain(ApplicationInfo::OrganisationDomain);
+    setProperty("ReleaseDate", ApplicationInfo::VersionDate);
+    setProperty("BuildId", ApplicationInfo::BuildId);
+    setProperty("ApplicationWebsite", ApplicationInfo::Website);
 
     // do this here rather than in initialisation section above because we need QStandardPaths to take account of
     // organisation name/domain and app name set in this constructor. in the init section these are not yet set
@@ -91,18 +109,48 @@ Application::Application(int & argc, char ** argv)
     root.mkpath(m_presetsPath);
 
     m_prefs.loadFrom(m_configPath + "/guipreferences");
+    addStartupPhase(tr("Loading the preferences"));
     loadPresets();
+    addStartupPhase(tr("Loading the presets"));
+
+    m_jobScheduler->applyPreferences(m_prefs);
+    Instrumentation::setEnabled(m_prefs.instrumentationEnabled());
+    m_eventLoopMonitor->setActive(m_prefs.instrumentationEnabled());
+
+    // the capabilities arrive once rsync has been run, unless they're cached already. the probe isn't started until
+    // the main window is up (see finishStartup())
+    m_rsyncProbe = std::make_unique<RsyncProbe>(m_configPath + "/rsynccapabilities");
+
+    connect(m_rsyncProbe.get(), &RsyncProbe::capabilitiesChanged, this, [this]() {
+        m_jobScheduler->setOutputFormat(rsyncOutputFormat());
+        Q_EMIT rsyncCapabilitiesChanged();
+    });
+
+    connect(this, &Application::preferencesChanged, this, [this]() {
+        m_jobScheduler->applyPreferences(m_prefs);
+        m_rsyncProbe->probe(m_prefs.rsyncPath());
+        Instrumentation::setEnabled(m_prefs.instrumentationEnabled());
+        m_eventLoopMonitor->setActive(m_prefs.instrumentationEnabled());
+    });
 
     // MainWindow constructor uses Application instance, specifically app display name, so
     // this must be instantiated after the Application instance is set up sufficiently
     m_mainWindow = std::make_unique<MainWindow>();
+    addStartupPhase(tr("Creating the main window"));
 }
 
 /**
  * @brief Destroy the application.
  */
 Application::~Application() {
+    // the main window may be showing the progress of queued processes
+    m_mainWindow.reset();
+    m_jobScheduler.reset();
+    m_rsyncProbe.reset();
+    m_eventLoopMonitor.reset();
+    m_presetModel.reset();
     clearPresets();
+    RemoteShell::stopSharedConnections();
 }
 
 /**
@@ -163,7 +211,8 @@ QString Application::lastError() const {
 /**
  * @brief Start the application's main loop.
  *
- * The main window is shown and the main loop is executed.
+ * The main window is shown and the main loop is executed. The rest of startup is done once the main loop has painted
+ * the window for the first time (see eventFilter() and finishStartup()).
  *
  * @return 0 on successful execution, non-0 on error.
  */
@@ -171,10 +220,57 @@ int Application::exec() {
     Q_ASSERT_X(qyncApp, __PRETTY_FUNCTION__, "no Application instance");
     Q_ASSERT_X(qyncApp->m_mainWindow, __PRETTY_FUNCTION__, "no main window (perhaps Application::~Application has been called?)");
 
+    // the window's first UpdateRequest, which paints it, finishes startup
+    qyncApp->m_mainWindow->installEventFilter(qyncApp);
     qyncApp->m_mainWindow->show();
+    qyncApp->addStartupPhase(tr("Showing the main window"));
     return QApplication::exec();
 }
 
+/**
+ * @brief Watch the main window for its first paint.
+ *
+ * @param watched The object the event is for.
+ * @param event The event.
+ *
+ * The main window paints itself when it handles an UpdateRequest. The first one it gets schedules finishStartup() to
+ * run as soon as the window has handled it, and the filter is removed. The event is never filtered out.
+ *
+ * @return @b false, so that the event is always delivered.
+ */
+bool Application::eventFilter(QObject * watched, QEvent * event) {
+    if(watched == m_mainWindow.get() && QEvent::UpdateRequest == event->type()) {
+        m_mainWindow->removeEventFilter(this);
+        addStartupPhase(tr("Waiting for the main window to be exposed"));
+        QTimer::singleShot(0, this, &Application::finishStartup);
+    }
+
+    return QApplication::eventFilter(watched, event);
+}
+
+/**
+ * @brief Do the parts of startup that the main window doesn't need to appear.
+ *
+ * The rsync capabilities are probed, which runs rsync unless they have been cached. Until they arrive the main window
+ * offers only the options that every rsync supports.
+ */
+void Application::finishStartup() {
+    addStartupPhase(tr("Painting the main window"));
+    m_rsyncProbe->probe(m_prefs.rsyncPath());
+    addStartupPhase(tr("Starting the rsync probe"));
+}
+
+/**
+ * @brief Record that a phase of startup has finished.
+ *
+ * @param name The name of the phase, for the diagnostics.
+ *
+ * The phase is timed from the end of the previous one, or from the start of the constructor for the first one.
+ */
+void Application::addStartupPhase(QString name) {
+    m_startupPhases.push_back({std::move(name), m_startupTimer.restart()});
+}
+
 /**
  * @brief Retrieve an indexed preset from the application.
  *
@@ -183,11 +279,45 @@ int Application::exec() {
  * Indices are 0-based. If the index is found to be out of bounds,
  * an assertion failure occurs.
  *
+ * If the preset's settings have not been read from its file yet, they are
+ * loaded before it is returned (see Preset::ensureLoaded()).
+ *
  * @return the preset at the index provided.
  */
 Preset & Application::preset(int index) {
     Q_ASSERT_X(0 <= index && m_presets.size() > static_cast<PresetList::size_type>(index), __PRETTY_FUNCTION__, QString("index %1 is out of bounds (have presets 0 .. %2)").arg(index, static_cast<int>(m_presets.size() - 1)).toUtf8());
-    return *m_presets[static_cast<PresetList::size_type>(index)];
+    auto & preset = *m_presets[static_cast<PresetList::size_type>(index)];
+    preset.ensureLoaded();
+    return preset;
+}
+
+/**
+ * @brief Save an indexed preset to its file.
+ *
+ * @param index is the index of the preset to save.
+ *
+ * Indices are 0-based. The provided index must not be out of bounds.
+ *
+ * Use this rather than Preset::save() for presets stored in the application
+ * so that anything showing the preset is told that it has changed. The preset
+ * is saved in the format set in the preferences.
+ *
+ * @return @b true if the preset was saved, @b false otherwise.
+ */
+bool Application::savePreset(int index) {
+    Q_ASSERT_X(0 <= index && m_presets.size() > static_cast<PresetList::size_type>(index), __PRETTY_FUNCTION__, QString("index %1 out of bounds (must be in range 0..%2)").arg(index, static_cast<int>(m_presets.size() - 1)).toUtf8());
+
+    auto & preset = *m_presets[static_cast<PresetList::size_type>(index)];
+    preset.setFileFormat(m_prefs.presetFileFormat());
+
+    if(!preset.save()) {
+        setLastError("The preset could not be saved.");
+        return false;
+    }
+
+    Q_EMIT presetChanged(index);
+    Q_EMIT presetsChanged();
+    return true;
 }
 
 /**
@@ -222,6 +352,7 @@ bool Application::removePreset(int index) {
     }
 
     m_presets.erase(presetToRemove);
+    Q_EMIT presetRemoved(index);
     Q_EMIT presetsChanged();
     return ret;
 }
@@ -249,8 +380,9 @@ Preset & Application::addPreset(const QString & name) {
     } while(presetDir.exists(fileName));
 
     preset.setFileName(presetDir.absoluteFilePath(fileName));
-
+    preset.setFileFormat(m_prefs.presetFileFormat());
     preset.save();
+    Q_EMIT presetsAdded(presetCount() - 1, presetCount() - 1);
     Q_EMIT presetsChanged();
     return preset;
 }
@@ -274,6 +406,14 @@ void Application::clearPresets() {
  * location are loaded. The default location is usually in the user's
  * home directory. This differs according to platform.
  *
+ * Only the names of the presets are needed to list them, so the names are
+ * cached in an index in the configuration directory along with the size and
+ * modification time of each preset file. Files that haven't changed since they
+ * were indexed are not parsed: a placeholder with just the name is added for
+ * each of them, and its settings are loaded when it is retrieved with preset().
+ * Files that are new or have changed are loaded in full and the index is
+ * updated.
+ *
  * return @b true if the presets were loaded, @b false otherwise.
  */
 bool Application::loadPresets() {
@@ -287,16 +427,35 @@ bool Application::loadPresets() {
     }
 
     clearPresets();
+    PresetIndex index(m_configPath + "/presetindex");
+    index.load();
+    QSet<QString> presetFileNames;
 
-    for(const auto & fileName : presetDir.entryList(QDir::Files | QDir::Readable)) {
-        Preset preset;
+    for(const auto & fileInfo : presetDir.entryInfoList(QDir::Files | QDir::Readable)) {
+        const auto fileName = fileInfo.absoluteFilePath();
+        presetFileNames.insert(fileName);
 
-        if(!loadPreset(presetDir.absoluteFilePath(fileName))) {
-            qWarning() << __PRETTY_FUNCTION__ << "failed to load preset from file" << fileName;
+        if(const auto name = index.name(fileInfo); name) {
+            m_presets.emplace_back(std::make_unique<Preset>());
+            m_presets.back()->setUnloaded(fileName, *name);
+        }
+        else if(loadPreset(fileName)) {
+            index.setName(fileInfo, m_presets.back()->name());
+        }
+        else {
+            qWarning() << __PRETTY_FUNCTION__ << "failed to load preset from file" << fileInfo.fileName();
+            index.remove(fileName);
         }
     }
 
+    index.retainOnly(presetFileNames);
+
+    if(!index.save()) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to save preset index to" << index.fileName();
+    }
+
     blocker.unblock();
+    Q_EMIT presetsReset();
     Q_EMIT presetsChanged();
     return true;
 }
@@ -321,7 +480,7 @@ bool Application::loadPreset(const QString & fileName) {
     bool ret = preset.load(fileName);
 
     if(!ret) {
-        m_presets.erase(m_presets.end());
+        m_presets.pop_back();
     }
     else {
         if(!QFileInfo(fileName).absolutePath().startsWith(m_presetsPath)) {
@@ -333,35 +492,148 @@ bool Application::loadPreset(const QString & fileName) {
                 newFileName = m_presetsPath % "/preset" % QString::number(i);
             } while(QFileInfo::exists(newFileName));
 
+            preset.setFileFormat(m_prefs.presetFileFormat());
+
             if(!preset.saveAs(newFileName)) {
                 qWarning() << "failed to save preset to" << newFileName;
             }
         }
 
+        Q_EMIT presetsAdded(presetCount() - 1, presetCount() - 1);
         Q_EMIT presetsChanged();
     }
 
     return ret;
 }
 
+/**
+ * @brief Import all the presets in a bundle.
+ *
+ * @param fileName The path to the bundle (see PresetBundleReader). A single
+ * preset file is also accepted.
+ *
+ * Each preset in the bundle is added to the application's list of presets and
+ * saved in its own file in the presets directory. The directory is listed once
+ * for the whole bundle, and presetsAdded() and presetsChanged() are emitted
+ * once at the end, so importing a large bundle costs little more than reading
+ * it.
+ *
+ * If the bundle is damaged part way through, the presets before the damage
+ * are still imported.
+ *
+ * @return The number of presets imported, or -1 if the bundle could not be
+ * read or is not valid (see lastError()).
+ */
+int Application::importPresetBundle(const QString & fileName) {
+    QFile file(fileName);
+
+    if(!file.open(QIODevice::ReadOnly)) {
+        setLastError(QStringLiteral("The file \"%1\" could not be opened: %2").arg(fileName, file.errorString()));
+        return -1;
+    }
+
+    PresetBundleReader reader(file);
+    const int first = presetCount();
+    const int added = reader.readAllInto(m_presetsPath, m_presets, m_prefs.presetFileFormat());
+
+    if(0 < added) {
+        Q_EMIT presetsAdded(first, first + added - 1);
+        Q_EMIT presetsChanged();
+    }
+
+    if(reader.hasError()) {
+        setLastError(QStringLiteral("The file \"%1\" is not a valid preset bundle: %2").arg(fileName, reader.errorString()));
+        return -1;
+    }
+
+    return added;
+}
+
+/**
+ * @brief Export all the presets to a bundle.
+ *
+ * @param fileName The path to the bundle to write (see PresetBundleWriter).
+ *
+ * The presets are written as they are stored, not with the current settings.
+ * The file is replaced atomically, so an existing file is left untouched if
+ * the export fails. Presets whose files can no longer be loaded are left out.
+ *
+ * @return @b true if the bundle was written, @b false otherwise (see
+ * lastError()).
+ */
+bool Application::exportPresetBundle(const QString & fileName) {
+    QSaveFile file(fileName);
+
+    if(!file.open(QIODevice::WriteOnly)) {
+        setLastError(QStringLiteral("The file \"%1\" could not be opened: %2").arg(fileName, file.errorString()));
+        return false;
+    }
+
+    PresetBundleWriter writer(file);
+
+    for(const auto & preset : m_presets) {
+        if(!preset->ensureLoaded()) {
+            qWarning() << __PRETTY_FUNCTION__ << "leaving out preset" << preset->name() << "which could not be loaded";
+            continue;
+        }
+
+        if(!writer.write(*preset)) {
+            break;
+        }
+    }
+
+    if(!writer.finish() || !file.commit()) {
+        setLastError(QStringLiteral("The presets could not be written to \"%1\": %2").arg(fileName, file.errorString()));
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * @brief Get the version text of the rsync binary.
  *
  * The version text is the text output when the command @b rsync
  * @b --version is issued.
  *
+ * The text comes from rsyncCapabilities(). If rsync is still being probed this
+ * waits for it, which is only likely if it is called just after startup with a
+ * new or upgraded rsync.
+ *
  * @return The version text, or a null string if the rsync binary is
  * not valid.
  */
 QString Application::rsyncVersionText() {
-    if(m_rsyncVersionText.isEmpty()) {
-        QProcess p(this);
-        p.start(m_prefs.rsyncPath(), QStringList() << "--version", QIODevice::ReadOnly | QIODevice::Text);
-        p.waitForFinished();
-        m_rsyncVersionText = p.readAll();
-    }
+    m_rsyncProbe->waitForFinished();
+    return m_rsyncProbe->capabilities().versionText();
+}
 
-    return m_rsyncVersionText;
+/**
+ * @brief Get what the rsync binary can do.
+ *
+ * The binary set in the preferences is probed in the background when the
+ * application starts and whenever the preferences change, and the result is
+ * cached on disk so that rsync is only run again if it changes (see
+ * RsyncProbe). Until the first probe has finished the capabilities are not
+ * valid; rsyncCapabilitiesChanged() is emitted whenever they are updated.
+ *
+ * @return The capabilities.
+ */
+const RsyncCapabilities & Application::rsyncCapabilities() const {
+    return m_rsyncProbe->capabilities();
+}
+
+/**
+ * @brief Get the output format to use with the rsync binary.
+ *
+ * This is worked out from rsyncCapabilities(). Processes created by the
+ * application's JobScheduler use it automatically; others should be given it
+ * with Process::setOutputFormat().
+ *
+ * @return The output format.
+ */
+Process::OutputFormat Application::rsyncOutputFormat() const {
+    return Process::outputFormatFor(rsyncCapabilities());
 }
 
 /**
@@ -387,14 +659,82 @@ QString Application::rsyncVersionText() {
  */
 
 /**
- * @fn Application::presetsChanged()
+ * @fn Application::jobScheduler()
+ * @brief Retrieve the scheduler that runs queued synchronisations.
+ *
+ * The rsync command, worker thread setting and maximum number of concurrent
+ * jobs follow the preferences.
+ *
+ * @return The scheduler.
+ */
+
+/**
+ * @fn Application::startupPhases()
+ * @brief Retrieve how long each phase of startup took.
+ *
+ * @return The phases, in the order they happened. The list is complete once
+ * the main window has been shown.
+ */
+
+/**
+ * @fn Application::presetModel()
+ * @brief Retrieve the model of the presets stored in the application.
+ *
+ * The model is shared by all the widgets that list the presets.
+ *
+ * @return The model.
+ */
+
+/**
+ * @fn Application::presetsAdded(int, int)
+ * @brief Emitted when one or more presets have been added.
+ *
+ * The indices of the first and last new presets are provided. New presets are
+ * always added at the end of the list.
+ */
+
+/**
+ * @fn Application::presetRemoved(int)
  * @brief Emitted when a preset has been removed.
  *
- * When emitted with either presetAdded() or presetRemoved(), this
- * signal is always emitted after the other, never before.
+ * The index the preset had is provided. The indices of the presets that
+ * followed it are now one less.
+ */
+
+/**
+ * @fn Application::presetChanged(int)
+ * @brief Emitted when a preset has been saved by savePreset().
+ *
+ * The index of the preset is provided.
+ */
+
+/**
+ * @fn Application::presetsReset()
+ * @brief Emitted when all the presets have been replaced by loadPresets().
+ *
+ * Any indices previously retrieved are no longer valid.
+ */
+
+/**
+ * @fn Application::presetsChanged()
+ * @brief Emitted when the presets have changed in any way.
+ *
+ * When emitted with any of presetsAdded(), presetRemoved(), presetChanged() or
+ * presetsReset(), this signal is always emitted after the other, never before.
+ * It is convenient for code that only needs to know that something changed;
+ * anything that lists the presets should use the finer-grained signals, or the
+ * presetModel(), instead of re-reading the whole list.
  */
 
 /**
  * @fn Application::preferencesChanged()
  * @brief Emitted when the application preferences have changed.
  */
+
+/**
+ * @fn Application::rsyncCapabilitiesChanged()
+ * @brief Emitted when rsyncCapabilities() has been updated.
+ *
+ * This happens when the rsync binary has been probed, shortly after startup
+ * and after the rsync path in the preferences has changed.
+ */
@@ -14,16 +14,23 @@
 #include <vector>
 
 #include <QtWidgets/QApplication>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QString>
 
 #include "guipreferences.h"
 #include "mainwindow.h"
+#include "process.h"
 
 namespace Qync {
 
 	class Preset;
+	class EventLoopMonitor;
 	class Process;
 	class Preferences;
+	class JobScheduler;
+	class PresetListModel;
+	class RsyncCapabilities;
+	class RsyncProbe;
 
 	class Application
 	: public QApplication {
@@ -38,6 +45,12 @@ namespace Qync {
 			Error
 		};
 
+		// a step in starting up, and how long it took
+		struct StartupPhase {
+			QString name;
+			qint64 elapsedMs = 0;
+		};
+
 		Application(int & argc, char ** argv);
 		~Application();
 
@@ -46,6 +59,8 @@ namespace Qync {
 		QString configurationPath();
 		QString presetsPath();
 		QString rsyncVersionText();
+		const RsyncCapabilities & rsyncCapabilities() const;
+		Process::OutputFormat rsyncOutputFormat() const;
 
 		inline QString buildId() const {
 			return property("BuildId").toString();
@@ -71,10 +86,17 @@ namespace Qync {
 			return m_presets;
 		}
 
+		inline PresetListModel & presetModel() {
+			return *m_presetModel;
+		}
+
 		Preset & preset(int index);
+		bool savePreset(int index);
 		bool removePreset(int index);
 		Preset & addPreset(const QString & name);
 		bool loadPreset(const QString & fileName);
+		int importPresetBundle(const QString & fileName);
+		bool exportPresetBundle(const QString & fileName);
 
 		void clearPresets();
 
@@ -86,24 +108,48 @@ namespace Qync {
 			return m_mainWindow.get();
 		}
 
+		inline JobScheduler & jobScheduler() {
+			return *m_jobScheduler;
+		}
+
+		[[nodiscard]] inline const std::vector<StartupPhase> & startupPhases() const {
+			return m_startupPhases;
+		}
+
 	Q_SIGNALS:
+		void presetsAdded(int, int);
+		void presetRemoved(int);
+		void presetChanged(int);
+		void presetsReset();
 		void presetsChanged();
 		void preferencesChanged();
+		void rsyncCapabilitiesChanged();
 
 	protected:
 		void setLastError(const QString & err) const;
+		bool eventFilter(QObject * watched, QEvent * event) override;
 
 	private:
-		QString m_rsyncVersionText;
+		void finishStartup();
+		void addStartupPhase(QString name);
+
 		QString m_configPath;
 		QString m_presetsPath;
 
 		PresetList m_presets;
 		GuiPreferences m_prefs;
 
+		std::unique_ptr<JobScheduler> m_jobScheduler;
+		std::unique_ptr<RsyncProbe> m_rsyncProbe;
+		std::unique_ptr<EventLoopMonitor> m_eventLoopMonitor;
+		std::unique_ptr<PresetListModel> m_presetModel;
 		std::unique_ptr<MainWindow> m_mainWindow;
 
 		mutable QString m_lastError;
+
+		// measures each startup phase in turn
+		QElapsedTimer m_startupTimer;
+		std::vector<StartupPhase> m_startupPhases;
 	};
 
 }  // namespace Qync
@@ -0,0 +1,26 @@
+/**
+ * @file applicationinfo.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Identifying details shared by the Qync applications.
+ *
+ * Both the GUI and the command-line application register these with Qt, so
+ * that QStandardPaths finds the same configuration and presets for both.
+ */
+
+#ifndef QYNC_APPLICATIONINFO_H
+#define QYNC_APPLICATIONINFO_H
+
+namespace Qync::ApplicationInfo {
+	static constexpr const char * const Name = "Qync";
+	static constexpr const char * const VersionString = "1.1.1";
+	static constexpr const char * const VersionDate = "April 2020";
+	static constexpr const char * const BuildId = "ac4e7d5";
+	static constexpr const char * const Website = "https://www.equituk.net/";
+	static constexpr const char * const OrganisationName = "BitCraft";
+	static constexpr const char * const OrganisationDomain = "bitcraft.eu";
+}  // namespace Qync::ApplicationInfo
+
+#endif  // QYNC_APPLICATIONINFO_H
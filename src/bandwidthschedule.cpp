@@ -0,0 +1,201 @@
+/**
+ * @file bandwidthschedule.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the BandwidthSchedule class.
+ */
+
+#include "bandwidthschedule.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QtCore/QStringBuilder>
+#include <QtCore/QStringList>
+#include <QtCore/QTime>
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::BandwidthSchedule class.
+ */
+namespace Qync::Detail::BandwidthSchedule {
+    static constexpr const int MinutesPerDay = 24 * 60;
+
+    // rsync's --bwlimit is limited to what fits in an int of bytes per second
+    static constexpr const int MaximumLimit = std::numeric_limits<int>::max() / 1024;
+
+    // "HH:MM" to minutes after midnight, or -1. "24:00" is allowed for the end of the day
+    static int parseTime(const QString & text)
+    {
+        if(QStringLiteral("24:00") == text) {
+            return MinutesPerDay;
+        }
+
+        const auto time = QTime::fromString(text, QStringLiteral("H:mm"));
+
+        if(!time.isValid()) {
+            return -1;
+        }
+
+        return time.hour() * 60 + time.minute();
+    }
+
+    static QString formatTime(int minute)
+    {
+        return QStringLiteral("%1:%2").arg(minute / 60, 2, 10, QLatin1Char('0')).arg(minute % 60, 2, 10, QLatin1Char('0'));
+    }
+
+    static bool contains(const Qync::BandwidthSchedule::Period & period, int minute)
+    {
+        if(period.startMinute <= period.endMinute) {
+            return period.startMinute <= minute && minute < period.endMinute;
+        }
+
+        return period.startMinute <= minute || minute < period.endMinute;
+    }
+}  // namespace Qync::Detail::BandwidthSchedule
+
+/**
+ * @class BandwidthSchedule
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief A bandwidth limit that depends on the time of day.
+ *
+ * The schedule is a list of periods of the day, each with its own limit. It is
+ * written as a comma-separated list of @b start-end=limit entries, where the
+ * times are @b HH:MM on the 24 hour clock and the limit is in KiB per second,
+ * 0 meaning no limit; for example <tt>08:00-18:00=1024, 18:00-23:00=4096</tt>.
+ * A period whose end is before its start runs past midnight. Where periods
+ * overlap the first one listed applies, and outside all the periods the
+ * default limit given to limitAt() applies.
+ *
+ * Preset stores its schedule as a string, and Process uses limitAt() to decide
+ * rsync's @b --bwlimit and msecsToNextChange() to know when to think again.
+ */
+
+/**
+ * @brief Read a schedule from its string form.
+ *
+ * @param schedule The schedule. An empty string is an empty schedule.
+ *
+ * @return The schedule, or no value if the string is not valid.
+ */
+std::optional<BandwidthSchedule> BandwidthSchedule::fromString(const QString & schedule)
+{
+    using namespace Detail::BandwidthSchedule;
+    BandwidthSchedule ret;
+
+    for(const auto & entry : schedule.split(',', QString::SkipEmptyParts)) {
+        const auto equals = entry.indexOf('=');
+        const auto dash = entry.indexOf('-');
+
+        if(-1 == equals || -1 == dash || equals < dash) {
+            return {};
+        }
+
+        bool ok;
+        Period period;
+        period.startMinute = parseTime(entry.left(dash).trimmed());
+        period.endMinute = parseTime(entry.mid(dash + 1, equals - dash - 1).trimmed());
+        period.limit = entry.mid(equals + 1).trimmed().toInt(&ok);
+
+        if(!ok || 0 > period.limit || MaximumLimit < period.limit || 0 > period.startMinute || MinutesPerDay <= period.startMinute || 0 > period.endMinute || period.startMinute == period.endMinute) {
+            return {};
+        }
+
+        ret.m_periods.push_back(period);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Write the schedule in its string form.
+ *
+ * @return The schedule, in the form fromString() reads.
+ */
+QString BandwidthSchedule::toString() const
+{
+    using Detail::BandwidthSchedule::formatTime;
+    QStringList entries;
+
+    for(const auto & period : m_periods) {
+        entries.push_back(formatTime(period.startMinute) % '-' % formatTime(period.endMinute) % '=' % QString::number(period.limit));
+    }
+
+    return entries.join(QStringLiteral(", "));
+}
+
+/**
+ * @brief Work out the limit at a time of day.
+ *
+ * @param time The time.
+ * @param defaultLimit The limit outside all the periods, in KiB per second.
+ *
+ * @return The limit in KiB per second, 0 for no limit.
+ */
+int BandwidthSchedule::limitAt(const QTime & time, int defaultLimit) const
+{
+    const auto minute = time.hour() * 60 + time.minute();
+
+    for(const auto & period : m_periods) {
+        if(Detail::BandwidthSchedule::contains(period, minute)) {
+            return period.limit;
+        }
+    }
+
+    return defaultLimit;
+}
+
+/**
+ * @brief Work out how long it is until the limit might next change.
+ *
+ * @param time The time now.
+ *
+ * @return The number of milliseconds until the next start or end of a period,
+ * or -1 if the schedule is empty.
+ */
+int BandwidthSchedule::msecsToNextChange(const QTime & time) const
+{
+    using Detail::BandwidthSchedule::MinutesPerDay;
+
+    if(m_periods.empty()) {
+        return -1;
+    }
+
+    const auto msecs = time.msecsSinceStartOfDay();
+    int next = std::numeric_limits<int>::max();
+
+    for(const auto & period : m_periods) {
+        for(const auto minute : {period.startMinute, period.endMinute}) {
+            auto until = minute * 60000 - msecs;
+
+            if(0 >= until) {
+                until += MinutesPerDay * 60000;
+            }
+
+            next = std::min(next, until);
+        }
+    }
+
+    return next;
+}
+
+/**
+ * @fn BandwidthSchedule::isEmpty()
+ * @brief Check whether the schedule has any periods.
+ *
+ * @return @b true if there are no periods, so the default limit always applies.
+ */
+
+/**
+ * @fn BandwidthSchedule::periods()
+ * @brief Fetch the periods in the schedule.
+ *
+ * @return The periods, in the order they were given.
+ */
@@ -0,0 +1,55 @@
+/**
+ * @file bandwidthschedule.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the BandwidthSchedule class.
+ */
+
+#ifndef QYNC_BANDWIDTHSCHEDULE_H
+#define QYNC_BANDWIDTHSCHEDULE_H
+
+#include <optional>
+#include <vector>
+
+#include <QtCore/QString>
+
+class QTime;
+
+namespace Qync {
+
+	class BandwidthSchedule {
+	public:
+		struct Period {
+			// minutes after midnight, the end up to 24:00. a period that ends before it starts runs past midnight
+			int startMinute = 0;
+			int endMinute = 0;
+
+			// KiB per second, 0 for no limit
+			int limit = 0;
+		};
+
+		BandwidthSchedule() = default;
+
+		[[nodiscard]] static std::optional<BandwidthSchedule> fromString(const QString & schedule);
+		[[nodiscard]] QString toString() const;
+
+		[[nodiscard]] inline bool isEmpty() const {
+			return m_periods.empty();
+		}
+
+		[[nodiscard]] inline const std::vector<Period> & periods() const {
+			return m_periods;
+		}
+
+		[[nodiscard]] int limitAt(const QTime & time, int defaultLimit) const;
+		[[nodiscard]] int msecsToNextChange(const QTime & time) const;
+
+	private:
+		std::vector<Period> m_periods;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_BANDWIDTHSCHEDULE_H
@@ -0,0 +1,528 @@
+/**
+ * @file changesetmodel.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the ChangeSetModel class.
+ */
+
+#include "changesetmodel.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+#include "functions.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::ChangeSetModel class.
+ */
+namespace Qync::Detail::ChangeSetModel {
+    // how long appended items wait before the views are told about them
+    static constexpr const int CommitInterval = 100;
+
+    // whether rsync sends the content of an item, rather than just creating it
+    // or adjusting it in place
+    static bool transfersData(const QString & changes)
+    {
+        return !changes.isEmpty() && ('<' == changes.at(0) || '>' == changes.at(0));
+    }
+}  // namespace Qync::Detail::ChangeSetModel
+
+/**
+ * @class ChangeSetModel
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief A compact table model of the changes rsync is making to a
+ * destination.
+ *
+ * The model is fed the items a Process lists (see Process::itemChanged()) and
+ * works out from rsync's itemised changes whether each one is new, updated,
+ * deleted or just having its attributes adjusted (see changeFor()). It is
+ * intended for dry runs, to show what a run would do - and what it would cost -
+ * before it is run for real: count() provides the number of items of each kind
+ * and bytesToSend() the total size of the files whose content would be sent.
+ * Sorting by size descending puts the largest items first.
+ *
+ * The model is designed to hold millions of items. It doesn't store the paths
+ * itself, just their Ids in the Process's PathStore (see Process::pathStore()),
+ * so an item costs 16 bytes plus what the store needs for its path, which it
+ * shares with the other views of the process. Paths are only built when they
+ * are shown.
+ *
+ * Sorting rearranges an array of item numbers rather than the items. Sorting
+ * by path uses PathStore::isBefore(), so it is the order rsync lists a tree in
+ * whether or not the run was split between several rsync processes.
+ *
+ * Appended items are not inserted into the model immediately. Instead they are
+ * committed in batches a short time later, or when commit() is called. Items
+ * committed after the model has been sorted are added at the end.
+ */
+
+/**
+ * @brief Create a new, empty, change set.
+ *
+ * @param parent The parent object.
+ */
+ChangeSetModel::ChangeSetModel(QObject * parent)
+:   QAbstractTableModel(parent),
+    m_paths(),
+    m_items(),
+    m_order(),
+    m_rowCount(0),
+    m_counts(),
+    m_bytesToSend(0),
+    m_commitTimer()
+{
+    m_commitTimer.setSingleShot(true);
+    m_commitTimer.setTimerType(Qt::CoarseTimer);
+    m_commitTimer.setInterval(Detail::ChangeSetModel::CommitInterval);
+    connect(&m_commitTimer, &QTimer::timeout, this, &ChangeSetModel::commit);
+}
+
+/**
+ * @brief Destroy the change set.
+ *
+ * The paths of its items are released.
+ */
+ChangeSetModel::~ChangeSetModel()
+{
+    releasePaths();
+}
+
+/**
+ * @brief Work out what rsync is doing to an item from its itemised changes.
+ *
+ * @param changes The changes, as given by rsync's @b %i output format (e.g.
+ * ">f.st......").
+ *
+ * An item whose attributes rsync lists as all new ('+') is new; an item that
+ * isn't being updated ('.') is only having its attributes changed, and an item
+ * that is being transferred, created or linked is updated.
+ *
+ * @return The change.
+ */
+ChangeSetModel::Change ChangeSetModel::changeFor(const QString & changes)
+{
+    if(changes.isEmpty()) {
+        return Change::Listed;
+    }
+
+    // "*deleting", or another message in place of the attributes
+    if('*' == changes.at(0)) {
+        return Change::Deleted;
+    }
+
+    if(2 < changes.size() && std::all_of(changes.cbegin() + 2, changes.cend(), [](QChar ch) {
+        return '+' == ch;
+    })) {
+        return Change::New;
+    }
+
+    if('.' == changes.at(0)) {
+        return Change::AttributesOnly;
+    }
+
+    return Change::Updated;
+}
+
+/**
+ * @brief Fetch the number of items in the model.
+ *
+ * @param parent The parent index. It must be invalid since this is a table model.
+ *
+ * @return The number of items.
+ */
+int ChangeSetModel::rowCount(const QModelIndex & parent) const
+{
+    if(parent.isValid()) {
+        return 0;
+    }
+
+    return m_rowCount;
+}
+
+/**
+ * @brief Fetch the number of columns in the model.
+ *
+ * @param parent The parent index. It must be invalid since this is a table model.
+ *
+ * @return The number of columns.
+ */
+int ChangeSetModel::columnCount(const QModelIndex & parent) const
+{
+    if(parent.isValid()) {
+        return 0;
+    }
+
+    return ColumnCount;
+}
+
+/**
+ * @brief Fetch the data for an item.
+ *
+ * @param index The index of the item.
+ * @param role The role for which the data is required.
+ *
+ * The display role provides the change, the formatted size or the path,
+ * depending on the column. SizeRole provides the size in bytes in any column.
+ *
+ * @return The data, or an invalid QVariant if the index or role is not valid.
+ */
+QVariant ChangeSetModel::data(const QModelIndex & index, int role) const
+{
+    if(!index.isValid() || index.parent().isValid() || 0 > index.row() || m_rowCount <= index.row()) {
+        return {};
+    }
+
+    const auto & item = itemAt(index.row());
+
+    switch(role) {
+        case Qt::DisplayRole:
+            switch(index.column()) {
+                case ChangeColumn:
+                    switch(item.change) {
+                        case Change::New:
+                            return tr("New");
+
+                        case Change::Updated:
+                            return tr("Updated");
+
+                        case Change::AttributesOnly:
+                            return tr("Attributes");
+
+                        case Change::Deleted:
+                            return tr("Deleted");
+
+                        case Change::Listed:
+                            return tr("Listed");
+                    }
+                    break;
+
+                case SizeColumn:
+                    return (isDirectory(item) || Change::Deleted == item.change ? QString() : formatSize(item.size));
+
+                case PathColumn:
+                    return path(index.row());
+            }
+            break;
+
+        case SizeRole:
+            return item.size;
+
+        case Qt::TextAlignmentRole:
+            if(SizeColumn == index.column()) {
+                return static_cast<int>(Qt::AlignRight | Qt::AlignVCenter);
+            }
+            break;
+
+        case Qt::ToolTipRole:
+            if(SizeColumn == index.column()) {
+                return tr("%1 bytes").arg(item.size);
+            }
+            break;
+    }
+
+    return {};
+}
+
+/**
+ * @brief Fetch the column headers.
+ *
+ * @param section The column.
+ * @param orientation The orientation of the header. Only the horizontal header
+ * has any data.
+ * @param role The role for which the data is required.
+ *
+ * @return The header, or an invalid QVariant if there isn't one.
+ */
+QVariant ChangeSetModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(Qt::Horizontal != orientation || Qt::DisplayRole != role) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch(section) {
+        case ChangeColumn:
+            return tr("Change");
+
+        case SizeColumn:
+            return tr("Size");
+
+        case PathColumn:
+            return tr("Path");
+    }
+
+    return {};
+}
+
+/**
+ * @brief Sort the items.
+ *
+ * @param column The column to sort by.
+ * @param order The order to sort in.
+ *
+ * Items that sort the same stay in the order rsync listed them. Any items that
+ * have been appended but not committed are committed first.
+ */
+void ChangeSetModel::sort(int column, Qt::SortOrder order)
+{
+    if(0 > column || ColumnCount <= column) {
+        return;
+    }
+
+    commit();
+    Q_EMIT layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+
+    // remember which items the persistent indices are for, to find them again afterwards
+    const auto persistent = persistentIndexList();
+    std::vector<quint32> persistentItems;
+    persistentItems.reserve(static_cast<std::size_t>(persistent.size()));
+
+    for(const auto & index : persistent) {
+        persistentItems.push_back(m_order.empty() ? static_cast<quint32>(index.row()) : m_order[static_cast<std::size_t>(index.row())]);
+    }
+
+    if(m_order.empty()) {
+        m_order.resize(m_items.size());
+        std::iota(m_order.begin(), m_order.end(), 0);
+    }
+
+    const bool descending = (Qt::DescendingOrder == order);
+
+    auto sortBy = [this, descending](auto isBefore) {
+        std::stable_sort(m_order.begin(), m_order.end(), [this, descending, &isBefore](quint32 first, quint32 second) {
+            const auto & firstItem = m_items[first];
+            const auto & secondItem = m_items[second];
+            return (descending ? isBefore(secondItem, firstItem) : isBefore(firstItem, secondItem));
+        });
+    };
+
+    switch(column) {
+        case ChangeColumn:
+            sortBy([](const Item & first, const Item & second) {
+                return first.change < second.change;
+            });
+            break;
+
+        case SizeColumn:
+            sortBy([](const Item & first, const Item & second) {
+                return first.size < second.size;
+            });
+            break;
+
+        case PathColumn:
+            if(m_paths) {
+                sortBy([this](const Item & first, const Item & second) {
+                    return m_paths->contains(first.path) && m_paths->contains(second.path) && m_paths->isBefore(first.path, second.path);
+                });
+            }
+            break;
+    }
+
+    if(!persistent.isEmpty()) {
+        std::vector<int> rowOf(m_order.size());
+
+        for(std::size_t row = 0; row < m_order.size(); ++row) {
+            rowOf[m_order[row]] = static_cast<int>(row);
+        }
+
+        QModelIndexList moved;
+        moved.reserve(persistent.size());
+
+        for(int index = 0; index < persistent.size(); ++index) {
+            moved.push_back(createIndex(rowOf[persistentItems[static_cast<std::size_t>(index)]], persistent[index].column()));
+        }
+
+        changePersistentIndexList(persistent, moved);
+    }
+
+    Q_EMIT layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+/**
+ * @brief Set the store that holds the paths of the items.
+ *
+ * @param paths The store.
+ *
+ * The model is cleared, since the Ids of its items are only meaningful in the
+ * store they came from.
+ */
+void ChangeSetModel::setPathStore(std::shared_ptr<const PathStore> paths)
+{
+    clear();
+    m_paths = std::move(paths);
+}
+
+/**
+ * @brief Fetch the path of the item in a row.
+ *
+ * @param row The row.
+ *
+ * @return The path, relative to the source, with a trailing '/' for
+ * directories.
+ */
+QString ChangeSetModel::path(int row) const
+{
+    if(!m_paths) {
+        return {};
+    }
+
+    return m_paths->path(itemAt(row).path);
+}
+
+/**
+ * @brief Estimate the memory used to store the items.
+ *
+ * This doesn't include the path store, which is shared.
+ *
+ * @return The number of bytes.
+ */
+std::size_t ChangeSetModel::memoryUsed() const
+{
+    return m_items.capacity() * sizeof(Item)
+           + m_order.capacity() * sizeof(quint32);
+}
+
+/**
+ * @brief Add an item to the change set.
+ *
+ * @param path The Id of the path of the item in the path store.
+ * @param changes rsync's itemised changes for the item. This can be empty if
+ * rsync wasn't asked for them, in which case the item is Change::Listed.
+ * @param size The size of the item in bytes.
+ */
+void ChangeSetModel::append(PathStore::Id path, const QString & changes, quint64 size)
+{
+    if(m_paths) {
+        m_paths->retain(path);
+    }
+
+    const auto change = changeFor(changes);
+    m_items.push_back({size, path, change});
+    ++m_counts[static_cast<std::size_t>(change)];
+
+    if(!isDirectory(m_items.back()) && (Change::Listed == change || ((Change::New == change || Change::Updated == change) && Detail::ChangeSetModel::transfersData(changes)))) {
+        m_bytesToSend += size;
+    }
+
+    if(!m_commitTimer.isActive()) {
+        m_commitTimer.start();
+    }
+}
+
+/**
+ * @brief Insert all the appended items into the model.
+ */
+void ChangeSetModel::commit()
+{
+    m_commitTimer.stop();
+    const auto itemCount = static_cast<int>(m_items.size());
+
+    if(itemCount > m_rowCount) {
+        beginInsertRows({}, m_rowCount, itemCount - 1);
+
+        if(!m_order.empty()) {
+            for(auto item = static_cast<quint32>(m_rowCount); item < static_cast<quint32>(itemCount); ++item) {
+                m_order.push_back(item);
+            }
+        }
+
+        m_rowCount = itemCount;
+        endInsertRows();
+    }
+}
+
+/**
+ * @brief Remove all the items from the change set.
+ */
+void ChangeSetModel::clear()
+{
+    m_commitTimer.stop();
+    beginResetModel();
+    releasePaths();
+    m_items.clear();
+    m_order.clear();
+    m_rowCount = 0;
+    m_counts.fill(0);
+    m_bytesToSend = 0;
+    endResetModel();
+}
+
+/**
+ * @brief Release the paths of all the items.
+ *
+ * The model keeps a reference to the path of each item it holds. The Ids of
+ * the items must not be used afterwards.
+ */
+void ChangeSetModel::releasePaths()
+{
+    if(!m_paths) {
+        return;
+    }
+
+    for(const auto & item : m_items) {
+        m_paths->release(item.path);
+    }
+}
+
+/**
+ * @brief Fetch the item in a row.
+ *
+ * @param row The row. It must be valid.
+ *
+ * @return The item.
+ */
+const ChangeSetModel::Item & ChangeSetModel::itemAt(int row) const
+{
+    const auto index = static_cast<std::size_t>(row);
+    return m_items[m_order.empty() ? index : m_order[index]];
+}
+
+/**
+ * @brief Check whether an item is a directory.
+ *
+ * @param item The item.
+ *
+ * @return @b true if the path store says it's a directory, @b false otherwise.
+ */
+bool ChangeSetModel::isDirectory(const Item & item) const
+{
+    return m_paths && m_paths->contains(item.path) && m_paths->isDirectory(item.path);
+}
+
+/**
+ * @fn ChangeSetModel::pathStore()
+ * @brief Fetch the store that holds the paths of the items.
+ *
+ * @return The store, or @b nullptr if it hasn't been set.
+ */
+
+/**
+ * @fn ChangeSetModel::count(Change)
+ * @brief Fetch the number of items with a given change.
+ *
+ * @param change The change.
+ *
+ * This includes items that have not yet been committed.
+ *
+ * @return The number of items.
+ */
+
+/**
+ * @fn ChangeSetModel::bytesToSend()
+ * @brief Fetch the total size of the files whose content is being sent.
+ *
+ * This is the size of the new files and of the updated files that are being
+ * transferred rather than just having their attributes changed. rsync's delta
+ * transfer usually sends much less than this for files that already exist at
+ * the destination, so it's an upper bound. For Change::Listed items it
+ * includes every file.
+ *
+ * @return The number of bytes.
+ */
@@ -0,0 +1,112 @@
+/**
+ * @file changesetmodel.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the ChangeSetModel class.
+ */
+
+#ifndef QYNC_CHANGESETMODEL_H
+#define QYNC_CHANGESETMODEL_H
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QAbstractTableModel>
+#include <QtCore/QTimer>
+
+#include "pathstore.h"
+
+namespace Qync {
+
+	class ChangeSetModel
+	: public QAbstractTableModel {
+		Q_OBJECT
+
+	public:
+		enum class Change : quint8 {
+			New = 0,
+			Updated,
+			AttributesOnly,
+			Deleted,
+
+			// rsync didn't say, because the output format doesn't have the itemised changes
+			Listed,
+		};
+
+		static constexpr const int ChangeCount = static_cast<int>(Change::Listed) + 1;
+
+		enum Column {
+			ChangeColumn = 0,
+			SizeColumn,
+			PathColumn,
+		};
+
+		static constexpr const int ColumnCount = PathColumn + 1;
+		static constexpr const int SizeRole = Qt::UserRole;
+
+		explicit ChangeSetModel(QObject * parent = nullptr);
+		~ChangeSetModel() override;
+
+		[[nodiscard]] static Change changeFor(const QString & changes);
+
+		[[nodiscard]] int rowCount(const QModelIndex & parent = {}) const override;
+		[[nodiscard]] int columnCount(const QModelIndex & parent = {}) const override;
+		[[nodiscard]] QVariant data(const QModelIndex & index, int role = Qt::DisplayRole) const override;
+		[[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+		void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+		[[nodiscard]] inline const std::shared_ptr<const PathStore> & pathStore() const {
+			return m_paths;
+		}
+
+		void setPathStore(std::shared_ptr<const PathStore> paths);
+
+		[[nodiscard]] QString path(int row) const;
+
+		[[nodiscard]] inline int count(Change change) const {
+			return m_counts[static_cast<std::size_t>(change)];
+		}
+
+		[[nodiscard]] inline quint64 bytesToSend() const {
+			return m_bytesToSend;
+		}
+
+		[[nodiscard]] std::size_t memoryUsed() const;
+
+		void clear();
+
+	public Q_SLOTS:
+		void append(PathStore::Id path, const QString & changes, quint64 size);
+		void commit();
+
+	private:
+		struct Item {
+			quint64 size;
+			PathStore::Id path;
+			Change change;
+		};
+
+		[[nodiscard]] const Item & itemAt(int row) const;
+		[[nodiscard]] bool isDirectory(const Item & item) const;
+		void releasePaths();
+
+		std::shared_ptr<const PathStore> m_paths;
+		std::vector<Item> m_items;
+
+		/* the item shown in each row, empty while the rows are in the order rsync
+		 * listed them */
+		std::vector<quint32> m_order;
+
+		/* rows the views know about; items beyond this are waiting for commit() */
+		int m_rowCount;
+		std::array<int, ChangeCount> m_counts;
+		quint64 m_bytesToSend;
+		QTimer m_commitTimer;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_CHANGESETMODEL_H
@@ -0,0 +1,709 @@
+/**
+ * @file cliapplication.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the CliApplication class.
+ */
+
+#include "cliapplication.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <QtCore/QCommandLineOption>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMetaObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QStringBuilder>
+
+#include "applicationinfo.h"
+#include "preset.h"
+#include "presetbundlereader.h"
+#include "presetbundlewriter.h"
+#include "presetindex.h"
+#include "rsyncprobe.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::CliApplication class.
+ */
+namespace Qync::Detail::CliApplication {
+    // the options that select the headless application when given to the GUI executable
+    static constexpr const char * const HeadlessOptions[] = {"--run", "--queue", "--list-presets", "--import-presets", "--export-presets"};
+
+    static constexpr const int DefaultProgressInterval = 1000;
+
+    // exit code when the command line or the presets requested are not valid (same as rsync's)
+    static constexpr const int UsageErrorExitCode = static_cast<int>(Qync::Process::ExitCode::SyntaxError);
+
+    static const char * stateText(Qync::JobScheduler::JobState state)
+    {
+        switch(state) {
+            case Qync::JobScheduler::JobState::Queued:
+                return "queued";
+
+            case Qync::JobScheduler::JobState::Running:
+                return "running";
+
+            case Qync::JobScheduler::JobState::Succeeded:
+                return "succeeded";
+
+            case Qync::JobScheduler::JobState::Failed:
+                return "failed";
+
+            case Qync::JobScheduler::JobState::Interrupted:
+                return "interrupted";
+
+            case Qync::JobScheduler::JobState::Cancelled:
+                return "cancelled";
+        }
+
+        return "unknown";
+    }
+
+    // fields are tab-separated and records newline-terminated, so neither may appear unescaped in a field
+    static QString escapeField(QString field)
+    {
+        return field.replace('\\', QStringLiteral("\\\\")).replace('\t', QStringLiteral("\\t")).replace('\n', QStringLiteral("\\n")).replace('\r', QStringLiteral("\\r"));
+    }
+}  // namespace Qync::Detail::CliApplication
+
+/**
+ * @class CliApplication
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Runs presets without a user interface.
+ *
+ * This is the application for headless use, e.g. from cron or a systemd
+ * timer. It is a QCoreApplication, so it needs no display and none of the
+ * widget code is initialised. It reads the same preferences and presets as the
+ * GUI and runs the requested presets with a JobScheduler, so the maximum number
+ * of concurrent synchronisations and the device serialisation are the same as
+ * for jobs queued in the GUI.
+ *
+ * The presets to run are given with --run (which can be repeated) or --queue
+ * (a comma-separated list). Each is either the name of a preset or the path to
+ * a preset file. --dry-run simulates the synchronisations. --jobs overrides the
+ * maximum number of concurrent synchronisations, --bwlimit the bandwidth they
+ * share and --rsync the rsync command.
+ * --list-presets prints the names of the available presets. --import-presets
+ * adds all the presets in a bundle (see PresetBundleReader) to the stored
+ * presets, and --export-presets writes all the stored presets to a bundle;
+ * either can be used on its own or before running presets. --watch keeps the
+ * application running after the presets have been synchronised, and
+ * synchronises each of them again whenever its source changes (see
+ * PresetWatcher); all the presets must have local directory sources.
+ *
+ * Progress is written to standard output as one record per line, with the
+ * fields separated by tabs (tabs, newlines and backslashes in fields are
+ * escaped with a backslash). The first field identifies the record:
+ * - queued <id> <preset>
+ * - started <id> <preset>
+ * - progress <id> <percent> <bytes per second> <bytes> <items> <seconds remaining>
+ * - item <id> <path> <size> (only with --items)
+ * - retry <id> <rsync exit code> <attempt> <seconds until the retry>
+ * - finished <id> <rsync exit code> <state> <bytes> <items> <milliseconds>
+ * - summary <succeeded> <jobs> <bytes> <bytes per second> (not with --watch)
+ * - watching <preset> <directories> (only with --watch)
+ * - batch <id> <preset> <paths> (only with --watch)
+ * - imported <presets> (only with --import-presets)
+ * - exported <presets> (only with --export-presets)
+ *
+ * Progress records are written for each running job at the interval given
+ * with --progress-interval (in milliseconds; 0 to disable them). The time
+ * remaining is -1 unless it can be estimated from a scan of the job's source
+ * (see Process::setScanSource()). Errors are written to standard error.
+ *
+ * The exit code is 0 if all the synchronisations succeeded. Otherwise it is
+ * rsync's exit code for the first preset (in the order given) that did not
+ * succeed, so when a single preset is run the exit code is rsync's. If the
+ * command line is not valid or a preset can't be found, nothing is run and the
+ * exit code is 1, which rsync also uses for usage errors.
+ */
+
+/**
+ * @brief Create a new headless application.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The command-line arguments.
+ *
+ * The preferences are loaded from the same location as the GUI's. The
+ * presets are not loaded until run() is called.
+ */
+CliApplication::CliApplication(int & argc, char ** argv)
+:   QCoreApplication(argc, argv),
+    m_configPath(),
+    m_presetsPath(),
+    m_prefs(),
+    m_presets(),
+    m_scheduler(),
+    m_watchers(),
+    m_progress(),
+    m_progressTimer(),
+    m_out(stdout),
+    m_reportItems(false),
+    m_exitCode(0),
+    m_exitCodeJob(0)
+{
+    setApplicationName(ApplicationInfo::Name);
+    setApplicationVersion(ApplicationInfo::VersionString);
+    setOrganizationName(ApplicationInfo::OrganisationName);
+    setOrganizationDomain(ApplicationInfo::OrganisationDomain);
+
+    // must come after the names are set, since QStandardPaths uses them
+    m_configPath = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation);
+    m_presetsPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) % "/presets";
+
+    // the GUI's preferences file; the GUI-only settings in it are skipped
+    m_prefs.loadFrom(m_configPath + "/guipreferences");
+    m_scheduler.applyPreferences(m_prefs);
+
+    connect(&m_scheduler, &JobScheduler::jobQueued, this, [this](JobScheduler::JobId id) {
+        writeRecord({QStringLiteral("queued"), QString::number(id), m_scheduler.job(id)->name});
+    });
+
+    connect(&m_scheduler, &JobScheduler::jobStarted, this, &CliApplication::onJobStarted);
+    connect(&m_scheduler, &JobScheduler::jobFinished, this, &CliApplication::onJobFinished);
+    connect(&m_scheduler, &JobScheduler::queueFinished, this, &CliApplication::onQueueFinished);
+    connect(&m_progressTimer, &QTimer::timeout, this, &CliApplication::reportProgress);
+}
+
+/**
+ * @brief Destroy the application.
+ *
+ * Any synchronisations still running are killed.
+ */
+CliApplication::~CliApplication() = default;
+
+/**
+ * @brief Check whether a command line asks for the headless application.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The command-line arguments.
+ *
+ * This is used by the GUI executable to decide which application to create,
+ * so it must be called before any application object exists.
+ *
+ * @return @b true if any of the arguments is --run, --queue, --list-presets,
+ * --import-presets or --export-presets, @b false otherwise.
+ */
+bool CliApplication::isHeadlessInvocation(int argc, char ** argv)
+{
+    for(int index = 1; index < argc; ++index) {
+        for(const auto * option : Detail::CliApplication::HeadlessOptions) {
+            auto length = std::strlen(option);
+
+            // accepts both "--run name" and "--run=name"
+            if(0 == std::strncmp(argv[index], option, length) && ('\0' == argv[index][length] || '=' == argv[index][length])) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Parse the command line, run the requested presets and wait for them to
+ * finish.
+ *
+ * @return The exit code for the application.
+ */
+int CliApplication::run()
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(tr("Run Qync presets without a user interface."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption runOption("run", tr("Run the preset <preset> (a name or a preset file). Can be given more than once."), tr("preset"));
+    QCommandLineOption queueOption("queue", tr("Run the comma-separated list of presets <presets>."), tr("presets"));
+    QCommandLineOption dryRunOption("dry-run", tr("Simulate the synchronisations."));
+    QCommandLineOption jobsOption("jobs", tr("Run at most <count> synchronisations at once."), tr("count"));
+    QCommandLineOption bandwidthOption("bwlimit", tr("Share <KiB/s> of bandwidth between the synchronisations running at once, or no limit if 0."), tr("KiB/s"));
+    QCommandLineOption rsyncOption("rsync", tr("Use the rsync command <path>."), tr("path"));
+    QCommandLineOption intervalOption("progress-interval", tr("Report progress every <ms> milliseconds, or never if 0."), tr("ms"), QString::number(Detail::CliApplication::DefaultProgressInterval));
+    QCommandLineOption itemsOption("items", tr("Report each item transferred."));
+    QCommandLineOption listOption("list-presets", tr("List the available presets and exit."));
+    QCommandLineOption watchOption("watch", tr("Keep running and synchronise each preset again whenever its source changes."));
+    QCommandLineOption importOption("import-presets", tr("Add the presets in the bundle <file> to the stored presets."), tr("file"));
+    QCommandLineOption exportOption("export-presets", tr("Write all the stored presets to the bundle <file>."), tr("file"));
+    parser.addOptions({runOption, queueOption, dryRunOption, jobsOption, bandwidthOption, rsyncOption, intervalOption, itemsOption, listOption, watchOption, importOption, exportOption});
+    parser.process(*this);
+
+    loadPresets();
+
+    if(parser.isSet(importOption) && 0 > importPresets(parser.value(importOption))) {
+        return Detail::CliApplication::UsageErrorExitCode;
+    }
+
+    if(parser.isSet(exportOption) && !exportPresets(parser.value(exportOption))) {
+        return Detail::CliApplication::UsageErrorExitCode;
+    }
+
+    if(parser.isSet(listOption)) {
+        listPresets();
+        return 0;
+    }
+
+    QStringList presetNames = parser.values(runOption);
+
+    for(const auto & list : parser.values(queueOption)) {
+        presetNames.append(list.split(',', QString::SkipEmptyParts));
+    }
+
+    if(presetNames.isEmpty() && (parser.isSet(importOption) || parser.isSet(exportOption))) {
+        // only managing the stored presets
+        return 0;
+    }
+
+    if(presetNames.isEmpty()) {
+        std::fputs(qPrintable(tr("No presets given. Use --run or --queue.\n")), stderr);
+        return Detail::CliApplication::UsageErrorExitCode;
+    }
+
+    if(parser.isSet(jobsOption)) {
+        bool ok;
+        int jobs = parser.value(jobsOption).toInt(&ok);
+
+        if(!ok || Preferences::MinimumConcurrentJobs > jobs || Preferences::MaximumConcurrentJobs < jobs) {
+            std::fputs(qPrintable(tr("The number of jobs must be between %1 and %2.\n").arg(Preferences::MinimumConcurrentJobs).arg(Preferences::MaximumConcurrentJobs)), stderr);
+            return Detail::CliApplication::UsageErrorExitCode;
+        }
+
+        m_scheduler.setMaximumConcurrentJobs(jobs);
+    }
+
+    if(parser.isSet(bandwidthOption)) {
+        bool ok;
+        int budget = parser.value(bandwidthOption).toInt(&ok);
+
+        if(!ok || 0 > budget || Preferences::MaximumBandwidthBudget < budget) {
+            std::fputs(qPrintable(tr("The bandwidth must be between 0 and %1 KiB/s.\n").arg(Preferences::MaximumBandwidthBudget)), stderr);
+            return Detail::CliApplication::UsageErrorExitCode;
+        }
+
+        m_scheduler.setBandwidthBudget(budget);
+    }
+
+    if(parser.isSet(rsyncOption)) {
+        m_scheduler.setRsyncPath(parser.value(rsyncOption));
+    }
+
+    bool ok;
+    int interval = parser.value(intervalOption).toInt(&ok);
+
+    if(!ok || 0 > interval) {
+        std::fputs(qPrintable(tr("The progress interval must be a number of milliseconds.\n")), stderr);
+        return Detail::CliApplication::UsageErrorExitCode;
+    }
+
+    m_reportItems = parser.isSet(itemsOption);
+
+    // resolve everything before queueing anything, so a typo doesn't leave a partial run
+    std::vector<const Preset *> presets;
+
+    for(const auto & name : presetNames) {
+        const auto * preset = findPreset(name.trimmed());
+
+        if(!preset) {
+            std::fputs(qPrintable(tr("Preset \"%1\" not found.\n").arg(name)), stderr);
+            return Detail::CliApplication::UsageErrorExitCode;
+        }
+
+        if(parser.isSet(watchOption) && !PresetWatcher::canWatch(*preset)) {
+            std::fputs(qPrintable(tr("The source of preset \"%1\" can't be watched because it is not a local directory.\n").arg(name)), stderr);
+            return Detail::CliApplication::UsageErrorExitCode;
+        }
+
+        presets.push_back(preset);
+    }
+
+    // only now that something is going to be run is it worth asking rsync. this is cached, so it
+    // usually costs nothing, and there's no UI to keep responsive so it's fine to wait if it doesn't
+    RsyncProbe probe(m_configPath + "/rsynccapabilities");
+    probe.probe(m_scheduler.rsyncPath());
+    probe.waitForFinished();
+    m_scheduler.setOutputFormat(Process::outputFormatFor(probe.capabilities()));
+
+    if(parser.isSet(watchOption)) {
+        if(parser.isSet(dryRunOption)) {
+            std::fputs(qPrintable(tr("--watch can't be used with --dry-run.\n")), stderr);
+            return Detail::CliApplication::UsageErrorExitCode;
+        }
+
+        // each watcher queues its preset's first synchronisation itself
+        for(const auto * preset : presets) {
+            auto watcher = std::make_unique<PresetWatcher>(*preset, m_scheduler);
+
+            connect(watcher.get(), &PresetWatcher::watching, this, [this, preset](int directories) {
+                writeRecord({QStringLiteral("watching"), preset->name(), QString::number(directories)});
+            });
+
+            connect(watcher.get(), &PresetWatcher::batchQueued, this, [this, preset](JobScheduler::JobId id, int paths) {
+                writeRecord({QStringLiteral("batch"), QString::number(id), preset->name(), QString::number(paths)});
+            });
+
+            watcher->start();
+            m_watchers.push_back(std::move(watcher));
+        }
+
+        if(0 < interval) {
+            m_progressTimer.start(interval);
+        }
+
+        return exec();
+    }
+
+    for(const auto * preset : presets) {
+        auto type = Process::RunType::Normal;
+
+        if(parser.isSet(dryRunOption)) {
+            type = Process::RunType::DryRun;
+        }
+        else if(1 < preset->shardCount()) {
+            type = Process::RunType::Parallel;
+        }
+
+        m_scheduler.enqueue(*preset, type);
+    }
+
+    if(0 < interval) {
+        m_progressTimer.start(interval);
+    }
+
+    return exec();
+}
+
+/**
+ * @brief Load all the presets in the presets directory.
+ *
+ * The preset index shared with the desktop application is used so that only
+ * presets that are new or have changed are parsed; the others are loaded when
+ * they are found by findPreset().
+ *
+ * @return @b true if the presets directory could be read, @b false otherwise.
+ */
+bool CliApplication::loadPresets()
+{
+    QDir presetDir(m_presetsPath);
+
+    if(!presetDir.exists()) {
+        return false;
+    }
+
+    PresetIndex index(m_configPath + "/presetindex");
+    index.load();
+    QSet<QString> presetFileNames;
+
+    for(const auto & fileInfo : presetDir.entryInfoList(QDir::Files | QDir::Readable)) {
+        const auto fileName = fileInfo.absoluteFilePath();
+        auto preset = std::make_unique<Preset>();
+        presetFileNames.insert(fileName);
+
+        if(const auto name = index.name(fileInfo); name) {
+            preset->setUnloaded(fileName, *name);
+        }
+        else if(preset->load(fileName)) {
+            index.setName(fileInfo, preset->name());
+        }
+        else {
+            qWarning() << __PRETTY_FUNCTION__ << "failed to load preset from file" << fileInfo.fileName();
+            index.remove(fileName);
+            continue;
+        }
+
+        m_presets.push_back(std::move(preset));
+    }
+
+    index.retainOnly(presetFileNames);
+
+    if(!index.save()) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to save preset index to" << index.fileName();
+    }
+
+    return true;
+}
+
+/**
+ * @brief Find a preset to run.
+ *
+ * @param nameOrFile The name of one of the stored presets, or the path to a
+ * preset file.
+ *
+ * Names take precedence over files.
+ *
+ * @return The preset, or @b nullptr if it can't be found.
+ */
+const Preset * CliApplication::findPreset(const QString & nameOrFile)
+{
+    for(const auto & preset : m_presets) {
+        if(preset->name() == nameOrFile) {
+            return (preset->ensureLoaded() ? preset.get() : nullptr);
+        }
+    }
+
+    if(!QFileInfo(nameOrFile).isFile()) {
+        return nullptr;
+    }
+
+    auto preset = std::make_unique<Preset>();
+
+    if(!preset->load(nameOrFile)) {
+        return nullptr;
+    }
+
+    m_presets.push_back(std::move(preset));
+    return m_presets.back().get();
+}
+
+/**
+ * @brief Write the names of the available presets to standard output.
+ */
+void CliApplication::listPresets()
+{
+    for(const auto & preset : m_presets) {
+        m_out << Detail::CliApplication::escapeField(preset->name()) << '\n';
+    }
+
+    m_out.flush();
+}
+
+/**
+ * @brief Add all the presets in a bundle to the stored presets.
+ *
+ * @param fileName The path to the bundle.
+ *
+ * The presets are saved in the presets directory, so the GUI will see them
+ * too. If the bundle is damaged part way through, the presets before the
+ * damage are still imported. Errors are written to standard error.
+ *
+ * @return The number of presets imported, or -1 if the bundle could not be
+ * read or is not valid.
+ */
+int CliApplication::importPresets(const QString & fileName)
+{
+    QFile file(fileName);
+
+    if(!file.open(QIODevice::ReadOnly)) {
+        std::fputs(qPrintable(tr("The preset bundle \"%1\" could not be opened: %2\n").arg(fileName, file.errorString())), stderr);
+        return -1;
+    }
+
+    PresetBundleReader reader(file);
+    int imported = reader.readAllInto(m_presetsPath, m_presets, m_prefs.presetFileFormat());
+
+    if(reader.hasError()) {
+        std::fputs(qPrintable(tr("The preset bundle \"%1\" is not valid: %2 (%3 preset(s) imported)\n").arg(fileName, reader.errorString()).arg(imported)), stderr);
+        return -1;
+    }
+
+    writeRecord({QStringLiteral("imported"), QString::number(imported)});
+    return imported;
+}
+
+/**
+ * @brief Write all the stored presets to a bundle.
+ *
+ * @param fileName The path to the bundle.
+ *
+ * Presets that can't be loaded are left out. The file is replaced atomically.
+ * Errors are written to standard error.
+ *
+ * @return @b true if the bundle was written, @b false otherwise.
+ */
+bool CliApplication::exportPresets(const QString & fileName)
+{
+    QSaveFile file(fileName);
+
+    if(!file.open(QIODevice::WriteOnly)) {
+        std::fputs(qPrintable(tr("The preset bundle \"%1\" could not be opened: %2\n").arg(fileName, file.errorString())), stderr);
+        return false;
+    }
+
+    PresetBundleWriter writer(file);
+
+    for(const auto & preset : m_presets) {
+        if(!preset->ensureLoaded()) {
+            std::fputs(qPrintable(tr("Leaving out preset \"%1\", which could not be loaded.\n").arg(preset->name())), stderr);
+            continue;
+        }
+
+        if(!writer.write(*preset)) {
+            break;
+        }
+    }
+
+    if(!writer.finish() || !file.commit()) {
+        std::fputs(qPrintable(tr("The presets could not be written to \"%1\": %2\n").arg(fileName, file.errorString())), stderr);
+        return false;
+    }
+
+    writeRecord({QStringLiteral("exported"), QString::number(writer.presetCount())});
+    return true;
+}
+
+/**
+ * @brief Called when the scheduler starts a job.
+ *
+ * @param id The ID of the job.
+ */
+void CliApplication::onJobStarted(JobScheduler::JobId id)
+{
+    const auto * job = m_scheduler.job(id);
+    Q_ASSERT_X(job, __PRETTY_FUNCTION__, "started job not found");
+    m_progress[id] = {};
+    auto * process = job->process.get();
+
+    connect(process, &Process::overallProgress, this, [this, id](int percent) {
+        m_progress[id].percent = percent;
+    });
+
+    connect(process, &Process::transferSpeed, this, [this, id](float bytesPerSecond) {
+        m_progress[id].bytesPerSecond = bytesPerSecond;
+    });
+
+    connect(process, &Process::overallSecondsRemaining, this, [this, id](int seconds) {
+        m_progress[id].secondsRemaining = seconds;
+    });
+
+    connect(process, &Process::retrying, this, [this, id](Process::ExitCode code, int attempt, int seconds) {
+        writeRecord({QStringLiteral("retry"), QString::number(id), QString::number(static_cast<int>(code)), QString::number(attempt), QString::number(seconds)});
+    });
+
+    if(m_reportItems) {
+        // the process creates the store for the run's paths as it starts
+        connect(process, &Process::started, this, [this, id, process]() {
+            m_progress[id].paths = process->pathStore();
+        });
+
+        connect(process, &Process::itemStarted, this, [this, id, process](PathStore::Id path, quint64 size) {
+            writeRecord({QStringLiteral("item"), QString::number(id), process->pathStore()->path(path), QString::number(size)});
+        });
+    }
+
+    writeRecord({QStringLiteral("started"), QString::number(id), job->name});
+}
+
+/**
+ * @brief Called when a job has finished.
+ *
+ * @param id The ID of the job.
+ * @param code The rsync exit code.
+ */
+void CliApplication::onJobFinished(JobScheduler::JobId id, Process::ExitCode code)
+{
+    const auto * job = m_scheduler.job(id);
+    Q_ASSERT_X(job, __PRETTY_FUNCTION__, "finished job not found");
+    m_progress.erase(id);
+
+    // jobs are queued in the order given, so the lowest ID is the first preset that failed
+    if(Process::ExitCode::Success != code) {
+        if(0 == m_exitCode || id < m_exitCodeJob) {
+            m_exitCode = static_cast<int>(code);
+            m_exitCodeJob = id;
+        }
+    }
+
+    writeRecord({
+      QStringLiteral("finished"),
+      QString::number(id),
+      QString::number(static_cast<int>(code)),
+      QString::fromLatin1(Detail::CliApplication::stateText(job->state)),
+      QString::number(job->bytes),
+      QString::number(job->items),
+      QString::number(job->elapsedMs),
+    });
+}
+
+/**
+ * @brief Called when all the jobs have finished.
+ *
+ * The summary is written and the event loop is asked to exit with the
+ * application's exit code.
+ */
+void CliApplication::onQueueFinished()
+{
+    if(!m_watchers.empty()) {
+        // watching never finishes; the queue just goes quiet between batches. the
+        // finished processes are forgotten from the event loop, never from inside
+        // a chain of their own signals
+        QMetaObject::invokeMethod(&m_scheduler, &JobScheduler::clearFinished, Qt::QueuedConnection);
+        return;
+    }
+
+    m_progressTimer.stop();
+    int succeeded = 0;
+
+    for(const auto & job : m_scheduler.jobs()) {
+        if(JobScheduler::JobState::Succeeded == job.state) {
+            ++succeeded;
+        }
+    }
+
+    writeRecord({
+      QStringLiteral("summary"),
+      QString::number(succeeded),
+      QString::number(m_scheduler.jobs().size()),
+      QString::number(m_scheduler.totalBytes()),
+      QString::number(m_scheduler.throughput(), 'f', 0),
+    });
+
+    exit(m_exitCode);
+}
+
+/**
+ * @brief Write a progress record for each running job.
+ */
+void CliApplication::reportProgress()
+{
+    for(const auto & [id, progress] : m_progress) {
+        const auto * job = m_scheduler.job(id);
+
+        writeRecord({
+          QStringLiteral("progress"),
+          QString::number(id),
+          QString::number(progress.percent),
+          QString::number(static_cast<double>(progress.bytesPerSecond), 'f', 0),
+          QString::number(job->bytes),
+          QString::number(job->items),
+          QString::number(progress.secondsRemaining),
+        });
+    }
+}
+
+/**
+ * @brief Write a record to standard output.
+ *
+ * @param fields The fields of the record.
+ *
+ * The output is flushed after each record so that a reader on a pipe sees it
+ * straight away.
+ */
+void CliApplication::writeRecord(const QStringList & fields)
+{
+    bool first = true;
+
+    for(const auto & field : fields) {
+        if(!first) {
+            m_out << '\t';
+        }
+
+        m_out << Detail::CliApplication::escapeField(field);
+        first = false;
+    }
+
+    m_out << '\n';
+    m_out.flush();
+}
@@ -0,0 +1,82 @@
+/**
+ * @file cliapplication.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the CliApplication class.
+ */
+
+#ifndef QYNC_CLIAPPLICATION_H
+#define QYNC_CLIAPPLICATION_H
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+#include <QtCore/QTimer>
+
+#include "jobscheduler.h"
+#include "preferences.h"
+#include "presetwatcher.h"
+
+namespace Qync {
+
+	class Preset;
+
+	class CliApplication
+	: public QCoreApplication {
+		Q_OBJECT
+
+	public:
+		CliApplication(int & argc, char ** argv);
+		~CliApplication() override;
+
+		[[nodiscard]] static bool isHeadlessInvocation(int argc, char ** argv);
+
+		int run();
+
+	private:
+		struct JobProgress {
+			int percent = 0;
+			float bytesPerSecond = 0.0f;
+			int secondsRemaining = -1;
+
+			// held while items are reported, so that the process keeps their paths
+			std::shared_ptr<const PathStore> paths;
+		};
+
+		bool loadPresets();
+		[[nodiscard]] const Preset * findPreset(const QString & nameOrFile);
+		void listPresets();
+		[[nodiscard]] int importPresets(const QString & fileName);
+		[[nodiscard]] bool exportPresets(const QString & fileName);
+
+		void onJobStarted(JobScheduler::JobId id);
+		void onJobFinished(JobScheduler::JobId id, Process::ExitCode code);
+		void onQueueFinished();
+		void reportProgress();
+
+		void writeRecord(const QStringList & fields);
+
+		QString m_configPath;
+		QString m_presetsPath;
+		Preferences m_prefs;
+		std::vector<std::unique_ptr<Preset>> m_presets;
+		JobScheduler m_scheduler;
+		std::vector<std::unique_ptr<PresetWatcher>> m_watchers;
+		std::map<JobScheduler::JobId, JobProgress> m_progress;
+		QTimer m_progressTimer;
+		QTextStream m_out;
+		bool m_reportItems;
+		int m_exitCode;
+		JobScheduler::JobId m_exitCodeJob;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_CLIAPPLICATION_H
@@ -0,0 +1,24 @@
+/**
+ * @file climain.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Qync command-line application file.
+ *
+ * This file implements the main() function for qync-cli, the headless
+ * application that runs presets without linking any widget code.
+ */
+
+#include "cliapplication.h"
+
+/**
+ * @brief The main entry point for the Qync command-line application.
+ *
+ * @return 0 if all the presets were run successfully, rsync's exit code for the
+ * first one that was not otherwise.
+ */
+int main(int argc, char ** argv) {
+	Qync::CliApplication app(argc, argv);
+	return app.run();
+}
@@ -0,0 +1,281 @@
+/**
+ * @file diagnosticsdialogue.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the DiagnosticsDialogue class.
+ */
+
+#include "diagnosticsdialogue.h"
+#include "ui_diagnosticsdialogue.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QLocale>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtGui/QHideEvent>
+#include <QtGui/QShowEvent>
+#include <QtWidgets/QFileDialog>
+#include <QtWidgets/QMessageBox>
+#include <QtWidgets/QPushButton>
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+#include "application.h"
+#include "functions.h"
+#include "instrumentation.h"
+#include "processworker.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::DiagnosticsDialogue class.
+ */
+namespace Qync::Detail::DiagnosticsDialogue {
+    // how often the measurements shown are updated, in milliseconds
+    static constexpr const int RefreshInterval = 1000;
+
+    /**
+     * @brief Format a value from a histogram for display.
+     *
+     * @param value The value.
+     * @param isDuration Whether the value is a duration in microseconds rather
+     * than a size in bytes.
+     *
+     * @return The value with its unit.
+     */
+    static QString formatValue(quint64 value, bool isDuration)
+    {
+        const QLocale locale;
+
+        if(!isDuration) {
+            return formatSize(value);
+        }
+
+        if(1000000 <= value) {
+            return locale.toString(static_cast<double>(value) / 1000000.0, 'f', 2) + " s";
+        }
+
+        if(1000 <= value) {
+            return locale.toString(static_cast<double>(value) / 1000.0, 'f', 2) + " ms";
+        }
+
+        return locale.toString(static_cast<qulonglong>(value)) + QStringLiteral(" \u00b5s");
+    }
+
+    /**
+     * @brief Find out how much memory Qync is using.
+     *
+     * @return The size of the resident set in bytes, or -1 if it is not known
+     * on this platform.
+     */
+    static qint64 residentMemory()
+    {
+#if defined(Q_OS_LINUX)
+        QFile statm(QStringLiteral("/proc/self/statm"));
+
+        if(!statm.open(QIODevice::ReadOnly)) {
+            return -1;
+        }
+
+        bool ok;
+        const auto pages = statm.readLine().split(' ').value(1).toLongLong(&ok);
+        return (ok ? pages * sysconf(_SC_PAGESIZE) : -1);
+#else
+        return -1;
+#endif
+    }
+}  // namespace Qync::Detail::DiagnosticsDialogue
+
+/**
+ * @class DiagnosticsDialogue
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Dialogue showing what the Instrumentation has measured.
+ *
+ * Each counter and histogram is shown as a row, and the rates at which rsync's
+ * output is being read and parsed are worked out from the counters. The
+ * content is updated every second while the dialogue is visible. The
+ * measurements can be reset, and the trace exported to a file that
+ * chrome://tracing or the Perfetto UI can open.
+ *
+ * The memory Qync is using, where the platform says, how much rsync output is
+ * waiting to be read (see ProcessWorker) and how long each phase of startup
+ * took (see Application::startupPhases()) are shown whether or not the
+ * Instrumentation is recording.
+ */
+
+/**
+ * @brief Create a new DiagnosticsDialogue.
+ *
+ * @param parent The owner of the dialogue.
+ */
+DiagnosticsDialogue::DiagnosticsDialogue(QWidget * parent)
+:   QDialog(parent),
+    m_ui(std::make_unique<Ui::DiagnosticsDialogue>()),
+    m_refreshTimer(),
+    m_sinceRefresh(),
+    m_lastLines(0),
+    m_lastBytes(0)
+{
+    m_ui->setupUi(this);
+    m_ui->controls->button(QDialogButtonBox::Save)->setText(tr("Export trace..."));
+
+    m_refreshTimer.setInterval(Detail::DiagnosticsDialogue::RefreshInterval);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &DiagnosticsDialogue::refresh);
+
+    connect(m_ui->controls->button(QDialogButtonBox::Reset), &QPushButton::clicked, this, &DiagnosticsDialogue::reset);
+    connect(m_ui->controls, &QDialogButtonBox::accepted, this, &DiagnosticsDialogue::exportTrace);
+    connect(m_ui->controls, &QDialogButtonBox::rejected, this, &QDialog::close);
+}
+
+/**
+ * @brief Destroy the DiagnosticsDialogue.
+ */
+DiagnosticsDialogue::~DiagnosticsDialogue() = default;
+
+/**
+ * @brief Show the latest measurements.
+ */
+void DiagnosticsDialogue::refresh()
+{
+    using Detail::DiagnosticsDialogue::formatValue;
+    const QLocale locale;
+    const auto lines = Instrumentation::counter(Instrumentation::Counter::LinesParsed);
+    const auto bytes = Instrumentation::counter(Instrumentation::Counter::StdoutBytes);
+    double linesPerSecond = 0.0;
+    double bytesPerSecond = 0.0;
+
+    if(m_sinceRefresh.isValid() && 0 < m_sinceRefresh.elapsed() && lines >= m_lastLines && bytes >= m_lastBytes) {
+        const auto seconds = static_cast<double>(m_sinceRefresh.elapsed()) / 1000.0;
+        linesPerSecond = static_cast<double>(lines - m_lastLines) / seconds;
+        bytesPerSecond = static_cast<double>(bytes - m_lastBytes) / seconds;
+    }
+
+    m_sinceRefresh.start();
+    m_lastLines = lines;
+    m_lastBytes = bytes;
+
+    if(Instrumentation::isEnabled()) {
+        m_ui->status->setText(tr("Parsing %1 lines per second from %2 per second of rsync output. The trace holds %3 events.")
+                              .arg(locale.toString(linesPerSecond, 'f', 0), formatValue(static_cast<quint64>(bytesPerSecond), false), locale.toString(Instrumentation::traceEventCount())));
+    }
+    else {
+        m_ui->status->setText(tr("Nothing is being recorded. Turn on performance diagnostics in the preferences to start recording."));
+    }
+
+    const auto buffered = tr("%1 of rsync output is waiting to be read, and at most %2 has been. rsync has been paused %n time(s) while Qync caught up.", "", static_cast<int>(ProcessWorker::pauseCount()))
+                          .arg(formatValue(static_cast<quint64>(ProcessWorker::bufferedOutput()), false), formatValue(static_cast<quint64>(ProcessWorker::peakBufferedOutput()), false));
+
+    if(const auto resident = Detail::DiagnosticsDialogue::residentMemory(); 0 <= resident) {
+        m_ui->memory->setText(tr("Qync is using %1 of memory. %2").arg(formatValue(static_cast<quint64>(resident), false), buffered));
+    }
+    else {
+        m_ui->memory->setText(buffered);
+    }
+
+    qint64 startupMs = 0;
+    QStringList phases;
+
+    for(const auto & phase : qyncApp->startupPhases()) {
+        startupMs += phase.elapsedMs;
+        phases.push_back(tr("%1: %2 ms").arg(phase.name, locale.toString(phase.elapsedMs)));
+    }
+
+    m_ui->startup->setText(tr("Startup took %1 ms. %2.").arg(locale.toString(startupMs), phases.join(QStringLiteral("; "))));
+
+    auto * tree = m_ui->measurements;
+    int row = 0;
+
+    // reuses the rows from the last refresh so that the selection and scroll position survive
+    const auto rowAt = [tree, &row]() {
+        auto * item = tree->topLevelItem(row);
+
+        if(!item) {
+            item = new QTreeWidgetItem(tree);
+
+            for(int column = 1; column < tree->columnCount(); ++column) {
+                item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+            }
+        }
+
+        ++row;
+        return item;
+    };
+
+    for(int index = 0; index < Instrumentation::CounterCount; ++index) {
+        const auto counter = static_cast<Instrumentation::Counter>(index);
+        auto * item = rowAt();
+        item->setText(0, Instrumentation::name(counter));
+        item->setText(1, locale.toString(static_cast<qulonglong>(Instrumentation::counter(counter))));
+    }
+
+    for(int index = 0; index < Instrumentation::HistogramCount; ++index) {
+        const auto histogram = static_cast<Instrumentation::Histogram>(index);
+        const auto snapshot = Instrumentation::histogram(histogram);
+        const auto isDuration = Instrumentation::isDuration(histogram);
+        auto * item = rowAt();
+        item->setText(0, Instrumentation::name(histogram));
+        item->setText(1, locale.toString(static_cast<qulonglong>(snapshot.count)));
+        item->setText(2, formatValue(static_cast<quint64>(snapshot.mean()), isDuration));
+        item->setText(3, formatValue(snapshot.percentile(0.5), isDuration));
+        item->setText(4, formatValue(snapshot.percentile(0.95), isDuration));
+        item->setText(5, formatValue(snapshot.maximum, isDuration));
+    }
+}
+
+/**
+ * @brief Discard everything that has been measured.
+ */
+void DiagnosticsDialogue::reset()
+{
+    Instrumentation::reset();
+    ProcessWorker::resetPeakBufferedOutput();
+    m_sinceRefresh.invalidate();
+    refresh();
+}
+
+/**
+ * @brief Ask the user for a file and write the trace to it.
+ */
+void DiagnosticsDialogue::exportTrace()
+{
+    const auto fileName = QFileDialog::getSaveFileName(this, tr("Export trace"), {}, tr("Chrome trace files (*.json)"));
+
+    if(fileName.isEmpty()) {
+        return;
+    }
+
+    if(!Instrumentation::exportChromeTrace(fileName)) {
+        QMessageBox::warning(this, tr("%1 Warning").arg(qyncApp->applicationDisplayName()), tr("The trace could not be written to %1.").arg(fileName));
+    }
+}
+
+/**
+ * @brief Start updating the measurements when the dialogue is shown.
+ *
+ * @param event The event.
+ */
+void DiagnosticsDialogue::showEvent(QShowEvent * event)
+{
+    QDialog::showEvent(event);
+    m_sinceRefresh.invalidate();
+    refresh();
+    m_refreshTimer.start();
+}
+
+/**
+ * @brief Stop updating the measurements when the dialogue is hidden.
+ *
+ * @param event The event.
+ */
+void DiagnosticsDialogue::hideEvent(QHideEvent * event)
+{
+    m_refreshTimer.stop();
+    QDialog::hideEvent(event);
+}
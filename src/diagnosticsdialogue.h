@@ -0,0 +1,57 @@
+/**
+ * @file diagnosticsdialogue.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the DiagnosticsDialogue class.
+ */
+
+#ifndef QYNC_DIAGNOSTICSDIALOGUE_H
+#define QYNC_DIAGNOSTICSDIALOGUE_H
+
+#include <memory>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTimer>
+#include <QtWidgets/QDialog>
+
+class QHideEvent;
+class QShowEvent;
+
+namespace Qync {
+
+	namespace Ui {
+		class DiagnosticsDialogue;
+	}
+
+	class DiagnosticsDialogue
+	: public QDialog {
+		Q_OBJECT
+
+	public:
+		explicit DiagnosticsDialogue(QWidget * parent = nullptr);
+		~DiagnosticsDialogue() override;
+
+	public Q_SLOTS:
+		void refresh();
+		void reset();
+		void exportTrace();
+
+	protected:
+		void showEvent(QShowEvent *) override;
+		void hideEvent(QHideEvent *) override;
+
+	private:
+		std::unique_ptr<Ui::DiagnosticsDialogue> m_ui;
+		QTimer m_refreshTimer;
+
+		// for the rates, from the previous refresh
+		QElapsedTimer m_sinceRefresh;
+		quint64 m_lastLines;
+		quint64 m_lastBytes;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_DIAGNOSTICSDIALOGUE_H
@@ -0,0 +1,341 @@
+/**
+ * @file directorylister.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the DirectoryLister class.
+ */
+
+#include "directorylister.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMetaObject>
+#include <QtCore/QStringBuilder>
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::DirectoryLister class.
+ */
+namespace Qync::Detail::DirectoryLister {
+    using RequestId = Qync::DirectoryLister::RequestId;
+
+    // entries are delivered when this many have been read, or when this many ms
+    // have passed since the last delivery, whichever is sooner
+    static constexpr const int BatchSize = 256;
+    static constexpr const qint64 BatchInterval = 50;
+
+    // how many listings are kept, and for how many ms one is used before the
+    // directory is read again
+    static constexpr const std::size_t MaximumCachedListings = 16;
+    static constexpr const qint64 CacheLifetime = 30 * 1000;
+
+    static constexpr const QDir::Filters EntryFilters = QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot;
+
+    struct Listing {
+        QString directory;
+        QStringList entries;
+        QElapsedTimer age;
+    };
+
+    struct State {
+        std::mutex lock;
+        std::condition_variable requested;
+
+        // guarded by lock. the owner is cleared when the lister is destroyed
+        Qync::DirectoryLister * owner = nullptr;
+        bool started = false;
+        bool stopping = false;
+        QString directory;
+        RequestId pending = Qync::DirectoryLister::NoRequest;
+        RequestId lastIssued = Qync::DirectoryLister::NoRequest;
+
+        // the most recently used first
+        std::vector<Listing> cache;
+
+        // the request the caller is waiting for; the thread abandons any other
+        std::atomic<RequestId> current{Qync::DirectoryLister::NoRequest};
+    };
+
+    // deliver entries to the lister on its own thread, if it still exists
+    static void deliver(State & state, RequestId request, QStringList entries, bool finished)
+    {
+        std::lock_guard<std::mutex> lock(state.lock);
+
+        if(!state.owner) {
+            return;
+        }
+
+        // events posted to the lister are discarded if it is destroyed before they are delivered
+        auto * owner = state.owner;
+
+        QMetaObject::invokeMethod(owner, [owner, request, entries = std::move(entries), finished]() {
+            if(!entries.isEmpty()) {
+                Q_EMIT owner->entriesListed(request, entries);
+            }
+
+            if(finished) {
+                Q_EMIT owner->listingFinished(request);
+            }
+        }, Qt::QueuedConnection);
+    }
+
+    static bool isCurrent(const State & state, RequestId request)
+    {
+        return request == state.current.load(std::memory_order_relaxed);
+    }
+
+    // deliver a cached listing in batches, so the receiver never has to take it all at once
+    static void deliverCached(State & state, RequestId request, const QStringList & entries)
+    {
+        if(entries.isEmpty()) {
+            deliver(state, request, {}, true);
+            return;
+        }
+
+        for(int index = 0; index < entries.size() && isCurrent(state, request); index += BatchSize) {
+            deliver(state, request, entries.mid(index, BatchSize), entries.size() <= index + BatchSize);
+        }
+    }
+
+    // the listing thread
+    static void run(std::shared_ptr<State> state)
+    {
+        while(true) {
+            QString directory;
+            RequestId request;
+            QStringList cached;
+            bool isCached = false;
+
+            {
+                std::unique_lock<std::mutex> lock(state->lock);
+
+                state->requested.wait(lock, [&state]() {
+                    return state->stopping || Qync::DirectoryLister::NoRequest != state->pending;
+                });
+
+                if(state->stopping) {
+                    break;
+                }
+
+                directory = std::exchange(state->directory, {});
+                request = std::exchange(state->pending, Qync::DirectoryLister::NoRequest);
+
+                const auto listing = std::find_if(state->cache.begin(), state->cache.end(), [&directory](const Listing & cachedListing) {
+                    return cachedListing.directory == directory;
+                });
+
+                if(state->cache.end() != listing) {
+                    if(listing->age.hasExpired(CacheLifetime)) {
+                        state->cache.erase(listing);
+                    }
+                    else {
+                        cached = listing->entries;
+                        isCached = true;
+                        std::rotate(state->cache.begin(), listing, listing + 1);
+                    }
+                }
+            }
+
+            if(isCached) {
+                deliverCached(*state, request, cached);
+                continue;
+            }
+
+            QStringList entries;
+            QStringList batch;
+            QElapsedTimer sinceDelivery;
+            sinceDelivery.start();
+            QDirIterator it(directory, EntryFilters);
+            bool abandoned = false;
+
+            while(it.hasNext()) {
+                if(!isCurrent(*state, request)) {
+                    abandoned = true;
+                    break;
+                }
+
+                it.next();
+
+                // directories get a trailing '/', so completing one carries on into it
+                if(it.fileInfo().isDir()) {
+                    batch.push_back(it.fileName() % QLatin1Char('/'));
+                }
+                else {
+                    batch.push_back(it.fileName());
+                }
+
+                if(BatchSize <= batch.size() || sinceDelivery.hasExpired(BatchInterval)) {
+                    entries.append(batch);
+                    deliver(*state, request, std::exchange(batch, {}), false);
+                    sinceDelivery.restart();
+                }
+            }
+
+            // a partial listing is no use to anyone later
+            if(abandoned) {
+                continue;
+            }
+
+            entries.append(batch);
+            deliver(*state, request, std::move(batch), true);
+
+            std::lock_guard<std::mutex> lock(state->lock);
+
+            state->cache.erase(std::remove_if(state->cache.begin(), state->cache.end(), [&directory](const Listing & cachedListing) {
+                return cachedListing.directory == directory;
+            }), state->cache.end());
+
+            Listing listing{std::move(directory), std::move(entries), {}};
+            listing.age.start();
+            state->cache.insert(state->cache.begin(), std::move(listing));
+
+            if(MaximumCachedListings < state->cache.size()) {
+                state->cache.pop_back();
+            }
+        }
+    }
+}  // namespace Qync::Detail::DirectoryLister
+
+/**
+ * @class DirectoryLister
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Lists local directories on a background thread.
+ *
+ * Reading a directory can take seconds on a slow network mount or when it has
+ * hundreds of thousands of entries, so the lister reads them on its own thread
+ * and delivers the names as they are read, in batches, with the
+ * entriesListed() signal. listingFinished() follows the last batch. Both are
+ * emitted on the lister's thread. Directory names have a trailing '/'.
+ *
+ * Only the most recent request is served: calling list() again, or cancel(),
+ * abandons the listing in progress, and any batches from an earlier request
+ * that are still to be delivered carry that request's Id, so they can be told
+ * apart. Abandoning takes effect between entries, so a directory that the
+ * file system is slow to read still holds up the next request until the
+ * current read returns, but it never holds up the caller.
+ *
+ * The most recently used complete listings are cached for a short time, and
+ * requests for them are served from the cache without reading the directory
+ * again. The listing thread is started with the first request. It is not
+ * joined when the lister is destroyed, since it could be waiting on an
+ * unresponsive mount; it finishes by itself once its current read returns,
+ * and the lister's signals are never emitted after it has gone.
+ */
+
+/**
+ * @brief Create a new lister.
+ *
+ * @param parent The parent object.
+ */
+DirectoryLister::DirectoryLister(QObject * parent)
+:   QObject(parent),
+    m_state(std::make_shared<Detail::DirectoryLister::State>())
+{
+    m_state->owner = this;
+}
+
+/**
+ * @brief Destroy the lister.
+ *
+ * Any listing in progress is abandoned. This does not wait for the listing
+ * thread to stop.
+ */
+DirectoryLister::~DirectoryLister()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_state->lock);
+        m_state->owner = nullptr;
+        m_state->stopping = true;
+        m_state->current = NoRequest;
+    }
+
+    m_state->requested.notify_one();
+}
+
+/**
+ * @brief List a directory.
+ *
+ * @param directory The path of the directory.
+ *
+ * Any request still in progress is abandoned.
+ *
+ * @return The Id of the request, which the signals for its entries carry.
+ */
+DirectoryLister::RequestId DirectoryLister::list(const QString & directory)
+{
+    RequestId request;
+
+    {
+        std::lock_guard<std::mutex> lock(m_state->lock);
+
+        if(!m_state->started) {
+            std::thread(&Detail::DirectoryLister::run, m_state).detach();
+            m_state->started = true;
+        }
+
+        request = ++m_state->lastIssued;
+        m_state->directory = directory;
+        m_state->pending = request;
+        m_state->current = request;
+    }
+
+    m_state->requested.notify_one();
+    return request;
+}
+
+/**
+ * @brief Abandon the request in progress, if any.
+ *
+ * Batches from it that are still to be delivered are delivered anyway.
+ */
+void DirectoryLister::cancel()
+{
+    std::lock_guard<std::mutex> lock(m_state->lock);
+    m_state->pending = NoRequest;
+    m_state->current = NoRequest;
+}
+
+/**
+ * @brief Fetch the request being served.
+ *
+ * @return The Id of the latest request, or NoRequest if it has been cancelled.
+ * Its entries may all have been delivered already.
+ */
+DirectoryLister::RequestId DirectoryLister::currentRequest() const
+{
+    return m_state->current.load(std::memory_order_relaxed);
+}
+
+/**
+ * @fn DirectoryLister::entriesListed(RequestId, const QStringList &)
+ * @brief Emitted with the next batch of entries in a directory.
+ *
+ * @param request The Id of the request the entries are for.
+ * @param entries The names of the entries, in no particular order.
+ */
+
+/**
+ * @fn DirectoryLister::listingFinished(RequestId)
+ * @brief Emitted when all the entries in a directory have been delivered.
+ *
+ * @param request The Id of the request.
+ *
+ * It is not emitted for requests that are abandoned. A directory that can't
+ * be read finishes with no entries.
+ */
@@ -0,0 +1,56 @@
+/**
+ * @file directorylister.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the DirectoryLister class.
+ */
+
+#ifndef QYNC_DIRECTORYLISTER_H
+#define QYNC_DIRECTORYLISTER_H
+
+#include <memory>
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+namespace Qync {
+
+	namespace Detail::DirectoryLister {
+		struct State;
+	}
+
+	class DirectoryLister
+	: public QObject {
+		Q_OBJECT
+
+	public:
+		using RequestId = quint64;
+		static constexpr const RequestId NoRequest = 0;
+
+		explicit DirectoryLister(QObject * parent = nullptr);
+		DirectoryLister(const DirectoryLister &) = delete;
+		DirectoryLister(DirectoryLister &&) = delete;
+		void operator=(const DirectoryLister &) = delete;
+		void operator=(DirectoryLister &&) = delete;
+		~DirectoryLister() override;
+
+		RequestId list(const QString & directory);
+		void cancel();
+
+		[[nodiscard]] RequestId currentRequest() const;
+
+	Q_SIGNALS:
+		void entriesListed(Qync::DirectoryLister::RequestId request, const QStringList & entries);
+		void listingFinished(Qync::DirectoryLister::RequestId request);
+
+	private:
+		// shared with the listing thread, which can outlive the lister
+		std::shared_ptr<Detail::DirectoryLister::State> m_state;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_DIRECTORYLISTER_H
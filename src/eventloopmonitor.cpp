@@ -0,0 +1,98 @@
+/**
+ * @file eventloopmonitor.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the EventLoopMonitor class.
+ */
+
+#include "eventloopmonitor.h"
+
+#include <algorithm>
+
+#include "instrumentation.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::EventLoopMonitor class.
+ */
+namespace Qync::Detail::EventLoopMonitor {
+    // how often the event loop is checked, in milliseconds
+    static constexpr const int Interval = 50;
+}  // namespace Qync::Detail::EventLoopMonitor
+
+/**
+ * @class EventLoopMonitor
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Measures how late the event loop of its thread is in getting round to
+ * things.
+ *
+ * While it is active, a precise timer fires every few milliseconds. Any time
+ * beyond the interval between one timeout and the next is time the event loop
+ * spent busy with something else, and is recorded in the
+ * Instrumentation::Histogram::EventLoopLag histogram and as a trace counter.
+ * A lag that keeps growing while rsync is producing lots of output means the
+ * thread can't keep up with it.
+ */
+
+/**
+ * @brief Create an inactive monitor.
+ *
+ * @param parent The owner of the monitor. The monitor measures the event loop
+ * of the thread it lives in.
+ */
+EventLoopMonitor::EventLoopMonitor(QObject * parent)
+:   QObject(parent),
+    m_timer(),
+    m_sinceLastTimeout()
+{
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setInterval(Detail::EventLoopMonitor::Interval);
+    connect(&m_timer, &QTimer::timeout, this, &EventLoopMonitor::onTimeout);
+}
+
+/**
+ * @brief Start or stop measuring.
+ *
+ * @param active Whether to measure.
+ *
+ * The lag is only recorded while the Instrumentation is enabled as well.
+ */
+void EventLoopMonitor::setActive(bool active)
+{
+    if(active == isActive()) {
+        return;
+    }
+
+    if(active) {
+        m_sinceLastTimeout.start();
+        m_timer.start();
+    }
+    else {
+        m_timer.stop();
+    }
+}
+
+/**
+ * @brief Record how late the timer was.
+ */
+void EventLoopMonitor::onTimeout()
+{
+    const auto elapsed = m_sinceLastTimeout.nsecsElapsed() / 1000;
+    m_sinceLastTimeout.start();
+    const auto lag = static_cast<quint64>(std::max<qint64>(0, elapsed - Detail::EventLoopMonitor::Interval * 1000));
+    Instrumentation::record(Instrumentation::Histogram::EventLoopLag, lag);
+    Instrumentation::traceCounter("Event loop lag (us)", lag);
+}
+
+/**
+ * @fn EventLoopMonitor::isActive()
+ * @brief Check whether the monitor is measuring.
+ *
+ * @return @b true if it is, @b false if not.
+ */
@@ -0,0 +1,41 @@
+/**
+ * @file eventloopmonitor.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the EventLoopMonitor class.
+ */
+
+#ifndef QYNC_EVENTLOOPMONITOR_H
+#define QYNC_EVENTLOOPMONITOR_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+namespace Qync {
+
+	class EventLoopMonitor
+	: public QObject {
+		Q_OBJECT
+
+	public:
+		explicit EventLoopMonitor(QObject * parent = nullptr);
+
+		[[nodiscard]] inline bool isActive() const {
+			return m_timer.isActive();
+		}
+
+		void setActive(bool active);
+
+	private:
+		void onTimeout();
+
+		QTimer m_timer;
+		QElapsedTimer m_sinceLastTimeout;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_EVENTLOOPMONITOR_H
@@ -10,9 +10,14 @@
 #include "functions.h"
 
 #include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QLocale>
 #include <QtCore/QString>
 #include <QtCore/QXmlStreamReader>
 
+#include "units.h"
+
 /**
  * @namespace Qync
  *
@@ -88,3 +93,102 @@ std::optional<bool> Qync::parseBooleanText(const QString &boolString) {
 
 	return {};
 }
+
+/**
+ * @brief Work out how to give rsync the entries of a local source with
+ * --files-from.
+ *
+ * @param source is the rsync source, a local directory.
+ * @param prefix receives the prefix for the paths of the source's entries.
+ *
+ * If the source path ends with a separator (i.e. rsync is to copy the
+ * directory's content), the base directory is the source itself and the prefix
+ * is empty. Otherwise the base directory is the source's parent and the prefix
+ * is the source's name followed by a separator, so that with --relative rsync
+ * recreates the same layout under the destination.
+ *
+ * @return The base directory, with a trailing separator. It replaces the source
+ * in rsync's arguments, and the entries listed in the --files-from file are the
+ * paths relative to the source with the prefix prepended.
+ */
+QString Qync::filesFromBaseDirectory(const QString &source, QString &prefix) {
+	if (source.endsWith('/') || source.endsWith(QDir::separator())) {
+		prefix.clear();
+		return QDir(source).absolutePath() + '/';
+	}
+
+	QFileInfo info(source);
+	prefix = info.fileName() + '/';
+	return info.absolutePath() + '/';
+}
+
+/**
+ * @brief Check whether an rsync source or destination is on this computer.
+ *
+ * @param path is the source or destination.
+ *
+ * rsync takes a path with a colon before its first separator to name a remote
+ * host (or, with a double colon or an rsync:// URL, an rsync daemon). On
+ * Windows a drive letter is not a host name.
+ *
+ * @return @b true if the path is local, @b false if it is empty or remote.
+ */
+bool Qync::isLocalPath(const QString &path) {
+	if (path.isEmpty() || path.startsWith(QStringLiteral("rsync://"))) {
+		return false;
+	}
+
+	const auto colon = path.indexOf(':');
+
+	if (-1 == colon) {
+		return true;
+	}
+
+#if defined(Q_OS_WIN)
+	if (1 == colon && path.at(0).isLetter()) {
+		return true;
+	}
+#endif
+
+	const auto slash = path.indexOf('/');
+	return -1 != slash && slash < colon;
+}
+
+/**
+ * @brief Format a size for display.
+ *
+ * @param bytes is the size, in bytes.
+ *
+ * The size is given in the largest IEC unit of which there are at least two,
+ * to two decimal places, in the user's locale.
+ *
+ * @return The size with its unit.
+ */
+QString Qync::formatSize(long double bytes) {
+	if (bytes > 2.0_gib) {
+		return QLocale().toString(static_cast<double>(bytes / 1.0_gib), 'f', 2) + " GiB";
+	}
+
+	if (bytes > 2.0_mib) {
+		return QLocale().toString(static_cast<double>(bytes / 1.0_mib), 'f', 2) + " MiB";
+	}
+
+	if (bytes > 2.0_kib) {
+		return QLocale().toString(static_cast<double>(bytes / 1.0_kib), 'f', 2) + " KiB";
+	}
+
+	return QLocale().toString(static_cast<qulonglong>(bytes)) + " B";
+}
+
+/**
+ * @brief Format a transfer speed for display.
+ *
+ * @param bytesPerSecond is the speed.
+ *
+ * The speed is given in the same units as formatSize().
+ *
+ * @return The speed with its unit.
+ */
+QString Qync::formatSpeed(long double bytesPerSecond) {
+	return formatSize(bytesPerSecond) + "/s";
+}
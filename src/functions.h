@@ -21,6 +21,10 @@ class QString;
 namespace Qync {
 	void parseUnknownElementXml(QXmlStreamReader &);
     std::optional<bool> parseBooleanText(const QString &);
+	QString filesFromBaseDirectory(const QString &, QString &);
+	bool isLocalPath(const QString &);
+	QString formatSize(long double);
+	QString formatSpeed(long double);
 };
 
 #endif  // QYNC_FUNCTIONS_H
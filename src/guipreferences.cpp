@@ -35,6 +35,8 @@ using namespace Qync;
  *   - Icons with text below
  *   - Icons with text beside
  *   - Whatever style the current visual theme suggests
+ * - how many times per second the progress of a running process is shown
+ * - how many processed items the process dialogue keeps in its list
  */
 
 /**
@@ -53,7 +55,9 @@ GuiPreferences::GuiPreferences(const QString & fileName)
     m_simpleUi(true),   
     m_presetsToolbar(true),
     m_syncToolbar(true),
-    m_toolButtonStyle(Qt::ToolButtonFollowStyle)
+    m_toolButtonStyle(Qt::ToolButtonFollowStyle),
+    m_progressUpdateRate(DefaultProgressUpdateRate),
+    m_transferLogCapacity(DefaultTransferLogCapacity)
 {
     loadFrom(fileName);
 }
@@ -66,8 +70,10 @@ GuiPreferences::~GuiPreferences() = default;
 /**
  * @brief Set the default values for all settings.
  *
- * By default, both toolbars are shown and the toolbar button style is
- * set to the default for the current Qt theme. See the documentation
+ * By default, both toolbars are shown, the toolbar button style is
+ * set to the default for the current Qt theme, progress is updated
+ * 20 times per second and the process dialogue lists the most recent
+ * 100,000 items. See the documentation
  * for @ref GuiPreferences::setDefaults() for the defaults for
  * settings governed by that class.
  */
@@ -77,6 +83,48 @@ void GuiPreferences::setDefaults()
     setShowPresetsToolBar(true);
     setShowSynchroniseToolBar(true);
     setToolBarButtonStyle(Qt::ToolButtonFollowStyle);
+    setProgressUpdateRate(DefaultProgressUpdateRate);
+    setTransferLogCapacity(DefaultTransferLogCapacity);
+}
+
+/**
+ * @brief Set how many times per second the progress of a process is shown.
+ *
+ * @param rate The number of updates per second. It must be between
+ * MinimumProgressUpdateRate and MaximumProgressUpdateRate.
+ *
+ * @return @b true if the rate was set, @b false if it is out of range.
+ */
+bool GuiPreferences::setProgressUpdateRate(int rate)
+{
+    if(MinimumProgressUpdateRate > rate || MaximumProgressUpdateRate < rate) {
+        qWarning() << __PRETTY_FUNCTION__ << "progress update rate" << rate << "is out of range";
+        return false;
+    }
+
+    m_progressUpdateRate = rate;
+    return true;
+}
+
+/**
+ * @brief Set how many processed items the process dialogue keeps in its list.
+ *
+ * @param capacity The number of items. It must be between
+ * MinimumTransferLogCapacity and MaximumTransferLogCapacity.
+ *
+ * Older items are not shown, but are still included when the output is saved.
+ *
+ * @return @b true if the capacity was set, @b false if it is out of range.
+ */
+bool GuiPreferences::setTransferLogCapacity(int capacity)
+{
+    if(MinimumTransferLogCapacity > capacity || MaximumTransferLogCapacity < capacity) {
+        qWarning() << __PRETTY_FUNCTION__ << "transfer log capacity" << capacity << "is out of range";
+        return false;
+    }
+
+    m_transferLogCapacity = capacity;
+    return true;
 }
 
 /**
@@ -136,6 +184,8 @@ bool GuiPreferences::emitXmlElements(QXmlStreamWriter & xml) const
     emitPresetsToolbarXml(xml);
     emitSynchroniseToolbarXml(xml);
     emitToolBarButtonStyleXml(xml);
+    emitProgressUpdateRateXml(xml);
+    emitTransferLogCapacityXml(xml);
     xml.writeEndElement(); /* guipreferences */
     return true;
 }
@@ -223,6 +273,36 @@ bool GuiPreferences::emitToolBarButtonStyleXml(QXmlStreamWriter & xml) const
     return true;
 }
 
+/**
+ * @brief Write the progress update rate setting to an XML stream.
+ *
+ * @param xml is the stream to which to write.
+ *
+ * @return @b true if the setting was written, @b false otherwise.
+ */
+bool GuiPreferences::emitProgressUpdateRateXml(QXmlStreamWriter & xml) const
+{
+    xml.writeStartElement("progressupdaterate");
+    xml.writeCharacters(QString::number(progressUpdateRate()));
+    xml.writeEndElement();
+    return true;
+}
+
+/**
+ * @brief Write the transfer log capacity setting to an XML stream.
+ *
+ * @param xml is the stream to which to write.
+ *
+ * @return @b true if the setting was written, @b false otherwise.
+ */
+bool GuiPreferences::emitTransferLogCapacityXml(QXmlStreamWriter & xml) const
+{
+    xml.writeStartElement("transferlogcapacity");
+    xml.writeCharacters(QString::number(transferLogCapacity()));
+    xml.writeEndElement();
+    return true;
+}
+
 /**
  * @brief Read an element from an XML stream.
  *
@@ -301,6 +381,22 @@ bool GuiPreferences::parseGuiPreferencesXml(QXmlStreamReader & xml)
                 this->setToolBarButtonStyle(*value);
             }
         }
+        else if("progressupdaterate" == xml.name()) {
+            bool ok;
+            int rate = xml.readElementText().trimmed().toInt(&ok);
+
+            if(ok) {
+                setProgressUpdateRate(rate);
+            }
+        }
+        else if("transferlogcapacity" == xml.name()) {
+            bool ok;
+            int capacity = xml.readElementText().trimmed().toInt(&ok);
+
+            if(ok) {
+                setTransferLogCapacity(capacity);
+            }
+        }
         else {
             qWarning() << __PRETTY_FUNCTION__ << "found unexpected XML element" << xml.name() << "at line" << xml.lineNumber();
             Qync::parseUnknownElementXml(xml);
@@ -383,3 +479,17 @@ bool GuiPreferences::parseGuiPreferencesXml(QXmlStreamReader & xml)
  *
  * @return @b true if the style was set, @b false otherwise.
  */
+
+/**
+ * @fn GuiPreferences::progressUpdateRate()
+ * @brief Get how many times per second the progress of a process is shown.
+ *
+ * @return The number of updates per second.
+ */
+
+/**
+ * @fn GuiPreferences::transferLogCapacity()
+ * @brief Get how many processed items the process dialogue keeps in its list.
+ *
+ * @return The number of items.
+ */
@@ -64,6 +64,28 @@ namespace Qync {
 			return true;
 		}
 
+		[[nodiscard]] inline int progressUpdateRate() const
+		{
+			return m_progressUpdateRate;
+		}
+
+		bool setProgressUpdateRate(int rate);
+
+		static constexpr const int MinimumProgressUpdateRate = 1;
+		static constexpr const int MaximumProgressUpdateRate = 60;
+		static constexpr const int DefaultProgressUpdateRate = 20;
+
+		[[nodiscard]] inline int transferLogCapacity() const
+		{
+			return m_transferLogCapacity;
+		}
+
+		bool setTransferLogCapacity(int capacity);
+
+		static constexpr const int MinimumTransferLogCapacity = 1000;
+		static constexpr const int MaximumTransferLogCapacity = 10000000;
+		static constexpr const int DefaultTransferLogCapacity = 100000;
+
 	protected:
 		static std::optional<Qt::ToolButtonStyle> parseToolButtonStyleText(const QString &);
 
@@ -76,12 +98,16 @@ namespace Qync {
 		bool emitPresetsToolbarXml(QXmlStreamWriter &) const;
 		bool emitSynchroniseToolbarXml(QXmlStreamWriter &) const;
 		bool emitToolBarButtonStyleXml(QXmlStreamWriter &) const;
+		bool emitProgressUpdateRateXml(QXmlStreamWriter &) const;
+		bool emitTransferLogCapacityXml(QXmlStreamWriter &) const;
 
 	private:
 		bool m_simpleUi;
 		bool m_presetsToolbar;
 		bool m_syncToolbar;
 		Qt::ToolButtonStyle m_toolButtonStyle;
+		int m_progressUpdateRate;
+		int m_transferLogCapacity;
 	};
 
 }  // namespace Qync
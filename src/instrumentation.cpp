@@ -0,0 +1,540 @@
+/**
+ * @file instrumentation.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the Instrumentation class.
+ */
+
+#include "instrumentation.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSaveFile>
+#include <QtCore/QtAlgorithms>
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::Instrumentation class.
+ */
+namespace Qync::Detail::Instrumentation {
+    // the most trace events kept; once it's full the oldest are overwritten
+    static constexpr const std::size_t TraceCapacity = 1 << 16;
+
+    struct Histogram {
+        std::atomic<quint64> count{0};
+        std::atomic<quint64> sum{0};
+        std::atomic<quint64> minimum{~quint64(0)};
+        std::atomic<quint64> maximum{0};
+        std::array<std::atomic<quint64>, Qync::Instrumentation::BucketCount> buckets = {};
+    };
+
+    struct TraceEvent {
+        const char * name = nullptr;
+        char phase = 'X';
+        quint32 thread = 0;
+        quint64 timestamp = 0;
+        quint64 value = 0;
+    };
+
+    struct Trace {
+        QMutex lock;
+        std::vector<TraceEvent> events;
+        std::size_t next = 0;
+    };
+
+    static std::array<std::atomic<quint64>, Qync::Instrumentation::CounterCount> s_counters = {};
+    static std::array<Histogram, Qync::Instrumentation::HistogramCount> s_histograms;
+    static std::atomic<quint32> s_nextThread{1};
+
+    static Trace & trace()
+    {
+        static Trace s_trace;
+        return s_trace;
+    }
+
+    static const QElapsedTimer & clock()
+    {
+        static const QElapsedTimer s_clock = []() {
+            QElapsedTimer timer;
+            timer.start();
+            return timer;
+        }();
+
+        return s_clock;
+    }
+
+    /**
+     * @brief Fetch a small number that identifies the calling thread in the trace.
+     */
+    static quint32 threadNumber()
+    {
+        thread_local const quint32 s_thread = s_nextThread.fetch_add(1, std::memory_order_relaxed);
+        return s_thread;
+    }
+
+    /**
+     * @brief Work out which bucket of a histogram a value goes in.
+     *
+     * Bucket 0 holds 0 and bucket @b n holds the values from 2^(n - 1) to
+     * 2^n - 1. The last bucket holds everything bigger.
+     */
+    static int bucketFor(quint64 value)
+    {
+        if(0 == value) {
+            return 0;
+        }
+
+        return std::min(Qync::Instrumentation::BucketCount - 1, 64 - static_cast<int>(qCountLeadingZeroBits(value)));
+    }
+
+    static void addEvent(const TraceEvent & event)
+    {
+        auto & trace = Detail::Instrumentation::trace();
+        QMutexLocker locker(&trace.lock);
+
+        if(trace.events.size() < TraceCapacity) {
+            trace.events.push_back(event);
+        }
+        else {
+            trace.events[trace.next] = event;
+        }
+
+        trace.next = (trace.next + 1) % TraceCapacity;
+    }
+}  // namespace Qync::Detail::Instrumentation
+
+/**
+ * @class Instrumentation
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Counters, latency histograms and a trace of Qync's own hot paths.
+ *
+ * When a synchronisation is slow it isn't obvious whether the time is going in
+ * rsync, in the pipe, in parsing rsync's output, in delivering Process's
+ * signals or in updating the user interface. The places where the time might
+ * go measure themselves using this class: counters count things (reads from
+ * rsync, bytes, lines, events), histograms record a distribution of sizes or
+ * durations, and a Scope times a block of code, recording its duration in a
+ * histogram and as a trace event.
+ *
+ * Everything is off unless setEnabled() is called, and while it is off each
+ * measurement costs a relaxed load of an atomic flag, so the measurements can
+ * stay in the code permanently. While it is on, counters and histograms are
+ * updated with relaxed atomics and can be used from any thread. Trace events
+ * are kept in a bounded buffer that holds the most recent TraceCapacity events
+ * and can be written by exportChromeTrace() in the Chrome trace event format,
+ * which both chrome://tracing and the Perfetto UI open.
+ *
+ * Durations are in microseconds, from a monotonic clock that starts the first
+ * time anything is measured. Trace event names must be string literals (or
+ * otherwise outlive the trace), since only the pointer is kept.
+ */
+
+/**
+ * @brief Turn the instrumentation on or off.
+ *
+ * @param enabled Whether measurements are recorded.
+ *
+ * Turning it off keeps what has been recorded so far.
+ */
+void Instrumentation::setEnabled(bool enabled)
+{
+    if(enabled) {
+        // start the clock before anything is timed with it
+        static_cast<void>(Detail::Instrumentation::clock());
+    }
+
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Discard everything that has been recorded.
+ *
+ * Measurements being recorded at the same time in other threads may survive.
+ */
+void Instrumentation::reset()
+{
+    for(auto & counter : Detail::Instrumentation::s_counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+
+    for(auto & histogram : Detail::Instrumentation::s_histograms) {
+        histogram.count.store(0, std::memory_order_relaxed);
+        histogram.sum.store(0, std::memory_order_relaxed);
+        histogram.minimum.store(~quint64(0), std::memory_order_relaxed);
+        histogram.maximum.store(0, std::memory_order_relaxed);
+
+        for(auto & bucket : histogram.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    auto & trace = Detail::Instrumentation::trace();
+    QMutexLocker locker(&trace.lock);
+    trace.events.clear();
+    trace.next = 0;
+}
+
+/**
+ * @brief Fetch the time on the instrumentation's clock.
+ *
+ * @return The time in microseconds.
+ */
+quint64 Instrumentation::now()
+{
+    return static_cast<quint64>(Detail::Instrumentation::clock().nsecsElapsed() / 1000);
+}
+
+/**
+ * @brief Add to a counter.
+ *
+ * @param counter The counter.
+ * @param amount How much to add.
+ */
+void Instrumentation::addEnabled(Counter counter, quint64 amount)
+{
+    Detail::Instrumentation::s_counters[static_cast<std::size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Record a value in a histogram.
+ *
+ * @param histogram The histogram.
+ * @param value The value.
+ */
+void Instrumentation::recordEnabled(Histogram histogram, quint64 value)
+{
+    auto & data = Detail::Instrumentation::s_histograms[static_cast<std::size_t>(histogram)];
+    data.count.fetch_add(1, std::memory_order_relaxed);
+    data.sum.fetch_add(value, std::memory_order_relaxed);
+    data.buckets[static_cast<std::size_t>(Detail::Instrumentation::bucketFor(value))].fetch_add(1, std::memory_order_relaxed);
+    auto minimum = data.minimum.load(std::memory_order_relaxed);
+
+    while(value < minimum && !data.minimum.compare_exchange_weak(minimum, value, std::memory_order_relaxed)) {
+    }
+
+    auto maximum = data.maximum.load(std::memory_order_relaxed);
+
+    while(value > maximum && !data.maximum.compare_exchange_weak(maximum, value, std::memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Fetch the value of a counter.
+ *
+ * @param counter The counter.
+ *
+ * @return The value.
+ */
+quint64 Instrumentation::counter(Counter counter)
+{
+    return Detail::Instrumentation::s_counters[static_cast<std::size_t>(counter)].load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Fetch a copy of a histogram.
+ *
+ * @param histogram The histogram.
+ *
+ * The copy is not taken atomically, so if values are being recorded at the
+ * same time its totals may not quite agree with its buckets.
+ *
+ * @return The copy.
+ */
+Instrumentation::HistogramSnapshot Instrumentation::histogram(Histogram histogram)
+{
+    const auto & data = Detail::Instrumentation::s_histograms[static_cast<std::size_t>(histogram)];
+    HistogramSnapshot snapshot;
+    snapshot.count = data.count.load(std::memory_order_relaxed);
+    snapshot.sum = data.sum.load(std::memory_order_relaxed);
+    snapshot.minimum = (0 == snapshot.count ? 0 : data.minimum.load(std::memory_order_relaxed));
+    snapshot.maximum = data.maximum.load(std::memory_order_relaxed);
+
+    for(std::size_t index = 0; index < snapshot.buckets.size(); ++index) {
+        snapshot.buckets[index] = data.buckets[index].load(std::memory_order_relaxed);
+    }
+
+    return snapshot;
+}
+
+/**
+ * @brief Fetch the name of a counter for display.
+ *
+ * @param counter The counter.
+ *
+ * @return The name.
+ */
+QString Instrumentation::name(Counter counter)
+{
+    switch(counter) {
+        case Counter::StdoutReads:
+            return QCoreApplication::translate("Qync::Instrumentation", "Reads from rsync");
+
+        case Counter::StdoutBytes:
+            return QCoreApplication::translate("Qync::Instrumentation", "Bytes read from rsync");
+
+        case Counter::LinesParsed:
+            return QCoreApplication::translate("Qync::Instrumentation", "Lines parsed");
+
+        case Counter::EventsDispatched:
+            return QCoreApplication::translate("Qync::Instrumentation", "Events dispatched");
+
+        case Counter::ProgressUpdates:
+            return QCoreApplication::translate("Qync::Instrumentation", "Progress updates received");
+
+        case Counter::ProgressUpdatesDropped:
+            return QCoreApplication::translate("Qync::Instrumentation", "Progress updates dropped");
+    }
+
+    return {};
+}
+
+/**
+ * @brief Fetch the name of a histogram for display.
+ *
+ * @param histogram The histogram.
+ *
+ * @return The name.
+ */
+QString Instrumentation::name(Histogram histogram)
+{
+    switch(histogram) {
+        case Histogram::StdoutReadSize:
+            return QCoreApplication::translate("Qync::Instrumentation", "Bytes per read from rsync");
+
+        case Histogram::ParseBatchTime:
+            return QCoreApplication::translate("Qync::Instrumentation", "Read and parse time per batch");
+
+        case Histogram::DispatchTime:
+            return QCoreApplication::translate("Qync::Instrumentation", "Signal delivery time per batch");
+
+        case Histogram::UiUpdateTime:
+            return QCoreApplication::translate("Qync::Instrumentation", "Progress widget update time");
+
+        case Histogram::RepaintTime:
+            return QCoreApplication::translate("Qync::Instrumentation", "Progress window repaint time");
+
+        case Histogram::EventLoopLag:
+            return QCoreApplication::translate("Qync::Instrumentation", "Event loop lag");
+    }
+
+    return {};
+}
+
+/**
+ * @brief Check whether a histogram records durations.
+ *
+ * @param histogram The histogram.
+ *
+ * @return @b true if its values are microseconds, @b false if they are sizes
+ * in bytes.
+ */
+bool Instrumentation::isDuration(Histogram histogram)
+{
+    return Histogram::StdoutReadSize != histogram;
+}
+
+/**
+ * @brief Add an event with a duration to the trace.
+ *
+ * @param name The name of the event. It must outlive the trace.
+ * @param start When the event started, from now().
+ * @param duration How long the event took, in microseconds.
+ */
+void Instrumentation::traceComplete(const char * name, quint64 start, quint64 duration)
+{
+    Detail::Instrumentation::addEvent({name, 'X', Detail::Instrumentation::threadNumber(), start, duration});
+}
+
+/**
+ * @brief Add the value of a counter at the current time to the trace.
+ *
+ * @param name The name of the counter. It must outlive the trace.
+ * @param value The value.
+ */
+void Instrumentation::traceCounter(const char * name, quint64 value)
+{
+    if(isEnabled()) {
+        Detail::Instrumentation::addEvent({name, 'C', Detail::Instrumentation::threadNumber(), now(), value});
+    }
+}
+
+/**
+ * @brief Fetch the number of events in the trace.
+ *
+ * @return The number of events.
+ */
+int Instrumentation::traceEventCount()
+{
+    auto & trace = Detail::Instrumentation::trace();
+    QMutexLocker locker(&trace.lock);
+    return static_cast<int>(trace.events.size());
+}
+
+/**
+ * @brief Write the trace to a file.
+ *
+ * @param fileName The file. Its directory is created if necessary.
+ *
+ * The file is JSON in the Chrome trace event format, with the events in the
+ * order they were recorded.
+ *
+ * @return @b true if the file was written, @b false if not.
+ */
+bool Instrumentation::exportChromeTrace(const QString & fileName)
+{
+    QJsonArray events;
+
+    {
+        auto & trace = Detail::Instrumentation::trace();
+        QMutexLocker locker(&trace.lock);
+        // once the buffer is full, the oldest event is the next one to be overwritten
+        const auto first = (trace.events.size() < Detail::Instrumentation::TraceCapacity ? 0 : trace.next);
+
+        for(std::size_t index = 0; index < trace.events.size(); ++index) {
+            const auto & event = trace.events[(first + index) % trace.events.size()];
+            QJsonObject json{
+              {QStringLiteral("name"), QString::fromLatin1(event.name)},
+              {QStringLiteral("ph"), QString(QChar::fromLatin1(event.phase))},
+              {QStringLiteral("ts"), static_cast<double>(event.timestamp)},
+              {QStringLiteral("pid"), 1},
+              {QStringLiteral("tid"), static_cast<int>(event.thread)},
+            };
+
+            if('C' == event.phase) {
+                json.insert(QStringLiteral("args"), QJsonObject{{QStringLiteral("value"), static_cast<double>(event.value)}});
+            }
+            else {
+                json.insert(QStringLiteral("cat"), QStringLiteral("qync"));
+                json.insert(QStringLiteral("dur"), static_cast<double>(event.value));
+            }
+
+            events.append(json);
+        }
+    }
+
+    events.append(QJsonObject{
+      {QStringLiteral("name"), QStringLiteral("process_name")},
+      {QStringLiteral("ph"), QStringLiteral("M")},
+      {QStringLiteral("pid"), 1},
+      {QStringLiteral("args"), QJsonObject{{QStringLiteral("name"), QCoreApplication::applicationName()}}},
+    });
+
+    if(!QDir().mkpath(QFileInfo(fileName).absolutePath())) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to create directory for" << fileName;
+        return false;
+    }
+
+    QSaveFile file(fileName);
+
+    if(!file.open(QIODevice::WriteOnly)) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to open" << fileName << ":" << file.errorString();
+        return false;
+    }
+
+    const QJsonObject document{
+      {QStringLiteral("traceEvents"), events},
+      {QStringLiteral("displayTimeUnit"), QStringLiteral("ms")},
+    };
+
+    if(-1 == file.write(QJsonDocument(document).toJson(QJsonDocument::Compact)) || !file.commit()) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to write" << fileName << ":" << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Record how long the scope took.
+ */
+void Instrumentation::Scope::finish()
+{
+    const auto duration = now() - m_start;
+    recordEnabled(m_histogram, duration);
+    traceComplete(m_name, m_start, duration);
+}
+
+/**
+ * @brief Work out the value below which a proportion of the values fall.
+ *
+ * @param fraction The proportion, between 0 and 1.
+ *
+ * The histogram only knows which power of two each value was between, so the
+ * result is the top of the bucket the value is in, or the maximum if that's
+ * lower.
+ *
+ * @return The value, or 0 if the histogram is empty.
+ */
+quint64 Instrumentation::HistogramSnapshot::percentile(double fraction) const
+{
+    if(0 == count) {
+        return 0;
+    }
+
+    const auto target = static_cast<quint64>(fraction * static_cast<double>(count));
+    quint64 seen = 0;
+
+    for(std::size_t index = 0; index < buckets.size(); ++index) {
+        seen += buckets[index];
+
+        if(index + 1 == buckets.size()) {
+            break;
+        }
+
+        if(seen > target) {
+            const quint64 top = (0 == index ? 0 : (quint64(1) << index) - 1);
+            return std::min(top, maximum);
+        }
+    }
+
+    return maximum;
+}
+
+/**
+ * @class Instrumentation::Scope
+ *
+ * @brief Times the block of code it is declared in.
+ *
+ * If the instrumentation is enabled when the scope is created, its duration is
+ * recorded in a histogram and as a trace event when it is destroyed.
+ */
+
+/**
+ * @fn Instrumentation::isEnabled()
+ * @brief Check whether measurements are being recorded.
+ *
+ * @return @b true if they are, @b false if not.
+ */
+
+/**
+ * @fn Instrumentation::add(Counter, quint64)
+ * @brief Add to a counter, if the instrumentation is enabled.
+ *
+ * @param counter The counter.
+ * @param amount How much to add.
+ */
+
+/**
+ * @fn Instrumentation::record(Histogram, quint64)
+ * @brief Record a value in a histogram, if the instrumentation is enabled.
+ *
+ * @param histogram The histogram.
+ * @param value The value. Durations are in microseconds.
+ */
@@ -0,0 +1,129 @@
+/**
+ * @file instrumentation.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the Instrumentation class.
+ */
+
+#ifndef QYNC_INSTRUMENTATION_H
+#define QYNC_INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+
+#include <QtCore/QString>
+
+namespace Qync {
+
+	class Instrumentation final {
+	public:
+		enum class Counter : int {
+			StdoutReads = 0,
+			StdoutBytes,
+			LinesParsed,
+			EventsDispatched,
+			ProgressUpdates,
+			ProgressUpdatesDropped,
+		};
+
+		enum class Histogram : int {
+			StdoutReadSize = 0,
+			ParseBatchTime,
+			DispatchTime,
+			UiUpdateTime,
+			RepaintTime,
+			EventLoopLag,
+		};
+
+		static constexpr const int CounterCount = 6;
+		static constexpr const int HistogramCount = 6;
+		static constexpr const int BucketCount = 32;
+
+		struct HistogramSnapshot {
+			quint64 count = 0;
+			quint64 sum = 0;
+			quint64 minimum = 0;
+			quint64 maximum = 0;
+			std::array<quint64, BucketCount> buckets = {};
+
+			[[nodiscard]] inline double mean() const {
+				return (0 == count ? 0.0 : static_cast<double>(sum) / count);
+			}
+
+			[[nodiscard]] quint64 percentile(double fraction) const;
+		};
+
+		class Scope final {
+		public:
+			inline Scope(Histogram histogram, const char * name)
+			: m_histogram(histogram),
+			  m_name(name),
+			  m_start(isEnabled() ? now() : NotStarted) {
+			}
+
+			inline ~Scope() {
+				if(NotStarted != m_start) {
+					finish();
+				}
+			}
+
+			Scope(const Scope &) = delete;
+			Scope(Scope &&) = delete;
+			void operator=(const Scope &) = delete;
+			void operator=(Scope &&) = delete;
+
+		private:
+			static constexpr const quint64 NotStarted = ~quint64(0);
+
+			void finish();
+
+			Histogram m_histogram;
+			const char * m_name;
+			quint64 m_start;
+		};
+
+		Instrumentation() = delete;
+
+		[[nodiscard]] static inline bool isEnabled() {
+			return s_enabled.load(std::memory_order_relaxed);
+		}
+
+		static void setEnabled(bool enabled);
+		static void reset();
+
+		static inline void add(Counter counter, quint64 amount = 1) {
+			if(isEnabled()) {
+				addEnabled(counter, amount);
+			}
+		}
+
+		static inline void record(Histogram histogram, quint64 value) {
+			if(isEnabled()) {
+				recordEnabled(histogram, value);
+			}
+		}
+
+		[[nodiscard]] static quint64 now();
+		[[nodiscard]] static quint64 counter(Counter counter);
+		[[nodiscard]] static HistogramSnapshot histogram(Histogram histogram);
+		[[nodiscard]] static QString name(Counter counter);
+		[[nodiscard]] static QString name(Histogram histogram);
+		[[nodiscard]] static bool isDuration(Histogram histogram);
+
+		static void traceComplete(const char * name, quint64 start, quint64 duration);
+		static void traceCounter(const char * name, quint64 value);
+		[[nodiscard]] static int traceEventCount();
+		static bool exportChromeTrace(const QString & fileName);
+
+	private:
+		static void addEnabled(Counter counter, quint64 amount);
+		static void recordEnabled(Histogram histogram, quint64 value);
+
+		static inline std::atomic<bool> s_enabled{false};
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_INSTRUMENTATION_H
@@ -0,0 +1,994 @@
+/**
+ * @file jobscheduler.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the JobScheduler class.
+ */
+
+#include "jobscheduler.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMetaObject>
+#include <QtCore/QStorageInfo>
+
+#include "preferences.h"
+#include "preset.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::JobScheduler class.
+ */
+namespace Qync::Detail::JobScheduler {
+    // finished processes kept for createProcess() to reuse. enough for a watched
+    // preset or two plus a preset queued repeatedly
+    static constexpr const std::size_t MaximumIdleProcesses = 4;
+
+    static bool isFinishedState(Qync::JobScheduler::JobState state)
+    {
+        return Qync::JobScheduler::JobState::Queued != state && Qync::JobScheduler::JobState::Running != state;
+    }
+
+    static Qync::JobScheduler::JobState stateForExitCode(Process::ExitCode code)
+    {
+        switch(code) {
+            // a file that disappeared during the run is only missing because it's no longer in the source
+            case Process::ExitCode::Success:
+            case Process::ExitCode::VanishedSourceFile:
+                return Qync::JobScheduler::JobState::Succeeded;
+
+            case Process::ExitCode::InterruptReceived:
+                return Qync::JobScheduler::JobState::Interrupted;
+
+            default:
+                break;
+        }
+
+        return Qync::JobScheduler::JobState::Failed;
+    }
+
+    // rsync's exit codes for not getting through to the remote host at all. ssh
+    // exits with 255 when it can't connect, which rsync passes on
+    static bool isConnectionError(int code)
+    {
+        switch(code) {
+            case static_cast<int>(Process::ExitCode::SocketIoError):
+            case static_cast<int>(Process::ExitCode::DataStreamError):
+            case static_cast<int>(Process::ExitCode::DataTransmissionTimeout):
+            case static_cast<int>(Process::ExitCode::ConnectionTimeout):
+            case static_cast<int>(Process::ExitCode::RemoteShellError):
+                return true;
+
+            default:
+                break;
+        }
+
+        return false;
+    }
+}  // namespace Qync::Detail::JobScheduler
+
+/**
+ * @class JobScheduler
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Runs a queue of rsync processes with a limit on how many run at once.
+ *
+ * Jobs are added with enqueue(), either from a Preset (in which case the
+ * scheduler creates the Process) or with a Process that has been created but
+ * not started. The scheduler owns the processes and starts them in the order
+ * they were queued as long as fewer than maximumConcurrentJobs() are running.
+ *
+ * Each job is tagged with the devices its source and destination live on (see
+ * deviceKey()). A job is never started while another job using any of the
+ * same devices is running, so two jobs don't fight over the same disk or the
+ * same remote host. A queued job that is held back for this reason doesn't
+ * hold up the jobs behind it.
+ *
+ * jobStarted() and jobFinished() are emitted as jobs start and finish, and
+ * queueFinished() is emitted when the last running job finishes and no more
+ * are queued. The result of each job - its state, exit code, the number of
+ * items and bytes rsync reported, how long it ran and how many times rsync was
+ * retried (see Process::retryCount()) - is available from jobs() and job()
+ * until clearFinished() is called. throughput() reports the bytes transferred
+ * per second, measured over the time during which at least one job was
+ * running.
+ *
+ * The jobs can be given a bandwidth budget with setBandwidthBudget(), which is
+ * shared between the running jobs. A job that would like less than an equal
+ * share (see Process::preferredBandwidthLimit()) is given what it would like,
+ * and what it leaves is shared between the others. The budget is shared out
+ * again whenever a job starts or finishes, or a job's preference changes.
+ *
+ * While a job is running, its process() can be given to a ProcessWidget or
+ * ProcessDialogue to show its progress. The scheduler releases its reference
+ * to the process shortly after the process finishes.
+ *
+ * A finished process that nothing else refers to is kept for a while (with all
+ * its signals disconnected) so that createProcess() can rearm it for the next
+ * run of the same preset instead of creating a new one (see Process::rearm()).
+ * This is what happens for a watched preset, whose batches are all run from the
+ * same Preset object.
+ *
+ * When a preset with a remote source or destination is queued, the source and
+ * the directory the destination goes in are checked with remoteLister() before
+ * the job is allowed to start. A job whose source or destination directory
+ * does not exist, or whose host refuses the request, fails without running
+ * rsync, with the reason in its error. A job whose host can't be reached fails
+ * the same way unless the preset has retryAttempts(), in which case rsync is
+ * left to retry. If the check itself can't be run, the job runs as normal.
+ */
+
+/**
+ * @brief Create a new scheduler.
+ *
+ * @param parent The parent object.
+ *
+ * The scheduler runs one job at a time until setMaximumConcurrentJobs() is
+ * called. Set the rsync command with setRsyncPath() (or applyPreferences())
+ * before queueing any presets.
+ */
+JobScheduler::JobScheduler(QObject * parent)
+:   QObject(parent),
+    m_jobs(),
+    m_idleProcesses(),
+    m_nextId(1),
+    m_rsyncPath(),
+    m_useWorkerThreads(false),
+    m_scanSources(false),
+    m_outputFormat(Process::OutputFormat::Text),
+    m_maxConcurrentJobs(1),
+    m_bandwidthBudget(0),
+    m_dispatchPending(false),
+    m_queueFinishedPending(false),
+    m_activeTimer(),
+    m_activeMs(0),
+    m_remoteLister(),
+    m_endpointChecks()
+{
+    connect(&m_remoteLister, &RemoteLister::listingFinished, this, &JobScheduler::onEndpointChecked);
+}
+
+/**
+ * @brief Destroy the scheduler.
+ *
+ * Any running processes are killed. No signals are emitted.
+ */
+JobScheduler::~JobScheduler()
+{
+    for(auto & job : m_jobs) {
+        if(job.process) {
+            job.process->disconnect(this);
+        }
+    }
+}
+
+/**
+ * @brief Set how many jobs may run at once.
+ *
+ * @param max The maximum number of concurrent jobs. Values less than 1 are
+ * treated as 1.
+ *
+ * Running jobs are not affected if the limit is reduced.
+ */
+void JobScheduler::setMaximumConcurrentJobs(int max)
+{
+    m_maxConcurrentJobs = std::max(max, 1);
+    scheduleDispatch();
+}
+
+/**
+ * @brief Set the bandwidth shared between the running jobs.
+ *
+ * @param budget The budget in KiB per second, 0 for none. Negative values are
+ * treated as 0.
+ *
+ * Running jobs are given their new shares straight away, which restarts their
+ * rsync processes if their bandwidth limits change.
+ */
+void JobScheduler::setBandwidthBudget(int budget)
+{
+    budget = std::max(budget, 0);
+
+    if(budget == m_bandwidthBudget) {
+        return;
+    }
+
+    m_bandwidthBudget = budget;
+    rebalanceBandwidth();
+}
+
+/**
+ * @brief Take the scheduler's settings from a set of preferences.
+ *
+ * @param prefs The preferences.
+ *
+ * The rsync command, whether to use worker threads, whether to scan sources,
+ * the maximum number of concurrent jobs and the bandwidth budget are all set.
+ * Jobs that have already been queued are not affected by the rsync command,
+ * worker thread or source scan settings. The output format depends on the
+ * rsync rather than on the preferences, so it is set separately with
+ * setOutputFormat().
+ */
+void JobScheduler::applyPreferences(const Preferences & prefs)
+{
+    setRsyncPath(prefs.rsyncPath());
+    setUseWorkerThreads(prefs.useWorkerThread());
+    setScanSources(prefs.scanSources());
+    setMaximumConcurrentJobs(prefs.maximumConcurrentJobs());
+    setBandwidthBudget(prefs.bandwidthBudget());
+}
+
+/**
+ * @brief Create a process for a preset with the scheduler's settings.
+ *
+ * @param preset The preset.
+ * @param type The type of run.
+ *
+ * The process runs rsyncPath(), uses a worker thread if usesWorkerThreads(),
+ * scans its source if scansSources() and uses outputFormat(). It is not queued,
+ * so that the caller can adjust it before passing it to enqueue().
+ *
+ * If a finished process of the same type that last ran the same revision of the
+ * preset is idle, it is rearmed and returned rather than creating a new one.
+ *
+ * @return The process.
+ */
+std::shared_ptr<Process> JobScheduler::createProcess(const Preset & preset, Process::RunType type)
+{
+    std::shared_ptr<Process> process;
+
+    auto idle = std::find_if(m_idleProcesses.begin(), m_idleProcesses.end(), [this, &preset, type](const std::shared_ptr<Process> & candidate) {
+        return candidate->runType() == type && candidate->presetRevision() == preset.revision() && candidate->command() == m_rsyncPath;
+    });
+
+    if(m_idleProcesses.end() != idle && (*idle)->rearm(preset)) {
+        process = std::move(*idle);
+        m_idleProcesses.erase(idle);
+    }
+    else {
+        process = std::make_shared<Process>(m_rsyncPath, preset, type);
+    }
+
+    process->setUseWorkerThread(m_useWorkerThreads);
+    process->setScanSource(m_scanSources);
+    process->setOutputFormat(m_outputFormat);
+    return process;
+}
+
+/**
+ * @brief Queue a job to run a preset.
+ *
+ * @param preset The preset. The process is created immediately, so changes to
+ * the preset after it has been queued have no effect on the job.
+ * @param type The type of run.
+ *
+ * The process is created with createProcess(). The job is held in the queue
+ * until its remote source and destination, if any, have been checked.
+ *
+ * @return The ID of the new job.
+ */
+JobScheduler::JobId JobScheduler::enqueue(const Preset & preset, Process::RunType type)
+{
+    const auto id = enqueue(preset.name(), createProcess(preset, type), presetDevices(preset));
+    checkEndpoints(*findJob(id), preset);
+    return id;
+}
+
+/**
+ * @brief Queue a job to run a process.
+ *
+ * @param name The name of the job.
+ * @param process The process. It must not have been started.
+ * @param devices The devices the process uses. See deviceKey().
+ *
+ * @return The ID of the new job.
+ */
+JobScheduler::JobId JobScheduler::enqueue(QString name, std::shared_ptr<Process> process, QStringList devices)
+{
+    Q_ASSERT_X(process, __PRETTY_FUNCTION__, "can't queue a null process");
+    devices.removeAll({});
+    devices.removeDuplicates();
+
+    Job job;
+    job.id = m_nextId++;
+    job.name = std::move(name);
+    job.devices = std::move(devices);
+    job.process = std::move(process);
+    m_jobs.push_back(std::move(job));
+
+    auto id = m_jobs.back().id;
+    Q_EMIT jobQueued(id);
+    scheduleDispatch();
+    return id;
+}
+
+/**
+ * @brief Fetch a job.
+ *
+ * @param id The ID of the job.
+ *
+ * @return The job, or @b nullptr if there is no job with the ID provided. The
+ * pointer is invalidated when another job is queued or clearFinished() is
+ * called.
+ */
+const JobScheduler::Job * JobScheduler::job(JobId id) const
+{
+    auto job = std::find_if(m_jobs.cbegin(), m_jobs.cend(), [id](const Job & job) {
+        return job.id == id;
+    });
+
+    return (m_jobs.cend() == job ? nullptr : &(*job));
+}
+
+/**
+ * @brief Fetch a job for modification.
+ *
+ * @param id The ID of the job.
+ *
+ * @return The job, or @b nullptr if there is no job with the ID provided.
+ */
+JobScheduler::Job * JobScheduler::findJob(JobId id)
+{
+    return const_cast<Job *>(job(id));
+}
+
+/**
+ * @brief Count the jobs waiting to start.
+ *
+ * @return The number of queued jobs.
+ */
+int JobScheduler::queuedJobCount() const
+{
+    return static_cast<int>(std::count_if(m_jobs.cbegin(), m_jobs.cend(), [](const Job & job) {
+        return JobState::Queued == job.state;
+    }));
+}
+
+/**
+ * @brief Count the jobs that are running.
+ *
+ * @return The number of running jobs.
+ */
+int JobScheduler::runningJobCount() const
+{
+    return static_cast<int>(std::count_if(m_jobs.cbegin(), m_jobs.cend(), [](const Job & job) {
+        return JobState::Running == job.state;
+    }));
+}
+
+/**
+ * @brief Fetch the total number of bytes reported by all the jobs.
+ *
+ * This is the sum of the sizes of the items rsync reported as transferred, for
+ * both running and finished jobs.
+ *
+ * @return The number of bytes.
+ */
+quint64 JobScheduler::totalBytes() const
+{
+    quint64 bytes = 0;
+
+    for(const auto & job : m_jobs) {
+        bytes += job.bytes;
+    }
+
+    return bytes;
+}
+
+/**
+ * @brief Fetch the overall throughput of the queue.
+ *
+ * @return The number of bytes transferred per second while at least one job
+ * was running, or 0 if no job has run yet.
+ */
+double JobScheduler::throughput() const
+{
+    qint64 ms = m_activeMs + (m_activeTimer.isValid() ? m_activeTimer.elapsed() : 0);
+
+    if(0 >= ms) {
+        return 0.0;
+    }
+
+    return static_cast<double>(totalBytes()) * 1000.0 / static_cast<double>(ms);
+}
+
+/**
+ * @brief Work out which device an rsync source or destination is on.
+ *
+ * @param path The source or destination.
+ *
+ * For remote paths (host:path, user\@host:path and rsync://host/path) the key
+ * identifies the host. For local paths it identifies the storage device on
+ * which the nearest existing directory is found, so a destination that does
+ * not exist yet is still attributed to the right device.
+ *
+ * @return A key that is the same for all paths on the same device, or an empty
+ * string if the path is empty.
+ */
+QString JobScheduler::deviceKey(const QString & path)
+{
+    if(path.isEmpty()) {
+        return {};
+    }
+
+    if(path.startsWith(QStringLiteral("rsync://"))) {
+        auto host = path.mid(8).section('/', 0, 0).section('@', -1);
+        return QStringLiteral("host:") + host.section(':', 0, 0);
+    }
+
+    auto colon = path.indexOf(':');
+
+    // a single letter before the colon is a Windows drive, not a host
+    if(1 < colon && (-1 == path.indexOf('/') || colon < path.indexOf('/'))) {
+        return QStringLiteral("host:") + path.left(colon).section('@', -1);
+    }
+
+    QFileInfo info(path);
+
+    while(!info.exists() && !info.isRoot()) {
+        auto parent = info.absolutePath();
+
+        if(parent == info.absoluteFilePath()) {
+            break;
+        }
+
+        info.setFile(parent);
+    }
+
+    QStorageInfo storage(info.absoluteFilePath());
+
+    if(!storage.isValid()) {
+        return QStringLiteral("path:") + QDir::cleanPath(info.absoluteFilePath());
+    }
+
+    return QStringLiteral("device:") + QString::fromLocal8Bit(storage.device());
+}
+
+/**
+ * @brief Work out which devices a preset uses.
+ *
+ * @param preset The preset.
+ *
+ * @return The device keys for the preset's source, destination and fan-out
+ * destinations.
+ */
+QStringList JobScheduler::presetDevices(const Preset & preset)
+{
+    QStringList devices = {deviceKey(preset.source()), deviceKey(preset.destination())};
+
+    for(const auto & destination : preset.fanOutDestinationList()) {
+        devices.push_back(deviceKey(destination));
+    }
+
+    return devices;
+}
+
+/**
+ * @brief Cancel a job.
+ *
+ * @param id The ID of the job.
+ *
+ * A queued job is removed from the queue; a running job is stopped.
+ */
+void JobScheduler::cancel(JobId id)
+{
+    auto * job = findJob(id);
+
+    if(!job) {
+        qWarning() << __PRETTY_FUNCTION__ << "no job with ID" << id;
+        return;
+    }
+
+    if(JobState::Queued == job->state) {
+        cancelEndpointChecks(id);
+        job->state = JobState::Cancelled;
+        job->process.reset();
+        Q_EMIT jobFinished(id, Process::ExitCode::InterruptReceived);
+        m_queueFinishedPending = true;
+        scheduleDispatch();
+    }
+    else if(JobState::Running == job->state) {
+        job->process->stop();
+    }
+}
+
+/**
+ * @brief Cancel all queued jobs and stop all running jobs.
+ */
+void JobScheduler::stopAll()
+{
+    std::vector<JobId> ids;
+
+    for(const auto & job : m_jobs) {
+        if(!Detail::JobScheduler::isFinishedState(job.state)) {
+            ids.push_back(job.id);
+        }
+    }
+
+    // queued jobs first, so that none of them is started as a running one finishes
+    std::stable_partition(ids.begin(), ids.end(), [this](JobId id) {
+        return JobState::Queued == job(id)->state;
+    });
+
+    for(auto id : ids) {
+        cancel(id);
+    }
+}
+
+/**
+ * @brief Forget the jobs that have finished.
+ *
+ * The throughput measurement is also reset if there are no running jobs.
+ *
+ * This must not be called from inside one of a Process's signals, since a
+ * finished job's process may not have been released yet; call it from
+ * queueFinished() instead.
+ */
+void JobScheduler::clearFinished()
+{
+    m_jobs.erase(std::remove_if(m_jobs.begin(), m_jobs.end(), [](const Job & job) {
+        return Detail::JobScheduler::isFinishedState(job.state);
+    }), m_jobs.end());
+
+    if(0 == runningJobCount()) {
+        m_activeMs = 0;
+        m_activeTimer.invalidate();
+    }
+}
+
+/**
+ * @brief Check whether a queued job may start now.
+ *
+ * @param job The job.
+ *
+ * @return @b true if the job's endpoints have been checked and none of the
+ * running jobs uses any of the job's devices.
+ */
+bool JobScheduler::canStart(const Job & job) const
+{
+    if(0 < job.pendingChecks) {
+        return false;
+    }
+
+    return std::none_of(m_jobs.cbegin(), m_jobs.cend(), [&job](const Job & other) {
+        if(JobState::Running != other.state) {
+            return false;
+        }
+
+        return std::any_of(job.devices.cbegin(), job.devices.cend(), [&other](const QString & device) {
+            return other.devices.contains(device);
+        });
+    });
+}
+
+/**
+ * @brief Arrange for dispatch() to be called from the event loop.
+ *
+ * Dispatching is always deferred, so that jobs are never started, and finished
+ * processes never released, from inside one of a Process's signals. For the
+ * same reason queueFinished() is only emitted from dispatch(), once the
+ * finished processes have been released, so its receivers are free to call
+ * clearFinished().
+ */
+void JobScheduler::scheduleDispatch()
+{
+    if(m_dispatchPending) {
+        return;
+    }
+
+    m_dispatchPending = true;
+    QMetaObject::invokeMethod(this, &JobScheduler::dispatch, Qt::QueuedConnection);
+}
+
+/**
+ * @brief Release finished processes and start as many queued jobs as possible.
+ *
+ * If a job has finished since the last dispatch and there is nothing left to
+ * run, queueFinished() is emitted.
+ */
+void JobScheduler::dispatch()
+{
+    m_dispatchPending = false;
+
+    for(auto & job : m_jobs) {
+        if(Detail::JobScheduler::isFinishedState(job.state) && job.process) {
+            if(1 == job.process.use_count() && !job.process->isRunning()) {
+                // nobody else is watching it, so it can be reused
+                job.process->disconnect();
+                m_idleProcesses.push_back(std::move(job.process));
+
+                if(Detail::JobScheduler::MaximumIdleProcesses < m_idleProcesses.size()) {
+                    m_idleProcesses.erase(m_idleProcesses.begin());
+                }
+            }
+            else {
+                job.process->disconnect(this);
+            }
+
+            job.process.reset();
+        }
+    }
+
+    int running = runningJobCount();
+
+    // jobs are started in queue order, skipping any that share a device with a running job
+    for(std::size_t index = 0; index < m_jobs.size() && running < m_maxConcurrentJobs; ++index) {
+        auto & job = m_jobs[index];
+
+        if(JobState::Queued != job.state || !canStart(job)) {
+            continue;
+        }
+
+        start(job);
+        ++running;
+    }
+
+    if(std::exchange(m_queueFinishedPending, false) && isIdle()) {
+        Q_EMIT queueFinished();
+    }
+}
+
+/**
+ * @brief Start a job.
+ *
+ * @param job The job.
+ */
+void JobScheduler::start(Job & job)
+{
+    auto id = job.id;
+    auto * process = job.process.get();
+
+    connect(process, &Process::itemStarted, this, [this, id](PathStore::Id, quint64 size) {
+        auto * job = findJob(id);
+        job->bytes += size;
+        ++job->items;
+    });
+
+    connect(process, qOverload<Process::ExitCode>(&Process::finished), this, [this, id](Process::ExitCode code) {
+        onJobFinished(id, code);
+    });
+
+    // queued, because giving out shares can change what the processes prefer
+    connect(process, &Process::preferredBandwidthLimitChanged, this, &JobScheduler::rebalanceBandwidth, Qt::QueuedConnection);
+
+    if(!m_activeTimer.isValid()) {
+        m_activeTimer.start();
+    }
+
+    job.state = JobState::Running;
+    job.timer.start();
+
+    // before the process starts, so that its rsync starts with its share
+    rebalanceBandwidth();
+    Q_EMIT jobStarted(id);
+    process->start();
+}
+
+/**
+ * @brief Called when the process for a job has finished.
+ *
+ * @param id The ID of the job.
+ * @param code The rsync exit code.
+ */
+void JobScheduler::onJobFinished(JobId id, Process::ExitCode code)
+{
+    auto * job = findJob(id);
+    Q_ASSERT_X(job, __PRETTY_FUNCTION__, "finished job is not in the queue");
+    job->state = Detail::JobScheduler::stateForExitCode(code);
+    job->exitCode = code;
+    job->elapsedMs = job->timer.elapsed();
+
+    if(job->process) {
+        job->retries = job->process->retryCount();
+        job->resumedBytes = job->process->resumedBytes();
+    }
+
+    if(0 == runningJobCount()) {
+        m_activeMs += m_activeTimer.elapsed();
+        m_activeTimer.invalidate();
+    }
+
+    Q_EMIT jobFinished(id, code);
+    rebalanceBandwidth();
+    m_queueFinishedPending = true;
+    scheduleDispatch();
+}
+
+/**
+ * @brief Share the bandwidth budget between the running jobs.
+ *
+ * The jobs are considered in order of the limit they would like, lowest first,
+ * with those that would like no limit last. Each is given the lesser of what it
+ * would like and an equal share of what is left of the budget. Without a budget,
+ * the jobs are given no limit.
+ */
+void JobScheduler::rebalanceBandwidth()
+{
+    std::vector<std::pair<int, Process *>> demands;
+
+    for(auto & job : m_jobs) {
+        if(JobState::Running == job.state && job.process) {
+            const auto preferred = job.process->preferredBandwidthLimit();
+            demands.emplace_back((0 < preferred ? preferred : std::numeric_limits<int>::max()), job.process.get());
+        }
+    }
+
+    if(0 == m_bandwidthBudget) {
+        for(auto & demand : demands) {
+            demand.second->setBandwidthShare(0);
+        }
+
+        return;
+    }
+
+    std::stable_sort(demands.begin(), demands.end(), [](const auto & first, const auto & second) {
+        return first.first < second.first;
+    });
+
+    auto remaining = m_bandwidthBudget;
+    auto count = static_cast<int>(demands.size());
+
+    for(auto & demand : demands) {
+        // never 0, which would be no limit at all
+        const auto share = std::max(std::min(demand.first, remaining / count), 1);
+        demand.second->setBandwidthShare(share);
+        remaining = std::max(remaining - share, 0);
+        --count;
+    }
+}
+
+/**
+ * @brief Check the remote source and destination of a newly queued job.
+ *
+ * @param job The job.
+ * @param preset The preset the job runs.
+ *
+ * The destination itself need not exist, since rsync creates it, so it is the
+ * directory it goes in that is checked. The fan-out destinations are not
+ * checked: one that can't be reached fails on its own when the job runs rather
+ * than failing the job for all the others.
+ */
+void JobScheduler::checkEndpoints(Job & job, const Preset & preset)
+{
+    const auto failOnConnectionError = (0 == preset.retryAttempts());
+
+    const auto check = [this, &job, &preset, failOnConnectionError](const QString & endpoint) {
+        m_endpointChecks.emplace(m_remoteLister.check(preset, endpoint), EndpointCheck{job.id, endpoint, failOnConnectionError});
+        ++job.pendingChecks;
+    };
+
+    if(RemoteLister::isRemote(preset.source())) {
+        check(preset.source());
+    }
+
+    if(RemoteLister::isRemote(preset.destination())) {
+        check(RemoteLister::parentOf(preset.destination()));
+    }
+}
+
+/**
+ * @brief Called when a check of a job's remote source or destination has
+ * finished.
+ *
+ * @param request The lister's request for the check.
+ * @param exitCode rsync's exit code for the check.
+ * @param error Why the check failed.
+ *
+ * The lister is shared with the path completers, so listings that aren't
+ * checks are ignored.
+ */
+void JobScheduler::onEndpointChecked(RemoteLister::RequestId request, int exitCode, const QString & error)
+{
+    const auto it = m_endpointChecks.find(request);
+
+    if(m_endpointChecks.end() == it) {
+        return;
+    }
+
+    const auto check = std::move(it->second);
+    m_endpointChecks.erase(it);
+    auto * job = findJob(check.job);
+
+    if(!job || JobState::Queued != job->state) {
+        return;
+    }
+
+    --job->pendingChecks;
+
+    // a check that couldn't be run says nothing about the endpoint, so rsync is left to find out
+    if(0 == exitCode || RemoteLister::NotRun == exitCode || (!check.failOnConnectionError && Detail::JobScheduler::isConnectionError(exitCode))) {
+        scheduleDispatch();
+        return;
+    }
+
+    if(static_cast<int>(Process::ExitCode::PartialTransferError) == exitCode) {
+        failQueuedJob(*job, Process::ExitCode::FileSelectionError, tr("%1 was not found on the remote host.").arg(check.endpoint));
+    }
+    else if(error.isEmpty()) {
+        failQueuedJob(*job, static_cast<Process::ExitCode>(exitCode), tr("%1 could not be reached.").arg(check.endpoint));
+    }
+    else {
+        failQueuedJob(*job, static_cast<Process::ExitCode>(exitCode), tr("%1 could not be reached: %2").arg(check.endpoint, error));
+    }
+}
+
+/**
+ * @brief Abandon the outstanding checks for a job.
+ *
+ * @param id The ID of the job.
+ */
+void JobScheduler::cancelEndpointChecks(JobId id)
+{
+    for(auto it = m_endpointChecks.begin(); it != m_endpointChecks.end();) {
+        if(it->second.job == id) {
+            m_remoteLister.cancel(it->first);
+            it = m_endpointChecks.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+/**
+ * @brief Fail a queued job without running it.
+ *
+ * @param job The job.
+ * @param code The exit code to report for the job.
+ * @param error Why the job failed.
+ */
+void JobScheduler::failQueuedJob(Job & job, Process::ExitCode code, QString error)
+{
+    const auto id = job.id;
+    cancelEndpointChecks(id);
+    qWarning() << __PRETTY_FUNCTION__ << "job" << id << "failed its checks:" << error;
+    job.state = JobState::Failed;
+    job.exitCode = code;
+    job.error = std::move(error);
+    job.pendingChecks = 0;
+    job.process.reset();
+    Q_EMIT jobFinished(id, code);
+    m_queueFinishedPending = true;
+    scheduleDispatch();
+}
+
+/**
+ * @fn JobScheduler::maximumConcurrentJobs()
+ * @brief Fetch how many jobs may run at once.
+ *
+ * @return The maximum number of concurrent jobs.
+ */
+
+/**
+ * @fn JobScheduler::rsyncPath()
+ * @brief Fetch the rsync command used for presets that are queued.
+ *
+ * @return The path to rsync.
+ */
+
+/**
+ * @fn JobScheduler::setRsyncPath()
+ * @brief Set the rsync command used for presets that are queued.
+ *
+ * @param path The path to rsync.
+ *
+ * The remoteLister() uses the same command.
+ */
+
+/**
+ * @fn JobScheduler::remoteLister()
+ * @brief Fetch the lister used to check remote sources and destinations.
+ *
+ * It can be shared with anything else that lists remote paths, so that they
+ * share its cache and its limit on concurrent listings.
+ *
+ * @return The lister.
+ */
+
+/**
+ * @fn JobScheduler::usesWorkerThreads()
+ * @brief Check whether the processes for queued presets use worker threads.
+ *
+ * @return @b true if they do, @b false otherwise.
+ */
+
+/**
+ * @fn JobScheduler::setUseWorkerThreads()
+ * @brief Set whether the processes for queued presets use worker threads.
+ *
+ * @param use @b true if they should, @b false otherwise.
+ */
+
+/**
+ * @fn JobScheduler::scansSources()
+ * @brief Check whether the processes for queued presets scan their sources to
+ * estimate overall progress.
+ *
+ * @return @b true if they do, @b false otherwise.
+ */
+
+/**
+ * @fn JobScheduler::setScanSources()
+ * @brief Set whether the processes for queued presets scan their sources to
+ * estimate overall progress.
+ *
+ * @param scan @b true if they should, @b false otherwise.
+ */
+
+/**
+ * @fn JobScheduler::jobs()
+ * @brief Fetch all the jobs the scheduler knows about, in the order they were
+ * queued.
+ *
+ * @return The jobs.
+ */
+
+/**
+ * @fn JobScheduler::isIdle()
+ * @brief Check whether there are any jobs queued or running.
+ *
+ * @return @b true if there are none, @b false otherwise.
+ */
+
+/**
+ * @fn JobScheduler::jobQueued(JobScheduler::JobId)
+ * @brief Emitted when a job has been queued.
+ *
+ * @param id The ID of the job.
+ */
+
+/**
+ * @fn JobScheduler::jobStarted(JobScheduler::JobId)
+ * @brief Emitted when a job's process is about to be started.
+ *
+ * @param id The ID of the job.
+ */
+
+/**
+ * @fn JobScheduler::jobFinished(JobScheduler::JobId, Process::ExitCode)
+ * @brief Emitted when a job has finished or been cancelled.
+ *
+ * @param id The ID of the job.
+ * @param code The rsync exit code. Cancelled jobs report
+ * Process::ExitCode::InterruptReceived.
+ */
+
+/**
+ * @fn JobScheduler::queueFinished()
+ * @brief Emitted when the last job has finished and there are no more queued.
+ *
+ * It is emitted from the event loop rather than from inside the finished
+ * Process's signals, so receivers may call clearFinished().
+ */
+
+/**
+ * @fn JobScheduler::outputFormat()
+ * @brief Fetch the output format used for presets that are queued.
+ *
+ * @return The output format.
+ */
+
+/**
+ * @fn JobScheduler::setOutputFormat()
+ * @brief Set the output format used for presets that are queued.
+ *
+ * @param format The output format. It must be supported by rsyncPath() (see
+ * Process::outputFormatFor()).
+ */
+
+/**
+ * @fn JobScheduler::bandwidthBudget()
+ * @brief Fetch the bandwidth shared between the running jobs.
+ *
+ * @return The budget in KiB per second, 0 for none.
+ */
@@ -0,0 +1,189 @@
+/**
+ * @file jobscheduler.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the JobScheduler class.
+ */
+
+#ifndef QYNC_JOBSCHEDULER_H
+#define QYNC_JOBSCHEDULER_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include "process.h"
+#include "remotelister.h"
+
+namespace Qync {
+
+	class Preset;
+	class Preferences;
+
+	class JobScheduler
+	: public QObject {
+		Q_OBJECT
+
+	public:
+		using JobId = int;
+
+		enum class JobState : unsigned char {
+			Queued = 0,
+			Running,
+			Succeeded,
+			Failed,
+			Interrupted,
+			Cancelled,
+		};
+
+		struct Job {
+			JobId id = 0;
+			QString name;
+			QStringList devices;
+			JobState state = JobState::Queued;
+			Process::ExitCode exitCode = Process::ExitCode::Success;
+			quint64 bytes = 0;
+			int items = 0;
+			qint64 elapsedMs = 0;
+			int retries = 0;
+			quint64 resumedBytes = 0;
+			QString error;
+			int pendingChecks = 0;
+			std::shared_ptr<Process> process;
+			QElapsedTimer timer;
+		};
+
+		explicit JobScheduler(QObject * parent = nullptr);
+		~JobScheduler() override;
+
+		[[nodiscard]] inline int maximumConcurrentJobs() const {
+			return m_maxConcurrentJobs;
+		}
+
+		void setMaximumConcurrentJobs(int max);
+
+		[[nodiscard]] inline int bandwidthBudget() const {
+			return m_bandwidthBudget;
+		}
+
+		void setBandwidthBudget(int budget);
+
+		[[nodiscard]] inline const QString & rsyncPath() const {
+			return m_rsyncPath;
+		}
+
+		inline void setRsyncPath(QString path) {
+			m_remoteLister.setRsyncPath(path);
+			m_rsyncPath = std::move(path);
+		}
+
+		[[nodiscard]] inline RemoteLister & remoteLister() {
+			return m_remoteLister;
+		}
+
+		[[nodiscard]] inline bool usesWorkerThreads() const {
+			return m_useWorkerThreads;
+		}
+
+		inline void setUseWorkerThreads(bool use) {
+			m_useWorkerThreads = use;
+		}
+
+		[[nodiscard]] inline bool scansSources() const {
+			return m_scanSources;
+		}
+
+		inline void setScanSources(bool scan) {
+			m_scanSources = scan;
+		}
+
+		[[nodiscard]] inline Process::OutputFormat outputFormat() const {
+			return m_outputFormat;
+		}
+
+		inline void setOutputFormat(Process::OutputFormat format) {
+			m_outputFormat = format;
+		}
+
+		void applyPreferences(const Preferences & prefs);
+
+		[[nodiscard]] std::shared_ptr<Process> createProcess(const Preset & preset, Process::RunType type = Process::RunType::Normal);
+		JobId enqueue(const Preset & preset, Process::RunType type = Process::RunType::Normal);
+		JobId enqueue(QString name, std::shared_ptr<Process> process, QStringList devices);
+
+		[[nodiscard]] inline const std::vector<Job> & jobs() const {
+			return m_jobs;
+		}
+
+		[[nodiscard]] const Job * job(JobId id) const;
+		[[nodiscard]] int queuedJobCount() const;
+		[[nodiscard]] int runningJobCount() const;
+
+		[[nodiscard]] inline bool isIdle() const {
+			return 0 == queuedJobCount() && 0 == runningJobCount();
+		}
+
+		[[nodiscard]] quint64 totalBytes() const;
+		[[nodiscard]] double throughput() const;
+
+		[[nodiscard]] static QString deviceKey(const QString & path);
+		[[nodiscard]] static QStringList presetDevices(const Preset & preset);
+
+	public Q_SLOTS:
+		void cancel(JobId id);
+		void stopAll();
+		void clearFinished();
+
+	Q_SIGNALS:
+		void jobQueued(JobScheduler::JobId);
+		void jobStarted(JobScheduler::JobId);
+		void jobFinished(JobScheduler::JobId, Process::ExitCode);
+		void queueFinished();
+
+	private:
+		// a check that a queued job's remote source or destination is there
+		struct EndpointCheck {
+			JobId job;
+			QString endpoint;
+			bool failOnConnectionError;
+		};
+
+		[[nodiscard]] Job * findJob(JobId id);
+		[[nodiscard]] bool canStart(const Job & job) const;
+		void scheduleDispatch();
+		void dispatch();
+		void start(Job & job);
+		void onJobFinished(JobId id, Process::ExitCode code);
+		void rebalanceBandwidth();
+		void checkEndpoints(Job & job, const Preset & preset);
+		void onEndpointChecked(RemoteLister::RequestId request, int exitCode, const QString & error);
+		void cancelEndpointChecks(JobId id);
+		void failQueuedJob(Job & job, Process::ExitCode code, QString error);
+
+		std::vector<Job> m_jobs;
+		std::vector<std::shared_ptr<Process>> m_idleProcesses;
+		JobId m_nextId;
+		QString m_rsyncPath;
+		bool m_useWorkerThreads;
+		bool m_scanSources;
+		Process::OutputFormat m_outputFormat;
+		int m_maxConcurrentJobs;
+		int m_bandwidthBudget;
+		bool m_dispatchPending;
+		bool m_queueFinishedPending;
+		QElapsedTimer m_activeTimer;
+		qint64 m_activeMs;
+		RemoteLister m_remoteLister;
+		std::unordered_map<RemoteLister::RequestId, EndpointCheck> m_endpointChecks;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_JOBSCHEDULER_H
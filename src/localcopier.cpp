@@ -0,0 +1,1159 @@
+/**
+ * @file localcopier.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the LocalCopier class.
+ */
+
+#include "localcopier.h"
+
+#include <QtCore/QtGlobal>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <set>
+#include <utility>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+
+#if defined(Q_OS_UNIX)
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#if defined(Q_OS_LINUX)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#endif
+
+#include "functions.h"
+#include "preset.h"
+#include "shardplanner.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::LocalCopier class.
+ */
+namespace Qync::Detail::LocalCopier {
+    // copying is mostly waiting for the disks, which only keep so many requests busy
+    static constexpr const int MaximumThreads = 4;
+
+    // how much is copied between progress reports and checks for being stopped
+    static constexpr const std::size_t ChunkSize = 8 * 1024 * 1024;
+
+    // the buffer for copying with read() and write(), when the kernel can't copy itself
+    static constexpr const std::size_t BufferSize = 1024 * 1024;
+    static constexpr const std::size_t BufferAlignment = 4096;
+
+    // the most often progress is reported, in ms
+    static constexpr const qint64 ProgressInterval = 100;
+
+    // what rsync would exit with
+    static constexpr const int Success = 0;
+    static constexpr const int PartialTransferError = 23;
+    static constexpr const int InterruptReceived = 20;
+
+#if defined(Q_OS_UNIX)
+    // the calls that fail like this don't work for this pair of file systems at all
+    static bool isUnsupported(int error)
+    {
+        return ENOSYS == error || EXDEV == error || EINVAL == error || EOPNOTSUPP == error || ENOTTY == error;
+    }
+
+    static const struct timespec & modifiedTime(const struct stat & info)
+    {
+#if defined(Q_OS_DARWIN)
+        return info.st_mtimespec;
+#else
+        return info.st_mtim;
+#endif
+    }
+
+    // rsync's quick check compares whole seconds
+    static bool isSameTime(const struct stat & first, const struct stat & second, int window)
+    {
+        return std::abs(static_cast<long long>(modifiedTime(first).tv_sec - modifiedTime(second).tv_sec)) <= window;
+    }
+
+    // the umask, read once (before the threads start) since reading it means setting it
+    static mode_t processUmask()
+    {
+        static const mode_t mask = []() {
+            const auto ret = ::umask(0);
+            ::umask(ret);
+            return ret;
+        }();
+
+        return mask;
+    }
+
+    // close a file descriptor when it goes out of scope
+    class FileDescriptor {
+    public:
+        explicit FileDescriptor(int fd = -1)
+        : m_fd(fd)
+        {}
+
+        FileDescriptor(const FileDescriptor &) = delete;
+        void operator=(const FileDescriptor &) = delete;
+
+        ~FileDescriptor()
+        {
+            if(0 <= m_fd) {
+                ::close(m_fd);
+            }
+        }
+
+        [[nodiscard]] inline int get() const {
+            return m_fd;
+        }
+
+        // close now, reporting whether it succeeded: for a file being written, the last chance to see an error
+        bool close()
+        {
+            const auto fd = std::exchange(m_fd, -1);
+            return 0 > fd || 0 == ::close(fd);
+        }
+
+    private:
+        int m_fd;
+    };
+#endif
+}  // namespace Qync::Detail::LocalCopier
+
+/**
+ * @brief The way one of the copying threads copies the content of files.
+ *
+ * Each thread tries the quickest way first: on Linux, cloning the file (so
+ * that on a file system that supports it the copy shares the original's
+ * blocks until one of them changes), then asking the kernel to copy the data
+ * with copy_file_range() and then with sendfile(), neither of which copies it
+ * into and out of the process. Once one of them turns out not to work for the
+ * source and destination it isn't tried again. Otherwise, and on other
+ * platforms, the data is read into a large buffer and written out again.
+ */
+class LocalCopier::Copy {
+public:
+    Copy()
+    : m_buffer(nullptr, &std::free)
+    {}
+
+#if defined(Q_OS_UNIX)
+    // progress is called with the bytes copied so far, and returns false to stop
+    template<typename Progress>
+    bool transfer(int from, int to, quint64 size, Progress && progress)
+    {
+        using namespace Detail::LocalCopier;
+        quint64 done = 0;
+
+#if defined(FICLONE)
+        if(m_tryClone && 0 < size) {
+            if(0 == ::ioctl(to, FICLONE, from)) {
+                return progress(size);
+            }
+
+            if(isUnsupported(errno)) {
+                m_tryClone = false;
+            }
+        }
+#endif
+
+#if defined(Q_OS_LINUX) && defined(__GLIBC__) && (2 < __GLIBC__ || (2 == __GLIBC__ && 27 <= __GLIBC_MINOR__))
+        if(m_tryCopyRange) {
+            while(done < size) {
+                const auto count = ::copy_file_range(from, nullptr, to, nullptr, static_cast<std::size_t>(std::min<quint64>(ChunkSize, size - done)), 0);
+
+                if(0 > count) {
+                    if(EINTR == errno) {
+                        continue;
+                    }
+
+                    if(0 == done && isUnsupported(errno)) {
+                        m_tryCopyRange = false;
+                        break;
+                    }
+
+                    return false;
+                }
+
+                if(0 == count) {
+                    // the file has shrunk since it was listed
+                    return true;
+                }
+
+                done += static_cast<quint64>(count);
+
+                if(!progress(done)) {
+                    return false;
+                }
+            }
+
+            if(m_tryCopyRange) {
+                return true;
+            }
+        }
+#endif
+
+#if defined(Q_OS_LINUX)
+        if(m_trySendfile) {
+            while(done < size) {
+                const auto count = ::sendfile(to, from, nullptr, static_cast<std::size_t>(std::min<quint64>(ChunkSize, size - done)));
+
+                if(0 > count) {
+                    if(EINTR == errno) {
+                        continue;
+                    }
+
+                    if(0 == done && isUnsupported(errno)) {
+                        m_trySendfile = false;
+                        break;
+                    }
+
+                    return false;
+                }
+
+                if(0 == count) {
+                    return true;
+                }
+
+                done += static_cast<quint64>(count);
+
+                if(!progress(done)) {
+                    return false;
+                }
+            }
+
+            if(m_trySendfile) {
+                return true;
+            }
+        }
+
+        ::posix_fadvise(from, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+        if(!m_buffer) {
+            m_buffer.reset(static_cast<char *>(std::aligned_alloc(BufferAlignment, BufferSize)));
+
+            if(!m_buffer) {
+                errno = ENOMEM;
+                return false;
+            }
+        }
+
+        quint64 sinceProgress = 0;
+
+        while(true) {
+            const auto count = ::read(from, m_buffer.get(), BufferSize);
+
+            if(0 > count) {
+                if(EINTR == errno) {
+                    continue;
+                }
+
+                return false;
+            }
+
+            if(0 == count) {
+                return progress(done);
+            }
+
+            for(ssize_t written = 0; written < count;) {
+                const auto writeCount = ::write(to, m_buffer.get() + written, static_cast<std::size_t>(count - written));
+
+                if(0 > writeCount) {
+                    if(EINTR == errno) {
+                        continue;
+                    }
+
+                    return false;
+                }
+
+                written += writeCount;
+            }
+
+            done += static_cast<quint64>(count);
+            sinceProgress += static_cast<quint64>(count);
+
+            if(ChunkSize <= sinceProgress) {
+                sinceProgress = 0;
+
+                if(!progress(done)) {
+                    return false;
+                }
+            }
+        }
+    }
+#endif
+
+private:
+    bool m_tryClone = true;
+    bool m_tryCopyRange = true;
+    bool m_trySendfile = true;
+    std::unique_ptr<char, void (*)(void *)> m_buffer;
+};
+
+/**
+ * @class LocalCopier
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Copies a local directory to a local destination without rsync.
+ *
+ * When the source and destination are both on this computer, rsync's sender
+ * and receiver processes, the pipe between them and its delta transfer are all
+ * overhead: every changed file is read and written in full anyway. The copier
+ * does the same job as rsync for those presets that it can (see canCopy()),
+ * on a small pool of threads that share a queue of directories and files
+ * still to be copied, in the same way as a SourceScanner. Each thread takes
+ * the most recently queued task, so the walk goes deep before it goes wide and
+ * the queue stays short. A directory's files are queued as separate tasks, so a
+ * directory full of large files is copied by all the threads at once.
+ *
+ * The destination is laid out the way rsync lays it out: the source
+ * directory's content is copied into the destination if the source ends with
+ * a separator, otherwise the source directory is copied into it. A file is
+ * skipped if the destination already has a file of the same size and
+ * modification time, unless the options say to ignore times; otherwise it is
+ * written to a temporary file beside the destination file, which replaces it
+ * once it is complete, so that an interrupted copy never leaves a partial
+ * file. The content is copied as described for Copy. The file's modification
+ * time, permissions, owner and group are kept according to the options, as
+ * rsync's @b --times, @b --perms, @b --owner and @b --group would keep them;
+ * directories get theirs once all their content has been copied. An owner or
+ * group that can't be set (because Qync isn't running as root) is silently
+ * left as it is, as rsync leaves it. Symbolic links are recreated if the
+ * options say so and skipped otherwise, and special files are always skipped.
+ * With deletions honoured, entries in a destination directory that aren't in
+ * the source directory are removed, unless an entry in the source directory
+ * couldn't be read, since then its copy would be removed too. rsync likewise
+ * doesn't delete after an I/O error.
+ *
+ * The copier reports what it does in ProcessEvents in the queue it is given,
+ * just as a ProcessWorker reports rsync's output, so the Process it works for
+ * emits the same signals either way. Several files are copied at once, so the
+ * progress of one can be reported after another has started; the item counts
+ * cover everything the threads have found so far. The queue has a single
+ * producer, so the threads take turns to add to it. Progress reports are
+ * dropped if the queue is full; other events are kept and added once the
+ * consumer calls resume().
+ *
+ * Start the copier with start(). stop() stops the threads after the chunk of
+ * data they are copying, removing their temporary files, and the copier
+ * finishes as rsync does when it is interrupted. The copier is only available
+ * on Unix-like platforms (see isAvailable()).
+ */
+
+/**
+ * @brief Create a new copier.
+ *
+ * @param source The directory to copy. It must be local - see canCopy().
+ * @param destination The directory to copy it to.
+ * @param options How to copy it.
+ * @param queue The queue to report to.
+ * @param threadCount The number of threads to use, or 0 to choose
+ * automatically.
+ * @param parent The parent object.
+ *
+ * The copy is not started until start() is called.
+ */
+LocalCopier::LocalCopier(QString source, QString destination, Options options, ProcessEventQueue & queue, int threadCount, QObject * parent)
+:   QObject(parent),
+    m_source(std::move(source)),
+    m_destination(std::move(destination)),
+    m_itemPrefix(),
+    m_options(options),
+    m_threadCount(0 < threadCount ? threadCount : std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, Detail::LocalCopier::MaximumThreads)),
+    m_timer(),
+    m_lock(),
+    m_workAvailable(),
+    m_pending(),
+    m_busy(0),
+    m_directories(),
+    m_queueLock(),
+    m_queue(queue),
+    m_backlog(),
+    m_lastProgress(0),
+    m_cancelled(false),
+    m_failed(false),
+    m_runningThreads(0),
+    m_totalItems(0),
+    m_doneItems(0),
+    m_copiedBytes(0),
+    m_stalled(false),
+    m_notifyPending(false),
+    m_threads()
+{
+}
+
+/**
+ * @brief Destroy the copier.
+ *
+ * If the copy is still in progress it is stopped. This blocks until the
+ * copying threads have stopped.
+ */
+LocalCopier::~LocalCopier()
+{
+    stop();
+
+    for(auto & thread : m_threads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Check whether the copier can be used at all on this platform.
+ *
+ * @return @b true if it can, @b false otherwise.
+ */
+bool LocalCopier::isAvailable()
+{
+#if defined(Q_OS_UNIX)
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Check whether the copier can do what rsync would do for a preset.
+ *
+ * @param preset The preset.
+ *
+ * The source must be a local directory and the destination must be local.
+ * The preset mustn't use any of the rsync features that the copier doesn't
+ * have: checksums, backups, hard links, devices, updating in place or
+ * appending, a log file, snapshots, a bandwidth limit or fan-out destinations.
+ *
+ * @return @b true if the copier can be used instead of rsync, @b false if
+ * rsync is needed.
+ */
+bool LocalCopier::canCopy(const Preset & preset)
+{
+    return isAvailable()
+        && ShardPlanner::canShard(preset.source())
+        && isLocalPath(preset.destination())
+        && preset.logFile().isEmpty()
+        && !preset.alwaysCompareChecksums()
+        && !preset.makeBackups()
+        && !preset.copyHardlinksAsHardlinks()
+        && !preset.preserveDevices()
+        && !preset.updateInPlace()
+        && !preset.appendVerify()
+        && !preset.snapshots()
+        && 0 == preset.bandwidthLimit()
+        && preset.bandwidthSchedule().isEmpty()
+        && !preset.adaptiveBandwidth()
+        && preset.fanOutDestinations().isEmpty();
+}
+
+/**
+ * @brief Work out how to copy for a preset.
+ *
+ * @param preset The preset.
+ *
+ * @return The options.
+ */
+LocalCopier::Options LocalCopier::optionsFor(const Preset & preset)
+{
+    Options ret;
+    ret.preserveTime = preset.preserveTime();
+    ret.preservePermissions = preset.preservePermissions();
+    ret.preserveOwner = preset.preserveOwner();
+    ret.preserveGroup = preset.preserveGroup();
+    ret.copySymlinksAsSymlinks = preset.copySymlinksAsSymlinks();
+    ret.honourDeletions = preset.honourDeletions();
+    ret.ignoreTimes = preset.ignoreTimes();
+    ret.onlyUpdateExistingEntries = preset.onlyUpdateExistingEntries();
+    ret.dontUpdateExistingEntries = preset.dontUpdateExistingEntries();
+    ret.modifyWindow = (preset.windowsCompatability() ? 1 : 0);
+    return ret;
+}
+
+/**
+ * @brief Start copying.
+ */
+void LocalCopier::start()
+{
+    Q_ASSERT_X(m_threads.empty(), __PRETTY_FUNCTION__, "the copier has already been started");
+    m_timer.start();
+
+    // laid out under the destination as rsync lays it out
+    QString prefix;
+    const auto base = filesFromBaseDirectory(m_source, prefix);
+    m_source = base + prefix;
+    m_destination = QDir(m_destination).absolutePath() + '/' + prefix;
+    m_itemPrefix = prefix;
+    static_cast<void>(Detail::LocalCopier::processUmask());
+
+    m_pending.push_back({QString(), true});
+    m_totalItems = 1;
+    m_runningThreads = m_threadCount;
+
+    for(int index = 0; index < m_threadCount; ++index) {
+        m_threads.emplace_back(&LocalCopier::run, this);
+    }
+}
+
+/**
+ * @brief Stop copying.
+ *
+ * The file each thread is copying is abandoned and the Finished event reports
+ * that the copy was interrupted. This does not wait for the threads to stop.
+ */
+void LocalCopier::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_cancelled = true;
+    }
+
+    m_workAvailable.notify_all();
+}
+
+/**
+ * @brief Add the events that didn't fit in the queue.
+ *
+ * The consumer calls this when it has made room, if isStalled() returns
+ * @b true.
+ */
+void LocalCopier::resume()
+{
+    std::lock_guard<std::mutex> lock(m_queueLock);
+
+    while(!m_backlog.empty() && m_queue.push(std::move(m_backlog.front()))) {
+        m_backlog.pop_front();
+    }
+
+    m_stalled.store(!m_backlog.empty(), std::memory_order_release);
+    notifyConsumer();
+}
+
+/**
+ * @brief A copying thread.
+ */
+void LocalCopier::run()
+{
+    std::vector<Task> tasks;
+    Copy copy;
+
+    while(true) {
+        Task task;
+
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+
+            // with nothing queued and nobody copying, no more work can appear
+            m_workAvailable.wait(lock, [this]() {
+                return m_cancelled || !m_pending.empty() || 0 == m_busy;
+            });
+
+            if(m_cancelled || m_pending.empty()) {
+                break;
+            }
+
+            task = std::move(m_pending.back());
+            m_pending.pop_back();
+            ++m_busy;
+        }
+
+        if(task.isDirectory) {
+            copyDirectory(task.path, tasks);
+        }
+        else {
+            copyFile(task.path, copy);
+        }
+
+        m_doneItems.fetch_add(1, std::memory_order_relaxed);
+
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            std::move(tasks.begin(), tasks.end(), std::back_inserter(m_pending));
+            --m_busy;
+        }
+
+        tasks.clear();
+        m_workAvailable.notify_all();
+    }
+
+    // the last thread out reports the result
+    if(1 == m_runningThreads.fetch_sub(1, std::memory_order_acq_rel)) {
+        finish();
+    }
+}
+
+/**
+ * @brief Create a directory in the destination and queue its content.
+ *
+ * @param path The path of the directory, relative to the source.
+ * @param tasks Receives the tasks for the directory's content.
+ */
+void LocalCopier::copyDirectory(const QString & path, std::vector<Task> & tasks)
+{
+#if defined(Q_OS_UNIX)
+    const auto source = QFile::encodeName(sourcePath(path));
+    const auto destination = QFile::encodeName(destinationPath(path));
+    struct stat sourceInfo = {};
+    struct stat destinationInfo = {};
+
+    if(0 != ::stat(source.constData(), &sourceInfo)) {
+        failed(sourcePath(path), "failed to read directory", errno);
+        return;
+    }
+
+    if(path.isEmpty() && !m_itemPrefix.isEmpty()) {
+        // the destination the source directory goes in is created if necessary, as rsync creates it
+        ::mkdir(QFile::encodeName(m_destination.left(m_destination.size() - m_itemPrefix.size())).constData(), 0777);
+    }
+
+    bool exists = (0 == ::lstat(destination.constData(), &destinationInfo));
+
+    if(exists && !S_ISDIR(destinationInfo.st_mode)) {
+        // rsync makes way for a directory whether or not it deletes
+        if(0 != ::unlink(destination.constData())) {
+            failed(destinationPath(path), "failed to replace with a directory", errno);
+            return;
+        }
+
+        exists = false;
+    }
+
+    if(!exists) {
+        if(m_options.onlyUpdateExistingEntries && !path.isEmpty()) {
+            return;
+        }
+
+        // writable until all its content is there, whatever the source's permissions
+        if(0 != ::mkdir(destination.constData(), (sourceInfo.st_mode & 0777) | S_IRWXU) && EEXIST != errno) {
+            failed(destinationPath(path), "failed to create directory", errno);
+            return;
+        }
+
+        if(m_options.preserveOwner || m_options.preserveGroup) {
+            // fails unless we are root, or a member of the group
+            [[maybe_unused]] const auto result = ::lchown(destination.constData(), (m_options.preserveOwner ? sourceInfo.st_uid : static_cast<uid_t>(-1)), (m_options.preserveGroup ? sourceInfo.st_gid : static_cast<gid_t>(-1)));
+        }
+
+        // rsync calls the source directory "./" when it copies its content
+        reportItem((path.isEmpty() ? (m_itemPrefix.isEmpty() ? QStringLiteral("./") : QString()) : path + '/'), 0);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_directories.push_back({destinationPath(path), static_cast<unsigned int>(sourceInfo.st_mode), modifiedTime(sourceInfo).tv_sec, modifiedTime(sourceInfo).tv_nsec});
+    }
+
+    auto * directory = ::opendir(source.constData());
+
+    if(!directory) {
+        failed(sourcePath(path), "failed to read directory", errno);
+        return;
+    }
+
+    std::set<QString> names;
+    const QString prefix = (path.isEmpty() ? QString() : path + '/');
+    int found = 0;
+    bool complete = true;
+
+    while(auto * entry = ::readdir(directory)) {
+        if(0 == std::strcmp(entry->d_name, ".") || 0 == std::strcmp(entry->d_name, "..")) {
+            continue;
+        }
+
+        if(m_cancelled.load(std::memory_order_relaxed)) {
+            complete = false;
+            break;
+        }
+
+        const auto name = QFile::decodeName(entry->d_name);
+        const auto childPath = prefix + name;
+        struct stat childInfo = {};
+
+        if(0 != ::lstat(QFile::encodeName(sourcePath(childPath)).constData(), &childInfo)) {
+            failed(sourcePath(childPath), "failed to read entry", errno);
+            complete = false;
+            continue;
+        }
+
+        if(S_ISDIR(childInfo.st_mode)) {
+            tasks.push_back({childPath, true});
+        }
+        else if(S_ISREG(childInfo.st_mode)) {
+            tasks.push_back({childPath, false});
+        }
+        else if(S_ISLNK(childInfo.st_mode) && m_options.copySymlinksAsSymlinks) {
+            // small enough to deal with here
+            QByteArray target(static_cast<int>(childInfo.st_size) + 1, '\0');
+            const auto length = ::readlink(QFile::encodeName(sourcePath(childPath)).constData(), target.data(), static_cast<std::size_t>(target.size()));
+            const auto link = QFile::encodeName(destinationPath(childPath));
+
+            if(0 > length) {
+                failed(sourcePath(childPath), "failed to read link", errno);
+            }
+            else {
+                target.truncate(static_cast<int>(length));
+                QByteArray existing(static_cast<int>(length) + 1, '\0');
+
+                if(length != ::readlink(link.constData(), existing.data(), static_cast<std::size_t>(existing.size())) || existing.left(static_cast<int>(length)) != target) {
+                    ::unlink(link.constData());
+
+                    if(0 != ::symlink(target.constData(), link.constData())) {
+                        failed(destinationPath(childPath), "failed to create link", errno);
+                    }
+                    else {
+                        reportItem(childPath, 0);
+                    }
+                }
+            }
+        }
+        else {
+            // like rsync, skip what it isn't asked to copy
+            continue;
+        }
+
+        names.insert(name);
+        ++found;
+    }
+
+    ::closedir(directory);
+    m_totalItems.fetch_add(found, std::memory_order_relaxed);
+
+    // an entry that's missing from names would have its copy deleted
+    if(!m_options.honourDeletions || !exists || !complete) {
+        return;
+    }
+
+    auto * existing = ::opendir(destination.constData());
+
+    if(!existing) {
+        failed(destinationPath(path), "failed to read directory", errno);
+        return;
+    }
+
+    std::vector<QString> extraneous;
+
+    while(auto * entry = ::readdir(existing)) {
+        if(0 != std::strcmp(entry->d_name, ".") && 0 != std::strcmp(entry->d_name, "..")) {
+            const auto name = QFile::decodeName(entry->d_name);
+
+            if(0 == names.count(name)) {
+                extraneous.push_back(prefix + name);
+            }
+        }
+    }
+
+    ::closedir(existing);
+
+    for(const auto & extraneousPath : extraneous) {
+        if(!removeExtraneous(extraneousPath)) {
+            break;
+        }
+    }
+#else
+    Q_UNUSED(path);
+    Q_UNUSED(tasks);
+#endif
+}
+
+/**
+ * @brief Copy a file to the destination, if it has changed.
+ *
+ * @param path The path of the file, relative to the source.
+ * @param copy The thread's way of copying.
+ */
+void LocalCopier::copyFile(const QString & path, Copy & copy)
+{
+#if defined(Q_OS_UNIX)
+    using namespace Detail::LocalCopier;
+    const auto destinationName = destinationPath(path);
+    const auto destination = QFile::encodeName(destinationName);
+    FileDescriptor from(::open(QFile::encodeName(sourcePath(path)).constData(), O_RDONLY | O_CLOEXEC));
+    struct stat sourceInfo = {};
+    struct stat destinationInfo = {};
+
+    if(0 > from.get() || 0 != ::fstat(from.get(), &sourceInfo)) {
+        failed(sourcePath(path), "failed to open file", errno);
+        return;
+    }
+
+    bool exists = (0 == ::lstat(destination.constData(), &destinationInfo));
+
+    if(exists ? m_options.dontUpdateExistingEntries : m_options.onlyUpdateExistingEntries) {
+        return;
+    }
+
+    if(exists && S_ISDIR(destinationInfo.st_mode)) {
+        // rsync only removes a directory to make way for a file if it deletes
+        if(!m_options.honourDeletions) {
+            failed(destinationName, "could not make way for new file", EISDIR);
+            return;
+        }
+
+        if(!removeExtraneous(path)) {
+            return;
+        }
+
+        exists = false;
+    }
+
+    const bool isRegular = exists && S_ISREG(destinationInfo.st_mode);
+    const auto mode = (m_options.preservePermissions ? sourceInfo.st_mode : (isRegular ? destinationInfo.st_mode : sourceInfo.st_mode & ~processUmask())) & 07777;
+
+    if(isRegular && !m_options.ignoreTimes && sourceInfo.st_size == destinationInfo.st_size && isSameTime(sourceInfo, destinationInfo, m_options.modifyWindow)) {
+        // up to date, but the attributes might not be
+        if(m_options.preservePermissions && (destinationInfo.st_mode & 07777) != mode) {
+            ::chmod(destination.constData(), mode);
+        }
+
+        return;
+    }
+
+    const auto size = static_cast<quint64>(sourceInfo.st_size);
+    reportItem(path, size);
+
+    // beside the file it replaces, so that renaming it is atomic
+    auto temporary = QFile::encodeName(QFileInfo(destinationName).absolutePath() + QStringLiteral("/.") + QFileInfo(destinationName).fileName() + QStringLiteral(".XXXXXX"));
+    FileDescriptor to(::mkstemp(temporary.data()));
+
+    if(0 > to.get()) {
+        failed(destinationName, "failed to create file", errno);
+        return;
+    }
+
+    quint64 reported = 0;
+
+    const bool copied = copy.transfer(from.get(), to.get(), size, [this, &reported, size](quint64 done) {
+        m_copiedBytes.fetch_add(done - reported, std::memory_order_relaxed);
+        reported = done;
+        reportProgress(done, size, false);
+        return !m_cancelled.load(std::memory_order_relaxed);
+    });
+
+    const auto error = errno;
+
+    if(!copied || m_cancelled) {
+        ::unlink(temporary.constData());
+
+        if(!m_cancelled) {
+            failed(destinationName, "failed to copy file", error);
+        }
+
+        return;
+    }
+
+    ::fchmod(to.get(), mode);
+
+    if(m_options.preserveOwner || m_options.preserveGroup) {
+        // fails unless we are root, or a member of the group
+        [[maybe_unused]] const auto result = ::fchown(to.get(), (m_options.preserveOwner ? sourceInfo.st_uid : static_cast<uid_t>(-1)), (m_options.preserveGroup ? sourceInfo.st_gid : static_cast<gid_t>(-1)));
+    }
+
+    if(m_options.preserveTime) {
+        const struct timespec times[2] = {{0, UTIME_OMIT}, modifiedTime(sourceInfo)};
+        ::futimens(to.get(), times);
+    }
+
+    if(!to.close() || 0 != ::rename(temporary.constData(), destination.constData())) {
+        failed(destinationName, "failed to write file", errno);
+        ::unlink(temporary.constData());
+        return;
+    }
+
+    reportProgress(size, size, true);
+#else
+    Q_UNUSED(path);
+    Q_UNUSED(copy);
+#endif
+}
+
+/**
+ * @brief Remove an entry from the destination that isn't in the source.
+ *
+ * @param path The path of the entry, relative to the destination.
+ *
+ * A directory is removed along with its content. Links are removed, not
+ * followed.
+ *
+ * @return @b true if the entry was removed, @b false if it wasn't or the copy
+ * has been stopped.
+ */
+bool LocalCopier::removeExtraneous(const QString & path)
+{
+#if defined(Q_OS_UNIX)
+    if(m_cancelled) {
+        return false;
+    }
+
+    const auto entry = QFile::encodeName(destinationPath(path));
+    struct stat info = {};
+
+    if(0 != ::lstat(entry.constData(), &info)) {
+        return ENOENT == errno;
+    }
+
+    if(!S_ISDIR(info.st_mode)) {
+        if(0 != ::unlink(entry.constData())) {
+            failed(destinationPath(path), "failed to delete", errno);
+            return false;
+        }
+
+        return true;
+    }
+
+    ::chmod(entry.constData(), (info.st_mode & 07777) | S_IRWXU);
+    auto * directory = ::opendir(entry.constData());
+
+    if(!directory) {
+        failed(destinationPath(path), "failed to read directory", errno);
+        return false;
+    }
+
+    std::vector<QString> children;
+
+    while(auto * child = ::readdir(directory)) {
+        if(0 != std::strcmp(child->d_name, ".") && 0 != std::strcmp(child->d_name, "..")) {
+            children.push_back(path + '/' + QFile::decodeName(child->d_name));
+        }
+    }
+
+    ::closedir(directory);
+
+    for(const auto & child : children) {
+        if(!removeExtraneous(child)) {
+            return false;
+        }
+    }
+
+    if(0 != ::rmdir(entry.constData())) {
+        failed(destinationPath(path), "failed to delete", errno);
+        return false;
+    }
+
+    return true;
+#else
+    Q_UNUSED(path);
+    return false;
+#endif
+}
+
+/**
+ * @brief Finish the copy once every thread has stopped.
+ *
+ * The directories get their permissions and modification times, now that
+ * nothing more will be created in them, and the Completed and Finished events
+ * are reported.
+ */
+void LocalCopier::finish()
+{
+    using namespace Detail::LocalCopier;
+
+#if defined(Q_OS_UNIX)
+    if(!m_cancelled) {
+        // deepest first, although setting a directory's attributes doesn't change its parent's time
+        for(auto it = m_directories.crbegin(); it != m_directories.crend(); ++it) {
+            const auto directory = QFile::encodeName(it->path);
+
+            if(m_options.preservePermissions) {
+                ::chmod(directory.constData(), it->mode & 07777);
+            }
+
+            if(m_options.preserveTime) {
+                const struct timespec times[2] = {{0, UTIME_OMIT}, {static_cast<time_t>(it->modifiedSeconds), it->modifiedNanoseconds}};
+                ::utimensat(AT_FDCWD, directory.constData(), times, 0);
+            }
+        }
+    }
+#endif
+
+    ProcessEvent completed;
+    completed.type = ProcessEvent::Type::Completed;
+    completed.bytesSent = m_copiedBytes.load(std::memory_order_relaxed);
+    completed.bytesPerSecond = bytesPerSecond();
+    enqueue(std::move(completed));
+
+    ProcessEvent finished;
+    finished.type = ProcessEvent::Type::Finished;
+    finished.exitCode = (m_cancelled ? InterruptReceived : (m_failed ? PartialTransferError : Success));
+    enqueue(std::move(finished));
+}
+
+/**
+ * @brief Note that an entry could not be copied.
+ *
+ * @param path The path of the entry.
+ * @param what What went wrong.
+ * @param error The error number.
+ *
+ * The copy carries on with the other entries, and finishes as rsync does when
+ * it has only been able to transfer some of the files.
+ */
+void LocalCopier::failed(const QString & path, const char * what, int error)
+{
+    qWarning() << __PRETTY_FUNCTION__ << what << path << ":" << std::strerror(error);
+    m_failed = true;
+}
+
+/**
+ * @brief Report that an entry is being copied.
+ *
+ * @param path The path of the entry, relative to the source.
+ * @param size The size of the entry.
+ *
+ * The path is reported as rsync would report it, i.e. including the source
+ * directory's name if it is being copied into the destination.
+ */
+void LocalCopier::reportItem(const QString & path, quint64 size)
+{
+    ProcessEvent event;
+    event.type = ProcessEvent::Type::NewItem;
+    event.itemPath = m_itemPrefix + path;
+    event.itemSize = size;
+    enqueue(std::move(event));
+}
+
+/**
+ * @brief Report the progress of a file being copied.
+ *
+ * @param itemBytes How much of it has been copied.
+ * @param itemSize Its size.
+ * @param force @b true to report it however recently progress was reported,
+ * @b false to report it only if it hasn't been for a while.
+ */
+void LocalCopier::reportProgress(quint64 itemBytes, quint64 itemSize, bool force)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queueLock);
+        const auto now = m_timer.elapsed();
+
+        if(!force && now - m_lastProgress < Detail::LocalCopier::ProgressInterval) {
+            return;
+        }
+
+        m_lastProgress = now;
+    }
+
+    const auto speed = bytesPerSecond();
+    const auto total = m_totalItems.load(std::memory_order_relaxed);
+
+    ProcessEvent event;
+    event.type = ProcessEvent::Type::Progress;
+    event.bytesPerSecond = speed;
+    event.secondsRemaining = (0.0 < speed ? static_cast<int>(static_cast<double>(itemSize - std::min(itemBytes, itemSize)) / speed) : 0);
+    event.hasCheckCounts = true;
+    event.totalItems = total;
+    event.itemsRemaining = std::max(0, total - m_doneItems.load(std::memory_order_relaxed));
+    event.itemBytes = itemBytes;
+    event.itemPercent = (0 == itemSize ? 100 : static_cast<int>(itemBytes * 100 / itemSize));
+    enqueue(std::move(event), true);
+}
+
+/**
+ * @brief Work out the speed of the whole copy so far.
+ *
+ * @return The speed, in bytes per second.
+ */
+double LocalCopier::bytesPerSecond() const
+{
+    const auto elapsed = m_timer.elapsed();
+    return (0 < elapsed ? static_cast<double>(m_copiedBytes.load(std::memory_order_relaxed)) * 1000.0 / static_cast<double>(elapsed) : 0.0);
+}
+
+/**
+ * @brief Add an event to the queue.
+ *
+ * @param event The event.
+ * @param droppable @b true if the event can be dropped when the queue is full,
+ * @b false if it must be kept until there is room.
+ *
+ * Events are always added in the order they are reported, so while any are
+ * waiting for room the new event waits behind them.
+ */
+void LocalCopier::enqueue(ProcessEvent && event, bool droppable)
+{
+    std::lock_guard<std::mutex> lock(m_queueLock);
+
+    if(m_backlog.empty() && m_queue.push(std::move(event))) {
+        notifyConsumer();
+        return;
+    }
+
+    if(!droppable) {
+        m_backlog.push_back(std::move(event));
+        m_stalled.store(true, std::memory_order_release);
+    }
+
+    // the consumer looks at isStalled() once it has emptied the queue
+    notifyConsumer();
+}
+
+/**
+ * @brief Tell the consumer there are events to dispatch, unless it already
+ * knows.
+ */
+void LocalCopier::notifyConsumer()
+{
+    if(!m_notifyPending.exchange(true, std::memory_order_acq_rel)) {
+        Q_EMIT eventsAvailable();
+    }
+}
+
+/**
+ * @brief Work out the path of an entry in the source.
+ *
+ * @param path The path of the entry, relative to the source.
+ *
+ * @return The path.
+ */
+QString LocalCopier::sourcePath(const QString & path) const
+{
+    return m_source + path;
+}
+
+/**
+ * @brief Work out the path of an entry in the destination.
+ *
+ * @param path The path of the entry, relative to the source.
+ *
+ * @return The path.
+ */
+QString LocalCopier::destinationPath(const QString & path) const
+{
+    return m_destination + path;
+}
+
+/**
+ * @fn LocalCopier::isStalled()
+ * @brief Check whether any events are waiting for room in the queue.
+ *
+ * @return @b true if the consumer should call resume(), @b false otherwise.
+ */
+
+/**
+ * @fn LocalCopier::acknowledgeEvents()
+ * @brief Note that the consumer is about to dispatch the events in the queue.
+ *
+ * eventsAvailable() is not emitted again until this has been called.
+ */
+
+/**
+ * @fn LocalCopier::eventsAvailable()
+ * @brief Emitted when there are events in the queue.
+ *
+ * This is emitted from one of the copying threads, so connections to it
+ * should be queued.
+ */
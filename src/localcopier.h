@@ -0,0 +1,143 @@
+/**
+ * @file localcopier.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the LocalCopier class.
+ */
+
+#ifndef QYNC_LOCALCOPIER_H
+#define QYNC_LOCALCOPIER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include "processworker.h"
+
+namespace Qync {
+
+	class Preset;
+
+	class LocalCopier
+	: public QObject {
+		Q_OBJECT
+
+	public:
+		struct Options {
+			bool preserveTime = false;
+			bool preservePermissions = false;
+			bool preserveOwner = false;
+			bool preserveGroup = false;
+			bool copySymlinksAsSymlinks = false;
+			bool honourDeletions = false;
+			bool ignoreTimes = false;
+			bool onlyUpdateExistingEntries = false;
+			bool dontUpdateExistingEntries = false;
+
+			// the difference in modification times, in seconds, that still counts as the same
+			int modifyWindow = 0;
+		};
+
+		LocalCopier(QString source, QString destination, Options options, ProcessEventQueue & queue, int threadCount = 0, QObject * parent = nullptr);
+		LocalCopier(const LocalCopier &) = delete;
+		LocalCopier(LocalCopier &&) = delete;
+		void operator=(const LocalCopier &) = delete;
+		void operator=(LocalCopier &&) = delete;
+		~LocalCopier() override;
+
+		[[nodiscard]] static bool isAvailable();
+		[[nodiscard]] static bool canCopy(const Preset & preset);
+		[[nodiscard]] static Options optionsFor(const Preset & preset);
+
+		[[nodiscard]] inline bool isStalled() const {
+			return m_stalled.load(std::memory_order_acquire);
+		}
+
+		inline void acknowledgeEvents() {
+			// read-modify-write so we synchronise with the producer's exchange() in notifyConsumer()
+			m_notifyPending.exchange(false, std::memory_order_acq_rel);
+		}
+
+	Q_SIGNALS:
+		void eventsAvailable();
+
+	public Q_SLOTS:
+		void start();
+		void stop();
+		void resume();
+
+	private:
+		struct Task {
+			// relative to the source and destination roots; empty for the roots themselves
+			QString path;
+			bool isDirectory = false;
+		};
+
+		struct DirectoryAttributes {
+			QString path;
+			unsigned int mode = 0;
+			qint64 modifiedSeconds = 0;
+			long modifiedNanoseconds = 0;
+		};
+
+		class Copy;
+
+		void run();
+		void copyDirectory(const QString & path, std::vector<Task> & tasks);
+		void copyFile(const QString & path, Copy & copy);
+		bool removeExtraneous(const QString & path);
+		void finish();
+		void failed(const QString & path, const char * what, int error);
+		void reportItem(const QString & path, quint64 size);
+		void reportProgress(quint64 itemBytes, quint64 itemSize, bool force);
+		double bytesPerSecond() const;
+		void enqueue(ProcessEvent && event, bool droppable = false);
+		void notifyConsumer();
+
+		[[nodiscard]] QString sourcePath(const QString & path) const;
+		[[nodiscard]] QString destinationPath(const QString & path) const;
+
+		QString m_source;
+		QString m_destination;
+		QString m_itemPrefix;
+		Options m_options;
+		int m_threadCount;
+		QElapsedTimer m_timer;
+
+		/* shared with the copying threads, guarded by m_lock */
+		std::mutex m_lock;
+		std::condition_variable m_workAvailable;
+		std::vector<Task> m_pending;
+		int m_busy;
+		std::vector<DirectoryAttributes> m_directories;
+
+		/* guarded by m_queueLock: the queue has one producer at a time */
+		std::mutex m_queueLock;
+		ProcessEventQueue & m_queue;
+		std::deque<ProcessEvent> m_backlog;
+		qint64 m_lastProgress;
+
+		std::atomic<bool> m_cancelled;
+		std::atomic<bool> m_failed;
+		std::atomic<int> m_runningThreads;
+		std::atomic<int> m_totalItems;
+		std::atomic<int> m_doneItems;
+		std::atomic<quint64> m_copiedBytes;
+		std::atomic<bool> m_stalled;
+		std::atomic<bool> m_notifyPending;
+
+		std::vector<std::thread> m_threads;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_LOCALCOPIER_H
@@ -0,0 +1,364 @@
+/**
+ * @file logfilewriter.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the LogFileWriter class.
+ */
+
+#include "logfilewriter.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::LogFileWriter class.
+ */
+namespace Qync::Detail::LogFileWriter {
+    // the writer thread is woken as soon as this much data is waiting
+    static constexpr const int FlushSize = 256 * 1024;
+
+    // ... or after this long, whichever comes first
+    static constexpr const std::chrono::milliseconds FlushInterval{1000};
+
+    // if the file system can't keep up, write() blocks once this much data is
+    // waiting rather than letting the memory used grow without limit
+    static constexpr const int MaximumPending = 16 * 1024 * 1024;
+
+    static inline bool isLineEnd(char ch)
+    {
+        return '\n' == ch || '\r' == ch;
+    }
+
+    // find one past the last line end in [begin, end), or nullptr if there isn't one
+    static const char * afterLastLineEnd(const char * begin, const char * end)
+    {
+        while(end != begin) {
+            if(isLineEnd(end[-1])) {
+                return end;
+            }
+
+            --end;
+        }
+
+        return nullptr;
+    }
+
+    // find one past the first line end in [begin, end), or end if there isn't one
+    static const char * afterFirstLineEnd(const char * begin, const char * end)
+    {
+        auto * lineEnd = std::find_if(begin, end, isLineEnd);
+        return (lineEnd == end ? end : lineEnd + 1);
+    }
+}  // namespace Qync::Detail::LogFileWriter
+
+/**
+ * @class LogFileWriter
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Writes rsync's output to a log file on a background thread.
+ *
+ * The writer accepts the raw bytes read from rsync and appends them to a
+ * buffer in memory. A background thread swaps the buffer out and writes it to
+ * the file whenever 256 KiB has accumulated, and at least once a second while
+ * there is anything waiting, so the thread that calls write() never waits for
+ * the file system (unless it has fallen 16 MiB behind, in which case write()
+ * blocks until it catches up). The data is written exactly as it was
+ * provided.
+ *
+ * If a rotation size is given, the log file is rotated when it would exceed
+ * that size: the current file is renamed with the suffix ".1", existing
+ * rotated files have their suffixes incremented and a new file is started.
+ * Rotated files beyond the rotation count are removed. Files are rotated at
+ * the end of a line wherever possible, so a line of output is not split
+ * between two files.
+ *
+ * All file operations, including opening and rotating, happen on the
+ * background thread. Failures are reported using qWarning(); once the file
+ * can't be written, further output is discarded.
+ *
+ * Call open() to start the background thread and close() (or destroy the
+ * writer) to write any remaining data and stop it. write() and close() must
+ * be called from the same thread.
+ */
+
+/**
+ * @brief Create a new log file writer.
+ *
+ * @param fileName The path to the log file.
+ * @param rotationSize The size in bytes at which to rotate the log file, or 0
+ * never to rotate it.
+ * @param rotationCount The number of rotated log files to keep.
+ *
+ * The file is not opened until open() is called.
+ */
+LogFileWriter::LogFileWriter(QString fileName, qint64 rotationSize, int rotationCount)
+:   m_fileName(std::move(fileName)),
+    m_rotationSize(std::max<qint64>(rotationSize, 0)),
+    m_rotationCount(std::max(rotationCount, 1)),
+    m_append(false),
+    m_fileSize(0),
+    m_lock(),
+    m_dataAvailable(),
+    m_spaceAvailable(),
+    m_pending(),
+    m_stopRequested(false),
+    m_thread()
+{
+}
+
+/**
+ * @brief Destroy the log file writer.
+ *
+ * Any data not yet written is written before the writer is destroyed.
+ */
+LogFileWriter::~LogFileWriter()
+{
+    close();
+}
+
+/**
+ * @brief Open the log file and start the background thread.
+ *
+ * The log file is truncated if it already exists, unless setAppend() has been
+ * used to ask for the output to be added to the end of it.
+ */
+void LogFileWriter::open()
+{
+    Q_ASSERT_X(!m_thread.joinable(), __PRETTY_FUNCTION__, "the log file writer is already open");
+    m_stopRequested = false;
+
+    // reserving also stops QByteArray from releasing the storage when it's cleared
+    m_pending.reserve(Detail::LogFileWriter::FlushSize * 2);
+    m_thread = std::thread(&LogFileWriter::run, this);
+}
+
+/**
+ * @brief Add some data to the log.
+ *
+ * @param data The data to write.
+ */
+void LogFileWriter::write(const QByteArray & data)
+{
+    Q_ASSERT_X(m_thread.joinable(), __PRETTY_FUNCTION__, "the log file writer is not open");
+
+    if(data.isEmpty()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    m_spaceAvailable.wait(lock, [this]() {
+        return Detail::LogFileWriter::MaximumPending > m_pending.size();
+    });
+
+    m_pending.append(data);
+
+    if(Detail::LogFileWriter::FlushSize <= m_pending.size()) {
+        lock.unlock();
+        m_dataAvailable.notify_one();
+    }
+}
+
+/**
+ * @brief Write any remaining data, close the log file and stop the background
+ * thread.
+ *
+ * This blocks until the data has been written.
+ */
+void LogFileWriter::close()
+{
+    if(!m_thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_stopRequested = true;
+    }
+
+    m_dataAvailable.notify_one();
+    m_thread.join();
+}
+
+/**
+ * @brief The background thread.
+ */
+void LogFileWriter::run()
+{
+    QFile file;
+    bool ok = openFile(file);
+    QByteArray buffer;
+    buffer.reserve(Detail::LogFileWriter::FlushSize * 2);
+
+    while(true) {
+        bool stop;
+
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+
+            m_dataAvailable.wait_for(lock, Detail::LogFileWriter::FlushInterval, [this]() {
+                return m_stopRequested || Detail::LogFileWriter::FlushSize <= m_pending.size();
+            });
+
+            // the producer gets our empty buffer, so neither side allocates
+            buffer.swap(m_pending);
+            stop = m_stopRequested;
+        }
+
+        m_spaceAvailable.notify_all();
+
+        if(ok && !buffer.isEmpty()) {
+            ok = writeToFile(file, buffer.constData(), buffer.size());
+        }
+
+        buffer.resize(0);
+
+        if(stop) {
+            break;
+        }
+    }
+
+    if(file.isOpen()) {
+        file.close();
+    }
+}
+
+/**
+ * @brief Open (and truncate, unless appending) the log file.
+ *
+ * @param file The file object to use.
+ *
+ * @return @b true if the file was opened, @b false otherwise.
+ */
+bool LogFileWriter::openFile(QFile & file)
+{
+    file.setFileName(m_fileName);
+    m_fileSize = 0;
+
+    // the data is already batched, so QFile's own buffer would just be an extra copy
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Unbuffered | (m_append ? QIODevice::Append : QIODevice::Truncate))) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to open log file" << m_fileName << ":" << file.errorString();
+        return false;
+    }
+
+    if(m_append) {
+        m_fileSize = file.size();
+    }
+
+    return true;
+}
+
+/**
+ * @brief Write data to the log file, rotating it as necessary.
+ *
+ * @param file The open log file.
+ * @param data The data to write.
+ * @param size The number of bytes to write.
+ *
+ * @return @b true if the data was written, @b false otherwise.
+ */
+bool LogFileWriter::writeToFile(QFile & file, const char * data, qint64 size)
+{
+    while(0 < size) {
+        qint64 chunkSize = size;
+
+        if(0 < m_rotationSize && m_fileSize + size > m_rotationSize) {
+            const char * budgetEnd = data + std::min(std::max<qint64>(m_rotationSize - m_fileSize, 0), size);
+            const char * split = Detail::LogFileWriter::afterLastLineEnd(data, budgetEnd);
+
+            if(!split) {
+                // no complete line fits: start a fresh file, unless this one is
+                // already empty, in which case the line has to go in it anyway
+                split = (0 < m_fileSize ? data : Detail::LogFileWriter::afterFirstLineEnd(budgetEnd, data + size));
+            }
+
+            chunkSize = split - data;
+        }
+
+        if(0 < chunkSize) {
+            if(chunkSize != file.write(data, chunkSize)) {
+                qWarning() << __PRETTY_FUNCTION__ << "failed to write to log file" << m_fileName << ":" << file.errorString();
+                return false;
+            }
+
+            m_fileSize += chunkSize;
+            data += chunkSize;
+            size -= chunkSize;
+        }
+
+        if(0 < size && !rotate(file)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Rotate the log file.
+ *
+ * @param file The open log file. On success it is the new, empty, log file.
+ *
+ * @return @b true if the log file was rotated, @b false if the new log file
+ * could not be opened.
+ */
+bool LogFileWriter::rotate(QFile & file)
+{
+    file.close();
+    auto rotatedName = [this](int index) -> QString {
+        return m_fileName + '.' + QString::number(index);
+    };
+
+    QFile::remove(rotatedName(m_rotationCount));
+
+    for(int index = m_rotationCount - 1; 0 < index; --index) {
+        if(QFile::exists(rotatedName(index))) {
+            QFile::rename(rotatedName(index), rotatedName(index + 1));
+        }
+    }
+
+    if(!QFile::rename(m_fileName, rotatedName(1))) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to rename log file" << m_fileName << "to" << rotatedName(1) << "; log file will be truncated";
+    }
+
+    return openFile(file);
+}
+
+/**
+ * @fn LogFileWriter::fileName()
+ * @brief Fetch the path to the log file.
+ *
+ * @return The path.
+ */
+
+/**
+ * @fn LogFileWriter::isOpen()
+ * @brief Check whether the writer has been opened.
+ *
+ * @return @b true if open() has been called and close() has not.
+ */
+
+/**
+ * @fn LogFileWriter::appends()
+ * @brief Check whether output is added to the end of an existing log file.
+ *
+ * @return @b true if the log file is appended to, @b false if it is truncated.
+ */
+
+/**
+ * @fn LogFileWriter::setAppend(bool)
+ * @brief Set whether output is added to the end of an existing log file.
+ *
+ * @param append @b true to append to the log file, @b false to truncate it.
+ *
+ * This must be called before open().
+ */
@@ -0,0 +1,79 @@
+/**
+ * @file logfilewriter.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the LogFileWriter class.
+ */
+
+#ifndef QYNC_LOGFILEWRITER_H
+#define QYNC_LOGFILEWRITER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+class QFile;
+
+namespace Qync {
+
+	class LogFileWriter final {
+	public:
+		explicit LogFileWriter(QString fileName, qint64 rotationSize = 0, int rotationCount = 5);
+		LogFileWriter(const LogFileWriter &) = delete;
+		LogFileWriter(LogFileWriter &&) = delete;
+		void operator=(const LogFileWriter &) = delete;
+		void operator=(LogFileWriter &&) = delete;
+		~LogFileWriter();
+
+		[[nodiscard]] inline const QString & fileName() const {
+			return m_fileName;
+		}
+
+		[[nodiscard]] inline bool appends() const {
+			return m_append;
+		}
+
+		inline void setAppend(bool append) {
+			m_append = append;
+		}
+
+		void open();
+		void write(const QByteArray & data);
+		void close();
+
+		[[nodiscard]] inline bool isOpen() const {
+			return m_thread.joinable();
+		}
+
+	private:
+		void run();
+		bool openFile(QFile & file);
+		bool writeToFile(QFile & file, const char * data, qint64 size);
+		bool rotate(QFile & file);
+
+		QString m_fileName;
+		qint64 m_rotationSize;
+		int m_rotationCount;
+		bool m_append;
+
+		/* only touched by the writer thread */
+		qint64 m_fileSize;
+
+		/* shared with the writer thread, guarded by m_lock */
+		std::mutex m_lock;
+		std::condition_variable m_dataAvailable;
+		std::condition_variable m_spaceAvailable;
+		QByteArray m_pending;
+		bool m_stopRequested;
+
+		std::thread m_thread;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_LOGFILEWRITER_H
@@ -10,17 +10,27 @@
  */
 
 #include "application.h"
+#include "cliapplication.h"
 
 /**
  * @brief The main entry point for the Qync application.
  *
  * This function instantiates a Qync::Application and initiates its
- * event loop.
+ * event loop. If the command line asks for presets to be run headless (e.g.
+ * qync --run <preset>), a Qync::CliApplication is used instead, so no widgets
+ * are created and no display is required.
  *
  * @return 0 on clean exit, non-0 otherwise.
  */
 int main(int argc, char ** argv) {
     using Qync::Application;
+    using Qync::CliApplication;
+
+	if(CliApplication::isHeadlessInvocation(argc, argv)) {
+		CliApplication app(argc, argv);
+		return app.run();
+	}
+
 	Application app(argc, argv);
 	return Application::exec();
 }
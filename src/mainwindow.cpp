@@ -31,11 +31,55 @@
 #include "preferencesdialogue.h"
 #include "synchronisewhatcombo.h"
 #include "aboutdialogue.h"
+#include "diagnosticsdialogue.h"
 #include "functions.h"
+#include "jobscheduler.h"
+#include "rsynccapabilities.h"
+#include "transferreportdialogue.h"
 #include "types.h"
 
 using namespace Qync;
 
+	/**
+	 * @brief Implementation details for the Qync::MainWindow class.
+	 */
+	namespace Qync::Detail::MainWindow {
+		// the simple UI's snapshots: the last two weeks, and a week apart for two months before that
+		static constexpr const int SimpleDailySnapshots = 14;
+		static constexpr const int SimpleWeeklySnapshots = 8;
+
+		// show an algorithm in a combo, even if rsync doesn't list it, so it isn't lost from the preset
+		static void selectAlgorithm(QComboBox & combo, const QString & algorithm)
+		{
+			auto index = combo.findData(algorithm);
+
+			if(-1 == index) {
+				combo.addItem(Qync::MainWindow::tr("%1 (not supported by rsync)").arg(algorithm), algorithm);
+				index = combo.count() - 1;
+			}
+
+			combo.setCurrentIndex(index);
+		}
+
+		// fill a combo with the algorithms rsync lists, keeping the current choice
+		static void listAlgorithms(QComboBox & combo, const QStringList & algorithms)
+		{
+			QSignalBlocker blocker(&combo);
+			const auto current = combo.currentData().toString();
+			combo.clear();
+			combo.addItem(Qync::MainWindow::tr("rsync's choice"), QString());
+
+			for(const auto & algorithm : algorithms) {
+				// choosing "none" is the same as turning the feature off, which has its own setting
+				if(QStringLiteral("none") != algorithm) {
+					combo.addItem(algorithm, algorithm);
+				}
+			}
+
+			selectAlgorithm(combo, current);
+		}
+	}  // namespace Qync::Detail::MainWindow
+
 	/**
 	 * @class MainWindow
 	 * @author Darren Edale
@@ -50,7 +94,8 @@ using namespace Qync;
 	 * - a full UI for greater control.
 	 *
 	 * The simple UI provides the user with the ability to specify what to back up,
-	 * where to back it up to, and whether to do an incremental or full backup.
+	 * where to back it up to, and whether to do an incremental or full backup or to
+	 * keep a dated snapshot of each backup.
 	 *
 	 * The full UI provides the user with many more options controlling how the rsync
 	 * process operates, as well as the ability to store and manipulate presets
@@ -82,7 +127,8 @@ using namespace Qync;
 	 * available in the GUI. The saveSettingsToCurrentPreset(), removeCurrentPreset()
 	 * and newPresetFromSettings() slots are invoked when the user clicks the respective
 	 * toolbar button or chooses the respective menu item. The import and export preset
-	 * menu items are connected to the importPreset() and exportPreset() slots; the
+	 * menu items are connected to the importPreset() and exportPreset() slots, and
+	 * those for bundles of presets to importPresetBundle() and exportAllPresets(); the
 	 * _simulate_ and _synchronise_ toolbar buttons and menu items are connected to the
 	 * simulate() and synchronise() slots, and the _about_ and _about rsync_ menu items
 	 * are connected to the about() and aboutRsync() slots. Finally, the preferences item
@@ -97,15 +143,24 @@ using namespace Qync;
 	:   QMainWindow(nullptr),
 	    m_ui(std::make_unique<Ui::MainWindow>()),
 	    m_prefsWindow(nullptr),
-	    m_aboutDialogue(nullptr)
+	    m_aboutDialogue(nullptr),
+	    m_reportDialogue(nullptr),
+	    m_diagnosticsDialogue(nullptr),
+	    m_runPreset(std::make_unique<Preset>()),
+	    m_lastProcess(),
+	    m_processDialogue()
     {
 		m_ui->setupUi(this);
 		m_ui->presetsToolbar->insertWidget(m_ui->actionNew, m_ui->presets);
+		// the icon is decoded as it's needed; the simple UI's logo is rendered when the simple UI is shown
 		QIcon appIcon(QStringLiteral(":/icons/application"));
-		m_ui->simpleLogo->setPixmap(appIcon.pixmap(64));
 		m_ui->simpleSourceAndDestination->setSourceLabel(tr("Backup"));
 		m_ui->simpleSourceAndDestination->setDestinationLabel(tr("To"));
 
+		// remote paths are listed by the same lister that checks the queued jobs
+		m_ui->sourceAndDestination->setRemoteLister(&qyncApp->jobScheduler().remoteLister());
+		m_ui->simpleSourceAndDestination->setRemoteLister(&qyncApp->jobScheduler().remoteLister());
+
 		QFont titleFont = m_ui->simpleUiTitle->font();
 		titleFont.setPointSizeF(titleFont.pointSizeF() * 1.5);
 		titleFont.setBold(true);
@@ -128,8 +183,11 @@ using namespace Qync;
 
 		connect(m_ui->actionAbout, &QAction::triggered, this, &MainWindow::about);
 		connect(m_ui->actionAboutRsync, &QAction::triggered, this, &MainWindow::aboutRsync);
+		connect(m_ui->actionDiagnostics, &QAction::triggered, this, &MainWindow::showDiagnostics);
 		connect(m_ui->actionExport, &QAction::triggered, this, &MainWindow::exportPreset);
 		connect(m_ui->actionImport, &QAction::triggered, this, &MainWindow::importPreset);
+		connect(m_ui->actionExportAll, &QAction::triggered, this, &MainWindow::exportAllPresets);
+		connect(m_ui->actionImportBundle, &QAction::triggered, this, &MainWindow::importPresetBundle);
 		connect(m_ui->actionNew, &QAction::triggered, this, &MainWindow::newPreset);
 		connect(m_ui->actionPreferences, &QAction::triggered, this, &MainWindow::showPreferences);
 		connect(m_ui->actionRemove, &QAction::triggered, this, &MainWindow::removeCurrentPreset);
@@ -137,9 +195,23 @@ using namespace Qync;
 		connect(m_ui->actionSaveAs, &QAction::triggered, this, &MainWindow::newPresetFromSettings);
 		connect(m_ui->actionSimulate, &QAction::triggered, this, &MainWindow::simulate);
 		connect(m_ui->actionSync, &QAction::triggered, this, &MainWindow::synchronise);
+		connect(m_ui->actionQueue, &QAction::triggered, this, &MainWindow::queueSynchronisation);
+		connect(m_ui->actionQueueAllPresets, &QAction::triggered, this, &MainWindow::queueAllPresets);
+		connect(m_ui->actionTransferReport, &QAction::triggered, this, &MainWindow::showTransferReport);
 
 		connect(m_ui->chooseLogFile, &QToolButton::clicked, this, &MainWindow::chooseLogFile);
+		connect(m_ui->compressInTransit, &QCheckBox::toggled, this, &MainWindow::updateCompressionWidgets);
 		connect(m_ui->preferences, &QToolButton::clicked, m_ui->actionPreferences, &QAction::trigger);
+
+		connect(m_ui->snapshots, &QCheckBox::toggled, this, [this](bool keep) {
+			m_ui->keepHourlySnapshots->setEnabled(keep);
+			m_ui->keepDailySnapshots->setEnabled(keep);
+			m_ui->keepWeeklySnapshots->setEnabled(keep);
+		});
+
+		connect(m_ui->shareSshConnections, &QCheckBox::toggled, m_ui->sshConnectionLifetime, &QSpinBox::setEnabled);
+		connect(m_ui->useRsyncDaemon, &QCheckBox::toggled, m_ui->rsyncDaemonPort, &QSpinBox::setEnabled);
+
 		connect(m_ui->quitButton, &QPushButton::clicked, this, &MainWindow::close);
 		connect(m_ui->synchroniseButton, &QPushButton::clicked, m_ui->actionSync, &QAction::trigger);
 		
@@ -148,14 +220,11 @@ using namespace Qync;
 
 		connectApplication();
 
-		m_prefsWindow = std::make_unique<PreferencesDialogue>();
-		m_prefsWindow->setWindowTitle(tr("%1 Preferences").arg(appDisplayName));
-
-		m_aboutDialogue = std::make_unique<AboutDialogue>();
-		m_aboutDialogue->setWindowTitle(tr("About %1").arg(appDisplayName));
+		// the other dialogues are created the first time they're shown, so they don't slow down startup
 
 		// force the UI to follow the preferences on startup
 		onPreferencesChanged();
+		onRsyncCapabilitiesChanged();
 
 		// ensure UI is in correct state for selected preset
 		if(!m_ui->presets->currentItemIsNewPreset()) {
@@ -213,7 +282,16 @@ using namespace Qync;
 		m_ui->windowsCompatible->setChecked(preset.windowsCompatability());
 		m_ui->honourDeletions->setChecked(preset.honourDeletions());
 
-		m_ui->simpleDoFullBackup->setChecked(preset.ignoreTimes());
+		if(preset.snapshots()) {
+			m_ui->simpleDoSnapshotBackup->setChecked(true);
+		}
+		else if(preset.ignoreTimes()) {
+			m_ui->simpleDoFullBackup->setChecked(true);
+		}
+		else {
+			m_ui->simpleDoIncrementalBackup->setChecked(true);
+		}
+
 		m_ui->alwaysCompareChecksums->setChecked(preset.alwaysCompareChecksums());
 		m_ui->preserveDevices->setChecked(preset.preserveDevices());
 		m_ui->keepPartialFiles->setChecked(preset.keepPartialTransfers());
@@ -245,8 +323,40 @@ using namespace Qync;
 		m_ui->sourceAndDestination->setDestination(preset.destination());
 		m_ui->simpleSourceAndDestination->setSource(preset.source());
 		m_ui->simpleSourceAndDestination->setDestination(preset.destination());
+		m_ui->sourceAndDestination->setRemoteTransport(preset);
+		m_ui->simpleSourceAndDestination->setRemoteTransport(preset);
 
 		m_ui->logFile->setText(preset.logFile());
+		m_ui->logRotationSize->setValue(preset.logRotationSize());
+		m_ui->shardCount->setValue(preset.shardCount());
+		m_ui->useSourceIndex->setChecked(preset.useSourceIndex());
+		m_ui->useLocalCopier->setChecked(preset.useLocalCopier());
+		m_ui->snapshots->setChecked(preset.snapshots());
+		m_ui->keepHourlySnapshots->setValue(preset.keepHourlySnapshots());
+		m_ui->keepDailySnapshots->setValue(preset.keepDailySnapshots());
+		m_ui->keepWeeklySnapshots->setValue(preset.keepWeeklySnapshots());
+
+		Detail::MainWindow::selectAlgorithm(*m_ui->compressionAlgorithm, preset.compressionAlgorithm());
+		m_ui->compressionLevel->setValue(preset.compressionLevel());
+		Detail::MainWindow::selectAlgorithm(*m_ui->checksumAlgorithm, preset.checksumAlgorithm());
+		m_ui->blockSize->setValue(preset.blockSize());
+		m_ui->bandwidthLimit->setValue(preset.bandwidthLimit());
+		m_ui->bandwidthSchedule->setText(preset.bandwidthSchedule());
+		m_ui->adaptiveBandwidth->setChecked(preset.adaptiveBandwidth());
+		m_ui->retryAttempts->setValue(preset.retryAttempts());
+		m_ui->retryDelay->setValue(preset.retryDelay());
+		m_ui->partialDirectory->setText(preset.partialDirectory());
+		m_ui->transferWholeFiles->setChecked(preset.transferWholeFiles());
+		m_ui->updateInPlace->setChecked(preset.updateInPlace());
+		m_ui->appendVerify->setChecked(preset.appendVerify());
+		m_ui->remoteShell->setText(preset.remoteShell());
+		m_ui->sshCipher->setText(preset.sshCipher());
+		m_ui->shareSshConnections->setChecked(preset.shareSshConnections());
+		m_ui->sshConnectionLifetime->setValue(preset.sshConnectionLifetime());
+		m_ui->useRsyncDaemon->setChecked(preset.useRsyncDaemon());
+		m_ui->rsyncDaemonPort->setValue(preset.rsyncDaemonPort());
+		m_ui->fanOutDestinations->setPlainText(preset.fanOutDestinations());
+		m_ui->fanOutConcurrency->setValue(preset.fanOutConcurrency());
 
 		m_ui->actionRemove->setEnabled(true);
 	}
@@ -262,12 +372,41 @@ using namespace Qync;
 		useSimpleUi(qyncApp->preferences().useSimpleUi());
 	}
 
+	/**
+	 * @brief Offer the transfer options the rsync binary supports.
+	 *
+	 * The algorithm combos list what Application::rsyncCapabilities() says rsync
+	 * supports, and the options rsync doesn't have are disabled. Until rsync has
+	 * been probed nothing is known to be supported. Settings a preset already has
+	 * are kept and shown even if they aren't supported.
+	 */
+	void MainWindow::onRsyncCapabilitiesChanged()
+	{
+		const auto & capabilities = qyncApp->rsyncCapabilities();
+		Detail::MainWindow::listAlgorithms(*m_ui->compressionAlgorithm, capabilities.compressionAlgorithms());
+		Detail::MainWindow::listAlgorithms(*m_ui->checksumAlgorithm, capabilities.checksumAlgorithms());
+		m_ui->checksumAlgorithm->setEnabled(capabilities.supportsChecksumChoice());
+		m_ui->appendVerify->setEnabled(capabilities.supportsAppendVerify());
+		updateCompressionWidgets();
+	}
+
+	/**
+	 * @brief Enable the compression settings only when compression is used.
+	 */
+	void MainWindow::updateCompressionWidgets()
+	{
+		const auto compress = m_ui->compressInTransit->isChecked();
+		m_ui->compressionAlgorithm->setEnabled(compress && qyncApp->rsyncCapabilities().supportsCompressionChoice());
+		m_ui->compressionLevel->setEnabled(compress);
+	}
+
 	/**
 	 * @brief Disconnect the application's signals from the window's slots.
 	 */
 	void MainWindow::disconnectApplication()
 	{
 		qyncApp->disconnect(this);
+		qyncApp->jobScheduler().disconnect(this);
 	}
 
 	/**
@@ -276,6 +415,23 @@ using namespace Qync;
 	void MainWindow::connectApplication()
 	{
 		connect(qyncApp, &Application::preferencesChanged, this, &MainWindow::onPreferencesChanged);
+		connect(qyncApp, &Application::rsyncCapabilitiesChanged, this, &MainWindow::onRsyncCapabilitiesChanged);
+		connect(&qyncApp->jobScheduler(), &JobScheduler::queueFinished, this, &MainWindow::onQueueFinished);
+
+		connect(&qyncApp->jobScheduler(), &JobScheduler::jobFinished, this, [this](JobScheduler::JobId id, Process::ExitCode code) {
+			const auto * job = qyncApp->jobScheduler().job(id);
+
+			if(!job || JobScheduler::JobState::Failed != job->state) {
+				return;
+			}
+
+			if(job->error.isEmpty()) {
+				showNotification(tr("%1 Warning").arg(qyncApp->applicationDisplayName()), tr("The queued synchronisation \"%1\" failed (rsync exit code %2).").arg(job->name).arg(static_cast<int>(code)), NotificationType::Warning);
+			}
+			else {
+				showNotification(tr("%1 Warning").arg(qyncApp->applicationDisplayName()), tr("The queued synchronisation \"%1\" failed: %2").arg(job->name, job->error), NotificationType::Warning);
+			}
+		});
 	}
 
 	/**
@@ -292,6 +448,10 @@ using namespace Qync;
 
 			m_ui->presetsToolbar->hide();
 			m_ui->synchroniseToolbar->hide();
+
+			// QIcon caches the rendered pixmap, so this only decodes the icon the first time
+			m_ui->simpleLogo->setPixmap(windowIcon().pixmap(64));
+
 			m_ui->mainStack->setCurrentWidget(m_ui->simpleUi);
 			m_ui->synchroniseButton->setText(tr("Backup"));
 			adjustSize();
@@ -353,7 +513,10 @@ using namespace Qync;
 
 		Preset & myPreset = m_ui->presets->currentPreset();
 		fillPreset(myPreset);
-		myPreset.save();
+
+		if(!qyncApp->savePreset(m_ui->presets->currentIndex())) {
+			showNotification(tr("%1 Warning").arg(qyncApp->applicationDisplayName()), tr("The preset could not be saved:\n\n%1").arg(qyncApp->lastError()), NotificationType::Warning);
+		}
 	}
 
 	/**
@@ -488,6 +651,58 @@ using namespace Qync;
 		}
 	}
 
+	/**
+	 * @brief Import all the presets in a bundle file.
+	 *
+	 * A file dialogue is presented for the user to choose a bundle previously
+	 * written by exportAllPresets(). The presets in it are added to the
+	 * application and the last of them is selected. Any failures, other than
+	 * the user cancelling the dialogue, are reported to the user.
+	 */
+	void MainWindow::importPresetBundle()
+	{
+		QString fileName = QFileDialog::getOpenFileName(this, tr("Import %1 preset bundle").arg(qyncApp->applicationDisplayName()));
+
+		if(fileName.isEmpty()) {
+			return;
+		}
+
+		int previousCount = m_ui->presets->count();
+		int imported = qyncApp->importPresetBundle(fileName);
+
+		if(m_ui->presets->count() > previousCount) {
+			m_ui->presets->setCurrentIndex(m_ui->presets->count() - 1);
+		}
+
+		if(0 > imported) {
+			showNotification(tr("%1 Warning").arg(qyncApp->applicationDisplayName()), tr("Not all the presets in \"%1\" could be imported:\n\n%2").arg(fileName, qyncApp->lastError()), NotificationType::Warning);
+			return;
+		}
+
+		showNotification(tr("%1 Information").arg(qyncApp->applicationDisplayName()), tr("%n preset(s) imported from \"%1\".", "", imported).arg(fileName), NotificationType::Information);
+	}
+
+	/**
+	 * @brief Export all the presets to a bundle file.
+	 *
+	 * A file dialogue is presented for the user to choose the file. The presets
+	 * are written as they are stored, not with the current settings. Any
+	 * failures, other than the user cancelling the dialogue, are reported to
+	 * the user.
+	 */
+	void MainWindow::exportAllPresets()
+	{
+		QString fileName = QFileDialog::getSaveFileName(this, tr("Export all %1 presets").arg(qyncApp->applicationDisplayName()));
+
+		if(fileName.isEmpty()) {
+			return;
+		}
+
+		if(!qyncApp->exportPresetBundle(fileName)) {
+			showNotification(tr("%1 Warning").arg(qyncApp->applicationDisplayName()), tr("The presets could not be exported:\n\n%1").arg(qyncApp->lastError()), NotificationType::Warning);
+		}
+	}
+
 	/**
 	 * @brief Fill a preset with the current settings.
 	 */
@@ -516,7 +731,15 @@ using namespace Qync;
 			p.setUseTransferCompression(true);
 			p.setWindowsCompatability(false);
 
-			if(m_ui->simpleDoFullBackup->isChecked()) {
+			if(m_ui->simpleDoSnapshotBackup->isChecked()) {
+				// a new snapshot starts empty, so the times are enough to find what to link
+				p.setAlwaysCompareChecksums(false);
+				p.setIgnoreTimes(false);
+				p.setSnapshots(true);
+				p.setKeepDailySnapshots(Detail::MainWindow::SimpleDailySnapshots);
+				p.setKeepWeeklySnapshots(Detail::MainWindow::SimpleWeeklySnapshots);
+			}
+			else if(m_ui->simpleDoFullBackup->isChecked()) {
 				p.setAlwaysCompareChecksums(false);
 				p.setIgnoreTimes(true);
 			}
@@ -568,9 +791,81 @@ using namespace Qync;
 			p.setDestination(m_ui->sourceAndDestination->destination());
 
 			p.setLogFile(m_ui->logFile->text());
+			p.setLogRotationSize(m_ui->logRotationSize->value());
+			p.setShardCount(m_ui->shardCount->value());
+			p.setUseSourceIndex(m_ui->useSourceIndex->isChecked());
+			p.setUseLocalCopier(m_ui->useLocalCopier->isChecked());
+			p.setSnapshots(m_ui->snapshots->isChecked());
+			p.setKeepHourlySnapshots(m_ui->keepHourlySnapshots->value());
+			p.setKeepDailySnapshots(m_ui->keepDailySnapshots->value());
+			p.setKeepWeeklySnapshots(m_ui->keepWeeklySnapshots->value());
+
+			p.setCompressionAlgorithm(m_ui->compressionAlgorithm->currentData().toString());
+			p.setCompressionLevel(m_ui->compressionLevel->value());
+			p.setChecksumAlgorithm(m_ui->checksumAlgorithm->currentData().toString());
+			p.setBlockSize(m_ui->blockSize->value());
+			p.setBandwidthLimit(m_ui->bandwidthLimit->value());
+
+			if(!p.setBandwidthSchedule(m_ui->bandwidthSchedule->text().trimmed())) {
+				qWarning() << __PRETTY_FUNCTION__ << "ignoring invalid bandwidth schedule" << m_ui->bandwidthSchedule->text();
+			}
+
+			p.setAdaptiveBandwidth(m_ui->adaptiveBandwidth->isChecked());
+			p.setRetryAttempts(m_ui->retryAttempts->value());
+			p.setRetryDelay(m_ui->retryDelay->value());
+			p.setPartialDirectory(m_ui->partialDirectory->text().trimmed());
+			p.setTransferWholeFiles(m_ui->transferWholeFiles->isChecked());
+			p.setUpdateInPlace(m_ui->updateInPlace->isChecked());
+			p.setAppendVerify(m_ui->appendVerify->isChecked());
+			p.setRemoteShell(m_ui->remoteShell->text().trimmed());
+
+			if(!p.setSshCipher(m_ui->sshCipher->text().trimmed())) {
+				qWarning() << __PRETTY_FUNCTION__ << "ignoring invalid ssh cipher" << m_ui->sshCipher->text();
+			}
+
+			p.setShareSshConnections(m_ui->shareSshConnections->isChecked());
+			p.setSshConnectionLifetime(m_ui->sshConnectionLifetime->value());
+			p.setUseRsyncDaemon(m_ui->useRsyncDaemon->isChecked());
+			p.setRsyncDaemonPort(m_ui->rsyncDaemonPort->value());
+			p.setFanOutDestinations(m_ui->fanOutDestinations->toPlainText());
+			p.setFanOutConcurrency(m_ui->fanOutConcurrency->value());
 		}
 	}
 
+	/**
+	 * @brief Fetch a process to run the current settings.
+	 *
+	 * @param dryRun @b true for a simulation, @b false for a synchronisation. A
+	 * synchronisation is run in parallel if the settings ask for more than one
+	 * rsync process.
+	 *
+	 * The current settings are copied into m_runPreset, which only changes its
+	 * revision if the settings have changed. If the last process that was run is
+	 * of the same type and has finished, it is rearmed to run them again, so its
+	 * rsync arguments are only rebuilt if the settings have changed and the
+	 * widgets showing its progress stay connected to it. Otherwise a new process
+	 * is created.
+	 *
+	 * @return The process, ready to start.
+	 */
+	std::shared_ptr<Process> MainWindow::processForCurrentSettings(bool dryRun)
+	{
+		Preset preset;
+		fillPreset(preset);
+		m_runPreset->assignSettings(preset);
+		const auto & prefs = qyncApp->preferences();
+		const auto type = (dryRun ? Process::RunType::DryRun : (1 < m_runPreset->shardCount() ? Process::RunType::Parallel : Process::RunType::Normal));
+
+		if(!m_lastProcess || m_lastProcess->runType() != type || m_lastProcess->command() != prefs.rsyncPath() || !m_lastProcess->rearm(*m_runPreset)) {
+			m_lastProcess = std::make_shared<Process>(prefs.rsyncPath(), *m_runPreset, type);
+		}
+
+		m_lastProcess->setUseWorkerThread(prefs.useWorkerThread());
+		m_lastProcess->setScanSource(prefs.scanSources());
+		m_lastProcess->setOutputFormat(qyncApp->rsyncOutputFormat());
+		return m_lastProcess;
+	}
+
 	/**
 	 * @brief Helper for synchronise() and simulate().
 	 *
@@ -581,6 +876,9 @@ using namespace Qync;
 	 * that is identical save for the details of the process to run. This helper saves
 	 * repeating this common code.
 	 *
+	 * If the process is being run again and the dialogue showing its last run is
+	 * still open, the same dialogue shows the new run.
+	 *
 	 * @return @b true if the Process was started, @b false otherwise.
 	 */
 	bool MainWindow::runProcess(std::shared_ptr<Process> & process)
@@ -589,26 +887,28 @@ using namespace Qync;
 			// while simple backup in process, prevent any other being started
 			m_ui->simpleDoFullBackup->setEnabled(false);
 			m_ui->simpleDoIncrementalBackup->setEnabled(false);
+			m_ui->simpleDoSnapshotBackup->setEnabled(false);
 			m_ui->simpleSourceAndDestination->setEnabled(false);
 			m_ui->synchroniseButton->setEnabled(false);
 
-			// re-enable the UI when the process has finished
-			connect(process.get(), static_cast<void (Process::*)(Process::ExitCode)>(&Process::finished), [this]() {
-				m_ui->simpleDoFullBackup->setEnabled(true);
-				m_ui->simpleDoIncrementalBackup->setEnabled(true);
-				m_ui->simpleSourceAndDestination->setEnabled(true);
-				m_ui->synchroniseButton->setEnabled(true);
-			});
+			// re-enable the UI when the process has finished. a rearmed process is
+			// already connected
+			connect(process.get(), qOverload<Process::ExitCode>(&Process::finished), this, &MainWindow::onSimpleProcessFinished, Qt::UniqueConnection);
 
 			// widget shares ownership of the process
 			m_ui->simpleProcessWidget->setProcess(process);
 		}
+		else if(m_processDialogue && m_processDialogue->process() == process.get()) {
+			m_processDialogue->setProcess(process);
+			m_processDialogue->raise();
+			m_processDialogue->activateWindow();
+		}
 		else {
 			// dialogue shares ownership of the process
 			// dialogue deletes itself on closure
 			auto * dlg = new ProcessDialogue(process, this);
 
-			QString presetName = m_ui->presets->currentText();
+			QString presetName = m_ui->presets->currentItemIsNewPreset() ? QString() : m_ui->presets->currentPreset().name();
 
 			if (!presetName.isEmpty()) {
                 dlg->setWindowTitle(tr("%1 %2: %3").arg(qyncApp->applicationDisplayName(),
@@ -620,6 +920,7 @@ using namespace Qync;
 			}
 
 			connect(dlg, &ProcessDialogue::finished, dlg, &ProcessDialogue::deleteLater);
+			m_processDialogue = dlg;
             dlg->show();
 		}
 
@@ -627,6 +928,18 @@ using namespace Qync;
 		return true;
 	}
 
+	/**
+	 * @brief Re-enable the simple UI when its process has finished.
+	 */
+	void MainWindow::onSimpleProcessFinished()
+	{
+		m_ui->simpleDoFullBackup->setEnabled(true);
+		m_ui->simpleDoIncrementalBackup->setEnabled(true);
+		m_ui->simpleDoSnapshotBackup->setEnabled(true);
+		m_ui->simpleSourceAndDestination->setEnabled(true);
+		m_ui->synchroniseButton->setEnabled(true);
+	}
+
 	/**
 	 * @brief Start a simulation based on the current settings.
 	 *
@@ -637,9 +950,7 @@ using namespace Qync;
 	 */
 	void MainWindow::simulate()
 	{
-		Preset preset;
-		fillPreset(preset);
-		auto process = std::make_shared<Process>(preset, Process::RunType::DryRun);
+		auto process = processForCurrentSettings(true);
 
 		if(!runProcess(process)) {
 			showNotification(tr("%1 Warning").arg(qyncApp->applicationDisplayName()), "The simulation failed:\n\n" + qyncApp->lastError());
@@ -650,34 +961,131 @@ using namespace Qync;
 	 * @brief Start a synchronisation based on the current settings.
 	 *
 	 * The current settings are used to create a Process object that will
-	 * execute the synchronisation.
+	 * execute the synchronisation. If the settings ask for more than one rsync
+	 * process, the synchronisation is run in parallel.
 	 */
 	void MainWindow::synchronise()
 	{
-		Preset preset;
-		fillPreset(preset);
-		auto process = std::make_shared<Process>(preset);
+		auto process = processForCurrentSettings(false);
 
 		if(!runProcess(process)) {
 			showNotification(tr("%1 Warning").arg(qyncApp->applicationDisplayName()), "The synchronisation failed:\n\n" + qyncApp->lastError());
 		}
 	}
 
+	/**
+	 * @brief Queue a synchronisation based on the current settings.
+	 *
+	 * The synchronisation is run by the application's JobScheduler when it
+	 * reaches the front of the queue. Its progress is not shown; a
+	 * notification is shown when the queue has finished.
+	 */
+	void MainWindow::queueSynchronisation()
+	{
+		Preset preset;
+		fillPreset(preset);
+		QString name = m_ui->presets->currentItemIsNewPreset() ? QString() : m_ui->presets->currentPreset().name();
+
+		if(!name.isEmpty()) {
+			preset.setName(name);
+		}
+
+		qyncApp->jobScheduler().enqueue(preset, (1 < preset.shardCount() ? Process::RunType::Parallel : Process::RunType::Normal));
+	}
+
+	/**
+	 * @brief Queue a synchronisation for each of the application's presets.
+	 *
+	 * The presets are run as they are stored, not with the current settings.
+	 */
+	void MainWindow::queueAllPresets()
+	{
+		auto & scheduler = qyncApp->jobScheduler();
+
+		for(int index = 0; index < qyncApp->presetCount(); ++index) {
+			const auto & preset = qyncApp->preset(index);
+			scheduler.enqueue(preset, (1 < preset.shardCount() ? Process::RunType::Parallel : Process::RunType::Normal));
+		}
+	}
+
+	/**
+	 * @brief Summarise the results of the queued synchronisations.
+	 *
+	 * The finished jobs are then forgotten, so that the next summary only
+	 * covers jobs queued after this one.
+	 */
+	void MainWindow::onQueueFinished()
+	{
+		auto & scheduler = qyncApp->jobScheduler();
+		int succeeded = 0;
+		int unsuccessful = 0;
+
+		for(const auto & job : scheduler.jobs()) {
+			if(JobScheduler::JobState::Succeeded == job.state) {
+				++succeeded;
+			}
+			else {
+				++unsuccessful;
+			}
+		}
+
+		auto message = tr("%1 of %2 queued synchronisations succeeded. %3 MiB was transferred at %4 MiB/s.")
+		  .arg(succeeded)
+		  .arg(succeeded + unsuccessful)
+		  .arg(static_cast<double>(scheduler.totalBytes()) / (1024.0 * 1024.0), 0, 'f', 1)
+		  .arg(scheduler.throughput() / (1024.0 * 1024.0), 0, 'f', 1);
+
+		showNotification(tr("Queue finished"), message, (0 == unsuccessful ? NotificationType::Information : NotificationType::Warning));
+		scheduler.clearFinished();
+	}
+
 	/**
 	 * @brief Show the preferences dialogue.
 	 */
 	void MainWindow::showPreferences()
 	{
+		if(!m_prefsWindow) {
+			m_prefsWindow = std::make_unique<PreferencesDialogue>();
+			m_prefsWindow->setWindowTitle(tr("%1 Preferences").arg(qyncApp->applicationDisplayName()));
+		}
+
 		m_prefsWindow->show();
 		m_prefsWindow->raise();
 		m_prefsWindow->activateWindow();
 	}
 
+	/**
+	 * @brief Show the transfer report for the current settings.
+	 *
+	 * The report covers the recorded synchronisations of the source and
+	 * destination currently shown, whether or not they are those of a saved
+	 * preset.
+	 */
+	void MainWindow::showTransferReport()
+	{
+		if(!m_reportDialogue) {
+			m_reportDialogue = std::make_unique<TransferReportDialogue>();
+			m_reportDialogue->setWindowTitle(tr("%1 Transfer Report").arg(qyncApp->applicationDisplayName()));
+		}
+
+		Preset preset;
+		fillPreset(preset);
+		m_reportDialogue->showReport(preset.source(), preset.destination());
+		m_reportDialogue->show();
+		m_reportDialogue->raise();
+		m_reportDialogue->activateWindow();
+	}
+
 	/**
 	 * @brief Show the about Qync dialogue.
 	 */
 	void MainWindow::about()
 	{
+		if(!m_aboutDialogue) {
+			m_aboutDialogue = std::make_unique<AboutDialogue>();
+			m_aboutDialogue->setWindowTitle(tr("About %1").arg(qyncApp->applicationDisplayName()));
+		}
+
 		m_aboutDialogue->show();
 		m_aboutDialogue->raise();
 		m_aboutDialogue->activateWindow();
@@ -692,3 +1100,21 @@ using namespace Qync;
 	{
 		QMessageBox::information(this, tr("Qync - About rsync"), qyncApp->rsyncVersionText());
 	}
+
+	/**
+	 * @brief Show the measurements of Qync's own performance.
+	 *
+	 * Nothing is measured unless performance diagnostics have been turned on in
+	 * the preferences.
+	 */
+	void MainWindow::showDiagnostics()
+	{
+		if(!m_diagnosticsDialogue) {
+			m_diagnosticsDialogue = std::make_unique<DiagnosticsDialogue>();
+			m_diagnosticsDialogue->setWindowTitle(tr("%1 Diagnostics").arg(qyncApp->applicationDisplayName()));
+		}
+
+		m_diagnosticsDialogue->show();
+		m_diagnosticsDialogue->raise();
+		m_diagnosticsDialogue->activateWindow();
+	}
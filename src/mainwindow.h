@@ -12,6 +12,7 @@
 
 #include <memory>
 
+#include <QtCore/QPointer>
 #include <QtWidgets/QMainWindow>
 
 #include "types.h"
@@ -26,7 +27,10 @@ namespace Qync {
 	class Preset;
 	class PreferencesDialogue;
 	class AboutDialogue;
+	class DiagnosticsDialogue;
+	class TransferReportDialogue;
 	class Process;
+	class ProcessDialogue;
 
 	class MainWindow
 	: public QMainWindow {
@@ -48,6 +52,8 @@ namespace Qync {
 		void newPreset(bool fill = false);
 		void importPreset();
 		void exportPreset();
+		void importPresetBundle();
+		void exportAllPresets();
 
 		void chooseLogFile();
 
@@ -56,13 +62,21 @@ namespace Qync {
 
 		void simulate();
 		void synchronise();
+		void queueSynchronisation();
+		void queueAllPresets();
+		void showTransferReport();
 
 		void about();
 		void aboutRsync();
+		void showDiagnostics();
 
 	private Q_SLOTS:
 		void showPreset(const Preset &);
 		void onPreferencesChanged();
+		void onQueueFinished();
+		void onSimpleProcessFinished();
+		void onRsyncCapabilitiesChanged();
+		void updateCompressionWidgets();
 
 	protected:
 		void disconnectApplication();
@@ -70,11 +84,19 @@ namespace Qync {
 
 	private:
 		void fillPreset(Preset &) const;
+		[[nodiscard]] std::shared_ptr<Process> processForCurrentSettings(bool dryRun);
 		bool runProcess(std::shared_ptr<Process> &);
 
 		std::unique_ptr<Ui::MainWindow> m_ui;
 		std::unique_ptr<PreferencesDialogue> m_prefsWindow;
 		std::unique_ptr<AboutDialogue> m_aboutDialogue;
+		std::unique_ptr<TransferReportDialogue> m_reportDialogue;
+		std::unique_ptr<DiagnosticsDialogue> m_diagnosticsDialogue;
+
+		// the settings last run, and the process that ran them, for repeat runs
+		std::unique_ptr<Preset> m_runPreset;
+		std::shared_ptr<Process> m_lastProcess;
+		QPointer<ProcessDialogue> m_processDialogue;
 	};
 
 }  // namespace Qync
@@ -0,0 +1,306 @@
+/**
+ * @file pathcompleter.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the PathCompleter class.
+ */
+
+#include "pathcompleter.h"
+
+#include <algorithm>
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QDir>
+#include <QtCore/QStringBuilder>
+#include <QtWidgets/QAbstractItemView>
+#include <QtWidgets/QLineEdit>
+
+#include "functions.h"
+#include "preset.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::PathCompleter class.
+ */
+namespace Qync::Detail::PathCompleter {
+    // the entries in one directory, as full paths. only the names are stored;
+    // the paths are built as the completer asks for them
+    class EntryModel
+    : public QAbstractListModel {
+    public:
+        using QAbstractListModel::QAbstractListModel;
+
+        int rowCount(const QModelIndex & parent = {}) const override
+        {
+            return (parent.isValid() ? 0 : m_names.size());
+        }
+
+        QVariant data(const QModelIndex & index, int role) const override
+        {
+            if(!index.isValid() || index.row() >= m_names.size() || (Qt::DisplayRole != role && Qt::EditRole != role)) {
+                return {};
+            }
+
+            return QString(m_directory % m_names.at(index.row()));
+        }
+
+        void reset(const QString & directory)
+        {
+            beginResetModel();
+            m_directory = directory;
+            m_names.clear();
+            endResetModel();
+        }
+
+        void append(const QStringList & names)
+        {
+            if(names.isEmpty()) {
+                return;
+            }
+
+            beginInsertRows({}, m_names.size(), m_names.size() + names.size() - 1);
+            m_names.append(names);
+            endInsertRows();
+        }
+
+    private:
+        QString m_directory;
+        QStringList m_names;
+    };
+}  // namespace Qync::Detail::PathCompleter
+
+/**
+ * @class PathCompleter
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Completes local paths in a line edit without blocking while
+ * directories are read.
+ *
+ * When the user types or edits the path in the line edit, the directory it is
+ * in (everything up to the last '/') is listed by a DirectoryLister, and the
+ * entries in it are offered as completions as they arrive. The popup appears
+ * with the first batch and fills in as the rest are read, so typing carries
+ * on while a slow mount or a very large directory is read. Moving to another
+ * directory abandons the listing of the previous one.
+ *
+ * Only absolute local paths are completed, unless the completer is given a
+ * RemoteLister with setRemoteLister(), in which case remote paths are too.
+ * The directory a remote path is in is everything up to the last '/' after
+ * the host (or, for a daemon, the module), or the host's home directory if
+ * there is none; completing just the host of a daemon lists its modules.
+ * Directories are offered with a trailing '/', so choosing one goes on to
+ * complete the entries in it.
+ */
+
+/**
+ * @brief Create a new completer for a line edit.
+ *
+ * @param lister The lister that reads the directories. It can be shared with
+ * other completers, and must outlive this one.
+ * @param lineEdit The line edit. It takes ownership of the completer.
+ */
+PathCompleter::PathCompleter(DirectoryLister & lister, QLineEdit * lineEdit)
+:   QCompleter(lineEdit),
+    m_lister(lister),
+    m_lineEdit(lineEdit),
+    m_remoteLister(nullptr),
+    m_transport(nullptr),
+    m_entries(new Detail::PathCompleter::EntryModel(this)),
+    m_directory(),
+    m_request(DirectoryLister::NoRequest),
+    m_remote(false),
+    m_listed(false)
+{
+    setModel(m_entries);
+    setCaseSensitivity(Qt::CaseInsensitive);
+    setCompletionMode(QCompleter::PopupCompletion);
+    setModelSorting(QCompleter::UnsortedModel);
+    m_lineEdit->setCompleter(this);
+
+    connect(m_lineEdit, &QLineEdit::textEdited, this, &PathCompleter::listDirectoryFor);
+    connect(&m_lister, &DirectoryLister::entriesListed, this, &PathCompleter::appendEntries);
+    connect(&m_lister, &DirectoryLister::listingFinished, this, &PathCompleter::finishEntries);
+}
+
+/**
+ * @brief Destroy the completer.
+ */
+PathCompleter::~PathCompleter() = default;
+
+/**
+ * @brief Complete remote paths as well as local ones.
+ *
+ * @param lister The lister to list remote directories with, or @b nullptr to
+ * complete only local paths. It must outlive the completer, or be unset first.
+ * @param transport The preset whose transport settings are used to reach the
+ * hosts. It must outlive the completer, or be unset first.
+ */
+void PathCompleter::setRemoteLister(RemoteLister * lister, const Preset * transport)
+{
+    if(m_remoteLister) {
+        m_remoteLister->disconnect(this);
+    }
+
+    if(m_remote) {
+        resetEntries({});
+    }
+
+    m_remoteLister = (transport ? lister : nullptr);
+    m_transport = (lister ? transport : nullptr);
+
+    if(m_remoteLister) {
+        connect(m_remoteLister, &RemoteLister::entriesListed, this, &PathCompleter::appendRemoteEntries);
+        connect(m_remoteLister, &RemoteLister::listingFinished, this, &PathCompleter::finishRemoteEntries);
+    }
+}
+
+/**
+ * @brief Start listing the directory a path is in, if it's not already
+ * listed.
+ *
+ * @param path The path the user has typed.
+ *
+ * A local directory is listed again if its listing was abandoned, e.g.
+ * because another completer sharing the lister has asked for a listing since.
+ */
+void PathCompleter::listDirectoryFor(const QString & path)
+{
+    QString directory;
+    const auto remote = (m_remoteLister && RemoteLister::isRemote(path));
+
+    if(remote) {
+        // everything up to here is the host, or the host and the module
+        int root;
+
+        if(path.startsWith(QStringLiteral("rsync://"))) {
+            root = path.indexOf('/', 8);
+        }
+        else if(const auto colon = path.indexOf(QStringLiteral("::")); 0 < colon) {
+            root = colon + 1;
+        }
+        else {
+            root = path.indexOf(':');
+        }
+
+        if(0 < root) {
+            directory = path.left(std::max(path.lastIndexOf('/'), root) + 1);
+        }
+    }
+    else if(isLocalPath(path) && QDir::isAbsolutePath(path)) {
+        directory = path.left(path.lastIndexOf('/') + 1);
+    }
+
+    if(directory.isEmpty()) {
+        if(!m_directory.isEmpty()) {
+            resetEntries({});
+        }
+
+        return;
+    }
+
+    if(directory == m_directory && remote == m_remote && (m_listed || m_remote || m_request == m_lister.currentRequest())) {
+        return;
+    }
+
+    resetEntries(directory);
+    m_remote = remote;
+    m_request = (remote ? m_remoteLister->list(*m_transport, directory) : m_lister.list(directory));
+}
+
+/**
+ * @brief Offer the next batch of entries in the directory.
+ *
+ * @param request The request the entries are for.
+ * @param entries The names of the entries.
+ *
+ * Entries from requests other than the latest one are ignored, since the user
+ * has moved on to another directory or another line edit.
+ */
+void PathCompleter::appendEntries(DirectoryLister::RequestId request, const QStringList & entries)
+{
+    if(m_remote || request != m_request) {
+        return;
+    }
+
+    m_entries->append(entries);
+
+    // the popup closes when nothing matches, which is the case until the first entries arrive
+    if(m_lineEdit->hasFocus() && !popup()->isVisible() && m_lineEdit->text().startsWith(m_directory)) {
+        complete();
+    }
+}
+
+/**
+ * @brief Note that all the entries in the directory have been offered.
+ *
+ * @param request The request that has finished.
+ */
+void PathCompleter::finishEntries(DirectoryLister::RequestId request)
+{
+    if(!m_remote && request == m_request) {
+        m_listed = true;
+    }
+}
+
+/**
+ * @brief Offer the next batch of entries in the remote directory.
+ *
+ * @param request The request the entries are for.
+ * @param entries The names of the entries.
+ *
+ * The lister is shared, so entries from requests other than this completer's
+ * latest one are ignored.
+ */
+void PathCompleter::appendRemoteEntries(RemoteLister::RequestId request, const QStringList & entries)
+{
+    if(!m_remote || request != m_request) {
+        return;
+    }
+
+    m_entries->append(entries);
+
+    if(m_lineEdit->hasFocus() && !popup()->isVisible() && m_lineEdit->text().startsWith(m_directory)) {
+        complete();
+    }
+}
+
+/**
+ * @brief Note that all the entries in the remote directory have been offered.
+ *
+ * @param request The request that has finished.
+ *
+ * A directory that could not be listed simply offers no completions; it is
+ * not listed again until the user moves to another directory.
+ */
+void PathCompleter::finishRemoteEntries(RemoteLister::RequestId request)
+{
+    if(m_remote && request == m_request) {
+        m_listed = true;
+    }
+}
+
+/**
+ * @brief Forget the entries offered so far, abandoning the listing in
+ * progress.
+ *
+ * @param directory The directory whose entries are to be offered next, or an
+ * empty string for none.
+ */
+void PathCompleter::resetEntries(const QString & directory)
+{
+    // local listings are abandoned by the next one; remote ones have to be cancelled
+    if(m_remote && !m_listed) {
+        m_remoteLister->cancel(m_request);
+    }
+
+    m_directory = directory;
+    m_entries->reset(directory);
+    m_request = DirectoryLister::NoRequest;
+    m_remote = false;
+    m_listed = false;
+}
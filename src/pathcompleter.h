@@ -0,0 +1,71 @@
+/**
+ * @file pathcompleter.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the PathCompleter class.
+ */
+
+#ifndef QYNC_PATHCOMPLETER_H
+#define QYNC_PATHCOMPLETER_H
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtWidgets/QCompleter>
+
+#include "directorylister.h"
+#include "remotelister.h"
+
+class QLineEdit;
+
+namespace Qync {
+
+	namespace Detail::PathCompleter {
+		class EntryModel;
+	}
+
+	class Preset;
+
+	class PathCompleter
+	: public QCompleter {
+		Q_OBJECT
+
+	public:
+		PathCompleter(DirectoryLister & lister, QLineEdit * lineEdit);
+		~PathCompleter() override;
+
+		void setRemoteLister(RemoteLister * lister, const Preset * transport);
+
+	private Q_SLOTS:
+		void listDirectoryFor(const QString & path);
+		void appendEntries(Qync::DirectoryLister::RequestId request, const QStringList & entries);
+		void finishEntries(Qync::DirectoryLister::RequestId request);
+		void appendRemoteEntries(Qync::RemoteLister::RequestId request, const QStringList & entries);
+		void finishRemoteEntries(Qync::RemoteLister::RequestId request);
+
+	private:
+		void resetEntries(const QString & directory);
+
+		DirectoryLister & m_lister;
+		QLineEdit * m_lineEdit;
+
+		// not owned; both null unless remote paths are completed
+		RemoteLister * m_remoteLister;
+		const Preset * m_transport;
+
+		// owned by the completer, as its model
+		Detail::PathCompleter::EntryModel * m_entries;
+
+		// the directory the entries are in, with its trailing '/'
+		QString m_directory;
+
+		// a request to m_remoteLister if m_remote, otherwise to m_lister
+		quint64 m_request;
+		bool m_remote;
+		bool m_listed;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_PATHCOMPLETER_H
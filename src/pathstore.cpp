@@ -0,0 +1,572 @@
+/**
+ * @file pathstore.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the PathStore class.
+ */
+
+#include "pathstore.h"
+
+#include <cstring>
+
+#include <QtCore/QDebug>
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::PathStore class.
+ */
+namespace Qync::Detail::PathStore {
+    // the size of each block of names. a name's offset is its block number in
+    // the high bits and its position in the block in the low bits
+    static constexpr const int NameBlockBits = 16;
+    static constexpr const std::size_t NameBlockSize = std::size_t{1} << NameBlockBits;
+
+    // keeps the offsets clear of NoName
+    static constexpr const std::size_t MaximumNameBlocks = std::size_t{1} << (31 - NameBlockBits);
+
+    // file Ids have to leave the directory bit clear
+    static constexpr const std::size_t MaximumFileBlocks = std::size_t{1} << 19;
+
+    // what addName() gives when the store is full
+    static constexpr const quint32 NoName = 0xffffffff;
+
+    // names longer than a block are truncated, but no filesystem allows names
+    // anything like that long
+    static std::string_view fittedName(std::string_view name)
+    {
+        if(NameBlockSize - 1 < name.size()) {
+            qWarning() << __PRETTY_FUNCTION__ << "name of" << name.size() << "bytes is too long; truncating it";
+            return name.substr(0, NameBlockSize - 1);
+        }
+
+        return name;
+    }
+}  // namespace Qync::Detail::PathStore
+
+/**
+ * @class PathStore
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief A compact store of the paths of the items rsync processes.
+ *
+ * A Process adds the path of each item rsync lists to its store (see
+ * Process::pathStore()) and its item signals carry the Id of the path rather
+ * than the path itself, so the views and logs that keep track of the items
+ * hold 4-byte Ids and share a single copy of each path.
+ *
+ * The paths are stored in a trie. Each Id is a node, which refers to the node
+ * for its parent directory and to its name, so a directory's path is stored
+ * once however many entries it has. Directory names are also interned, since
+ * the same few (e.g. "src", ".git") recur throughout most trees. The names
+ * themselves are stored end to end in large blocks, so a file costs 8 bytes
+ * plus the length of its name, compared to a couple of hundred bytes for a
+ * QString of the full path of an entry a few directories deep. Full paths are
+ * only built when they're asked for.
+ *
+ * Directories have a single Id, however many times they are added or appear
+ * in the paths of other entries. Files are not looked up, so adding the same
+ * file twice gives it two Ids. Ids are never reused.
+ *
+ * Files are reference counted, so that the store only holds the files that
+ * something is still keeping track of. add() gives the caller a reference to
+ * the file it adds; anything else that keeps the Id calls retain(), and
+ * everything that has a reference calls release() when it no longer needs the
+ * path. The files are stored in blocks of a few thousand, and a block is freed
+ * once all the references to its files have been released - for example when
+ * a log has evicted them - so the store's memory is bounded by what its users
+ * keep rather than by the size of the run. An Id must not be used once it has
+ * been released. Directories are never released, since the files in them
+ * refer to them.
+ *
+ * The store is not thread safe: a Process's store is only used on the thread
+ * that owns the Process.
+ */
+
+/**
+ * @brief Create a new, empty, block of files.
+ */
+PathStore::FileBlock::FileBlock()
+:   nodes(std::make_unique<Node[]>(FileBlockSize)),
+    count(0),
+    names(std::make_unique<char[]>(Detail::PathStore::NameBlockSize)),
+    namesUsed(0),
+    references(0)
+{
+}
+
+/**
+ * @brief Create a new, empty, store.
+ */
+PathStore::PathStore()
+:   m_nameBlocks(),
+    m_nameBlockUsed(0),
+    m_directoryNames(),
+    m_directoryNodes(),
+    m_directories(),
+    m_fileBlocks(),
+    m_liveFileBlocks(0),
+    m_lastParentPath(),
+    m_lastParent(NoPath)
+{
+}
+
+/**
+ * @brief Destroy the store.
+ */
+PathStore::~PathStore() = default;
+
+/**
+ * @brief Add a path to the store.
+ *
+ * @param path The path. Directories have a trailing '/'.
+ *
+ * All the directories in the path are added too, if they're not already in
+ * the store. If the path is a file, the caller has a reference to it and must
+ * release() it when it no longer needs it.
+ *
+ * @return The Id of the path, or NoPath if the store is full.
+ */
+PathStore::Id PathStore::add(const QString & path)
+{
+    auto utf8 = path.toUtf8();
+    const bool isDirectory = utf8.endsWith('/');
+
+    if(isDirectory) {
+        utf8.chop(1);
+    }
+
+    const auto slash = utf8.lastIndexOf('/');
+    Id parent = NoPath;
+
+    if(0 < slash) {
+        const auto parentPath = QByteArray::fromRawData(utf8.constData(), slash);
+
+        if(NoPath != m_lastParent && parentPath == m_lastParentPath) {
+            parent = m_lastParent;
+        }
+        else {
+            int begin = 0;
+
+            while(begin < slash) {
+                auto end = utf8.indexOf('/', begin);
+
+                if(0 > end || end > slash) {
+                    end = slash;
+                }
+
+                if(end > begin) {
+                    parent = directoryNode(parent, std::string_view(utf8.constData() + begin, static_cast<std::size_t>(end - begin)));
+
+                    if(NoPath == parent) {
+                        return NoPath;
+                    }
+                }
+
+                begin = end + 1;
+            }
+
+            m_lastParentPath = QByteArray(utf8.constData(), slash);
+            m_lastParent = parent;
+        }
+    }
+
+    const std::string_view name(utf8.constData() + slash + 1, static_cast<std::size_t>(utf8.size() - slash - 1));
+
+    if(isDirectory) {
+        return directoryNode(parent, name);
+    }
+
+    return fileNode(parent, name);
+}
+
+/**
+ * @brief Take a reference to a file.
+ *
+ * @param id The Id of the file. It must be in the store and must not have been
+ * released by whatever already holds it.
+ *
+ * The path stays in the store until the reference is given back with
+ * release(). Directories are never released, so nothing is done for them, nor
+ * for NoPath.
+ */
+void PathStore::retain(Id id) const
+{
+    if(NoPath == id || isDirectory(id)) {
+        return;
+    }
+
+    Q_ASSERT_X(contains(id), __PRETTY_FUNCTION__, "the file is not in the store");
+    ++m_fileBlocks[id >> FileBlockBits]->references;
+}
+
+/**
+ * @brief Give back a reference to a file.
+ *
+ * @param id The Id of the file, as given by add() or passed to retain().
+ *
+ * Once the last reference to every file in its block has been released and
+ * no more files are being added to the block, it is freed. Nothing is done for
+ * directories or NoPath.
+ */
+void PathStore::release(Id id) const
+{
+    if(NoPath == id || isDirectory(id)) {
+        return;
+    }
+
+    Q_ASSERT_X(contains(id), __PRETTY_FUNCTION__, "the file is not in the store");
+    const auto index = id >> FileBlockBits;
+    auto & block = m_fileBlocks[index];
+    Q_ASSERT_X(0 < block->references, __PRETTY_FUNCTION__, "the file has already been released");
+    --block->references;
+
+    if(0 == block->references && index + 1 < m_fileBlocks.size()) {
+        block.reset();
+        --m_liveFileBlocks;
+    }
+}
+
+/**
+ * @brief Check whether an Id is in the store.
+ *
+ * @param id The Id.
+ *
+ * An Id that has been released may still be reported as in the store until
+ * the rest of its block has been released.
+ *
+ * @return @b true if the Id was given out by the store and its path is still
+ * held, @b false otherwise.
+ */
+bool PathStore::contains(Id id) const
+{
+    if(NoPath == id) {
+        return false;
+    }
+
+    if(isDirectory(id)) {
+        return (id & ~DirectoryId) < m_directoryNodes.size();
+    }
+
+    const auto index = id >> FileBlockBits;
+    return index < m_fileBlocks.size() && m_fileBlocks[index] && static_cast<int>(id & (FileBlockSize - 1)) < m_fileBlocks[index]->count;
+}
+
+/**
+ * @brief Fetch the name of an entry.
+ *
+ * @param id The Id of the entry. It must be in the store.
+ *
+ * @return The name, UTF-8. It remains valid until the entry is released.
+ */
+std::string_view PathStore::name(Id id) const
+{
+    using Detail::PathStore::NameBlockBits;
+    const auto offset = node(id).name;
+
+    if(isDirectory(id)) {
+        return {m_nameBlocks[offset >> NameBlockBits].get() + (offset & ((1U << NameBlockBits) - 1))};
+    }
+
+    return {m_fileBlocks[id >> FileBlockBits]->names.get() + offset};
+}
+
+/**
+ * @brief Fetch the path of an entry.
+ *
+ * @param id The Id of the entry.
+ *
+ * @return The UTF-8 path, with a trailing '/' for directories, or an empty
+ * array if the Id is not in the store.
+ */
+QByteArray PathStore::utf8Path(Id id) const
+{
+    if(!contains(id)) {
+        return {};
+    }
+
+    QByteArray path;
+
+    for(auto entry = id; NoPath != entry; entry = node(entry).parent) {
+        const auto entryName = name(entry);
+
+        if(!path.isEmpty()) {
+            path.prepend('/');
+        }
+
+        path.prepend(entryName.data(), static_cast<int>(entryName.size()));
+    }
+
+    if(isDirectory(id)) {
+        path.append('/');
+    }
+
+    return path;
+}
+
+/**
+ * @brief Fetch the path of an entry.
+ *
+ * @param id The Id of the entry.
+ *
+ * @return The path, with a trailing '/' for directories, or an empty string if
+ * the Id is not in the store.
+ */
+QString PathStore::path(Id id) const
+{
+    return QString::fromUtf8(utf8Path(id));
+}
+
+/**
+ * @brief Work out how deep an entry is in the tree.
+ *
+ * @param id The Id of the entry. It must be in the store.
+ *
+ * @return 0 for a top-level entry, 1 for an entry in a top-level directory,
+ * and so on.
+ */
+int PathStore::depth(Id id) const
+{
+    int depth = 0;
+
+    for(auto entry = node(id).parent; NoPath != entry; entry = node(entry).parent) {
+        ++depth;
+    }
+
+    return depth;
+}
+
+/**
+ * @brief Check whether one path sorts before another.
+ *
+ * @param first The Id of the first path. It must be in the store.
+ * @param second The Id of the second path. It must be in the store.
+ *
+ * A directory sorts before everything it contains; otherwise the paths sort by
+ * the names of the entries where they part, byte for byte, which is the order
+ * rsync lists a tree in.
+ *
+ * @return @b true if @p first sorts before @p second, @b false otherwise.
+ */
+bool PathStore::isBefore(Id first, Id second) const
+{
+    if(first == second) {
+        return false;
+    }
+
+    auto firstDepth = depth(first);
+    auto secondDepth = depth(second);
+
+    for(; firstDepth > secondDepth; --firstDepth) {
+        first = node(first).parent;
+    }
+
+    // second contains first
+    if(first == second) {
+        return false;
+    }
+
+    for(; secondDepth > firstDepth; --secondDepth) {
+        second = node(second).parent;
+    }
+
+    // first contains second
+    if(first == second) {
+        return true;
+    }
+
+    while(node(first).parent != node(second).parent) {
+        first = node(first).parent;
+        second = node(second).parent;
+    }
+
+    return name(first) < name(second);
+}
+
+/**
+ * @brief Estimate the memory used by the store.
+ *
+ * @return The number of bytes.
+ */
+std::size_t PathStore::memoryUsed() const
+{
+    // each hash table entry is a node holding the key, the value and a link,
+    // plus a bucket pointer
+    static constexpr const std::size_t HashEntryOverhead = 2 * sizeof(void *);
+
+    return m_nameBlocks.size() * Detail::PathStore::NameBlockSize
+           + m_directoryNames.size() * (sizeof(std::string_view) + sizeof(quint32) + HashEntryOverhead)
+           + m_directoryNodes.capacity() * sizeof(Node)
+           + m_directories.size() * (sizeof(quint64) + sizeof(Id) + HashEntryOverhead)
+           + m_fileBlocks.capacity() * sizeof(std::unique_ptr<FileBlock>)
+           + m_liveFileBlocks * (sizeof(FileBlock) + FileBlockSize * sizeof(Node) + Detail::PathStore::NameBlockSize);
+}
+
+/**
+ * @brief Store the name of a directory.
+ *
+ * @param name The name, UTF-8.
+ *
+ * @return The offset of the stored name, or Detail::PathStore::NoName if the
+ * store is full.
+ */
+quint32 PathStore::addName(std::string_view name)
+{
+    using namespace Detail::PathStore;
+    name = fittedName(name);
+
+    if(m_nameBlocks.empty() || NameBlockSize - m_nameBlockUsed < name.size() + 1) {
+        if(MaximumNameBlocks == m_nameBlocks.size()) {
+            qWarning() << __PRETTY_FUNCTION__ << "the path store is full";
+            return NoName;
+        }
+
+        m_nameBlocks.push_back(std::make_unique<char[]>(NameBlockSize));
+        m_nameBlockUsed = 0;
+    }
+
+    const auto offset = static_cast<quint32>(((m_nameBlocks.size() - 1) << NameBlockBits) | m_nameBlockUsed);
+    auto * storage = m_nameBlocks.back().get() + m_nameBlockUsed;
+    std::memcpy(storage, name.data(), name.size());
+    storage[name.size()] = '\0';
+    m_nameBlockUsed += name.size() + 1;
+    return offset;
+}
+
+/**
+ * @brief Find or store the name of a directory.
+ *
+ * @param name The name, UTF-8.
+ *
+ * @return The offset of the stored name, or Detail::PathStore::NoName if the
+ * store is full.
+ */
+quint32 PathStore::internDirectoryName(std::string_view name)
+{
+    const auto it = m_directoryNames.find(name);
+
+    if(m_directoryNames.cend() != it) {
+        return it->second;
+    }
+
+    const auto offset = addName(name);
+
+    if(Detail::PathStore::NoName == offset) {
+        return offset;
+    }
+
+    // the key must refer to the stored name, not the caller's
+    const auto & blockBase = m_nameBlocks.back();
+    m_directoryNames.emplace(std::string_view(blockBase.get() + (offset & ((1U << Detail::PathStore::NameBlockBits) - 1))), offset);
+    return offset;
+}
+
+/**
+ * @brief Find or add the node for a directory.
+ *
+ * @param parent The Id of the directory that contains it, or NoPath if it is a
+ * top-level entry.
+ * @param name The name of the directory, UTF-8.
+ *
+ * @return The Id of the directory, or NoPath if the store is full.
+ */
+PathStore::Id PathStore::directoryNode(Id parent, std::string_view name)
+{
+    const auto offset = internDirectoryName(name);
+
+    if(Detail::PathStore::NoName == offset) {
+        return NoPath;
+    }
+
+    const auto key = (static_cast<quint64>(parent) << 32) | offset;
+    const auto it = m_directories.find(key);
+
+    if(m_directories.cend() != it) {
+        return it->second;
+    }
+
+    if(DirectoryId - 1 == m_directoryNodes.size()) {
+        qWarning() << __PRETTY_FUNCTION__ << "the path store is full";
+        return NoPath;
+    }
+
+    m_directoryNodes.push_back({parent, offset});
+    const auto id = static_cast<Id>(m_directoryNodes.size() - 1) | DirectoryId;
+    m_directories.emplace(key, id);
+    return id;
+}
+
+/**
+ * @brief Add the node for a file.
+ *
+ * @param parent The Id of the directory that contains it, or NoPath if it is a
+ * top-level entry.
+ * @param name The name of the file, UTF-8.
+ *
+ * A new block is started when the last one has no room for the file. If
+ * nothing refers to any of the files in the last block by then, it is freed.
+ *
+ * @return The Id of the file, with a reference for the caller, or NoPath if
+ * the store is full.
+ */
+PathStore::Id PathStore::fileNode(Id parent, std::string_view name)
+{
+    using namespace Detail::PathStore;
+    name = fittedName(name);
+    auto * block = (m_fileBlocks.empty() ? nullptr : m_fileBlocks.back().get());
+
+    if(!block || FileBlockSize == block->count || NameBlockSize - block->namesUsed < name.size() + 1) {
+        if(MaximumFileBlocks == m_fileBlocks.size()) {
+            qWarning() << __PRETTY_FUNCTION__ << "the path store is full";
+            return NoPath;
+        }
+
+        if(block && 0 == block->references) {
+            m_fileBlocks.back().reset();
+            --m_liveFileBlocks;
+        }
+
+        m_fileBlocks.push_back(std::make_unique<FileBlock>());
+        ++m_liveFileBlocks;
+        block = m_fileBlocks.back().get();
+    }
+
+    auto * storage = block->names.get() + block->namesUsed;
+    std::memcpy(storage, name.data(), name.size());
+    storage[name.size()] = '\0';
+    block->nodes[static_cast<std::size_t>(block->count)] = {parent, static_cast<quint32>(block->namesUsed)};
+    block->namesUsed += name.size() + 1;
+    ++block->references;
+    return static_cast<Id>(((m_fileBlocks.size() - 1) << FileBlockBits) | static_cast<std::size_t>(block->count++));
+}
+
+/**
+ * @fn PathStore::parent(Id)
+ * @brief Fetch the directory that contains an entry.
+ *
+ * @param id The Id of the entry. It must be in the store.
+ *
+ * @return The Id of the directory, or NoPath for a top-level entry.
+ */
+
+/**
+ * @fn PathStore::isDirectory(Id)
+ * @brief Check whether an entry is a directory.
+ *
+ * @param id The Id of the entry.
+ *
+ * @return @b true if it is a directory, @b false otherwise.
+ */
+
+/**
+ * @fn PathStore::node(Id)
+ * @brief Fetch the node for an entry.
+ *
+ * @param id The Id of the entry. It must be in the store.
+ *
+ * @return The node.
+ */
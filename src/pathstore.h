@@ -0,0 +1,127 @@
+/**
+ * @file pathstore.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the PathStore class.
+ */
+
+#ifndef QYNC_PATHSTORE_H
+#define QYNC_PATHSTORE_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+namespace Qync {
+
+	class PathStore {
+	public:
+		using Id = quint32;
+		static constexpr const Id NoPath = 0xffffffff;
+
+		PathStore();
+		PathStore(const PathStore &) = delete;
+		PathStore(PathStore &&) = default;
+		PathStore & operator=(const PathStore &) = delete;
+		PathStore & operator=(PathStore &&) = default;
+		~PathStore();
+
+		Id add(const QString & path);
+		void retain(Id id) const;
+		void release(Id id) const;
+
+		[[nodiscard]] bool contains(Id id) const;
+
+		[[nodiscard]] inline Id parent(Id id) const {
+			return node(id).parent;
+		}
+
+		[[nodiscard]] inline bool isDirectory(Id id) const {
+			return NoPath != id && 0 != (id & DirectoryId);
+		}
+
+		[[nodiscard]] std::string_view name(Id id) const;
+		[[nodiscard]] QByteArray utf8Path(Id id) const;
+		[[nodiscard]] QString path(Id id) const;
+		[[nodiscard]] int depth(Id id) const;
+		[[nodiscard]] bool isBefore(Id first, Id second) const;
+		[[nodiscard]] std::size_t memoryUsed() const;
+
+	private:
+		struct Node {
+			// the directory containing the entry, NoPath for the top-level entries
+			Id parent;
+
+			// the offset of the name, in the name blocks for a directory and in its block for a file
+			quint32 name;
+		};
+
+		struct FileBlock {
+			FileBlock();
+
+			std::unique_ptr<Node[]> nodes;
+			int count;
+			std::unique_ptr<char[]> names;
+			std::size_t namesUsed;
+
+			// the references to the block's files held by the users of the store
+			std::size_t references;
+		};
+
+		// the Ids of directories have this bit set; the rest is the index of the directory's node
+		static constexpr const Id DirectoryId = 0x80000000;
+
+		// the Id of a file is its block number in the high bits and its index in the block in the low bits
+		static constexpr const int FileBlockBits = 12;
+		static constexpr const int FileBlockSize = 1 << FileBlockBits;
+
+		[[nodiscard]] inline const Node & node(Id id) const {
+			if(id & DirectoryId) {
+				return m_directoryNodes[id & ~DirectoryId];
+			}
+
+			return m_fileBlocks[id >> FileBlockBits]->nodes[id & (FileBlockSize - 1)];
+		}
+
+		quint32 addName(std::string_view name);
+		quint32 internDirectoryName(std::string_view name);
+		Id directoryNode(Id parent, std::string_view name);
+		Id fileNode(Id parent, std::string_view name);
+
+		/* the names of the directories, UTF-8 and nul-terminated, in blocks that
+		 * never move so that the interned names can refer to them */
+		std::vector<std::unique_ptr<char[]>> m_nameBlocks;
+		std::size_t m_nameBlockUsed;
+
+		/* directory names are interned, since the same ones recur throughout a
+		 * tree; the names of files are mostly unique, so they're not */
+		std::unordered_map<std::string_view, quint32> m_directoryNames;
+
+		/* only directories are ever parents, so only they can be found by parent
+		 * and name. they are never released, since the paths of the files they
+		 * contain refer to them */
+		std::vector<Node> m_directoryNodes;
+		std::unordered_map<quint64, Id> m_directories;
+
+		/* files are added to the last block, and the others are freed once
+		 * nothing refers to any of their files. releasing a file doesn't change
+		 * the paths of those still held, so it can be done through a const store */
+		mutable std::vector<std::unique_ptr<FileBlock>> m_fileBlocks;
+		mutable std::size_t m_liveFileBlocks;
+
+		/* paths usually arrive a directory at a time, so the last parent found is
+		 * kept to save looking it up again */
+		QByteArray m_lastParentPath;
+		Id m_lastParent;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_PATHSTORE_H
@@ -28,10 +28,22 @@ using namespace Qync;
  *
  * @brief Base class representing the core Qync preferences.
  *
- * This class represents the core preferences for a Qync application. At present
- * it has only one setting, which is the path of the @b rsync executable file.
- * This is set using setRsyncPath(), read using rsyncPath() and its validity can
- * be assessed using rsyncPathIsValid().
+ * This class represents the core preferences for a Qync application. The main
+ * setting is the path of the @b rsync executable file. This is set using
+ * setRsyncPath(), read using rsyncPath() and its validity can be assessed using
+ * rsyncPathIsValid(). Whether rsync's output is read and parsed on a worker
+ * thread rather than the main thread is set using setUseWorkerThread() and read
+ * using useWorkerThread(). Whether local sources are scanned so that overall
+ * progress can be estimated from their size is set using setScanSources() and
+ * read using scanSources(). The format in which presets are saved in the
+ * presets directory is set using setPresetFileFormat() and read using
+ * presetFileFormat(). The number of queued synchronisations that may run
+ * at the same time is set using setMaximumConcurrentJobs() and read using
+ * maximumConcurrentJobs(). The bandwidth shared between the synchronisations
+ * that are running is set using setBandwidthBudget() and read using
+ * bandwidthBudget(). Whether Qync measures its own handling of rsync's
+ * output (see Instrumentation) is set using setInstrumentationEnabled() and
+ * read using instrumentationEnabled().
  *
  * In addition to managing this setting, the class provides the core loading -
  * load() and loadFrom() - and saving - save(), saveAs() and saveCopyAs() -
@@ -78,7 +90,13 @@ Preferences::Preferences()
  */
 Preferences::Preferences(QString fileName)
 :   m_fileName(std::move(fileName)),
-    m_rsyncBinary()
+    m_rsyncBinary(),
+    m_workerThread(false),
+    m_scanSources(true),
+    m_presetFileFormat(Preset::FileFormat::Xml),
+    m_maxConcurrentJobs(DefaultConcurrentJobs),
+    m_bandwidthBudget(0),
+    m_instrumentation(false)
 {
     m_fileName = fileName;
     load();
@@ -87,7 +105,10 @@ Preferences::Preferences(QString fileName)
 /**
  * @brief Set the default values for all settings.
  *
- * By default, the rsync path is set to @b /usr/bin/rsync.
+ * By default, the rsync path is set to @b /usr/bin/rsync and rsync's output is
+ * processed on the main thread. Local sources are scanned to estimate overall
+ * progress. Presets are saved as XML. Two queued synchronisations may run at
+ * once, with no limit on the bandwidth they use between them.
  *
  * Reimplementations should call this base class method to ensure that
  * defaults for core settings are also set.
@@ -108,6 +129,51 @@ void Preferences::setDefaults()
     qCritical() << __PRETTY_FUNCTION__ << "unsupported platform - default rsync binary unknown";
     setRsyncPath({});
 #endif
+
+    setUseWorkerThread(false);
+    setScanSources(true);
+    setPresetFileFormat(Preset::FileFormat::Xml);
+    setMaximumConcurrentJobs(DefaultConcurrentJobs);
+    setBandwidthBudget(0);
+    setInstrumentationEnabled(false);
+}
+
+/**
+ * @brief Set how many queued synchronisations may run at the same time.
+ *
+ * @param max The number of synchronisations. It must be between
+ * MinimumConcurrentJobs and MaximumConcurrentJobs.
+ *
+ * @return @b true if the number was set, @b false if it is out of range.
+ */
+bool Preferences::setMaximumConcurrentJobs(int max)
+{
+    if(MinimumConcurrentJobs > max || MaximumConcurrentJobs < max) {
+        qWarning() << __PRETTY_FUNCTION__ << "maximum concurrent jobs" << max << "is out of range";
+        return false;
+    }
+
+    m_maxConcurrentJobs = max;
+    return true;
+}
+
+/**
+ * @brief Set the bandwidth shared between the synchronisations that are running.
+ *
+ * @param budget The bandwidth in KiB per second, 0 for no limit. It must be no
+ * more than MaximumBandwidthBudget.
+ *
+ * @return @b true if the budget was set, @b false if it is out of range.
+ */
+bool Preferences::setBandwidthBudget(int budget)
+{
+    if(0 > budget || MaximumBandwidthBudget < budget) {
+        qWarning() << __PRETTY_FUNCTION__ << "bandwidth budget" << budget << "is out of range";
+        return false;
+    }
+
+    m_bandwidthBudget = budget;
+    return true;
 }
 
 /**
@@ -199,6 +265,56 @@ bool Preferences::parseCorePreferencesXml(QXmlStreamReader & xml)
         if("rsyncpath" == xml.name()) {
             setRsyncPath(xml.readElementText());
         }
+        else if("workerthread" == xml.name()) {
+            auto value = parseBooleanText(xml.readElementText());
+
+            if(value) {
+                setUseWorkerThread(*value);
+            }
+        }
+        else if("scansources" == xml.name()) {
+            auto value = parseBooleanText(xml.readElementText());
+
+            if(value) {
+                setScanSources(*value);
+            }
+        }
+        else if("presetformat" == xml.name()) {
+            auto format = xml.readElementText().trimmed();
+
+            if(0 == QString::compare("binary", format, Qt::CaseInsensitive)) {
+                setPresetFileFormat(Preset::FileFormat::Binary);
+            }
+            else if(0 == QString::compare("xml", format, Qt::CaseInsensitive)) {
+                setPresetFileFormat(Preset::FileFormat::Xml);
+            }
+            else {
+                qWarning() << __PRETTY_FUNCTION__ << "unrecognised preset format" << format;
+            }
+        }
+        else if("maximumconcurrentjobs" == xml.name()) {
+            bool ok;
+            int max = xml.readElementText().trimmed().toInt(&ok);
+
+            if(ok) {
+                setMaximumConcurrentJobs(max);
+            }
+        }
+        else if("bandwidthbudget" == xml.name()) {
+            bool ok;
+            int budget = xml.readElementText().trimmed().toInt(&ok);
+
+            if(ok) {
+                setBandwidthBudget(budget);
+            }
+        }
+        else if("instrumentation" == xml.name()) {
+            auto value = parseBooleanText(xml.readElementText());
+
+            if(value) {
+                setInstrumentationEnabled(*value);
+            }
+        }
         else {
             Qync::parseUnknownElementXml(xml);
         }
@@ -254,6 +370,24 @@ bool Preferences::emitCorePreferencesXml(QXmlStreamWriter & xml) const
     xml.writeStartElement("rsyncpath");
     xml.writeCharacters(rsyncPath());
     xml.writeEndElement();
+    xml.writeStartElement("workerthread");
+    xml.writeCharacters(useWorkerThread() ? "true" : "false");
+    xml.writeEndElement();
+    xml.writeStartElement("scansources");
+    xml.writeCharacters(scanSources() ? "true" : "false");
+    xml.writeEndElement();
+    xml.writeStartElement("presetformat");
+    xml.writeCharacters(Preset::FileFormat::Binary == presetFileFormat() ? "binary" : "xml");
+    xml.writeEndElement();
+    xml.writeStartElement("maximumconcurrentjobs");
+    xml.writeCharacters(QString::number(maximumConcurrentJobs()));
+    xml.writeEndElement();
+    xml.writeStartElement("bandwidthbudget");
+    xml.writeCharacters(QString::number(bandwidthBudget()));
+    xml.writeEndElement();
+    xml.writeStartElement("instrumentation");
+    xml.writeCharacters(instrumentationEnabled() ? "true" : "false");
+    xml.writeEndElement();
     xml.writeEndElement();
     return true;
 }
@@ -405,3 +539,85 @@ bool Preferences::rsyncPathIsValid() const {
  *
  * @return @b true if the path was set, @b false otherwise.
  */
+
+/**
+ * @fn Preferences::useWorkerThread()
+ * @brief Check whether rsync's output should be processed on a worker thread.
+ *
+ * @return @b true if Process objects should read, log and parse rsync's output
+ * on a dedicated thread, @b false if it should be done on the main thread.
+ */
+
+/**
+ * @fn Preferences::setUseWorkerThread(bool)
+ * @brief Set whether rsync's output should be processed on a worker thread.
+ *
+ * @param use @b true if Process objects should read, log and parse rsync's
+ * output on a dedicated thread, @b false if it should be done on the main
+ * thread.
+ */
+
+/**
+ * @fn Preferences::scanSources()
+ * @brief Check whether local sources should be scanned to estimate overall
+ * progress.
+ *
+ * @return @b true if Process objects should scan local sources, @b false if
+ * overall progress should be based only on rsync's item counts.
+ */
+
+/**
+ * @fn Preferences::setScanSources(bool)
+ * @brief Set whether local sources should be scanned to estimate overall
+ * progress.
+ *
+ * @param scan @b true if Process objects should scan local sources, @b false
+ * if overall progress should be based only on rsync's item counts.
+ */
+
+/**
+ * @fn Preferences::presetFileFormat()
+ * @brief Fetch the format in which presets are saved.
+ *
+ * Presets are only converted to the format when they are next saved; they can
+ * be loaded whatever format they are in. Exported presets are always XML.
+ *
+ * @return The format.
+ */
+
+/**
+ * @fn Preferences::setPresetFileFormat(Preset::FileFormat)
+ * @brief Set the format in which presets are saved.
+ *
+ * @param format The format.
+ */
+
+/**
+ * @fn Preferences::maximumConcurrentJobs()
+ * @brief Fetch how many queued synchronisations may run at the same time.
+ *
+ * @return The number of synchronisations.
+ */
+
+/**
+ * @fn Preferences::bandwidthBudget()
+ * @brief Fetch the bandwidth shared between the synchronisations that are
+ * running.
+ *
+ * @return The bandwidth in KiB per second, 0 for no limit.
+ */
+
+/**
+ * @fn Preferences::instrumentationEnabled()
+ * @brief Check whether Qync should measure its own handling of rsync's output.
+ *
+ * @return @b true if the Instrumentation should be enabled, @b false if not.
+ */
+
+/**
+ * @fn Preferences::setInstrumentationEnabled(bool)
+ * @brief Set whether Qync should measure its own handling of rsync's output.
+ *
+ * @param enabled @b true if the Instrumentation should be enabled, @b false if
+ * not.
+ */
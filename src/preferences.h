@@ -11,8 +11,11 @@
 #define QYNC_PREFERENCES_H
 
 #include <QtCore/QString>
+#include <limits>
 #include <optional>
 
+#include "preset.h"
+
 class QXmlStreamReader;
 class QXmlStreamWriter;
 
@@ -41,6 +44,55 @@ namespace Qync {
 
 		[[nodiscard]] bool rsyncPathIsValid() const;
 
+		[[nodiscard]] inline bool useWorkerThread() const {
+			return m_workerThread;
+		}
+
+		inline void setUseWorkerThread(bool use) {
+			m_workerThread = use;
+		}
+
+		[[nodiscard]] inline bool scanSources() const {
+			return m_scanSources;
+		}
+
+		inline void setScanSources(bool scan) {
+			m_scanSources = scan;
+		}
+
+		[[nodiscard]] inline Preset::FileFormat presetFileFormat() const {
+			return m_presetFileFormat;
+		}
+
+		inline void setPresetFileFormat(Preset::FileFormat format) {
+			m_presetFileFormat = format;
+		}
+
+		[[nodiscard]] inline int maximumConcurrentJobs() const {
+			return m_maxConcurrentJobs;
+		}
+
+		bool setMaximumConcurrentJobs(int max);
+
+		[[nodiscard]] inline int bandwidthBudget() const {
+			return m_bandwidthBudget;
+		}
+
+		bool setBandwidthBudget(int budget);
+
+		[[nodiscard]] inline bool instrumentationEnabled() const {
+			return m_instrumentation;
+		}
+
+		inline void setInstrumentationEnabled(bool enabled) {
+			m_instrumentation = enabled;
+		}
+
+		static constexpr const int MinimumConcurrentJobs = 1;
+		static constexpr const int MaximumConcurrentJobs = 64;
+		static constexpr const int DefaultConcurrentJobs = 2;
+		static constexpr const int MaximumBandwidthBudget = std::numeric_limits<int>::max() / 1024;
+
 	protected:
 		virtual void setDefaults();
 		virtual bool parseXmlStream(QXmlStreamReader & xml);
@@ -53,6 +105,12 @@ namespace Qync {
 	private:
 		QString m_fileName;
 		QString m_rsyncBinary;
+		bool m_workerThread;
+		bool m_scanSources;
+		Preset::FileFormat m_presetFileFormat;
+		int m_maxConcurrentJobs;
+		int m_bandwidthBudget;
+		bool m_instrumentation;
 	};
 
 }  // namespace Qync
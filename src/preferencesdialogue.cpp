@@ -14,6 +14,7 @@
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QCheckBox>
 #include <QtWidgets/QGroupBox>
+#include <QtWidgets/QSpinBox>
 #include <QtCore/QString>
 #include <QtWidgets/QFileDialog>
 
@@ -38,8 +39,10 @@ using namespace Qync;
  * used along with the example GUI (or another GUI that uses the
  * GuiPreferences class for its preferences).
  *
- * The dialogue provides access to the rsync path as well as setting the visible
- * toolbars and the style of the toolbars. The modified settings can be applied
+ * The dialogue provides access to the rsync path, whether rsync's output is
+ * processed on a worker thread, how often progress is shown and how many
+ * processed items are listed, as well as setting the visible toolbars and the
+ * style of the toolbars. The modified settings can be applied
  * while keeping the dialogue open, applied and the dialogue closed, or
  * forgotten completely. As the manager saves the preferences whenever they
  * are set, applied changes are always rememberd between sessions using the
@@ -83,10 +86,22 @@ void PreferencesDialogue::updateWidgets()
     const auto & prefs = qyncApp->preferences();
 
     m_ui->rsyncPath->setText(prefs.rsyncPath());
+    m_ui->workerThread->setChecked(prefs.useWorkerThread());
+    m_ui->scanSources->setChecked(prefs.scanSources());
+    m_ui->binaryPresets->setChecked(Preset::FileFormat::Binary == prefs.presetFileFormat());
+    m_ui->instrumentation->setChecked(prefs.instrumentationEnabled());
+    m_ui->maximumConcurrentJobs->setRange(Preferences::MinimumConcurrentJobs, Preferences::MaximumConcurrentJobs);
+    m_ui->maximumConcurrentJobs->setValue(prefs.maximumConcurrentJobs());
+    m_ui->bandwidthBudget->setRange(0, Preferences::MaximumBandwidthBudget);
+    m_ui->bandwidthBudget->setValue(prefs.bandwidthBudget());
     m_ui->simpleUi->setChecked(prefs.useSimpleUi());
     m_ui->toolbarGroup->setDisabled(prefs.useSimpleUi());
     m_ui->presetsToolbar->setChecked(prefs.showPresetsToolBar());
     m_ui->synchroniseToolbar->setChecked(prefs.showSynchroniseToolBar());
+    m_ui->progressUpdateRate->setRange(GuiPreferences::MinimumProgressUpdateRate, GuiPreferences::MaximumProgressUpdateRate);
+    m_ui->progressUpdateRate->setValue(prefs.progressUpdateRate());
+    m_ui->transferLogCapacity->setRange(GuiPreferences::MinimumTransferLogCapacity, GuiPreferences::MaximumTransferLogCapacity);
+    m_ui->transferLogCapacity->setValue(prefs.transferLogCapacity());
 
     switch(prefs.toolBarButtonStyle()) {
         case Qt::ToolButtonFollowStyle:
@@ -122,9 +137,17 @@ void PreferencesDialogue::apply()
     auto & prefs = qyncApp->preferences();
 
     prefs.setRsyncPath(m_ui->rsyncPath->text());
+    prefs.setUseWorkerThread(m_ui->workerThread->isChecked());
+    prefs.setScanSources(m_ui->scanSources->isChecked());
+    prefs.setPresetFileFormat(m_ui->binaryPresets->isChecked() ? Preset::FileFormat::Binary : Preset::FileFormat::Xml);
+    prefs.setInstrumentationEnabled(m_ui->instrumentation->isChecked());
+    prefs.setMaximumConcurrentJobs(m_ui->maximumConcurrentJobs->value());
+    prefs.setBandwidthBudget(m_ui->bandwidthBudget->value());
     prefs.setUseSimpleUi(m_ui->simpleUi->isChecked());
     prefs.setShowPresetsToolBar(m_ui->presetsToolbar->isChecked());
     prefs.setShowSynchroniseToolBar(m_ui->synchroniseToolbar->isChecked());
+    prefs.setProgressUpdateRate(m_ui->progressUpdateRate->value());
+    prefs.setTransferLogCapacity(m_ui->transferLogCapacity->value());
 
     switch(m_ui->toolbarStyle->currentIndex()) {
         default:
@@ -9,8 +9,10 @@
 
 #include "preset.h"
 
-#include <unordered_map>
+#include <atomic>
+#include <limits>
 
+#include <QtCore/QDataStream>
 #include <QtCore/QDebug>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
@@ -19,7 +21,9 @@
 #include <QtCore/QXmlStreamWriter>
 #include <QtCore/QXmlStreamReader>
 
+#include "bandwidthschedule.h"
 #include "functions.h"
+#include "presetproperties.h"
 
 using namespace Qync;
 
@@ -27,63 +31,90 @@ using namespace Qync;
  * @brief Implementation details for the Qync::Preset class.
  */
 namespace Qync::Detail::Preset {
-    // These aid with loading from and saving to XML. It is not necessary to
-    // implement any added features as properties, but doing so means that the
-    // XML reading/writing code will automatically handle them without having
-    // to write any XML parsing code (which can be a bit verbose).
-
-    // data structure containing the getter and setter for a property
-    // getters and setters are member functions of Preset.
-    template<typename T>
-    struct PresetProperty {
-        using Type = T;
-        using Getter = const T & (Qync::Preset::*) () const;
-        using Setter = bool (Qync::Preset::*)(const T &);
-
-        const Getter getter;
-        const Setter setter;
-    };
-
-    // Alias for a set of properties of a given type. it's a map of
-    // property-name => PresetProperty, with property-name a std::string
-    //
-    // so for any given property "myproperty" the value contains the getter
-    // and setter for "myproperty". So properties["myproperty"].setter(value)
-    // sets the value of "myproperty" and properties["myproperties"].getter()
-    // retrieves the value. The actual call syntax is more complicated because
-    // it needs an object to operate on.
-    template<typename T>
-    using PresetProperties = std::unordered_map<std::string, PresetProperty<T>>;
-
-    // the boolean properties for Preset objects
-    static PresetProperties<bool> booleanPresetProperties = {
-      {"preserveTime", {&Qync::Preset::preserveTime, &Qync::Preset::setPreserveTime}},
-      {"preservePermissions", {&Qync::Preset::preservePermissions, &Qync::Preset::setPreservePermissions}},
-      {"preserveOwner", {&Qync::Preset::preserveOwner, &Qync::Preset::setPreserveOwner}},
-      {"preserveGroup", {&Qync::Preset::preserveGroup, &Qync::Preset::setPreserveGroup}},
-
-      {"windowsCompatability", {&Qync::Preset::windowsCompatability, &Qync::Preset::setWindowsCompatability}},
-      {"honourDeletions", {&Qync::Preset::honourDeletions, &Qync::Preset::setHonourDeletions}},
-
-      {"alwaysCompareChecksums", {&Qync::Preset::alwaysCompareChecksums, &Qync::Preset::setAlwaysCompareChecksums}},
-      {"ignoreTimes", {&Qync::Preset::ignoreTimes, &Qync::Preset::setIgnoreTimes}},
-      {"preserveDevices", {&Qync::Preset::preserveDevices, &Qync::Preset::setPreserveDevices}},
-      {"keepPartialTransfers", {&Qync::Preset::keepPartialTransfers, &Qync::Preset::setKeepPartialTransfers}},
-      {"copySymlinksAsSymlinks", {&Qync::Preset::copySymlinksAsSymlinks, &Qync::Preset::setCopySymlinksAsSymlinks}},
-      {"makeBackups", {&Qync::Preset::makeBackups, &Qync::Preset::setMakeBackups}},
-
-      {"useTransferCompression", {&Qync::Preset::useTransferCompression, &Qync::Preset::setUseTransferCompression}},
-      {"onlyUpdateExistingEntries", {&Qync::Preset::onlyUpdateExistingEntries, &Qync::Preset::setOnlyUpdateExistingEntries}},
-      {"dontUpdateExistingEntries", {&Qync::Preset::dontUpdateExistingEntries, &Qync::Preset::setDontUpdateExistingEntries}},
-      {"dontMapUsersAndGroups", {&Qync::Preset::dontMapUsersAndGroups, &Qync::Preset::setDontMapUsersAndGroups}},
-      {"copyHardlinksAsHardlinks", {&Qync::Preset::copyHardlinksAsHardlinks, &Qync::Preset::setCopyHardlinksAsHardlinks}},
-      {"showItemisedChanges", {&Qync::Preset::showItemisedChanges, &Qync::Preset::setShowItemisedChanges}},
-    };
-
-    // the string properties for Preset objects
-    static PresetProperties<QString> stringPresetProperties = {
-      {"logFile", {&Qync::Preset::logFile, &Qync::Preset::setLogFile}},
-    };
+    // the source of revisions for all presets. 0 is never issued
+    static std::atomic<quint64> lastRevision(0);
+
+    // zstd's highest level, and the largest block size rsync accepts (protocol 30 and later)
+    static constexpr const int MaximumCompressionLevel = 22;
+    static constexpr const int MaximumBlockSize = 128 * 1024;
+
+    // rsync's --bwlimit is limited to what fits in an int of bytes per second
+    static constexpr const int MaximumBandwidthLimit = std::numeric_limits<int>::max() / 1024;
+
+    // retries are for riding out a flaky link, not for waiting indefinitely for one
+    static constexpr const int MaximumRetryAttempts = 100;
+    static constexpr const int DefaultRetryDelay = 30;
+    static constexpr const int MaximumRetryDelay = 60 * 60;
+
+    // an idle shared ssh connection is kept open for at most a day
+    static constexpr const int MaximumSshConnectionLifetime = 24 * 60 * 60;
+    static constexpr const int MaximumPort = 65535;
+
+    // how many fan-out destinations are synchronised at the same time
+    static constexpr const int MaximumFanOutConcurrency = 64;
+
+    // how many hours, days or weeks a retention rule can cover
+    static constexpr const int MaximumKeptSnapshots = 1000;
+
+    static bool isValidKeptSnapshots(int count, const char * function)
+    {
+        if(0 > count || MaximumKeptSnapshots < count) {
+            qWarning() << function << "invalid number of snapshots to keep" << count;
+            return false;
+        }
+
+        return true;
+    }
+
+    // Most settings are properties, listed in the tables in presetproperties.h.
+    // The XML and binary reading/writing code iterates the tables, so a
+    // property added there is loaded and saved without any more code here.
+
+    // the binary format starts with this, so it's easy to tell from XML. in
+    // the file it reads "QYNB"
+    static constexpr const quint32 BinaryMagic = 0x51594e42;
+    static constexpr const quint32 BinaryVersion = 1;
+    static constexpr const QDataStream::Version BinaryStreamVersion = QDataStream::Qt_5_9;
+
+    // read the named properties of one type from a binary stream
+    template<typename T, std::size_t N>
+    static bool parseBinaryProperties(QDataStream & in, Qync::Preset & preset, const PresetProperties::Table<T, N> & properties)
+    {
+        quint8 count;
+        in >> count;
+
+        for(quint8 index = 0; index < count && QDataStream::Ok == in.status(); ++index) {
+            QByteArray name;
+            T value;
+            in >> name >> value;
+
+            if(QDataStream::Ok != in.status()) {
+                break;
+            }
+
+            const auto * propertyDef = properties.find(std::string_view(name.constData(), static_cast<std::size_t>(name.size())));
+
+            if(!propertyDef) {
+                qWarning() << __PRETTY_FUNCTION__ << "unrecognised property" << name;
+                continue;
+            }
+
+            (preset.*(propertyDef->setter))(value);
+        }
+
+        return QDataStream::Ok == in.status();
+    }
+
+    // write the named properties of one type to a binary stream
+    template<typename T, std::size_t N>
+    static void emitBinaryProperties(QDataStream & out, const Qync::Preset & preset, const PresetProperties::Table<T, N> & properties)
+    {
+        out << static_cast<quint8>(properties.size());
+
+        for(const auto & propertyDef : properties) {
+            out << QByteArray(propertyDef.name.data(), static_cast<int>(propertyDef.name.size())) << (preset.*(propertyDef.getter))();
+        }
+    }
 }		// namespace Detail
 
 
@@ -124,19 +155,79 @@ namespace Qync::Detail::Preset {
  *   (copyHardlinksAsHardlinks(), rsync -H)
  * - whether or not an itemised list of changes should be generated
  *   (showItemisedChanges(), rsync -i)
+ * - whether or not only the entries that have changed since the last successful
+ *   synchronisation are given to rsync (useSourceIndex(), see SourceIndex)
+ * - whether or not a local source is copied to a local destination without
+ *   rsync where possible (useLocalCopier(), see LocalCopier)
  * - the log file for the standard output of the rsync command (logFile()).
+ * - the size in MiB at which the log file is rotated, or 0 not to rotate it
+ *   (logRotationSize()), and how many rotated logs to keep
+ *   (logRotationCount()).
+ * - the number of rsync processes to run concurrently for a parallel run
+ *   (shardCount()).
+ * - the compression algorithm and level to use when compression is used, or
+ *   rsync's defaults (compressionAlgorithm(), compressionLevel(), rsync
+ *   --compress-choice and --compress-level)
+ * - the checksum algorithm, or rsync's default (checksumAlgorithm(), rsync
+ *   --checksum-choice)
+ * - the block size for the delta-transfer algorithm, or rsync's default
+ *   (blockSize(), rsync --block-size)
+ * - whether or not files are always sent whole rather than as deltas
+ *   (transferWholeFiles(), rsync -W)
+ * - whether or not destination files are updated in place (updateInPlace(),
+ *   rsync --inplace) and whether or not data is appended to shorter
+ *   destination files (appendVerify(), rsync --append-verify)
+ * - the bandwidth limit, the times of day at which other limits apply and
+ *   whether the limit adapts to other traffic on the link (bandwidthLimit(),
+ *   bandwidthSchedule(), adaptiveBandwidth(), rsync --bwlimit; see Process)
+ * - how many times and how soon rsync is run again after losing its connection
+ *   (retryAttempts(), retryDelay(); see Process), and where partly transferred
+ *   files are kept (partialDirectory(), rsync --partial-dir)
+ * - whether each run makes a dated snapshot of the source in the destination,
+ *   sharing unchanged files with the previous snapshot, and how many hourly,
+ *   daily and weekly snapshots are kept (snapshots(), keepHourlySnapshots(),
+ *   keepDailySnapshots(), keepWeeklySnapshots(), rsync --link-dest; see
+ *   SnapshotSet)
+ * - the remote shell for remote sources and destinations, the cipher ssh
+ *   uses and whether runs share ssh connections, and for how long an idle
+ *   shared connection stays open (remoteShell(), sshCipher(),
+ *   shareSshConnections(), sshConnectionLifetime(), rsync --rsh; see
+ *   RemoteShell)
+ * - whether remote sources and destinations are reached through an rsync
+ *   daemon rather than a remote shell, and the daemon's port
+ *   (useRsyncDaemon(), rsyncDaemonPort(), rsync --port)
+ * - the other destinations the source is replicated to in the same run, and
+ *   how many of them are synchronised at a time (fanOutDestinations(),
+ *   fanOutConcurrency(); see Process)
  * - the source and destination for the rsync process (source(), destination())
  *
  * In addition, it provides (protected) methods to write and read the preset to
  * and from an XML stream (parseXml(), emitXml()), and to write and read that
  * stream to and from a file (load(), save(), saveAs(), saveCopyAs()).
  *
+ * Files can also hold the preset in a compact binary form (emitBinary(),
+ * parseBinary()). load() reads either format, and records which one it found
+ * in fileFormat(); the save methods write the format set with setFileFormat().
+ * New presets use XML, which is also the format for exporting presets.
+ *
  * A Preset object is just a container for settings. It does not _do_ anything
  * itself. An object of this class is provided to a Process object in order for
  * the Process to set up the rsync command. A set of Preset objects is kept by
  * the Application instance as the master set of presets available during a
  * session. These can be retrieved individually using Application::preset() or
  * as a complete set using Application::presets().
+ *
+ * Presets in the set that haven't been used yet may only have their name and
+ * file name available (see setUnloaded(), isLoaded()). Application::preset()
+ * loads the rest of the settings before returning the preset; code working with
+ * the complete set should only rely on the name, or call ensureLoaded().
+ *
+ * Every change to a setting that affects how rsync is run gives the preset a
+ * new revision(). Revisions are never reused, even by different presets, so a
+ * Process that has built its rsync arguments from a preset can tell from the
+ * revision alone whether they are still valid (see Process::rearm()). The
+ * name, file name and file format don't affect a run and don't change the
+ * revision.
  */
 
 /**
@@ -146,6 +237,7 @@ namespace Qync::Detail::Preset {
  */
 Preset::Preset(const QString & name)
 :	m_fileName(QStringLiteral()),
+	m_fileFormat(FileFormat::Xml),
 	m_name(QStringLiteral()),
 	m_source(QStringLiteral()),
 	m_dest(QStringLiteral()),
@@ -167,7 +259,39 @@ Preset::Preset(const QString & name)
 	m_dontMapUidGid(false),
 	m_copyHardlinksAsHardlinks(false),
 	m_showItemisedChanges(false),
-    m_logFile(QStringLiteral())
+	m_useSourceIndex(false),
+	m_useLocalCopier(false),
+    m_logFile(QStringLiteral()),
+    m_logRotationSize(0),
+    m_logRotationCount(5),
+    m_shardCount(1),
+    m_compressionAlgorithm(),
+    m_compressionLevel(0),
+    m_checksumAlgorithm(),
+    m_blockSize(0),
+    m_wholeFile(false),
+    m_inPlace(false),
+    m_appendVerify(false),
+    m_bandwidthLimit(0),
+    m_bandwidthSchedule(),
+    m_adaptiveBandwidth(false),
+    m_retryAttempts(0),
+    m_retryDelay(Detail::Preset::DefaultRetryDelay),
+    m_partialDirectory(),
+    m_snapshots(false),
+    m_keepHourlySnapshots(0),
+    m_keepDailySnapshots(0),
+    m_keepWeeklySnapshots(0),
+    m_remoteShell(),
+    m_sshCipher(),
+    m_shareSshConnections(false),
+    m_sshConnectionLifetime(0),
+    m_useRsyncDaemon(false),
+    m_rsyncDaemonPort(0),
+    m_fanOutDestinations(),
+    m_fanOutConcurrency(0),
+    m_loaded(true),
+    m_revision(nextRevision())
 {
     setName(name);
 }
@@ -182,9 +306,10 @@ Preset::~Preset() = default;
  *
  * @param fileName is the path to the file to load.
  *
- * If the file is a valid Preset file, the file is loaded into the preset
- * object. If not, the preset is reset to its default state (which is not
- * necessarily the same state as it was before the call).
+ * If the file is a valid Preset file, in either the XML or the binary format,
+ * the file is loaded into the preset object and fileFormat() is set to the
+ * format it was in. If not, the preset is reset to its default state (which is
+ * not necessarily the same state as it was before the call).
  *
  * @return @b true if the file was loaded successfully, @b false otherwise.
  */
@@ -201,6 +326,22 @@ bool Preset::load(const QString & fileName)
     }
 
     setFileName(fileName);
+
+    if(file.peek(4) == QByteArrayLiteral("QYNB")) {
+        QDataStream in(&file);
+
+        if(parseBinary(in)) {
+            m_fileFormat = FileFormat::Binary;
+            m_loaded = true;
+            return true;
+        }
+
+        qCritical() << __PRETTY_FUNCTION__ << "file" << fileName << "does not contain a valid binary qync preset";
+        setDefaults();
+        return false;
+    }
+
+    m_fileFormat = FileFormat::Xml;
     QXmlStreamReader xml(&file);
 
     while(!xml.atEnd()) {
@@ -208,6 +349,7 @@ bool Preset::load(const QString & fileName)
 
         if(xml.isStartElement()) {
             if("qyncpreset" == xml.name() && parseXml(xml)) {
+                m_loaded = true;
                 return true;
             }
             else {
@@ -221,6 +363,52 @@ bool Preset::load(const QString & fileName)
     return false;
 }
 
+/**
+ * @brief Make the preset a placeholder for a file that has not been loaded.
+ *
+ * @param fileName is the path to the preset file.
+ * @param name is the name of the preset in the file.
+ *
+ * The preset is reset to its default state apart from its name and file name,
+ * and is marked as not loaded. This is enough to list the preset without
+ * parsing the file; ensureLoaded() reads the rest of the settings from the file
+ * when they are needed. An unloaded preset can not be saved.
+ */
+void Preset::setUnloaded(const QString & fileName, const QString & name)
+{
+    setDefaults();
+    setFileName(fileName);
+    setName(name);
+    m_loaded = false;
+}
+
+/**
+ * @brief Load the preset's settings from its file if that hasn't been done yet.
+ *
+ * Presets are always loaded unless they have been made placeholders using
+ * setUnloaded(). If the file can no longer be loaded, the preset keeps its name
+ * and file name and remains unloaded.
+ *
+ * @return @b true if the preset is loaded, @b false otherwise.
+ */
+bool Preset::ensureLoaded()
+{
+    if(m_loaded) {
+        return true;
+    }
+
+    QString fileName = m_fileName;
+    QString name = m_name;
+
+    if(!load(fileName)) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to load preset" << name << "from" << fileName;
+        setUnloaded(fileName, name);
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * @brief Save the preset to a new file.
  *
@@ -237,8 +425,7 @@ bool Preset::saveAs(const QString & fileName)
         return false;
     }
 
-    m_fileName = fileName;
-    return true;
+    return updateSetting(m_fileName, fileName);
 }
 
 /**
@@ -253,12 +440,22 @@ bool Preset::saveAs(const QString & fileName)
  */
 bool Preset::saveCopyAs(const QString & fileName) const
 {
+    if(!m_loaded) {
+        qWarning() << __PRETTY_FUNCTION__ << "preset" << m_name << "has not been loaded from" << m_fileName;
+        return false;
+    }
+
     QFile file(fileName);
 
     if(!file.open(QIODevice::WriteOnly)) {
         return false;
     }
 
+    if(FileFormat::Binary == m_fileFormat) {
+        QDataStream out(&file);
+        return emitBinary(out);
+    }
+
     QXmlStreamWriter xml(&file);
     xml.setAutoFormatting(true);
     return emitXml(xml);
@@ -337,8 +534,8 @@ bool Preset::emitDestinationXml(QXmlStreamWriter & xml) const
  * @param xml is the stream to write to.
  *
  * Most of the settings in a preset are implemented using a basic properties
- * system. The properties are defined in a map in the PresetDetail private
- * namespace. Each property has a name, a getter and a setter. This function
+ * system. The properties are defined in the tables in presetproperties.h.
+ * Each property has a name, a getter and a setter. This function
  * iterates over the defined properties and emits a &lt;property&gt; element
  * to the XML stream for each with the appropriate name and type attributes,
  * and the value set according to the value provided by the property's getter.
@@ -350,19 +547,27 @@ bool Preset::emitPropertiesXml(QXmlStreamWriter & xml) const
 {
     xml.writeStartElement("properties");
 
-    for(const auto & propertyDef : Detail::Preset::booleanPresetProperties) {
+    for(const auto & propertyDef : PresetProperties::booleanProperties) {
         xml.writeStartElement("property");
-        xml.writeAttribute("name", QString::fromStdString(propertyDef.first));
+        xml.writeAttribute("name", QString::fromLatin1(propertyDef.name.data(), static_cast<int>(propertyDef.name.size())));
         xml.writeAttribute("type", "boolean");
-        xml.writeCharacters((this->*(propertyDef.second.getter))() ? "true" : "false");
+        xml.writeCharacters((this->*(propertyDef.getter))() ? "true" : "false");
         xml.writeEndElement();  // property
     }
 
-    for(const auto & propertyDef : Qync::Detail::Preset::stringPresetProperties) {
+    for(const auto & propertyDef : PresetProperties::stringProperties) {
         xml.writeStartElement("property");
-        xml.writeAttribute("name", QString::fromStdString(propertyDef.first));
+        xml.writeAttribute("name", QString::fromLatin1(propertyDef.name.data(), static_cast<int>(propertyDef.name.size())));
         xml.writeAttribute("type", "string");
-        xml.writeCharacters((this->*(propertyDef.second.getter))());
+        xml.writeCharacters((this->*(propertyDef.getter))());
+        xml.writeEndElement();  // property
+    }
+
+    for(const auto & propertyDef : PresetProperties::integerProperties) {
+        xml.writeStartElement("property");
+        xml.writeAttribute("name", QString::fromLatin1(propertyDef.name.data(), static_cast<int>(propertyDef.name.size())));
+        xml.writeAttribute("type", "integer");
+        xml.writeCharacters(QString::number((this->*(propertyDef.getter))()));
         xml.writeEndElement();  // property
     }
 
@@ -475,9 +680,9 @@ bool Preset::parsePropertyXml(QXmlStreamReader & xml)
     auto propValueString = xml.readElementText();
 
     if(0 == QString::compare("boolean", propType, Qt::CaseInsensitive)) {
-        auto propertyDef = Qync::Detail::Preset::booleanPresetProperties.find(propName.toString().toStdString());
+        const auto * propertyDef = PresetProperties::booleanProperties.find(propName);
 
-        if(propertyDef == Qync::Detail::Preset::booleanPresetProperties.end()) {
+        if(!propertyDef) {
             qWarning() << __PRETTY_FUNCTION__ << "unrecognised boolean property" << propName << "found at line" << xml.lineNumber();
             return false;
         }
@@ -495,17 +700,35 @@ bool Preset::parsePropertyXml(QXmlStreamReader & xml)
             return false;
         }
 
-        (this->*(propertyDef->second.setter))(propValue);
+        (this->*(propertyDef->setter))(propValue);
     }
     else if(0 == QString::compare("string", propType, Qt::CaseInsensitive)) {
-        auto propertyDef = Qync::Detail::Preset::stringPresetProperties.find(propName.toString().toStdString());
+        const auto * propertyDef = PresetProperties::stringProperties.find(propName);
 
-        if(propertyDef == Qync::Detail::Preset::stringPresetProperties.end()) {
+        if(!propertyDef) {
             qWarning() << __PRETTY_FUNCTION__ << "unrecognised string property" << propName << "found at line" << xml.lineNumber();
             return false;
         }
 
-        (this->*(propertyDef->second.setter))(propValueString);
+        (this->*(propertyDef->setter))(propValueString);
+    }
+    else if(0 == QString::compare("integer", propType, Qt::CaseInsensitive)) {
+        const auto * propertyDef = PresetProperties::integerProperties.find(propName);
+
+        if(!propertyDef) {
+            qWarning() << __PRETTY_FUNCTION__ << "unrecognised integer property" << propName << "found at line" << xml.lineNumber();
+            return false;
+        }
+
+        bool ok;
+        int propValue = propValueString.trimmed().toInt(&ok);
+
+        if(!ok) {
+            qWarning() << __PRETTY_FUNCTION__ << "Preset::parsePropertyXml() - invalid value" << propValueString << "for integer property" << propName << "at line" << xml.lineNumber() << "column" << xml.columnNumber();
+            return false;
+        }
+
+        (this->*(propertyDef->setter))(propValue);
     }
     else {
         qWarning() << __PRETTY_FUNCTION__ << "unrecognised property type" << propType << "for property" << propName << "found at line" << xml.lineNumber();
@@ -515,6 +738,70 @@ bool Preset::parsePropertyXml(QXmlStreamReader & xml)
     return true;
 }
 
+/**
+ * @brief Write the preset to a binary stream.
+ *
+ * @param out is the stream to write to.
+ *
+ * The stream starts with a header identifying the binary format and its
+ * version, followed by the name, source and destination and then each of the
+ * properties that are written to XML as a name and value pair, so that
+ * properties can be added without breaking older files.
+ *
+ * @return @b true if the preset was written to the stream, @b false otherwise.
+ */
+bool Preset::emitBinary(QDataStream & out) const
+{
+    out.setVersion(Detail::Preset::BinaryStreamVersion);
+    out << Detail::Preset::BinaryMagic << Detail::Preset::BinaryVersion << m_name << m_source << m_dest;
+    Detail::Preset::emitBinaryProperties(out, *this, PresetProperties::booleanProperties);
+    Detail::Preset::emitBinaryProperties(out, *this, PresetProperties::stringProperties);
+    Detail::Preset::emitBinaryProperties(out, *this, PresetProperties::integerProperties);
+    return QDataStream::Ok == out.status();
+}
+
+/**
+ * @brief Read the preset from a binary stream.
+ *
+ * @param in is the stream to read from.
+ *
+ * The preset is reset to its default state before it is read. Unrecognised
+ * properties are skipped.
+ *
+ * @return @b true if the preset was read, @b false if the stream does not
+ * contain a valid binary preset.
+ */
+bool Preset::parseBinary(QDataStream & in)
+{
+    in.setVersion(Detail::Preset::BinaryStreamVersion);
+    quint32 magic;
+    quint32 version;
+    in >> magic >> version;
+
+    if(QDataStream::Ok != in.status() || Detail::Preset::BinaryMagic != magic || Detail::Preset::BinaryVersion < version) {
+        qWarning() << __PRETTY_FUNCTION__ << "not a binary preset, or a version newer than" << Detail::Preset::BinaryVersion;
+        return false;
+    }
+
+    setDefaults();
+    QString name;
+    QString source;
+    QString dest;
+    in >> name >> source >> dest;
+
+    if(QDataStream::Ok != in.status()) {
+        return false;
+    }
+
+    setName(name);
+    setSource(source);
+    setDestination(dest);
+
+    return Detail::Preset::parseBinaryProperties(in, *this, PresetProperties::booleanProperties)
+           && Detail::Preset::parseBinaryProperties(in, *this, PresetProperties::stringProperties)
+           && Detail::Preset::parseBinaryProperties(in, *this, PresetProperties::integerProperties);
+}
+
 /**
  * @brief Set all settings to default values.
  */
@@ -544,8 +831,82 @@ void Preset::setDefaults() {
     m_dontMapUidGid = false;
     m_copyHardlinksAsHardlinks = false;
     m_showItemisedChanges = false;
+    m_useSourceIndex = false;
+    m_useLocalCopier = false;
 
     m_logFile = QStringLiteral();
+    m_logRotationSize = 0;
+    m_logRotationCount = 5;
+    m_shardCount = 1;
+
+    m_compressionAlgorithm = QStringLiteral();
+    m_compressionLevel = 0;
+    m_checksumAlgorithm = QStringLiteral();
+    m_blockSize = 0;
+    m_wholeFile = false;
+    m_inPlace = false;
+    m_appendVerify = false;
+
+    m_bandwidthLimit = 0;
+    m_bandwidthSchedule = QStringLiteral();
+    m_adaptiveBandwidth = false;
+
+    m_retryAttempts = 0;
+    m_retryDelay = Detail::Preset::DefaultRetryDelay;
+    m_partialDirectory = QStringLiteral();
+
+    m_snapshots = false;
+    m_keepHourlySnapshots = 0;
+    m_keepDailySnapshots = 0;
+    m_keepWeeklySnapshots = 0;
+
+    m_remoteShell = QStringLiteral();
+    m_sshCipher = QStringLiteral();
+    m_shareSshConnections = false;
+    m_sshConnectionLifetime = 0;
+    m_useRsyncDaemon = false;
+    m_rsyncDaemonPort = 0;
+    m_fanOutDestinations = QStringLiteral();
+    m_fanOutConcurrency = 0;
+    m_revision = nextRevision();
+}
+
+/**
+ * @brief Take all the settings from another preset.
+ *
+ * @param other The preset to copy the settings from.
+ *
+ * The source, destination and all the properties are copied. The name, file
+ * name and file format are not. The revision only changes if at least one of
+ * the settings is different, so a preset that is repeatedly filled from the
+ * same settings keeps the same revision.
+ */
+void Preset::assignSettings(const Preset & other)
+{
+    setSource(other.source());
+    setDestination(other.destination());
+
+    for(const auto & property : PresetProperties::booleanProperties) {
+        (this->*(property.setter))((other.*(property.getter))());
+    }
+
+    for(const auto & property : PresetProperties::stringProperties) {
+        (this->*(property.setter))((other.*(property.getter))());
+    }
+
+    for(const auto & property : PresetProperties::integerProperties) {
+        (this->*(property.setter))((other.*(property.getter))());
+    }
+}
+
+/**
+ * @brief Issue a new revision.
+ *
+ * @return A revision that has not been issued to any preset before.
+ */
+quint64 Preset::nextRevision()
+{
+    return ++Detail::Preset::lastRevision;
 }
 
 /**
@@ -581,8 +942,7 @@ void Preset::setFileName(const QString & fileName)
  */
 bool Preset::setSource(const QString & source)
 {
-    m_source = source;
-    return true;
+    return updateSetting(m_source, source);
 }
 
 /**
@@ -594,8 +954,7 @@ bool Preset::setSource(const QString & source)
  */
 bool Preset::setDestination(const QString & dest)
 {
-    m_dest = dest;
-    return true;
+    return updateSetting(m_dest, dest);
 }
 
 /**
@@ -607,8 +966,7 @@ bool Preset::setDestination(const QString & dest)
  */
 bool Preset::setPreserveTime(const bool & preserve)
 {
-    m_preserveTime = preserve;
-    return true;
+    return updateSetting(m_preserveTime, preserve);
 }
 
 /**
@@ -620,8 +978,7 @@ bool Preset::setPreserveTime(const bool & preserve)
  */
 bool Preset::setPreservePermissions(const bool & preserve)
 {
-    m_preservePerms = preserve;
-    return true;
+    return updateSetting(m_preservePerms, preserve);
 }
 
 /**
@@ -633,8 +990,7 @@ bool Preset::setPreservePermissions(const bool & preserve)
  */
 bool Preset::setPreserveOwner(const bool & preserve)
 {
-    m_preserveOwner = preserve;
-    return true;
+    return updateSetting(m_preserveOwner, preserve);
 }
 
 /**
@@ -646,8 +1002,7 @@ bool Preset::setPreserveOwner(const bool & preserve)
  */
 bool Preset::setPreserveGroup(const bool & preserve)
 {
-    m_preserveGroup = preserve;
-    return true;
+    return updateSetting(m_preserveGroup, preserve);
 }
 
 /**
@@ -663,8 +1018,7 @@ bool Preset::setPreserveGroup(const bool & preserve)
  */
 bool Preset::setWindowsCompatability(const bool & compatible)
 {
-    m_windowsCompatability = compatible;
-    return true;
+    return updateSetting(m_windowsCompatability, compatible);
 }
 
 /**
@@ -679,8 +1033,7 @@ bool Preset::setWindowsCompatability(const bool & compatible)
  */
 bool Preset::setHonourDeletions(const bool & honour)
 {
-    this->m_deleteOnDestination = honour;
-    return true;
+    return updateSetting(m_deleteOnDestination, honour);
 }
 
 /**
@@ -695,8 +1048,7 @@ bool Preset::setHonourDeletions(const bool & honour)
  */
 bool Preset::setAlwaysCompareChecksums(const bool & compare)
 {
-    m_alwaysChecksum = compare;
-    return true;
+    return updateSetting(m_alwaysChecksum, compare);
 }
 
 /**
@@ -711,8 +1063,7 @@ bool Preset::setAlwaysCompareChecksums(const bool & compare)
  */
 bool Preset::setIgnoreTimes(const bool & ignore)
 {
-    m_ignoreTimes = ignore;
-    return true;
+    return updateSetting(m_ignoreTimes, ignore);
 }
 
 /**
@@ -724,8 +1075,7 @@ bool Preset::setIgnoreTimes(const bool & ignore)
  */
 bool Preset::setPreserveDevices(const bool & preserve)
 {
-    m_preserveDevices = preserve;
-    return true;
+    return updateSetting(m_preserveDevices, preserve);
 }
 
 /**
@@ -737,8 +1087,7 @@ bool Preset::setPreserveDevices(const bool & preserve)
  */
 bool Preset::setKeepPartialTransfers(const bool & partial)
 {
-    m_keepParitalTransfers = partial;
-    return true;
+    return updateSetting(m_keepParitalTransfers, partial);
 }
 
 /**
@@ -753,8 +1102,7 @@ bool Preset::setKeepPartialTransfers(const bool & partial)
  */
 bool Preset::setCopySymlinksAsSymlinks(const bool & copyAsLinks)
 {
-    m_symlinksAsSymlinks = copyAsLinks;
-    return true;
+    return updateSetting(m_symlinksAsSymlinks, copyAsLinks);
 }
 
 /**
@@ -769,8 +1117,7 @@ bool Preset::setCopySymlinksAsSymlinks(const bool & copyAsLinks)
  */
 bool Preset::setMakeBackups(const bool & backups)
 {
-    m_makeBackups = backups;
-    return true;
+    return updateSetting(m_makeBackups, backups);
 }
 
 /**
@@ -785,8 +1132,7 @@ bool Preset::setMakeBackups(const bool & backups)
  */
 bool Preset::setUseTransferCompression(const bool & compress)
 {
-    m_compressInTransit = compress;
-    return true;
+    return updateSetting(m_compressInTransit, compress);
 }
 
 /**
@@ -804,10 +1150,10 @@ bool Preset::setUseTransferCompression(const bool & compress)
  */
 bool Preset::setOnlyUpdateExistingEntries(const bool & existingOnly)
 {
-    m_onlyUpdateExisting = existingOnly;
+    updateSetting(m_onlyUpdateExisting, existingOnly);
 
     if(existingOnly) {
-        m_dontUpdateExisting = false;
+        updateSetting(m_dontUpdateExisting, false);
     }
 
     return true;
@@ -826,10 +1172,10 @@ bool Preset::setOnlyUpdateExistingEntries(const bool & existingOnly)
  */
 bool Preset::setDontUpdateExistingEntries(const bool & noExisting)
 {
-    m_dontUpdateExisting = noExisting;
+    updateSetting(m_dontUpdateExisting, noExisting);
 
     if(noExisting) {
-        m_onlyUpdateExisting = false;
+        updateSetting(m_onlyUpdateExisting, false);
     }
 
     return true;
@@ -849,8 +1195,7 @@ bool Preset::setDontUpdateExistingEntries(const bool & noExisting)
  */
 bool Preset::setDontMapUsersAndGroups(const bool & dontMap)
 {
-    m_dontMapUidGid = dontMap;
-    return true;
+    return updateSetting(m_dontMapUidGid, dontMap);
 }
 
 /**
@@ -865,8 +1210,7 @@ bool Preset::setDontMapUsersAndGroups(const bool & dontMap)
  */
 bool Preset::setCopyHardlinksAsHardlinks(const bool & copyAsLinks)
 {
-    m_copyHardlinksAsHardlinks = copyAsLinks;
-    return true;
+    return updateSetting(m_copyHardlinksAsHardlinks, copyAsLinks);
 }
 
 /**
@@ -878,8 +1222,45 @@ bool Preset::setCopyHardlinksAsHardlinks(const bool & copyAsLinks)
  */
 bool Preset::setShowItemisedChanges(const bool & show)
 {
-    m_showItemisedChanges = show;
-    return true;
+    return updateSetting(m_showItemisedChanges, show);
+}
+
+/**
+ * @brief Set whether or not rsync is only given the entries that have changed
+ * since the last successful synchronisation.
+ *
+ * @param use indicates whether the source index should be used.
+ *
+ * When this is set, a Process keeps an index of a local source after each
+ * successful run and on the next run gives rsync only the entries that have
+ * changed, with --files-from. It is ignored for remote sources and for presets
+ * that honour deletions, ignore times or always compare checksums, since those
+ * need rsync to see the whole source. The destination must not be changed by
+ * anything else between runs.
+ *
+ * @return @b true if the setting was set, @b false otherwise.
+ */
+bool Preset::setUseSourceIndex(const bool & use)
+{
+    return updateSetting(m_useSourceIndex, use);
+}
+
+/**
+ * @brief Set whether a local source is copied without rsync.
+ *
+ * @param use indicates whether the local copier should be used.
+ *
+ * When this is set and both the source and the destination are local, a
+ * Process copies the source itself with a LocalCopier rather than running
+ * rsync, as long as the preset uses none of the rsync features the copier
+ * doesn't have (see LocalCopier::canCopy()). Otherwise, and for simulations,
+ * rsync is run as usual.
+ *
+ * @return @b true if the setting was set, @b false otherwise.
+ */
+bool Preset::setUseLocalCopier(const bool & use)
+{
+    return updateSetting(m_useLocalCopier, use);
 }
 
 /**
@@ -894,88 +1275,665 @@ bool Preset::setShowItemisedChanges(const bool & show)
  */
 bool Preset::setLogFile(const QString & fileName)
 {
-    m_logFile = fileName;
-    return true;
+    return updateSetting(m_logFile, fileName);
 }
 
 /**
- * @fn Preset::name()
- * @brief Get the name of the preset.
+ * @brief Set the size at which the log file is rotated.
  *
- * @return The name of the preset.
- */
-
-/**
- * @fn Preset::fileName()
- * @brief Get the file name of the preset.
+ * @param size is the size in MiB, or 0 to never rotate the log file.
  *
- * @return The current path to the file for the preset.
+ * When the log file reaches this size it is renamed with the suffix ".1" (any
+ * existing rotated logs having their suffixes incremented) and a new log file
+ * is started.
+ *
+ * @return @b true if the size was set, @c false if it is negative.
  */
+bool Preset::setLogRotationSize(const int & size)
+{
+    if(0 > size) {
+        qWarning() << __PRETTY_FUNCTION__ << "invalid log rotation size" << size;
+        return false;
+    }
+
+    return updateSetting(m_logRotationSize, size);
+}
 
 /**
- * @fn Preset::save()
- * @brief Save the preset to its internally stored file name.
+ * @brief Set how many rotated log files are kept.
  *
- * @return @b true if the preset file was saved, @b false otherwise.
+ * @param count is the number of rotated log files, not including the current
+ * one. It must be at least 1.
+ *
+ * @return @b true if the count was set, @c false if it is not valid.
  */
+bool Preset::setLogRotationCount(const int & count)
+{
+    if(1 > count) {
+        qWarning() << __PRETTY_FUNCTION__ << "invalid log rotation count" << count;
+        return false;
+    }
+
+    return updateSetting(m_logRotationCount, count);
+}
 
 /**
- * @fn Preset::source()
- * @brief Get the source location.
+ * @brief Set the number of rsync processes used for a parallel run.
  *
- * @return The source.
+ * @param count is the number of shards into which the source is split. It must
+ * be at least 1.
+ *
+ * This only affects processes created with Process::RunType::Parallel, and
+ * dry runs (Process::RunType::DryRun) of presets that don't honour deletions.
+ *
+ * @return @b true if the count was set, @c false if it is not valid.
  */
+bool Preset::setShardCount(const int & count)
+{
+    if(1 > count) {
+        qWarning() << __PRETTY_FUNCTION__ << "invalid shard count" << count;
+        return false;
+    }
+
+    return updateSetting(m_shardCount, count);
+}
 
 /**
- * @fn Preset::destination()
- * @brief Get the destination location.
+ * @brief Set the compression algorithm.
  *
- * @return The destination.
+ * @param algorithm is the name rsync knows the algorithm by (e.g. @b zstd or
+ * @b lz4), or an empty string to let rsync choose.
+ *
+ * This only has an effect if transfer compression is used. rsync 3.2.0 and
+ * later list the algorithms they support (see
+ * RsyncCapabilities::compressionAlgorithms()).
+ *
+ * @return @b true if the algorithm was set, @b false if it is not valid.
  */
+bool Preset::setCompressionAlgorithm(const QString & algorithm)
+{
+    if(algorithm.contains(' ')) {
+        qWarning() << __PRETTY_FUNCTION__ << "invalid compression algorithm" << algorithm;
+        return false;
+    }
+
+    return updateSetting(m_compressionAlgorithm, algorithm);
+}
 
 /**
- * @fn Preset::preserveTime()
- * @brief Get whether file timestamps should be preserved.
+ * @brief Set the compression level.
  *
- * @return @b true if timestamps should be preserved, @b false
- * otherwise.
+ * @param level is the level to give the compression algorithm, or 0 to use
+ * its default level. It must be between 0 and 22 (the highest zstd level;
+ * zlib only goes up to 9 and lz4 ignores the level).
+ *
+ * This only has an effect if transfer compression is used.
+ *
+ * @return @b true if the level was set, @c false if it is not valid.
  */
+bool Preset::setCompressionLevel(const int & level)
+{
+    if(0 > level || Detail::Preset::MaximumCompressionLevel < level) {
+        qWarning() << __PRETTY_FUNCTION__ << "invalid compression level" << level;
+        return false;
+    }
+
+    return updateSetting(m_compressionLevel, level);
+}
 
 /**
- * @fn Preset::preservePermissions()
- * @brief Get whether file permissions should be preserved.
+ * @brief Set the checksum algorithm.
  *
- * @return @b true if permissions should be preserved, @b false
- * otherwise.
+ * @param algorithm is the name rsync knows the algorithm by (e.g. @b xxh128 or
+ * @b md5), or an empty string to let rsync choose.
+ *
+ * The algorithm is used both for the block checksums of the delta-transfer
+ * algorithm and for comparing whole files when checksums are always compared.
+ * rsync 3.2.0 and later list the algorithms they support (see
+ * RsyncCapabilities::checksumAlgorithms()).
+ *
+ * @return @b true if the algorithm was set, @b false if it is not valid.
  */
+bool Preset::setChecksumAlgorithm(const QString & algorithm)
+{
+    if(algorithm.contains(' ')) {
+        qWarning() << __PRETTY_FUNCTION__ << "invalid checksum algorithm" << algorithm;
+        return false;
+    }
+
+    return updateSetting(m_checksumAlgorithm, algorithm);
+}
 
 /**
- * @fn Preset::preserveOwner()
- * @brief Get whether file ownership should be preserved.
+ * @brief Set the block size for the delta-transfer algorithm.
  *
- * @return @b true if ownership should be preserved, @b false
- * otherwise.
+ * @param size is the block size in bytes, or 0 to let rsync choose one for
+ * each file. It must not be more than 128 KiB, the largest block size rsync
+ * accepts.
+ *
+ * @return @b true if the size was set, @c false if it is not valid.
  */
+bool Preset::setBlockSize(const int & size)
+{
+    if(0 > size || Detail::Preset::MaximumBlockSize < size) {
+        qWarning() << __PRETTY_FUNCTION__ << "invalid block size" << size;
+        return false;
+    }
+
+    return updateSetting(m_blockSize, size);
+}
 
 /**
- * @fn Preset::preserveGroup()
- * @brief Get whether file group ownership should be preserved.
+ * @brief Set whether or not files are always transferred whole.
  *
- * @return @b true if group ownership should be preserved, @b false
- * otherwise.
+ * @param whole indicates whether files are sent whole.
+ *
+ * If this is set, the delta-transfer algorithm is not used and changed files
+ * are sent in full. This is usually quicker when the network is faster than
+ * the disks, and is what rsync does anyway when the source and destination are
+ * both local.
+ *
+ * @return @b true if the setting was set, @b false otherwise.
  */
+bool Preset::setTransferWholeFiles(const bool & whole)
+{
+    return updateSetting(m_wholeFile, whole);
+}
 
 /**
- * @fn Preset::windowsCompatability()
- * @brief Get whether Windows compatability should be used.
+ * @brief Set whether or not destination files are updated in place.
  *
- * @return @b true if Windows compatability should be used, @b false
- * otherwise.
+ * @param inPlace indicates whether files are updated in place.
+ *
+ * If this is set, changed data is written straight into the destination file
+ * instead of into a new copy that replaces it. This saves rewriting the
+ * unchanged parts of large files, but a file that is being updated is briefly
+ * inconsistent.
+ *
+ * @return @b true if the setting was set, @b false otherwise.
  */
+bool Preset::setUpdateInPlace(const bool & inPlace)
+{
+    return updateSetting(m_inPlace, inPlace);
+}
 
 /**
- * @fn Preset::honourDeletions()
- * @brief Get whether source tree deletions should be honoured.
+ * @brief Set whether or not data is appended to shorter destination files.
+ *
+ * @param append indicates whether data is appended.
+ *
+ * If this is set, a destination file that is shorter than its source is
+ * assumed to be identical to the start of it, so only the rest of the source
+ * is sent; the whole file is checksummed afterwards and sent again if it does
+ * not match. This suits files that only ever grow, such as logs. It needs
+ * rsync 3.0.0 or later, and implies updating in place.
+ *
+ * @return @b true if the setting was set, @b false otherwise.
+ */
+bool Preset::setAppendVerify(const bool & append)
+{
+    return updateSetting(m_appendVerify, append);
+}
+
+/**
+ * @brief Set the bandwidth limit.
+ *
+ * @param limit is the limit in KiB per second, or 0 for no limit.
+ *
+ * This is the limit outside the periods in the bandwidthSchedule().
+ *
+ * @return @b true if the limit was set, @c false if it is not valid.
+ */
+bool Preset::setBandwidthLimit(const int & limit)
+{
+    if(0 > limit || Detail::Preset::MaximumBandwidthLimit < limit) {
+        qWarning() << __PRETTY_FUNCTION__ << "invalid bandwidth limit" << limit;
+        return false;
+    }
+
+    return updateSetting(m_bandwidthLimit, limit);
+}
+
+/**
+ * @brief Set the times of day at which other bandwidth limits apply.
+ *
+ * @param schedule is the schedule, in the form BandwidthSchedule::fromString()
+ * reads, or an empty string for the bandwidthLimit() to apply all day.
+ *
+ * The schedule is stored as given so that it reads the same when it is edited
+ * again.
+ *
+ * @return @b true if the schedule was set, @c false if it is not valid.
+ */
+bool Preset::setBandwidthSchedule(const QString & schedule)
+{
+    if(!BandwidthSchedule::fromString(schedule)) {
+        qWarning() << __PRETTY_FUNCTION__ << "invalid bandwidth schedule" << schedule;
+        return false;
+    }
+
+    return updateSetting(m_bandwidthSchedule, schedule);
+}
+
+/**
+ * @brief Set whether or not the bandwidth limit adapts to other traffic.
+ *
+ * @param adaptive indicates whether the limit adapts.
+ *
+ * If this is set, the limit is lowered while the transfer is getting much less
+ * than its limit, which usually means something else is using the link, and
+ * raised again while it is using all of it. The limit never rises above the
+ * one that would apply otherwise. See AdaptiveBandwidth.
+ *
+ * @return @b true if the setting was set, @b false otherwise.
+ */
+bool Preset::setAdaptiveBandwidth(const bool & adaptive)
+{
+    return updateSetting(m_adaptiveBandwidth, adaptive);
+}
+
+/**
+ * @brief Set how many times rsync is run again after a transient failure.
+ *
+ * @param attempts is the number of retries, or 0 not to retry.
+ *
+ * A transient failure is one in which rsync loses its connection or times out.
+ * rsync is always given @b --partial when it might be retried, and each retry
+ * uses the files it was part way through as the basis for sending them. See
+ * Process.
+ *
+ * @return @b true if the number was set, @c false if it is not valid.
+ */
+bool Preset::setRetryAttempts(const int & attempts)
+{
+    if(0 > attempts || Detail::Preset::MaximumRetryAttempts < attempts) {
+        qWarning() << __PRETTY_FUNCTION__ << "invalid retry attempts" << attempts;
+        return false;
+    }
+
+    return updateSetting(m_retryAttempts, attempts);
+}
+
+/**
+ * @brief Set how long to wait before the first retry.
+ *
+ * @param delay is the delay in seconds. It doubles for each further retry.
+ *
+ * @return @b true if the delay was set, @c false if it is not valid.
+ */
+bool Preset::setRetryDelay(const int & delay)
+{
+    if(1 > delay || Detail::Preset::MaximumRetryDelay < delay) {
+        qWarning() << __PRETTY_FUNCTION__ << "invalid retry delay" << delay;
+        return false;
+    }
+
+    return updateSetting(m_retryDelay, delay);
+}
+
+/**
+ * @brief Set the directory in which rsync keeps partly transferred files.
+ *
+ * @param dir is the directory, usually relative to each destination directory,
+ * or an empty string for partly transferred files to be kept in place.
+ *
+ * rsync can't use a partial directory with updateInPlace() or appendVerify().
+ *
+ * @return @b true if the directory was set, @b false otherwise.
+ */
+bool Preset::setPartialDirectory(const QString & dir)
+{
+    return updateSetting(m_partialDirectory, dir);
+}
+
+/**
+ * @brief Set whether or not each run makes a snapshot of the source.
+ *
+ * @param snapshots indicates whether snapshots are made.
+ *
+ * If this is set, each run synchronises into a new subdirectory of the
+ * destination named for the time of the run, and files that haven't changed
+ * since the last snapshot are hard linked to it rather than copied. The
+ * destination must be local. Snapshots that the keepHourlySnapshots(),
+ * keepDailySnapshots() and keepWeeklySnapshots() rules don't keep are removed
+ * after each successful run. See SnapshotSet.
+ *
+ * @return @b true if the setting was set, @b false otherwise.
+ */
+bool Preset::setSnapshots(const bool & snapshots)
+{
+    return updateSetting(m_snapshots, snapshots);
+}
+
+/**
+ * @brief Set for how many of the most recent hours a snapshot is kept.
+ *
+ * @param count is the number of hours.
+ *
+ * The latest snapshot made in each hour is kept. If this and the daily and
+ * weekly rules are all 0, every snapshot is kept.
+ *
+ * @return @b true if the number was set, @c false if it is not valid.
+ */
+bool Preset::setKeepHourlySnapshots(const int & count)
+{
+    if(!Detail::Preset::isValidKeptSnapshots(count, __PRETTY_FUNCTION__)) {
+        return false;
+    }
+
+    return updateSetting(m_keepHourlySnapshots, count);
+}
+
+/**
+ * @brief Set for how many of the most recent days a snapshot is kept.
+ *
+ * @param count is the number of days.
+ *
+ * The latest snapshot made on each day is kept.
+ *
+ * @return @b true if the number was set, @c false if it is not valid.
+ */
+bool Preset::setKeepDailySnapshots(const int & count)
+{
+    if(!Detail::Preset::isValidKeptSnapshots(count, __PRETTY_FUNCTION__)) {
+        return false;
+    }
+
+    return updateSetting(m_keepDailySnapshots, count);
+}
+
+/**
+ * @brief Set for how many of the most recent weeks a snapshot is kept.
+ *
+ * @param count is the number of weeks.
+ *
+ * The latest snapshot made in each week is kept.
+ *
+ * @return @b true if the number was set, @c false if it is not valid.
+ */
+bool Preset::setKeepWeeklySnapshots(const int & count)
+{
+    if(!Detail::Preset::isValidKeptSnapshots(count, __PRETTY_FUNCTION__)) {
+        return false;
+    }
+
+    return updateSetting(m_keepWeeklySnapshots, count);
+}
+
+/**
+ * @brief Set the remote shell rsync uses to reach remote sources and
+ * destinations.
+ *
+ * @param shell is the command, with any arguments, or an empty string for
+ * rsync's default (ssh).
+ *
+ * rsync splits the command into arguments at spaces; arguments that contain
+ * spaces must be quoted. The cipher and connection sharing settings are added
+ * to the command if it runs ssh, and ignored otherwise. See RemoteShell.
+ *
+ * @return @b true if the shell was set, @b false otherwise.
+ */
+bool Preset::setRemoteShell(const QString & shell)
+{
+    return updateSetting(m_remoteShell, shell);
+}
+
+/**
+ * @brief Set the cipher ssh uses for remote sources and destinations.
+ *
+ * @param cipher is the cipher, or a comma-separated list of them in order of
+ * preference (e.g. @b aes128-gcm@openssh.com), or an empty string to let ssh
+ * choose.
+ *
+ * @return @b true if the cipher was set, @b false if it is not valid.
+ */
+bool Preset::setSshCipher(const QString & cipher)
+{
+    if(cipher.contains(' ')) {
+        qWarning() << __PRETTY_FUNCTION__ << "invalid ssh cipher" << cipher;
+        return false;
+    }
+
+    return updateSetting(m_sshCipher, cipher);
+}
+
+/**
+ * @brief Set whether or not runs share ssh connections.
+ *
+ * @param share indicates whether connections are shared.
+ *
+ * If this is set, the first run to reach a host over ssh leaves the connection
+ * open as a master for sshConnectionLifetime() seconds after it was last used,
+ * and later runs to the same host go through it rather than connecting and
+ * authenticating again. The connections are closed when Qync exits. See
+ * RemoteShell.
+ *
+ * @return @b true if the setting was set, @b false otherwise.
+ */
+bool Preset::setShareSshConnections(const bool & share)
+{
+    return updateSetting(m_shareSshConnections, share);
+}
+
+/**
+ * @brief Set how long an idle shared ssh connection stays open.
+ *
+ * @param lifetime is the time in seconds, or 0 for the default of
+ * RemoteShell::DefaultConnectionLifetime.
+ *
+ * @return @b true if the lifetime was set, @b false if it is not valid.
+ */
+bool Preset::setSshConnectionLifetime(const int & lifetime)
+{
+    if(0 > lifetime || Detail::Preset::MaximumSshConnectionLifetime < lifetime) {
+        qWarning() << __PRETTY_FUNCTION__ << "invalid ssh connection lifetime" << lifetime;
+        return false;
+    }
+
+    return updateSetting(m_sshConnectionLifetime, lifetime);
+}
+
+/**
+ * @brief Set whether or not remote sources and destinations are reached
+ * through an rsync daemon.
+ *
+ * @param use indicates whether a daemon is used.
+ *
+ * If this is set, a @b host:module/path source or destination is given to rsync
+ * as @b rsync://host/module/path, so rsync connects to the daemon on the host
+ * directly rather than through a remote shell. This avoids the cost of
+ * encrypting the transfer, e.g. on a trusted local network.
+ *
+ * @return @b true if the setting was set, @b false otherwise.
+ */
+bool Preset::setUseRsyncDaemon(const bool & use)
+{
+    return updateSetting(m_useRsyncDaemon, use);
+}
+
+/**
+ * @brief Set the port the rsync daemon listens on.
+ *
+ * @param port is the port, or 0 for rsync's default (873).
+ *
+ * This only has an effect if an rsync daemon is used.
+ *
+ * @return @b true if the port was set, @b false if it is not valid.
+ */
+bool Preset::setRsyncDaemonPort(const int & port)
+{
+    if(0 > port || Detail::Preset::MaximumPort < port) {
+        qWarning() << __PRETTY_FUNCTION__ << "invalid rsync daemon port" << port;
+        return false;
+    }
+
+    return updateSetting(m_rsyncDaemonPort, port);
+}
+
+/**
+ * @brief Set the other destinations the source is replicated to.
+ *
+ * @param destinations is the destinations, one per line, or an empty string to
+ * synchronise only to the destination().
+ *
+ * Each destination is synchronised with the source in the same run as the
+ * destination(), sharing the scan of the source and the list of entries that
+ * have changed. The destinations are stored trimmed, one per line, without
+ * blank lines or repeats.
+ *
+ * @return @b true if the destinations were set, @b false otherwise.
+ */
+bool Preset::setFanOutDestinations(const QString & destinations)
+{
+    QStringList list;
+
+    for(const auto & line : destinations.split(QLatin1Char('\n'))) {
+        if(auto destination = line.trimmed(); !destination.isEmpty() && !list.contains(destination)) {
+            list.push_back(std::move(destination));
+        }
+    }
+
+    return updateSetting(m_fanOutDestinations, list.join(QLatin1Char('\n')));
+}
+
+/**
+ * @brief Fetch the other destinations the source is replicated to.
+ *
+ * @return The destinations, in the order they were given.
+ */
+QStringList Preset::fanOutDestinationList() const
+{
+    if(m_fanOutDestinations.isEmpty()) {
+        return {};
+    }
+
+    return m_fanOutDestinations.split(QLatin1Char('\n'));
+}
+
+/**
+ * @brief Set how many destinations are synchronised at the same time.
+ *
+ * @param concurrency is the number of destinations, or 0 for all of them.
+ *
+ * This only has an effect if there are fanOutDestinations(). The
+ * destination() is always among the first to be synchronised; the others
+ * start, in order, as earlier ones finish.
+ *
+ * @return @b true if the number was set, @b false if it is not valid.
+ */
+bool Preset::setFanOutConcurrency(const int & concurrency)
+{
+    if(0 > concurrency || Detail::Preset::MaximumFanOutConcurrency < concurrency) {
+        qWarning() << __PRETTY_FUNCTION__ << "invalid fan-out concurrency" << concurrency;
+        return false;
+    }
+
+    return updateSetting(m_fanOutConcurrency, concurrency);
+}
+
+/**
+ * @fn Preset::name()
+ * @brief Get the name of the preset.
+ *
+ * @return The name of the preset.
+ */
+
+/**
+ * @fn Preset::fileName()
+ * @brief Get the file name of the preset.
+ *
+ * @return The current path to the file for the preset.
+ */
+
+/**
+ * @fn Preset::fileFormat()
+ * @brief Fetch the format the preset is saved in.
+ *
+ * @return The format of the file it was loaded from, or the format set with
+ * setFileFormat().
+ */
+
+/**
+ * @fn Preset::setFileFormat()
+ * @brief Set the format the preset is saved in.
+ *
+ * The format takes effect the next time the preset is saved.
+ *
+ * @param format The format.
+ */
+
+/**
+ * @fn Preset::isLoaded()
+ * @brief Check whether the preset's settings have been loaded.
+ *
+ * @return @b false if the preset is a placeholder created with setUnloaded()
+ * whose file has not been loaded yet, @b true otherwise.
+ */
+
+/**
+ * @fn Preset::save()
+ * @brief Save the preset to its internally stored file name.
+ *
+ * @return @b true if the preset file was saved, @b false otherwise.
+ */
+
+/**
+ * @fn Preset::source()
+ * @brief Get the source location.
+ *
+ * @return The source.
+ */
+
+/**
+ * @fn Preset::destination()
+ * @brief Get the destination location.
+ *
+ * @return The destination.
+ */
+
+/**
+ * @fn Preset::preserveTime()
+ * @brief Get whether file timestamps should be preserved.
+ *
+ * @return @b true if timestamps should be preserved, @b false
+ * otherwise.
+ */
+
+/**
+ * @fn Preset::preservePermissions()
+ * @brief Get whether file permissions should be preserved.
+ *
+ * @return @b true if permissions should be preserved, @b false
+ * otherwise.
+ */
+
+/**
+ * @fn Preset::preserveOwner()
+ * @brief Get whether file ownership should be preserved.
+ *
+ * @return @b true if ownership should be preserved, @b false
+ * otherwise.
+ */
+
+/**
+ * @fn Preset::preserveGroup()
+ * @brief Get whether file group ownership should be preserved.
+ *
+ * @return @b true if group ownership should be preserved, @b false
+ * otherwise.
+ */
+
+/**
+ * @fn Preset::windowsCompatability()
+ * @brief Get whether Windows compatability should be used.
+ *
+ * @return @b true if Windows compatability should be used, @b false
+ * otherwise.
+ */
+
+/**
+ * @fn Preset::honourDeletions()
+ * @brief Get whether source tree deletions should be honoured.
  *
  * @return @b true if source tree deletions should be honoured, @b false
  * otherwise.
@@ -1074,9 +2032,245 @@ bool Preset::setLogFile(const QString & fileName)
  * otherwise.
  */
 
+/**
+ * @fn Preset::useSourceIndex()
+ * @brief Get whether rsync should only be given the entries that have changed
+ * since the last successful synchronisation.
+ *
+ * @return @b true if the source index should be used, @b false otherwise.
+ */
+
+/**
+ * @fn Preset::useLocalCopier()
+ * @brief Get whether a local source should be copied to a local destination
+ * without rsync where possible.
+ *
+ * @return @b true if the local copier should be used, @b false otherwise.
+ */
+
 /**
  * @fn Preset::logFile()
  * @brief Get the log file.
  *
  * @return The path to the log file.
  */
+
+/**
+ * @fn Preset::logRotationSize()
+ * @brief Get the size at which the log file is rotated.
+ *
+ * @return The size in MiB, or 0 if the log file is never rotated.
+ */
+
+/**
+ * @fn Preset::logRotationCount()
+ * @brief Get how many rotated log files are kept.
+ *
+ * @return The number of rotated log files.
+ */
+
+/**
+ * @fn Preset::shardCount()
+ * @brief Get the number of rsync processes used for a parallel run.
+ *
+ * @return The number of shards.
+ */
+
+/**
+ * @fn Preset::compressionAlgorithm()
+ * @brief Get the compression algorithm.
+ *
+ * @return The name of the algorithm, or an empty string if rsync chooses.
+ */
+
+/**
+ * @fn Preset::compressionLevel()
+ * @brief Get the compression level.
+ *
+ * @return The level, or 0 for the algorithm's default level.
+ */
+
+/**
+ * @fn Preset::checksumAlgorithm()
+ * @brief Get the checksum algorithm.
+ *
+ * @return The name of the algorithm, or an empty string if rsync chooses.
+ */
+
+/**
+ * @fn Preset::blockSize()
+ * @brief Get the block size for the delta-transfer algorithm.
+ *
+ * @return The size in bytes, or 0 if rsync chooses.
+ */
+
+/**
+ * @fn Preset::transferWholeFiles()
+ * @brief Get whether files are always transferred whole.
+ *
+ * @return @b true if files are transferred whole, @b false otherwise.
+ */
+
+/**
+ * @fn Preset::updateInPlace()
+ * @brief Get whether destination files are updated in place.
+ *
+ * @return @b true if files are updated in place, @b false otherwise.
+ */
+
+/**
+ * @fn Preset::appendVerify()
+ * @brief Get whether data is appended to shorter destination files.
+ *
+ * @return @b true if data is appended, @b false otherwise.
+ */
+
+/**
+ * @fn Preset::bandwidthLimit()
+ * @brief Get the bandwidth limit.
+ *
+ * @return The limit in KiB per second, or 0 for no limit.
+ */
+
+/**
+ * @fn Preset::bandwidthSchedule()
+ * @brief Get the times of day at which other bandwidth limits apply.
+ *
+ * @return The schedule, or an empty string if there is none.
+ */
+
+/**
+ * @fn Preset::adaptiveBandwidth()
+ * @brief Get whether the bandwidth limit adapts to other traffic.
+ *
+ * @return @b true if the limit adapts, @b false otherwise.
+ */
+
+/**
+ * @fn Preset::retryAttempts()
+ * @brief Get how many times rsync is run again after a transient failure.
+ *
+ * @return The number of retries, or 0 if failures aren't retried.
+ */
+
+/**
+ * @fn Preset::retryDelay()
+ * @brief Get how long to wait before the first retry.
+ *
+ * @return The delay in seconds.
+ */
+
+/**
+ * @fn Preset::partialDirectory()
+ * @brief Get the directory in which rsync keeps partly transferred files.
+ *
+ * @return The directory, or an empty string if they are kept in place.
+ */
+
+/**
+ * @fn Preset::snapshots()
+ * @brief Get whether or not each run makes a snapshot of the source.
+ *
+ * @return @b true if snapshots are made, @b false otherwise.
+ */
+
+/**
+ * @fn Preset::keepHourlySnapshots()
+ * @brief Get for how many of the most recent hours a snapshot is kept.
+ *
+ * @return The number of hours.
+ */
+
+/**
+ * @fn Preset::keepDailySnapshots()
+ * @brief Get for how many of the most recent days a snapshot is kept.
+ *
+ * @return The number of days.
+ */
+
+/**
+ * @fn Preset::keepWeeklySnapshots()
+ * @brief Get for how many of the most recent weeks a snapshot is kept.
+ *
+ * @return The number of weeks.
+ */
+
+/**
+ * @fn Preset::remoteShell()
+ * @brief Get the remote shell rsync uses to reach remote sources and
+ * destinations.
+ *
+ * @return The command, or an empty string for rsync's default.
+ */
+
+/**
+ * @fn Preset::sshCipher()
+ * @brief Get the cipher ssh uses for remote sources and destinations.
+ *
+ * @return The cipher, or an empty string if ssh chooses.
+ */
+
+/**
+ * @fn Preset::shareSshConnections()
+ * @brief Get whether or not runs share ssh connections.
+ *
+ * @return @b true if connections are shared, @b false otherwise.
+ */
+
+/**
+ * @fn Preset::sshConnectionLifetime()
+ * @brief Get how long an idle shared ssh connection stays open.
+ *
+ * @return The time in seconds, or 0 for the default.
+ */
+
+/**
+ * @fn Preset::useRsyncDaemon()
+ * @brief Get whether or not remote sources and destinations are reached
+ * through an rsync daemon.
+ *
+ * @return @b true if a daemon is used, @b false otherwise.
+ */
+
+/**
+ * @fn Preset::rsyncDaemonPort()
+ * @brief Get the port the rsync daemon listens on.
+ *
+ * @return The port, or 0 for rsync's default.
+ */
+
+/**
+ * @fn Preset::fanOutDestinations()
+ * @brief Get the other destinations the source is replicated to.
+ *
+ * @return The destinations, one per line, or an empty string if there are none.
+ */
+
+/**
+ * @fn Preset::fanOutConcurrency()
+ * @brief Get how many destinations are synchronised at the same time.
+ *
+ * @return The number of destinations, or 0 for all of them.
+ */
+
+/**
+ * @fn Preset::revision()
+ * @brief Fetch the preset's revision.
+ *
+ * The revision changes whenever a setting that affects how rsync is run
+ * changes. No two presets ever share a revision.
+ *
+ * @return The revision.
+ */
+
+/**
+ * @fn Preset::updateSetting()
+ * @brief Helper for the setters to change a setting.
+ *
+ * @param setting The member holding the setting.
+ * @param value The new value.
+ *
+ * The preset is given a new revision if the value is different.
+ *
+ * @return @b true.
+ */
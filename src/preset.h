@@ -20,13 +20,20 @@
  * option since it would enable removal of the Qt dependency without
  * introducing another and the data to store is not particularly complex.
  * INI style files would be possible.
+ *
+ * Presets can now also be stored in a compact binary format (see
+ * Preset::FileFormat) which is much quicker to read and write than XML. It
+ * still uses Qt (QDataStream), so it doesn't help with de-coupling, and XML
+ * remains the format for exchanging presets.
  */
 
 #ifndef QYNC_PRESET_H
 #define QYNC_PRESET_H
 
 #include <QtCore/QString>
+#include <QtCore/QStringList>
 
+class QDataStream;
 class QXmlStreamReader;
 class QXmlStreamWriter;
 
@@ -34,6 +41,11 @@ namespace Qync {
 
 	class Preset final {
 	public:
+		enum class FileFormat : unsigned char {
+			Xml = 0,
+			Binary,
+		};
+
 		explicit Preset(const QString & = QStringLiteral());
 		Preset(const Preset &) = delete;
 		Preset(Preset &&) = default;
@@ -44,7 +56,18 @@ namespace Qync {
 		~Preset();
 
 		void setDefaults();
+		void assignSettings(const Preset & other);
 		bool load(const QString &);
+		void setUnloaded(const QString & fileName, const QString & name);
+		bool ensureLoaded();
+
+		[[nodiscard]] inline bool isLoaded() const {
+			return m_loaded;
+		}
+
+		[[nodiscard]] inline quint64 revision() const {
+			return m_revision;
+		}
 
 		inline bool save() const {
 			return saveCopyAs(m_fileName);
@@ -65,6 +88,14 @@ namespace Qync {
 			return m_fileName;
 		}
 
+		[[nodiscard]] inline FileFormat fileFormat() const {
+			return m_fileFormat;
+		}
+
+		inline void setFileFormat(FileFormat format) {
+			m_fileFormat = format;
+		}
+
 		bool setSource(const QString &);
 		bool setDestination(const QString &);
 		bool setPreserveTime(const bool &);
@@ -85,7 +116,37 @@ namespace Qync {
 		bool setDontMapUsersAndGroups(const bool &);
 		bool setCopyHardlinksAsHardlinks(const bool &);
 		bool setShowItemisedChanges(const bool &);
+		bool setUseSourceIndex(const bool &);
+		bool setUseLocalCopier(const bool &);
 		bool setLogFile(const QString &);
+		bool setLogRotationSize(const int &);
+		bool setLogRotationCount(const int &);
+		bool setShardCount(const int &);
+		bool setCompressionAlgorithm(const QString &);
+		bool setCompressionLevel(const int &);
+		bool setChecksumAlgorithm(const QString &);
+		bool setBlockSize(const int &);
+		bool setTransferWholeFiles(const bool &);
+		bool setUpdateInPlace(const bool &);
+		bool setAppendVerify(const bool &);
+		bool setBandwidthLimit(const int &);
+		bool setBandwidthSchedule(const QString &);
+		bool setAdaptiveBandwidth(const bool &);
+		bool setRetryAttempts(const int &);
+		bool setRetryDelay(const int &);
+		bool setPartialDirectory(const QString &);
+		bool setSnapshots(const bool &);
+		bool setKeepHourlySnapshots(const int &);
+		bool setKeepDailySnapshots(const int &);
+		bool setKeepWeeklySnapshots(const int &);
+		bool setRemoteShell(const QString &);
+		bool setSshCipher(const QString &);
+		bool setShareSshConnections(const bool &);
+		bool setSshConnectionLifetime(const int &);
+		bool setUseRsyncDaemon(const bool &);
+		bool setRsyncDaemonPort(const int &);
+		bool setFanOutDestinations(const QString &);
+		bool setFanOutConcurrency(const int &);
 
 		[[nodiscard]] inline const QString & source() const {
 			return m_source;
@@ -167,10 +228,132 @@ namespace Qync {
 			return m_showItemisedChanges;
 		}
 
+		[[nodiscard]] inline const bool & useSourceIndex() const {
+			return m_useSourceIndex;
+		}
+
+		[[nodiscard]] inline const bool & useLocalCopier() const {
+			return m_useLocalCopier;
+		}
+
 		inline const QString & logFile() const {
 			return m_logFile;
 		}
 
+		[[nodiscard]] inline const int & logRotationSize() const {
+			return m_logRotationSize;
+		}
+
+		[[nodiscard]] inline const int & logRotationCount() const {
+			return m_logRotationCount;
+		}
+
+		[[nodiscard]] inline const int & shardCount() const {
+			return m_shardCount;
+		}
+
+		[[nodiscard]] inline const QString & compressionAlgorithm() const {
+			return m_compressionAlgorithm;
+		}
+
+		[[nodiscard]] inline const int & compressionLevel() const {
+			return m_compressionLevel;
+		}
+
+		[[nodiscard]] inline const QString & checksumAlgorithm() const {
+			return m_checksumAlgorithm;
+		}
+
+		[[nodiscard]] inline const int & blockSize() const {
+			return m_blockSize;
+		}
+
+		[[nodiscard]] inline const bool & transferWholeFiles() const {
+			return m_wholeFile;
+		}
+
+		[[nodiscard]] inline const bool & updateInPlace() const {
+			return m_inPlace;
+		}
+
+		[[nodiscard]] inline const bool & appendVerify() const {
+			return m_appendVerify;
+		}
+
+		[[nodiscard]] inline const int & bandwidthLimit() const {
+			return m_bandwidthLimit;
+		}
+
+		[[nodiscard]] inline const QString & bandwidthSchedule() const {
+			return m_bandwidthSchedule;
+		}
+
+		[[nodiscard]] inline const bool & adaptiveBandwidth() const {
+			return m_adaptiveBandwidth;
+		}
+
+		[[nodiscard]] inline const int & retryAttempts() const {
+			return m_retryAttempts;
+		}
+
+		[[nodiscard]] inline const int & retryDelay() const {
+			return m_retryDelay;
+		}
+
+		[[nodiscard]] inline const QString & partialDirectory() const {
+			return m_partialDirectory;
+		}
+
+		[[nodiscard]] inline const bool & snapshots() const {
+			return m_snapshots;
+		}
+
+		[[nodiscard]] inline const int & keepHourlySnapshots() const {
+			return m_keepHourlySnapshots;
+		}
+
+		[[nodiscard]] inline const int & keepDailySnapshots() const {
+			return m_keepDailySnapshots;
+		}
+
+		[[nodiscard]] inline const int & keepWeeklySnapshots() const {
+			return m_keepWeeklySnapshots;
+		}
+
+		[[nodiscard]] inline const QString & remoteShell() const {
+			return m_remoteShell;
+		}
+
+		[[nodiscard]] inline const QString & sshCipher() const {
+			return m_sshCipher;
+		}
+
+		[[nodiscard]] inline const bool & shareSshConnections() const {
+			return m_shareSshConnections;
+		}
+
+		[[nodiscard]] inline const int & sshConnectionLifetime() const {
+			return m_sshConnectionLifetime;
+		}
+
+		[[nodiscard]] inline const bool & useRsyncDaemon() const {
+			return m_useRsyncDaemon;
+		}
+
+		[[nodiscard]] inline const int & rsyncDaemonPort() const {
+			return m_rsyncDaemonPort;
+		}
+
+		[[nodiscard]] inline const QString & fanOutDestinations() const {
+			return m_fanOutDestinations;
+		}
+
+		[[nodiscard]] QStringList fanOutDestinationList() const;
+
+		[[nodiscard]] inline const int & fanOutConcurrency() const {
+			return m_fanOutConcurrency;
+		}
+
 	protected:
 		bool emitXml(QXmlStreamWriter & xml) const;
 		bool emitNameXml(QXmlStreamWriter & xml) const;
@@ -182,8 +365,24 @@ namespace Qync {
 		bool parsePropertiesXml(QXmlStreamReader & xml);
 		bool parsePropertyXml(QXmlStreamReader & xml);
 
+		bool emitBinary(QDataStream & out) const;
+		bool parseBinary(QDataStream & in);
+
 	private:
+		template<typename T>
+		inline bool updateSetting(T & setting, const T & value) {
+			if(setting != value) {
+				setting = value;
+				m_revision = nextRevision();
+			}
+
+			return true;
+		}
+
+		[[nodiscard]] static quint64 nextRevision();
+
 		QString m_fileName;
+		FileFormat m_fileFormat;
 		QString m_name;
 
 		QString m_source;
@@ -210,8 +409,47 @@ namespace Qync {
 		bool m_dontMapUidGid;
 		bool m_copyHardlinksAsHardlinks;
 		bool m_showItemisedChanges;
+		bool m_useSourceIndex;
+		bool m_useLocalCopier;
 
 		QString m_logFile;
+		int m_logRotationSize;
+		int m_logRotationCount;
+
+		int m_shardCount;
+
+		QString m_compressionAlgorithm;
+		int m_compressionLevel;
+		QString m_checksumAlgorithm;
+		int m_blockSize;
+		bool m_wholeFile;
+		bool m_inPlace;
+		bool m_appendVerify;
+
+		int m_bandwidthLimit;
+		QString m_bandwidthSchedule;
+		bool m_adaptiveBandwidth;
+
+		int m_retryAttempts;
+		int m_retryDelay;
+		QString m_partialDirectory;
+
+		bool m_snapshots;
+		int m_keepHourlySnapshots;
+		int m_keepDailySnapshots;
+		int m_keepWeeklySnapshots;
+
+		QString m_remoteShell;
+		QString m_sshCipher;
+		bool m_shareSshConnections;
+		int m_sshConnectionLifetime;
+		bool m_useRsyncDaemon;
+		int m_rsyncDaemonPort;
+		QString m_fanOutDestinations;
+		int m_fanOutConcurrency;
+
+		bool m_loaded;
+		quint64 m_revision;
 	};
 
 }  // namespace Qync
@@ -0,0 +1,229 @@
+/**
+ * @file presetbundlereader.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the PresetBundleReader class.
+ */
+
+#include "presetbundlereader.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QIODevice>
+#include <QtCore/QSet>
+
+#include "functions.h"
+#include "preset.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::PresetBundleReader class.
+ */
+namespace Qync::Detail::PresetBundleReader {
+    // the newest bundle format this reader understands
+    static constexpr const int Version = 1;
+}  // namespace Qync::Detail::PresetBundleReader
+
+/**
+ * @class PresetBundleReader
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Reads presets one at a time from a preset bundle.
+ *
+ * A preset bundle is an XML document whose root @b qyncpresets element
+ * contains any number of @b qyncpreset elements, each exactly as found in a
+ * single preset file (see Preset::emitXml()). Bundles are written by
+ * PresetBundleWriter. The reader also accepts a single preset file, which it
+ * treats as a bundle of one.
+ *
+ * The bundle is read as a stream: readNext() parses just the next preset, so a
+ * bundle of any size can be read without holding more than one preset in
+ * memory. readAllInto() reads the remaining presets into a presets directory,
+ * allocating a file name for each from a single listing of the directory.
+ *
+ * If the bundle is not valid, reading stops at the problem; hasError() then
+ * returns @b true and errorString() describes it. The presets read before the
+ * problem are unaffected.
+ */
+
+/**
+ * @brief Create a reader for a bundle.
+ *
+ * @param in The device to read the bundle from. It must be open for reading
+ * and remain so for as long as the reader is used.
+ */
+PresetBundleReader::PresetBundleReader(QIODevice & in)
+:   m_xml(&in),
+    m_state(State::Start),
+    m_presetCount(0),
+    m_error()
+{
+}
+
+/**
+ * @brief Destroy the reader.
+ */
+PresetBundleReader::~PresetBundleReader() = default;
+
+/**
+ * @brief Read the next preset from the bundle.
+ *
+ * @param preset The preset to read into. Its file name is not changed.
+ *
+ * @return @b true if a preset was read, @b false if there are no more presets
+ * or the bundle is not valid (see hasError()).
+ */
+bool PresetBundleReader::readNext(Preset & preset)
+{
+    while(State::Finished != m_state && !m_xml.atEnd()) {
+        m_xml.readNext();
+
+        if(m_xml.isStartElement()) {
+            if(State::Start == m_state) {
+                if("qyncpreset" == m_xml.name()) {
+                    m_state = State::SinglePreset;
+                    return readPreset(preset);
+                }
+
+                if("qyncpresets" != m_xml.name()) {
+                    m_error = QStringLiteral("not a preset bundle (found \"%1\" element)").arg(m_xml.name().toString());
+                    m_state = State::Finished;
+                    return false;
+                }
+
+                bool ok;
+                const int version = m_xml.attributes().value("version").toInt(&ok);
+
+                if(!ok || Detail::PresetBundleReader::Version < version) {
+                    m_error = QStringLiteral("unsupported preset bundle version \"%1\"").arg(m_xml.attributes().value("version").toString());
+                    m_state = State::Finished;
+                    return false;
+                }
+
+                m_state = State::InBundle;
+            }
+            else if("qyncpreset" == m_xml.name()) {
+                return readPreset(preset);
+            }
+            else {
+                Qync::parseUnknownElementXml(m_xml);
+            }
+        }
+        else if(m_xml.isEndElement()) {
+            // the end of the root element: there's nothing more of interest
+            m_state = State::Finished;
+        }
+    }
+
+    if(m_xml.hasError() && m_error.isEmpty()) {
+        m_error = QStringLiteral("%1 at line %2 column %3").arg(m_xml.errorString()).arg(m_xml.lineNumber()).arg(m_xml.columnNumber());
+    }
+
+    m_state = State::Finished;
+    return false;
+}
+
+/**
+ * @brief Read the remaining presets into a presets directory.
+ *
+ * @param presetsDirectory The directory to save the presets in.
+ * @param presets The list to append the presets to.
+ * @param format The format to save the presets' files in.
+ *
+ * Each preset is saved in its own file in the directory, named @b presetN in
+ * the same way as those created by the application. The directory is listed
+ * once to find the names that are already taken; nothing else must create
+ * files in it while the presets are being read. Presets that can't be saved
+ * are skipped with a warning.
+ *
+ * @return The number of presets added to @b presets.
+ */
+int PresetBundleReader::readAllInto(const QString & presetsDirectory, std::vector<std::unique_ptr<Preset>> & presets, Preset::FileFormat format)
+{
+    const QDir dir(presetsDirectory);
+    QSet<QString> taken;
+
+    for(const auto & fileName : dir.entryList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot)) {
+        taken.insert(fileName);
+    }
+
+    int number = 0;
+    int added = 0;
+
+    while(true) {
+        auto preset = std::make_unique<Preset>();
+
+        if(!readNext(*preset)) {
+            break;
+        }
+
+        QString fileName;
+        preset->setFileFormat(format);
+
+        do {
+            fileName = QStringLiteral("preset") + QString::number(++number);
+        } while(taken.contains(fileName));
+
+        if(!preset->saveAs(dir.absoluteFilePath(fileName))) {
+            qWarning() << __PRETTY_FUNCTION__ << "failed to save preset" << preset->name() << "to" << dir.absoluteFilePath(fileName);
+            continue;
+        }
+
+        presets.push_back(std::move(preset));
+        ++added;
+    }
+
+    return added;
+}
+
+/**
+ * @brief Parse the preset element the stream is at.
+ *
+ * @param preset The preset to read into.
+ *
+ * @return @b true if the preset was read, @b false if the stream ended or was
+ * invalid before the end of the element.
+ */
+bool PresetBundleReader::readPreset(Preset & preset)
+{
+    preset.parseXml(m_xml);
+
+    if(m_xml.hasError()) {
+        m_error = QStringLiteral("%1 at line %2 column %3").arg(m_xml.errorString()).arg(m_xml.lineNumber()).arg(m_xml.columnNumber());
+        m_state = State::Finished;
+        return false;
+    }
+
+    if(State::SinglePreset == m_state) {
+        m_state = State::Finished;
+    }
+
+    ++m_presetCount;
+    return true;
+}
+
+/**
+ * @fn PresetBundleReader::presetCount()
+ * @brief Fetch the number of presets read so far.
+ *
+ * @return The number of presets.
+ */
+
+/**
+ * @fn PresetBundleReader::hasError()
+ * @brief Check whether reading stopped because the bundle is not valid.
+ *
+ * @return @b true if there was an error, @b false otherwise.
+ */
+
+/**
+ * @fn PresetBundleReader::errorString()
+ * @brief Fetch a description of the error that stopped reading.
+ *
+ * @return The description, or an empty string if there was no error.
+ */
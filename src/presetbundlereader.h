@@ -0,0 +1,67 @@
+/**
+ * @file presetbundlereader.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the PresetBundleReader class.
+ */
+
+#ifndef QYNC_PRESETBUNDLEREADER_H
+#define QYNC_PRESETBUNDLEREADER_H
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QString>
+#include <QtCore/QXmlStreamReader>
+
+#include "preset.h"
+
+class QIODevice;
+
+namespace Qync {
+
+	class PresetBundleReader final {
+	public:
+		explicit PresetBundleReader(QIODevice & in);
+		PresetBundleReader(const PresetBundleReader &) = delete;
+		PresetBundleReader(PresetBundleReader &&) = delete;
+		void operator=(const PresetBundleReader &) = delete;
+		void operator=(PresetBundleReader &&) = delete;
+		~PresetBundleReader();
+
+		bool readNext(Preset & preset);
+		int readAllInto(const QString & presetsDirectory, std::vector<std::unique_ptr<Preset>> & presets, Preset::FileFormat format = Preset::FileFormat::Xml);
+
+		[[nodiscard]] inline int presetCount() const {
+			return m_presetCount;
+		}
+
+		[[nodiscard]] inline bool hasError() const {
+			return !m_error.isEmpty();
+		}
+
+		[[nodiscard]] inline const QString & errorString() const {
+			return m_error;
+		}
+
+	private:
+		enum class State : unsigned char {
+			Start = 0,
+			InBundle,
+			SinglePreset,
+			Finished,
+		};
+
+		bool readPreset(Preset & preset);
+
+		QXmlStreamReader m_xml;
+		State m_state;
+		int m_presetCount;
+		QString m_error;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_PRESETBUNDLEREADER_H
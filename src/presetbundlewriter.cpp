@@ -0,0 +1,119 @@
+/**
+ * @file presetbundlewriter.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the PresetBundleWriter class.
+ */
+
+#include "presetbundlewriter.h"
+
+#include <QtCore/QIODevice>
+
+#include "preset.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::PresetBundleWriter class.
+ */
+namespace Qync::Detail::PresetBundleWriter {
+    // the bundle format written, recorded in the root element
+    static constexpr const int Version = 1;
+}  // namespace Qync::Detail::PresetBundleWriter
+
+/**
+ * @class PresetBundleWriter
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Writes presets one at a time to a preset bundle.
+ *
+ * See PresetBundleReader for a description of the bundle format. Each preset
+ * is written to the device as soon as write() is called, so a bundle of any
+ * size can be written without holding all the presets in memory. The bundle
+ * is complete once finish() has been called; the destructor calls it if
+ * necessary.
+ */
+
+/**
+ * @brief Create a writer for a bundle.
+ *
+ * @param out The device to write the bundle to. It must be open for writing
+ * and remain so for as long as the writer is used.
+ *
+ * The start of the bundle is written immediately.
+ */
+PresetBundleWriter::PresetBundleWriter(QIODevice & out)
+:   m_xml(&out),
+    m_presetCount(0),
+    m_finished(false)
+{
+    m_xml.setAutoFormatting(true);
+    m_xml.writeStartDocument();
+    m_xml.writeStartElement("qyncpresets");
+    m_xml.writeAttribute("version", QString::number(Detail::PresetBundleWriter::Version));
+}
+
+/**
+ * @brief Destroy the writer, finishing the bundle if necessary.
+ */
+PresetBundleWriter::~PresetBundleWriter()
+{
+    finish();
+}
+
+/**
+ * @brief Add a preset to the bundle.
+ *
+ * @param preset The preset to write. It must be loaded (see
+ * Preset::isLoaded()).
+ *
+ * @return @b true if the preset was written, @b false otherwise.
+ */
+bool PresetBundleWriter::write(const Preset & preset)
+{
+    Q_ASSERT_X(!m_finished, __PRETTY_FUNCTION__, "the bundle has already been finished");
+    Q_ASSERT_X(preset.isLoaded(), __PRETTY_FUNCTION__, "the preset has not been loaded");
+
+    if(!preset.emitXml(m_xml) || m_xml.hasError()) {
+        return false;
+    }
+
+    ++m_presetCount;
+    return true;
+}
+
+/**
+ * @brief Write the end of the bundle.
+ *
+ * Calling this more than once has no effect.
+ *
+ * @return @b true if the bundle was written without error, @b false otherwise.
+ */
+bool PresetBundleWriter::finish()
+{
+    if(!m_finished) {
+        m_xml.writeEndElement();
+        m_xml.writeEndDocument();
+        m_finished = true;
+    }
+
+    return !m_xml.hasError();
+}
+
+/**
+ * @fn PresetBundleWriter::presetCount()
+ * @brief Fetch the number of presets written so far.
+ *
+ * @return The number of presets.
+ */
+
+/**
+ * @fn PresetBundleWriter::hasError()
+ * @brief Check whether writing to the device has failed.
+ *
+ * @return @b true if there was an error, @b false otherwise.
+ */
@@ -0,0 +1,49 @@
+/**
+ * @file presetbundlewriter.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the PresetBundleWriter class.
+ */
+
+#ifndef QYNC_PRESETBUNDLEWRITER_H
+#define QYNC_PRESETBUNDLEWRITER_H
+
+#include <QtCore/QXmlStreamWriter>
+
+class QIODevice;
+
+namespace Qync {
+
+	class Preset;
+
+	class PresetBundleWriter final {
+	public:
+		explicit PresetBundleWriter(QIODevice & out);
+		PresetBundleWriter(const PresetBundleWriter &) = delete;
+		PresetBundleWriter(PresetBundleWriter &&) = delete;
+		void operator=(const PresetBundleWriter &) = delete;
+		void operator=(PresetBundleWriter &&) = delete;
+		~PresetBundleWriter();
+
+		bool write(const Preset & preset);
+		bool finish();
+
+		[[nodiscard]] inline int presetCount() const {
+			return m_presetCount;
+		}
+
+		[[nodiscard]] inline bool hasError() const {
+			return m_xml.hasError();
+		}
+
+	private:
+		QXmlStreamWriter m_xml;
+		int m_presetCount;
+		bool m_finished;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_PRESETBUNDLEWRITER_H
@@ -9,8 +9,13 @@
 
 #include "presetcombo.h"
 
+#include <QtWidgets/QCompleter>
+#include <QtWidgets/QLineEdit>
+#include <QtWidgets/QListView>
+
 #include "application.h"
 #include "preset.h"
+#include "presetlistmodel.h"
 
 using namespace Qync;
 
@@ -20,8 +25,9 @@ using namespace Qync;
  * class.
  */
 namespace Qync::Detail::PresetCombo {
-    static constexpr int NewPresetRole = Qt::UserRole + 1;
-    static constexpr int NewPresetTag = 99;
+    // the width of the combo box, in characters. the contents are not measured
+    // because that means laying out the name of every preset
+    static constexpr const int MinimumContentsLength = 24;
 }		// namespace Detail
 
 /**
@@ -32,18 +38,21 @@ namespace Qync::Detail::PresetCombo {
  *
  * @brief A combo box specialised for selecting a sync preset.
  *
- * The combo box listens for changes in the list of presets stored in the
- * Application and updates as required. If the list of presets is empty, it
- * presents a single "&lt;New Preset&gt;" item. The choice of this special
- * item can be determined by calling currentItemIsNewPreset(). If this
- * returns @b false, the currently-selected preset can be retrieved by
- * calling currentPreset().
+ * The combo box shows the Application's shared PresetListModel, so it follows
+ * changes in the list of presets one preset at a time without re-reading the
+ * list. If the list of presets is empty, no item is selected and the combo box
+ * shows "&lt;New Preset&gt;" as a placeholder. This can be determined by
+ * calling currentItemIsNewPreset(). If this returns @b false, the
+ * currently-selected preset can be retrieved by calling currentPreset().
  *
- * You can manually trigger the combo box to re-read the list of presets
- * in the Application by calling reset().
+ * The combo box is editable so that a preset can be found by typing part of
+ * its name: the presets whose names contain the text are offered for
+ * completion. Typing never creates an item; when editing finishes the text is
+ * put back to the name of the selected preset.
  *
  * It is not possible to add, insert, remove or clear items to/from the
- * combo box - the methods to do so have been explicitly deleted.
+ * combo box, or to replace its model - the methods to do so have been
+ * explicitly deleted.
  */
 
 /**
@@ -54,17 +63,40 @@ namespace Qync::Detail::PresetCombo {
 PresetCombo::PresetCombo(QWidget * parent)
 :   QComboBox(parent)
 {
-    refresh();
+    auto & model = qyncApp->presetModel();
+
+    // only the visible rows are laid out, whichever way the presets are listed
+    auto * view = new QListView(this);
+    view->setUniformItemSizes(true);
+    setView(view);
+    QComboBox::setModel(&model);
+    setSizeAdjustPolicy(QComboBox::AdjustToMinimumContentsLengthWithIcon);
+    setMinimumContentsLength(Detail::PresetCombo::MinimumContentsLength);
+
+    setEditable(true);
+    setInsertPolicy(QComboBox::NoInsert);
+    lineEdit()->setPlaceholderText(tr("<New Preset>"));
+
+    auto * completer = new QCompleter(&model, this);
+    completer->setCaseSensitivity(Qt::CaseInsensitive);
+    completer->setFilterMode(Qt::MatchContains);
+    completer->setCompletionMode(QCompleter::PopupCompletion);
+
+    if(auto * popup = qobject_cast<QListView *>(completer->popup()); popup) {
+        popup->setUniformItemSizes(true);
+    }
+
+    setCompleter(completer);
+
+    connect(lineEdit(), &QLineEdit::editingFinished, this, &PresetCombo::restoreCurrentText);
 
     connect(this, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), [this](int idx) {
         if(-1 == idx) {
-            // reset or no items
-            return;
-        }
+            if(0 == count()) {
+                // the last preset has gone, so the <new preset> placeholder is showing
+                Q_EMIT newPresetSelected();
+            }
 
-        if(itemData(idx, Detail::PresetCombo::NewPresetRole).toInt() == Detail::PresetCombo::NewPresetTag) {
-            // new selection is the <new preset> item
-            Q_EMIT newPresetSelected();
             return;
         }
 
@@ -75,16 +107,16 @@ PresetCombo::PresetCombo(QWidget * parent)
 /**
  * @brief Determine whether the current item is the "&lt;New Preset &gt;" item.
  *
- * The special "&lt;New Preset &gt;" item is the only item in the list when
- * there are no presets in the Application's master list. In all other cases,
- * this special item is absent.
+ * The special "&lt;New Preset &gt;" placeholder is shown when there are no
+ * presets in the Application's master list. In all other cases, a preset is
+ * selected.
  *
  * @return @b true if the special "new preset" item is selected, @b false
  * otherwise.
  */
 bool PresetCombo::currentItemIsNewPreset() const
 {
-    return currentData(Detail::PresetCombo::NewPresetRole).toInt() == Detail::PresetCombo::NewPresetTag;
+    return -1 == currentIndex();
 }
 
 /**
@@ -101,39 +133,12 @@ Preset & PresetCombo::currentPreset() const
 }
 
 /**
- * @brief Refresh the list of presets available in the combo box.
+ * @brief Put the text back to the name of the selected preset.
  *
- * On a call to this method the Application object is queried for the
- * presets, and the combo box items are replaced with those
- * representing the list of available presets.
+ * This discards any partial name that was typed to search for a preset but
+ * not completed.
  */
-void PresetCombo::refresh()
+void PresetCombo::restoreCurrentText()
 {
-    int selectedIndex = currentIndex();
-    QString name = currentText();
-    QComboBox::clear();
-    int idx = 0;
-
-    for (const auto & preset : qyncApp->presets()) {
-        QComboBox::addItem(preset->name());
-        ++idx;
-    }
-
-    if (0 == idx) {
-        QComboBox::insertItem(0, tr("<New Preset>"));
-        setItemData(0, Detail::PresetCombo::NewPresetTag, Detail::PresetCombo::NewPresetRole);
-    }
-
-    if (-1 == selectedIndex) {
-        return;
-    }
-
-    // try to preserve the previous selection
-    int nameIdx = findText(name);
-
-    if (-1 != nameIdx) {
-        setCurrentIndex(nameIdx);
-    } else if (count() <= selectedIndex) {
-        setCurrentIndex(selectedIndex);
-    }
+    setEditText(-1 == currentIndex() ? QString() : itemText(currentIndex()));
 }
@@ -29,6 +29,7 @@ namespace Qync {
 		void insertItems() = delete;
 		void removeItem() = delete;
 		void clear() = delete;
+		void setModel() = delete;
 
 		[[nodiscard]] bool currentItemIsNewPreset() const;
 		[[nodiscard]] Preset & currentPreset() const;
@@ -37,8 +38,8 @@ namespace Qync {
 		void currentPresetChanged(Preset &);
 		void newPresetSelected();
 
-	public Q_SLOTS:
-		void refresh();
+	private:
+		void restoreCurrentText();
 	};
 
 }  // namespace Qync
@@ -0,0 +1,228 @@
+/**
+ * @file presetindex.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the PresetIndex class.
+ */
+
+#include "presetindex.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::PresetIndex class.
+ */
+namespace Qync::Detail::PresetIndex {
+    static constexpr const quint32 Magic = 0x51594e50;  // "QYNP"
+    static constexpr const quint32 Version = 1;
+    static constexpr const QDataStream::Version StreamVersion = QDataStream::Qt_5_9;
+}  // namespace Qync::Detail::PresetIndex
+
+/**
+ * @class PresetIndex
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief A cache of the names of the preset files in the presets directory.
+ *
+ * Listing the presets only needs their names, but reading a name from a preset
+ * file means parsing its XML. The index records the name of each preset file
+ * along with the file's size and modification time when the name was read, so
+ * that the next time the presets are listed the name can be taken from the
+ * index for every file that hasn't changed, and the file itself is only parsed
+ * when the settings in it are needed (see Preset::ensureLoaded()).
+ *
+ * name() only returns a name if the file's size and modification time still
+ * match the index. Names read from files that have changed are recorded with
+ * setName(), and retainOnly() drops the files that no longer exist, so the
+ * index is brought up to date incrementally each time it is used. It is stored
+ * in a small binary file which save() only rewrites if it has changed.
+ */
+
+/**
+ * @brief Create an empty index.
+ *
+ * @param fileName The file the index is loaded from and saved to.
+ */
+PresetIndex::PresetIndex(QString fileName)
+:   m_fileName(std::move(fileName)),
+    m_records(),
+    m_modified(false)
+{
+}
+
+/**
+ * @brief Load the index from its file.
+ *
+ * If the file does not exist or is not a valid index, the index is left empty.
+ *
+ * @return @b true if the index was loaded, @b false otherwise.
+ */
+bool PresetIndex::load()
+{
+    m_records.clear();
+    m_modified = false;
+    QFile file(m_fileName);
+
+    if(!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(Detail::PresetIndex::StreamVersion);
+    quint32 magic;
+    quint32 version;
+    qint32 count;
+    in >> magic >> version >> count;
+
+    if(QDataStream::Ok != in.status() || Detail::PresetIndex::Magic != magic || Detail::PresetIndex::Version != version || 0 > count) {
+        qWarning() << __PRETTY_FUNCTION__ << m_fileName << "is not a valid preset index";
+        return false;
+    }
+
+    m_records.reserve(count);
+
+    for(qint32 index = 0; index < count; ++index) {
+        QString presetFileName;
+        Record record;
+        in >> presetFileName >> record.modified >> record.size >> record.name;
+
+        if(QDataStream::Ok != in.status()) {
+            qWarning() << __PRETTY_FUNCTION__ << m_fileName << "is truncated or corrupt";
+            m_records.clear();
+            return false;
+        }
+
+        m_records.insert(presetFileName, record);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Save the index to its file if it has changed.
+ *
+ * @return @b true if the index file is up to date, @b false if it could not be
+ * written.
+ */
+bool PresetIndex::save()
+{
+    if(!m_modified) {
+        return true;
+    }
+
+    if(!QDir().mkpath(QFileInfo(m_fileName).absolutePath())) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to create directory for" << m_fileName;
+        return false;
+    }
+
+    QSaveFile file(m_fileName);
+
+    if(!file.open(QIODevice::WriteOnly)) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to open" << m_fileName << ":" << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(Detail::PresetIndex::StreamVersion);
+    out << Detail::PresetIndex::Magic << Detail::PresetIndex::Version << static_cast<qint32>(m_records.size());
+
+    for(auto it = m_records.cbegin(); it != m_records.cend(); ++it) {
+        out << it.key() << it->modified << it->size << it->name;
+    }
+
+    if(QDataStream::Ok != out.status() || !file.commit()) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to write" << m_fileName << ":" << file.errorString();
+        return false;
+    }
+
+    m_modified = false;
+    return true;
+}
+
+/**
+ * @brief Look up the name of a preset.
+ *
+ * @param presetFile The preset file.
+ *
+ * @return The name, or no value if the file is not in the index or has changed
+ * since its name was recorded.
+ */
+std::optional<QString> PresetIndex::name(const QFileInfo & presetFile) const
+{
+    auto it = m_records.constFind(presetFile.absoluteFilePath());
+
+    if(m_records.cend() == it || it->size != presetFile.size() || it->modified != presetFile.lastModified().toMSecsSinceEpoch()) {
+        return {};
+    }
+
+    return it->name;
+}
+
+/**
+ * @brief Record the name of a preset.
+ *
+ * @param presetFile The preset file. Its current size and modification time
+ * are recorded with the name.
+ * @param name The name read from the file.
+ */
+void PresetIndex::setName(const QFileInfo & presetFile, const QString & name)
+{
+    m_records.insert(presetFile.absoluteFilePath(), {presetFile.lastModified().toMSecsSinceEpoch(), presetFile.size(), name});
+    m_modified = true;
+}
+
+/**
+ * @brief Forget a preset file.
+ *
+ * @param presetFileName The absolute path to the preset file.
+ */
+void PresetIndex::remove(const QString & presetFileName)
+{
+    if(0 < m_records.remove(presetFileName)) {
+        m_modified = true;
+    }
+}
+
+/**
+ * @brief Forget all the preset files except those given.
+ *
+ * @param presetFileNames The absolute paths to the preset files to keep.
+ */
+void PresetIndex::retainOnly(const QSet<QString> & presetFileNames)
+{
+    for(auto it = m_records.begin(); it != m_records.end();) {
+        if(presetFileNames.contains(it.key())) {
+            ++it;
+        }
+        else {
+            it = m_records.erase(it);
+            m_modified = true;
+        }
+    }
+}
+
+/**
+ * @fn PresetIndex::fileName()
+ * @brief Fetch the file the index is loaded from and saved to.
+ *
+ * @return The path to the file.
+ */
+
+/**
+ * @fn PresetIndex::isModified()
+ * @brief Check whether the index has changed since it was loaded or saved.
+ *
+ * @return @b true if it has changed, @b false otherwise.
+ */
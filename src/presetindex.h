@@ -0,0 +1,57 @@
+/**
+ * @file presetindex.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the PresetIndex class.
+ */
+
+#ifndef QYNC_PRESETINDEX_H
+#define QYNC_PRESETINDEX_H
+
+#include <optional>
+
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+
+class QFileInfo;
+
+namespace Qync {
+
+	class PresetIndex {
+	public:
+		explicit PresetIndex(QString fileName);
+
+		[[nodiscard]] inline const QString & fileName() const {
+			return m_fileName;
+		}
+
+		[[nodiscard]] inline bool isModified() const {
+			return m_modified;
+		}
+
+		bool load();
+		bool save();
+
+		[[nodiscard]] std::optional<QString> name(const QFileInfo & presetFile) const;
+		void setName(const QFileInfo & presetFile, const QString & name);
+		void remove(const QString & presetFileName);
+		void retainOnly(const QSet<QString> & presetFileNames);
+
+	private:
+		struct Record {
+			qint64 modified = 0;
+			qint64 size = 0;
+			QString name;
+		};
+
+		QString m_fileName;
+		QHash<QString, Record> m_records;
+		bool m_modified;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_PRESETINDEX_H
@@ -0,0 +1,150 @@
+/**
+ * @file presetlistmodel.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the PresetListModel class.
+ */
+
+#include "presetlistmodel.h"
+
+#include "application.h"
+#include "preset.h"
+
+using namespace Qync;
+
+/**
+ * @class PresetListModel
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief A list model of the presets stored in the Application.
+ *
+ * The model has one row for each preset, in the same order as
+ * Application::presets(), so a row can be passed directly to
+ * Application::preset(). The display role provides the preset's name and
+ * FileNameRole (also used for the tooltip) the path to its file. Only names
+ * and file names are read, so presets that haven't been loaded yet (see
+ * Preset::isLoaded()) stay that way.
+ *
+ * The model follows the Application's presetsAdded(), presetRemoved() and
+ * presetChanged() signals with row notifications, so the views using it only
+ * do the work for the presets that changed rather than rebuilding the whole
+ * list. The model is only reset when the Application replaces all of its
+ * presets (presetsReset()).
+ *
+ * The Application owns a single instance, shared by the PresetCombo and
+ * PresetMenu (see Application::presetModel()).
+ */
+
+/**
+ * @brief Create a model of an application's presets.
+ *
+ * @param app The application whose presets are modelled.
+ * @param parent The owning object.
+ */
+PresetListModel::PresetListModel(Application & app, QObject * parent)
+:   QAbstractListModel(parent),
+    m_app(app)
+{
+    connect(&m_app, &Application::presetsAdded, this, &PresetListModel::onPresetsAdded);
+    connect(&m_app, &Application::presetRemoved, this, &PresetListModel::onPresetRemoved);
+    connect(&m_app, &Application::presetChanged, this, &PresetListModel::onPresetChanged);
+    connect(&m_app, &Application::presetsReset, this, &PresetListModel::onPresetsReset);
+}
+
+/**
+ * @brief Destroy the model.
+ */
+PresetListModel::~PresetListModel() = default;
+
+/**
+ * @brief Fetch the number of presets.
+ *
+ * @param parent The parent index. Only the invalid (root) index has any rows.
+ *
+ * @return The number of presets.
+ */
+int PresetListModel::rowCount(const QModelIndex & parent) const
+{
+    if(parent.isValid()) {
+        return 0;
+    }
+
+    return m_app.presetCount();
+}
+
+/**
+ * @brief Fetch the data for a preset.
+ *
+ * @param index The index of the preset.
+ * @param role The role for which to fetch the data.
+ *
+ * @return The data, or an invalid QVariant if the index is not valid or the
+ * role is not supported.
+ */
+QVariant PresetListModel::data(const QModelIndex & index, int role) const
+{
+    if(!index.isValid() || index.parent().isValid() || 0 != index.column() || rowCount() <= index.row()) {
+        return {};
+    }
+
+    const auto & preset = *m_app.presets()[static_cast<Application::PresetList::size_type>(index.row())];
+
+    switch(role) {
+        case Qt::DisplayRole:
+        case Qt::EditRole:
+            return preset.name();
+
+        case Qt::ToolTipRole:
+        case FileNameRole:
+            return preset.fileName();
+    }
+
+    return {};
+}
+
+/**
+ * @brief Handler for when the application has added presets.
+ *
+ * @param first The index of the first new preset.
+ * @param last The index of the last new preset.
+ */
+void PresetListModel::onPresetsAdded(int first, int last)
+{
+    beginInsertRows({}, first, last);
+    endInsertRows();
+}
+
+/**
+ * @brief Handler for when the application has removed a preset.
+ *
+ * @param index The index the preset had.
+ */
+void PresetListModel::onPresetRemoved(int index)
+{
+    beginRemoveRows({}, index, index);
+    endRemoveRows();
+}
+
+/**
+ * @brief Handler for when the application has changed a preset.
+ *
+ * @param index The index of the preset.
+ */
+void PresetListModel::onPresetChanged(int index)
+{
+    const auto changed = this->index(index);
+    Q_EMIT dataChanged(changed, changed, {Qt::DisplayRole, Qt::EditRole, Qt::ToolTipRole, FileNameRole});
+}
+
+/**
+ * @brief Handler for when the application has replaced all of its presets.
+ */
+void PresetListModel::onPresetsReset()
+{
+    beginResetModel();
+    endResetModel();
+}
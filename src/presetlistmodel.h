@@ -0,0 +1,43 @@
+/**
+ * @file presetlistmodel.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the PresetListModel class.
+ */
+
+#ifndef QYNC_PRESETLISTMODEL_H
+#define QYNC_PRESETLISTMODEL_H
+
+#include <QtCore/QAbstractListModel>
+
+namespace Qync {
+
+	class Application;
+
+	class PresetListModel
+	: public QAbstractListModel {
+		Q_OBJECT
+
+	public:
+		static constexpr const int FileNameRole = Qt::UserRole;
+
+		explicit PresetListModel(Application & app, QObject * parent = nullptr);
+		~PresetListModel() override;
+
+		[[nodiscard]] int rowCount(const QModelIndex & parent = {}) const override;
+		[[nodiscard]] QVariant data(const QModelIndex & index, int role = Qt::DisplayRole) const override;
+
+	private:
+		void onPresetsAdded(int first, int last);
+		void onPresetRemoved(int index);
+		void onPresetChanged(int index);
+		void onPresetsReset();
+
+		Application & m_app;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_PRESETLISTMODEL_H
@@ -9,8 +9,14 @@
 
 #include "presetmenu.h"
 
+#include <algorithm>
+
+#include <QtWidgets/QLineEdit>
+#include <QtWidgets/QWidgetAction>
+
 #include "application.h"
 #include "preset.h"
+#include "presetlistmodel.h"
 
 using namespace Qync;
 
@@ -22,10 +28,17 @@ using namespace Qync;
  *
  * @brief A combo menu specialised for selecting a sync preset.
  *
- * The menu listens for changes in the list of presets stored in the
- * Application and updates as required. You can manually trigger the
- * menu to re-read the list of presets in the Application by calling
- * reset().
+ * The menu lists the presets in the Application's shared PresetListModel. It
+ * notes when the model changes but only rebuilds its items when it is about to
+ * be shown (or is already showing), so adding or removing presets costs
+ * nothing while the menu is closed. You can manually trigger the menu to
+ * rebuild its items by calling refresh().
+ *
+ * The first item in the menu is a filter box. Typing in it lists only the
+ * presets whose names contain the text. At most MaximumPresetActions presets
+ * are listed at once; if more match, a final disabled item says how many more
+ * there are, so that a very long list of presets doesn't make a menu too long
+ * to use or slow to open.
  *
  * When an item from the menu is selected by the user, the
  * presetTriggered() and presetIndexTriggered() signals are emitted.
@@ -46,33 +59,117 @@ using namespace Qync;
  * @param parent The owning parent widget.
  */
 PresetMenu::PresetMenu(QWidget * parent)
-:   QMenu(parent)
+:   QMenu(parent),
+    m_filterModel(),
+    m_filter(new QLineEdit(this)),
+    m_filterAction(new QWidgetAction(this)),
+    m_dirty(true)
 {
-    refresh();
+    auto & model = qyncApp->presetModel();
+    m_filterModel.setSourceModel(&model);
+    m_filterModel.setFilterCaseSensitivity(Qt::CaseInsensitive);
+
+    m_filter->setPlaceholderText(tr("Filter presets"));
+    m_filter->setClearButtonEnabled(true);
+    m_filterAction->setDefaultWidget(m_filter);
+    QMenu::addAction(m_filterAction);
+    QMenu::addSeparator();
+
+    connect(m_filter, &QLineEdit::textChanged, this, [this](const QString & text) {
+        m_filterModel.setFilterFixedString(text);
+        rebuild();
+    });
+
+    connect(&model, &QAbstractItemModel::rowsInserted, this, &PresetMenu::invalidate);
+    connect(&model, &QAbstractItemModel::rowsRemoved, this, &PresetMenu::invalidate);
+    connect(&model, &QAbstractItemModel::dataChanged, this, &PresetMenu::invalidate);
+    connect(&model, &QAbstractItemModel::modelReset, this, &PresetMenu::invalidate);
+
+    connect(this, &QMenu::aboutToShow, this, [this]() {
+        if(m_dirty) {
+            rebuild();
+        }
+
+        setActiveAction(m_filterAction);
+        m_filter->setFocus();
+    });
+
+    connect(this, &QMenu::aboutToHide, this, [this]() {
+        // the filter is for finding a preset this time; it starts empty next time
+        m_filter->clear();
+    });
 
     connect(this, &QMenu::triggered, [this](QAction * action) {
+        if(!action->data().isValid()) {
+            // the filter or the "more presets" item
+            return;
+        }
+
         int idx = action->data().toInt();
         Q_EMIT presetTriggered(qyncApp->preset(idx));
         Q_EMIT presetIndexTriggered(idx);
     });
-
-    connect(qyncApp, &Application::presetsChanged, this, &PresetMenu::refresh);
 }
 
 /**
  * @brief Refresh the list of presets available in the menu.
  *
- * On a call to this method the Application object is queried for the
- * presets, and the menu items are replaced with those representing
- * the list of available presets.
+ * The menu items are replaced with those representing the presets that match
+ * the filter.
  */
 void PresetMenu::refresh() {
-    QMenu::clear();
-    int idx = 0;
+    rebuild();
+}
 
-    for(const auto & preset : qyncApp->presets()) {
-        QAction * action = QMenu::addAction(preset->name());
-        action->setData(idx);
-        ++idx;
+/**
+ * @brief Note that the menu items no longer match the presets.
+ *
+ * The items are rebuilt immediately if the menu is showing, otherwise the next
+ * time it is about to be shown.
+ */
+void PresetMenu::invalidate()
+{
+    m_dirty = true;
+
+    if(isVisible()) {
+        rebuild();
+    }
+}
+
+/**
+ * @brief Rebuild the menu items from the filtered presets.
+ */
+void PresetMenu::rebuild()
+{
+    // keep the filter and its separator, which are always the first two
+    // actions, so that typing in the filter isn't interrupted
+    const auto oldActions = actions().mid(2);
+
+    for(auto * action : oldActions) {
+        QMenu::removeAction(action);
+        delete action;
+    }
+
+    const int rows = m_filterModel.rowCount();
+    const int shown = std::min(rows, MaximumPresetActions);
+
+    for(int row = 0; row < shown; ++row) {
+        const auto index = m_filterModel.index(row, 0);
+        QAction * action = QMenu::addAction(index.data(Qt::DisplayRole).toString());
+        action->setData(m_filterModel.mapToSource(index).row());
+    }
+
+    if(shown < rows) {
+        QMenu::addAction(tr("%n more preset(s) - type to filter", "", rows - shown))->setEnabled(false);
+    }
+    else if(0 == rows && !m_filter->text().isEmpty()) {
+        QMenu::addAction(tr("No matching presets"))->setEnabled(false);
     }
+
+    m_dirty = false;
 }
+
+/**
+ * @var PresetMenu::MaximumPresetActions
+ * @brief The largest number of presets listed in the menu at once.
+ */
@@ -8,13 +8,18 @@
  *
  * @dep
  * - QMenu
+ * - QSortFilterProxyModel
  */
 
 #ifndef QYNC_PRESETMENU_H
 #define QYNC_PRESETMENU_H
 
+#include <QtCore/QSortFilterProxyModel>
 #include <QtWidgets/QMenu>
 
+class QLineEdit;
+class QWidgetAction;
+
 namespace Qync {
 
 	class Preset;
@@ -38,12 +43,23 @@ namespace Qync {
 		void removeAction() = delete;
 		void clear() = delete;
 
+		static constexpr const int MaximumPresetActions = 50;
+
 	public Q_SLOTS:
 		void refresh();
 
 	Q_SIGNALS:
 		void presetTriggered(Preset &);
 		void presetIndexTriggered(int);
+
+	private:
+		void invalidate();
+		void rebuild();
+
+		QSortFilterProxyModel m_filterModel;
+		QLineEdit * m_filter;
+		QWidgetAction * m_filterAction;
+		bool m_dirty;
 	};
 
 }  // namespace Qync
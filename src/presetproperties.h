@@ -0,0 +1,249 @@
+/**
+ * @file presetproperties.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief The table of Preset properties.
+ *
+ * Every setting of a Preset other than its name, source and destination is a
+ * property listed here, with the name it is stored under, its getter and
+ * setter and the rsync option it corresponds to, if any. Boolean options are
+ * given when the property is set; string and integer options are given with
+ * the value appended when it is not empty or is positive, so the default value
+ * leaves rsync to its own default. An option can also be limited to presets
+ * with one of the boolean properties set, e.g. the compression options only
+ * mean anything when compression is used. The tables drive reading and
+ * writing presets in both file formats (see Preset::parsePropertyXml(),
+ * Preset::emitPropertiesXml(), Preset::emitBinary()) and building the rsync
+ * command line (see Process::rsyncArguments()), so adding a property here is
+ * all that is needed for it to be saved, loaded and, if it has an rsync
+ * option, used.
+ *
+ * The tables are constexpr arrays, so nothing is allocated or constructed at
+ * startup. The order of each table is the order of its options on the rsync
+ * command line, boolean options first. Lookup by name is a binary search of an
+ * index sorted at compile time.
+ */
+
+#ifndef QYNC_PRESETPROPERTIES_H
+#define QYNC_PRESETPROPERTIES_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include <QtCore/QString>
+#include <QtCore/QStringRef>
+
+#include "preset.h"
+
+namespace Qync::PresetProperties {
+
+	template<typename T>
+	struct Property {
+		using Type = T;
+		using Getter = const T & (Qync::Preset::*)() const;
+		using Setter = bool (Qync::Preset::*)(const T &);
+		using Condition = const bool & (Qync::Preset::*)() const;
+
+		// the name the property is stored under in preset files
+		std::string_view name;
+		Getter getter;
+		Setter setter;
+
+		// the rsync option the property turns on, or nullptr if it has none. for string and
+		// integer properties the value is appended, so this includes the "="
+		const char * rsyncOption = nullptr;
+
+		// the boolean property that must be set for rsyncOption to be given, nullptr if none
+		Condition onlyWith = nullptr;
+	};
+
+	// a table of properties of one type, with an index of them sorted by name
+	template<typename T, std::size_t N>
+	struct Table {
+		std::array<Property<T>, N> properties;
+		std::array<std::size_t, N> byName;
+
+		[[nodiscard]] constexpr auto begin() const {
+			return properties.begin();
+		}
+
+		[[nodiscard]] constexpr auto end() const {
+			return properties.end();
+		}
+
+		[[nodiscard]] constexpr std::size_t size() const {
+			return N;
+		}
+
+		// find a property by the name it is stored under, nullptr if there is no such property
+		[[nodiscard]] const Property<T> * find(std::string_view name) const
+		{
+			const auto it = std::lower_bound(byName.cbegin(), byName.cend(), name, [this](std::size_t index, std::string_view value) {
+				return properties[index].name < value;
+			});
+
+			if(byName.cend() == it || properties[*it].name != name) {
+				return nullptr;
+			}
+
+			return &properties[*it];
+		}
+
+		// as above, for names read from XML. property names are ASCII, so
+		// anything else can't match and needn't be converted
+		[[nodiscard]] const Property<T> * find(const QStringRef & name) const
+		{
+			char ascii[MaximumNameLength];
+
+			if(MaximumNameLength < name.size()) {
+				return nullptr;
+			}
+
+			for(int index = 0; index < name.size(); ++index) {
+				const auto ch = name.at(index).unicode();
+
+				if(0x7f < ch) {
+					return nullptr;
+				}
+
+				ascii[index] = static_cast<char>(ch);
+			}
+
+			return find(std::string_view(ascii, static_cast<std::size_t>(name.size())));
+		}
+
+		static constexpr const int MaximumNameLength = 64;
+	};
+
+	namespace Detail {
+		template<typename T, std::size_t N>
+		constexpr Table<T, N> makeTable(const std::array<Property<T>, N> & properties)
+		{
+			Table<T, N> table{properties, {}};
+
+			for(std::size_t index = 0; index < N; ++index) {
+				table.byName[index] = index;
+			}
+
+			// insertion sort, since std::sort isn't constexpr until C++20
+			for(std::size_t index = 1; index < N; ++index) {
+				for(std::size_t sorted = index; 0 < sorted && properties[table.byName[sorted]].name < properties[table.byName[sorted - 1]].name; --sorted) {
+					const auto swap = table.byName[sorted];
+					table.byName[sorted] = table.byName[sorted - 1];
+					table.byName[sorted - 1] = swap;
+				}
+			}
+
+			return table;
+		}
+
+		template<typename T, std::size_t N>
+		constexpr bool isValid(const Table<T, N> & table)
+		{
+			for(std::size_t index = 0; index < N; ++index) {
+				if(table.properties[index].name.empty() || Table<T, N>::MaximumNameLength < static_cast<int>(table.properties[index].name.size())) {
+					return false;
+				}
+
+				if(0 < index && table.properties[table.byName[index]].name == table.properties[table.byName[index - 1]].name) {
+					return false;
+				}
+			}
+
+			return true;
+		}
+	}  // namespace Detail
+
+	inline constexpr const auto booleanProperties = Detail::makeTable<bool, 27>({{
+		{"preserveTime", &Qync::Preset::preserveTime, &Qync::Preset::setPreserveTime, "--times"},
+		{"preservePermissions", &Qync::Preset::preservePermissions, &Qync::Preset::setPreservePermissions, "--perms"},
+		{"preserveOwner", &Qync::Preset::preserveOwner, &Qync::Preset::setPreserveOwner, "--owner"},
+		{"preserveGroup", &Qync::Preset::preserveGroup, &Qync::Preset::setPreserveGroup, "--group"},
+
+		{"windowsCompatability", &Qync::Preset::windowsCompatability, &Qync::Preset::setWindowsCompatability, "--modify-window=1"},
+		{"honourDeletions", &Qync::Preset::honourDeletions, &Qync::Preset::setHonourDeletions, "--delete"},
+
+		{"ignoreTimes", &Qync::Preset::ignoreTimes, &Qync::Preset::setIgnoreTimes, "--ignore-times"},
+		{"alwaysCompareChecksums", &Qync::Preset::alwaysCompareChecksums, &Qync::Preset::setAlwaysCompareChecksums, "--checksum"},
+		{"preserveDevices", &Qync::Preset::preserveDevices, &Qync::Preset::setPreserveDevices, "--devices"},
+		{"keepPartialTransfers", &Qync::Preset::keepPartialTransfers, &Qync::Preset::setKeepPartialTransfers, "--partial"},
+		{"copySymlinksAsSymlinks", &Qync::Preset::copySymlinksAsSymlinks, &Qync::Preset::setCopySymlinksAsSymlinks, "--links"},
+		{"makeBackups", &Qync::Preset::makeBackups, &Qync::Preset::setMakeBackups, "--backup"},
+
+		{"useTransferCompression", &Qync::Preset::useTransferCompression, &Qync::Preset::setUseTransferCompression, "--compress"},
+		{"onlyUpdateExistingEntries", &Qync::Preset::onlyUpdateExistingEntries, &Qync::Preset::setOnlyUpdateExistingEntries, "--existing"},
+		{"dontUpdateExistingEntries", &Qync::Preset::dontUpdateExistingEntries, &Qync::Preset::setDontUpdateExistingEntries, "--ignore-existing"},
+		{"dontMapUsersAndGroups", &Qync::Preset::dontMapUsersAndGroups, &Qync::Preset::setDontMapUsersAndGroups, "--numeric-ids"},
+		{"copyHardlinksAsHardlinks", &Qync::Preset::copyHardlinksAsHardlinks, &Qync::Preset::setCopyHardlinksAsHardlinks, "--hard-links"},
+		{"showItemisedChanges", &Qync::Preset::showItemisedChanges, &Qync::Preset::setShowItemisedChanges, "--itemize-changes"},
+
+		{"transferWholeFiles", &Qync::Preset::transferWholeFiles, &Qync::Preset::setTransferWholeFiles, "--whole-file"},
+		{"updateInPlace", &Qync::Preset::updateInPlace, &Qync::Preset::setUpdateInPlace, "--inplace"},
+		{"appendVerify", &Qync::Preset::appendVerify, &Qync::Preset::setAppendVerify, "--append-verify"},
+
+		// Process gives rsync a list of changed entries instead, see SourceIndex
+		{"useSourceIndex", &Qync::Preset::useSourceIndex, &Qync::Preset::setUseSourceIndex},
+
+		// the bandwidth settings are all turned into --bwlimit by Process, since the limit can change during a run
+		{"adaptiveBandwidth", &Qync::Preset::adaptiveBandwidth, &Qync::Preset::setAdaptiveBandwidth},
+
+		// Process gives rsync the snapshot to write and the one to link against, see SnapshotSet
+		{"snapshots", &Qync::Preset::snapshots, &Qync::Preset::setSnapshots},
+
+		// Process copies the source itself instead of running rsync, see LocalCopier
+		{"useLocalCopier", &Qync::Preset::useLocalCopier, &Qync::Preset::setUseLocalCopier},
+
+		// the ssh settings are all turned into the remote shell rsync is given by Process, see RemoteShell
+		{"shareSshConnections", &Qync::Preset::shareSshConnections, &Qync::Preset::setShareSshConnections},
+
+		// Process rewrites host:path sources and destinations as rsync:// URLs, see RemoteShell
+		{"useRsyncDaemon", &Qync::Preset::useRsyncDaemon, &Qync::Preset::setUseRsyncDaemon},
+	}});
+
+	inline constexpr const auto stringProperties = Detail::makeTable<QString, 8>({{
+		{"logFile", &Qync::Preset::logFile, &Qync::Preset::setLogFile},
+		{"compressionAlgorithm", &Qync::Preset::compressionAlgorithm, &Qync::Preset::setCompressionAlgorithm, "--compress-choice=", &Qync::Preset::useTransferCompression},
+		{"checksumAlgorithm", &Qync::Preset::checksumAlgorithm, &Qync::Preset::setChecksumAlgorithm, "--checksum-choice="},
+		{"bandwidthSchedule", &Qync::Preset::bandwidthSchedule, &Qync::Preset::setBandwidthSchedule},
+		{"partialDirectory", &Qync::Preset::partialDirectory, &Qync::Preset::setPartialDirectory, "--partial-dir="},
+
+		{"remoteShell", &Qync::Preset::remoteShell, &Qync::Preset::setRemoteShell},
+		{"sshCipher", &Qync::Preset::sshCipher, &Qync::Preset::setSshCipher},
+
+		// the fan-out settings are all used by Process to run an rsync for each destination
+		{"fanOutDestinations", &Qync::Preset::fanOutDestinations, &Qync::Preset::setFanOutDestinations},
+	}});
+
+	inline constexpr const auto integerProperties = Detail::makeTable<int, 14>({{
+		{"logRotationSize", &Qync::Preset::logRotationSize, &Qync::Preset::setLogRotationSize},
+		{"logRotationCount", &Qync::Preset::logRotationCount, &Qync::Preset::setLogRotationCount},
+		{"shardCount", &Qync::Preset::shardCount, &Qync::Preset::setShardCount},
+		{"compressionLevel", &Qync::Preset::compressionLevel, &Qync::Preset::setCompressionLevel, "--compress-level=", &Qync::Preset::useTransferCompression},
+		{"blockSize", &Qync::Preset::blockSize, &Qync::Preset::setBlockSize, "--block-size="},
+		{"bandwidthLimit", &Qync::Preset::bandwidthLimit, &Qync::Preset::setBandwidthLimit},
+
+		// Process runs rsync again itself
+		{"retryAttempts", &Qync::Preset::retryAttempts, &Qync::Preset::setRetryAttempts},
+		{"retryDelay", &Qync::Preset::retryDelay, &Qync::Preset::setRetryDelay},
+
+		// Process prunes the snapshots itself once a run has finished
+		{"keepHourlySnapshots", &Qync::Preset::keepHourlySnapshots, &Qync::Preset::setKeepHourlySnapshots},
+		{"keepDailySnapshots", &Qync::Preset::keepDailySnapshots, &Qync::Preset::setKeepDailySnapshots},
+		{"keepWeeklySnapshots", &Qync::Preset::keepWeeklySnapshots, &Qync::Preset::setKeepWeeklySnapshots},
+
+		{"sshConnectionLifetime", &Qync::Preset::sshConnectionLifetime, &Qync::Preset::setSshConnectionLifetime},
+		{"rsyncDaemonPort", &Qync::Preset::rsyncDaemonPort, &Qync::Preset::setRsyncDaemonPort, "--port=", &Qync::Preset::useRsyncDaemon},
+		{"fanOutConcurrency", &Qync::Preset::fanOutConcurrency, &Qync::Preset::setFanOutConcurrency},
+	}});
+
+	static_assert(Detail::isValid(booleanProperties), "boolean preset property names must be unique and not too long");
+	static_assert(Detail::isValid(stringProperties), "string preset property names must be unique and not too long");
+	static_assert(Detail::isValid(integerProperties), "integer preset property names must be unique and not too long");
+
+}  // namespace Qync::PresetProperties
+
+#endif  // QYNC_PRESETPROPERTIES_H
@@ -0,0 +1,563 @@
+/**
+ * @file presetwatcher.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the PresetWatcher class.
+ */
+
+#include "presetwatcher.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFileInfo>
+
+#include "preset.h"
+#include "shardplanner.h"
+#include "sourcescanner.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::PresetWatcher class.
+ */
+namespace Qync::Detail::PresetWatcher {
+    static constexpr const QDir::Filters EntryFilters = QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot;
+
+    // files share the platform's limit on watches with the directories, so only
+    // this many of them are watched
+    static constexpr const int MaximumWatchedFiles = 8192;
+}  // namespace Qync::Detail::PresetWatcher
+
+/**
+ * @class PresetWatcher
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Keeps the destination of a preset up to date as its source changes.
+ *
+ * When started, the watcher scans the preset's source (which must be a local
+ * directory - see canWatch()) and watches every directory in it with a
+ * QFileSystemWatcher, along with up to Detail::PresetWatcher::MaximumWatchedFiles
+ * of its regular files. Once the watches are in place it queues a full
+ * synchronisation of the preset with the JobScheduler, so that anything that
+ * changed beforehand is caught.
+ *
+ * A directory's watch only reports entries being added, removed or renamed in
+ * it (with Qt's inotify backend, for example, it doesn't include IN_MODIFY), so
+ * a file that is rewritten in place - appended to, or saved by an editor or
+ * database that doesn't replace it - is only noticed through a watch on the
+ * file itself. Files found after the watcher has started, in new or changed
+ * directories, are watched too while there is room.
+ *
+ * After that, each change reported in a directory marks it as changed, and each
+ * change reported in a watched file marks the file as changed. Changes
+ * are collected until the source has been quiet for quietPeriod() ms, or for
+ * at most maximumLatency() ms after the first of them, and then the whole batch
+ * is queued as a single job. The job's Process is restricted (see
+ * Process::setPaths()) to the changed files, the changed directories and their
+ * immediate entries, plus everything in any directory that has appeared, which
+ * is watched from then on. rsync's usual size and time check means unchanged entries in those
+ * directories cost little more than a stat. A burst of changes, e.g. from
+ * switching branches in a working copy, therefore results in one rsync rather
+ * than thousands. Only one job for the watcher is queued or running at a time;
+ * changes made while it runs go into the next batch.
+ *
+ * Entries removed from the source are not removed from the destination by the
+ * batches, only by the initial synchronisation (if the preset honours
+ * deletions).
+ *
+ * The number of directories that can be watched is limited by the platform
+ * (on Linux, by fs.inotify.max_user_watches). Directories that can't be
+ * watched are reported with qWarning() and changes in them are missed until
+ * the next full synchronisation. The same goes for rewrites in place of the
+ * files beyond those that are watched: they are caught when something else
+ * changes in their directory, or by the next full synchronisation.
+ *
+ * The preset must outlive the watcher.
+ */
+
+/**
+ * @brief Create a new watcher.
+ *
+ * @param preset The preset to keep up to date.
+ * @param scheduler The scheduler to queue the synchronisations with. The
+ * processes are created with its settings.
+ * @param parent The parent object.
+ *
+ * The watcher does nothing until start() is called.
+ */
+PresetWatcher::PresetWatcher(const Preset & preset, JobScheduler & scheduler, QObject * parent)
+:   QObject(parent),
+    m_preset(preset),
+    m_scheduler(scheduler),
+    m_root(QDir::cleanPath(QFileInfo(preset.source()).absoluteFilePath())),
+    m_watcher(),
+    m_directories(),
+    m_files(),
+    m_scanner(),
+    m_quietTimer(),
+    m_latencyTimer(),
+    m_changedDirectories(),
+    m_changedFiles(),
+    m_job(0),
+    m_watching(false)
+{
+    m_quietTimer.setSingleShot(true);
+    m_quietTimer.setInterval(DefaultQuietPeriod);
+    m_latencyTimer.setSingleShot(true);
+    m_latencyTimer.setInterval(DefaultMaximumLatency);
+    connect(&m_quietTimer, &QTimer::timeout, this, &PresetWatcher::flush);
+    connect(&m_latencyTimer, &QTimer::timeout, this, &PresetWatcher::flush);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &PresetWatcher::onDirectoryChanged);
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, &PresetWatcher::onFileChanged);
+
+    connect(&m_scheduler, &JobScheduler::jobFinished, this, [this](JobScheduler::JobId id) {
+        onJobFinished(id);
+    });
+}
+
+/**
+ * @brief Destroy the watcher.
+ *
+ * A job the watcher has queued is left to run.
+ */
+PresetWatcher::~PresetWatcher()
+{
+    m_scheduler.disconnect(this);
+}
+
+/**
+ * @brief Check whether a preset's source can be watched.
+ *
+ * @param preset The preset.
+ *
+ * @return @b true if the source is a local directory, @b false otherwise.
+ */
+bool PresetWatcher::canWatch(const Preset & preset)
+{
+    return ShardPlanner::canShard(preset.source());
+}
+
+/**
+ * @brief Set how long the source must be quiet before a batch is queued.
+ *
+ * @param ms The time in milliseconds. Negative values are treated as 0.
+ */
+void PresetWatcher::setQuietPeriod(int ms)
+{
+    m_quietTimer.setInterval(std::max(ms, 0));
+}
+
+/**
+ * @brief Set the longest time a change waits before it is queued.
+ *
+ * @param ms The time in milliseconds, from the first change in a batch.
+ * Negative values are treated as 0.
+ *
+ * This stops a source that never goes quiet from never being synchronised.
+ */
+void PresetWatcher::setMaximumLatency(int ms)
+{
+    m_latencyTimer.setInterval(std::max(ms, 0));
+}
+
+/**
+ * @brief Start watching.
+ *
+ * The source is scanned on background threads; the watches are set up and the
+ * initial synchronisation is queued when the scan is complete.
+ */
+void PresetWatcher::start()
+{
+    if(m_watching) {
+        return;
+    }
+
+    if(!canWatch(m_preset)) {
+        qWarning() << __PRETTY_FUNCTION__ << "can't watch source" << m_preset.source() << "- it is not a local directory";
+        return;
+    }
+
+    m_watching = true;
+    m_scanner = std::make_unique<SourceScanner>(m_root);
+    m_scanner->setRecordEntries(true);
+    connect(m_scanner.get(), &SourceScanner::finished, this, &PresetWatcher::onDirectoriesScanned, Qt::QueuedConnection);
+    m_scanner->start();
+}
+
+/**
+ * @brief Stop watching.
+ *
+ * Changes that have not yet been queued are discarded, and a job the watcher
+ * has queued is cancelled.
+ */
+void PresetWatcher::stop()
+{
+    if(!m_watching) {
+        return;
+    }
+
+    m_watching = false;
+    m_scanner.reset();
+    m_quietTimer.stop();
+    m_latencyTimer.stop();
+    m_changedDirectories.clear();
+    m_changedFiles.clear();
+
+    if(!m_directories.isEmpty()) {
+        m_watcher.removePaths(m_directories.values());
+        m_directories.clear();
+    }
+
+    if(!m_files.isEmpty()) {
+        m_watcher.removePaths(m_files.values());
+        m_files.clear();
+    }
+
+    if(0 != m_job) {
+        auto job = m_job;
+        m_job = 0;
+        m_scheduler.cancel(job);
+    }
+}
+
+/**
+ * @brief Set up the watches once the source has been scanned, and queue the
+ * initial synchronisation.
+ */
+void PresetWatcher::onDirectoriesScanned()
+{
+    Q_ASSERT_X(m_scanner, __PRETTY_FUNCTION__, "no source scanner");
+    QStringList directories = {m_root};
+    QStringList files;
+
+    for(const auto & entry : m_scanner->takeEntries()) {
+        if(SourceScanner::Entry::Type::Directory == entry.type) {
+            directories.append(absolutePath(entry.path));
+        }
+        else if(SourceScanner::Entry::Type::File == entry.type && Detail::PresetWatcher::MaximumWatchedFiles > files.size()) {
+            files.append(absolutePath(entry.path));
+        }
+    }
+
+    m_scanner.reset();
+    auto failed = m_watcher.addPaths(directories);
+
+    if(!failed.isEmpty()) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to watch" << failed.size() << "of" << directories.size() << "directories in" << m_root << "- the limit on watches may need raising";
+    }
+
+    for(const auto & directory : m_watcher.directories()) {
+        m_directories.insert(directory);
+    }
+
+    // the directories first, since they matter more if the watches run out
+    if(!files.isEmpty()) {
+        failed = m_watcher.addPaths(files);
+
+        if(!failed.isEmpty()) {
+            qWarning() << __PRETTY_FUNCTION__ << "failed to watch" << failed.size() << "of" << files.size() << "files in" << m_root << "- rewrites of them are missed until something else in their directory changes";
+        }
+
+        for(const auto & file : m_watcher.files()) {
+            m_files.insert(file);
+        }
+    }
+
+    Q_EMIT watching(watchedDirectoryCount());
+    m_job = m_scheduler.enqueue(m_preset, (1 < m_preset.shardCount() ? Process::RunType::Parallel : Process::RunType::Normal));
+}
+
+/**
+ * @brief Record a change in a watched directory.
+ *
+ * @param path The absolute path of the directory.
+ */
+void PresetWatcher::onDirectoryChanged(const QString & path)
+{
+    if(!m_watching) {
+        return;
+    }
+
+    if(!QFileInfo(path).isDir()) {
+        // QFileSystemWatcher drops the watch itself; the removal can't be synchronised
+        m_directories.remove(path);
+        return;
+    }
+
+    m_changedDirectories.insert(path);
+    noteChange();
+}
+
+/**
+ * @brief Record a change in a watched file.
+ *
+ * @param path The absolute path of the file.
+ *
+ * A file that has been removed or replaced loses its watch; a file that
+ * replaces it is watched again when the batch is queued.
+ */
+void PresetWatcher::onFileChanged(const QString & path)
+{
+    if(!m_watching) {
+        return;
+    }
+
+    m_changedFiles.insert(path);
+    noteChange();
+}
+
+/**
+ * @brief Start or extend the wait before the changes are queued.
+ */
+void PresetWatcher::noteChange()
+{
+    m_quietTimer.start();
+
+    if(!m_latencyTimer.isActive()) {
+        m_latencyTimer.start();
+    }
+}
+
+/**
+ * @brief Called when the scheduler has finished a job.
+ *
+ * @param id The ID of the job.
+ *
+ * If it was the watcher's job, the changes made while it ran are queued unless
+ * more are still arriving.
+ */
+void PresetWatcher::onJobFinished(JobScheduler::JobId id)
+{
+    if(id != m_job) {
+        return;
+    }
+
+    m_job = 0;
+
+    if((!m_changedDirectories.isEmpty() || !m_changedFiles.isEmpty()) && !m_quietTimer.isActive()) {
+        flush();
+    }
+}
+
+/**
+ * @brief Queue a job for the changes collected so far.
+ *
+ * Nothing is queued while the watcher's previous job is queued or running; the
+ * changes are kept for when it finishes.
+ */
+void PresetWatcher::flush()
+{
+    m_quietTimer.stop();
+    m_latencyTimer.stop();
+
+    if(0 != m_job || (m_changedDirectories.isEmpty() && m_changedFiles.isEmpty())) {
+        return;
+    }
+
+    // the watcher silently drops the watches on files that have been removed or replaced
+    m_files.clear();
+
+    for(const auto & file : m_watcher.files()) {
+        m_files.insert(file);
+    }
+
+    QStringList paths;
+
+    for(const auto & file : std::as_const(m_changedFiles)) {
+        if(QFileInfo(file).isFile()) {
+            paths.append(file.mid(m_root.size() + 1));
+            watchFile(file);
+        }
+    }
+
+    m_changedFiles.clear();
+
+    for(const auto & directory : std::as_const(m_changedDirectories)) {
+        if(QFileInfo(directory).isDir()) {
+            addPaths((directory == m_root ? QString() : directory.mid(m_root.size() + 1)), paths);
+        }
+    }
+
+    m_changedDirectories.clear();
+    paths.removeDuplicates();
+
+    if(paths.isEmpty()) {
+        return;
+    }
+
+    auto process = m_scheduler.createProcess(m_preset);
+    process->setPaths(paths);
+    m_job = m_scheduler.enqueue(m_preset.name(), std::move(process), JobScheduler::presetDevices(m_preset));
+    Q_EMIT batchQueued(m_job, paths.size());
+}
+
+/**
+ * @brief Add a changed directory and its immediate entries to a batch.
+ *
+ * @param relativeDirectory The path of the directory relative to the source,
+ * empty for the source itself.
+ * @param paths The batch's paths.
+ *
+ * Directories that are not yet watched are new, so they are added with all
+ * their content (see addDirectory()).
+ */
+void PresetWatcher::addPaths(const QString & relativeDirectory, QStringList & paths)
+{
+    if(!relativeDirectory.isEmpty()) {
+        paths.append(relativeDirectory);
+    }
+
+    QDirIterator it(absolutePath(relativeDirectory), Detail::PresetWatcher::EntryFilters);
+
+    while(it.hasNext()) {
+        it.next();
+        auto info = it.fileInfo();
+        QString relativePath = (relativeDirectory.isEmpty() ? info.fileName() : relativeDirectory + '/' + info.fileName());
+
+        if(info.isDir() && !info.isSymLink() && !m_directories.contains(info.absoluteFilePath())) {
+            addDirectory(relativePath, paths);
+        }
+        else {
+            if(info.isFile() && !info.isSymLink()) {
+                watchFile(info.absoluteFilePath());
+            }
+
+            paths.append(relativePath);
+        }
+    }
+}
+
+/**
+ * @brief Watch a new directory and add it and all its content to a batch.
+ *
+ * @param relativePath The path of the directory relative to the source.
+ * @param paths The batch's paths.
+ */
+void PresetWatcher::addDirectory(const QString & relativePath, QStringList & paths)
+{
+    paths.append(relativePath);
+    QString path = absolutePath(relativePath);
+
+    if(m_watcher.addPath(path)) {
+        m_directories.insert(path);
+    }
+    else {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to watch new directory" << path;
+    }
+
+    QDirIterator it(path, Detail::PresetWatcher::EntryFilters);
+
+    while(it.hasNext()) {
+        it.next();
+        auto info = it.fileInfo();
+        QString childPath = relativePath + '/' + info.fileName();
+
+        if(info.isDir() && !info.isSymLink()) {
+            addDirectory(childPath, paths);
+        }
+        else {
+            if(info.isFile() && !info.isSymLink()) {
+                watchFile(info.absoluteFilePath());
+            }
+
+            paths.append(childPath);
+        }
+    }
+}
+
+/**
+ * @brief Watch a file for being rewritten in place, if it isn't already and
+ * there is room.
+ *
+ * @param path The absolute path of the file.
+ */
+void PresetWatcher::watchFile(const QString & path)
+{
+    if(m_files.contains(path) || Detail::PresetWatcher::MaximumWatchedFiles <= m_files.size()) {
+        return;
+    }
+
+    if(m_watcher.addPath(path)) {
+        m_files.insert(path);
+    }
+}
+
+/**
+ * @brief Convert a path relative to the source to an absolute path.
+ *
+ * @param relativePath The relative path, empty for the source itself.
+ *
+ * @return The absolute path.
+ */
+QString PresetWatcher::absolutePath(const QString & relativePath) const
+{
+    return (relativePath.isEmpty() ? m_root : m_root + '/' + relativePath);
+}
+
+/**
+ * @fn PresetWatcher::preset()
+ * @brief Fetch the preset being watched.
+ *
+ * @return The preset.
+ */
+
+/**
+ * @fn PresetWatcher::isWatching()
+ * @brief Check whether the watcher has been started.
+ *
+ * @return @b true if it is watching the source, @b false otherwise.
+ */
+
+/**
+ * @fn PresetWatcher::watchedDirectoryCount()
+ * @brief Fetch the number of directories being watched.
+ *
+ * @return The number of directories.
+ */
+
+/**
+ * @fn PresetWatcher::watchedFileCount()
+ * @brief Fetch the number of files being watched for being rewritten in place.
+ *
+ * The count is brought up to date each time a batch is queued, so it may
+ * include files that have since been removed.
+ *
+ * @return The number of files.
+ */
+
+/**
+ * @fn PresetWatcher::quietPeriod()
+ * @brief Fetch how long the source must be quiet before a batch is queued.
+ *
+ * @return The time in milliseconds.
+ */
+
+/**
+ * @fn PresetWatcher::maximumLatency()
+ * @brief Fetch the longest time a change waits before it is queued.
+ *
+ * @return The time in milliseconds.
+ */
+
+/**
+ * @fn PresetWatcher::watching(int)
+ * @brief Emitted when the watches have been set up.
+ *
+ * @param directories The number of directories being watched.
+ */
+
+/**
+ * @fn PresetWatcher::batchQueued(JobScheduler::JobId, int)
+ * @brief Emitted when a batch of changes has been queued.
+ *
+ * @param id The ID of the job.
+ * @param paths The number of paths in the batch.
+ */
@@ -0,0 +1,107 @@
+/**
+ * @file presetwatcher.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the PresetWatcher class.
+ */
+
+#ifndef QYNC_PRESETWATCHER_H
+#define QYNC_PRESETWATCHER_H
+
+#include <memory>
+
+#include <QtCore/QFileSystemWatcher>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+
+#include "jobscheduler.h"
+
+namespace Qync {
+
+	class Preset;
+	class SourceScanner;
+
+	class PresetWatcher
+	: public QObject {
+		Q_OBJECT
+
+	public:
+		PresetWatcher(const Preset & preset, JobScheduler & scheduler, QObject * parent = nullptr);
+		~PresetWatcher() override;
+
+		[[nodiscard]] static bool canWatch(const Preset & preset);
+
+		[[nodiscard]] inline const Preset & preset() const {
+			return m_preset;
+		}
+
+		[[nodiscard]] inline bool isWatching() const {
+			return m_watching;
+		}
+
+		[[nodiscard]] inline int watchedDirectoryCount() const {
+			return m_directories.size();
+		}
+
+		[[nodiscard]] inline int watchedFileCount() const {
+			return m_files.size();
+		}
+
+		[[nodiscard]] inline int quietPeriod() const {
+			return m_quietTimer.interval();
+		}
+
+		void setQuietPeriod(int ms);
+
+		[[nodiscard]] inline int maximumLatency() const {
+			return m_latencyTimer.interval();
+		}
+
+		void setMaximumLatency(int ms);
+
+		static constexpr const int DefaultQuietPeriod = 500;
+		static constexpr const int DefaultMaximumLatency = 5000;
+
+	public Q_SLOTS:
+		void start();
+		void stop();
+
+	Q_SIGNALS:
+		void watching(int);
+		void batchQueued(JobScheduler::JobId, int);
+
+	private:
+		void onDirectoriesScanned();
+		void onDirectoryChanged(const QString & path);
+		void onFileChanged(const QString & path);
+		void noteChange();
+		void watchFile(const QString & path);
+		void onJobFinished(JobScheduler::JobId id);
+		void flush();
+		void addDirectory(const QString & relativePath, QStringList & paths);
+		[[nodiscard]] QString absolutePath(const QString & relativePath) const;
+		void addPaths(const QString & relativeDirectory, QStringList & paths);
+
+		const Preset & m_preset;
+		JobScheduler & m_scheduler;
+		QString m_root;
+		QFileSystemWatcher m_watcher;
+		QSet<QString> m_directories;
+		QSet<QString> m_files;
+		std::unique_ptr<SourceScanner> m_scanner;
+		QTimer m_quietTimer;
+		QTimer m_latencyTimer;
+		QSet<QString> m_changedDirectories;
+		QSet<QString> m_changedFiles;
+		JobScheduler::JobId m_job;
+		bool m_watching;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_PRESETWATCHER_H
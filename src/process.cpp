@@ -9,21 +9,180 @@
 
 #include "process.h"
 
+#include <algorithm>
+#include <limits>
 #include <map>
 
+#include <QtCore/QDateTime>
 #include <QtCore/QDebug>
-#include <QtCore/QProcess>
+#include <QtCore/QDir>
 #include <QtCore/QHash>
 #include <QtCore/QFile>
-#include <QtCore/QRegularExpression>
+#include <QtCore/QFileInfo>
+#include <QtCore/QLocale>
+#include <QtCore/QMetaObject>
+#include <QtCore/QStringBuilder>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QThread>
+#include <QtCore/QTime>
 #include <QtCore/QtGlobal>
 
+#include "functions.h"
+#include "instrumentation.h"
+#include "localcopier.h"
 #include "preset.h"
-#include "application.h"
-#include "preferences.h"
+#include "presetproperties.h"
+#include "remoteshell.h"
+#include "rsynccapabilities.h"
+#include "shardplanner.h"
+#include "snapshotpruner.h"
+#include "snapshotset.h"
+#include "sourceindex.h"
+#include "sourcescanner.h"
+#include "telemetrywriter.h"
+#include "transfertelemetry.h"
+#include "units.h"
 
 using namespace Qync;
 
+/**
+ * @brief Implementation details for the Qync::Process class.
+ */
+namespace Qync::Detail::Process {
+    // enough to absorb a burst of several thousand small files between two GUI
+    // event loop iterations without the worker stalling
+    static constexpr const std::size_t EventQueueCapacity = 4096;
+
+    // the transfer speed is recorded at most this often, in milliseconds
+    static constexpr const quint32 TelemetrySampleInterval = 1000;
+
+    // the number of runs of each source and destination whose telemetry is kept
+    static constexpr const int TelemetryRunsKept = 20;
+
+    // how often an adaptive bandwidth limit is reconsidered, in milliseconds
+    static constexpr const int AdaptiveBandwidthInterval = 60 * 1000;
+
+    // a higher limit isn't worth restarting rsync for unless it's this much higher
+    static constexpr const double MinimumBandwidthRise = 0.25;
+
+    // however many retries there have been, the delay before the next one is no
+    // longer than this, in seconds
+    static constexpr const int MaximumRetryDelay = 60 * 60;
+
+    // the failures that a flaky link causes, and that running rsync again can fix. these
+    // are the codes JobScheduler treats as connection errors. a partial transfer (23) is
+    // usually down to permissions, which a retry won't change
+    static bool isTransientFailure(Qync::Process::ExitCode code)
+    {
+        using ExitCode = Qync::Process::ExitCode;
+
+        switch(code) {
+            case ExitCode::SocketIoError:
+            case ExitCode::DataStreamError:
+            case ExitCode::DataTransmissionTimeout:
+            case ExitCode::ConnectionTimeout:
+            case ExitCode::RemoteShellError:
+                return true;
+
+            default:
+                break;
+        }
+
+        return false;
+    }
+
+    // the tighter of two bandwidth limits, where 0 is no limit
+    static int tighterLimit(int first, int second)
+    {
+        if(0 >= first) {
+            return std::max(second, 0);
+        }
+
+        if(0 >= second) {
+            return first;
+        }
+
+        return std::min(first, second);
+    }
+}  // namespace Qync::Detail::Process
+
+/**
+ * @brief One of the rsync processes run by a Process.
+ *
+ * A normal run has exactly one shard. A parallel run, or a dry run that
+ * doesn't delete anything, has one for each part of the source planned by the
+ * ShardPlanner. A run with fan-out destinations has one for each destination,
+ * all with the same file list. The shard keeps the latest progress figures
+ * reported by its rsync so that they can be combined with those of the other
+ * shards.
+ */
+struct Process::Shard {
+    explicit Shard(std::size_t capacity)
+    : events(capacity)
+    {}
+
+    ProcessEventQueue events;
+    std::unique_ptr<QTemporaryFile> filesFrom;
+    std::unique_ptr<ProcessWorker> worker;
+    std::unique_ptr<QThread> thread;
+
+    // copies the shard instead of rsync, if the process uses the local copier
+    std::unique_ptr<LocalCopier> copier;
+
+    // what the shard's rsync is run with, without the bandwidth options, so that
+    // it can be restarted with a different limit
+    QStringList args;
+    QString logFileName;
+    bool restarting = false;
+
+    // which of the fan-out destinations the shard synchronises, 0 for the preset's
+    // own destination, and whether it is waiting for another to finish first
+    int node = 0;
+    bool waiting = false;
+
+    // how many times the shard's rsync has been retried after a transient
+    // failure, and the timer for the next retry
+    int retries = 0;
+    QTimer retryTimer;
+
+    double bytesPerSecond = 0.0;
+    bool hasCheckCounts = false;
+    int itemsRemaining = 0;
+    int totalItems = 0;
+    bool finished = false;
+    ExitCode exitCode = ExitCode::Success;
+
+    // what the shard's rsync has listed and transferred so far, for the estimate
+    // of overall progress from the source scan
+    quint64 completedBytes = 0;
+    quint64 currentItemSize = 0;
+    quint64 currentItemBytes = 0;
+    quint64 listedBytes = 0;
+    int listedItems = 0;
+
+    // what the shard's rsync reports for its whole transfer, with structured output.
+    // transferredBytesBefore is what earlier rsyncs for the shard had transferred
+    // before being restarted
+    bool hasTransferTotals = false;
+    quint64 transferredBytes = 0;
+    quint64 transferredBytesBefore = 0;
+    int transferPercent = 0;
+    int transferSecondsRemaining = 0;
+
+    // the item the shard's rsync is working on, for the telemetry. only used
+    // with text output, in which rsync reports an item when it starts on it
+    // rather than when it has finished with it. the start time is that of the
+    // previous item's line either way. the process holds a reference to the
+    // item's path until it has been recorded
+    bool hasTelemetryItem = false;
+    PathStore::Id telemetryItem = PathStore::NoPath;
+    quint32 telemetryItemStart = 0;
+
+    // what the shard's rsync reports having sent and received when it completes
+    quint64 bytesSent = 0;
+    quint64 bytesReceived = 0;
+};
+
 /**
  * @class Process
  * @author Darren Edale
@@ -34,7 +193,7 @@ using namespace Qync;
  *
  * The QProcess for the rsync command is wrapped inside an object of this class.
  * The command, arguments and optional log file are set in the constructor from
- * the Preset object provided, and cannot later be modified - this is intended
+ * the Preset object provided, and can only be changed by rearm() - this is intended
  * as a read-only class that is provided by the application to represent processes
  * and as such the manager exercises complete control over its attributes. The
  * command, arguments and log file name are accessible with the command(),
@@ -60,22 +219,176 @@ using namespace Qync;
  * To monitor the progress of the rsync process, the newItemStarted(),
  * itemProgress(), itemProgressBytes() and overallProgress() signals are
  * available. The newItemStarted() signal indicates that rsync has started the
- * synchronisation of a new file or directory; itemProgress() and
+ * synchronisation of a new file or directory. The item signals carry the Id
+ * of the item's path in the process's PathStore rather than the path itself,
+ * so that each path is stored once however many views and logs keep track of
+ * the items. A new store is created each time the process is started, before
+ * started() is emitted, and receivers fetch it with pathStore(). Paths are
+ * only stored while something other than the process holds the store, and a
+ * receiver that keeps an Id beyond the signal retains it (see PathStore), so
+ * the store only ever holds the paths that are still wanted. itemProgress() and
  * itemProgressBytes() indicate how much of the current item has been
  * synchronised as a percentage of its total size and in bytes respectively. The
- * overallProgress() signal is not yet implemented, but it is intended to
- * indicate an overall percentage progress for the rsync command as a whole.
+ * overallProgress() signal indicates an overall percentage progress for the
+ * rsync command as a whole.
+ *
+ * By default overall progress is the proportion of the items rsync has
+ * checked, which it only reports once it has finished building its file list
+ * and which says nothing about how much data is left. If setScanSource() is
+ * called before start() and the source is local, a SourceScanner counts the
+ * entries and bytes in the source alongside rsync. Once the scan is complete,
+ * overall progress is the proportion of the source's bytes that rsync has
+ * dealt with: the bytes of the items it has transferred, plus an estimate for
+ * the items it has checked and skipped because they were already up to date
+ * (each is assumed to be the average size of the items rsync hasn't
+ * transferred). The overallSecondsRemaining() signal then also provides an
+ * estimate of the time remaining for the whole process based on the current
+ * transfer speed. For remote sources the count-based progress is used
+ * throughout and overallSecondsRemaining() is not emitted.
  *
  * Finally, if you are interested in capturing the standard output stream of
  * the process in its entirety, you can do so by connecting to the
  * standardOutputUpdated() signal. The argument provided with this signal is all
  * the data from the standard output stream since the last time the signal was
  * emitted.
+ *
+ * The QProcess itself is run by a ProcessWorker, which reads, logs and parses
+ * rsync's output and hands the results to the Process through a bounded
+ * single-producer/single-consumer queue. By default the worker lives in the same
+ * thread as the Process; if setUseWorkerThread() is called before start() it
+ * gets a dedicated thread instead, so that a busy transfer does not compete
+ * with the user interface for the event loop. Either way, all the signals are
+ * emitted from the thread that owns the Process, in the order the output was
+ * produced, and mean exactly the same thing.
+ *
+ * A process created with RunType::Parallel splits the preset's source into
+ * (at most) Preset::shardCount() shards and runs one rsync for each at the same
+ * time. The split is planned on a background thread by a ShardPlanner once
+ * start() is called, using the source's top-level entries as the units of
+ * work; each rsync is then given its share with --files-from. The shards are
+ * presented as a single process: itemProgress() and the other item signals
+ * come from whichever rsync reported most recently, transferSpeed() is the sum
+ * of the shards' speeds, overallProgress() is computed from the combined item
+ * counts and the finished(), interrupted() and failed() signals are emitted
+ * once, when the last rsync has finished, for the first shard that did not
+ * succeed. Only local directory sources can be split. For other sources, or if
+ * the source has only one top-level entry, a parallel process runs a single
+ * rsync just like a normal one. Since each rsync only sees the entries in its
+ * shard, a top-level entry that has been removed from the source is not
+ * removed from the destination even if the preset honours deletions.
+ *
+ * A dry run is split in the same way, so that listing the changes a large run
+ * would make takes about as long as the slowest shard, unless the preset
+ * honours deletions: the deleted top-level entries are part of what a dry run
+ * is for, so it then runs a single rsync.
+ *
+ * If the preset uses a source index (Preset::useSourceIndex()) and the source
+ * is a local directory, start() first scans the source and compares it with
+ * the SourceIndex saved after the last successful run. rsync is then given only
+ * the entries that have changed, with --files-from and --no-recursive, so it
+ * doesn't need to build and compare a list of the whole tree. The scan is
+ * complete before rsync starts, so an entry that changes while rsync is
+ * running is seen as changed next time. If there is no index yet, rsync is run
+ * on the whole source as usual. Either way, the index is replaced with the
+ * result of the scan when rsync succeeds (unless it was a dry run). An indexed
+ * run always uses a single rsync process for each destination.
+ *
+ * Alternatively, setPaths() restricts the process to a known set of entries in
+ * a local source, which are given to a single rsync in the same way. This is
+ * what a PresetWatcher uses to synchronise the entries that have changed.
+ *
+ * If the preset has fan-out destinations (Preset::fanOutDestinations()), the
+ * source is replicated to each of them in the same run, by an rsync per
+ * destination with the same arguments apart from the destination. The source
+ * is scanned and indexed once, and an indexed run writes its list of changed
+ * entries once for all of them, so replicating to many hosts costs the source
+ * little more than replicating to one, and the run takes about as long as the
+ * slowest link. At most Preset::fanOutConcurrency() destinations are
+ * synchronised at the same time; the rest wait, in order, for a place. The
+ * destinations are presented as a single process in the same way as shards,
+ * except that the item signals only come from the preset's own destination,
+ * since every destination gets the same items, and the progress is of all the
+ * destinations together. The failure message lists each destination that did
+ * not succeed. The source is not split for a fan-out run, snapshots are only
+ * kept in the preset's own destination and a dry run only covers that one.
+ *
+ * By default rsync is asked for its human-readable per-item progress, which is
+ * what every version of rsync can produce. If setOutputFormat() is given
+ * OutputFormat::Structured, rsync (3.1 or later) is asked instead for its
+ * progress through the whole transfer and for tab-separated item lines without
+ * digit grouping. overallProgress() and overallSecondsRemaining() are then
+ * rsync's own figures, whether or not the source is scanned, and
+ * bytesTransferred() reports the bytes transferred so far; itemProgress() and
+ * the other per-item progress signals are not emitted, since rsync doesn't
+ * report both at once.
+ *
+ * Once it has finished, a process can be run again by calling rearm() and then
+ * start(). The rsync arguments are kept along with the revision of the preset
+ * they were built from, and are only rebuilt if the preset has changed since,
+ * so a preset that is run over and over again doesn't pay for building them
+ * each time, and receivers connected to the process's signals don't need to be
+ * connected again.
+ *
+ * Every run other than a dry run records TransferTelemetry as it goes: the
+ * size, bytes transferred and approximate duration of each item rsync reports,
+ * and the combined transfer speed about once a second. When the run finishes
+ * the telemetry is saved on a background thread (see TelemetryWriter) in the
+ * directory given by TransferTelemetry::directoryFor() for the preset's source
+ * and destination, along with those of the most recent earlier runs, so that
+ * the report of how the transfer went can be produced afterwards without the
+ * run being any slower for having been measured.
+ *
+ * rsync's bandwidth is limited according to the preset: its bandwidthLimit(),
+ * or the limit its bandwidthSchedule() gives for the time of day, further
+ * lowered by an AdaptiveBandwidth if the preset's adaptiveBandwidth() is set
+ * (preferredBandwidthLimit()). The owner of the process can impose a limit of
+ * its own with setBandwidthShare(), which is how the JobScheduler splits its
+ * bandwidth budget between the jobs it is running. The tightest of these is
+ * given to rsync with @b --bwlimit. When it changes during a run - because the
+ * schedule has moved on to another period, the adaptive limit has changed or
+ * the share has - each rsync is asked to stop and is started again with the
+ * new limit. If the limit may change, rsync is always given @b --partial, so
+ * the part of the file it was transferring is kept and the new rsync only has
+ * to check the files it has already done.
+ *
+ * If the preset has retryAttempts(), an rsync that fails in a way that a flaky
+ * link causes - losing its connection or timing out - is run again after the
+ * preset's retry delay, which doubles for each further retry of the same
+ * rsync. The retrying() signal is emitted when a retry is scheduled. rsync is
+ * given @b --partial whenever it might be retried, so each retry uses the file
+ * it was part way through as the basis for its transfer (see
+ * resumeArguments()). The progress reported carries on from where it was
+ * rather than starting again, and retryCount() and resumedBytes() report how
+ * many retries there were and how much of the partly transferred files they
+ * didn't have to send again. Only once the retries are used up does the
+ * Process finish with the failure.
+ *
+ * If the preset keeps snapshots (Preset::snapshots()) and its destination is
+ * local, each run synchronises into a new SnapshotSet subdirectory of the
+ * destination, named for the time the run started, and rsync is given
+ * @b --link-dest with the latest complete snapshot so that unchanged files are
+ * hard links to it rather than copies. The snapshot is written with
+ * SnapshotSet::IncompleteSuffix and only renamed once rsync has succeeded; a
+ * run that finds an incomplete snapshot left by an earlier run carries on with
+ * it instead. Once the snapshot is complete, the snapshots that the preset's
+ * retention policy doesn't keep are removed by a SnapshotPruner before the
+ * process finishes. Since every snapshot has to be a complete copy of the
+ * source, a process that keeps snapshots ignores the source index and
+ * setPaths(). snapshotName() is the name of the snapshot the last run wrote.
+ *
+ * If the preset uses the local copier (Preset::useLocalCopier()) and
+ * LocalCopier::canCopy() it, a run other than a dry run copies the source
+ * with a LocalCopier instead of running rsync at all. The copier reports its
+ * progress through the same queue as a ProcessWorker, so the signals are the
+ * same either way. It copies with several threads of its own, so the run is
+ * never split into shards, and neither the source index nor setPaths() is
+ * used. Bandwidth limits don't apply to it.
  */
 
 /**
  * @brief Create a new Process.
  *
+ * @param cmd is the path to the rsync command to run.
  * @param preset is the preset from which to create the process.
  * @param type The type of rsync process to create.
  *
@@ -83,47 +396,346 @@ using namespace Qync;
  * of rsync or RunType::DryRun to perform a dry run. A dry run of rsync does
  * everything a normal run of rsync would do, except make any actual changes to
  * the destination. This run type is generally used for simulations.
+ * RunType::Parallel performs a normal run with the source split between
+ * several concurrent rsync processes.
+ *
+ * The Process does not consult the application's preferences, so it can be
+ * used without an Application. The caller provides the rsync command and, if
+ * required, calls setUseWorkerThread() before starting it.
+ */
+Process::Process(QString cmd, const Preset & preset, RunType type)
+:   QObject(),
+    m_command(std::move(cmd)),
+    m_runType(type),
+    m_source(),
+    m_destination(),
+    m_logRotationSize(0),
+    m_logRotationCount(0),
+    m_shardCount(1),
+    m_fanOutDestinations(),
+    m_fanOutConcurrency(0),
+    m_useWorkerThread(false),
+    m_useLocalCopier(false),
+    m_localCopierOptions(),
+    m_scanSource(false),
+    m_outputFormat(OutputFormat::Text),
+    m_running(false),
+    m_stopRequested(false),
+    m_planner(),
+    m_scanner(),
+    m_indexScanner(),
+    m_pendingIndex(),
+    m_telemetry(),
+    m_telemetryWriter(),
+    m_pathStore(std::make_shared<PathStore>()),
+    m_runTimer(),
+    m_lastTelemetrySample(0),
+    m_bandwidthSchedule(),
+    m_defaultBandwidthLimit(0),
+    m_adaptiveBandwidth(false),
+    m_adaptive(),
+    m_bandwidthShare(0),
+    m_bandwidthLimit(0),
+    m_preferredBandwidthLimit(0),
+    m_bandwidthTimer(),
+    m_retryAttempts(0),
+    m_retryDelay(0),
+    m_usesPartialDirectory(false),
+    m_retryCount(0),
+    m_resumedBytes(0),
+    m_snapshotDirectory(),
+    m_snapshotRetention(),
+    m_snapshotName(),
+    m_snapshotTarget(),
+    m_snapshotLinkTarget(),
+    m_pruner(),
+    m_overallProgress(0),
+    m_overallProgressFloor(0),
+    m_paths(),
+    m_shards(),
+    m_finishedShards(0),
+    m_exitCode(ExitCode::Success),
+    m_presetRevision(0)
+{
+    m_bandwidthTimer.setSingleShot(true);
+    connect(&m_bandwidthTimer, &QTimer::timeout, this, &Process::updateBandwidthLimit);
+    configure(preset);
+}
+
+/**
+ * @brief Destroy the Process.
  *
- * The rsync command to run is gathered directly from the application
- * preferences.
+ * If rsync is still running it is killed, and if the last run's telemetry is
+ * still being saved it is waited for. No signals are emitted.
  */
-Process::Process(const Preset & preset, RunType type)
-:   Process(qyncApp->preferences().rsyncPath(), preset, type)
+Process::~Process()
 {
+    releaseRun();
+
+    if(m_telemetryWriter) {
+        m_telemetryWriter->disconnect(this);
+        m_telemetryWriter->wait();
+    }
 }
 
 /**
- * @brief Create a new Process.
+ * @brief Prepare a finished process to be started again.
  *
- * @param cmd is the path to the rsync command to run.
- * @param preset is the preset from which to create the process.
- * @param type The type of rsync process to create.
+ * @param preset The preset to run. It need not be the preset the process was
+ * created from.
  *
- * The type argument should be RunType::Normal (the default) for normal execution
- * of rsync or RunType::DryRun to perform a dry run. A dry run of rsync does
- * everything a normal run of rsync would do, except make any actual changes to
- * the destination. This run type is generally used for simulations.
+ * The rsync arguments are only rebuilt if the preset's revision is different
+ * from that of the preset they were last built from, so running the same
+ * preset again costs nothing more than starting rsync. The run type, the rsync
+ * command and the worker thread and source scan settings are kept, and the
+ * paths set with setPaths() are cleared. Anything connected to the process's
+ * signals stays connected.
+ *
+ * @return @b true if the process is ready to start, @b false if it is still
+ * running.
  */
-Process::Process(QString cmd, const Preset & preset, RunType type)
-:   QObject(),
-    m_process(std::make_unique<QProcess>()),
-    m_command(std::move(cmd)),
-    m_runType(type)
+bool Process::rearm(const Preset & preset)
+{
+    if(m_running) {
+        qWarning() << __PRETTY_FUNCTION__ << "can't rearm a process that is running";
+        return false;
+    }
+
+    releaseRun();
+    m_paths.reset();
+    m_finishedShards = 0;
+    m_exitCode = ExitCode::Success;
+    m_stopRequested = false;
+
+    if(preset.revision() != m_presetRevision) {
+        configure(preset);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Take the settings for the rsync process from a preset.
+ *
+ * @param preset The preset.
+ */
+void Process::configure(const Preset & preset)
 {
+    m_source = preset.source();
+    m_destination = preset.destination();
+    m_useLocalCopier = RunType::DryRun != m_runType && preset.useLocalCopier() && LocalCopier::canCopy(preset);
+    m_localCopierOptions = LocalCopier::optionsFor(preset);
     m_logFileName = preset.logFile();
+    m_logRotationSize = static_cast<qint64>(preset.logRotationSize()) * 1024 * 1024;
+    m_logRotationCount = preset.logRotationCount();
+    m_fanOutDestinations.clear();
+    m_fanOutConcurrency = preset.fanOutConcurrency();
+
+    // a dry run only shows what would change in the preset's own destination
+    if(RunType::DryRun != m_runType) {
+        for(const auto & destination : preset.fanOutDestinationList()) {
+            m_fanOutDestinations.push_back(RemoteShell::endpointFor(preset, destination));
+        }
+    }
+
+    // a split dry run would miss deleted top-level entries, so only split it when nothing is deleted
+    m_shardCount = ((RunType::Parallel == m_runType || (RunType::DryRun == m_runType && !preset.honourDeletions())) && !m_useLocalCopier && m_fanOutDestinations.isEmpty() ? preset.shardCount() : 1);
+    m_indexFileName.clear();
+    m_telemetryDirectory = (RunType::DryRun == m_runType ? QString() : TransferTelemetry::directoryFor(preset.source(), preset.destination()));
+    m_bandwidthSchedule = BandwidthSchedule::fromString(preset.bandwidthSchedule()).value_or(BandwidthSchedule());
+    m_defaultBandwidthLimit = preset.bandwidthLimit();
+    m_adaptiveBandwidth = preset.adaptiveBandwidth();
+    m_retryAttempts = preset.retryAttempts();
+    m_retryDelay = preset.retryDelay();
+    m_usesPartialDirectory = !preset.partialDirectory().isEmpty();
+    m_snapshotDirectory.clear();
+
+    if(preset.snapshots()) {
+        if(SnapshotSet::canSnapshot(preset.destination())) {
+            m_snapshotDirectory = preset.destination();
+            m_snapshotRetention = {preset.keepHourlySnapshots(), preset.keepDailySnapshots(), preset.keepWeeklySnapshots()};
+        }
+        else {
+            qWarning() << __PRETTY_FUNCTION__ << "snapshots can only be kept in a local destination; synchronising into" << preset.destination() << "directly";
+        }
+    }
 
-    if(RunType::DryRun == type) {
-        m_args = rsyncArguments(preset, {"--dry-run"});
+    // these all need rsync to see the whole of the source
+    if(preset.useSourceIndex() && !usesSnapshots() && !m_useLocalCopier && !preset.honourDeletions() && !preset.ignoreTimes() && !preset.alwaysCompareChecksums()) {
+        // keyed on the arguments for a normal run so that dry runs use the same index. a
+        // new fan-out destination has none of the source, so it needs a new index too
+        m_indexFileName = SourceIndex::fileNameFor(rsyncArguments(preset) + preset.fanOutDestinationList());
+    }
+
+    if(RunType::DryRun == m_runType) {
+        m_args = rsyncArguments(preset, {"--dry-run"}, m_outputFormat);
     }
     else {
-        m_args = rsyncArguments(preset);
+        m_args = rsyncArguments(preset, {}, m_outputFormat);
     }
+
+    m_presetRevision = preset.revision();
 }
 
 /**
- * @brief Destroy the Process.
+ * @brief Dispose of everything left over from the last run.
+ *
+ * If rsync is still running it is killed. No signals are emitted.
+ */
+void Process::releaseRun()
+{
+    if(m_scanner) {
+        m_scanner->disconnect(this);
+        m_scanner->cancel();
+    }
+
+    if(m_indexScanner) {
+        m_indexScanner->disconnect(this);
+        m_indexScanner->cancel();
+    }
+
+    if(m_planner) {
+        m_planner->disconnect(this);
+        m_planner->requestInterruption();
+        m_planner->wait();
+    }
+
+    if(m_pruner) {
+        m_pruner->disconnect(this);
+        m_pruner->requestInterruption();
+        m_pruner->wait();
+    }
+
+    for(auto & shard : m_shards) {
+        shutdownWorker(*shard);
+
+        if(shard->thread) {
+            shard->thread->quit();
+            shard->thread->wait();
+        }
+    }
+
+    m_shards.clear();
+    m_bandwidthTimer.stop();
+    m_scanner.reset();
+    m_indexScanner.reset();
+    m_planner.reset();
+    m_pruner.reset();
+    m_pendingIndex.reset();
+    m_telemetry.reset();
+    m_running = false;
+}
+
+/**
+ * @brief Set whether rsync's output is processed on a dedicated thread.
+ *
+ * @param use @b true to use a worker thread, @b false to process the output in
+ * the Process's own thread.
+ *
+ * This must be called before start(); it has no effect on a process that has
+ * already been started.
+ */
+void Process::setUseWorkerThread(bool use)
+{
+    if(hasStarted()) {
+        qWarning() << __PRETTY_FUNCTION__ << "can't change the worker thread setting once the process has been started";
+        return;
+    }
+
+    m_useWorkerThread = use;
+}
+
+/**
+ * @brief Set whether a local source is scanned to estimate overall progress.
+ *
+ * @param scan @b true to scan the source, @b false to base overall progress
+ * on rsync's item counts alone.
+ *
+ * This must be called before start(); it has no effect on a process that has
+ * already been started. Scanning reads the whole source tree a second time, so
+ * it may be worth disabling for very large sources on slow disks.
+ */
+void Process::setScanSource(bool scan)
+{
+    if(hasStarted()) {
+        qWarning() << __PRETTY_FUNCTION__ << "can't change the source scan setting once the process has been started";
+        return;
+    }
+
+    m_scanSource = scan;
+}
+
+/**
+ * @brief Set the format in which rsync reports its progress.
+ *
+ * @param format The format. OutputFormat::Structured needs rsync 3.1 or later;
+ * use outputFormatFor() to find out whether the rsync being run supports it.
+ *
+ * This must be called before start(); it has no effect on a process that has
+ * already been started. The format is kept if the process is rearmed.
+ */
+void Process::setOutputFormat(OutputFormat format)
+{
+    if(hasStarted()) {
+        qWarning() << __PRETTY_FUNCTION__ << "can't change the output format once the process has been started";
+        return;
+    }
+
+    if(format == m_outputFormat) {
+        return;
+    }
+
+    // the output options are the same whatever the preset, so they can be swapped in place
+    const auto & current = outputArguments(m_outputFormat);
+    const auto at = m_args.indexOf(current.first());
+
+    if(-1 != at) {
+        m_args.erase(m_args.begin() + at, m_args.begin() + at + current.size());
+        const auto & replacement = outputArguments(format);
+
+        for(int index = 0; index < replacement.size(); ++index) {
+            m_args.insert(at + index, replacement[index]);
+        }
+    }
+
+    m_outputFormat = format;
+}
+
+/**
+ * @brief Work out which output format an rsync supports.
+ *
+ * @param capabilities What the rsync can do (see RsyncProbe).
+ *
+ * @return OutputFormat::Structured if rsync has the @b --info option,
+ * OutputFormat::Text otherwise or if its capabilities aren't known.
+ */
+Process::OutputFormat Process::outputFormatFor(const RsyncCapabilities & capabilities)
+{
+    return capabilities.supportsInfo() ? OutputFormat::Structured : OutputFormat::Text;
+}
+
+/**
+ * @brief Restrict the process to some of the entries in the source.
+ *
+ * @param paths The paths of the entries to synchronise, relative to the source.
+ * Directories in the list are not synchronised recursively: their own
+ * attributes are updated but their content is only synchronised if it is also
+ * listed.
+ *
+ * This must be called before start(); it has no effect on a process that has
+ * already been started. It only applies to local directory sources. A process
+ * restricted to paths runs a single rsync and does not use or update the
+ * source index.
  */
-Process::~Process() = default;
+void Process::setPaths(QStringList paths)
+{
+    if(hasStarted()) {
+        qWarning() << __PRETTY_FUNCTION__ << "can't change the paths once the process has been started";
+        return;
+    }
+
+    m_paths = std::move(paths);
+}
 
 /**
  * @brief Build a set of rsync arguments.
@@ -131,342 +743,1607 @@ Process::~Process() = default;
  * @param preset is the preset from which to build the arguments.
  * @param forceOptions is a set of extra rsync arguments to add to the
  * returned list.
+ * @param format is the format in which rsync is asked to report its progress.
  *
  * Given a Preset object, this method will produce the set of
  * arguments for @b rsync that correstponds to the settings in the
  * preset. The list of arguments returned is suitable for use as
  * the @b args parameter for a call to QProcess::start();
  *
+ * The options for the preset's settings come from the tables in
+ * presetproperties.h, in the order they are listed there: the boolean options
+ * first, then the string and integer options whose values are set. The
+ * remote shell, if the preset needs one other than rsync's default for its
+ * source, destination or any of its fan-out destinations, and the source and
+ * destination come from RemoteShell. The fan-out destinations are not in the
+ * arguments; Process replaces the destination with each of them in turn.
+ *
  * It is possible to force the use of certain @b rsync arguments using
  * the forceOptions parameter. Any options in this list are inserted
  * into the returned list, even if this means an argument appears in the
  * list more than once.
  *
- *@return A list of arguments.
+ *@return A list of arguments.
+ */
+QStringList Process::rsyncArguments(const Preset & preset, const QStringList & forceOptions, OutputFormat format)
+{
+    if(preset.source().isEmpty()) {
+        qCritical() << __PRETTY_FUNCTION__ << "Preset's source is empty";
+        return {};
+    }
+
+    if(preset.destination().isEmpty()) {
+        qCritical() << __PRETTY_FUNCTION__ << "Preset's destination is empty";
+        return {};
+    }
+
+    QStringList args(forceOptions);
+    args.push_back("--recursive");
+    args.append(outputArguments(format));
+
+    // the options for the preset's properties, in table order
+    for(const auto & property : PresetProperties::booleanProperties) {
+        if(property.rsyncOption && (preset.*(property.getter))() && (!property.onlyWith || (preset.*(property.onlyWith))())) {
+            args.push_back(QString::fromLatin1(property.rsyncOption));
+        }
+    }
+
+    for(const auto & property : PresetProperties::stringProperties) {
+        if(property.rsyncOption && !(preset.*(property.getter))().isEmpty() && (!property.onlyWith || (preset.*(property.onlyWith))())) {
+            args.push_back(QString::fromLatin1(property.rsyncOption) % (preset.*(property.getter))());
+        }
+    }
+
+    for(const auto & property : PresetProperties::integerProperties) {
+        if(property.rsyncOption && 0 < (preset.*(property.getter))() && (!property.onlyWith || (preset.*(property.onlyWith))())) {
+            args.push_back(QString::fromLatin1(property.rsyncOption) % QString::number((preset.*(property.getter))()));
+        }
+    }
+
+    /* source and dest */
+    const auto source = RemoteShell::endpointFor(preset, preset.source());
+    const auto destination = RemoteShell::endpointFor(preset, preset.destination());
+
+    const auto fanOutDestinations = preset.fanOutDestinationList();
+
+    const auto isShellEndpoint = [&preset](const QString & path) {
+        return RemoteShell::isShellEndpoint(RemoteShell::endpointFor(preset, path));
+    };
+
+    if(RemoteShell::isShellEndpoint(source) || RemoteShell::isShellEndpoint(destination) || std::any_of(fanOutDestinations.cbegin(), fanOutDestinations.cend(), isShellEndpoint)) {
+        if(const auto shell = RemoteShell::commandFor(preset); !shell.isEmpty()) {
+            args.push_back(QStringLiteral("--rsh=") % shell);
+        }
+    }
+
+    args.push_back(source);
+    args.push_back(destination);
+
+    return args;
+}
+
+/**
+ * @brief Provides a default explanation of an exit code.
+ *
+ * @param code is the exit code to explain.
+ *
+ * The explanation will be a null string if the code is not valid.
+ *
+ * @return The explanation.
+ */
+const QString & Process::defaultExitCodeMessage(const Process::ExitCode & code)
+{
+    static const QString emptyString;
+
+    static std::map<ExitCode, QString> s_messages = {
+      {ExitCode::Success, tr("The rsync process completed successfully.")},
+      {ExitCode::SyntaxError, tr("The rsync process could not be started because one or more arguments were not valid.")},
+      {ExitCode::ProtocolIncompatibility, tr("The rysnc process could not be started because the source and destination rsync versions are incompatible.")},
+      {ExitCode::FileSelectionError, tr("The rsync process failed because one or more source files or directories could not be found.")},
+      {ExitCode::UnsupportedAction, tr("The rsync process failed because the action requested is not supported.\n\nThis usually means you attempted to transfer data from a 32-bit computer to a 64-bit computer, or vice versa.")},
+      {ExitCode::TransmissionProtocolStartupError, tr("The rsync process failed because it was unable to initialise its data transmission protocol.")},
+      {ExitCode::UnableToWriteLogFile, tr("The rsync process completed but was unable to write to its log file.")},
+      {ExitCode::SocketIoError, tr("The rsync process failed because it encountered a network input/output error.")},
+      {ExitCode::FileIoError, tr("The rsync process failed because it encountered a file input/output error.")},
+      {ExitCode::DataStreamError, tr("The rsync process failed because of a failure in the transmission protocol's data stream.")},
+      {ExitCode::ProgramDiagnosticsError, tr("The rsync process failed because it was unable successfully to complete some internal diagnostics.")},
+      {ExitCode::IpcCodeError, tr("The rsync process failed because of an inter-process communication problem.")},
+      {ExitCode::InterruptReceived, tr("The rsync process was interrupted by the operating system.")},
+      {ExitCode::WaitpidError, tr("The rsync process failed while waiting for a process state to change.")},
+      {ExitCode::MemoryAllocationError, tr("The rsync process failed because it was unable to allocate some memory.")},
+      {ExitCode::PartialTransferError, tr("The rsync process completed but some files or directories were only partially transferred.\n\nThis could mean that the destination filesystem does not support some features (such as access permissions or ownership).")},
+      {ExitCode::VanishedSourceFile, tr("The rsync process failed because a source file or directory vanished while rsync was transferring its contents.")},
+      {ExitCode::MaximumDeletionsExceeded, tr("The rsync process aborted because the maximum number of deletions was exceeded.")},
+      {ExitCode::DataTransmissionTimeout, tr("The rsync process failed because it had to wait too long for data to be transmitted.")},
+      {ExitCode::ConnectionTimeout, tr("The rsync process failed because its network connection timed out.")},
+      {ExitCode::FailedToStart, tr("The rsync process could not be started. Check that rsync is installed and that the path to it in the preferences is correct.")},
+      {ExitCode::Crashed, tr("The rsync process crashed or was killed before it finished.")},
+      {ExitCode::RemoteShellError, tr("The rsync process failed because the remote shell could not connect to the remote host.")},
+    };
+
+    if(s_messages.end() == s_messages.find(code)) {
+        return emptyString;
+    }
+
+    return s_messages[code];
+}
+
+/**
+ * @brief Fetch the rsync options for an output format.
+ *
+ * @param format The format.
+ *
+ * For OutputFormat::Text these are the options Qync has always used, so that
+ * the arguments for a text run (and so the names of source index files) are
+ * unchanged. OutputFormat::Structured asks for whole-transfer progress and
+ * tab-separated item lines without digit grouping (see RsyncOutputParser).
+ *
+ * @return The options.
+ */
+const QStringList & Process::outputArguments(OutputFormat format)
+{
+    static const QStringList s_text = {
+      QStringLiteral("--progress"),
+      QStringLiteral("--verbose"),
+      QStringLiteral("--out-format=f%n %l"),
+    };
+
+    static const QStringList s_structured = {
+      QStringLiteral("--info=progress2,name,stats1"),
+      QStringLiteral("--no-human-readable"),
+      QStringLiteral("--out-format=F%i\t%l\t%b\t%C\t%n"),
+    };
+
+    return (OutputFormat::Structured == format ? s_structured : s_text);
+}
+
+/**
+ * @brief Start the process.
+ *
+ * Once the process has started, the started() signal will be emitted
+ * and other progress and information signals will start to be emitted.
+ */
+void Process::start()
+{
+    Q_ASSERT_X(!hasStarted(), __PRETTY_FUNCTION__, "the process has already been started");
+    m_running = true;
+    m_runTimer.start();
+
+    // the last run's store stays valid for anything still showing its items
+    m_pathStore = std::make_shared<PathStore>();
+
+    if(!m_telemetryDirectory.isEmpty()) {
+        m_telemetry = std::make_unique<TransferTelemetry>();
+        m_telemetry->setStartTime(QDateTime::currentMSecsSinceEpoch());
+        m_telemetry->setPathStore(m_pathStore);
+        m_lastTelemetrySample = 0;
+    }
+
+    m_retryCount = 0;
+    m_resumedBytes = 0;
+    m_overallProgress = 0;
+    m_overallProgressFloor = 0;
+    m_adaptive.reset(0);
+    m_adaptive.setCeiling(Detail::Process::tighterLimit(scheduledBandwidthLimit(), m_bandwidthShare));
+    m_preferredBandwidthLimit = preferredBandwidthLimit();
+    m_bandwidthLimit = Detail::Process::tighterLimit(m_preferredBandwidthLimit, m_bandwidthShare);
+    scheduleBandwidthUpdate();
+    m_snapshotName.clear();
+    m_snapshotTarget.clear();
+    m_snapshotLinkTarget.clear();
+
+    if(usesSnapshots() && 2 <= m_args.size()) {
+        prepareSnapshot();
+    }
+
+    if(m_paths && !usesSnapshots() && !m_useLocalCopier && 2 <= m_args.size() && ShardPlanner::canShard(m_source)) {
+        if(!startRsyncForPaths(*m_paths)) {
+            qWarning() << __PRETTY_FUNCTION__ << "synchronising the whole source instead of the paths given";
+            startRsync();
+        }
+    }
+    else if(usesSourceIndex() && 2 <= m_args.size() && ShardPlanner::canShard(m_source)) {
+        // rsync is started when the scan is complete
+        m_indexScanner = std::make_unique<SourceScanner>(m_source);
+        m_indexScanner->setRecordEntries(true);
+        connect(m_indexScanner.get(), &SourceScanner::finished, this, &Process::onSourceIndexed, Qt::QueuedConnection);
+        m_indexScanner->start();
+    }
+    else {
+        startRsync();
+    }
+
+    Q_EMIT started();
+}
+
+/**
+ * @brief Start rsync for the whole source.
+ *
+ * For a parallel run the source is split first, and the rsync processes are
+ * started once the plan is ready.
+ */
+void Process::startRsync()
+{
+    if(m_scanSource && SourceScanner::canScan(m_source)) {
+        // runs alongside rsync; until it's done the item counts are used
+        m_scanner = std::make_unique<SourceScanner>(m_source);
+        connect(m_scanner.get(), &SourceScanner::finished, this, &Process::emitOverallProgress, Qt::QueuedConnection);
+        m_scanner->start();
+    }
+
+    if(1 < m_shardCount && 2 <= m_args.size() && ShardPlanner::canShard(m_source)) {
+        // the shards are started when the plan is ready
+        m_planner = std::make_unique<ShardPlanner>(m_source, m_shardCount);
+        connect(m_planner.get(), &QThread::finished, this, &Process::onShardsPlanned);
+        m_planner->start();
+    }
+    else {
+        startDestinations(m_args, m_logFileName);
+    }
+}
+
+/**
+ * @brief Attempt to stop the process.
+ *
+ * If the process has been started, this will attempt to interrupt it.
+ * If the attempt is successful, the interrupted() signal will be
+ * emitted. No error messages will be generated by a call to this slot.
+ */
+void Process::stop()
+{
+    if(!m_running || m_stopRequested) {
+        return;
+    }
+
+    m_stopRequested = true;
+
+    if(m_planner) {
+        m_planner->requestInterruption();
+    }
+
+    if(m_pruner) {
+        // the rest are expired again after the next run
+        m_pruner->requestInterruption();
+    }
+
+    if(m_indexScanner) {
+        // rsync hasn't been started, so there won't be a Finished event
+        m_indexScanner->disconnect(this);
+        m_indexScanner.reset();
+
+        QMetaObject::invokeMethod(this, [this]() {
+            onProcessFinished(ExitCode::InterruptReceived);
+        }, Qt::QueuedConnection);
+    }
+
+    for(auto & shard : m_shards) {
+        if(shard->retryTimer.isActive()) {
+            // rsync isn't running, so there won't be a Finished event
+            shard->retryTimer.stop();
+            auto * shardPtr = shard.get();
+
+            QMetaObject::invokeMethod(this, [this, shardPtr]() {
+                onShardFinished(*shardPtr, ExitCode::InterruptReceived);
+            }, Qt::QueuedConnection);
+        }
+        else if(shard->waiting) {
+            // rsync hasn't been started, so there won't be a Finished event
+            auto * shardPtr = shard.get();
+
+            QMetaObject::invokeMethod(this, [this, shardPtr]() {
+                onShardFinished(*shardPtr, ExitCode::InterruptReceived);
+            }, Qt::QueuedConnection);
+        }
+        else if(shard->copier) {
+            shard->copier->stop();
+        }
+        else if(!shard->finished) {
+            QMetaObject::invokeMethod(shard->worker.get(), "stop");
+        }
+    }
+
+    Q_EMIT interrupted("");
+}
+
+/**
+ * @brief Start the rsync processes for a parallel run once the source has been
+ * split.
+ *
+ * Each shard's entries are written to a temporary file for rsync's --files-from
+ * option, and the source argument is replaced with the directory to which the
+ * entries are relative. If the plan has only one shard, or the temporary files
+ * can't be written, a single rsync is run with the original arguments.
+ */
+void Process::onShardsPlanned()
+{
+    Q_ASSERT_X(m_planner, __PRETTY_FUNCTION__, "no shard planner");
+    m_planner->wait();
+
+    if(m_stopRequested) {
+        m_planner.reset();
+        onProcessFinished(ExitCode::InterruptReceived);
+        return;
+    }
+
+    const auto & plan = m_planner->shards();
+    std::vector<std::unique_ptr<QTemporaryFile>> fileLists;
+
+    if(1 < plan.size()) {
+        for(const auto & entries : plan) {
+            auto fileList = std::make_unique<QTemporaryFile>();
+
+            if(!fileList->open()) {
+                qWarning() << __PRETTY_FUNCTION__ << "failed to create file list for shard:" << fileList->errorString() << "; running a single rsync process";
+                fileLists.clear();
+                break;
+            }
+
+            for(const auto & entry : entries) {
+                // rsync reads the names as raw bytes, NUL-terminated because of --from0
+                fileList->write(QFile::encodeName(entry));
+                fileList->putChar('\0');
+            }
+
+            fileList->close();
+            fileLists.push_back(std::move(fileList));
+        }
+    }
+
+    if(fileLists.empty()) {
+        startShard(m_args, m_logFileName);
+    }
+    else {
+        int shardNumber = 0;
+
+        for(auto & fileList : fileLists) {
+            ++shardNumber;
+            QStringList args = m_args;
+            args[args.size() - 2] = m_planner->baseDirectory();
+            args.prepend("--from0");
+            args.prepend("--files-from=" + fileList->fileName());
+            QString logFileName = (m_logFileName.isEmpty() ? QString() : m_logFileName + QStringLiteral(".shard%1").arg(shardNumber));
+            startShard(std::move(args), std::move(logFileName), std::move(fileList));
+        }
+    }
+
+    m_planner.reset();
+}
+
+/**
+ * @brief Start rsync once the source has been scanned for an indexed run.
+ *
+ * If there is a saved index, rsync is given the entries that have changed since
+ * it was saved. Otherwise, or if the list of entries can't be written, rsync is
+ * run on the whole source. The new index is kept to be saved when rsync
+ * succeeds.
+ */
+void Process::onSourceIndexed()
+{
+    Q_ASSERT_X(m_indexScanner, __PRETTY_FUNCTION__, "no source index scanner");
+    auto entries = m_indexScanner->takeEntries();
+    m_indexScanner.reset();
+
+    auto index = std::make_unique<SourceIndex>(m_indexFileName);
+    QStringList changedPaths;
+    bool haveIndex = index->load();
+
+    if(haveIndex) {
+        changedPaths = index->changedPaths(entries);
+    }
+
+    index->setEntries(entries);
+
+    if(!isDryRun()) {
+        m_pendingIndex = std::move(index);
+    }
+
+    if(!haveIndex || !startRsyncForPaths(changedPaths)) {
+        startRsync();
+    }
+}
+
+/**
+ * @brief Start a single rsync for some of the entries in the source.
+ *
+ * @param paths The paths of the entries, relative to the source.
+ *
+ * The entries are written to a temporary file for rsync's --files-from option
+ * and the source argument is replaced with the directory to which they are
+ * relative. rsync is also given --no-recursive, so a directory in the list
+ * is created or updated but its content is only transferred if it is listed
+ * too. Every fan-out destination is given the same list.
+ *
+ * @return @b true if rsync was started, @b false if the list of entries could
+ * not be written.
+ */
+bool Process::startRsyncForPaths(const QStringList & paths)
+{
+    auto fileList = std::make_unique<QTemporaryFile>();
+
+    if(!fileList->open()) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to create file list:" << fileList->errorString();
+        return false;
+    }
+
+    QString prefix;
+    QString baseDirectory = filesFromBaseDirectory(m_source, prefix);
+
+    for(const auto & path : paths) {
+        fileList->write(QFile::encodeName(prefix + path));
+        fileList->putChar('\0');
+    }
+
+    fileList->close();
+    QStringList args = m_args;
+    args[args.size() - 2] = baseDirectory;
+    // --files-from would otherwise recurse into every directory listed
+    args.insert(args.size() - 2, QStringLiteral("--no-recursive"));
+    args.prepend("--from0");
+    args.prepend("--files-from=" + fileList->fileName());
+    startDestinations(std::move(args), m_logFileName, std::move(fileList));
+    return true;
+}
+
+/**
+ * @brief Start rsync for the preset's destination and each of its fan-out
+ * destinations.
+ *
+ * @param args The arguments for rsync for the preset's destination.
+ * @param logFileName The log file for the preset's destination. Each fan-out
+ * destination has its own, with the destination's number appended.
+ * @param filesFrom The file list given to rsync with --files-from, if any.
+ *
+ * Every rsync is given the same arguments apart from the destination, so they
+ * all use the same file list and the source is scanned only once however many
+ * destinations there are. Without fan-out destinations this is just
+ * startShard().
+ */
+void Process::startDestinations(QStringList args, QString logFileName, std::unique_ptr<QTemporaryFile> filesFrom)
+{
+    // the first shard keeps the file list; the others only need its name, which is in the arguments
+    const auto nodeArgs = args;
+    startShard(std::move(args), logFileName, std::move(filesFrom));
+    int node = 0;
+
+    for(const auto & destination : m_fanOutDestinations) {
+        ++node;
+        auto destinationArgs = nodeArgs;
+        destinationArgs.last() = destination;
+        QString destinationLogFileName = (logFileName.isEmpty() ? QString() : logFileName + QStringLiteral(".node%1").arg(node));
+        startShard(std::move(destinationArgs), std::move(destinationLogFileName), {}, node);
+    }
+}
+
+/**
+ * @brief Start one rsync process.
+ *
+ * @param args The arguments for rsync.
+ * @param logFileName The log file for the process's output. If empty, the output
+ * is not logged.
+ * @param filesFrom The file list given to rsync with --files-from, if any. It is
+ * kept until the Process is destroyed.
+ * @param node The fan-out destination the rsync is for, 0 for the preset's own
+ * destination.
+ *
+ * If the preset's fan-out concurrency is already taken up by other
+ * destinations, the shard waits until one of them has finished.
+ */
+void Process::startShard(QStringList args, QString logFileName, std::unique_ptr<QTemporaryFile> filesFrom, int node)
+{
+    auto shard = std::make_unique<Shard>(Detail::Process::EventQueueCapacity);
+    auto * shardPtr = shard.get();
+    shard->filesFrom = std::move(filesFrom);
+    shard->args = std::move(args);
+    shard->logFileName = std::move(logFileName);
+    shard->node = node;
+    shard->retryTimer.setSingleShot(true);
+
+    connect(&shard->retryTimer, &QTimer::timeout, this, [this, shardPtr]() {
+        if(m_running && !m_stopRequested) {
+            restartShard(*shardPtr);
+        }
+    });
+
+    const auto active = std::count_if(m_shards.cbegin(), m_shards.cend(), [](const auto & other) {
+        return !other->finished && !other->waiting;
+    });
+
+    m_shards.push_back(std::move(shard));
+
+    if(0 < node && 0 < m_fanOutConcurrency && m_fanOutConcurrency <= active) {
+        shardPtr->waiting = true;
+        return;
+    }
+
+    launchShard(*shardPtr);
+}
+
+/**
+ * @brief Start the first of the fan-out destinations that is waiting for
+ * another to finish.
+ */
+void Process::startWaitingShard()
+{
+    const auto shard = std::find_if(m_shards.cbegin(), m_shards.cend(), [](const auto & candidate) {
+        return candidate->waiting;
+    });
+
+    if(m_shards.cend() == shard) {
+        return;
+    }
+
+    (*shard)->waiting = false;
+    launchShard(**shard);
+}
+
+/**
+ * @brief Give a shard its thread, if it has one, and start its worker.
+ *
+ * @param shard The shard.
+ */
+void Process::launchShard(Shard & shard)
+{
+    if(m_useWorkerThread && !m_useLocalCopier) {
+        shard.thread = std::make_unique<QThread>();
+        shard.thread->start();
+    }
+
+    startWorker(shard);
+}
+
+/**
+ * @brief Start a worker to run a shard's rsync.
+ *
+ * @param shard The shard. It must not have a worker.
+ * @param appendToLog Whether rsync's output is added to the end of the shard's
+ * log rather than replacing it.
+ *
+ * rsync is given the shard's arguments with the bandwidth options for the
+ * current bandwidthLimit() and the options to resume after a retry. Only the
+ * preset's own destination is given the snapshot options; the fan-out
+ * destinations are synchronised directly.
+ */
+void Process::startWorker(Shard & shard, bool appendToLog)
+{
+    Q_ASSERT_X(!shard.worker && !shard.copier, __PRETTY_FUNCTION__, "the shard already has a worker");
+    auto * shardPtr = &shard;
+
+    if(m_useLocalCopier) {
+        // the copier has threads of its own
+        shard.copier = std::make_unique<LocalCopier>(m_source, m_destination, m_localCopierOptions, shard.events);
+
+        connect(shard.copier.get(), &LocalCopier::eventsAvailable, this, [this, shardPtr]() {
+            dispatchEvents(*shardPtr);
+        }, Qt::QueuedConnection);
+
+        shard.copier->start();
+        return;
+    }
+
+    shard.worker = std::make_unique<ProcessWorker>(m_command, bandwidthArguments(resumeArguments(0 == shard.node ? snapshotArguments(shard.args) : shard.args)), shard.logFileName, shard.events, m_logRotationSize, m_logRotationCount);
+    shard.worker->setOutputFormat(OutputFormat::Structured == m_outputFormat ? RsyncOutputParser::Format::Structured : RsyncOutputParser::Format::Text);
+    shard.worker->setAppendToLog(appendToLog);
+
+    if(shard.thread) {
+        shard.worker->moveToThread(shard.thread.get());
+    }
+
+    // always queued: the worker must never be on the stack when a receiver of one
+    // of our signals destroys us
+    connect(shard.worker.get(), &ProcessWorker::eventsAvailable, this, [this, shardPtr]() {
+        dispatchEvents(*shardPtr);
+    }, Qt::QueuedConnection);
+
+    QMetaObject::invokeMethod(shard.worker.get(), "start");
+}
+
+/**
+ * @brief Release a shard's worker, killing its rsync if it is still running.
+ *
+ * @param shard The shard.
+ *
+ * The shard's thread, if it has one, is left running.
+ */
+void Process::shutdownWorker(Shard & shard)
+{
+    if(shard.copier) {
+        // waits for the copier's threads
+        shard.copier->disconnect(this);
+        shard.copier.reset();
+    }
+
+    if(!shard.worker) {
+        return;
+    }
+
+    shard.worker->disconnect(this);
+
+    if(shard.thread) {
+        QMetaObject::invokeMethod(shard.worker.get(), "shutdown", Qt::BlockingQueuedConnection);
+    }
+    else {
+        shard.worker->shutdown();
+    }
+}
+
+/**
+ * @brief Start a shard's rsync again after it has been stopped for a new
+ * bandwidth limit or has failed and is being retried.
+ *
+ * @param shard The shard.
+ *
+ * The new rsync appends to the shard's log. It skips whatever the old one
+ * finished, so what it reports is added to what the shard has already done;
+ * the item the old one was working on is reported again by the new one, so it
+ * is forgotten here.
+ */
+void Process::restartShard(Shard & shard)
+{
+    shutdownWorker(shard);
+
+    // the worker might belong to the shard's thread, which is still running
+    if(shard.worker) {
+        shard.worker.release()->deleteLater();
+    }
+
+    shard.bytesPerSecond = 0.0;
+    shard.listedBytes -= std::min(shard.listedBytes, shard.currentItemSize);
+    shard.currentItemSize = 0;
+    shard.currentItemBytes = 0;
+    shard.transferredBytesBefore = shard.transferredBytes;
+    m_pathStore->release(shard.telemetryItem);
+    shard.telemetryItem = PathStore::NoPath;
+    shard.hasTelemetryItem = false;
+    shard.restarting = false;
+
+    // the new rsync starts its counts again, and the progress shouldn't go back
+    m_overallProgressFloor = m_overallProgress;
+    startWorker(shard, true);
+}
+
+/**
+ * @brief Arrange for a shard's rsync to be run again after a transient failure.
+ *
+ * @param shard The shard.
+ * @param code The exit code of the failed rsync.
+ *
+ * The delay is the preset's retry delay for the first retry, doubling for each
+ * retry after that up to Detail::Process::MaximumRetryDelay. The part of the
+ * current item that had been transferred is counted as resumed, since the
+ * retry carries on from it rather than starting it again.
+ */
+void Process::scheduleRetry(Shard & shard, ExitCode code)
+{
+    ++shard.retries;
+    ++m_retryCount;
+    m_resumedBytes += shard.currentItemBytes;
+
+    auto delay = std::max(m_retryDelay, 1);
+
+    for(int retry = 1; retry < shard.retries && delay < Detail::Process::MaximumRetryDelay; ++retry) {
+        delay *= 2;
+    }
+
+    delay = std::min(delay, Detail::Process::MaximumRetryDelay);
+    qWarning() << __PRETTY_FUNCTION__ << "rsync exited with code" << static_cast<int>(code) << "- retry" << shard.retries << "of" << m_retryAttempts << "in" << delay << "seconds";
+    shard.bytesPerSecond = 0.0;
+    shard.retryTimer.start(delay * 1000);
+    Q_EMIT transferSpeed(static_cast<float>(aggregateTransferSpeed()));
+    Q_EMIT retrying(code, shard.retries, delay);
+}
+
+/**
+ * @brief Emit the signals for the events a shard's worker has queued.
+ *
+ * @param shard The shard.
+ *
+ * The queue is drained completely. If the worker stopped reading because the
+ * queue was full, it is told to resume once there is room again.
+ */
+void Process::dispatchEvents(Shard & shard)
+{
+    Instrumentation::Scope scope(Instrumentation::Histogram::DispatchTime, "Process::dispatchEvents");
+    if(shard.copier) {
+        shard.copier->acknowledgeEvents();
+    }
+    else {
+        shard.worker->acknowledgeEvents();
+    }
+
+    ProcessEvent event;
+
+    while(shard.events.pop(event)) {
+        Instrumentation::add(Instrumentation::Counter::EventsDispatched);
+
+        switch(event.type) {
+            case ProcessEvent::Type::Progress:
+                if(m_stopRequested) {
+                    break;
+                }
+
+                shard.bytesPerSecond = event.bytesPerSecond;
+                shard.currentItemBytes = std::min(event.itemBytes, shard.currentItemSize);
+                sampleTelemetry();
+                sampleBandwidth();
+                Q_EMIT transferSpeed(static_cast<float>(aggregateTransferSpeed()));
+
+                // every destination gets the same items, so only the first's are reported
+                if(0 == shard.node) {
+                    Q_EMIT itemProgressBytes(static_cast<int>(std::min<quint64>(event.itemBytes, std::numeric_limits<int>::max())));
+                    Q_EMIT itemProgress(event.itemPercent);
+                    Q_EMIT itemSecondsRemaining(event.secondsRemaining);
+                }
+
+                if(event.hasCheckCounts && 0 < event.totalItems) {
+                    shard.hasCheckCounts = true;
+                    shard.itemsRemaining = event.itemsRemaining;
+                    shard.totalItems = event.totalItems;
+                }
+
+                if(shard.hasCheckCounts || hasScanTotals()) {
+                    emitOverallProgress();
+                }
+                break;
+
+            case ProcessEvent::Type::TransferProgress:
+                if(m_stopRequested) {
+                    break;
+                }
+
+                shard.bytesPerSecond = event.bytesPerSecond;
+                shard.hasTransferTotals = true;
+                shard.transferredBytes = shard.transferredBytesBefore + event.transferredBytes;
+                shard.transferPercent = event.transferPercent;
+                shard.transferSecondsRemaining = event.secondsRemaining;
+
+                if(event.hasCheckCounts && 0 < event.totalItems) {
+                    shard.hasCheckCounts = true;
+                    shard.itemsRemaining = event.itemsRemaining;
+                    shard.totalItems = event.totalItems;
+                }
+
+                sampleTelemetry();
+                sampleBandwidth();
+                Q_EMIT transferSpeed(static_cast<float>(aggregateTransferSpeed()));
+                Q_EMIT bytesTransferred(transferredBytes());
+                emitOverallProgress();
+                break;
+
+            case ProcessEvent::Type::NewItem:
+                onShardNewItem(shard, event);
+                break;
+
+            case ProcessEvent::Type::Completed:
+                shard.bytesSent = event.bytesSent;
+                shard.bytesReceived = event.bytesReceived;
+
+                if(!m_stopRequested) {
+                    shard.bytesPerSecond = event.bytesPerSecond;
+                    Q_EMIT transferSpeed(static_cast<float>(aggregateTransferSpeed()));
+                }
+                break;
+
+            case ProcessEvent::Type::Finished:
+                // always the last event, and receivers are entitled to destroy us in response
+                onShardFinished(shard, static_cast<ExitCode>(event.exitCode));
+                return;
+        }
+    }
+
+    if(shard.copier ? shard.copier->isStalled() : shard.worker->isStalled()) {
+        QMetaObject::invokeMethod((shard.copier ? static_cast<QObject *>(shard.copier.get()) : shard.worker.get()), "resume", Qt::QueuedConnection);
+    }
+}
+
+/**
+ * @brief Called when a shard's rsync lists an item.
+ *
+ * @param shard The shard.
+ * @param event The NewItem event.
+ *
+ * The item's path is only added to the path store while something other than
+ * the process is holding the store, which is the only way anything can look it
+ * up; otherwise the item signals carry PathStore::NoPath. The reference add()
+ * gives the process is released once the signals have been emitted, so the
+ * path only stays in the store if a receiver has retained it.
+ */
+void Process::onShardNewItem(Shard & shard, const ProcessEvent & event)
+{
+    auto path = PathStore::NoPath;
+
+    if(0 == shard.node && 1 < m_pathStore.use_count()) {
+        path = m_pathStore->add(event.itemPath);
+    }
+
+    recordItemTelemetry(shard, &event, path);
+
+    // rsync only reports a new item once it's done with the previous one
+    shard.completedBytes += shard.currentItemSize;
+    shard.currentItemSize = event.itemSize;
+    shard.currentItemBytes = 0;
+    shard.listedBytes += event.itemSize;
+    ++shard.listedItems;
+
+    if(!m_stopRequested && 0 == shard.node) {
+        Q_EMIT newItemStarted(path);
+        Q_EMIT itemStarted(path, event.itemSize);
+        Q_EMIT itemChanged(path, event.itemChanges, event.itemSize);
+    }
+
+    m_pathStore->release(path);
+}
+
+/**
+ * @brief Called when a shard's worker reports that its rsync has finished.
+ *
+ * @param shard The shard.
+ * @param code The rsync exit code.
+ *
+ * Once the last shard has finished, the Process is finished with the exit code
+ * of the first shard that did not succeed. A shard whose rsync was stopped for
+ * a new bandwidth limit is started again instead, unless it had finished anyway,
+ * and one whose rsync failed for a transient reason is retried if it has any
+ * retries left. When a fan-out destination finishes, the next one waiting for
+ * it is started.
+ */
+void Process::onShardFinished(Shard & shard, ExitCode code)
+{
+    if(shard.restarting) {
+        shard.restarting = false;
+
+        if(ExitCode::Success != code && !m_stopRequested) {
+            restartShard(shard);
+            return;
+        }
+    }
+
+    if(!m_stopRequested && shard.retries < m_retryAttempts && Detail::Process::isTransientFailure(code)) {
+        scheduleRetry(shard, code);
+        return;
+    }
+
+    recordItemTelemetry(shard, nullptr, PathStore::NoPath);
+    shard.finished = true;
+    shard.waiting = false;
+    shard.exitCode = code;
+    ++m_finishedShards;
+
+    if(ExitCode::Success != code && !m_fanOutDestinations.isEmpty()) {
+        qWarning() << __PRETTY_FUNCTION__ << "rsync to" << shard.args.last() << "exited with code" << static_cast<int>(code);
+    }
+
+    if(ExitCode::Success == m_exitCode) {
+        m_exitCode = code;
+    }
+
+    if(m_finishedShards < static_cast<int>(m_shards.size())) {
+        if(!m_stopRequested) {
+            // a finished shard is complete and no longer transferring
+            shard.bytesPerSecond = 0.0;
+            shard.itemsRemaining = 0;
+            shard.completedBytes += shard.currentItemSize;
+            shard.currentItemSize = 0;
+            shard.currentItemBytes = 0;
+            Q_EMIT transferSpeed(static_cast<float>(aggregateTransferSpeed()));
+
+            if(shard.hasCheckCounts || hasScanTotals()) {
+                emitOverallProgress();
+            }
+
+            startWaitingShard();
+        }
+
+        return;
+    }
+
+    if(completeSnapshot()) {
+        // finishes when the expired snapshots have been removed
+        return;
+    }
+
+    onProcessFinished(m_exitCode);
+}
+
+/**
+ * @brief Record an item that a shard's rsync has finished with in the telemetry.
+ *
+ * @param shard The shard.
+ * @param event The NewItem event that finishes it, or @b nullptr if the shard's
+ * rsync has finished.
+ * @param path The Id of the path of the event's item in the path store, or
+ * PathStore::NoPath if it hasn't been stored.
+ *
+ * rsync doesn't report how long it spent on an item, so its duration is the
+ * time since the shard's previous item line. With structured output the event
+ * is the item that has been finished with; with text output it is the next
+ * item, and the one it replaces is recorded with the bytes seen in its
+ * progress lines. Only the items for the preset's own destination are
+ * recorded.
+ */
+void Process::recordItemTelemetry(Shard & shard, const ProcessEvent * event, PathStore::Id path)
+{
+    if(!m_telemetry || 0 != shard.node) {
+        return;
+    }
+
+    const auto now = static_cast<quint32>(m_runTimer.elapsed());
+    const auto duration = now - shard.telemetryItemStart;
+
+    if(OutputFormat::Structured == m_outputFormat) {
+        if(event) {
+            m_telemetry->addItem(path, event->itemSize, event->itemTransferredBytes, duration);
+        }
+    }
+    else if(shard.hasTelemetryItem) {
+        m_telemetry->addItem(shard.telemetryItem, shard.currentItemSize, shard.currentItemBytes, duration);
+        m_pathStore->release(shard.telemetryItem);
+        shard.telemetryItem = PathStore::NoPath;
+        shard.hasTelemetryItem = false;
+    }
+
+    if(event && OutputFormat::Text == m_outputFormat) {
+        m_pathStore->retain(path);
+        shard.telemetryItem = path;
+        shard.hasTelemetryItem = true;
+    }
+
+    shard.telemetryItemStart = now;
+}
+
+/**
+ * @brief Record the combined transfer speed in the telemetry.
+ *
+ * Nothing is recorded if a sample has been recorded less than
+ * Detail::Process::TelemetrySampleInterval milliseconds ago.
+ */
+void Process::sampleTelemetry()
+{
+    if(!m_telemetry) {
+        return;
+    }
+
+    const auto now = static_cast<quint32>(m_runTimer.elapsed());
+
+    if(0 < m_telemetry->sampleCount() && now - m_lastTelemetrySample < Detail::Process::TelemetrySampleInterval) {
+        return;
+    }
+
+    m_lastTelemetrySample = now;
+    m_telemetry->addSample(now, aggregateTransferSpeed());
+}
+
+/**
+ * @brief Complete the telemetry for the run and save it.
+ *
+ * @param code The exit code of the run.
+ *
+ * The run is saved by a TelemetryWriter alongside those of earlier runs of the
+ * same source and destination, the oldest of which are removed so that only
+ * Detail::Process::TelemetryRunsKept are kept. The process doesn't wait for
+ * it, so it can finish and even be started again while the record is being
+ * written.
+ */
+void Process::finishTelemetry(ExitCode code)
+{
+    if(!m_telemetry) {
+        return;
+    }
+
+    if(m_shards.empty()) {
+        // stopped before rsync was started, so there's nothing worth keeping
+        m_telemetry.reset();
+        return;
+    }
+
+    quint64 sentBytes = 0;
+    quint64 receivedBytes = 0;
+
+    for(const auto & shard : m_shards) {
+        sentBytes += shard->bytesSent;
+        receivedBytes += shard->bytesReceived;
+    }
+
+    m_telemetry->finish(static_cast<quint32>(m_runTimer.elapsed()), static_cast<int>(code), sentBytes, receivedBytes, hasScanTotals() ? m_scanner->totalBytes() : 0);
+
+    // one record at a time, so that pruning the directory doesn't race another save
+    if(m_telemetryWriter) {
+        m_telemetryWriter->disconnect(this);
+        m_telemetryWriter->wait();
+    }
+
+    m_telemetryWriter = std::make_unique<TelemetryWriter>(std::move(m_telemetry), m_telemetryDirectory, Detail::Process::TelemetryRunsKept);
+    connect(m_telemetryWriter.get(), &QThread::finished, this, &Process::onTelemetrySaved);
+    m_telemetryWriter->start();
+}
+
+/**
+ * @brief Dispose of the TelemetryWriter once it has saved the last run.
+ */
+void Process::onTelemetrySaved()
+{
+    Q_ASSERT_X(m_telemetryWriter, __PRETTY_FUNCTION__, "no telemetry writer");
+    m_telemetryWriter->wait();
+    m_telemetryWriter.reset();
+}
+
+/**
+ * @brief Work out the limit the preset's bandwidth schedule gives for now.
+ *
+ * @return The limit in KiB per second, 0 for none.
+ */
+int Process::scheduledBandwidthLimit() const
+{
+    return m_bandwidthSchedule.limitAt(QTime::currentTime(), m_defaultBandwidthLimit);
+}
+
+/**
+ * @brief Work out the bandwidth limit the process would like.
+ *
+ * This is the limit from the preset's schedule, lowered by the adaptive limit if
+ * the preset has adaptive bandwidth. It takes no account of the bandwidthShare().
+ *
+ * @return The limit in KiB per second, 0 for none.
+ */
+int Process::preferredBandwidthLimit() const
+{
+    return Detail::Process::tighterLimit(scheduledBandwidthLimit(), (m_adaptiveBandwidth ? m_adaptive.limit() : 0));
+}
+
+/**
+ * @brief Impose a bandwidth limit on the process.
+ *
+ * @param share The limit in KiB per second, 0 for none.
+ *
+ * The process uses the tighter of this and its preferredBandwidthLimit(). If
+ * it is running, rsync is restarted if the limit changes.
+ */
+void Process::setBandwidthShare(int share)
+{
+    share = std::max(share, 0);
+
+    if(share == m_bandwidthShare) {
+        return;
+    }
+
+    m_bandwidthShare = share;
+
+    if(m_running) {
+        updateBandwidthLimit();
+    }
+}
+
+/**
+ * @brief Check whether the bandwidth limit might change during a run.
+ *
+ * @return @b true if the preset has a schedule or adaptive bandwidth, or the
+ * process has a bandwidthShare(), @b false otherwise.
+ */
+bool Process::bandwidthLimitMayChange() const
+{
+    return RunType::DryRun != m_runType && (!m_bandwidthSchedule.isEmpty() || m_adaptiveBandwidth || 0 < m_bandwidthShare);
+}
+
+/**
+ * @brief Add the bandwidth options to a set of rsync arguments.
+ *
+ * @param args The arguments.
+ *
+ * @b --bwlimit is added for the current bandwidthLimit(). If the limit might
+ * change, @b --partial is added too so that restarting rsync for a new limit
+ * doesn't throw away the file it was part way through.
+ *
+ * @return The arguments.
+ */
+QStringList Process::bandwidthArguments(QStringList args) const
+{
+    if(RunType::DryRun == m_runType) {
+        return args;
+    }
+
+    if(bandwidthLimitMayChange() && !args.contains(QStringLiteral("--partial"))) {
+        args.prepend(QStringLiteral("--partial"));
+    }
+
+    if(0 < m_bandwidthLimit) {
+        args.prepend(QStringLiteral("--bwlimit=") % QString::number(m_bandwidthLimit));
+    }
+
+    return args;
+}
+
+/**
+ * @brief Add the options that let a retry resume where rsync left off.
+ *
+ * @param args The arguments.
+ *
+ * If rsync might be retried, @b --partial is added so that a failed rsync
+ * keeps the file it was part way through, and the retry uses it as the basis
+ * for the delta transfer, so only what is missing from it is sent. (With a
+ * partial directory rsync already does this.) A retry is deliberately not
+ * given @b --append-verify: that applies to every file in the run, and would
+ * skip any file whose destination copy is at least as long as the source even
+ * if it has changed.
+ *
+ * @return The arguments.
+ */
+QStringList Process::resumeArguments(QStringList args) const
+{
+    if(RunType::DryRun == m_runType || 0 == m_retryAttempts || m_usesPartialDirectory) {
+        return args;
+    }
+
+    if(!args.contains(QStringLiteral("--partial"))) {
+        args.prepend(QStringLiteral("--partial"));
+    }
+
+    return args;
+}
+
+/**
+ * @brief Give the adaptive bandwidth limit the combined transfer speed.
+ */
+void Process::sampleBandwidth()
+{
+    if(m_adaptiveBandwidth) {
+        m_adaptive.addSample(m_runTimer.elapsed(), aggregateTransferSpeed());
+    }
+}
+
+/**
+ * @brief Reconsider the bandwidth limit.
+ *
+ * The schedule and the adaptive limit are consulted and combined with the
+ * bandwidthShare(). If the resulting limit differs from the one rsync is using,
+ * each running rsync is stopped, and started again with the new limit when it
+ * has finished. A limit only a little higher than the current one isn't worth
+ * restarting for, so is ignored.
+ */
+void Process::updateBandwidthLimit()
+{
+    using Detail::Process::tighterLimit;
+
+    if(!m_running || m_stopRequested) {
+        return;
+    }
+
+    const auto now = m_runTimer.elapsed();
+    m_adaptive.setCeiling(tighterLimit(scheduledBandwidthLimit(), m_bandwidthShare));
+
+    if(m_adaptiveBandwidth) {
+        m_adaptive.update(now);
+    }
+
+    const auto preferred = preferredBandwidthLimit();
+    const auto limit = tighterLimit(preferred, m_bandwidthShare);
+    const bool isSmallRise = 0 < limit && 0 < m_bandwidthLimit && limit > m_bandwidthLimit && limit < m_bandwidthLimit * (1.0 + Detail::Process::MinimumBandwidthRise);
+
+    if(limit != m_bandwidthLimit && !isSmallRise) {
+        m_bandwidthLimit = limit;
+        bool restarted = false;
+
+        for(auto & shard : m_shards) {
+            // a shard waiting to be retried picks up the new limit when it is
+            if(shard->finished || shard->waiting || shard->restarting || shard->retryTimer.isActive() || shard->copier) {
+                continue;
+            }
+
+            // the worker terminates rsync gently so that --partial keeps the current file
+            shard->restarting = true;
+            restarted = true;
+            QMetaObject::invokeMethod(shard->worker.get(), "interrupt");
+        }
+
+        if(restarted) {
+            // the restarted rsyncs are slower while they catch up
+            m_adaptive.settle(now);
+        }
+    }
+
+    scheduleBandwidthUpdate();
+
+    if(preferred != m_preferredBandwidthLimit) {
+        m_preferredBandwidthLimit = preferred;
+        Q_EMIT preferredBandwidthLimitChanged(preferred);
+    }
+}
+
+/**
+ * @brief Arrange for the bandwidth limit to be reconsidered.
+ *
+ * The limit is reconsidered just after the schedule next moves from one
+ * period to another and, with adaptive bandwidth, regularly. Changes to the
+ * bandwidthShare() take effect straight away.
+ */
+void Process::scheduleBandwidthUpdate()
+{
+    if(!bandwidthLimitMayChange()) {
+        m_bandwidthTimer.stop();
+        return;
+    }
+
+    // a second late, to be sure the next period has begun
+    auto interval = m_bandwidthSchedule.msecsToNextChange(QTime::currentTime());
+
+    if(0 <= interval) {
+        interval += 1000;
+    }
+
+    if(m_adaptiveBandwidth) {
+        interval = (0 > interval ? Detail::Process::AdaptiveBandwidthInterval : std::min(interval, Detail::Process::AdaptiveBandwidthInterval));
+    }
+
+    if(0 > interval) {
+        m_bandwidthTimer.stop();
+        return;
+    }
+
+    m_bandwidthTimer.start(interval);
+}
+
+/**
+ * @brief Calculate the combined transfer speed of all the shards.
+ *
+ * @return The speed in bytes per second.
+ */
+double Process::aggregateTransferSpeed() const
+{
+    double speed = 0.0;
+
+    for(const auto & shard : m_shards) {
+        speed += shard->bytesPerSecond;
+    }
+
+    return speed;
+}
+
+/**
+ * @brief Calculate the overall progress of all the shards.
+ *
+ * Only shards for which rsync has reported item counts contribute.
+ *
+ * @return The progress in %.
+ */
+int Process::aggregateOverallProgress() const
+{
+    qint64 totalItems = 0;
+    qint64 completedItems = 0;
+
+    for(const auto & shard : m_shards) {
+        if(shard->hasCheckCounts) {
+            totalItems += shard->totalItems;
+            completedItems += shard->totalItems - shard->itemsRemaining;
+        }
+    }
+
+    if(0 >= totalItems) {
+        return 0;
+    }
+
+    return static_cast<int>((completedItems * 100.0) / totalItems);
+}
+
+/**
+ * @brief Check whether rsync has reported whole-transfer totals.
+ *
+ * @return @b true if at least one shard has reported its transfer progress,
+ * which it only does with OutputFormat::Structured.
+ */
+bool Process::hasTransferTotals() const
+{
+    return std::any_of(m_shards.cbegin(), m_shards.cend(), [](const auto & shard) {
+        return shard->hasTransferTotals;
+    });
+}
+
+/**
+ * @brief Fetch the number of bytes rsync has transferred so far.
+ *
+ * This is only known with OutputFormat::Structured, in which case it is the sum
+ * of the bytes reported by all the shards. Otherwise it is 0.
+ *
+ * @return The number of bytes.
  */
-QStringList Process::rsyncArguments(const Preset & preset, const QStringList & forceOptions)
+quint64 Process::transferredBytes() const
 {
-    if(preset.source().isEmpty()) {
-        qCritical() << __PRETTY_FUNCTION__ << "Preset's source is empty";
-        return {};
-    }
+    quint64 bytes = 0;
 
-    if(preset.destination().isEmpty()) {
-        qCritical() << __PRETTY_FUNCTION__ << "Preset's destination is empty";
-        return {};
+    for(const auto & shard : m_shards) {
+        bytes += shard->transferredBytes;
     }
 
-    QStringList args(forceOptions);
-    args.push_back("--recursive");
-    args.push_back("--progress");
-    args.push_back("--verbose");
-    args.push_back("--out-format=f%n %l");
+    return bytes;
+}
 
-    /* basic settings */
-    if(preset.preserveTime()) {
-        args.push_back("--times");
+/**
+ * @brief Estimate how many bytes of the source all the shards have dealt with.
+ *
+ * This is only meaningful once the source scan is complete. The bytes of items
+ * that have been transferred are known exactly. Items rsync has checked but not
+ * transferred are counted at the average size of the scanned items that have
+ * not been transferred, since rsync doesn't report their sizes. Each fan-out
+ * destination gets the whole of the source, so with fan-out destinations the
+ * source counts once for each destination.
+ *
+ * @return The estimate in bytes, no more than the scanned size of the source
+ * for all the destinations.
+ */
+quint64 Process::estimateCompletedBytes() const
+{
+    Q_ASSERT_X(hasScanTotals(), __PRETTY_FUNCTION__, "the source scan is not complete");
+    const quint64 totalBytes = m_scanner->totalBytes() * static_cast<quint64>(destinationCount());
+    const quint64 totalEntries = m_scanner->entryCount() * static_cast<quint64>(destinationCount());
+    quint64 transferredBytes = 0;
+    quint64 listedBytes = 0;
+    quint64 listedItems = 0;
+    quint64 checkedItems = 0;
+
+    for(const auto & shard : m_shards) {
+        transferredBytes += shard->completedBytes + shard->currentItemBytes;
+        listedBytes += shard->listedBytes;
+        listedItems += static_cast<quint64>(shard->listedItems);
+
+        if(shard->hasCheckCounts) {
+            checkedItems += static_cast<quint64>(shard->totalItems - shard->itemsRemaining);
+        }
     }
 
-    if(preset.preservePermissions()) {
-        args.push_back("--perms");
-    }
+    quint64 skippedItems = (checkedItems > listedItems ? checkedItems - listedItems : 0);
+    quint64 unlistedBytes = (totalBytes > listedBytes ? totalBytes - listedBytes : 0);
+    quint64 unlistedEntries = (totalEntries > listedItems ? totalEntries - listedItems : 0);
 
-    if(preset.preserveOwner()) {
-        args.push_back("--owner");
+    if(0 < unlistedEntries) {
+        transferredBytes += static_cast<quint64>(static_cast<double>(skippedItems) * static_cast<double>(unlistedBytes) / static_cast<double>(unlistedEntries));
     }
 
-    if(preset.preserveGroup()) {
-        args.push_back("--group");
-    }
+    return std::min(transferredBytes, totalBytes);
+}
 
-    if(preset.windowsCompatability()) {
-        args.push_back("--modify-window=1");
+/**
+ * @brief Emit the overall progress, and the overall time remaining if it can be
+ * estimated.
+ *
+ * With structured output the progress and time remaining are rsync's own
+ * figures for the whole transfer. Otherwise, once the source scan is complete
+ * the progress is byte-weighted; until then, or without a scan, it is based on
+ * rsync's item counts. With fan-out destinations the progress is of all the
+ * destinations together.
+ */
+void Process::emitOverallProgress()
+{
+    if(!m_running || m_stopRequested) {
+        return;
     }
 
-    if(preset.honourDeletions()) {
-        args.push_back("--delete");
-    }
+    if(hasTransferTotals()) {
+        // rsync knows exactly how far through the whole transfer it is
+        double transferred = 0.0;
+        double total = 0.0;
+        int seconds = 0;
+        int reported = 0;
 
-    /* advanced settings */
-    if(preset.ignoreTimes()) {
-        args.push_back("--ignore-times");
-    }
+        for(const auto & shard : m_shards) {
+            if(!shard->hasTransferTotals) {
+                continue;
+            }
 
-    if(preset.alwaysCompareChecksums()) {
-        args.push_back("--checksum");
-    }
+            ++reported;
 
-    if(preset.preserveDevices()) {
-        args.push_back("--devices");
-    }
+            // the percentage is of what the shard's current rsync has to do
+            const auto before = static_cast<double>(shard->transferredBytesBefore);
+            transferred += static_cast<double>(shard->transferredBytes);
+            total += (0 < shard->transferPercent ? before + (static_cast<double>(shard->transferredBytes) - before) * 100.0 / shard->transferPercent : 0.0);
+            seconds = std::max(seconds, shard->transferSecondsRemaining);
+        }
 
-    if(preset.keepPartialTransfers()) {
-        args.push_back("--partial");
-    }
+        if(!m_fanOutDestinations.isEmpty()) {
+            // the destinations that haven't reported yet have as much to do as those that have
+            total = total * static_cast<double>(m_shards.size()) / reported;
+        }
 
-    if(preset.copySymlinksAsSymlinks()) {
-        args.push_back("--links");
+        reportOverallProgress(0.0 < total ? static_cast<int>(transferred * 100.0 / total) : 0);
+        Q_EMIT overallSecondsRemaining(seconds);
+        return;
     }
 
-    if(preset.makeBackups()) {
-        args.push_back("--backup");
+    if(!hasScanTotals()) {
+        reportOverallProgress(aggregateOverallProgress());
+        return;
     }
 
-    if(preset.useTransferCompression()) {
-        args.push_back("--compress");
-    }
+    const quint64 totalBytes = m_scanner->totalBytes() * static_cast<quint64>(destinationCount());
+    const quint64 completedBytes = estimateCompletedBytes();
+    reportOverallProgress(static_cast<int>((static_cast<double>(completedBytes) * 100.0) / static_cast<double>(totalBytes)));
+    const double speed = aggregateTransferSpeed();
 
-    if(preset.onlyUpdateExistingEntries()) {
-        args.push_back("--existing");
+    if(0.0 < speed) {
+        const double seconds = static_cast<double>(totalBytes - completedBytes) / speed;
+        Q_EMIT overallSecondsRemaining(static_cast<int>(std::min<double>(seconds, std::numeric_limits<int>::max())));
     }
+}
 
-    if(preset.dontUpdateExistingEntries()) {
-        args.push_back("--ignore-existing");
-    }
+/**
+ * @brief Emit the overall progress.
+ *
+ * @param progress The progress, as a percentage.
+ *
+ * After a shard's rsync has been restarted the progress is never less than it
+ * was before the restart, while the new rsync catches up with the old one.
+ */
+void Process::reportOverallProgress(int progress)
+{
+    m_overallProgress = std::max(progress, m_overallProgressFloor);
+    Q_EMIT overallProgress(m_overallProgress);
+}
+
+/**
+ * @brief Work out where rsync is to write this run's snapshot.
+ *
+ * The snapshot is named for the current time (a second later if a snapshot
+ * already has that name) and written under that name with
+ * SnapshotSet::IncompleteSuffix. If an earlier run left an incomplete snapshot
+ * the most recent is renamed to it, so rsync only has to transfer what that
+ * run didn't. The latest complete snapshot, if there is one, is the one rsync
+ * links unchanged files to. A dry run doesn't change the destination.
+ */
+void Process::prepareSnapshot()
+{
+    const SnapshotSet snapshots(m_snapshotDirectory);
+    auto time = QDateTime::currentDateTime();
+    m_snapshotName = SnapshotSet::nameFor(time);
 
-    if(preset.dontMapUsersAndGroups()) {
-        args.push_back("--numeric-ids");
+    while(QFileInfo::exists(snapshots.path(m_snapshotName))) {
+        time = time.addSecs(1);
+        m_snapshotName = SnapshotSet::nameFor(time);
     }
 
-    if(preset.copyHardlinksAsHardlinks()) {
-        args.push_back("--hard-links");
+    m_snapshotTarget = snapshots.path(m_snapshotName % QLatin1String(SnapshotSet::IncompleteSuffix));
+    const auto latest = snapshots.latest();
+    m_snapshotLinkTarget = (latest.isEmpty() ? QString() : QFileInfo(snapshots.path(latest)).absoluteFilePath());
+
+    if(isDryRun()) {
+        return;
     }
 
-    if(preset.showItemisedChanges()) {
-        args.push_back("--itemize-changes");
+    if(!QDir().mkpath(m_snapshotDirectory)) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to create snapshot directory" << m_snapshotDirectory;
+        return;
     }
 
-    /* source and dest */
-    args.push_back(preset.source());
-    args.push_back(preset.destination());
+    const auto incomplete = snapshots.incompleteSnapshots();
 
-    return args;
+    if(!incomplete.isEmpty() && snapshots.path(incomplete.last()) != m_snapshotTarget && !QDir().rename(snapshots.path(incomplete.last()), m_snapshotTarget)) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to carry on with incomplete snapshot" << incomplete.last() << "; starting a new one";
+    }
 }
 
 /**
- * @brief Provides a default explanation of an exit code.
+ * @brief Point rsync at this run's snapshot.
  *
- * @param code is the exit code to explain.
+ * @param args The arguments.
  *
- * The explanation will be a null string if the code is not valid.
+ * The destination is replaced with the snapshot being written and, if there is
+ * a complete snapshot to link against, @b --link-dest is added before the
+ * source and destination. The path given to @b --link-dest is absolute, since
+ * rsync would take a relative one to be relative to the new snapshot.
  *
- * @return The explanation.
+ * @return The arguments.
  */
-const QString & Process::defaultExitCodeMessage(const Process::ExitCode & code)
+QStringList Process::snapshotArguments(QStringList args) const
 {
-    static const QString emptyString;
+    if(m_snapshotTarget.isEmpty() || 2 > args.size()) {
+        return args;
+    }
 
-    static std::map<ExitCode, QString> s_messages = {
-      {ExitCode::Success, tr("The rsync process completed successfully.")},
-      {ExitCode::SyntaxError, tr("The rsync process could not be started because one or more arguments were not valid.")},
-      {ExitCode::ProtocolIncompatibility, tr("The rysnc process could not be started because the source and destination rsync versions are incompatible.")},
-      {ExitCode::FileSelectionError, tr("The rsync process failed because one or more source files or directories could not be found.")},
-      {ExitCode::UnsupportedAction, tr("The rsync process failed because the action requested is not supported.\n\nThis usually means you attempted to transfer data from a 32-bit computer to a 64-bit computer, or vice versa.")},
-      {ExitCode::TransmissionProtocolStartupError, tr("The rsync process failed because it was unable to initialise its data transmission protocol.")},
-      {ExitCode::UnableToWriteLogFile, tr("The rsync process completed but was unable to write to its log file.")},
-      {ExitCode::SocketIoError, tr("The rsync process failed because it encountered a network input/output error.")},
-      {ExitCode::FileIoError, tr("The rsync process failed because it encountered a file input/output error.")},
-      {ExitCode::DataStreamError, tr("The rsync process failed because of a failure in the transmission protocol's data stream.")},
-      {ExitCode::ProgramDiagnosticsError, tr("The rsync process failed because it was unable successfully to complete some internal diagnostics.")},
-      {ExitCode::IpcCodeError, tr("The rsync process failed because of an inter-process communication problem.")},
-      {ExitCode::InterruptReceived, tr("The rsync process was interrupted by the operating system.")},
-      {ExitCode::WaitpidError, tr("The rsync process failed while waiting for a process state to change.")},
-      {ExitCode::MemoryAllocationError, tr("The rsync process failed because it was unable to allocate some memory.")},
-      {ExitCode::PartialTransferError, tr("The rsync process completed but some files or directories were only partially transferred.\n\nThis could mean that the destination filesystem does not support some features (such as access permissions or ownership).")},
-      {ExitCode::VanishedSourceFile, tr("The rsync process failed because a source file or directory vanished while rsync was transferring its contents.")},
-      {ExitCode::MaximumDeletionsExceeded, tr("The rsync process aborted because the maximum number of deletions was exceeded.")},
-      {ExitCode::DataTransmissionTimeout, tr("The rsync process failed because it had to wait too long for data to be transmitted.")},
-      {ExitCode::ConnectionTimeout, tr("The rsync process failed because its network connection timed out.")},
-    };
+    args.last() = m_snapshotTarget % QLatin1Char('/');
 
-    if(s_messages.end() == s_messages.find(code)) {
-        return emptyString;
+    if(!m_snapshotLinkTarget.isEmpty()) {
+        args.insert(args.size() - 2, QStringLiteral("--link-dest=") % m_snapshotLinkTarget);
     }
 
-    return s_messages[code];
+    return args;
 }
 
 /**
- * @brief Start the process.
+ * @brief Complete this run's snapshot once rsync has succeeded.
  *
- * Once the process has started, the started() signal will be emitted
- * and other progress and information signals will start to be emitted.
+ * The snapshot is renamed to remove SnapshotSet::IncompleteSuffix and the
+ * snapshots that the retention policy doesn't keep are given to a
+ * SnapshotPruner. If rsync didn't succeed the snapshot is left incomplete for
+ * the next run to carry on with.
+ *
+ * @return @b true if the pruner has been started, in which case the process
+ * finishes when it has finished, @b false if the process can finish now.
  */
-void Process::start()
+bool Process::completeSnapshot()
 {
-    Q_ASSERT(m_process);
-    m_process->start(m_command, m_args);
+    if(m_snapshotTarget.isEmpty() || isDryRun() || m_stopRequested || ExitCode::Success != m_exitCode) {
+        return false;
+    }
 
-    if(!m_logFileName.isEmpty()) {
-        m_logFile.setFileName(m_logFileName);
-        m_logFile.open(QIODevice::WriteOnly);
+    const SnapshotSet snapshots(m_snapshotDirectory);
+
+    if(!QDir().rename(m_snapshotTarget, snapshots.path(m_snapshotName))) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to rename" << m_snapshotTarget << "to" << m_snapshotName << "; leaving it incomplete";
+        return false;
     }
 
-    m_stdoutConnection = connect(m_process.get(), &QProcess::readyReadStandardOutput, this, &Process::parseStdout);
-    //		connect(m_process.get(), &QProcess::readyReadStandardError, this, &Process::parseStderr);
-    connect(m_process.get(), qOverload<int, QProcess::ExitStatus>(&QProcess::finished), this, &Process::onProcessFinished);
-    Q_EMIT started();
-}
+    auto expired = snapshots.expired(m_snapshotRetention);
 
-/**
- * @brief Attempt to stop the process.
- *
- * If the process has been started, this will attempt to interrupt it.
- * If the attempt is successful, the interrupted() signal will be
- * emitted. No error messages will be generated by a call to this slot.
- */
-void Process::stop()
-{
-    Q_ASSERT(m_process);
-    if(m_process->state() != QProcess::NotRunning) {
-        m_process->close();
-        Q_EMIT interrupted("");
-        disconnect(m_stdoutConnection);
+    if(expired.isEmpty()) {
+        return false;
     }
+
+    m_pruner = std::make_unique<SnapshotPruner>(std::move(expired));
+    connect(m_pruner.get(), &QThread::finished, this, &Process::onSnapshotsPruned);
+    m_pruner->start();
+    return true;
 }
 
 /**
- * @brief Read the process's error output stream.
- *
- * This method is not currently used, but its intention is to read
- * the standard error stream of the rsync process and emit an
- * appropriate error message.
+ * @brief Finish the process once the expired snapshots have been removed.
  */
-void Process::parseStderr()
+void Process::onSnapshotsPruned()
 {
-    Q_ASSERT(m_process);
-
-    //	QString data = m_process->readAllStandardError();
-    //	Q_EMIT error(data));
+    Q_ASSERT_X(m_pruner, __PRETTY_FUNCTION__, "no snapshot pruner");
+    m_pruner->wait();
+    m_pruner.reset();
+    onProcessFinished(m_exitCode);
 }
 
 /**
- * @brief Parse the standard output stream of the rsync process.
+ * @brief Called when the worker reports that rsync has finished.
+ *
+ * @param code The rsync exit code.
  *
- * The process's output stream is captured and parsed. The following
- * information is gathered from the output stream:
- * - the progress of the current transfer
- * - when a new item is starting to be transferred
- * - overall stats about the transfer when rsync has finished
+ * If the process was stopped using stop(), only the finished(ExitCode) signal
+ * is emitted since interrupted() has already been emitted. With fan-out
+ * destinations, the message lists the destinations that did not succeed.
  *
- * The data gathered is emitted as signals from this class.
+ * The Process may be destroyed by a receiver of any of the signals emitted, so
+ * nothing must be done after they have been emitted.
  */
-void Process::parseStdout()
+void Process::onProcessFinished(ExitCode code)
 {
-    // captures:
-    // 1: current item bytes transferred
-    // 2: current item transferred %
-    // 3: current transfer speed
-    // 4: transfer speed unit (M, k or G for Mb, kb or Gb per second respectively)
-    // 5: transfer time, # of hours
-    // 6: transfer time, # of minutes
-    // 7: transfer time, # of seconds
-    // 8: (optional) transfer number
-    // 9: (optional) # of items left to check
-    // 10: (optinal) total number of items
-    static QRegularExpression progressLine(" *(\\d+|\\d+(?:,\\d{3})*) *(\\d+)% *(\\d+\\.\\d{2})(.)B/s *(\\d+):(\\d{2}):(\\d{2})(?: +\\(xfr#(\\d+), (?:to|ir)-chk.(\\d+)\\/(\\d+)\\))?");
-
-    // captures:
-    // 1: new item path
-    // 2: new item size in bytes
-    static QRegularExpression newItemLine("f(.*) (\\d+)");
-
-    // captures:
-    // 1: total bytes sent
-    // 2: total bytes received
-    // 3: overall speed in bytes per second
-    static QRegularExpression completedLine("sent (\\d+|\\d+(?:,\\d{3})*) bytes *received (\\d+|\\d+(?:,\\d{3})*) bytes *((?:\\d+|\\d+(?:,\\d{3})*)(?:\\.(\\d{2}))?) bytes/sec");
-
-    Q_ASSERT_X(m_process, __PRETTY_FUNCTION__, "no process from which to read output");
-    QString data = m_process->readAllStandardOutput();
+    bool wasStopped = m_stopRequested;
+    m_running = false;
+    m_stopRequested = false;
+    m_bandwidthTimer.stop();
+
+    if(m_pendingIndex) {
+        if(!wasStopped && ExitCode::Success == code) {
+            m_pendingIndex->save();
+        }
 
-    if(m_logFile.isOpen()) {
-        m_logFile.write(data.toUtf8());
+        m_pendingIndex.reset();
     }
 
-    if(!data.isEmpty()) {
-        /* this parses the output of rsync for lines indicating progress/new item started/completion */
-        m_outputCache.append(data);
-        m_outputCache = m_outputCache.replace('\r', '\n');
-        QStringList lines(m_outputCache.split("\n"));
+    finishTelemetry(code);
+    QString msg = defaultExitCodeMessage(code);
 
-        /* parse all but the last line (since the last line might not be complete */
-        int n = lines.size() - 1;
-
-        for(int i = 0; i < n; i++) {
-            data = lines[i];
-
-            if(data.isEmpty()) {
-                continue;
-            }
-
-            /* WARNING C++17 feature: if initialisation statements */
-            if(QRegularExpressionMatch progressLineMatch = progressLine.match(data); progressLineMatch.hasMatch()) {
-                QStringList caps = progressLineMatch.capturedTexts();
-
-                int itemBytes = caps[1].remove("[^0-9]+").toInt();
-                int itemPc = caps[2].toInt();
-                float xferSpeed = caps[3].toFloat();
-
-                /* whatever unit the speed is expressed in, convert it to bytes per sec */
-                switch(caps[4][0].toLower().toLatin1()) {
-                    case 'k':
-                        xferSpeed *= 1024;
-                        break;
-
-                    case 'm':
-                        xferSpeed *= (1024 * 1024);
-                        break;
-
-                    case 'g':
-                        xferSpeed *= (1024 * 1024 * 1024);
-                        break;
-                }
-
-                int seconds = (caps[5].toInt() * 3600) + (caps[6].toInt() * 60) + caps[7].toInt();
+    if(0 < m_retryCount) {
+        msg += QStringLiteral("\n\n") % tr("rsync was retried %n time(s) after transient failures, resuming %1 of partly transferred files.", "", m_retryCount).arg(QLocale().toString(static_cast<double>(static_cast<long double>(m_resumedBytes) / 1.0_mib), 'f', 1) % QStringLiteral(" MiB"));
+    }
 
-                Q_EMIT transferSpeed(xferSpeed);
-                Q_EMIT itemProgressBytes(itemBytes);
-                Q_EMIT itemProgress(itemPc);
-                Q_EMIT itemSecondsRemaining(seconds);
+    if(!m_fanOutDestinations.isEmpty()) {
+        QStringList failedDestinations;
 
-                if(11 <= caps.size()) {
-                    /* transferNumber = capture # 8 */
-                    int remainingItems = caps[9].toInt();
-                    int totalItems = caps[10].toInt();
-                    int completedItems = totalItems - remainingItems;
-                    float overallPc = static_cast<float>((completedItems * 100.0) / totalItems);
-                    Q_EMIT overallProgress(static_cast<int>(overallPc));
-                }
-            }
-            else if(QRegularExpressionMatch newItemMatch = newItemLine.match(data); newItemMatch.hasMatch()) {
-                Q_EMIT newItemStarted(newItemMatch.captured(1));
-            }
-            else if(QRegularExpressionMatch completedLineMatch = completedLine.match(data); completedLineMatch.hasMatch()) {
-                Q_EMIT transferSpeed(completedLineMatch.captured(3).replace(',', "").toFloat());
+        for(const auto & shard : m_shards) {
+            if(shard->finished && ExitCode::Success != shard->exitCode) {
+                failedDestinations.push_back(shard->args.last() % QStringLiteral(": ") % defaultExitCodeMessage(shard->exitCode));
             }
         }
 
-        if(!lines.empty()) {
-            m_outputCache = lines[lines.size() - 1];
+        if(!failedDestinations.isEmpty()) {
+            msg += QStringLiteral("\n\n") % tr("%n of %1 destinations did not succeed:", "", failedDestinations.size()).arg(destinationCount()) % QLatin1Char('\n') % failedDestinations.join(QLatin1Char('\n'));
         }
     }
-}
 
-/**
- * @brief Called when the QProcess finishes.
- *
- * This method is connected to the QProcess::finished() signal.
- */
-void Process::onProcessFinished()
-{
-    Q_ASSERT_X(m_process, __PRETTY_FUNCTION__, "called without a QProcess object");
-    m_logFile.close();
-    m_outputCache.clear();
-    auto code = static_cast<ExitCode>(m_process->exitCode());
-    const QString & msg = defaultExitCodeMessage(code);
     Q_EMIT finished(code);
 
+    if(wasStopped) {
+        return;
+    }
+
     switch(code) {
         case ExitCode::Success:
         case ExitCode::PartialTransferError:
@@ -494,6 +2371,9 @@ void Process::onProcessFinished()
         case ExitCode::MaximumDeletionsExceeded:
         case ExitCode::DataTransmissionTimeout:
         case ExitCode::ConnectionTimeout:
+        case ExitCode::FailedToStart:
+        case ExitCode::Crashed:
+        case ExitCode::RemoteShellError:
             Q_EMIT failed(msg);
             break;
     }
@@ -507,15 +2387,45 @@ void Process::onProcessFinished()
  */
 
 /**
- * @fn Process::newItemStarted(QString)
+ * @fn Process::newItemStarted(PathStore::Id)
  * @brief Emitted when the @b rsync has started processing a
  * different file or directory.
  *
- * @param item is the path to the item whose processing has started.
+ * @param item is the Id of the path to the item whose processing has started,
+ * in pathStore().
  *
  * The item path is relative to the source.
  */
 
+/**
+ * @fn Process::itemStarted(PathStore::Id, quint64)
+ * @brief Emitted when the @b rsync has started processing a
+ * different file or directory.
+ *
+ * @param item is the Id of the path to the item whose processing has started,
+ * in pathStore().
+ * @param size is the size of the item in bytes.
+ *
+ * This is emitted immediately after newItemStarted(), for receivers that also
+ * need the size. The item path is relative to the source.
+ */
+
+/**
+ * @fn Process::itemChanged(PathStore::Id, QString, quint64)
+ * @brief Emitted when the @b rsync has listed a change it is making (or, for a
+ * dry run, would make) to the destination.
+ *
+ * @param item is the Id of the path to the item in pathStore(). The path is
+ * relative to the source.
+ * @param changes is rsync's itemised changes for the item (e.g. ">f+++++++++"
+ * for a new file or "*deleting" for one that is removed). It is empty unless
+ * the output format is OutputFormat::Structured.
+ * @param size is the size of the item in bytes.
+ *
+ * This is emitted immediately after itemStarted(), for receivers that need to
+ * know what is being done to each item, such as a ChangeSetModel.
+ */
+
 /**
  * @fn Process::itemProgress(int)
  * @brief Emitted when the progress of the current item being processed
@@ -539,6 +2449,16 @@ void Process::onProcessFinished()
  * @param progress is the new overall progress in %.
  */
 
+/**
+ * @fn Process::overallSecondsRemaining(int)
+ * @brief Emitted when an estimate of the time remaining for the whole process
+ * is available.
+ *
+ * This is only emitted if the source has been scanned (see setScanSource()).
+ *
+ * @param seconds is the estimated number of seconds remaining.
+ */
+
 /**
  * @fn Process::transferSpeed(float)
  * @brief Emitted when an update to the transfer speed is available.
@@ -546,6 +2466,32 @@ void Process::onProcessFinished()
  * @param bytesPerSecond is the current transfer speed in bytes per second.
  */
 
+/**
+ * @fn Process::bytesTransferred(quint64)
+ * @brief Emitted when rsync reports how much of the whole transfer it has done.
+ *
+ * This is only emitted with OutputFormat::Structured.
+ *
+ * @param bytes is the number of bytes transferred so far, over all the rsync
+ * processes.
+ */
+
+/**
+ * @fn Process::retrying(Process::ExitCode, int, int)
+ * @brief Emitted when an rsync has failed and will be run again.
+ *
+ * @param code is the exit code of the rsync that failed.
+ * @param attempt is the number of the retry, starting at 1.
+ * @param seconds is how long it will be before the retry.
+ */
+
+/**
+ * @fn Process::preferredBandwidthLimitChanged(int)
+ * @brief Emitted during a run when the preferredBandwidthLimit() changes.
+ *
+ * @param limit is the new limit in KiB per second, 0 for none.
+ */
+
 /**
  * @fn Process::finished(Process::ExitCode)
  * @brief Emitted when @b rsync has finished.
@@ -611,3 +2557,182 @@ void Process::onProcessFinished()
  * is recommended that errors emitted by this signal are introduced
  * to the user gently!
  */
+
+/**
+ * @fn Process::usesWorkerThread()
+ * @brief Check whether rsync's output is processed on a dedicated thread.
+ *
+ * @return @b true if a worker thread is used, @b false otherwise.
+ */
+
+/**
+ * @fn Process::scansSource()
+ * @brief Check whether a local source is scanned to estimate overall progress.
+ *
+ * @return @b true if the source is scanned, @b false otherwise.
+ */
+
+/**
+ * @fn Process::hasScanTotals()
+ * @brief Check whether the source scan is complete and found something to
+ * transfer.
+ *
+ * @return @b true if byte-weighted overall progress can be estimated.
+ */
+
+/**
+ * @fn Process::pathStore()
+ * @brief Fetch the store of the paths of the items rsync has listed.
+ *
+ * The Ids given by newItemStarted(), itemStarted() and itemChanged() refer to
+ * paths in this store. It is replaced when the process is started again, so
+ * a receiver should fetch it when started() is emitted. The items' paths are
+ * only stored while the store is held by something other than the process
+ * (the signals carry PathStore::NoPath otherwise), and a receiver that keeps
+ * an Id must PathStore::retain() it.
+ *
+ * @return The store.
+ */
+
+/**
+ * @fn Process::paths()
+ * @brief Fetch the entries the process is restricted to.
+ *
+ * @return The paths relative to the source, or no value if the process
+ * synchronises the whole source.
+ */
+
+/**
+ * @fn Process::usesSourceIndex()
+ * @brief Check whether the process uses a source index to give rsync only the
+ * entries that have changed since the last successful run.
+ *
+ * This is the case for presets that ask for it and whose other settings allow
+ * it. The index is then used if the source is a local directory when the
+ * process is started.
+ *
+ * @return @b true if the source index is used, @b false otherwise.
+ */
+
+/**
+ * @fn Process::hasStarted()
+ * @brief Check whether start() has been called.
+ *
+ * @return @b true if the process has been started, @b false otherwise.
+ */
+
+/**
+ * @fn Process::shardCount()
+ * @brief Fetch the maximum number of rsync processes the Process runs.
+ *
+ * This is 1 unless the run type is RunType::Parallel, or RunType::DryRun for a
+ * preset that doesn't honour deletions. The source may be split into fewer
+ * shards than this when the process is started.
+ *
+ * @return The number of shards.
+ */
+
+/**
+ * @fn Process::command()
+ * @brief Fetch the rsync command the process runs.
+ *
+ * @return The path to rsync.
+ */
+
+/**
+ * @fn Process::presetRevision()
+ * @brief Fetch the revision of the preset the rsync arguments were built from.
+ *
+ * @return The revision. See Preset::revision().
+ */
+
+/**
+ * @fn Process::isRunning()
+ * @brief Check whether the process is running.
+ *
+ * @return @b true if it has been started and has not yet finished, @b false
+ * otherwise.
+ */
+
+/**
+ * @fn Process::outputFormat()
+ * @brief Fetch the format in which rsync reports its progress.
+ *
+ * @return The format.
+ */
+
+/**
+ * @fn Process::bandwidthLimit()
+ * @brief Fetch the bandwidth limit rsync is using.
+ *
+ * @return The limit in KiB per second, 0 for none.
+ */
+
+/**
+ * @fn Process::bandwidthShare()
+ * @brief Fetch the bandwidth limit imposed on the process by its owner.
+ *
+ * @return The limit in KiB per second, 0 for none.
+ */
+
+/**
+ * @fn Process::retryAttempts()
+ * @brief Fetch how many times each rsync is run again after a transient failure.
+ *
+ * @return The number of retries, 0 if failures are not retried.
+ */
+
+/**
+ * @fn Process::retryCount()
+ * @brief Fetch how many times rsync has been retried during the current or most
+ * recent run.
+ *
+ * @return The number of retries, over all the rsync processes.
+ */
+
+/**
+ * @fn Process::resumedBytes()
+ * @brief Fetch how much of the files the retries picked up part way through
+ * had already been transferred.
+ *
+ * @return The number of bytes.
+ */
+
+/**
+ * @fn Process::usesLocalCopier()
+ * @brief Check whether the source is copied by a LocalCopier rather than rsync.
+ *
+ * @return @b true if the local copier is used, @b false if rsync is run.
+ */
+
+/**
+ * @fn Process::usesSnapshots()
+ * @brief Check whether each run writes a new snapshot in the destination.
+ *
+ * @return @b true if the preset keeps snapshots and its destination is local,
+ * @b false otherwise.
+ */
+
+/**
+ * @fn Process::snapshotName()
+ * @brief Fetch the name of the snapshot the current or most recent run wrote.
+ *
+ * @return The name, or an empty string if the process doesn't keep snapshots.
+ */
+
+/**
+ * @fn Process::fanOutDestinations()
+ * @brief Fetch the other destinations each run replicates the source to.
+ *
+ * A dry run has none, since it only shows what would change in the preset's
+ * own destination.
+ *
+ * @return The destinations, as they are given to rsync.
+ */
+
+/**
+ * @fn Process::destinationCount()
+ * @brief Fetch how many destinations each run synchronises.
+ *
+ * @return The number of destinations, including the preset's own.
+ */
@@ -11,19 +11,35 @@
 #define QYNC_PROCESS_H
 
 #include <memory>
+#include <optional>
+#include <vector>
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
-#include <QtCore/QFile>
-#include <QtCore/QMetaObject>
+#include <QtCore/QTimer>
 
-class QProcess;
+#include "adaptivebandwidth.h"
+#include "bandwidthschedule.h"
+#include "localcopier.h"
+#include "pathstore.h"
+#include "processworker.h"
+#include "snapshotset.h"
+#include "sourcescanner.h"
+
+class QThread;
+class QTemporaryFile;
 
 namespace Qync {
 
 	class Preset;
-	class Preferences;
+	class RsyncCapabilities;
+	class ShardPlanner;
+	class SnapshotPruner;
+	class SourceIndex;
+	class TelemetryWriter;
+	class TransferTelemetry;
 
 	class Process
 	: public QObject {
@@ -51,18 +67,44 @@ namespace Qync {
 			VanishedSourceFile = 24,
 			MaximumDeletionsExceeded = 25,
 			DataTransmissionTimeout = 30,
-			ConnectionTimeout = 35
+			ConnectionTimeout = 35,
+			FailedToStart = 127,
+
+			// not rsync's: rsync was killed by a signal rather than exiting
+			Crashed = 128,
+
+			// ssh's, which rsync passes on when the remote shell can't connect
+			RemoteShellError = 255
 		};
 
 		enum class RunType : unsigned char {
 			Normal = 0,
 			DryRun,
+			Parallel,
+		};
+
+		enum class OutputFormat : unsigned char {
+			Text = 0,
+			Structured,
 		};
 
-		explicit Process(const Preset & preset, RunType type = RunType::Normal);
 		Process(QString cmd, const Preset & preset, RunType type = RunType::Normal);
 		~Process() override;
 
+		bool rearm(const Preset & preset);
+
+		[[nodiscard]] inline const QString & command() const {
+			return m_command;
+		}
+
+		[[nodiscard]] inline quint64 presetRevision() const {
+			return m_presetRevision;
+		}
+
+		[[nodiscard]] inline bool isRunning() const {
+			return m_running;
+		}
+
 		[[nodiscard]] inline RunType runType() const {
 			return m_runType;
 		}
@@ -71,14 +113,104 @@ namespace Qync {
 			return RunType::DryRun == m_runType;
 		}
 
+		[[nodiscard]] inline bool usesWorkerThread() const {
+			return m_useWorkerThread;
+		}
+
+		void setUseWorkerThread(bool use);
+
+		[[nodiscard]] inline bool scansSource() const {
+			return m_scanSource;
+		}
+
+		void setScanSource(bool scan);
+
+		[[nodiscard]] inline OutputFormat outputFormat() const {
+			return m_outputFormat;
+		}
+
+		void setOutputFormat(OutputFormat format);
+
+		[[nodiscard]] static OutputFormat outputFormatFor(const RsyncCapabilities & capabilities);
+
+		[[nodiscard]] quint64 transferredBytes() const;
+
+		[[nodiscard]] inline const std::optional<QStringList> & paths() const {
+			return m_paths;
+		}
+
+		void setPaths(QStringList paths);
+
+		[[nodiscard]] inline std::shared_ptr<const PathStore> pathStore() const {
+			return m_pathStore;
+		}
+
+		[[nodiscard]] inline int shardCount() const {
+			return m_shardCount;
+		}
+
+		[[nodiscard]] inline bool usesSourceIndex() const {
+			return !m_indexFileName.isEmpty();
+		}
+
+		[[nodiscard]] inline int bandwidthLimit() const {
+			return m_bandwidthLimit;
+		}
+
+		[[nodiscard]] int preferredBandwidthLimit() const;
+
+		[[nodiscard]] inline int bandwidthShare() const {
+			return m_bandwidthShare;
+		}
+
+		void setBandwidthShare(int share);
+
+		[[nodiscard]] inline int retryAttempts() const {
+			return m_retryAttempts;
+		}
+
+		[[nodiscard]] inline int retryCount() const {
+			return m_retryCount;
+		}
+
+		[[nodiscard]] inline quint64 resumedBytes() const {
+			return m_resumedBytes;
+		}
+
+		[[nodiscard]] inline bool usesLocalCopier() const {
+			return m_useLocalCopier;
+		}
+
+		[[nodiscard]] inline bool usesSnapshots() const {
+			return !m_snapshotDirectory.isEmpty();
+		}
+
+		[[nodiscard]] inline const QString & snapshotName() const {
+			return m_snapshotName;
+		}
+
+		[[nodiscard]] inline const QStringList & fanOutDestinations() const {
+			return m_fanOutDestinations;
+		}
+
+		[[nodiscard]] inline int destinationCount() const {
+			return 1 + m_fanOutDestinations.size();
+		}
+
 	Q_SIGNALS:
 		void started();
-		void newItemStarted(QString);
+		void newItemStarted(PathStore::Id);
+		void itemStarted(PathStore::Id, quint64);
+		void itemChanged(PathStore::Id, QString, quint64);
 		void itemProgress(int);
 		void itemProgressBytes(int);
 		void itemSecondsRemaining(int);
 		void overallProgress(int);
+		void overallSecondsRemaining(int);
 		void transferSpeed(float);
+		void bytesTransferred(quint64);
+		void preferredBandwidthLimitChanged(int);
+		void retrying(Process::ExitCode, int, int);
 		void finished(Process::ExitCode);
 		void finished(QString);
 		void interrupted(QString);
@@ -90,23 +222,119 @@ namespace Qync {
 		void stop();
 
 	private Q_SLOTS:
-		void parseStdout();
-		void parseStderr();
-		void onProcessFinished();
+		void onShardsPlanned();
+		void onSourceIndexed();
+		void emitOverallProgress();
+		void updateBandwidthLimit();
+		void onSnapshotsPruned();
+		void onTelemetrySaved();
 
 	protected:
-		static QStringList rsyncArguments(const Preset &, const QStringList & = {});
+		static QStringList rsyncArguments(const Preset &, const QStringList & = {}, OutputFormat = OutputFormat::Text);
+		static const QStringList & outputArguments(OutputFormat);
 		static const QString & defaultExitCodeMessage(const Process::ExitCode &);
 
 	private:
-		std::unique_ptr<QProcess> m_process;
+		struct Shard;
+
+		[[nodiscard]] inline bool hasStarted() const {
+			return m_indexScanner || m_planner || m_pruner || !m_shards.empty();
+		}
+
+		void configure(const Preset & preset);
+		void releaseRun();
+		void startRsync();
+		bool startRsyncForPaths(const QStringList & paths);
+		void startDestinations(QStringList args, QString logFileName, std::unique_ptr<QTemporaryFile> filesFrom = {});
+		void startShard(QStringList args, QString logFileName, std::unique_ptr<QTemporaryFile> filesFrom = {}, int node = 0);
+		void startWaitingShard();
+		void launchShard(Shard & shard);
+		void startWorker(Shard & shard, bool appendToLog = false);
+		void shutdownWorker(Shard & shard);
+		void restartShard(Shard & shard);
+		void scheduleRetry(Shard & shard, ExitCode code);
+		void dispatchEvents(Shard & shard);
+		void onShardNewItem(Shard & shard, const ProcessEvent & event);
+		void onShardFinished(Shard & shard, ExitCode code);
+		void recordItemTelemetry(Shard & shard, const ProcessEvent * event, PathStore::Id path);
+		void sampleTelemetry();
+		void finishTelemetry(ExitCode code);
+		[[nodiscard]] double aggregateTransferSpeed() const;
+		[[nodiscard]] int aggregateOverallProgress() const;
+		[[nodiscard]] bool hasTransferTotals() const;
+
+		[[nodiscard]] inline bool hasScanTotals() const {
+			return m_scanner && m_scanner->isFinished() && 0 < m_scanner->totalBytes();
+		}
+
+		[[nodiscard]] quint64 estimateCompletedBytes() const;
+		[[nodiscard]] int scheduledBandwidthLimit() const;
+		[[nodiscard]] bool bandwidthLimitMayChange() const;
+		[[nodiscard]] QStringList bandwidthArguments(QStringList args) const;
+		void sampleBandwidth();
+		[[nodiscard]] QStringList resumeArguments(QStringList args) const;
+		void prepareSnapshot();
+		[[nodiscard]] QStringList snapshotArguments(QStringList args) const;
+		bool completeSnapshot();
+		void reportOverallProgress(int progress);
+		void scheduleBandwidthUpdate();
+		void onProcessFinished(ExitCode code);
+
 		QString m_command;
 		RunType m_runType;
 		QStringList m_args;
+		QString m_source;
+		QString m_destination;
 		QString m_logFileName;
-		QFile m_logFile;
-		QString m_outputCache;
-		QMetaObject::Connection m_stdoutConnection;
+		QString m_indexFileName;
+		QString m_telemetryDirectory;
+		qint64 m_logRotationSize;
+		int m_logRotationCount;
+		int m_shardCount;
+		QStringList m_fanOutDestinations;
+		int m_fanOutConcurrency;
+		bool m_useWorkerThread;
+		bool m_useLocalCopier;
+		LocalCopier::Options m_localCopierOptions;
+		bool m_scanSource;
+		OutputFormat m_outputFormat;
+		bool m_running;
+		bool m_stopRequested;
+		std::unique_ptr<ShardPlanner> m_planner;
+		std::unique_ptr<SourceScanner> m_scanner;
+		std::unique_ptr<SourceScanner> m_indexScanner;
+		std::unique_ptr<SourceIndex> m_pendingIndex;
+		std::unique_ptr<TransferTelemetry> m_telemetry;
+		std::unique_ptr<TelemetryWriter> m_telemetryWriter;
+		std::shared_ptr<PathStore> m_pathStore;
+		QElapsedTimer m_runTimer;
+		quint32 m_lastTelemetrySample;
+		BandwidthSchedule m_bandwidthSchedule;
+		int m_defaultBandwidthLimit;
+		bool m_adaptiveBandwidth;
+		AdaptiveBandwidth m_adaptive;
+		int m_bandwidthShare;
+		int m_bandwidthLimit;
+		int m_preferredBandwidthLimit;
+		QTimer m_bandwidthTimer;
+		int m_retryAttempts;
+		int m_retryDelay;
+		bool m_usesPartialDirectory;
+		int m_retryCount;
+		quint64 m_resumedBytes;
+		QString m_snapshotDirectory;
+		SnapshotSet::RetentionPolicy m_snapshotRetention;
+		QString m_snapshotName;
+		QString m_snapshotTarget;
+		QString m_snapshotLinkTarget;
+		std::unique_ptr<SnapshotPruner> m_pruner;
+		int m_overallProgress;
+		int m_overallProgressFloor;
+		std::optional<QStringList> m_paths;
+		std::vector<std::unique_ptr<Shard>> m_shards;
+		int m_finishedShards;
+		ExitCode m_exitCode;
+		quint64 m_presetRevision;
 	};
 
 }  // namespace Qync
@@ -16,15 +16,20 @@
 #include <QtGui/QCloseEvent>
 #include <QtWidgets/QFileDialog>
 #include <QtWidgets/QDialogButtonBox>
+#include <QtWidgets/QHeaderView>
 #include <QtWidgets/QPushButton>
+#include <QtWidgets/QScrollBar>
 
 #include "application.h"
 #include "process.h"
 #include "functions.h"
-#include "units.h"
+#include "instrumentation.h"
 
 using namespace Qync;
 
+/**
+ * @brief Implementation details for the Qync::ProcessDialogue class.
+ */
 /**
  * @class ProcessDialogue
  * @author Darren Edale
@@ -40,6 +45,19 @@ using namespace Qync;
  * files and directories as they are being processed, and by showing which item
  * is currently being processed, how close to completion it is, and how close to
  * completion the whole process is.
+ *
+ * The list of items is a TransferLogModel shown in a list view with uniform
+ * item sizes, so only the visible items are laid out and the memory used is
+ * bounded by the transfer log capacity in the application preferences. The
+ * list follows the newest item unless the user has scrolled away from the end.
+ *
+ * For a dry run the details show what the run would change instead: a
+ * ChangeSetModel of the items rsync lists, with what would happen to each,
+ * and totals of the number of items of each kind and of the data that would
+ * be sent. Once the dry run has finished the table can be sorted, e.g. by size
+ * to find the largest items. rsync only says what it would do to each item
+ * with structured output (see Process::setOutputFormat()); otherwise the items
+ * are just listed.
  */
 
 /**
@@ -54,23 +72,40 @@ using namespace Qync;
 ProcessDialogue::ProcessDialogue(const std::shared_ptr<Process> & process, QWidget * parent)
 :   QDialog(parent),
     m_ui(std::make_unique<Ui::ProcessDialogue>()),
+    m_log(),
+    m_changes(),
+    m_followLog(true),
+    m_process(),
     m_saveButton(nullptr),
     m_abortButton(nullptr)
 {
     Q_ASSERT_X(process, __PRETTY_FUNCTION__, "No process provided");
     m_ui->setupUi(this);
-    m_ui->processWidget->setProcess(process);
+    m_log.setCapacity(qyncApp->preferences().transferLogCapacity());
+    m_ui->details->setModel(&m_log);
+    m_ui->changes->setModel(&m_changes);
+    m_ui->changes->horizontalHeader()->setSortIndicator(ChangeSetModel::PathColumn, Qt::AscendingOrder);
 
     /* keep refs to these from the UI because we dis/enable them at various points */
     m_saveButton = m_ui->controls->button(QDialogButtonBox::Save);
     m_abortButton = m_ui->controls->button(QDialogButtonBox::Abort);
 
-    auto * tempProcess = process.get();
-    connect(tempProcess, &Process::started, this, &ProcessDialogue::onProcessStarted);
-    connect(tempProcess, qOverload<QString>(&Process::finished), this, &ProcessDialogue::onProcessFinished);
-    connect(tempProcess, &Process::interrupted, this, &ProcessDialogue::onProcessInterrupted);
-    connect(tempProcess, &Process::failed, this, &ProcessDialogue::onProcessFailed);
-    connect(tempProcess, &Process::newItemStarted, this, &ProcessDialogue::appendToDetails);
+    setProcess(process);
+
+    connect(&m_log, &TransferLogModel::rowsAboutToBeInserted, [this]() {
+        auto * scrollBar = m_ui->details->verticalScrollBar();
+        m_followLog = (scrollBar->value() == scrollBar->maximum());
+    });
+
+    connect(&m_log, &TransferLogModel::rowsInserted, [this]() {
+        if(m_followLog) {
+            m_ui->details->scrollToBottom();
+        }
+    });
+
+    connect(&m_changes, &ChangeSetModel::rowsInserted, this, &ProcessDialogue::updateChangeTotals);
+    connect(&m_changes, &ChangeSetModel::modelReset, this, &ProcessDialogue::updateChangeTotals);
+
     connect(m_ui->detailsButton, &QPushButton::clicked, this, &ProcessDialogue::toggleDetailedText);
 
     connect(m_ui->controls, &QDialogButtonBox::accepted, this, &ProcessDialogue::accept);
@@ -83,10 +118,65 @@ ProcessDialogue::ProcessDialogue(const std::shared_ptr<Process> & process, QWidg
 ProcessDialogue::~ProcessDialogue()
 {
     m_ui->detailsButton->disconnect(this);
+
+    // the views must not outlive their models
+    m_ui->details->setModel(nullptr);
+    m_ui->changes->setModel(nullptr);
     m_saveButton = nullptr;
     m_abortButton = nullptr;
 }
 
+/**
+ * @brief Set the process the dialogue is monitoring.
+ *
+ * @param process The process.
+ *
+ * The dialogue can be given the process it is already monitoring again when
+ * the process has been rearmed to run again (see Process::rearm()). Its signals
+ * are still connected, so only the process widget takes shared ownership of it
+ * again.
+ */
+void ProcessDialogue::setProcess(const std::shared_ptr<Process> & process)
+{
+    m_ui->processWidget->setProcess(process);
+
+    if(process.get() == m_process) {
+        return;
+    }
+
+    if(m_process) {
+        m_process->disconnect(this);
+    }
+
+    m_process = process.get();
+    auto * tempProcess = process.get();
+    m_log.setPathStore(tempProcess->pathStore());
+    m_changes.setPathStore(tempProcess->pathStore());
+    connect(tempProcess, &Process::started, this, &ProcessDialogue::onProcessStarted);
+    connect(tempProcess, qOverload<QString>(&Process::finished), this, &ProcessDialogue::onProcessFinished);
+    connect(tempProcess, &Process::interrupted, this, &ProcessDialogue::onProcessInterrupted);
+    connect(tempProcess, &Process::failed, this, &ProcessDialogue::onProcessFailed);
+    connect(tempProcess, &Process::itemStarted, this, &ProcessDialogue::appendToDetails);
+
+    if(tempProcess->isDryRun()) {
+        connect(tempProcess, &Process::itemChanged, this, &ProcessDialogue::appendToChanges);
+        m_ui->detailsStack->setCurrentWidget(m_ui->changesPage);
+    }
+    else {
+        m_ui->detailsStack->setCurrentWidget(m_ui->details);
+    }
+}
+
+/**
+ * @brief Fetch the process the dialogue is monitoring.
+ *
+ * @return The process, or @b nullptr if it has been destroyed.
+ */
+const Process * ProcessDialogue::process() const
+{
+    return m_process;
+}
+
 /**
  * @brief Handle a request to close the window.
  *
@@ -101,6 +191,26 @@ void ProcessDialogue::closeEvent(QCloseEvent * event)
     this->deleteLater();
 }
 
+/**
+ * @brief Handle an event.
+ *
+ * @param event The event.
+ *
+ * Repaints of the whole window, including the process widget and the list of
+ * items, are timed for the Instrumentation.
+ *
+ * @return @b true if the event was handled, @b false otherwise.
+ */
+bool ProcessDialogue::event(QEvent * event)
+{
+    if(QEvent::UpdateRequest == event->type()) {
+        Instrumentation::Scope scope(Instrumentation::Histogram::RepaintTime, "ProcessDialogue repaint");
+        return QDialog::event(event);
+    }
+
+    return QDialog::event(event);
+}
+
 /**
  * @brief Toggle the state of the detailed info text.
  *
@@ -109,7 +219,7 @@ void ProcessDialogue::closeEvent(QCloseEvent * event)
  */
 void ProcessDialogue::toggleDetailedText()
 {
-    if(m_ui->details->isVisible()) {
+    if(m_ui->detailsStack->isVisible()) {
         hideDetailedText();
     }
     else {
@@ -124,7 +234,7 @@ void ProcessDialogue::toggleDetailedText()
  */
 void ProcessDialogue::showDetailedText()
 {
-    m_ui->details->show();
+    m_ui->detailsStack->show();
     m_ui->detailsButton->setText(tr("Hide details"));
     m_ui->detailsButton->setIcon(QIcon::fromTheme(QStringLiteral("arrow-up"), QIcon(QStringLiteral(":icons/buttons/toggle_up"))));
     adjustSize();
@@ -137,28 +247,85 @@ void ProcessDialogue::showDetailedText()
  */
 void ProcessDialogue::hideDetailedText()
 {
-    m_ui->details->hide();
+    m_ui->detailsStack->hide();
     m_ui->detailsButton->setText(tr("Show details"));
     m_ui->detailsButton->setIcon(QIcon::fromTheme(QStringLiteral("arrow-down"), QIcon(QStringLiteral(":icons/buttons/toggle_down"))));
     adjustSize();
 }
 
 /**
- * @brief Append text to the details text widget.
+ * @brief Add an item to the details list.
+ *
+ * @param path The Id of the path of the item in the process's PathStore.
+ * @param size The size of the item in bytes.
+ */
+void ProcessDialogue::appendToDetails(PathStore::Id path, quint64 size)
+{
+    Instrumentation::Scope scope(Instrumentation::Histogram::UiUpdateTime, "ProcessDialogue::appendToDetails");
+    m_log.append(path, size);
+}
+
+/**
+ * @brief Add an item to the list of changes.
  *
- * @param txt The text to append.
+ * @param path The Id of the path of the item in the process's PathStore.
+ * @param changes rsync's itemised changes for the item.
+ * @param size The size of the item in bytes.
  */
-void ProcessDialogue::appendToDetails(const QString & txt)
+void ProcessDialogue::appendToChanges(PathStore::Id path, const QString & changes, quint64 size)
 {
-    m_ui->details->appendPlainText(txt);
+    Instrumentation::Scope scope(Instrumentation::Histogram::UiUpdateTime, "ProcessDialogue::appendToChanges");
+    m_changes.append(path, changes, size);
+}
+
+/**
+ * @brief Show the totals for the list of changes.
+ */
+void ProcessDialogue::updateChangeTotals()
+{
+    using Change = ChangeSetModel::Change;
+    const auto listed = m_changes.count(Change::Listed);
+    QString totals;
+
+    if(0 < listed) {
+        totals = tr("%n item(s) listed, up to %1 to send.", "", listed).arg(formatSize(m_changes.bytesToSend()));
+    }
+    else {
+        totals = tr("%1 new, %2 updated, %3 deleted and %4 with changed attributes; up to %5 to send.")
+            .arg(m_changes.count(Change::New))
+            .arg(m_changes.count(Change::Updated))
+            .arg(m_changes.count(Change::Deleted))
+            .arg(m_changes.count(Change::AttributesOnly))
+            .arg(formatSize(m_changes.bytesToSend()));
+    }
+
+    m_ui->changeTotals->setText(totals);
+    const auto & paths = m_changes.pathStore();
+    m_ui->changeTotals->setToolTip(tr("The list of changes is using %1 of memory, and the paths %2.").arg(formatSize(m_changes.memoryUsed()), formatSize(paths ? paths->memoryUsed() : 0)));
+}
+
+/**
+ * @brief Complete the list of changes once the process has stopped.
+ *
+ * The remaining changes are committed and the list can then be sorted.
+ * Sorting isn't possible while the process is running, since the rows would
+ * move as the changes arrive.
+ */
+void ProcessDialogue::finishChanges()
+{
+    m_changes.commit();
+    m_ui->changes->setSortingEnabled(true);
+    updateChangeTotals();
 }
 
 /**
  * @brief Save the current content of the output widget.
  *
  * A file dialogue is presented to the user, and if s/he does not cancel
- * the dialogue, the file chosen in overwritten with the content of
- * the output text edit.
+ * the dialogue, the file chosen in overwritten with the paths of all the items
+ * processed, including those no longer shown in the details list. The paths
+ * are streamed from the log, so this does not require memory proportional to
+ * the number of items.
  */
 void ProcessDialogue::saveOutput()
 {
@@ -175,7 +342,10 @@ void ProcessDialogue::saveOutput()
         return;
     }
 
-    f.write(m_ui->details->toPlainText().toUtf8());
+    if(!m_log.writeTo(f)) {
+        qyncApp->mainWindow()->showNotification(tr("%1 Warning").arg(qyncApp->applicationDisplayName()), tr("The output could not be saved to %1.").arg(fileName), NotificationType::Warning);
+    }
+
     f.close();
 }
 
@@ -186,6 +356,13 @@ void ProcessDialogue::saveOutput()
  */
 void ProcessDialogue::onProcessStarted()
 {
+    // the process may be running again, in which case the last run's items go,
+    // along with the store of their paths
+    m_log.setPathStore(m_process->pathStore());
+    m_ui->changes->setSortingEnabled(false);
+    m_ui->changes->horizontalHeader()->setSortIndicator(ChangeSetModel::PathColumn, Qt::AscendingOrder);
+    m_changes.setPathStore(m_process->pathStore());
+    m_followLog = true;
     m_abortButton->setEnabled(true);
     m_saveButton->setEnabled(false);
 }
@@ -199,6 +376,8 @@ void ProcessDialogue::onProcessStarted()
  */
 void ProcessDialogue::onProcessFinished(const QString &)
 {
+    m_log.commit();
+    finishChanges();
     m_abortButton->setEnabled(false);
     m_saveButton->setEnabled(true);
 }
@@ -211,6 +390,8 @@ void ProcessDialogue::onProcessFinished(const QString &)
  */
 void ProcessDialogue::onProcessInterrupted(const QString &)
 {
+    m_log.commit();
+    finishChanges();
     m_abortButton->setEnabled(false);
     m_saveButton->setEnabled(true);
 }
@@ -226,6 +407,8 @@ void ProcessDialogue::onProcessInterrupted(const QString &)
  */
 void ProcessDialogue::onProcessFailed(const QString &)
 {
+    m_log.commit();
+    finishChanges();
     m_abortButton->setEnabled(false);
     m_saveButton->setEnabled(true);
 }
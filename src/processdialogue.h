@@ -9,8 +9,11 @@
  * @dep
  * - memory
  * - QDialog
+ * - QPointer
  * - QString
  * - functions.h
+ * - transferlogmodel.h
+ * - changesetmodel.h
  */
 
 #ifndef QYNC_PROCESSDIALOGUE_H
@@ -19,9 +22,12 @@
 #include <memory>
 
 #include <QDialog>
+#include <QPointer>
 #include <QString>
 
 #include "functions.h"
+#include "transferlogmodel.h"
+#include "changesetmodel.h"
 
 class QCloseEvent;
 class QPushButton;
@@ -42,13 +48,19 @@ namespace Qync {
 		explicit ProcessDialogue(const std::shared_ptr<Process> &, QWidget * = nullptr);
 		~ProcessDialogue() override;
 
+		void setProcess(const std::shared_ptr<Process> &);
+
+		[[nodiscard]] const Process * process() const;
+
 	public Q_SLOTS:
 		void toggleDetailedText();
 		void showDetailedText();
 		void hideDetailedText();
 
 	private Q_SLOTS:
-		void appendToDetails(const QString &);
+		void appendToDetails(PathStore::Id, quint64);
+		void appendToChanges(PathStore::Id, const QString &, quint64);
+		void updateChangeTotals();
 		void saveOutput();
 
 		void onProcessStarted();
@@ -57,10 +69,17 @@ namespace Qync {
 		void onProcessFailed(const QString & = QStringLiteral());
 
 	protected:
+		bool event(QEvent *) override;
 		void closeEvent(QCloseEvent *) override;
 
 	private:
+		void finishChanges();
+
 		std::unique_ptr<Ui::ProcessDialogue> m_ui;
+		TransferLogModel m_log;
+		ChangeSetModel m_changes;
+		bool m_followLog;
+		QPointer<Process> m_process;
 
 		/* pointers to these are kept for convenience. they are valid for as long
 		 * as m_ui is valid (i.e. the lifetime of the object) */
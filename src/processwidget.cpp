@@ -11,8 +11,9 @@
 #include "ui_processwidget.h"
 
 #include "application.h"
+#include "functions.h"
+#include "instrumentation.h"
 #include "process.h"
-#include "units.h"
 
 using namespace Qync;
 
@@ -23,6 +24,12 @@ using namespace Qync;
  * @version 1.1.1
  *
  * @brief A custom widget to present the progress of a Qync process.
+ *
+ * The progress signals from the process are passed through a
+ * ProgressAggregator, so the widget is updated at most as often as the
+ * progress update rate in the application preferences, however quickly rsync
+ * reports its progress. While the process is waiting to retry a failed rsync
+ * the widget says so, and the overall progress is left where it was.
  */
 
 /**
@@ -38,10 +45,18 @@ using namespace Qync;
 ProcessWidget::ProcessWidget(QWidget * parent, const std::shared_ptr<Process> & process)
 :   QWidget(parent),
     m_ui(new Ui::ProcessWidget),
-    m_process(nullptr)
+    m_process(nullptr),
+    m_connectedProcess(),
+    m_progress()
 {
     m_ui->setupUi(this);
 
+    connect(&m_progress, &ProgressAggregator::itemProgressChanged, this, &ProcessWidget::updateItemProgress);
+    connect(&m_progress, &ProgressAggregator::transferSpeedChanged, this, &ProcessWidget::updateTransferSpeed);
+    connect(&m_progress, &ProgressAggregator::overallProgressChanged, this, &ProcessWidget::updateOverallProgress);
+    connect(&m_progress, &ProgressAggregator::overallSecondsRemainingChanged, this, &ProcessWidget::updateOverallSecondsRemaining);
+    connect(&m_progress, &ProgressAggregator::itemChanged, this, &ProcessWidget::onNewItemStarted);
+
     if(process) {
         setProcess(process);
     }
@@ -59,27 +74,37 @@ ProcessWidget::ProcessWidget(QWidget * parent, const std::shared_ptr<Process> &
  *
  * If the widget was already representing a process, shared ownership of that
  * process is released immediately before taking shared ownership of the provided
- * process.
+ * process. If the process is the one the widget was already representing (for
+ * example because it has been rearmed to run again), its signals are already
+ * connected and only ownership is taken again.
  */
 void ProcessWidget::setProcess(const std::shared_ptr<Process> & process)
 {
-    if(m_process) {
-        m_process->disconnect(this);
-    }
-
     m_process = process;
     Process * tempProcess = process.get();
+    m_progress.setUpdateRate(qyncApp->preferences().progressUpdateRate());
+    m_progress.setProcess(tempProcess);
+
+    // a process that has been rearmed to run again is still connected
+    if(tempProcess == m_connectedProcess) {
+        return;
+    }
+
+    if(m_connectedProcess) {
+        m_connectedProcess->disconnect(this);
+    }
 
+    m_connectedProcess = tempProcess;
     connect(tempProcess, &Process::started, this, &ProcessWidget::onProcessStarted);
     connect(tempProcess, static_cast<void (Process::*)(QString)>(&Process::finished), this, &ProcessWidget::onProcessFinished);
     connect(tempProcess, &Process::interrupted, this, &ProcessWidget::onProcessInterrupted);
     connect(tempProcess, &Process::failed, this, &ProcessWidget::onProcessFailed);
-    connect(tempProcess, &Process::itemProgress, this, &ProcessWidget::updateItemProgress);
-    connect(tempProcess, &Process::transferSpeed, this, &ProcessWidget::updateTransferSpeed);
-    connect(tempProcess, &Process::overallProgress, this, &ProcessWidget::updateOverallProgress);
-    connect(tempProcess, &Process::newItemStarted, this, &ProcessWidget::onNewItemStarted);
 
-    connect(tempProcess, &Process::error, [](const QString & err) {
+    connect(tempProcess, &Process::retrying, this, [this](Process::ExitCode, int attempt, int seconds) {
+        onProcessRetrying(attempt, seconds);
+    });
+
+    connect(tempProcess, &Process::error, this, [](const QString & err) {
         qyncApp->mainWindow()->showNotification(tr("%1 Warning").arg(qyncApp->applicationDisplayName()), tr("The following error occurred in rsync:\n\n%1").arg(err), NotificationType::Error);
     });
 }
@@ -96,6 +121,7 @@ ProcessWidget::~ProcessWidget() = default;
  */
 void ProcessWidget::updateItemProgress(int pc)
 {
+    Instrumentation::Scope scope(Instrumentation::Histogram::UiUpdateTime, "ProcessWidget::updateItemProgress");
     m_ui->itemProgress->setMaximum(100);
     m_ui->itemProgress->setValue(pc);
 }
@@ -109,6 +135,7 @@ void ProcessWidget::updateItemProgress(int pc)
  */
 void ProcessWidget::onNewItemStarted(const QString & item)
 {
+    Instrumentation::Scope scope(Instrumentation::Histogram::UiUpdateTime, "ProcessWidget::onNewItemStarted");
     m_ui->itemName->setText(item);
 }
 
@@ -121,37 +148,39 @@ void ProcessWidget::onNewItemStarted(const QString & item)
  */
 void ProcessWidget::updateOverallProgress(int pc)
 {
+    Instrumentation::Scope scope(Instrumentation::Histogram::UiUpdateTime, "ProcessWidget::updateOverallProgress");
     m_ui->overallProgress->setMaximum(100);
     m_ui->overallProgress->setValue(pc);
 }
 
+/**
+ * @brief Updates the display of the time remaining for the whole process.
+ *
+ * @param seconds is the estimated number of seconds remaining.
+ *
+ * The estimate is shown in the overall progress bar, alongside the percentage.
+ */
+void ProcessWidget::updateOverallSecondsRemaining(int seconds)
+{
+    Instrumentation::Scope scope(Instrumentation::Histogram::UiUpdateTime, "ProcessWidget::updateOverallSecondsRemaining");
+    const int hours = seconds / 3600;
+    const int minutes = (seconds / 60) % 60;
+    seconds %= 60;
+    m_ui->overallProgress->setFormat(tr("%p% (%1:%2:%3 remaining)").arg(hours).arg(minutes, 2, 10, QLatin1Char('0')).arg(seconds, 2, 10, QLatin1Char('0')));
+}
+
 /**
  * @brief Updates the display of the transfer speed.
  *
  * @param speed The transfer speed to display, in bytes per second.
  *
- * Currently the speed is always displayed as bytes per second. It is likely
- * to change to adapt the display unit based on the size of the transfer
- * speed.
+ * The speed is shown in the largest unit of which there are at least two (see
+ * formatSpeed()).
  */
 void ProcessWidget::updateTransferSpeed(float speed)
 {
-    QString unit = "B/s";
-
-    if(static_cast<long double>(speed) > 2.0_gib) {
-        speed /= 1.0_gib;
-        unit = "GiB/s";
-    }
-    else if(static_cast<long double>(speed) > 2.0_mib) {
-        speed /= 1.0_mib;
-        unit = "MiB/s";
-    }
-    else if(static_cast<long double>(speed) > 2.0_kib) {
-        speed /= 1.0_kib;
-        unit = "KiB/s";
-    }
-
-    m_ui->transferSpeed->setText(QLocale().toString(static_cast<double>(speed), 'f', 2) + " " + unit);
+    Instrumentation::Scope scope(Instrumentation::Histogram::UiUpdateTime, "ProcessWidget::updateTransferSpeed");
+    m_ui->transferSpeed->setText(formatSpeed(speed));
 }
 
 /**
@@ -165,6 +194,7 @@ void ProcessWidget::onProcessStarted()
     m_ui->transferSpeed->setText({});
     m_ui->itemProgress->setValue(0);
     m_ui->overallProgress->setValue(0);
+    m_ui->overallProgress->setFormat(QStringLiteral("%p%"));
     m_ui->itemProgress->setMaximum(0);
     m_ui->overallProgress->setMaximum(0);
 }
@@ -180,10 +210,14 @@ void ProcessWidget::onProcessStarted()
  */
 void ProcessWidget::onProcessFinished(const QString & msg)
 {
+    // make sure the final transfer speed is shown
+    m_progress.flush();
+    m_progress.setProcess(nullptr);
     m_ui->itemProgress->setMaximum(100);
     m_ui->itemProgress->setValue(100);
     m_ui->overallProgress->setMaximum(100);
     m_ui->overallProgress->setValue(100);
+    m_ui->overallProgress->setFormat(QStringLiteral("%p%"));
     m_ui->itemName->setText(QString("<strong>%1</strong>").arg(tr("Finished")));
 
     /* transfer speed will be set to the overall speed as emitted by rsync
@@ -207,10 +241,12 @@ void ProcessWidget::onProcessFinished(const QString & msg)
  */
 void ProcessWidget::onProcessInterrupted(const QString & msg)
 {
+    m_progress.setProcess(nullptr);
     m_ui->itemProgress->setMaximum(100);
     m_ui->itemProgress->setValue(0);
     m_ui->overallProgress->setMaximum(100);
     m_ui->overallProgress->setValue(0);
+    m_ui->overallProgress->setFormat(QStringLiteral("%p%"));
     m_ui->itemName->setText({});
     m_ui->transferSpeed->setText({});
     qyncApp->mainWindow()->showNotification(tr("%1 Error").arg(qyncApp->applicationDisplayName()), (msg.isEmpty() ? tr("The process was interrupted.") : msg), NotificationType::Error);
@@ -230,12 +266,31 @@ void ProcessWidget::onProcessInterrupted(const QString & msg)
  */
 void ProcessWidget::onProcessFailed(const QString & msg)
 {
+    m_progress.setProcess(nullptr);
     m_ui->itemProgress->setMaximum(100);
     m_ui->itemProgress->setValue(0);
     m_ui->overallProgress->setMaximum(100);
     m_ui->overallProgress->setValue(0);
+    m_ui->overallProgress->setFormat(QStringLiteral("%p%"));
     m_ui->itemName->setText({});
     m_ui->transferSpeed->setText({});
     qyncApp->mainWindow()->showNotification(tr("%1 Error").arg(qyncApp->applicationDisplayName()), (msg.isEmpty() ? tr("The process failed.") : msg), NotificationType::Error);
     m_process.reset();
 }
+
+/**
+ * @brief Indicate that rsync has failed and will be retried.
+ *
+ * @param attempt is the number of the retry.
+ * @param seconds is how long it will be before the retry.
+ *
+ * The item progress and transfer speed are cleared until the retry starts.
+ */
+void ProcessWidget::onProcessRetrying(int attempt, int seconds)
+{
+    const int attempts = (m_process ? m_process->retryAttempts() : attempt);
+    m_ui->itemProgress->setMaximum(100);
+    m_ui->itemProgress->setValue(0);
+    m_ui->transferSpeed->setText({});
+    m_ui->itemName->setText(QString("<strong>%1</strong>").arg(tr("Transfer interrupted. Retrying in %n second(s) (attempt %1 of %2)", "", seconds).arg(attempt).arg(attempts)));
+}
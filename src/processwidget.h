@@ -12,8 +12,11 @@
 
 #include <memory>
 
+#include <QtCore/QPointer>
 #include <QtWidgets/QWidget>
 
+#include "progressaggregator.h"
+
 namespace Qync {
 
 	namespace Ui {
@@ -36,16 +39,20 @@ namespace Qync {
 		void updateItemProgress(int);
 		void onNewItemStarted(const QString &);
 		void updateOverallProgress(int);
+		void updateOverallSecondsRemaining(int);
 		void updateTransferSpeed(float);
 
 		void onProcessStarted();
 		void onProcessFinished(const QString & = QStringLiteral());
 		void onProcessInterrupted(const QString & = QStringLiteral());
 		void onProcessFailed(const QString & = QStringLiteral());
+		void onProcessRetrying(int attempt, int seconds);
 
 	private:
 		std::unique_ptr<Ui::ProcessWidget> m_ui;
 		std::shared_ptr<Process> m_process;
+		QPointer<Process> m_connectedProcess;
+		ProgressAggregator m_progress;
 	};
 
 }  // namespace Qync
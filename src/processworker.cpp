@@ -0,0 +1,644 @@
+/**
+ * @file processworker.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the ProcessWorker class.
+ */
+
+#include "processworker.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QProcess>
+#include <QtCore/QTimer>
+
+#if defined(Q_OS_UNIX)
+#include <csignal>
+#include <sys/types.h>
+#endif
+
+#include "instrumentation.h"
+#include "process.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::ProcessWorker class.
+ */
+namespace Qync::Detail::ProcessWorker {
+    // how long rsync has to tidy up after being interrupted before it is killed
+    static constexpr const int InterruptTimeout = 10000;
+
+    // the most read from the process at once, which is what the parser's buffer
+    // is reserved for
+    static constexpr const qint64 MaximumReadSize = 64 * 1024;
+
+    // rsync is stopped when more than this many bytes of its output are waiting
+    // in the QProcess, and continued when it's down to the second
+    static constexpr const qint64 MaximumBufferedOutput = 4 * 1024 * 1024;
+    static constexpr const qint64 ResumeBufferedOutput = 1024 * 1024;
+
+    // how much of the end of rsync's error output is kept, for the warning if it fails
+    static constexpr const int MaximumErrorOutput = 4096;
+
+    static ProcessEvent eventFromLine(const RsyncOutputParser::Line & line)
+    {
+        ProcessEvent event;
+
+        switch(line.type) {
+            case RsyncOutputParser::LineType::Progress:
+                event.type = ProcessEvent::Type::Progress;
+                event.bytesPerSecond = line.bytesPerSecond;
+                event.itemBytes = line.itemBytes;
+                event.itemPercent = line.itemPercent;
+                event.secondsRemaining = line.secondsRemaining;
+                event.hasCheckCounts = line.hasCheckCounts;
+                event.itemsRemaining = line.itemsRemaining;
+                event.totalItems = line.totalItems;
+                break;
+
+            case RsyncOutputParser::LineType::NewItem:
+                // the path refers to the parser's buffer, so it must be copied here
+                event.type = ProcessEvent::Type::NewItem;
+                event.itemPath = QString::fromUtf8(line.itemPath.data(), static_cast<int>(line.itemPath.size()));
+                event.itemSize = line.itemSize;
+
+                if(!line.itemChanges.empty()) {
+                    event.itemChanges = QString::fromLatin1(line.itemChanges.data(), static_cast<int>(line.itemChanges.size()));
+                    event.itemChecksum = QByteArray(line.itemChecksum.data(), static_cast<int>(line.itemChecksum.size()));
+                    event.itemTransferredBytes = line.itemTransferredBytes;
+                }
+                break;
+
+            case RsyncOutputParser::LineType::TransferProgress:
+                event.type = ProcessEvent::Type::TransferProgress;
+                event.bytesPerSecond = line.bytesPerSecond;
+                event.transferredBytes = line.transferredBytes;
+                event.transferPercent = line.transferPercent;
+                event.secondsRemaining = line.secondsRemaining;
+                event.hasCheckCounts = line.hasCheckCounts;
+                event.itemsRemaining = line.itemsRemaining;
+                event.totalItems = line.totalItems;
+                break;
+
+            case RsyncOutputParser::LineType::Completed:
+                event.type = ProcessEvent::Type::Completed;
+                event.bytesPerSecond = line.bytesPerSecond;
+                event.bytesSent = line.bytesSent;
+                event.bytesReceived = line.bytesReceived;
+                break;
+
+            case RsyncOutputParser::LineType::Unrecognised:
+                Q_ASSERT_X(false, __PRETTY_FUNCTION__, "the parser should never provide unrecognised lines");
+                break;
+        }
+
+        return event;
+    }
+}  // namespace Qync::Detail::ProcessWorker
+
+/**
+ * @class ProcessWorker
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Runs the rsync QProcess and turns its output into events.
+ *
+ * The worker owns the QProcess for an rsync command. It reads the process's
+ * standard output, hands it to a LogFileWriter (if there is a log file), parses
+ * it and pushes a ProcessEvent for each recognised line into a queue provided
+ * by the owner. When the process finishes, a final Finished event carrying the exit
+ * code is pushed. The worker has no knowledge of how the events are used -
+ * Process is responsible for turning them into its signals.
+ *
+ * The worker is designed to be moved to its own thread, so that reading,
+ * logging and parsing do not compete with the user interface for the event
+ * loop. It does not require it, though: it works just as well in the thread
+ * that owns the queue's consumer. Either way, all its slots must be invoked in
+ * the worker's thread (i.e. using QMetaObject::invokeMethod() or queued
+ * connections) and it is the only producer for its queue.
+ *
+ * The queue is bounded. When it fills up, the worker keeps hold of the event
+ * it was unable to push, marks itself as stalled and stops reading from the
+ * process. The pipe from rsync then fills up and rsync blocks, so the memory
+ * used never grows with the rate at which rsync produces output. When the
+ * consumer has drained the queue it should check isStalled() and invoke the
+ * resume() slot if necessary.
+ *
+ * QProcess keeps reading the pipe into its own buffer regardless, so while the
+ * worker is stalled the output that builds up there is watched too. When more
+ * than Detail::ProcessWorker::MaximumBufferedOutput bytes are waiting, rsync
+ * is stopped (with SIGSTOP) until the worker has read all but
+ * Detail::ProcessWorker::ResumeBufferedOutput bytes of it. Output is read in
+ * chunks no bigger than the parser's buffer, so the parser doesn't grow with
+ * the backlog either. The error output is read as it arrives and only its end
+ * is kept (see readStderr()), so it can't build up at all. Stopping rsync isn't possible on Windows, where the
+ * backlog is only limited by the queue. The output waiting in all the workers,
+ * the most there has been and the number of times rsync has been stopped are
+ * available from bufferedOutput(), peakBufferedOutput() and pauseCount() for
+ * the diagnostics.
+ *
+ * The output is parsed as rsync's plain text output unless setOutputFormat() is
+ * called before the worker is started; it must match the output options in the
+ * arguments (see Process::OutputFormat).
+ *
+ * The eventsAvailable() signal is emitted when events are pushed into an
+ * empty-as-far-as-the-consumer-knows queue. It is not emitted again until the
+ * consumer calls acknowledgeEvents(), which it should do before it starts to
+ * drain the queue. This keeps the number of cross-thread signals down to
+ * roughly one per consumer wakeup rather than one per line of output.
+ */
+
+/**
+ * @brief Create a new worker.
+ *
+ * @param cmd The rsync command to run.
+ * @param args The arguments for the rsync command.
+ * @param logFileName The file to which to write rsync's output. If empty, the
+ * output is not logged.
+ * @param queue The queue into which to push the parsed events. It must outlive
+ * the worker.
+ * @param logRotationSize The size in bytes at which to rotate the log file, or
+ * 0 never to rotate it.
+ * @param logRotationCount The number of rotated log files to keep.
+ *
+ * The process is not started until the start() slot is invoked.
+ */
+ProcessWorker::ProcessWorker(QString cmd, QStringList args, QString logFileName, ProcessEventQueue & queue, qint64 logRotationSize, int logRotationCount)
+:   QObject(),
+    m_process(),
+    m_command(std::move(cmd)),
+    m_args(std::move(args)),
+    m_logFileName(std::move(logFileName)),
+    m_logRotationSize(logRotationSize),
+    m_logRotationCount(logRotationCount),
+    m_appendToLog(false),
+    m_log(),
+    m_parser(),
+    m_errorOutput(),
+    m_queue(queue),
+    m_pendingEvent(),
+    m_hasPendingEvent(false),
+    m_processFinished(false),
+    m_finishedQueued(false),
+    m_paused(false),
+    m_bufferedOutput(0),
+    m_stalled(false),
+    m_notifyPending(false)
+{
+}
+
+/**
+ * @brief Destroy the worker.
+ *
+ * If the process is still running it is killed. If the worker has been moved to
+ * another thread, invoke shutdown() in that thread before destroying it.
+ */
+ProcessWorker::~ProcessWorker()
+{
+    s_bufferedOutput.fetch_sub(m_bufferedOutput, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Start measuring the peak of the buffered output again.
+ *
+ * The peak is set to what is buffered now. This can be called from any thread.
+ */
+void ProcessWorker::resetPeakBufferedOutput()
+{
+    s_peakBufferedOutput.store(s_bufferedOutput.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Start the rsync process.
+ *
+ * The process's QProcess is created here so that it belongs to the worker's
+ * thread. If rsync can't be run at all, the Finished event is pushed straight
+ * away with Process::ExitCode::FailedToStart.
+ */
+void ProcessWorker::start()
+{
+    Q_ASSERT_X(!m_process, __PRETTY_FUNCTION__, "the worker has already been started");
+
+    if(!m_logFileName.isEmpty()) {
+        m_log = std::make_unique<LogFileWriter>(m_logFileName, m_logRotationSize, m_logRotationCount);
+        m_log->setAppend(m_appendToLog);
+        m_log->open();
+    }
+
+    m_process = std::make_unique<QProcess>();
+    connect(m_process.get(), &QProcess::readyReadStandardOutput, this, &ProcessWorker::readStdout);
+    connect(m_process.get(), &QProcess::readyReadStandardError, this, &ProcessWorker::readStderr);
+    connect(m_process.get(), qOverload<int, QProcess::ExitStatus>(&QProcess::finished), this, &ProcessWorker::onProcessFinished);
+
+    connect(m_process.get(), &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        // finished() is not emitted for a process that never started
+        if(QProcess::FailedToStart == error) {
+            qWarning() << __PRETTY_FUNCTION__ << "failed to run" << m_command << ":" << m_process->errorString();
+            onProcessFinished();
+        }
+    });
+
+    m_process->start(m_command, m_args);
+}
+
+/**
+ * @brief Stop the rsync process.
+ *
+ * Any output the process has produced that has not yet been read is discarded.
+ * The Finished event is still pushed once the process has terminated.
+ */
+void ProcessWorker::stop()
+{
+    if(!m_process || QProcess::NotRunning == m_process->state()) {
+        return;
+    }
+
+    disconnect(m_process.get(), &QProcess::readyReadStandardOutput, this, &ProcessWorker::readStdout);
+    continueProcess();
+    m_process->close();
+    updateBufferedOutput();
+}
+
+/**
+ * @brief Ask the rsync process to stop, letting it tidy up first.
+ *
+ * Unlike stop(), rsync is sent a termination request rather than being killed,
+ * so that with @b --partial it keeps the part of the file it was transferring,
+ * and its output is read until it exits. If it is still running after
+ * Detail::ProcessWorker::InterruptTimeout milliseconds (or the platform has no
+ * way to ask a console program to stop) it is killed. The Finished event is
+ * pushed once the process has terminated.
+ */
+void ProcessWorker::interrupt()
+{
+    if(!m_process || QProcess::NotRunning == m_process->state()) {
+        return;
+    }
+
+    // a stopped rsync can't act on the request
+    continueProcess();
+    m_process->terminate();
+    QTimer::singleShot(Detail::ProcessWorker::InterruptTimeout, m_process.get(), &QProcess::kill);
+}
+
+/**
+ * @brief Continue reading output after the queue has been full.
+ *
+ * The consumer invokes this when it has made room in the queue and isStalled()
+ * returns @b true.
+ */
+void ProcessWorker::resume()
+{
+    m_stalled.store(false, std::memory_order_release);
+    pump();
+}
+
+/**
+ * @brief Kill the process and release the worker's resources.
+ *
+ * This must be called in the worker's thread, so that the QProcess is
+ * destroyed in the thread that created it.
+ */
+void ProcessWorker::shutdown()
+{
+    if(m_process) {
+        m_process->disconnect(this);
+        continueProcess();
+        m_process.reset();
+    }
+
+    m_log.reset();
+    m_parser.reset();
+    updateBufferedOutput();
+}
+
+/**
+ * @brief Read the process's error output stream.
+ *
+ * The error output is read as soon as it arrives, even while the worker is
+ * stalled, so that it never builds up in the QProcess. Only the last
+ * Detail::ProcessWorker::MaximumErrorOutput bytes are kept, to be reported if
+ * rsync fails.
+ */
+void ProcessWorker::readStderr()
+{
+    Q_ASSERT(m_process);
+    m_errorOutput.append(m_process->readAllStandardError());
+
+    if(Detail::ProcessWorker::MaximumErrorOutput < m_errorOutput.size()) {
+        m_errorOutput = m_errorOutput.right(Detail::ProcessWorker::MaximumErrorOutput);
+    }
+
+    updateBufferedOutput();
+}
+
+/**
+ * @brief Handle the availability of new output from the process.
+ *
+ * While the worker is stalled the output is left in the QProcess, and rsync
+ * is stopped if too much builds up.
+ */
+void ProcessWorker::readStdout()
+{
+    if(m_stalled.load(std::memory_order_acquire)) {
+        updateBufferedOutput();
+        return;
+    }
+
+    pump();
+}
+
+/**
+ * @brief Called when the QProcess finishes.
+ */
+void ProcessWorker::onProcessFinished()
+{
+    m_processFinished = true;
+    m_paused = false;
+
+    if(m_stalled.load(std::memory_order_acquire)) {
+        // pump() will be called when the consumer resumes us
+        return;
+    }
+
+    pump();
+}
+
+/**
+ * @brief Move as much output as possible from the process into the queue.
+ *
+ * Output is read, logged and parsed until there is none left or the queue is
+ * full. Once the process has finished and all its output has been queued, the
+ * Finished event is pushed.
+ */
+void ProcessWorker::pump()
+{
+    Instrumentation::Scope scope(Instrumentation::Histogram::ParseBatchTime, "ProcessWorker::pump");
+
+    if(m_hasPendingEvent) {
+        if(!m_queue.push(std::move(m_pendingEvent))) {
+            // consumer still hasn't caught up
+            m_stalled.store(true, std::memory_order_release);
+            notifyConsumer();
+            updateBufferedOutput();
+            return;
+        }
+
+        m_hasPendingEvent = false;
+        notifyConsumer();
+    }
+
+    RsyncOutputParser::Line line;
+
+    while(true) {
+        while(m_parser.nextLine(line)) {
+            Instrumentation::add(Instrumentation::Counter::LinesParsed);
+
+            if(!enqueue(Detail::ProcessWorker::eventFromLine(line))) {
+                updateBufferedOutput();
+                return;
+            }
+        }
+
+        if(!m_process) {
+            break;
+        }
+
+        QByteArray data = m_process->read(Detail::ProcessWorker::MaximumReadSize);
+
+        if(data.isEmpty()) {
+            break;
+        }
+
+        Instrumentation::add(Instrumentation::Counter::StdoutReads);
+        Instrumentation::add(Instrumentation::Counter::StdoutBytes, static_cast<quint64>(data.size()));
+        Instrumentation::record(Instrumentation::Histogram::StdoutReadSize, static_cast<quint64>(data.size()));
+
+        if(m_log) {
+            m_log->write(data);
+        }
+
+        m_parser.append(data);
+    }
+
+    updateBufferedOutput();
+
+    if(m_processFinished && !m_finishedQueued) {
+        Q_ASSERT_X(m_process, __PRETTY_FUNCTION__, "process finished without a QProcess object");
+        // flushes whatever is left before Finished is delivered, so the log is complete by then
+        m_log.reset();
+        m_parser.reset();
+        readStderr();
+
+        ProcessEvent event;
+        event.type = ProcessEvent::Type::Finished;
+
+        if(QProcess::FailedToStart == m_process->error()) {
+            event.exitCode = static_cast<int>(Process::ExitCode::FailedToStart);
+        }
+        else if(QProcess::CrashExit == m_process->exitStatus()) {
+            // the exit code is the signal, which would read as one of rsync's codes
+            event.exitCode = static_cast<int>(Process::ExitCode::Crashed);
+        }
+        else {
+            event.exitCode = m_process->exitCode();
+        }
+
+        if(0 != event.exitCode && !m_errorOutput.isEmpty()) {
+            qWarning() << __PRETTY_FUNCTION__ << m_command << "failed:" << QString::fromUtf8(m_errorOutput).trimmed();
+        }
+
+        m_errorOutput.clear();
+        updateBufferedOutput();
+
+        // if the queue is full, the event is kept pending so it still goes exactly once
+        m_finishedQueued = true;
+        enqueue(std::move(event));
+    }
+}
+
+/**
+ * @brief Push an event into the queue.
+ *
+ * @param event The event to push.
+ *
+ * If the queue is full, the event is kept as the pending event and the worker
+ * becomes stalled.
+ *
+ * @return @b true if the event was pushed, @b false if the worker is now
+ * stalled.
+ */
+bool ProcessWorker::enqueue(ProcessEvent && event)
+{
+    if(m_queue.push(std::move(event))) {
+        notifyConsumer();
+        return true;
+    }
+
+    m_pendingEvent = std::move(event);
+    m_hasPendingEvent = true;
+
+    // the flag must be set before notifying, so that the consumer sees it once it has drained the queue
+    m_stalled.store(true, std::memory_order_release);
+    notifyConsumer();
+    return false;
+}
+
+/**
+ * @brief Tell the consumer that there are events to process.
+ *
+ * The signal is only emitted if the consumer has acknowledged the previous one.
+ */
+void ProcessWorker::notifyConsumer()
+{
+    if(!m_notifyPending.exchange(true, std::memory_order_acq_rel)) {
+        Q_EMIT eventsAvailable();
+    }
+}
+
+/**
+ * @brief Account for the output waiting to be parsed, stopping or continuing
+ * rsync as necessary.
+ */
+void ProcessWorker::updateBufferedOutput()
+{
+    const auto waiting = (m_process ? m_process->bytesAvailable() : 0);
+    const auto buffered = waiting + m_parser.pendingBytes() + m_errorOutput.size();
+    const auto total = s_bufferedOutput.fetch_add(buffered - m_bufferedOutput, std::memory_order_relaxed) + buffered - m_bufferedOutput;
+    m_bufferedOutput = buffered;
+    auto peak = s_peakBufferedOutput.load(std::memory_order_relaxed);
+
+    while(total > peak && !s_peakBufferedOutput.compare_exchange_weak(peak, total, std::memory_order_relaxed)) {
+    }
+
+    if(!m_paused && Detail::ProcessWorker::MaximumBufferedOutput < waiting) {
+        pauseProcess();
+    }
+    else if(m_paused && Detail::ProcessWorker::ResumeBufferedOutput >= waiting) {
+        continueProcess();
+    }
+}
+
+/**
+ * @brief Stop rsync until its output has been read.
+ */
+void ProcessWorker::pauseProcess()
+{
+#if defined(Q_OS_UNIX)
+    if(!m_process || QProcess::Running != m_process->state()) {
+        return;
+    }
+
+    if(0 != ::kill(static_cast<pid_t>(m_process->processId()), SIGSTOP)) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to stop rsync process" << m_process->processId();
+        return;
+    }
+
+    m_paused = true;
+    s_pauseCount.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+/**
+ * @brief Continue rsync if it has been stopped.
+ */
+void ProcessWorker::continueProcess()
+{
+#if defined(Q_OS_UNIX)
+    if(!m_paused) {
+        return;
+    }
+
+    m_paused = false;
+
+    if(m_process && QProcess::NotRunning != m_process->state()) {
+        ::kill(static_cast<pid_t>(m_process->processId()), SIGCONT);
+    }
+#endif
+}
+
+/**
+ * @fn ProcessWorker::isStalled()
+ * @brief Check whether the worker has stopped reading because the queue is full.
+ *
+ * This can be called from any thread.
+ *
+ * @return @b true if the worker is waiting for resume() to be invoked.
+ */
+
+/**
+ * @fn ProcessWorker::acknowledgeEvents()
+ * @brief Indicate that the consumer is about to drain the queue.
+ *
+ * Call this from the consumer's thread before popping events. Until it is
+ * called, the worker won't emit eventsAvailable() again.
+ */
+
+/**
+ * @fn ProcessWorker::eventsAvailable()
+ * @brief Emitted when there are events in the queue for the consumer.
+ */
+
+/**
+ * @fn ProcessWorker::outputFormat()
+ * @brief Fetch the format in which rsync's output is parsed.
+ *
+ * @return The format.
+ */
+
+/**
+ * @fn ProcessWorker::setOutputFormat()
+ * @brief Set the format in which rsync's output is parsed.
+ *
+ * @param format The format.
+ */
+
+/**
+ * @fn ProcessWorker::appendsToLog()
+ * @brief Check whether rsync's output is added to the end of an existing log.
+ *
+ * @return @b true if the log file is appended to, @b false if it is truncated.
+ */
+
+/**
+ * @fn ProcessWorker::setAppendToLog()
+ * @brief Set whether rsync's output is added to the end of an existing log.
+ *
+ * @param append @b true to append to the log file, @b false to truncate it.
+ *
+ * This must be called before start(). A worker that replaces one that was
+ * interrupted appends, so that the log holds the output of both.
+ */
+
+/**
+ * @fn ProcessWorker::bufferedOutput()
+ * @brief Fetch how much rsync output is waiting to be parsed, in all the
+ * workers.
+ *
+ * This can be called from any thread.
+ *
+ * @return The number of bytes.
+ */
+
+/**
+ * @fn ProcessWorker::peakBufferedOutput()
+ * @brief Fetch the most rsync output there has been waiting to be parsed, in
+ * all the workers.
+ *
+ * This can be called from any thread.
+ *
+ * @return The number of bytes.
+ */
+
+/**
+ * @fn ProcessWorker::pauseCount()
+ * @brief Fetch how many times an rsync has been stopped because too much of
+ * its output was waiting to be read.
+ *
+ * This can be called from any thread.
+ *
+ * @return The number of times.
+ */
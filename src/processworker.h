@@ -0,0 +1,181 @@
+/**
+ * @file processworker.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the ProcessWorker class.
+ */
+
+#ifndef QYNC_PROCESSWORKER_H
+#define QYNC_PROCESSWORKER_H
+
+#include <atomic>
+#include <memory>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include "logfilewriter.h"
+#include "rsyncoutputparser.h"
+#include "spscqueue.h"
+
+class QProcess;
+
+namespace Qync {
+
+	struct ProcessEvent {
+		enum class Type : unsigned char {
+			Progress = 0,
+			NewItem,
+			Completed,
+			Finished,
+			TransferProgress,
+		};
+
+		Type type = Type::Progress;
+
+		/* Progress, TransferProgress and Completed */
+		double bytesPerSecond = 0.0;
+
+		/* Progress and TransferProgress */
+		int secondsRemaining = 0;
+		bool hasCheckCounts = false;
+		int itemsRemaining = 0;
+		int totalItems = 0;
+
+		/* Progress */
+		quint64 itemBytes = 0;
+		int itemPercent = 0;
+
+		/* TransferProgress */
+		quint64 transferredBytes = 0;
+		int transferPercent = 0;
+
+		/* NewItem */
+		QString itemPath;
+		quint64 itemSize = 0;
+
+		/* NewItem, structured output only */
+		QString itemChanges;
+		QByteArray itemChecksum;
+		quint64 itemTransferredBytes = 0;
+
+		/* Completed */
+		quint64 bytesSent = 0;
+		quint64 bytesReceived = 0;
+
+		/* Finished */
+		int exitCode = 0;
+	};
+
+	using ProcessEventQueue = SpscQueue<ProcessEvent>;
+
+	class ProcessWorker
+	: public QObject {
+		Q_OBJECT
+
+	public:
+		ProcessWorker(QString cmd, QStringList args, QString logFileName, ProcessEventQueue & queue, qint64 logRotationSize = 0, int logRotationCount = 5);
+		~ProcessWorker() override;
+
+		[[nodiscard]] inline RsyncOutputParser::Format outputFormat() const {
+			return m_parser.format();
+		}
+
+		inline void setOutputFormat(RsyncOutputParser::Format format) {
+			m_parser.setFormat(format);
+		}
+
+		[[nodiscard]] inline bool appendsToLog() const {
+			return m_appendToLog;
+		}
+
+		inline void setAppendToLog(bool append) {
+			m_appendToLog = append;
+		}
+
+		[[nodiscard]] inline bool isStalled() const {
+			return m_stalled.load(std::memory_order_acquire);
+		}
+
+		inline void acknowledgeEvents() {
+			// read-modify-write so we synchronise with the producer's exchange() in notifyConsumer()
+			m_notifyPending.exchange(false, std::memory_order_acq_rel);
+		}
+
+		[[nodiscard]] static inline qint64 bufferedOutput() {
+			return s_bufferedOutput.load(std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] static inline qint64 peakBufferedOutput() {
+			return s_peakBufferedOutput.load(std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] static inline quint64 pauseCount() {
+			return s_pauseCount.load(std::memory_order_relaxed);
+		}
+
+		static void resetPeakBufferedOutput();
+
+	Q_SIGNALS:
+		void eventsAvailable();
+
+	public Q_SLOTS:
+		void start();
+		void stop();
+		void interrupt();
+		void resume();
+		void shutdown();
+
+	private Q_SLOTS:
+		void readStdout();
+		void readStderr();
+		void onProcessFinished();
+
+	private:
+		void pump();
+		bool enqueue(ProcessEvent && event);
+		void notifyConsumer();
+		void updateBufferedOutput();
+		void pauseProcess();
+		void continueProcess();
+
+		std::unique_ptr<QProcess> m_process;
+		QString m_command;
+		QStringList m_args;
+		QString m_logFileName;
+		qint64 m_logRotationSize;
+		int m_logRotationCount;
+		bool m_appendToLog;
+		std::unique_ptr<LogFileWriter> m_log;
+		RsyncOutputParser m_parser;
+
+		/* the end of rsync's error output; the rest is discarded as it is read */
+		QByteArray m_errorOutput;
+		ProcessEventQueue & m_queue;
+
+		/* an event that didn't fit in the queue; it's the first to go when the consumer catches up */
+		ProcessEvent m_pendingEvent;
+		bool m_hasPendingEvent;
+		bool m_processFinished;
+		bool m_finishedQueued;
+
+		/* rsync is stopped while too much of its output is waiting to be read */
+		bool m_paused;
+		qint64 m_bufferedOutput;
+
+		std::atomic<bool> m_stalled;
+		std::atomic<bool> m_notifyPending;
+
+		/* for all the workers */
+		static inline std::atomic<qint64> s_bufferedOutput{0};
+		static inline std::atomic<qint64> s_peakBufferedOutput{0};
+		static inline std::atomic<quint64> s_pauseCount{0};
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_PROCESSWORKER_H
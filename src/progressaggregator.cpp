@@ -0,0 +1,373 @@
+/**
+ * @file progressaggregator.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the ProgressAggregator class.
+ */
+
+#include "progressaggregator.h"
+
+#include <QtCore/QDebug>
+
+#include "guipreferences.h"
+#include "instrumentation.h"
+#include "process.h"
+
+using namespace Qync;
+
+/**
+ * @class ProgressAggregator
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Coalesces the progress signals from a Process into rate-limited
+ * updates.
+ *
+ * rsync reports progress for every file it transfers, so a Process synchronising
+ * lots of small files emits its progress signals tens of thousands of times a
+ * second - far more often than anyone can read a label or a progress bar. The
+ * aggregator sits between a Process and the widgets that show its progress. It
+ * records only the latest value of each part of the progress and, at most
+ * updateRate() times per second, emits a signal for each part that has changed
+ * since the last update. The cost of each signal from the Process is therefore
+ * a few assignments, and the cost of updating the display is independent of
+ * how quickly the files are going by. Item paths arrive as PathStore Ids and
+ * only the path of the item in each update is built. The aggregator holds the
+ * process's store and a reference to the latest item's path in it until the
+ * next item arrives.
+ *
+ * The timer only runs while there is an update waiting to be delivered, so an
+ * idle or slow process doesn't cause any extra wakeups.
+ *
+ * Each update from the Process that is overwritten by a newer one before it has
+ * been delivered is counted as dropped. The counts are available from
+ * receivedUpdateCount() and droppedUpdateCount() and are reset when a new
+ * process is set. The updates are also counted by the Instrumentation, for all
+ * processes together, so the DiagnosticsDialogue shows them.
+ *
+ * Call flush() to deliver any waiting update immediately - for example when the
+ * process finishes - or reset() to discard it.
+ */
+
+/**
+ * @brief Create a new aggregator.
+ *
+ * @param parent The parent object.
+ *
+ * The update rate is initially GuiPreferences::DefaultProgressUpdateRate.
+ */
+ProgressAggregator::ProgressAggregator(QObject * parent)
+:   QObject(parent),
+    m_process(),
+    m_paths(),
+    m_timer(),
+    m_updateRate(GuiPreferences::DefaultProgressUpdateRate),
+    m_item(PathStore::NoPath),
+    m_itemProgress(0),
+    m_itemSecondsRemaining(0),
+    m_overallProgress(0),
+    m_overallSecondsRemaining(0),
+    m_transferSpeed(0.0f),
+    m_dirty(0),
+    m_received(0),
+    m_dropped(0)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::CoarseTimer);
+    m_timer.setInterval(1000 / m_updateRate);
+    connect(&m_timer, &QTimer::timeout, this, &ProgressAggregator::flush);
+}
+
+/**
+ * @brief Destroy the aggregator.
+ */
+ProgressAggregator::~ProgressAggregator()
+{
+    setPathStore(nullptr);
+}
+
+/**
+ * @brief Set the process whose progress is aggregated.
+ *
+ * @param process The process. It may be @b nullptr to stop aggregating.
+ *
+ * Any update waiting to be delivered for the previous process is discarded and
+ * the counts are reset.
+ */
+void ProgressAggregator::setProcess(Process * process)
+{
+    if(m_process) {
+        m_process->disconnect(this);
+    }
+
+    reset();
+    m_received = 0;
+    m_dropped = 0;
+    m_process = process;
+
+    if(!process) {
+        setPathStore(nullptr);
+        return;
+    }
+
+    setPathStore(process->pathStore());
+    connect(process, &Process::started, this, &ProgressAggregator::onProcessStarted);
+    connect(process, &Process::newItemStarted, this, &ProgressAggregator::onNewItemStarted);
+    connect(process, &Process::itemProgress, this, &ProgressAggregator::onItemProgress);
+    connect(process, &Process::itemSecondsRemaining, this, &ProgressAggregator::onItemSecondsRemaining);
+    connect(process, &Process::overallProgress, this, &ProgressAggregator::onOverallProgress);
+    connect(process, &Process::overallSecondsRemaining, this, &ProgressAggregator::onOverallSecondsRemaining);
+    connect(process, &Process::transferSpeed, this, &ProgressAggregator::onTransferSpeed);
+}
+
+/**
+ * @brief Set the maximum number of updates per second.
+ *
+ * @param rate The number of updates per second. Values outside the range
+ * accepted by GuiPreferences are clamped.
+ */
+void ProgressAggregator::setUpdateRate(int rate)
+{
+    m_updateRate = qBound(GuiPreferences::MinimumProgressUpdateRate, rate, GuiPreferences::MaximumProgressUpdateRate);
+    m_timer.setInterval(1000 / m_updateRate);
+}
+
+/**
+ * @brief Deliver the waiting update, if there is one.
+ *
+ * A signal is emitted for each part of the progress that has changed since the
+ * last update.
+ */
+void ProgressAggregator::flush()
+{
+    m_timer.stop();
+
+    // take a copy in case a receiver calls back into us
+    auto dirty = m_dirty;
+    m_dirty = 0;
+
+    if(dirty & Item) {
+        // the path is only built for the items that are shown
+        Q_EMIT itemChanged(m_paths && m_paths->contains(m_item) ? m_paths->path(m_item) : QString());
+    }
+
+    if(dirty & ItemProgress) {
+        Q_EMIT itemProgressChanged(m_itemProgress);
+    }
+
+    if(dirty & ItemSecondsRemaining) {
+        Q_EMIT itemSecondsRemainingChanged(m_itemSecondsRemaining);
+    }
+
+    if(dirty & OverallProgress) {
+        Q_EMIT overallProgressChanged(m_overallProgress);
+    }
+
+    if(dirty & OverallSecondsRemaining) {
+        Q_EMIT overallSecondsRemainingChanged(m_overallSecondsRemaining);
+    }
+
+    if(dirty & TransferSpeed) {
+        Q_EMIT transferSpeedChanged(m_transferSpeed);
+    }
+}
+
+/**
+ * @brief Discard the waiting update, if there is one.
+ *
+ * The counts are not affected.
+ */
+void ProgressAggregator::reset()
+{
+    m_timer.stop();
+    m_dirty = 0;
+}
+
+/**
+ * @brief Record that part of the progress has changed.
+ *
+ * @param flag The part that has changed.
+ */
+void ProgressAggregator::markDirty(DirtyFlag flag)
+{
+    ++m_received;
+    Instrumentation::add(Instrumentation::Counter::ProgressUpdates);
+
+    if(m_dirty & flag) {
+        ++m_dropped;
+        Instrumentation::add(Instrumentation::Counter::ProgressUpdatesDropped);
+    }
+
+    m_dirty |= flag;
+
+    if(!m_timer.isActive()) {
+        m_timer.start();
+    }
+}
+
+/**
+ * @brief Use a different store for the paths of the items.
+ *
+ * @param paths The store. It may be @b nullptr.
+ *
+ * The reference to the latest item's path in the previous store is released.
+ */
+void ProgressAggregator::setPathStore(std::shared_ptr<const PathStore> paths)
+{
+    if(m_paths) {
+        m_paths->release(m_item);
+    }
+
+    m_item = PathStore::NoPath;
+    m_paths = std::move(paths);
+}
+
+/**
+ * @brief Called when the process starts.
+ *
+ * The process has a new store for the paths of the run's items.
+ */
+void ProgressAggregator::onProcessStarted()
+{
+    setPathStore(m_process->pathStore());
+}
+
+/**
+ * @brief Record the start of a new item.
+ *
+ * @param item The Id of the path of the item in the process's PathStore.
+ */
+void ProgressAggregator::onNewItemStarted(PathStore::Id item)
+{
+    if(m_paths) {
+        m_paths->retain(item);
+        m_paths->release(m_item);
+    }
+
+    m_item = item;
+    markDirty(Item);
+}
+
+/**
+ * @brief Record the progress of the current item.
+ *
+ * @param pc The percent progress.
+ */
+void ProgressAggregator::onItemProgress(int pc)
+{
+    m_itemProgress = pc;
+    markDirty(ItemProgress);
+}
+
+/**
+ * @brief Record the time remaining for the current item.
+ *
+ * @param seconds The number of seconds.
+ */
+void ProgressAggregator::onItemSecondsRemaining(int seconds)
+{
+    m_itemSecondsRemaining = seconds;
+    markDirty(ItemSecondsRemaining);
+}
+
+/**
+ * @brief Record the overall progress.
+ *
+ * @param pc The percent progress.
+ */
+void ProgressAggregator::onOverallProgress(int pc)
+{
+    m_overallProgress = pc;
+    markDirty(OverallProgress);
+}
+
+/**
+ * @brief Record the time remaining for the whole process.
+ *
+ * @param seconds The number of seconds.
+ */
+void ProgressAggregator::onOverallSecondsRemaining(int seconds)
+{
+    m_overallSecondsRemaining = seconds;
+    markDirty(OverallSecondsRemaining);
+}
+
+/**
+ * @brief Record the transfer speed.
+ *
+ * @param speed The speed in bytes per second.
+ */
+void ProgressAggregator::onTransferSpeed(float speed)
+{
+    m_transferSpeed = speed;
+    markDirty(TransferSpeed);
+}
+
+/**
+ * @fn ProgressAggregator::updateRate()
+ * @brief Get the maximum number of updates per second.
+ *
+ * @return The rate.
+ */
+
+/**
+ * @fn ProgressAggregator::receivedUpdateCount()
+ * @brief Get the number of progress signals received from the process.
+ *
+ * @return The count.
+ */
+
+/**
+ * @fn ProgressAggregator::droppedUpdateCount()
+ * @brief Get the number of progress signals that were superseded before they
+ * were delivered.
+ *
+ * @return The count.
+ */
+
+/**
+ * @fn ProgressAggregator::itemChanged(QString)
+ * @brief Emitted when the item being processed has changed.
+ *
+ * @param item The path of the latest item.
+ */
+
+/**
+ * @fn ProgressAggregator::itemProgressChanged(int)
+ * @brief Emitted when the progress of the current item has changed.
+ *
+ * @param pc The latest percent progress.
+ */
+
+/**
+ * @fn ProgressAggregator::itemSecondsRemainingChanged(int)
+ * @brief Emitted when the time remaining for the current item has changed.
+ *
+ * @param seconds The latest number of seconds remaining.
+ */
+
+/**
+ * @fn ProgressAggregator::overallProgressChanged(int)
+ * @brief Emitted when the overall progress has changed.
+ *
+ * @param pc The latest percent progress.
+ */
+
+/**
+ * @fn ProgressAggregator::overallSecondsRemainingChanged(int)
+ * @brief Emitted when the time remaining for the whole process has changed.
+ *
+ * This is only emitted for processes that scan their source.
+ *
+ * @param seconds The latest number of seconds remaining.
+ */
+
+/**
+ * @fn ProgressAggregator::transferSpeedChanged(float)
+ * @brief Emitted when the transfer speed has changed.
+ *
+ * @param speed The latest speed in bytes per second.
+ */
@@ -0,0 +1,106 @@
+/**
+ * @file progressaggregator.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the ProgressAggregator class.
+ */
+
+#ifndef QYNC_PROGRESSAGGREGATOR_H
+#define QYNC_PROGRESSAGGREGATOR_H
+
+#include <memory>
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QTimer>
+#include <QtCore/QPointer>
+
+#include "pathstore.h"
+
+namespace Qync {
+
+	class Process;
+
+	class ProgressAggregator
+	: public QObject {
+		Q_OBJECT
+
+	public:
+		explicit ProgressAggregator(QObject * parent = nullptr);
+		~ProgressAggregator() override;
+
+		void setProcess(Process * process);
+
+		[[nodiscard]] inline int updateRate() const {
+			return m_updateRate;
+		}
+
+		void setUpdateRate(int rate);
+
+		[[nodiscard]] inline quint64 receivedUpdateCount() const {
+			return m_received;
+		}
+
+		[[nodiscard]] inline quint64 droppedUpdateCount() const {
+			return m_dropped;
+		}
+
+	Q_SIGNALS:
+		void itemChanged(QString);
+		void itemProgressChanged(int);
+		void itemSecondsRemainingChanged(int);
+		void overallProgressChanged(int);
+		void overallSecondsRemainingChanged(int);
+		void transferSpeedChanged(float);
+
+	public Q_SLOTS:
+		void flush();
+		void reset();
+
+	private Q_SLOTS:
+		void onProcessStarted();
+		void onNewItemStarted(PathStore::Id item);
+		void onItemProgress(int pc);
+		void onItemSecondsRemaining(int seconds);
+		void onOverallProgress(int pc);
+		void onOverallSecondsRemaining(int seconds);
+		void onTransferSpeed(float speed);
+
+	private:
+		enum DirtyFlag : unsigned char {
+			Item = 0x01,
+			ItemProgress = 0x02,
+			ItemSecondsRemaining = 0x04,
+			OverallProgress = 0x08,
+			TransferSpeed = 0x10,
+			OverallSecondsRemaining = 0x20,
+		};
+
+		void markDirty(DirtyFlag flag);
+		void setPathStore(std::shared_ptr<const PathStore> paths);
+
+		QPointer<Process> m_process;
+
+		/* held so that the process keeps the path of the latest item */
+		std::shared_ptr<const PathStore> m_paths;
+		QTimer m_timer;
+		int m_updateRate;
+
+		/* the latest state, and which parts of it have changed since the last flush */
+		PathStore::Id m_item;
+		int m_itemProgress;
+		int m_itemSecondsRemaining;
+		int m_overallProgress;
+		int m_overallSecondsRemaining;
+		float m_transferSpeed;
+		unsigned char m_dirty;
+
+		quint64 m_received;
+		quint64 m_dropped;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_PROGRESSAGGREGATOR_H
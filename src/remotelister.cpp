@@ -0,0 +1,625 @@
+/**
+ * @file remotelister.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the RemoteLister class.
+ */
+
+#include "remotelister.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QtCore/QDebug>
+#include <QtCore/QMetaObject>
+#include <QtCore/QProcess>
+#include <QtCore/QStringBuilder>
+#include <QtCore/QTimer>
+
+#include "functions.h"
+#include "preset.h"
+#include "remoteshell.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::RemoteLister class.
+ */
+namespace Qync::Detail::RemoteLister {
+    // each listing is a connection to a remote host, so only a few run at once
+    static constexpr const std::size_t MaximumConcurrentListings = 4;
+
+    // how many listings are kept, and for how many ms one is used before the
+    // host is asked again
+    static constexpr const std::size_t MaximumCachedListings = 64;
+    static constexpr const qint64 CacheLifetime = 60 * 1000;
+
+    // rsync gives up if the host goes quiet for this many seconds; a listing that
+    // takes longer than this many ms altogether is abandoned
+    static constexpr const int IoTimeout = 20;
+    static constexpr const int ListingTimeout = 30 * 1000;
+
+    // enough of rsync's error output to find the message in
+    static constexpr const int MaximumErrorOutput = 4096;
+
+    // what ssh exits with when it can't connect, including when BatchMode stops
+    // it asking for a password it needs
+    static constexpr const int SshFailedExitCode = 255;
+
+    // the width of the permissions in a --list-only line
+    static constexpr const int PermissionsWidth = 10;
+
+    // parse a line of rsync --list-only output, e.g.
+    //   drwxr-xr-x          4,096 2026/10/14 12:00:00 docs
+    // or, listing a daemon's modules,
+    //   backups        	Nightly backups
+    static bool parseEntry(const QByteArray & line, QString & name)
+    {
+        const auto text = QString::fromUtf8(line);
+        const auto firstSpace = text.indexOf(' ');
+
+        if(PermissionsWidth != firstSpace || !QStringLiteral("-dlcbps").contains(text.at(0))) {
+            name = text.section('\t', 0, 0).trimmed();
+
+            if(name.isEmpty()) {
+                return false;
+            }
+
+            name += '/';
+            return true;
+        }
+
+        // skip the permissions, size, date and time
+        int position = 0;
+
+        for(int field = 0; field < 4 && position < text.size(); ++field) {
+            while(position < text.size() && ' ' == text.at(position)) {
+                ++position;
+            }
+
+            while(position < text.size() && ' ' != text.at(position)) {
+                ++position;
+            }
+        }
+
+        name = text.mid(position + 1);
+
+        // the directory being listed lists itself as "."
+        if(name.isEmpty() || QStringLiteral(".") == name) {
+            return false;
+        }
+
+        if('l' == text.at(0)) {
+            if(const auto arrow = name.indexOf(QStringLiteral(" -> ")); 0 < arrow) {
+                name.truncate(arrow);
+            }
+        }
+        else if('d' == text.at(0)) {
+            name += '/';
+        }
+
+        return true;
+    }
+
+    // find the message that explains why a listing failed
+    static QString errorMessage(const QByteArray & errorOutput)
+    {
+        const auto lines = QString::fromUtf8(errorOutput).split('\n', QString::SkipEmptyParts);
+
+        for(const auto & line : lines) {
+            if(line.startsWith(QStringLiteral("rsync:")) || line.startsWith(QStringLiteral("@ERROR")) || line.startsWith(QStringLiteral("ssh:"))) {
+                return line.trimmed();
+            }
+        }
+
+        return (lines.isEmpty() ? QString() : lines.last().trimmed());
+    }
+}  // namespace Qync::Detail::RemoteLister
+
+/**
+ * @class RemoteLister
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Lists and checks remote sources and destinations with rsync.
+ *
+ * The lister runs @b rsync @b --list-only against remote endpoints - over
+ * the remote shell or to the rsync daemon a Preset's transport settings give
+ * (see RemoteShell) - so remote paths can be completed as they are typed (see
+ * PathCompleter) and the endpoints of a queued preset can be checked before
+ * it runs (see JobScheduler). With Preset::shareSshConnections() set the
+ * listings use the shared connections, so after the first they take as long
+ * as a round trip to the host.
+ *
+ * list() lists the entries in a directory, delivering them with
+ * entriesListed() as rsync reports them, with a trailing '/' on directories;
+ * check() lists just the endpoint itself, to find out whether it exists and
+ * can be reached. Both finish with listingFinished(), which gives rsync's exit
+ * code (or NotRun) and its error message.
+ *
+ * Requests for the same listing share a single run of rsync, and at most a
+ * few run at once; the rest wait their turn. Successful listings are cached
+ * for a minute and requests for them are served from the cache. Results are
+ * always delivered from the event loop, never from inside list() or check().
+ * rsync is run non-interactively: ssh is never allowed to ask for a password,
+ * and a listing that takes too long is abandoned. Since ssh can't tell a host
+ * it can't reach from one that needs a password it may not ask for, a listing
+ * that ssh fails to connect for finishes with NotRun.
+ */
+
+/**
+ * @brief Create a new lister.
+ *
+ * @param rsyncPath The rsync command, as found in Preferences::rsyncPath().
+ * @param parent The parent object.
+ */
+RemoteLister::RemoteLister(QString rsyncPath, QObject * parent)
+:   QObject(parent),
+    m_rsyncPath(std::move(rsyncPath)),
+    m_lastRequest(NoRequest),
+    m_listings(),
+    m_cache()
+{
+}
+
+/**
+ * @brief Destroy the lister.
+ *
+ * Listings in progress are abandoned.
+ */
+RemoteLister::~RemoteLister()
+{
+    for(auto & listing : m_listings) {
+        if(listing->process) {
+            listing->process->disconnect(this);
+        }
+    }
+}
+
+/**
+ * @brief Set the rsync command.
+ *
+ * @param path The rsync command.
+ *
+ * Listings already in progress are not affected. The cache is cleared if the
+ * command changes, since another rsync could list things differently.
+ */
+void RemoteLister::setRsyncPath(QString path)
+{
+    if(path != m_rsyncPath) {
+        m_rsyncPath = std::move(path);
+        clearCache();
+    }
+}
+
+/**
+ * @brief Check whether a source or destination is remote.
+ *
+ * @param endpoint The source or destination.
+ *
+ * @return @b true for remote shell and rsync daemon endpoints, @b false for
+ * local paths and empty endpoints.
+ */
+bool RemoteLister::isRemote(const QString & endpoint)
+{
+    return !endpoint.isEmpty() && !isLocalPath(endpoint);
+}
+
+/**
+ * @brief Work out the directory containing a remote endpoint.
+ *
+ * @param endpoint The remote endpoint.
+ *
+ * rsync creates the destination directory if it doesn't exist, but not the
+ * directory it goes in, so this is what a destination is checked by. The
+ * parent of a top-level entry on a remote shell host is the user's home
+ * directory (@b host:); a daemon's module has no parent, so it is its own.
+ *
+ * @return The parent.
+ */
+QString RemoteLister::parentOf(const QString & endpoint)
+{
+    // everything up to here is the host, or the host and the module
+    int root;
+
+    if(endpoint.startsWith(QStringLiteral("rsync://"))) {
+        root = endpoint.indexOf('/', 8);
+        root = (0 > root ? -1 : endpoint.indexOf('/', root + 1));
+    }
+    else if(const auto colon = endpoint.indexOf(QStringLiteral("::")); 0 < colon) {
+        root = endpoint.indexOf('/', colon + 2);
+    }
+    else {
+        root = endpoint.indexOf(':');
+    }
+
+    if(0 > root) {
+        return endpoint;
+    }
+
+    auto path = endpoint;
+
+    while(path.endsWith('/') && path.size() > root + 2) {
+        path.chop(1);
+    }
+
+    const auto slash = path.lastIndexOf('/');
+
+    if(slash <= root + 1) {
+        // host:/entry is in the root directory, host:entry is in the home directory
+        return path.left(std::max(slash, root) + 1);
+    }
+
+    return path.left(slash);
+}
+
+/**
+ * @brief List the entries in a remote directory.
+ *
+ * @param transport The preset whose transport settings are used to reach the
+ * host.
+ * @param directory The directory, e.g. @b host:path/to/dir/. A trailing '/'
+ * is added if it doesn't have one.
+ *
+ * @return The Id of the request, which the signals for its listing carry.
+ */
+RemoteLister::RequestId RemoteLister::list(const Preset & transport, const QString & directory)
+{
+    if(directory.endsWith('/') || directory.endsWith(':')) {
+        return request(transport, directory);
+    }
+
+    return request(transport, directory % '/');
+}
+
+/**
+ * @brief Check that a remote source or destination exists and can be reached.
+ *
+ * @param transport The preset whose transport settings are used to reach the
+ * host.
+ * @param endpoint The endpoint. Only the endpoint itself is listed, not the
+ * entries in it.
+ *
+ * The endpoint exists if the listing finishes with an exit code of 0. rsync
+ * reports a missing entry with an exit code of 23 (see
+ * Process::ExitCode::PartialTransferError); the other codes mean the host
+ * could not be reached or refused the request.
+ *
+ * @return The Id of the request, which the signals for its listing carry.
+ */
+RemoteLister::RequestId RemoteLister::check(const Preset & transport, const QString & endpoint)
+{
+    auto entry = endpoint;
+
+    // host:/ has to stay as it is, since host: is the home directory
+    while(entry.endsWith('/') && !entry.endsWith(QStringLiteral(":/")) && !entry.endsWith(QStringLiteral("://"))) {
+        entry.chop(1);
+    }
+
+    return request(transport, entry);
+}
+
+/**
+ * @brief Abandon a request.
+ *
+ * @param request The Id of the request.
+ *
+ * No more entries are delivered for the request and listingFinished() is not
+ * emitted for it, unless it was served from the cache. The listing itself is
+ * stopped if no other request is waiting for it.
+ */
+void RemoteLister::cancel(RequestId request)
+{
+    const auto it = std::find_if(m_listings.begin(), m_listings.end(), [request](const std::unique_ptr<Listing> & listing) {
+        return listing->requests.cend() != std::find(listing->requests.cbegin(), listing->requests.cend(), request);
+    });
+
+    if(m_listings.end() == it) {
+        return;
+    }
+
+    auto & requests = (*it)->requests;
+    requests.erase(std::find(requests.begin(), requests.end(), request));
+
+    if(!requests.empty()) {
+        return;
+    }
+
+    if((*it)->process) {
+        (*it)->process->disconnect(this);
+        (*it)->process.release()->deleteLater();
+    }
+
+    m_listings.erase(it);
+    startListings();
+}
+
+/**
+ * @brief Forget all the cached listings.
+ */
+void RemoteLister::clearCache()
+{
+    m_cache.clear();
+}
+
+/**
+ * @brief Ask for a listing.
+ *
+ * @param transport The preset whose transport settings are used to reach the
+ * host.
+ * @param endpoint What rsync is to list.
+ *
+ * @return The Id of the request.
+ */
+RemoteLister::RequestId RemoteLister::request(const Preset & transport, const QString & endpoint)
+{
+    using namespace Detail::RemoteLister;
+    const auto target = RemoteShell::endpointFor(transport, endpoint);
+    QStringList arguments{QStringLiteral("--list-only"), QStringLiteral("--timeout=") % QString::number(IoTimeout)};
+    bool batchMode = false;
+
+    if(RemoteShell::isShellEndpoint(target)) {
+        auto shell = RemoteShell::commandFor(transport);
+
+        if(shell.isEmpty()) {
+            shell = QStringLiteral("ssh");
+        }
+
+        // no password prompts, in a terminal or out of one
+        if(RemoteShell::isOpenSsh(shell)) {
+            shell += QStringLiteral(" -o BatchMode=yes");
+            batchMode = true;
+        }
+
+        arguments.push_back(QStringLiteral("--rsh=") % shell);
+    }
+    else {
+        arguments.push_back(QStringLiteral("--no-motd"));
+
+        if(transport.useRsyncDaemon() && 0 < transport.rsyncDaemonPort()) {
+            arguments.push_back(QStringLiteral("--port=") % QString::number(transport.rsyncDaemonPort()));
+        }
+    }
+
+    arguments.push_back(target);
+    const auto key = m_rsyncPath % '\n' % arguments.join('\n');
+    const auto id = ++m_lastRequest;
+
+    const auto cached = std::find_if(m_cache.begin(), m_cache.end(), [&key](const CachedListing & listing) {
+        return listing.key == key;
+    });
+
+    if(m_cache.end() != cached) {
+        if(cached->age.hasExpired(CacheLifetime)) {
+            m_cache.erase(cached);
+        }
+        else {
+            std::rotate(m_cache.begin(), cached, cached + 1);
+
+            QMetaObject::invokeMethod(this, [this, id, entries = m_cache.front().entries]() {
+                if(!entries.isEmpty()) {
+                    Q_EMIT entriesListed(id, entries);
+                }
+
+                Q_EMIT listingFinished(id, 0, {});
+            }, Qt::QueuedConnection);
+
+            return id;
+        }
+    }
+
+    const auto inProgress = std::find_if(m_listings.begin(), m_listings.end(), [&key](const std::unique_ptr<Listing> & listing) {
+        return listing->key == key;
+    });
+
+    if(m_listings.end() != inProgress) {
+        (*inProgress)->requests.push_back(id);
+
+        // the rest are delivered to this request as they arrive
+        if(!(*inProgress)->entries.isEmpty()) {
+            QMetaObject::invokeMethod(this, [this, id, entries = (*inProgress)->entries]() {
+                Q_EMIT entriesListed(id, entries);
+            }, Qt::QueuedConnection);
+        }
+
+        return id;
+    }
+
+    auto listing = std::make_unique<Listing>();
+    listing->key = key;
+    listing->arguments = std::move(arguments);
+    listing->requests.push_back(id);
+    listing->batchMode = batchMode;
+    m_listings.push_back(std::move(listing));
+    startListings();
+    return id;
+}
+
+/**
+ * @brief Start as many waiting listings as the limit allows.
+ */
+void RemoteLister::startListings()
+{
+    auto running = static_cast<std::size_t>(std::count_if(m_listings.cbegin(), m_listings.cend(), [](const std::unique_ptr<Listing> & listing) {
+        return static_cast<bool>(listing->process);
+    }));
+
+    for(auto & listing : m_listings) {
+        if(Detail::RemoteLister::MaximumConcurrentListings <= running) {
+            break;
+        }
+
+        if(!listing->process) {
+            start(*listing);
+            ++running;
+        }
+    }
+}
+
+/**
+ * @brief Run rsync for a listing.
+ *
+ * @param listing The listing.
+ */
+void RemoteLister::start(Listing & listing)
+{
+    auto * listingPtr = &listing;
+    listing.process = std::make_unique<QProcess>();
+    auto * process = listing.process.get();
+
+    // nothing for rsync or ssh to read a password from
+    process->setStandardInputFile(QProcess::nullDevice());
+
+    connect(process, &QProcess::readyReadStandardOutput, this, [this, listingPtr]() {
+        readEntries(*listingPtr);
+    });
+
+    connect(process, &QProcess::readyReadStandardError, this, [listingPtr]() {
+        listingPtr->errorOutput.append(listingPtr->process->readAllStandardError());
+        listingPtr->errorOutput = listingPtr->errorOutput.right(Detail::RemoteLister::MaximumErrorOutput);
+    });
+
+    connect(process, qOverload<int, QProcess::ExitStatus>(&QProcess::finished), this, [this, listingPtr](int exitCode, QProcess::ExitStatus status) {
+        if(QProcess::NormalExit == status && listingPtr->batchMode && Detail::RemoteLister::SshFailedExitCode == exitCode) {
+            // the host may well be reachable by a run that can ask for a password
+            finish(listingPtr, NotRun, {});
+        }
+        else if(QProcess::NormalExit == status) {
+            finish(listingPtr, exitCode, {});
+        }
+        else {
+            finish(listingPtr, NotRun, tr("The listing was stopped because the host took too long to respond."));
+        }
+    });
+
+    connect(process, &QProcess::errorOccurred, this, [this, listingPtr](QProcess::ProcessError error) {
+        // finished() is not emitted for a process that never started
+        if(QProcess::FailedToStart == error) {
+            finish(listingPtr, NotRun, tr("rsync could not be started."));
+        }
+    });
+
+    QTimer::singleShot(Detail::RemoteLister::ListingTimeout, process, [process]() {
+        process->kill();
+    });
+
+    process->start(m_rsyncPath, listing.arguments);
+}
+
+/**
+ * @brief Read the entries rsync has listed so far.
+ *
+ * @param listing The listing.
+ */
+void RemoteLister::readEntries(Listing & listing)
+{
+    listing.partialLine.append(listing.process->readAllStandardOutput());
+    QStringList entries;
+    int begin = 0;
+
+    for(auto end = listing.partialLine.indexOf('\n'); 0 <= end; end = listing.partialLine.indexOf('\n', begin)) {
+        QString name;
+
+        if(Detail::RemoteLister::parseEntry(listing.partialLine.mid(begin, end - begin), name)) {
+            entries.push_back(std::move(name));
+        }
+
+        begin = end + 1;
+    }
+
+    listing.partialLine.remove(0, begin);
+
+    if(entries.isEmpty()) {
+        return;
+    }
+
+    listing.entries.append(entries);
+
+    // a receiver could cancel its request, so the list can change as it's walked
+    const auto requests = listing.requests;
+
+    for(const auto request : requests) {
+        Q_EMIT entriesListed(request, entries);
+    }
+}
+
+/**
+ * @brief Finish a listing, caching it if it succeeded.
+ *
+ * @param listing The listing.
+ * @param exitCode rsync's exit code, or NotRun.
+ * @param error Why the listing failed, if rsync didn't say.
+ */
+void RemoteLister::finish(Listing * listing, int exitCode, const QString & error)
+{
+    using namespace Detail::RemoteLister;
+
+    const auto it = std::find_if(m_listings.begin(), m_listings.end(), [listing](const std::unique_ptr<Listing> & candidate) {
+        return candidate.get() == listing;
+    });
+
+    if(m_listings.end() == it) {
+        return;
+    }
+
+    auto finished = std::move(*it);
+    m_listings.erase(it);
+
+    // not deleted here, since this is called from one of its signals
+    finished->process->disconnect(this);
+    finished->process.release()->deleteLater();
+
+    auto message = error;
+
+    if(0 == exitCode) {
+        m_cache.erase(std::remove_if(m_cache.begin(), m_cache.end(), [&finished](const CachedListing & cached) {
+            return cached.key == finished->key;
+        }), m_cache.end());
+
+        m_cache.insert(m_cache.begin(), {finished->key, finished->entries, {}});
+        m_cache.front().age.start();
+
+        if(MaximumCachedListings < m_cache.size()) {
+            m_cache.pop_back();
+        }
+    }
+    else if(message.isEmpty()) {
+        message = errorMessage(finished->errorOutput);
+        qWarning() << __PRETTY_FUNCTION__ << "listing" << finished->arguments.last() << "failed with exit code" << exitCode << message;
+    }
+
+    for(const auto request : finished->requests) {
+        Q_EMIT listingFinished(request, exitCode, message);
+    }
+
+    startListings();
+}
+
+/**
+ * @fn RemoteLister::rsyncPath()
+ * @brief Fetch the rsync command.
+ *
+ * @return The command.
+ */
+
+/**
+ * @fn RemoteLister::entriesListed(RequestId, const QStringList &)
+ * @brief Emitted with the next batch of entries in a listing.
+ *
+ * @param request The Id of the request the entries are for.
+ * @param entries The names of the entries. Directories have a trailing '/'.
+ */
+
+/**
+ * @fn RemoteLister::listingFinished(RequestId, int, const QString &)
+ * @brief Emitted when a listing has finished.
+ *
+ * @param request The Id of the request.
+ * @param exitCode rsync's exit code: 0 if the listing succeeded, NotRun if
+ * rsync could not be run, took too long or ssh could not connect without a
+ * password.
+ * @param error Why the listing failed, or an empty string if it succeeded.
+ */
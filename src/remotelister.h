@@ -0,0 +1,104 @@
+/**
+ * @file remotelister.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the RemoteLister class.
+ */
+
+#ifndef QYNC_REMOTELISTER_H
+#define QYNC_REMOTELISTER_H
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+class QProcess;
+
+namespace Qync {
+
+	class Preset;
+
+	class RemoteLister
+	: public QObject {
+		Q_OBJECT
+
+	public:
+		using RequestId = quint64;
+		static constexpr const RequestId NoRequest = 0;
+
+		// the exit code reported for a listing rsync couldn't run or didn't finish in time,
+		// or that ssh couldn't connect for without asking for a password
+		static constexpr const int NotRun = -1;
+
+		explicit RemoteLister(QString rsyncPath = {}, QObject * parent = nullptr);
+		RemoteLister(const RemoteLister &) = delete;
+		RemoteLister(RemoteLister &&) = delete;
+		void operator=(const RemoteLister &) = delete;
+		void operator=(RemoteLister &&) = delete;
+		~RemoteLister() override;
+
+		[[nodiscard]] inline const QString & rsyncPath() const {
+			return m_rsyncPath;
+		}
+
+		void setRsyncPath(QString path);
+
+		[[nodiscard]] static bool isRemote(const QString & endpoint);
+		[[nodiscard]] static QString parentOf(const QString & endpoint);
+
+		RequestId list(const Preset & transport, const QString & directory);
+		RequestId check(const Preset & transport, const QString & endpoint);
+		void cancel(RequestId request);
+		void clearCache();
+
+	Q_SIGNALS:
+		void entriesListed(Qync::RemoteLister::RequestId request, const QStringList & entries);
+		void listingFinished(Qync::RemoteLister::RequestId request, int exitCode, const QString & error);
+
+	private:
+		// a run of rsync --list-only, possibly serving several requests
+		struct Listing {
+			QString key;
+			QStringList arguments;
+			std::vector<RequestId> requests;
+			std::unique_ptr<QProcess> process;
+			QByteArray partialLine;
+			QStringList entries;
+			QByteArray errorOutput;
+
+			// ssh may not ask for a password, so it failing says nothing about the host
+			bool batchMode = false;
+		};
+
+		struct CachedListing {
+			QString key;
+			QStringList entries;
+			QElapsedTimer age;
+		};
+
+		RequestId request(const Preset & transport, const QString & endpoint);
+		void startListings();
+		void start(Listing & listing);
+		void readEntries(Listing & listing);
+		void finish(Listing * listing, int exitCode, const QString & error);
+
+		QString m_rsyncPath;
+		RequestId m_lastRequest;
+
+		// running and waiting listings, in the order they were asked for
+		std::vector<std::unique_ptr<Listing>> m_listings;
+
+		// the most recently used first
+		std::vector<CachedListing> m_cache;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_REMOTELISTER_H
@@ -0,0 +1,322 @@
+/**
+ * @file remoteshell.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the RemoteShell class.
+ */
+
+#include "remoteshell.h"
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QProcess>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QStringBuilder>
+
+#include "functions.h"
+#include "preset.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::RemoteShell class.
+ */
+namespace Qync::Detail::RemoteShell {
+    static constexpr const char * DefaultCommand = "ssh";
+
+    // ssh replaces %C with a hash of the connection's details, so each host, port
+    // and user has its own socket and the name is always the same length
+    static constexpr const char * ControlSocketName = "%C";
+    static constexpr const int ControlSocketNameLength = 40;
+
+    // the longest socket path every platform accepts (sun_path is 104 bytes on macOS and the BSDs)
+    static constexpr const int MaximumSocketPathLength = 100;
+
+    // how long to wait for the shared connections to be told to stop, in ms
+    static constexpr const int StopTimeout = 2000;
+
+    static QString controlDirectoryPath()
+    {
+        auto base = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+
+        if(base.isEmpty()) {
+            base = QDir::tempPath();
+        }
+
+        return base % QStringLiteral("/qync-ssh");
+    }
+
+    // rsync splits the remote shell command at spaces, but keeps quoted arguments whole
+    static QString quoted(const QString & arg)
+    {
+        if(!arg.contains(' ')) {
+            return arg;
+        }
+
+        if(!arg.contains('\'')) {
+            return '\'' % arg % '\'';
+        }
+
+        if(!arg.contains('"')) {
+            return '"' % arg % '"';
+        }
+
+        return {};
+    }
+}  // namespace Qync::Detail::RemoteShell
+
+/**
+ * @class RemoteShell
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Works out how rsync connects to remote sources and destinations.
+ *
+ * rsync reaches a @b [user@]host:path source or destination by running a
+ * remote shell - ssh, unless it's told otherwise with @b --rsh - and
+ * reaches an rsync daemon (@b host::module or @b rsync://host/module) over a
+ * plain socket. A Preset's transport settings choose between them and tune
+ * the shell: Process gives rsync the command from commandFor() and the
+ * endpoints from endpointFor().
+ *
+ * Each run of rsync over ssh normally makes a new connection, and the
+ * handshake and authentication can take longer than the synchronisation
+ * itself when a preset is run every few seconds by a PresetWatcher or the
+ * JobScheduler. With Preset::shareSshConnections() set, ssh is told to keep a
+ * master connection open for Preset::sshConnectionLifetime() seconds after it
+ * was last used (ssh's ControlMaster and ControlPersist), with its socket in
+ * controlDirectory(). Later runs to the same host, port and user go through
+ * the master, which takes milliseconds. Qync owns the sockets in that
+ * directory: stopSharedConnections() tells the masters to close once their
+ * current sessions have finished, which the application does when it quits.
+ * ssh removes stale sockets itself when it finds them.
+ *
+ * Sharing connections and choosing a cipher are only possible with OpenSSH
+ * (see isOpenSsh()). A custom remote shell that is something else is used as
+ * it is.
+ */
+
+/**
+ * @brief Check whether rsync reaches a source or destination with a remote
+ * shell.
+ *
+ * @param endpoint The source or destination.
+ *
+ * @return @b true for @b [user@]host:path, @b false for local paths and rsync
+ * daemons.
+ */
+bool RemoteShell::isShellEndpoint(const QString & endpoint)
+{
+    if(endpoint.isEmpty() || isLocalPath(endpoint) || endpoint.startsWith(QStringLiteral("rsync://"))) {
+        return false;
+    }
+
+    // host::module is a daemon
+    const auto colon = endpoint.indexOf(':');
+    return 0 < colon && (colon + 1 == endpoint.size() || ':' != endpoint.at(colon + 1));
+}
+
+/**
+ * @brief Convert a remote shell source or destination to the equivalent rsync
+ * daemon URL.
+ *
+ * @param endpoint The source or destination.
+ *
+ * @b [user@]host:module/path becomes @b rsync://[user@]host/module/path. The
+ * daemon port is given separately (see Preset::rsyncDaemonPort()).
+ *
+ * @return The URL, or @p endpoint unchanged if it is not a remote shell
+ * endpoint.
+ */
+QString RemoteShell::daemonEndpoint(const QString & endpoint)
+{
+    if(!isShellEndpoint(endpoint)) {
+        return endpoint;
+    }
+
+    const auto colon = endpoint.indexOf(':');
+    auto path = endpoint.mid(colon + 1);
+
+    // paths on a daemon are relative to its modules
+    while(path.startsWith('/')) {
+        path.remove(0, 1);
+    }
+
+    return QStringLiteral("rsync://") % endpoint.leftRef(colon) % '/' % path;
+}
+
+/**
+ * @brief Work out the source or destination to give rsync for a preset.
+ *
+ * @param preset The preset.
+ * @param endpoint The preset's source or destination.
+ *
+ * @return The daemon URL for a remote shell endpoint if the preset uses an
+ * rsync daemon, @p endpoint otherwise.
+ */
+QString RemoteShell::endpointFor(const Preset & preset, const QString & endpoint)
+{
+    return (preset.useRsyncDaemon() ? daemonEndpoint(endpoint) : endpoint);
+}
+
+/**
+ * @brief Work out the remote shell command rsync should use for a preset.
+ *
+ * @param preset The preset.
+ *
+ * The command is the preset's remote shell, or ssh, with the cipher and the
+ * options to share connections added if it is OpenSSH. The options are added
+ * after the preset's own. ssh keeps the first value it is given for an @b -o
+ * option, so any connection sharing options the user has given ssh take
+ * precedence, but it keeps the last @b -c, so the preset's cipher replaces one
+ * given in the remote shell.
+ *
+ * @return The command for @b --rsh, or an empty string if rsync's default is
+ * what the preset needs.
+ */
+QString RemoteShell::commandFor(const Preset & preset)
+{
+    using namespace Detail::RemoteShell;
+    const auto custom = preset.remoteShell().trimmed();
+
+    if(custom.isEmpty() && preset.sshCipher().isEmpty() && !preset.shareSshConnections()) {
+        return {};
+    }
+
+    QString command = (custom.isEmpty() ? QString::fromLatin1(DefaultCommand) : custom);
+
+    if(!isOpenSsh(command)) {
+        if(!preset.sshCipher().isEmpty() || preset.shareSshConnections()) {
+            qWarning() << __PRETTY_FUNCTION__ << "the remote shell" << command << "is not ssh; not setting the cipher or sharing connections";
+        }
+
+        return command;
+    }
+
+    if(!preset.sshCipher().isEmpty()) {
+        command += QStringLiteral(" -c ") % preset.sshCipher();
+    }
+
+    if(preset.shareSshConnections()) {
+        const auto directory = controlDirectory();
+        const auto controlPath = quoted(QStringLiteral("ControlPath=") % directory % '/' % QString::fromLatin1(ControlSocketName));
+
+        if(directory.isEmpty() || controlPath.isEmpty()) {
+            qWarning() << __PRETTY_FUNCTION__ << "no usable directory for shared connection sockets; not sharing connections";
+        }
+        else {
+            const auto lifetime = (0 < preset.sshConnectionLifetime() ? preset.sshConnectionLifetime() : DefaultConnectionLifetime);
+            command += QStringLiteral(" -o ControlMaster=auto -o ") % controlPath % QStringLiteral(" -o ControlPersist=") % QString::number(lifetime);
+        }
+    }
+
+    return command;
+}
+
+/**
+ * @brief Check whether a remote shell command runs OpenSSH.
+ *
+ * @param command The command.
+ *
+ * @return @b true if the program the command runs is called ssh, @b false
+ * otherwise.
+ */
+bool RemoteShell::isOpenSsh(const QString & command)
+{
+    auto program = command.trimmed();
+
+    if(program.startsWith('\'') || program.startsWith('"')) {
+        const auto end = program.indexOf(program.at(0), 1);
+        program = program.mid(1, (0 > end ? -1 : end - 1));
+    }
+    else {
+        program = program.section(' ', 0, 0);
+    }
+
+    return 0 == QFileInfo(program).completeBaseName().compare(QStringLiteral("ssh"), Qt::CaseInsensitive);
+}
+
+/**
+ * @brief Fetch the directory for shared connection sockets, creating it if
+ * necessary.
+ *
+ * The directory is in the user's runtime directory, and only the user can
+ * use it, since anyone who can reach a socket can use the connection.
+ *
+ * @return The directory, or an empty string if it can't be used on this
+ * platform, can't be created or is too deep for socket paths.
+ */
+QString RemoteShell::controlDirectory()
+{
+#if defined(Q_OS_WIN)
+    // Windows' OpenSSH has no ControlMaster
+    return {};
+#else
+    using namespace Detail::RemoteShell;
+    const auto directory = controlDirectoryPath();
+
+    if(MaximumSocketPathLength < directory.toLocal8Bit().size() + 1 + ControlSocketNameLength) {
+        qWarning() << __PRETTY_FUNCTION__ << directory << "is too long for socket paths";
+        return {};
+    }
+
+    if(!QDir().mkpath(directory)) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to create" << directory;
+        return {};
+    }
+
+    if(!QFile::setPermissions(directory, QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ExeOwner)) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to make" << directory << "private";
+        return {};
+    }
+
+    return directory;
+#endif
+}
+
+/**
+ * @brief Tell all the shared connections to close.
+ *
+ * Each master connection with a socket in the control directory is asked to
+ * stop (ssh -O stop): it accepts no more sessions, and closes once the
+ * sessions it has - e.g. an rsync another instance of Qync is running - have
+ * finished. This waits briefly for the requests to be delivered.
+ */
+void RemoteShell::stopSharedConnections()
+{
+#if !defined(Q_OS_WIN)
+    using namespace Detail::RemoteShell;
+    const QDir directory(controlDirectoryPath());
+
+    if(!directory.exists()) {
+        return;
+    }
+
+    std::vector<std::unique_ptr<QProcess>> requests;
+
+    for(const auto & socket : directory.entryInfoList(QDir::System | QDir::Files | QDir::NoDotAndDotDot | QDir::Hidden)) {
+        auto request = std::make_unique<QProcess>();
+        request->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+
+        // with an explicit socket ssh doesn't need the real host
+        request->start(QString::fromLatin1(DefaultCommand), {QStringLiteral("-o"), QStringLiteral("ControlPath=") % socket.absoluteFilePath(), QStringLiteral("-O"), QStringLiteral("stop"), QStringLiteral("qync")});
+        requests.push_back(std::move(request));
+    }
+
+    for(auto & request : requests) {
+        if(!request->waitForFinished(StopTimeout)) {
+            qWarning() << __PRETTY_FUNCTION__ << "timed out asking the shared connection" << request->arguments().at(1) << "to stop";
+            request->kill();
+            request->waitForFinished(StopTimeout);
+        }
+    }
+#endif
+}
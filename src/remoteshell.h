@@ -0,0 +1,37 @@
+/**
+ * @file remoteshell.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the RemoteShell class.
+ */
+
+#ifndef QYNC_REMOTESHELL_H
+#define QYNC_REMOTESHELL_H
+
+#include <QtCore/QString>
+
+namespace Qync {
+
+	class Preset;
+
+	class RemoteShell {
+	public:
+		RemoteShell() = delete;
+
+		[[nodiscard]] static bool isShellEndpoint(const QString & endpoint);
+		[[nodiscard]] static QString daemonEndpoint(const QString & endpoint);
+		[[nodiscard]] static QString endpointFor(const Preset & preset, const QString & endpoint);
+		[[nodiscard]] static QString commandFor(const Preset & preset);
+		[[nodiscard]] static bool isOpenSsh(const QString & command);
+		[[nodiscard]] static QString controlDirectory();
+		static void stopSharedConnections();
+
+		// how long, in seconds, an idle shared connection stays open if the preset doesn't say
+		static constexpr const int DefaultConnectionLifetime = 10 * 60;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_REMOTESHELL_H
@@ -0,0 +1,237 @@
+/**
+ * @file rsynccapabilities.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the RsyncCapabilities class.
+ */
+
+#include "rsynccapabilities.h"
+
+#include <cstddef>
+
+#include <QtCore/QRegularExpression>
+#include <QtCore/QVector>
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::RsyncCapabilities class.
+ */
+namespace Qync::Detail::RsyncCapabilities {
+    // fastest first. anything rsync lists that isn't here is never picked as the fastest
+    static constexpr const char * const ChecksumPreference[] = {"xxh128", "xxh3", "xxh64", "md5", "md4"};
+    static constexpr const char * const CompressionPreference[] = {"lz4", "zstd", "zlibx", "zlib"};
+
+    static constexpr const char * const ChecksumListHeading = "Checksum list:";
+    static constexpr const char * const CompressionListHeading = "Compress list:";
+
+    // the first release with --info
+    static const QVersionNumber InfoVersion(3, 1, 0);
+
+    // the words in the indented lines that follow a heading, without the (library) notes
+    static QStringList readList(const QVector<QStringRef> & lines, const char * heading)
+    {
+        QStringList list;
+        int index = 0;
+
+        while(index < lines.size() && lines[index].trimmed() != QLatin1String(heading)) {
+            ++index;
+        }
+
+        for(++index; index < lines.size() && lines[index].startsWith(' '); ++index) {
+            for(const auto & word : lines[index].split(' ', QString::SkipEmptyParts)) {
+                if(!word.startsWith('(')) {
+                    list.push_back(word.toString());
+                }
+            }
+        }
+
+        return list;
+    }
+
+    template<std::size_t N>
+    static QString firstOf(const QStringList & available, const char * const (& preference)[N])
+    {
+        for(const auto * algorithm : preference) {
+            if(available.contains(QLatin1String(algorithm))) {
+                return QString::fromLatin1(algorithm);
+            }
+        }
+
+        return {};
+    }
+}  // namespace Qync::Detail::RsyncCapabilities
+
+/**
+ * @class RsyncCapabilities
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief What an rsync binary is able to do.
+ *
+ * Everything is worked out from the output of <tt>rsync --version</tt> by
+ * fromVersionText(): the release, the protocol version, whether the @b --info
+ * option is available and the checksum and compression algorithms rsync lists.
+ * Releases before 3.2.0 don't list their algorithms, so for them the lists are
+ * empty, and nothing should assume that @b --checksum-choice or
+ * @b --compress-choice can be used.
+ *
+ * Running rsync to get the text is left to RsyncProbe, which also keeps the
+ * text on disk so that it is only fetched again when the binary changes. A
+ * default-constructed object describes an rsync that couldn't be run: it is not
+ * valid and supports nothing.
+ */
+
+/**
+ * @brief Work out the capabilities of an rsync from its version text.
+ *
+ * @param versionText The output of <tt>rsync --version</tt>.
+ *
+ * @return The capabilities. If the version can't be found in the text the
+ * object is not valid.
+ */
+RsyncCapabilities RsyncCapabilities::fromVersionText(const QString & versionText)
+{
+    static const QRegularExpression versionLine(QStringLiteral(R"(^rsync\s+version\s+v?(\S+)(?:\s+protocol\s+version\s+(\d+))?)"), QRegularExpression::MultilineOption);
+
+    RsyncCapabilities capabilities;
+    capabilities.m_versionText = versionText;
+    const auto match = versionLine.match(versionText);
+
+    if(!match.hasMatch()) {
+        return capabilities;
+    }
+
+    capabilities.m_version = QVersionNumber::fromString(match.captured(1));
+
+    if(capabilities.m_version.isNull()) {
+        return capabilities;
+    }
+
+    capabilities.m_protocolVersion = match.captured(2).toInt();
+    capabilities.m_supportsInfo = capabilities.m_version >= Detail::RsyncCapabilities::InfoVersion;
+
+    const auto lines = versionText.splitRef('\n');
+    capabilities.m_checksumAlgorithms = Detail::RsyncCapabilities::readList(lines, Detail::RsyncCapabilities::ChecksumListHeading);
+    capabilities.m_compressionAlgorithms = Detail::RsyncCapabilities::readList(lines, Detail::RsyncCapabilities::CompressionListHeading);
+    return capabilities;
+}
+
+/**
+ * @brief Find the fastest checksum algorithm rsync supports.
+ *
+ * @return The name to give to @b --checksum-choice, or an empty string if
+ * rsync doesn't list its algorithms.
+ */
+QString RsyncCapabilities::fastestChecksumAlgorithm() const
+{
+    return Detail::RsyncCapabilities::firstOf(m_checksumAlgorithms, Detail::RsyncCapabilities::ChecksumPreference);
+}
+
+/**
+ * @brief Find the fastest compression algorithm rsync supports.
+ *
+ * lz4 compresses less than zstd but costs far less CPU, which is the better
+ * trade for the fast links rsync is usually run over.
+ *
+ * @return The name to give to @b --compress-choice, or an empty string if
+ * rsync doesn't list its algorithms.
+ */
+QString RsyncCapabilities::fastestCompressionAlgorithm() const
+{
+    return Detail::RsyncCapabilities::firstOf(m_compressionAlgorithms, Detail::RsyncCapabilities::CompressionPreference);
+}
+
+/**
+ * @fn RsyncCapabilities::isValid()
+ * @brief Check whether the version of rsync is known.
+ *
+ * @return @b true if it is, @b false if rsync couldn't be run or its version
+ * text wasn't understood.
+ */
+
+/**
+ * @fn RsyncCapabilities::versionText()
+ * @brief Fetch the output of <tt>rsync --version</tt>.
+ *
+ * @return The text.
+ */
+
+/**
+ * @fn RsyncCapabilities::version()
+ * @brief Fetch the rsync release.
+ *
+ * @return The release, or a null version if it isn't known.
+ */
+
+/**
+ * @fn RsyncCapabilities::protocolVersion()
+ * @brief Fetch the version of the protocol rsync speaks.
+ *
+ * @return The protocol version, or 0 if it isn't known.
+ */
+
+/**
+ * @fn RsyncCapabilities::checksumAlgorithms()
+ * @brief Fetch the checksum algorithms rsync lists, in its order of preference.
+ *
+ * @return The algorithms.
+ */
+
+/**
+ * @fn RsyncCapabilities::compressionAlgorithms()
+ * @brief Fetch the compression algorithms rsync lists, in its order of
+ * preference.
+ *
+ * @return The algorithms.
+ */
+
+/**
+ * @fn RsyncCapabilities::hasChecksumAlgorithm(const QString &)
+ * @brief Check whether rsync lists a checksum algorithm.
+ *
+ * @return @b true if it does, @b false otherwise.
+ */
+
+/**
+ * @fn RsyncCapabilities::hasCompressionAlgorithm(const QString &)
+ * @brief Check whether rsync lists a compression algorithm.
+ *
+ * @return @b true if it does, @b false otherwise.
+ */
+
+/**
+ * @fn RsyncCapabilities::supportsInfo()
+ * @brief Check whether rsync has the @b --info option.
+ *
+ * @return @b true if it does, @b false otherwise.
+ */
+
+/**
+ * @fn RsyncCapabilities::supportsChecksumChoice()
+ * @brief Check whether the checksum algorithm can be chosen.
+ *
+ * Only releases that list their algorithms are counted, since there is
+ * nothing to choose from otherwise.
+ *
+ * @return @b true if rsync lists its checksum algorithms, @b false otherwise.
+ */
+
+/**
+ * @fn RsyncCapabilities::supportsCompressionChoice()
+ * @brief Check whether the compression algorithm can be chosen.
+ *
+ * @return @b true if rsync lists its compression algorithms, @b false
+ * otherwise.
+ */
+
+/**
+ * @fn RsyncCapabilities::supportsAppendVerify()
+ * @brief Check whether rsync has the @b --append-verify option.
+ *
+ * @return @b true if it does, @b false otherwise or if the version isn't
+ * known.
+ */
@@ -0,0 +1,87 @@
+/**
+ * @file rsynccapabilities.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the RsyncCapabilities class.
+ */
+
+#ifndef QYNC_RSYNCCAPABILITIES_H
+#define QYNC_RSYNCCAPABILITIES_H
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVersionNumber>
+
+namespace Qync {
+
+	class RsyncCapabilities {
+	public:
+		RsyncCapabilities() = default;
+
+		[[nodiscard]] static RsyncCapabilities fromVersionText(const QString & versionText);
+
+		[[nodiscard]] inline bool isValid() const {
+			return !m_version.isNull();
+		}
+
+		[[nodiscard]] inline const QString & versionText() const {
+			return m_versionText;
+		}
+
+		[[nodiscard]] inline const QVersionNumber & version() const {
+			return m_version;
+		}
+
+		[[nodiscard]] inline int protocolVersion() const {
+			return m_protocolVersion;
+		}
+
+		[[nodiscard]] inline const QStringList & checksumAlgorithms() const {
+			return m_checksumAlgorithms;
+		}
+
+		[[nodiscard]] inline const QStringList & compressionAlgorithms() const {
+			return m_compressionAlgorithms;
+		}
+
+		[[nodiscard]] inline bool hasChecksumAlgorithm(const QString & algorithm) const {
+			return m_checksumAlgorithms.contains(algorithm);
+		}
+
+		[[nodiscard]] inline bool hasCompressionAlgorithm(const QString & algorithm) const {
+			return m_compressionAlgorithms.contains(algorithm);
+		}
+
+		[[nodiscard]] inline bool supportsInfo() const {
+			return m_supportsInfo;
+		}
+
+		[[nodiscard]] inline bool supportsChecksumChoice() const {
+			return !m_checksumAlgorithms.isEmpty();
+		}
+
+		[[nodiscard]] inline bool supportsCompressionChoice() const {
+			return !m_compressionAlgorithms.isEmpty();
+		}
+
+		[[nodiscard]] inline bool supportsAppendVerify() const {
+			return m_version >= QVersionNumber(3, 0, 0);
+		}
+
+		[[nodiscard]] QString fastestChecksumAlgorithm() const;
+		[[nodiscard]] QString fastestCompressionAlgorithm() const;
+
+	private:
+		QString m_versionText;
+		QVersionNumber m_version;
+		int m_protocolVersion = 0;
+		QStringList m_checksumAlgorithms;
+		QStringList m_compressionAlgorithms;
+		bool m_supportsInfo = false;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_RSYNCCAPABILITIES_H
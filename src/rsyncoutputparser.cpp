@@ -0,0 +1,547 @@
+/**
+ * @file rsyncoutputparser.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the RsyncOutputParser class.
+ */
+
+#include "rsyncoutputparser.h"
+
+#include <cstring>
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::RsyncOutputParser class.
+ */
+namespace Qync::Detail::RsyncOutputParser {
+    // the buffer is reserved at this size up front so that a typical read from the
+    // rsync pipe never causes it to reallocate. reserving also prevents QByteArray
+    // from releasing the buffer when the content is fully consumed
+    static constexpr const int InitialBufferCapacity = 64 * 1024;
+
+    // an unfinished line longer than this is not going to be one the parser
+    // recognises, so it is discarded rather than kept growing
+    static constexpr const int MaximumLineLength = 64 * 1024;
+
+    static inline bool isDigit(char ch)
+    {
+        return '0' <= ch && '9' >= ch;
+    }
+
+    static inline void skipSpaces(const char *& pos, const char * end)
+    {
+        while(pos != end && ' ' == *pos) {
+            ++pos;
+        }
+    }
+
+    // consume a literal if it's next in the line
+    static inline bool expect(const char *& pos, const char * end, std::string_view literal)
+    {
+        if(static_cast<std::string_view::size_type>(end - pos) < literal.size() || 0 != std::memcmp(pos, literal.data(), literal.size())) {
+            return false;
+        }
+
+        pos += literal.size();
+        return true;
+    }
+
+    // read an unsigned integer; rsync groups digits with ',' in most of the numbers it prints
+    static bool readUnsigned(const char *& pos, const char * end, quint64 & value)
+    {
+        if(pos == end || !isDigit(*pos)) {
+            return false;
+        }
+
+        value = 0;
+
+        while(pos != end) {
+            if(isDigit(*pos)) {
+                value = (value * 10) + static_cast<quint64>(*pos - '0');
+            }
+            else if(',' != *pos || pos + 1 == end || !isDigit(pos[1])) {
+                break;
+            }
+
+            ++pos;
+        }
+
+        return true;
+    }
+
+    static inline bool readUnsigned(const char *& pos, const char * end, int & value)
+    {
+        quint64 wide;
+
+        if(!readUnsigned(pos, end, wide)) {
+            return false;
+        }
+
+        value = static_cast<int>(wide);
+        return true;
+    }
+
+    // read exactly two digits (for the minutes and seconds of the time remaining)
+    static inline bool readTwoDigits(const char *& pos, const char * end, int & value)
+    {
+        if(2 > end - pos || !isDigit(pos[0]) || !isDigit(pos[1])) {
+            return false;
+        }
+
+        value = ((pos[0] - '0') * 10) + (pos[1] - '0');
+        pos += 2;
+        return true;
+    }
+
+    // read a decimal number without going through the (locale-dependent) C library
+    static bool readDecimal(const char *& pos, const char * end, double & value)
+    {
+        quint64 whole;
+
+        if(!readUnsigned(pos, end, whole)) {
+            return false;
+        }
+
+        value = static_cast<double>(whole);
+
+        if(pos != end && '.' == *pos && pos + 1 != end && isDigit(pos[1])) {
+            ++pos;
+            double scale = 0.1;
+
+            while(pos != end && isDigit(*pos)) {
+                value += (*pos - '0') * scale;
+                scale /= 10.0;
+                ++pos;
+            }
+        }
+
+        return true;
+    }
+
+    // "   1,234,567  45%   12.34MB/s    0:01:23 (xfr#12, to-chk=34/567)"
+    // the (xfr#...) suffix is optional; the check counter can be to-chk or ir-chk
+    static bool parseProgressLine(const char * pos, const char * end, Qync::RsyncOutputParser::Line & line)
+    {
+        int hours;
+        int minutes;
+        int seconds;
+
+        skipSpaces(pos, end);
+
+        if(!readUnsigned(pos, end, line.itemBytes)) {
+            return false;
+        }
+
+        skipSpaces(pos, end);
+
+        if(!readUnsigned(pos, end, line.itemPercent) || !expect(pos, end, "%")) {
+            return false;
+        }
+
+        skipSpaces(pos, end);
+
+        if(!readDecimal(pos, end, line.bytesPerSecond)) {
+            return false;
+        }
+
+        /* whatever unit the speed is expressed in, convert it to bytes per sec */
+        if(pos != end) {
+            switch(*pos) {
+                case 'k':
+                case 'K':
+                    line.bytesPerSecond *= 1024.0;
+                    ++pos;
+                    break;
+
+                case 'm':
+                case 'M':
+                    line.bytesPerSecond *= 1024.0 * 1024.0;
+                    ++pos;
+                    break;
+
+                case 'g':
+                case 'G':
+                    line.bytesPerSecond *= 1024.0 * 1024.0 * 1024.0;
+                    ++pos;
+                    break;
+
+                case 't':
+                case 'T':
+                    line.bytesPerSecond *= 1024.0 * 1024.0 * 1024.0 * 1024.0;
+                    ++pos;
+                    break;
+            }
+        }
+
+        if(!expect(pos, end, "B/s")) {
+            return false;
+        }
+
+        skipSpaces(pos, end);
+
+        if(!readUnsigned(pos, end, hours) || !expect(pos, end, ":") || !readTwoDigits(pos, end, minutes) || !expect(pos, end, ":") || !readTwoDigits(pos, end, seconds)) {
+            return false;
+        }
+
+        line.secondsRemaining = (hours * 3600) + (minutes * 60) + seconds;
+        line.hasCheckCounts = false;
+        skipSpaces(pos, end);
+
+        if(expect(pos, end, "(xfr#") && readUnsigned(pos, end, line.transferNumber) && expect(pos, end, ", ") && (expect(pos, end, "to-chk") || expect(pos, end, "ir-chk")) && pos != end) {
+            // skip the '=' (any single character is accepted)
+            ++pos;
+            line.hasCheckCounts = readUnsigned(pos, end, line.itemsRemaining) && expect(pos, end, "/") && readUnsigned(pos, end, line.totalItems) && expect(pos, end, ")");
+        }
+
+        return true;
+    }
+
+    // "f<path> <size>", as produced by --out-format=f%n %l
+    static bool parseNewItemLine(const char * pos, const char * end, Qync::RsyncOutputParser::Line & line)
+    {
+        if(pos == end || 'f' != *pos) {
+            return false;
+        }
+
+        ++pos;
+        const char * sizeEnd = end;
+        const char * sizeBegin = end;
+
+        while(sizeBegin != pos && isDigit(sizeBegin[-1])) {
+            --sizeBegin;
+        }
+
+        // need at least one digit preceded by the separating space
+        if(sizeBegin == sizeEnd || sizeBegin == pos || ' ' != sizeBegin[-1]) {
+            return false;
+        }
+
+        line.itemPath = std::string_view(pos, static_cast<std::string_view::size_type>(sizeBegin - pos - 1));
+        readUnsigned(sizeBegin, sizeEnd, line.itemSize);
+        return true;
+    }
+
+    // read a tab-terminated field and step over the tab
+    static inline bool readField(const char *& pos, const char * end, std::string_view & field)
+    {
+        const auto * tab = static_cast<const char *>(std::memchr(pos, '\t', static_cast<std::size_t>(end - pos)));
+
+        if(!tab) {
+            return false;
+        }
+
+        field = std::string_view(pos, static_cast<std::string_view::size_type>(tab - pos));
+        pos = tab + 1;
+        return true;
+    }
+
+    // read a tab-terminated unsigned integer field and step over the tab
+    static inline bool readUnsignedField(const char *& pos, const char * end, quint64 & value)
+    {
+        return readUnsigned(pos, end, value) && expect(pos, end, "\t");
+    }
+
+    // "F<changes>\t<length>\t<transferred>\t<checksum>\t<path>", as produced by
+    // --out-format=F%i\t%l\t%b\t%C\t%n. the path is last because it's the only
+    // field that can contain a tab. rsync pads the checksum with spaces when it
+    // doesn't know it
+    static bool parseStructuredItemLine(const char * pos, const char * end, Qync::RsyncOutputParser::Line & line)
+    {
+        if(pos == end || 'F' != *pos) {
+            return false;
+        }
+
+        ++pos;
+
+        if(!readField(pos, end, line.itemChanges) || !readUnsignedField(pos, end, line.itemSize) || !readUnsignedField(pos, end, line.itemTransferredBytes) || !readField(pos, end, line.itemChecksum)) {
+            return false;
+        }
+
+        while(!line.itemChecksum.empty() && ' ' == line.itemChecksum.back()) {
+            line.itemChecksum.remove_suffix(1);
+        }
+
+        while(!line.itemChecksum.empty() && ' ' == line.itemChecksum.front()) {
+            line.itemChecksum.remove_prefix(1);
+        }
+
+        line.itemPath = std::string_view(pos, static_cast<std::string_view::size_type>(end - pos));
+        return true;
+    }
+
+    // the same shape as a --progress line, but the numbers are for the whole transfer
+    // rather than the current item
+    static bool parseTransferProgressLine(const char * pos, const char * end, Qync::RsyncOutputParser::Line & line)
+    {
+        if(!parseProgressLine(pos, end, line)) {
+            return false;
+        }
+
+        line.transferredBytes = line.itemBytes;
+        line.transferPercent = line.itemPercent;
+        line.itemBytes = 0;
+        line.itemPercent = 0;
+        return true;
+    }
+
+    // "sent 1,234 bytes  received 5,678 bytes  2,304.00 bytes/sec"
+    static bool parseCompletedLine(const char * pos, const char * end, Qync::RsyncOutputParser::Line & line)
+    {
+        if(!expect(pos, end, "sent ")) {
+            return false;
+        }
+
+        skipSpaces(pos, end);
+
+        if(!readUnsigned(pos, end, line.bytesSent) || !expect(pos, end, " bytes")) {
+            return false;
+        }
+
+        skipSpaces(pos, end);
+
+        if(!expect(pos, end, "received ")) {
+            return false;
+        }
+
+        skipSpaces(pos, end);
+
+        if(!readUnsigned(pos, end, line.bytesReceived) || !expect(pos, end, " bytes")) {
+            return false;
+        }
+
+        skipSpaces(pos, end);
+        return readDecimal(pos, end, line.bytesPerSecond) && expect(pos, end, " bytes/sec");
+    }
+}  // namespace Qync::Detail::RsyncOutputParser
+
+/**
+ * @class RsyncOutputParser
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Incremental parser for the standard output of rsync.
+ *
+ * The parser is fed the raw bytes read from the rsync process's standard
+ * output using append(), in whatever size chunks they arrive. Complete lines
+ * are then retrieved one at a time with nextLine(), which returns @b false
+ * once the only remaining data is an unfinished line. That unfinished tail is
+ * all that is kept between reads - it is moved to the start of the buffer on
+ * the next call to append(), so the amount of data copied per read is bounded
+ * by the length of one line rather than by the amount of output seen so far.
+ * An unfinished line that grows beyond
+ * Detail::RsyncOutputParser::MaximumLineLength bytes is discarded, along with
+ * the rest of it up to its terminator, so output with no line terminators
+ * can't make the buffer grow without limit.
+ *
+ * Both @b \\n and @b \\r are treated as line terminators, since rsync uses the
+ * latter to overwrite its --progress lines in place. Empty lines and lines that
+ * are not recognised are skipped. The following line shapes are recognised:
+ * - the per-item progress lines produced by @b --progress
+ * - the new item lines produced by @b --out-format=f%n %l
+ * - the summary line rsync prints when it has finished
+ *
+ * Those are the lines produced for Format::Text. For Format::Structured, which
+ * needs rsync 3.1 or later, rsync is run with @b --info=progress2 and
+ * @b --no-human-readable (see Process::OutputFormat) and the parser recognises
+ * instead:
+ * - the whole-transfer progress lines produced by @b --info=progress2, as
+ *   LineType::TransferProgress lines with the bytes transferred so far and the
+ *   percentage of the whole transfer
+ * - tab-separated item lines produced by
+ *   @b --out-format=F%i\\t%l\\t%b\\t%C\\t%n, as LineType::NewItem lines which
+ *   also carry the itemised changes, the bytes actually transferred and the
+ *   checksum (if rsync knows it)
+ * - the summary line, as for Format::Text
+ * rsync prints the structured lines without digit grouping, and the item lines
+ * are fixed fields rather than text to be picked apart. Only the transfer rate
+ * still carries a unit, since rsync always scales it.
+ *
+ * Recognition is done with a hand-written scanner rather than regular
+ * expressions, and the parser does not allocate once its buffer has grown to
+ * the size of a typical pipe read. For this reason the item path in a parsed
+ * Line refers directly to the parser's buffer: it is only valid until the next
+ * call to append() or reset().
+ */
+
+/**
+ * @brief Create a new parser.
+ *
+ * @param format The format of the output to parse.
+ */
+RsyncOutputParser::RsyncOutputParser(Format format)
+:   m_buffer(),
+    m_position(0),
+    m_format(format),
+    m_discardingLine(false)
+{
+    m_buffer.reserve(Detail::RsyncOutputParser::InitialBufferCapacity);
+}
+
+/**
+ * @brief Add some output to be parsed.
+ *
+ * @param data The data read from rsync.
+ *
+ * Any lines previously retrieved using nextLine() are discarded, so the
+ * item paths in those lines are no longer valid.
+ */
+void RsyncOutputParser::append(const QByteArray & data)
+{
+    append(data.constData(), data.size());
+}
+
+/**
+ * @brief Add some output to be parsed.
+ *
+ * @param data The data read from rsync.
+ * @param size The number of bytes of data.
+ *
+ * Any lines previously retrieved using nextLine() are discarded, so the
+ * item paths in those lines are no longer valid.
+ */
+void RsyncOutputParser::append(const char * data, int size)
+{
+    if(0 >= size) {
+        return;
+    }
+
+    if(0 < m_position) {
+        // only the unfinished tail is ever moved
+        m_buffer.remove(0, m_position);
+        m_position = 0;
+    }
+
+    m_buffer.append(data, size);
+}
+
+/**
+ * @brief Fetch the next recognised line of output.
+ *
+ * @param line The Line to fill with the details of the parsed output.
+ *
+ * Unrecognised lines are skipped over. If this method returns @b false the
+ * content of the line is undefined.
+ *
+ * @return @b true if a recognised line was found, @b false if there are no
+ * more complete lines available.
+ */
+bool RsyncOutputParser::nextLine(Line & line)
+{
+    const char * const data = m_buffer.constData();
+    const char * const end = data + m_buffer.size();
+
+    while(data + m_position < end) {
+        const char * const begin = data + m_position;
+        const char * eol = begin;
+
+        while(eol != end && '\n' != *eol && '\r' != *eol) {
+            ++eol;
+        }
+
+        if(eol == end) {
+            if(m_discardingLine || Detail::RsyncOutputParser::MaximumLineLength < end - begin) {
+                m_position = m_buffer.size();
+                m_discardingLine = true;
+            }
+
+            // not yet complete - keep it for the next append()
+            return false;
+        }
+
+        m_position = static_cast<int>(eol - data) + 1;
+
+        if(m_discardingLine) {
+            // the end of the line that was too long
+            m_discardingLine = false;
+            continue;
+        }
+
+        if(eol != begin && LineType::Unrecognised != parseLine(begin, eol, line, m_format)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Discard all the output provided to the parser.
+ *
+ * The storage used by the parser is retained for reuse.
+ */
+void RsyncOutputParser::reset()
+{
+    m_buffer.resize(0);
+    m_position = 0;
+    m_discardingLine = false;
+}
+
+/**
+ * @brief Parse a single line of rsync output.
+ *
+ * @param begin The first character in the line.
+ * @param end One past the last character in the line. It should not include the
+ * line terminator.
+ * @param line The Line to fill with the details parsed from the text.
+ * @param format The format of the output the line comes from.
+ *
+ * This is the scanner used by nextLine(). It is exposed so that individual lines
+ * can be parsed without a parser instance.
+ *
+ * @return The type of line found. Its type is also set in the provided line.
+ */
+RsyncOutputParser::LineType RsyncOutputParser::parseLine(const char * begin, const char * end, Line & line, Format format)
+{
+    using namespace Detail::RsyncOutputParser;
+
+    if(begin == end) {
+        line.type = LineType::Unrecognised;
+    }
+    else if(Format::Structured == format) {
+        if('F' == *begin) {
+            line.type = (parseStructuredItemLine(begin, end, line) ? LineType::NewItem : LineType::Unrecognised);
+        }
+        else if('s' == *begin) {
+            line.type = (parseCompletedLine(begin, end, line) ? LineType::Completed : LineType::Unrecognised);
+        }
+        else {
+            line.type = (parseTransferProgressLine(begin, end, line) ? LineType::TransferProgress : LineType::Unrecognised);
+        }
+    }
+    else if('f' == *begin) {
+        line.type = (parseNewItemLine(begin, end, line) ? LineType::NewItem : LineType::Unrecognised);
+    }
+    else if('s' == *begin) {
+        line.type = (parseCompletedLine(begin, end, line) ? LineType::Completed : LineType::Unrecognised);
+    }
+    else {
+        line.type = (parseProgressLine(begin, end, line) ? LineType::Progress : LineType::Unrecognised);
+    }
+
+    return line.type;
+}
+
+/**
+ * @fn RsyncOutputParser::pendingBytes()
+ * @brief Fetch the number of bytes of output not yet consumed by nextLine().
+ *
+ * @return The number of bytes.
+ */
+
+/**
+ * @fn RsyncOutputParser::format()
+ * @brief Fetch the format of the output being parsed.
+ *
+ * @return The format.
+ */
+
+/**
+ * @fn RsyncOutputParser::setFormat()
+ * @brief Set the format of the output to parse.
+ *
+ * @param format The format. It should be set before any output is appended.
+ */
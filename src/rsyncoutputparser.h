@@ -0,0 +1,99 @@
+/**
+ * @file rsyncoutputparser.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the RsyncOutputParser class.
+ */
+
+#ifndef QYNC_RSYNCOUTPUTPARSER_H
+#define QYNC_RSYNCOUTPUTPARSER_H
+
+#include <string_view>
+
+#include <QtCore/QtGlobal>
+#include <QtCore/QByteArray>
+
+namespace Qync {
+
+	class RsyncOutputParser final {
+	public:
+		enum class Format : unsigned char {
+			Text = 0,
+			Structured,
+		};
+
+		enum class LineType : unsigned char {
+			Unrecognised = 0,
+			Progress,
+			NewItem,
+			Completed,
+			TransferProgress,
+		};
+
+		struct Line {
+			LineType type = LineType::Unrecognised;
+
+			/* progress lines */
+			quint64 itemBytes = 0;
+			int itemPercent = 0;
+			double bytesPerSecond = 0.0;
+			int secondsRemaining = 0;
+			bool hasCheckCounts = false;
+			int transferNumber = 0;
+			int itemsRemaining = 0;
+			int totalItems = 0;
+
+			/* new item lines - itemPath refers to the parser's buffer */
+			std::string_view itemPath;
+			quint64 itemSize = 0;
+
+			/* structured new item lines only - these also refer to the parser's buffer */
+			std::string_view itemChanges;
+			std::string_view itemChecksum;
+			quint64 itemTransferredBytes = 0;
+
+			/* transfer progress lines (bytesPerSecond, secondsRemaining and the check
+			 * counts are also set) */
+			quint64 transferredBytes = 0;
+			int transferPercent = 0;
+
+			/* completed lines (bytesPerSecond is also set) */
+			quint64 bytesSent = 0;
+			quint64 bytesReceived = 0;
+		};
+
+		explicit RsyncOutputParser(Format format = Format::Text);
+
+		[[nodiscard]] inline Format format() const {
+			return m_format;
+		}
+
+		inline void setFormat(Format format) {
+			m_format = format;
+		}
+
+		void append(const QByteArray & data);
+		void append(const char * data, int size);
+		bool nextLine(Line & line);
+		void reset();
+
+		[[nodiscard]] inline int pendingBytes() const {
+			return m_buffer.size() - m_position;
+		}
+
+		static LineType parseLine(const char * begin, const char * end, Line & line, Format format = Format::Text);
+
+	private:
+		QByteArray m_buffer;
+		int m_position;
+		Format m_format;
+
+		/* the rest of the line is thrown away up to its terminator, since it was too long */
+		bool m_discardingLine;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_RSYNCOUTPUTPARSER_H
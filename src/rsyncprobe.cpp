@@ -0,0 +1,326 @@
+/**
+ * @file rsyncprobe.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the RsyncProbe class.
+ */
+
+#include "rsyncprobe.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QProcess>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::RsyncProbe class.
+ */
+namespace Qync::Detail::RsyncProbe {
+    static constexpr const quint32 Magic = 0x51594e52;  // "QYNR"
+    static constexpr const quint32 Version = 1;
+    static constexpr const QDataStream::Version StreamVersion = QDataStream::Qt_5_9;
+}  // namespace Qync::Detail::RsyncProbe
+
+/**
+ * @class RsyncProbe
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Finds out what an rsync binary can do without holding anything up.
+ *
+ * probe() runs <tt>rsync --version</tt> in the background and, when it
+ * finishes, works out the binary's RsyncCapabilities and emits
+ * capabilitiesChanged(). Until then capabilities() describes the last binary
+ * probed, or nothing at all, so anything that depends on them must cope with
+ * them changing after it has started (e.g. by only using them for processes it
+ * creates later).
+ *
+ * The version text of each binary is kept in a small cache file along with the
+ * binary's size and modification time, so rsync is only run the first time a
+ * binary is probed and again after it has been upgraded. When the cache is up
+ * to date probe() costs a stat() and the capabilities change before it
+ * returns. The raw text is cached rather than what was worked out from it, so
+ * the cache remains valid when RsyncCapabilities learns about new options.
+ *
+ * Probing a different binary while a probe is running abandons the running
+ * one. Anything that can't wait, such as the headless application, can call
+ * waitForFinished().
+ */
+
+/**
+ * @brief Create a probe.
+ *
+ * @param cacheFileName The file the version texts are cached in. It is read
+ * the first time probe() is called.
+ * @param parent The owner of the probe.
+ */
+RsyncProbe::RsyncProbe(QString cacheFileName, QObject * parent)
+:   QObject(parent),
+    m_cacheFileName(std::move(cacheFileName)),
+    m_cache(),
+    m_cacheLoaded(false),
+    m_rsyncPath(),
+    m_key(),
+    m_capabilities(),
+    m_process(nullptr)
+{
+}
+
+/**
+ * @brief Destroy the probe.
+ *
+ * A probe that is still running is abandoned.
+ */
+RsyncProbe::~RsyncProbe()
+{
+    if(m_process) {
+        m_process->disconnect(this);
+    }
+}
+
+/**
+ * @brief Find out what an rsync binary can do.
+ *
+ * @param rsyncPath The rsync command, as found in Preferences::rsyncPath(). If
+ * it is not an absolute path it is looked for in the @b PATH.
+ *
+ * If the binary is the one last probed and hasn't changed since, nothing is
+ * done. If its version text is in the cache the capabilities are updated
+ * immediately; otherwise rsync is started and they are updated when it
+ * finishes. capabilitiesChanged() is emitted either way.
+ */
+void RsyncProbe::probe(const QString & rsyncPath)
+{
+    const QFileInfo binary(QDir::isAbsolutePath(rsyncPath) ? rsyncPath : QStandardPaths::findExecutable(rsyncPath));
+    const auto path = binary.exists() ? binary.absoluteFilePath() : rsyncPath;
+    Record key{binary.lastModified().toMSecsSinceEpoch(), binary.size(), {}};
+
+    if(path == m_rsyncPath && key.modified == m_key.modified && key.size == m_key.size && (isProbing() || m_capabilities.isValid())) {
+        return;
+    }
+
+    if(m_process) {
+        m_process->disconnect(this);
+        m_process.reset();
+    }
+
+    m_rsyncPath = path;
+    m_key = key;
+
+    if(!binary.exists()) {
+        qWarning() << __PRETTY_FUNCTION__ << "rsync binary" << rsyncPath << "not found";
+        setCapabilities({});
+        return;
+    }
+
+    if(!m_cacheLoaded) {
+        loadCache();
+    }
+
+    if(const auto it = m_cache.constFind(path); m_cache.cend() != it && it->modified == key.modified && it->size == key.size) {
+        setCapabilities(RsyncCapabilities::fromVersionText(it->versionText));
+        return;
+    }
+
+    m_process = std::make_unique<QProcess>();
+    connect(m_process.get(), qOverload<int, QProcess::ExitStatus>(&QProcess::finished), this, &RsyncProbe::onProcessFinished);
+
+    connect(m_process.get(), &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        // finished() is not emitted for a process that never started
+        if(QProcess::FailedToStart == error) {
+            onProcessFinished();
+        }
+    });
+
+    m_process->start(path, {QStringLiteral("--version")}, QIODevice::ReadOnly);
+}
+
+/**
+ * @brief Wait for a running probe to finish.
+ *
+ * @param msecs The longest time to wait, in milliseconds.
+ *
+ * The capabilities are up to date when this returns @b true. There is no need
+ * to call it for a probe satisfied from the cache.
+ *
+ * @return @b true if no probe is running when this returns, @b false if the
+ * probe timed out.
+ */
+bool RsyncProbe::waitForFinished(int msecs)
+{
+    if(!m_process) {
+        return true;
+    }
+
+    if(!m_process->waitForFinished(msecs) && m_process && QProcess::NotRunning == m_process->state()) {
+        // never started, so errorOccurred() is the only thing that will finish it
+        onProcessFinished();
+    }
+
+    return !isProbing();
+}
+
+/**
+ * @brief Read the version texts cached by previous probes.
+ *
+ * A missing or damaged cache is treated as empty.
+ */
+void RsyncProbe::loadCache()
+{
+    m_cacheLoaded = true;
+    m_cache.clear();
+    QFile file(m_cacheFileName);
+
+    if(!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(Detail::RsyncProbe::StreamVersion);
+    quint32 magic;
+    quint32 version;
+    qint32 count;
+    in >> magic >> version >> count;
+
+    if(QDataStream::Ok != in.status() || Detail::RsyncProbe::Magic != magic || Detail::RsyncProbe::Version != version || 0 > count) {
+        qWarning() << __PRETTY_FUNCTION__ << m_cacheFileName << "is not a valid rsync capability cache";
+        return;
+    }
+
+    for(qint32 index = 0; index < count; ++index) {
+        QString path;
+        Record record;
+        in >> path >> record.modified >> record.size >> record.versionText;
+
+        if(QDataStream::Ok != in.status()) {
+            qWarning() << __PRETTY_FUNCTION__ << m_cacheFileName << "is truncated or corrupt";
+            m_cache.clear();
+            return;
+        }
+
+        m_cache.insert(path, record);
+    }
+}
+
+/**
+ * @brief Write the cached version texts to the cache file.
+ */
+void RsyncProbe::saveCache()
+{
+    if(m_cacheFileName.isEmpty()) {
+        return;
+    }
+
+    if(!QDir().mkpath(QFileInfo(m_cacheFileName).absolutePath())) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to create directory for" << m_cacheFileName;
+        return;
+    }
+
+    QSaveFile file(m_cacheFileName);
+
+    if(!file.open(QIODevice::WriteOnly)) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to open" << m_cacheFileName << ":" << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(Detail::RsyncProbe::StreamVersion);
+    out << Detail::RsyncProbe::Magic << Detail::RsyncProbe::Version << static_cast<qint32>(m_cache.size());
+
+    for(auto it = m_cache.cbegin(); it != m_cache.cend(); ++it) {
+        out << it.key() << it->modified << it->size << it->versionText;
+    }
+
+    if(QDataStream::Ok != out.status() || !file.commit()) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to write" << m_cacheFileName << ":" << file.errorString();
+    }
+}
+
+/**
+ * @brief Handle rsync finishing, or failing to start.
+ *
+ * The version text is only cached if it was understood, so a binary that
+ * failed once is probed again next time.
+ */
+void RsyncProbe::onProcessFinished()
+{
+    if(!m_process) {
+        return;
+    }
+
+    m_process->disconnect(this);
+    const auto versionText = QString::fromLocal8Bit(m_process->readAllStandardOutput());
+
+    if(QProcess::FailedToStart == m_process->error()) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to run" << m_rsyncPath << ":" << m_process->errorString();
+    }
+
+    // this is called from the process's own signals, so it can't be destroyed here
+    m_process.release()->deleteLater();
+    auto capabilities = RsyncCapabilities::fromVersionText(versionText);
+
+    if(capabilities.isValid()) {
+        m_cache.insert(m_rsyncPath, {m_key.modified, m_key.size, versionText});
+        saveCache();
+    }
+    else {
+        qWarning() << __PRETTY_FUNCTION__ << "could not find the version of" << m_rsyncPath;
+    }
+
+    setCapabilities(std::move(capabilities));
+}
+
+/**
+ * @brief Replace the capabilities and tell everyone.
+ *
+ * @param capabilities The new capabilities.
+ */
+void RsyncProbe::setCapabilities(RsyncCapabilities capabilities)
+{
+    m_capabilities = std::move(capabilities);
+    Q_EMIT capabilitiesChanged();
+}
+
+/**
+ * @fn RsyncProbe::cacheFileName()
+ * @brief Fetch the file the version texts are cached in.
+ *
+ * @return The path to the file.
+ */
+
+/**
+ * @fn RsyncProbe::rsyncPath()
+ * @brief Fetch the path to the binary last probed.
+ *
+ * @return The absolute path, or the command as given if it couldn't be found.
+ */
+
+/**
+ * @fn RsyncProbe::capabilities()
+ * @brief Fetch what the binary last probed can do.
+ *
+ * @return The capabilities. They are not valid if no probe has finished yet
+ * or rsync couldn't be run.
+ */
+
+/**
+ * @fn RsyncProbe::isProbing()
+ * @brief Check whether rsync is being run to find out what it can do.
+ *
+ * @return @b true if it is, @b false otherwise.
+ */
+
+/**
+ * @fn RsyncProbe::capabilitiesChanged()
+ * @brief Emitted when capabilities() has been updated by a probe.
+ */
@@ -0,0 +1,79 @@
+/**
+ * @file rsyncprobe.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the RsyncProbe class.
+ */
+
+#ifndef QYNC_RSYNCPROBE_H
+#define QYNC_RSYNCPROBE_H
+
+#include <memory>
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include "rsynccapabilities.h"
+
+class QProcess;
+
+namespace Qync {
+
+	class RsyncProbe
+	: public QObject {
+		Q_OBJECT
+
+	public:
+		explicit RsyncProbe(QString cacheFileName, QObject * parent = nullptr);
+		~RsyncProbe() override;
+
+		[[nodiscard]] inline const QString & cacheFileName() const {
+			return m_cacheFileName;
+		}
+
+		[[nodiscard]] inline const QString & rsyncPath() const {
+			return m_rsyncPath;
+		}
+
+		[[nodiscard]] inline const RsyncCapabilities & capabilities() const {
+			return m_capabilities;
+		}
+
+		[[nodiscard]] inline bool isProbing() const {
+			return static_cast<bool>(m_process);
+		}
+
+		void probe(const QString & rsyncPath);
+		bool waitForFinished(int msecs = 30000);
+
+	Q_SIGNALS:
+		void capabilitiesChanged();
+
+	private:
+		struct Record {
+			qint64 modified = 0;
+			qint64 size = 0;
+			QString versionText;
+		};
+
+		void loadCache();
+		void saveCache();
+		void onProcessFinished();
+		void setCapabilities(RsyncCapabilities capabilities);
+
+		QString m_cacheFileName;
+		QHash<QString, Record> m_cache;
+		bool m_cacheLoaded;
+
+		QString m_rsyncPath;
+		Record m_key;
+		RsyncCapabilities m_capabilities;
+		std::unique_ptr<QProcess> m_process;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_RSYNCPROBE_H
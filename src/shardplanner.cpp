@@ -0,0 +1,190 @@
+/**
+ * @file shardplanner.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the ShardPlanner class.
+ */
+
+#include "shardplanner.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFileInfo>
+
+#include "functions.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::ShardPlanner class.
+ */
+namespace Qync::Detail::ShardPlanner {
+    // rsync's cost per file (stat, file list entry, open/close at both ends) is
+    // roughly that of transferring this many bytes, so each file is given this
+    // weight on top of its size. without it a shard full of tiny files would
+    // look almost free
+    static constexpr const qint64 PerFileWeight = 128 * 1024;
+
+    static constexpr const QDir::Filters EntryFilters = QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot;
+}  // namespace Qync::Detail::ShardPlanner
+
+/**
+ * @class ShardPlanner
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Splits a local source directory into balanced shards on a background
+ * thread.
+ *
+ * The top-level entries of the source are the units of work. Each is weighed
+ * by walking it and adding up the sizes of its files plus a fixed overhead per
+ * file, then the entries are distributed between the shards greedily, heaviest
+ * first, each going to the shard with the least weight so far. The result is a
+ * list of entries for each shard, relative to baseDirectory(), suitable for
+ * rsync's --files-from option.
+ *
+ * If the source path ends with a separator (i.e. rsync is to copy the
+ * directory's content), the base directory is the source itself and the entries
+ * are its children. Otherwise the base directory is the source's parent and
+ * each entry is prefixed with the source's name, so that with --relative rsync
+ * recreates the same layout under the destination.
+ *
+ * Start the planner with start() and read the shards once finished() has been
+ * emitted. The walk stops early if requestInterruption() is called, in which
+ * case there are no shards. Shards that would be empty are omitted, so there
+ * may be fewer shards than requested.
+ */
+
+/**
+ * @brief Create a new planner.
+ *
+ * @param source The rsync source. It must be a local directory - see canShard().
+ * @param shardCount The maximum number of shards.
+ * @param parent The parent object.
+ */
+ShardPlanner::ShardPlanner(QString source, int shardCount, QObject * parent)
+:   QThread(parent),
+    m_source(std::move(source)),
+    m_shardCount(std::max(shardCount, 1)),
+    m_baseDirectory(),
+    m_shards()
+{
+}
+
+/**
+ * @brief Destroy the planner.
+ *
+ * The planner must have finished.
+ */
+ShardPlanner::~ShardPlanner() = default;
+
+/**
+ * @brief Check whether an rsync source can be sharded.
+ *
+ * @param source The source.
+ *
+ * @return @b true if the source is a local directory, @b false otherwise.
+ */
+bool ShardPlanner::canShard(const QString & source)
+{
+    if(source.isEmpty()) {
+        return false;
+    }
+
+    QFileInfo info(source);
+    return info.isDir() && !info.isSymLink();
+}
+
+/**
+ * @brief Plan the shards.
+ */
+void ShardPlanner::run()
+{
+    m_shards.clear();
+    QDir sourceDir(m_source);
+    QString prefix;
+    m_baseDirectory = filesFromBaseDirectory(m_source, prefix);
+
+    std::vector<std::pair<qint64, QString>> entries;
+
+    for(const auto & entry : sourceDir.entryInfoList(Detail::ShardPlanner::EntryFilters, QDir::NoSort)) {
+        if(isInterruptionRequested()) {
+            return;
+        }
+
+        entries.emplace_back(weigh(entry.absoluteFilePath()), prefix + entry.fileName());
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const auto & first, const auto & second) {
+        return first.first > second.first;
+    });
+
+    std::vector<QStringList> shards(static_cast<std::size_t>(m_shardCount));
+    std::vector<qint64> weights(static_cast<std::size_t>(m_shardCount), 0);
+
+    for(auto & entry : entries) {
+        auto lightest = static_cast<std::size_t>(std::min_element(weights.cbegin(), weights.cend()) - weights.cbegin());
+        weights[lightest] += entry.first;
+        shards[lightest].append(std::move(entry.second));
+    }
+
+    for(auto & shard : shards) {
+        if(!shard.isEmpty()) {
+            m_shards.push_back(std::move(shard));
+        }
+    }
+}
+
+/**
+ * @brief Weigh a top-level entry.
+ *
+ * @param path The path to the entry.
+ *
+ * Symbolic links are not followed.
+ *
+ * @return The weight.
+ */
+qint64 ShardPlanner::weigh(const QString & path) const
+{
+    QFileInfo info(path);
+
+    if(!info.isDir() || info.isSymLink()) {
+        return info.size() + Detail::ShardPlanner::PerFileWeight;
+    }
+
+    qint64 weight = Detail::ShardPlanner::PerFileWeight;
+    QDirIterator it(path, Detail::ShardPlanner::EntryFilters, QDirIterator::Subdirectories);
+
+    while(it.hasNext() && !isInterruptionRequested()) {
+        it.next();
+        weight += it.fileInfo().size() + Detail::ShardPlanner::PerFileWeight;
+    }
+
+    return weight;
+}
+
+/**
+ * @fn ShardPlanner::baseDirectory()
+ * @brief Fetch the directory to which the entries in the shards are relative.
+ *
+ * This is only valid once the planner has finished. It always ends with a
+ * separator.
+ *
+ * @return The base directory.
+ */
+
+/**
+ * @fn ShardPlanner::shards()
+ * @brief Fetch the planned shards.
+ *
+ * This is only valid once the planner has finished.
+ *
+ * @return The entries for each shard.
+ */
@@ -0,0 +1,53 @@
+/**
+ * @file shardplanner.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the ShardPlanner class.
+ */
+
+#ifndef QYNC_SHARDPLANNER_H
+#define QYNC_SHARDPLANNER_H
+
+#include <vector>
+
+#include <QtCore/QThread>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+namespace Qync {
+
+	class ShardPlanner
+	: public QThread {
+		Q_OBJECT
+
+	public:
+		ShardPlanner(QString source, int shardCount, QObject * parent = nullptr);
+		~ShardPlanner() override;
+
+		[[nodiscard]] inline const QString & baseDirectory() const {
+			return m_baseDirectory;
+		}
+
+		[[nodiscard]] inline const std::vector<QStringList> & shards() const {
+			return m_shards;
+		}
+
+		[[nodiscard]] static bool canShard(const QString & source);
+
+	protected:
+		void run() override;
+
+	private:
+		[[nodiscard]] qint64 weigh(const QString & path) const;
+
+		QString m_source;
+		int m_shardCount;
+		QString m_baseDirectory;
+		std::vector<QStringList> m_shards;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_SHARDPLANNER_H
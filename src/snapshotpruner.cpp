@@ -0,0 +1,130 @@
+/**
+ * @file snapshotpruner.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the SnapshotPruner class.
+ */
+
+#include "snapshotpruner.h"
+
+#include <utility>
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::SnapshotPruner class.
+ */
+namespace Qync::Detail::SnapshotPruner {
+    static constexpr const QDir::Filters EntryFilters = QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot;
+
+    // what's needed to list a directory and remove its entries
+    static constexpr const QFileDevice::Permissions OwnerAccess = QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ExeOwner;
+}  // namespace Qync::Detail::SnapshotPruner
+
+/**
+ * @class SnapshotPruner
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Removes expired snapshots on a background thread.
+ *
+ * A snapshot can have millions of entries, most of them hard links to files in
+ * other snapshots, and removing it takes a while even though little space is
+ * freed until the last link to each file is gone. The pruner removes each of
+ * the snapshots it is given, oldest first as they are listed by
+ * SnapshotSet::expired(). Directories are made writable before their entries
+ * are removed, since a snapshot keeps the source's permissions.
+ *
+ * Start the pruner with start(). It stops after the entry it is removing if
+ * requestInterruption() is called, leaving the rest of that snapshot and the
+ * snapshots after it; they are expired again after the next run. removedCount()
+ * is the number of snapshots that were removed completely.
+ */
+
+/**
+ * @brief Create a new pruner.
+ *
+ * @param snapshots The paths of the snapshots to remove.
+ * @param parent The parent object.
+ */
+SnapshotPruner::SnapshotPruner(QStringList snapshots, QObject * parent)
+:   QThread(parent),
+    m_snapshots(std::move(snapshots)),
+    m_removedCount(0)
+{
+}
+
+/**
+ * @brief Destroy the pruner.
+ *
+ * The pruner must have finished.
+ */
+SnapshotPruner::~SnapshotPruner() = default;
+
+/**
+ * @brief Remove the snapshots.
+ */
+void SnapshotPruner::run()
+{
+    m_removedCount = 0;
+
+    for(const auto & snapshot : m_snapshots) {
+        if(isInterruptionRequested()) {
+            return;
+        }
+
+        if(removeTree(snapshot)) {
+            ++m_removedCount;
+        }
+        else if(!isInterruptionRequested()) {
+            qWarning() << __PRETTY_FUNCTION__ << "failed to remove all of snapshot" << snapshot;
+        }
+    }
+}
+
+/**
+ * @brief Remove a directory and everything in it.
+ *
+ * @param path The directory.
+ *
+ * Symbolic links are removed, not followed.
+ *
+ * @return @b true if the directory was removed, @b false if anything in it
+ * could not be or the pruner was interrupted.
+ */
+bool SnapshotPruner::removeTree(const QString & path)
+{
+    using namespace Detail::SnapshotPruner;
+    QFile::setPermissions(path, QFile::permissions(path) | OwnerAccess);
+    bool ok = true;
+
+    for(const auto & entry : QDir(path).entryInfoList(EntryFilters, QDir::NoSort)) {
+        if(isInterruptionRequested()) {
+            return false;
+        }
+
+        if(entry.isDir() && !entry.isSymLink()) {
+            ok = removeTree(entry.filePath()) && ok;
+        }
+        else if(!QFile::remove(entry.filePath())) {
+            ok = false;
+        }
+    }
+
+    return QDir().rmdir(path) && ok;
+}
+
+/**
+ * @fn SnapshotPruner::removedCount()
+ * @brief Fetch how many snapshots were removed.
+ *
+ * @return The number of snapshots removed completely.
+ */
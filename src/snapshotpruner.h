@@ -0,0 +1,43 @@
+/**
+ * @file snapshotpruner.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the SnapshotPruner class.
+ */
+
+#ifndef QYNC_SNAPSHOTPRUNER_H
+#define QYNC_SNAPSHOTPRUNER_H
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QThread>
+
+namespace Qync {
+
+	class SnapshotPruner
+	: public QThread {
+		Q_OBJECT
+
+	public:
+		explicit SnapshotPruner(QStringList snapshots, QObject * parent = nullptr);
+		~SnapshotPruner() override;
+
+		[[nodiscard]] inline int removedCount() const {
+			return m_removedCount;
+		}
+
+	protected:
+		void run() override;
+
+	private:
+		bool removeTree(const QString & path);
+
+		QStringList m_snapshots;
+		int m_removedCount;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_SNAPSHOTPRUNER_H
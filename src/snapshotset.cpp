@@ -0,0 +1,274 @@
+/**
+ * @file snapshotset.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the SnapshotSet class.
+ */
+
+#include "snapshotset.h"
+
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+
+#include "functions.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::SnapshotSet class.
+ */
+namespace Qync::Detail::SnapshotSet {
+    // sorts in time order and is valid on every filesystem rsync writes to
+    static constexpr const char * NameFormat = "yyyy-MM-dd_HHmmss";
+
+    // snapshots that fall in the same period of a rule share a key
+    static qint64 hourKey(const QDateTime & time)
+    {
+        return time.date().toJulianDay() * 24 + time.time().hour();
+    }
+
+    static qint64 dayKey(const QDateTime & time)
+    {
+        return time.date().toJulianDay();
+    }
+
+    static qint64 weekKey(const QDateTime & time)
+    {
+        int year;
+        const auto week = time.date().weekNumber(&year);
+        return static_cast<qint64>(year) * 100 + week;
+    }
+}  // namespace Qync::Detail::SnapshotSet
+
+/**
+ * @class SnapshotSet
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief The dated snapshots in a snapshot directory.
+ *
+ * A preset that keeps snapshots (see Preset::snapshots()) synchronises into a
+ * new subdirectory of its destination each time it is run, named for the time
+ * of the run (see nameFor()). Files that haven't changed since the previous
+ * snapshot are hard links to it (rsync's @b --link-dest), so each snapshot is
+ * a complete copy of the source but only the files that changed take up space.
+ *
+ * A snapshot is written under its name with IncompleteSuffix added, and only
+ * renamed once rsync has succeeded, so an interrupted run never looks like a
+ * complete snapshot. The next run carries on with the incomplete snapshot
+ * rather than starting another.
+ *
+ * snapshots() lists the complete snapshots and latest() is the one to link
+ * against. expired() applies a retention policy: for each of the most recent
+ * RetentionPolicy::hourly hours (and days, and weeks) that have a snapshot,
+ * the latest snapshot in that hour is kept. Any snapshot that no rule keeps has
+ * expired, apart from the latest, which is never expired. A policy with no
+ * rules keeps all the snapshots. SnapshotPruner removes the expired snapshots.
+ */
+
+/**
+ * @brief Create a new snapshot set.
+ *
+ * @param directory The directory that contains the snapshots.
+ */
+SnapshotSet::SnapshotSet(QString directory)
+:   m_directory(std::move(directory))
+{
+}
+
+/**
+ * @brief Check whether an rsync destination can hold snapshots.
+ *
+ * @param destination The destination.
+ *
+ * Qync has to list, rename and remove the snapshots itself, so only local
+ * destinations can.
+ *
+ * @return @b true if the destination is a local path, @b false if it is on a
+ * remote host.
+ */
+bool SnapshotSet::canSnapshot(const QString & destination)
+{
+    return isLocalPath(destination);
+}
+
+/**
+ * @brief Work out the name of the snapshot for a run at a given time.
+ *
+ * @param time The time.
+ *
+ * @return The name.
+ */
+QString SnapshotSet::nameFor(const QDateTime & time)
+{
+    return time.toString(QString::fromLatin1(Detail::SnapshotSet::NameFormat));
+}
+
+/**
+ * @brief Work out the time of a snapshot from its name.
+ *
+ * @param name The name of the snapshot, with or without IncompleteSuffix.
+ *
+ * @return The time, or an invalid QDateTime if the name is not that of a
+ * snapshot.
+ */
+QDateTime SnapshotSet::timeOf(const QString & name)
+{
+    const QString suffix = QString::fromLatin1(IncompleteSuffix);
+    return QDateTime::fromString((name.endsWith(suffix) ? name.left(name.size() - suffix.size()) : name), QString::fromLatin1(Detail::SnapshotSet::NameFormat));
+}
+
+/**
+ * @brief Work out the path of a snapshot.
+ *
+ * @param name The name of the snapshot.
+ *
+ * @return The path.
+ */
+QString SnapshotSet::path(const QString & name) const
+{
+    return QDir(m_directory).filePath(name);
+}
+
+/**
+ * @brief List the complete snapshots.
+ *
+ * @return The names of the snapshots, oldest first.
+ */
+QStringList SnapshotSet::snapshots() const
+{
+    QStringList ret;
+    const QString suffix = QString::fromLatin1(IncompleteSuffix);
+
+    for(const auto & name : QDir(m_directory).entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDir::Name)) {
+        if(!name.endsWith(suffix) && timeOf(name).isValid()) {
+            ret.push_back(name);
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief List the snapshots that runs have not finished.
+ *
+ * @return The names of the snapshots, including IncompleteSuffix, oldest first.
+ */
+QStringList SnapshotSet::incompleteSnapshots() const
+{
+    QStringList ret;
+    const QString suffix = QString::fromLatin1(IncompleteSuffix);
+
+    for(const auto & name : QDir(m_directory).entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks, QDir::Name)) {
+        if(name.endsWith(suffix) && timeOf(name).isValid()) {
+            ret.push_back(name);
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Find the most recent complete snapshot.
+ *
+ * @return The name of the snapshot, or an empty string if there are none.
+ */
+QString SnapshotSet::latest() const
+{
+    const auto all = snapshots();
+    return (all.isEmpty() ? QString() : all.last());
+}
+
+/**
+ * @brief Work out which snapshots a retention policy does not keep.
+ *
+ * @param policy The policy.
+ * @param keep The name of an incomplete snapshot that is in use.
+ *
+ * Incomplete snapshots other than @p keep (or, if no snapshot is in use, the
+ * most recent one) are always expired, since a run only ever carries on with
+ * the most recent one.
+ *
+ * @return The paths of the snapshots that should be removed.
+ */
+QStringList SnapshotSet::expired(const RetentionPolicy & policy, const QString & keep) const
+{
+    using namespace Detail::SnapshotSet;
+    QStringList ret;
+    const auto incomplete = incompleteSnapshots();
+
+    if(!incomplete.isEmpty()) {
+        // without one in use, the most recent might be carried on with next time
+        const auto & inUse = (keep.isEmpty() ? incomplete.last() : keep);
+
+        for(const auto & name : incomplete) {
+            if(name != inUse) {
+                ret.push_back(path(name));
+            }
+        }
+    }
+
+    const auto all = snapshots();
+
+    if(policy.keepsEverything() || all.isEmpty()) {
+        return ret;
+    }
+
+    std::vector<QDateTime> times;
+
+    for(const auto & name : all) {
+        times.push_back(timeOf(name));
+    }
+
+    std::set<int> kept = {all.size() - 1};
+
+    auto applyRule = [&times, &kept](int count, qint64 (*key)(const QDateTime &)) {
+        bool haveKey = false;
+        qint64 lastKey = 0;
+
+        // newest first, so it's the latest snapshot in each period that's kept
+        for(auto index = static_cast<int>(times.size()) - 1; 0 <= index && 0 < count; --index) {
+            const auto thisKey = key(times[static_cast<std::size_t>(index)]);
+
+            if(!haveKey || thisKey != lastKey) {
+                kept.insert(index);
+                lastKey = thisKey;
+                haveKey = true;
+                --count;
+            }
+        }
+    };
+
+    applyRule(policy.hourly, &hourKey);
+    applyRule(policy.daily, &dayKey);
+    applyRule(policy.weekly, &weekKey);
+
+    for(int index = 0; index < all.size(); ++index) {
+        if(0 == kept.count(index)) {
+            ret.push_back(path(all[index]));
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @fn SnapshotSet::directory()
+ * @brief Fetch the directory that contains the snapshots.
+ *
+ * @return The directory.
+ */
+
+/**
+ * @fn SnapshotSet::RetentionPolicy::keepsEverything()
+ * @brief Check whether the policy has no rules, and so keeps every snapshot.
+ *
+ * @return @b true if no snapshot is ever expired, @b false otherwise.
+ */
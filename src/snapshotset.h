@@ -0,0 +1,57 @@
+/**
+ * @file snapshotset.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the SnapshotSet class.
+ */
+
+#ifndef QYNC_SNAPSHOTSET_H
+#define QYNC_SNAPSHOTSET_H
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+class QDateTime;
+
+namespace Qync {
+
+	class SnapshotSet {
+	public:
+		struct RetentionPolicy {
+			// how many of the most recent hours, days and weeks keep a snapshot
+			int hourly = 0;
+			int daily = 0;
+			int weekly = 0;
+
+			[[nodiscard]] inline bool keepsEverything() const {
+				return 0 >= hourly && 0 >= daily && 0 >= weekly;
+			}
+		};
+
+		explicit SnapshotSet(QString directory);
+
+		[[nodiscard]] inline const QString & directory() const {
+			return m_directory;
+		}
+
+		[[nodiscard]] static bool canSnapshot(const QString & destination);
+		[[nodiscard]] static QString nameFor(const QDateTime & time);
+		[[nodiscard]] static QDateTime timeOf(const QString & name);
+
+		[[nodiscard]] QString path(const QString & name) const;
+		[[nodiscard]] QStringList snapshots() const;
+		[[nodiscard]] QStringList incompleteSnapshots() const;
+		[[nodiscard]] QString latest() const;
+		[[nodiscard]] QStringList expired(const RetentionPolicy & policy, const QString & keep = {}) const;
+
+		static constexpr const char * IncompleteSuffix = ".incomplete";
+
+	private:
+		QString m_directory;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_SNAPSHOTSET_H
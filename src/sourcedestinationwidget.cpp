@@ -11,11 +11,12 @@
 #include "ui_sourcedestinationwidget.h"
 
 #include <QtWidgets/QFileDialog>
-#include <QtWidgets/QCompleter>
-#include <QtWidgets/QFileSystemModel>
 #include <QtWidgets/QToolButton>
 #include <QtWidgets/QLineEdit>
 
+#include "pathcompleter.h"
+#include "preset.h"
+
 using namespace Qync;
 
 /**
@@ -28,9 +29,12 @@ using namespace Qync;
  * for a sync.
  *
  * The user can manually type the source and destination, or use the file-select
- * buttons to choose a file using a standard system file dialogue. The text entry
- * components do not yet support inline completion (for local files/dirs), but
- * this is a planned feature.
+ * buttons to choose a file using a standard system file dialogue. Local paths
+ * typed into the text entry components are completed from the directories
+ * they are in, which are read in the background (see PathCompleter). Remote
+ * paths are completed too once the widget has a RemoteLister (see
+ * setRemoteLister()); they are listed using the transport settings given with
+ * setRemoteTransport().
  *
  * The source and destination can be set using setSource()/setDestination() and
  * read using source()/destination(). You can also customise the labels for these
@@ -44,29 +48,19 @@ using namespace Qync;
  */
 SourceDestinationWidget::SourceDestinationWidget(QWidget * parent)
 : QWidget(parent),
-  m_ui(std::make_unique<Ui::SourceDestinationWidget>()) {
+  m_ui(std::make_unique<Ui::SourceDestinationWidget>()),
+  m_lister(),
+  m_sourceCompleter(nullptr),
+  m_destinationCompleter(nullptr),
+  m_remoteTransport(std::make_unique<Preset>()) {
     m_ui->setupUi(this);
     adjustSize();
     setMinimumHeight(height());
     setMaximumHeight(height());
 
-    // completer is destroyed in when SourceDestinationWidget is destroyed; fsModel destroyed when completer destroyed
-    auto * completer = new QCompleter(this);
-    auto * fsModel = new QFileSystemModel(completer);
-    fsModel->setRootPath(QStringLiteral(""));
-    completer->setModel(fsModel);
-    m_ui->source->setCompleter(completer);
-    completer->setCaseSensitivity(Qt::CaseInsensitive);
-    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
-
-    // ...ditto...
-    completer = new QCompleter(this);
-    fsModel = new QFileSystemModel(completer);
-    fsModel->setRootPath(QStringLiteral(""));
-    completer->setModel(fsModel);
-    m_ui->destination->setCompleter(completer);
-    completer->setCaseSensitivity(Qt::CaseInsensitive);
-    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    // the completers are owned by the line edits
+    m_sourceCompleter = new PathCompleter(m_lister, m_ui->source);
+    m_destinationCompleter = new PathCompleter(m_lister, m_ui->destination);
 
     connect(m_ui->source, &QLineEdit::textEdited, this, &SourceDestinationWidget::sourceChanged);
     connect(m_ui->destination, &QLineEdit::textEdited, this, &SourceDestinationWidget::destinationChanged);
@@ -78,6 +72,29 @@ SourceDestinationWidget::SourceDestinationWidget(QWidget * parent)
 /** @brief Destroy the SourceDestinationWidget. */
 SourceDestinationWidget::~SourceDestinationWidget() = default;
 
+/**
+ * @brief Set the lister used to complete remote paths.
+ *
+ * @param lister The lister, or @b nullptr to complete only local paths. It must
+ * outlive the widget.
+ */
+void SourceDestinationWidget::setRemoteLister(RemoteLister * lister)
+{
+    m_sourceCompleter->setRemoteLister(lister, m_remoteTransport.get());
+    m_destinationCompleter->setRemoteLister(lister, m_remoteTransport.get());
+}
+
+/**
+ * @brief Set the transport settings used to complete remote paths.
+ *
+ * @param preset The preset whose remote shell and daemon settings are used. The
+ * settings are copied.
+ */
+void SourceDestinationWidget::setRemoteTransport(const Preset & preset)
+{
+    m_remoteTransport->assignSettings(preset);
+}
+
 /**
  * @brief Fetch the current source.
  *
@@ -97,7 +114,6 @@ void SourceDestinationWidget::setSource(const QString & src)
 {
     if(src != m_ui->source->text()) {
         m_ui->source->setText(src);
-        qobject_cast<QFileSystemModel *>(m_ui->source->completer()->model())->setRootPath(QFileInfo(src).absolutePath());
         Q_EMIT sourceChanged(src);
     }
 }
@@ -121,7 +137,6 @@ void SourceDestinationWidget::setDestination(const QString & dest)
 {
     if(dest != m_ui->destination->text()) {
         m_ui->destination->setText(dest);
-        qobject_cast<QFileSystemModel *>(m_ui->destination->completer()->model())->setRootPath(QFileInfo(dest).absolutePath());
         Q_EMIT destinationChanged(dest);
     }
 }
@@ -14,11 +14,17 @@
 
 #include <QtWidgets/QWidget>
 
+#include "directorylister.h"
+
 namespace Qync {
 	namespace Ui {
 		class SourceDestinationWidget;
 	}
 
+	class PathCompleter;
+	class Preset;
+	class RemoteLister;
+
 	class SourceDestinationWidget
 	: public QWidget {
 		Q_OBJECT
@@ -33,6 +39,9 @@ namespace Qync {
 		void setSourceLabel(const QString &);
 		void setDestinationLabel(const QString &);
 
+		void setRemoteLister(RemoteLister *);
+		void setRemoteTransport(const Preset &);
+
 	Q_SIGNALS:
 		void sourceChanged(const QString &);
 		void destinationChanged(const QString &);
@@ -49,6 +58,16 @@ namespace Qync {
 
 	private:
 		std::unique_ptr<Ui::SourceDestinationWidget> m_ui;
+
+		// shared by the source and destination completers
+		DirectoryLister m_lister;
+
+		// owned by the line edits
+		PathCompleter * m_sourceCompleter;
+		PathCompleter * m_destinationCompleter;
+
+		// the transport settings for remote completions
+		std::unique_ptr<Preset> m_remoteTransport;
 	};
 
 }  // namespace Qync
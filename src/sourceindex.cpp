@@ -0,0 +1,253 @@
+/**
+ * @file sourceindex.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the SourceIndex class.
+ */
+
+#include "sourceindex.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QStringBuilder>
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::SourceIndex class.
+ */
+namespace Qync::Detail::SourceIndex {
+    static constexpr const quint32 Magic = 0x51594e49;  // "QYNI"
+    static constexpr const quint32 Version = 1;
+    static constexpr const QDataStream::Version StreamVersion = QDataStream::Qt_5_9;
+}  // namespace Qync::Detail::SourceIndex
+
+/**
+ * @class SourceIndex
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief A record of the state of a local source after a successful
+ * synchronisation.
+ *
+ * The index holds the path (relative to the source), type, size and
+ * modification time of every entry in the source, as found by a SourceScanner.
+ * It is stored in a binary file, one for each distinct set of rsync arguments
+ * (see fileNameFor()), so that the index for a preset is discarded
+ * automatically when anything that affects the transfer, including the
+ * destination, is changed.
+ *
+ * On the next run, changedPaths() compares a fresh scan of the source with the
+ * index and lists the entries that rsync needs to see: those that are new or
+ * whose type, size or modification time differ. This is the same size and time
+ * check rsync uses to decide whether a file needs transferring, so as long as
+ * the destination has not been changed by anything else since the index was
+ * saved, giving rsync only those entries with --files-from has the same result
+ * as a full run. Entries that are neither files nor directories (symbolic
+ * links, devices, etc.) are always listed since their details are not
+ * recorded.
+ *
+ * The index is only updated with setEntries() and save(); it is up to the
+ * caller to do so only once the synchronisation it describes has succeeded.
+ */
+
+/**
+ * @brief Create an empty index.
+ *
+ * @param fileName The file the index is loaded from and saved to.
+ */
+SourceIndex::SourceIndex(QString fileName)
+:   m_fileName(std::move(fileName)),
+    m_entries()
+{
+}
+
+/**
+ * @brief Work out the file for the index of a synchronisation.
+ *
+ * @param rsyncArgs The full rsync arguments for the synchronisation, including
+ * the source and destination.
+ *
+ * The name is a hash of the arguments, in the "indexes" directory under the
+ * application's data location.
+ *
+ * @return The path to the index file.
+ */
+QString SourceIndex::fileNameFor(const QStringList & rsyncArgs)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    for(const auto & arg : rsyncArgs) {
+        hash.addData(arg.toUtf8());
+        hash.addData("\0", 1);
+    }
+
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) % "/indexes/" % QString::fromLatin1(hash.result().toHex()) % ".idx";
+}
+
+/**
+ * @brief Load the index from its file.
+ *
+ * If the file does not exist or is not a valid index, the index is left empty.
+ *
+ * @return @b true if the index was loaded, @b false otherwise.
+ */
+bool SourceIndex::load()
+{
+    m_entries.clear();
+    QFile file(m_fileName);
+
+    if(!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(Detail::SourceIndex::StreamVersion);
+    quint32 magic;
+    quint32 version;
+    qint32 count;
+    in >> magic >> version >> count;
+
+    if(QDataStream::Ok != in.status() || Detail::SourceIndex::Magic != magic || Detail::SourceIndex::Version != version || 0 > count) {
+        qWarning() << __PRETTY_FUNCTION__ << m_fileName << "is not a valid source index";
+        return false;
+    }
+
+    m_entries.reserve(count);
+
+    for(qint32 index = 0; index < count; ++index) {
+        QString path;
+        quint8 type;
+        Record record;
+        in >> path >> type >> record.size >> record.modified;
+
+        if(QDataStream::Ok != in.status() || static_cast<quint8>(Entry::Type::Other) < type) {
+            qWarning() << __PRETTY_FUNCTION__ << m_fileName << "is truncated or corrupt";
+            m_entries.clear();
+            return false;
+        }
+
+        record.type = static_cast<Entry::Type>(type);
+        m_entries.insert(path, record);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Save the index to its file.
+ *
+ * The file is replaced atomically, so an earlier index survives a failed save.
+ *
+ * @return @b true if the index was saved, @b false otherwise.
+ */
+bool SourceIndex::save() const
+{
+    if(!QDir().mkpath(QFileInfo(m_fileName).absolutePath())) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to create directory for" << m_fileName;
+        return false;
+    }
+
+    QSaveFile file(m_fileName);
+
+    if(!file.open(QIODevice::WriteOnly)) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to open" << m_fileName << ":" << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(Detail::SourceIndex::StreamVersion);
+    out << Detail::SourceIndex::Magic << Detail::SourceIndex::Version << static_cast<qint32>(m_entries.size());
+
+    for(auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+        out << it.key() << static_cast<quint8>(it->type) << it->size << it->modified;
+    }
+
+    if(QDataStream::Ok != out.status() || !file.commit()) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to write" << m_fileName << ":" << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Empty the index and delete its file.
+ *
+ * @return @b true if there is no longer an index file, @b false if it could
+ * not be deleted.
+ */
+bool SourceIndex::remove()
+{
+    m_entries.clear();
+    return !QFile::exists(m_fileName) || QFile::remove(m_fileName);
+}
+
+/**
+ * @brief Replace the content of the index.
+ *
+ * @param entries The entries from a scan of the source.
+ */
+void SourceIndex::setEntries(const std::vector<Entry> & entries)
+{
+    m_entries.clear();
+    m_entries.reserve(static_cast<int>(entries.size()));
+
+    for(const auto & entry : entries) {
+        m_entries.insert(entry.path, {entry.type, entry.size, entry.modified});
+    }
+}
+
+/**
+ * @brief List the entries that have changed since the index was saved.
+ *
+ * @param entries The entries from a fresh scan of the source.
+ *
+ * @return The paths (relative to the source) of the entries that are not in the
+ * index, or whose details differ from those in the index, in the order they
+ * appear in @b entries.
+ */
+QStringList SourceIndex::changedPaths(const std::vector<Entry> & entries) const
+{
+    QStringList paths;
+
+    for(const auto & entry : entries) {
+        auto it = m_entries.constFind(entry.path);
+
+        if(Entry::Type::Other == entry.type || m_entries.cend() == it || it->type != entry.type || it->size != entry.size || it->modified != entry.modified) {
+            paths.append(entry.path);
+        }
+    }
+
+    return paths;
+}
+
+/**
+ * @fn SourceIndex::fileName()
+ * @brief Fetch the file the index is loaded from and saved to.
+ *
+ * @return The path to the file.
+ */
+
+/**
+ * @fn SourceIndex::isEmpty()
+ * @brief Check whether the index has any entries.
+ *
+ * @return @b true if it is empty, @b false otherwise.
+ */
+
+/**
+ * @fn SourceIndex::entryCount()
+ * @brief Fetch the number of entries in the index.
+ *
+ * @return The number of entries.
+ */
@@ -0,0 +1,63 @@
+/**
+ * @file sourceindex.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the SourceIndex class.
+ */
+
+#ifndef QYNC_SOURCEINDEX_H
+#define QYNC_SOURCEINDEX_H
+
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include "sourcescanner.h"
+
+namespace Qync {
+
+	class SourceIndex {
+	public:
+		using Entry = SourceScanner::Entry;
+
+		explicit SourceIndex(QString fileName);
+
+		[[nodiscard]] static QString fileNameFor(const QStringList & rsyncArgs);
+
+		[[nodiscard]] inline const QString & fileName() const {
+			return m_fileName;
+		}
+
+		[[nodiscard]] inline bool isEmpty() const {
+			return m_entries.isEmpty();
+		}
+
+		[[nodiscard]] inline int entryCount() const {
+			return m_entries.size();
+		}
+
+		bool load();
+		bool save() const;
+		bool remove();
+
+		void setEntries(const std::vector<Entry> & entries);
+		[[nodiscard]] QStringList changedPaths(const std::vector<Entry> & entries) const;
+
+	private:
+		struct Record {
+			Entry::Type type = Entry::Type::File;
+			quint64 size = 0;
+			qint64 modified = 0;
+		};
+
+		QString m_fileName;
+		QHash<QString, Record> m_entries;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_SOURCEINDEX_H
@@ -0,0 +1,322 @@
+/**
+ * @file sourcescanner.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the SourceScanner class.
+ */
+
+#include "sourcescanner.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFileInfo>
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::SourceScanner class.
+ */
+namespace Qync::Detail::SourceScanner {
+    // the walk is mostly waiting for the file system, so a few threads help to
+    // keep its queue full but beyond that they just contend with rsync
+    static constexpr const int MaximumThreads = 4;
+
+    static constexpr const QDir::Filters EntryFilters = QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot;
+}  // namespace Qync::Detail::SourceScanner
+
+/**
+ * @class SourceScanner
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Counts the entries and bytes in a local rsync source.
+ *
+ * The scanner walks the source on a small pool of threads that share a queue
+ * of directories still to be read. Each thread reads one directory at a time,
+ * adds the sizes of its files to the totals and queues its subdirectories, so
+ * wide trees are read in parallel. Symbolic links are counted as entries but
+ * not followed and contribute no bytes.
+ *
+ * The totals are updated as each directory is read and can be read from any
+ * thread at any time, but they are only complete once isFinished() returns
+ * @b true. The finished() signal is emitted (from one of the scanning threads)
+ * when the walk is complete; it is not emitted if the scan is cancelled.
+ *
+ * The entry count includes directories as well as files, and the source
+ * directory itself, since that is what rsync counts in its file list.
+ *
+ * If setRecordEntries() is called before the scan is started, the scanner also
+ * keeps the path (relative to the source), type, size and modification time of
+ * every entry other than the source itself. They can be collected with
+ * takeEntries() once the scan is complete. They are in no particular order.
+ */
+
+/**
+ * @brief Create a new scanner.
+ *
+ * @param source The local path to scan. It can be a directory or a file.
+ * @param threadCount The number of threads to use, or 0 to choose
+ * automatically.
+ * @param parent The parent object.
+ *
+ * The scan is not started until start() is called.
+ */
+SourceScanner::SourceScanner(QString source, int threadCount, QObject * parent)
+:   QObject(parent),
+    m_source(std::move(source)),
+    m_threadCount(0 < threadCount ? threadCount : std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, Detail::SourceScanner::MaximumThreads)),
+    m_recordEntries(false),
+    m_rootLength(0),
+    m_lock(),
+    m_workAvailable(),
+    m_pending(),
+    m_busy(0),
+    m_entries(),
+    m_cancelled(false),
+    m_finished(false),
+    m_runningThreads(0),
+    m_totalBytes(0),
+    m_entryCount(0),
+    m_fileCount(0),
+    m_threads()
+{
+}
+
+/**
+ * @brief Destroy the scanner.
+ *
+ * If the scan is still in progress it is cancelled. This blocks until the
+ * scanning threads have stopped.
+ */
+SourceScanner::~SourceScanner()
+{
+    cancel();
+
+    for(auto & thread : m_threads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Check whether an rsync source can be scanned.
+ *
+ * @param source The source.
+ *
+ * @return @b true if the source is a local file or directory, @b false
+ * otherwise.
+ */
+bool SourceScanner::canScan(const QString & source)
+{
+    return !source.isEmpty() && QFileInfo::exists(source);
+}
+
+/**
+ * @brief Set whether the scanner keeps a record of each entry it finds.
+ *
+ * @param record @b true to record the entries, @b false to count them only.
+ *
+ * This must be called before start().
+ */
+void SourceScanner::setRecordEntries(bool record)
+{
+    if(!m_threads.empty()) {
+        qWarning() << __PRETTY_FUNCTION__ << "can't change whether entries are recorded once the scan has been started";
+        return;
+    }
+
+    m_recordEntries = record;
+}
+
+/**
+ * @brief Take the entries recorded by the scan.
+ *
+ * The scan must be complete. The scanner's record is emptied; the totals are
+ * not affected.
+ *
+ * @return The entries, or an empty set if setRecordEntries() was not called.
+ */
+std::vector<SourceScanner::Entry> SourceScanner::takeEntries()
+{
+    Q_ASSERT_X(isFinished(), __PRETTY_FUNCTION__, "the scan is not complete");
+    std::lock_guard<std::mutex> lock(m_lock);
+    return std::exchange(m_entries, {});
+}
+
+/**
+ * @brief Start scanning.
+ */
+void SourceScanner::start()
+{
+    Q_ASSERT_X(m_threads.empty(), __PRETTY_FUNCTION__, "the scanner has already been started");
+    QFileInfo info(m_source);
+    m_entryCount = 1;
+
+    if(info.isDir() && !info.isSymLink()) {
+        m_pending.push_back(info.absoluteFilePath());
+        m_rootLength = m_pending.back().length() + (m_pending.back().endsWith('/') ? 0 : 1);
+    }
+    else if(info.isFile() && !info.isSymLink()) {
+        // nothing to walk; the threads will see an empty queue and finish straight away
+        m_fileCount = 1;
+        m_totalBytes = static_cast<quint64>(info.size());
+    }
+
+    m_runningThreads = m_threadCount;
+
+    for(int index = 0; index < m_threadCount; ++index) {
+        m_threads.emplace_back(&SourceScanner::run, this);
+    }
+}
+
+/**
+ * @brief Stop scanning.
+ *
+ * The totals are left incomplete and finished() is not emitted. This does not
+ * wait for the threads to stop.
+ */
+void SourceScanner::cancel()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_cancelled = true;
+    }
+
+    m_workAvailable.notify_all();
+}
+
+/**
+ * @brief A scanning thread.
+ */
+void SourceScanner::run()
+{
+    std::vector<QString> subdirectories;
+    std::vector<Entry> entryRecords;
+
+    while(true) {
+        QString directory;
+
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+
+            // with nothing queued and nobody reading, no more work can appear
+            m_workAvailable.wait(lock, [this]() {
+                return m_cancelled || !m_pending.empty() || 0 == m_busy;
+            });
+
+            if(m_cancelled || m_pending.empty()) {
+                break;
+            }
+
+            directory = std::move(m_pending.back());
+            m_pending.pop_back();
+            ++m_busy;
+        }
+
+        quint64 bytes = 0;
+        quint64 entries = 0;
+        quint64 files = 0;
+        QDirIterator it(directory, Detail::SourceScanner::EntryFilters);
+
+        while(it.hasNext() && !m_cancelled.load(std::memory_order_relaxed)) {
+            it.next();
+            auto info = it.fileInfo();
+            ++entries;
+            // links are never followed, and QFileInfo only reports their targets' details
+            auto type = Entry::Type::Other;
+
+            if(!info.isSymLink() && info.isDir()) {
+                type = Entry::Type::Directory;
+                subdirectories.push_back(info.absoluteFilePath());
+            }
+            else if(!info.isSymLink() && info.isFile()) {
+                type = Entry::Type::File;
+                ++files;
+                bytes += static_cast<quint64>(info.size());
+            }
+
+            if(m_recordEntries) {
+                entryRecords.push_back({
+                  info.absoluteFilePath().mid(m_rootLength),
+                  type,
+                  (Entry::Type::File == type ? static_cast<quint64>(info.size()) : 0),
+                  (Entry::Type::Other == type ? 0 : info.lastModified().toMSecsSinceEpoch()),
+                });
+            }
+        }
+
+        m_totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+        m_entryCount.fetch_add(entries, std::memory_order_relaxed);
+        m_fileCount.fetch_add(files, std::memory_order_relaxed);
+
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            std::move(subdirectories.begin(), subdirectories.end(), std::back_inserter(m_pending));
+            std::move(entryRecords.begin(), entryRecords.end(), std::back_inserter(m_entries));
+            --m_busy;
+        }
+
+        subdirectories.clear();
+        entryRecords.clear();
+        m_workAvailable.notify_all();
+    }
+
+    // the last thread out reports the result
+    if(1 == m_runningThreads.fetch_sub(1, std::memory_order_acq_rel) && !m_cancelled) {
+        m_finished.store(true, std::memory_order_release);
+        Q_EMIT finished();
+    }
+}
+
+/**
+ * @fn SourceScanner::recordsEntries()
+ * @brief Check whether the scanner keeps a record of each entry it finds.
+ *
+ * @return @b true if it does, @b false if it only counts them.
+ */
+
+/**
+ * @fn SourceScanner::isFinished()
+ * @brief Check whether the scan is complete.
+ *
+ * @return @b true if the whole source has been scanned, @b false if it is
+ * still in progress or was cancelled.
+ */
+
+/**
+ * @fn SourceScanner::totalBytes()
+ * @brief Fetch the total size of the files found so far.
+ *
+ * @return The number of bytes.
+ */
+
+/**
+ * @fn SourceScanner::entryCount()
+ * @brief Fetch the number of entries (files, directories, links, etc.) found so
+ * far.
+ *
+ * @return The number of entries.
+ */
+
+/**
+ * @fn SourceScanner::fileCount()
+ * @brief Fetch the number of regular files found so far.
+ *
+ * @return The number of files.
+ */
+
+/**
+ * @fn SourceScanner::finished()
+ * @brief Emitted when the scan is complete.
+ *
+ * This is emitted from one of the scanning threads, so connections to it
+ * should be queued.
+ */
@@ -0,0 +1,108 @@
+/**
+ * @file sourcescanner.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the SourceScanner class.
+ */
+
+#ifndef QYNC_SOURCESCANNER_H
+#define QYNC_SOURCESCANNER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+namespace Qync {
+
+	class SourceScanner
+	: public QObject {
+		Q_OBJECT
+
+	public:
+		struct Entry {
+			enum class Type : unsigned char {
+				File = 0,
+				Directory,
+				Other,
+			};
+
+			QString path;
+			Type type = Type::File;
+			quint64 size = 0;
+			qint64 modified = 0;
+		};
+
+		explicit SourceScanner(QString source, int threadCount = 0, QObject * parent = nullptr);
+		SourceScanner(const SourceScanner &) = delete;
+		SourceScanner(SourceScanner &&) = delete;
+		void operator=(const SourceScanner &) = delete;
+		void operator=(SourceScanner &&) = delete;
+		~SourceScanner() override;
+
+		[[nodiscard]] static bool canScan(const QString & source);
+
+		[[nodiscard]] inline bool recordsEntries() const {
+			return m_recordEntries;
+		}
+
+		void setRecordEntries(bool record);
+
+		void start();
+		void cancel();
+
+		[[nodiscard]] inline bool isFinished() const {
+			return m_finished.load(std::memory_order_acquire);
+		}
+
+		[[nodiscard]] inline quint64 totalBytes() const {
+			return m_totalBytes.load(std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] inline quint64 entryCount() const {
+			return m_entryCount.load(std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] inline quint64 fileCount() const {
+			return m_fileCount.load(std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] std::vector<Entry> takeEntries();
+
+	Q_SIGNALS:
+		void finished();
+
+	private:
+		void run();
+
+		QString m_source;
+		int m_threadCount;
+		bool m_recordEntries;
+		int m_rootLength;
+
+		/* shared with the scanning threads, guarded by m_lock */
+		std::mutex m_lock;
+		std::condition_variable m_workAvailable;
+		std::vector<QString> m_pending;
+		int m_busy;
+		std::vector<Entry> m_entries;
+
+		std::atomic<bool> m_cancelled;
+		std::atomic<bool> m_finished;
+		std::atomic<int> m_runningThreads;
+		std::atomic<quint64> m_totalBytes;
+		std::atomic<quint64> m_entryCount;
+		std::atomic<quint64> m_fileCount;
+
+		std::vector<std::thread> m_threads;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_SOURCESCANNER_H
@@ -0,0 +1,106 @@
+/**
+ * @file spscqueue.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration and implementation of the SpscQueue class template.
+ */
+
+#ifndef QYNC_SPSCQUEUE_H
+#define QYNC_SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace Qync {
+
+	/**
+	 * @brief A bounded, lock-free, single-producer/single-consumer queue.
+	 *
+	 * One thread may push() and one (other) thread may pop(). The capacity is
+	 * fixed at construction (rounded up to a power of two) and all storage is
+	 * allocated up front. When the queue is full push() fails and leaves its
+	 * argument untouched, so the producer can hold on to the item and retry once
+	 * the consumer has caught up.
+	 *
+	 * @tparam T The type of item in the queue. It must be default-constructible
+	 * and move-assignable.
+	 */
+	template<typename T>
+	class SpscQueue final {
+	public:
+		explicit SpscQueue(std::size_t capacity)
+		: m_slots(roundUpToPowerOfTwo(capacity)),
+		  m_mask(m_slots.size() - 1),
+		  m_head(0),
+		  m_tail(0) {
+		}
+
+		SpscQueue(const SpscQueue &) = delete;
+		SpscQueue(SpscQueue &&) = delete;
+		void operator=(const SpscQueue &) = delete;
+		void operator=(SpscQueue &&) = delete;
+
+		[[nodiscard]] inline std::size_t capacity() const {
+			return m_slots.size();
+		}
+
+		/** @brief The number of items in the queue. Only a snapshot if the other thread is active. */
+		[[nodiscard]] inline std::size_t size() const {
+			return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+		}
+
+		[[nodiscard]] inline bool isEmpty() const {
+			return 0 == size();
+		}
+
+		/** @brief Add an item. Producer thread only. @return @b false if the queue is full. */
+		bool push(T && value) {
+			const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+
+			if(tail - m_head.load(std::memory_order_acquire) == m_slots.size()) {
+				return false;
+			}
+
+			m_slots[tail & m_mask] = std::move(value);
+			m_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		/** @brief Remove the oldest item. Consumer thread only. @return @b false if the queue is empty. */
+		bool pop(T & value) {
+			const std::size_t head = m_head.load(std::memory_order_relaxed);
+
+			if(head == m_tail.load(std::memory_order_acquire)) {
+				return false;
+			}
+
+			value = std::move(m_slots[head & m_mask]);
+			m_head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+	private:
+		static std::size_t roundUpToPowerOfTwo(std::size_t value) {
+			std::size_t ret = 1;
+
+			while(ret < value) {
+				ret <<= 1;
+			}
+
+			return ret;
+		}
+
+		std::vector<T> m_slots;
+		const std::size_t m_mask;
+
+		// keep the indices on separate cache lines so that the producer and consumer don't contend
+		alignas(64) std::atomic<std::size_t> m_head;
+		alignas(64) std::atomic<std::size_t> m_tail;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_SPSCQUEUE_H
@@ -0,0 +1,82 @@
+/**
+ * @file telemetrywriter.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the TelemetryWriter class.
+ */
+
+#include "telemetrywriter.h"
+
+#include <utility>
+
+#include "transfertelemetry.h"
+
+using namespace Qync;
+
+/**
+ * @class TelemetryWriter
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Saves a run's TransferTelemetry on a background thread.
+ *
+ * A record can hold tens of thousands of items, and writing it and then
+ * listing and removing the oldest records for the same source and destination
+ * is file I/O that doesn't need to hold up the thread that ran the process.
+ * The writer takes the finished record, saves it in its directory and prunes
+ * the directory so that only the most recent records are kept (see
+ * TransferTelemetry::prune()). The old records are only removed if the new
+ * one was saved.
+ *
+ * Start the writer with start(). The record must have been finished, so that
+ * it no longer refers to the Process's PathStore, which isn't thread safe.
+ * saved() says whether the record was saved once the writer has finished.
+ */
+
+/**
+ * @brief Create a new writer.
+ *
+ * @param telemetry The finished record to save.
+ * @param directory The directory to save it in, as given by
+ * TransferTelemetry::directoryFor().
+ * @param keep How many records to keep in the directory, including this one.
+ * @param parent The parent object.
+ */
+TelemetryWriter::TelemetryWriter(std::unique_ptr<TransferTelemetry> telemetry, QString directory, int keep, QObject * parent)
+:   QThread(parent),
+    m_telemetry(std::move(telemetry)),
+    m_directory(std::move(directory)),
+    m_keep(keep),
+    m_saved(false)
+{
+}
+
+/**
+ * @brief Destroy the writer.
+ *
+ * The writer must have finished.
+ */
+TelemetryWriter::~TelemetryWriter() = default;
+
+/**
+ * @brief Save the record and remove the oldest ones.
+ */
+void TelemetryWriter::run()
+{
+    m_saved = m_telemetry->save(m_telemetry->fileNameIn(m_directory));
+
+    if(m_saved) {
+        TransferTelemetry::prune(m_directory, m_keep);
+    }
+}
+
+/**
+ * @fn TelemetryWriter::saved()
+ * @brief Check whether the record was saved.
+ *
+ * @return @b true if the record was saved, @b false if it couldn't be or the
+ * writer hasn't finished.
+ */
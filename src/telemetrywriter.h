@@ -0,0 +1,46 @@
+/**
+ * @file telemetrywriter.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the TelemetryWriter class.
+ */
+
+#ifndef QYNC_TELEMETRYWRITER_H
+#define QYNC_TELEMETRYWRITER_H
+
+#include <memory>
+
+#include <QtCore/QString>
+#include <QtCore/QThread>
+
+namespace Qync {
+
+	class TransferTelemetry;
+
+	class TelemetryWriter
+	: public QThread {
+		Q_OBJECT
+
+	public:
+		TelemetryWriter(std::unique_ptr<TransferTelemetry> telemetry, QString directory, int keep, QObject * parent = nullptr);
+		~TelemetryWriter() override;
+
+		[[nodiscard]] inline bool saved() const {
+			return m_saved;
+		}
+
+	protected:
+		void run() override;
+
+	private:
+		std::unique_ptr<TransferTelemetry> m_telemetry;
+		QString m_directory;
+		int m_keep;
+		bool m_saved;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_TELEMETRYWRITER_H
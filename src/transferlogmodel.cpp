@@ -0,0 +1,446 @@
+/**
+ * @file transferlogmodel.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the TransferLogModel class.
+ */
+
+#include "transferlogmodel.h"
+
+#include <utility>
+
+#include <QtCore/QDebug>
+#include <QtCore/QIODevice>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QDir>
+
+#include "guipreferences.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::TransferLogModel class.
+ */
+namespace Qync::Detail::TransferLogModel {
+    // the number of items in each chunk. chunks are the unit of eviction, so
+    // the model holds between capacity() and capacity() + ChunkSize items
+    static constexpr const int ChunkSize = 4096;
+
+    // how long appended items wait before the views are told about them. this
+    // turns thousands of single-row insertions per second into a few batches
+    static constexpr const int CommitInterval = 100;
+
+    // the block size used when copying the evicted items to the output
+    static constexpr const qint64 CopyBlockSize = 64 * 1024;
+}  // namespace Qync::Detail::TransferLogModel
+
+/**
+ * @class TransferLogModel
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief A compact, bounded list model of the items processed by rsync.
+ *
+ * The model stores the path and size of each item that rsync processes. It is
+ * designed to be displayed in a QListView with uniform item sizes, so that
+ * only the visible rows are ever laid out, however many items there are.
+ *
+ * Items are stored in fixed-size chunks, each an array of the Ids of the items'
+ * paths in the Process's PathStore (see Process::pathStore()) and an array of
+ * their sizes. The paths themselves are held once, in the store, and shared
+ * with the other views of the process; the log costs 12 bytes per item, and
+ * the paths of the rows that are shown are built as they are needed.
+ *
+ * The number of items held in memory is limited by capacity(). When there are
+ * more than that, the oldest chunks are removed from the model and their paths
+ * written to a temporary file, so that writeTo() can still provide the whole
+ * history, and then released from the store. totalCount() provides the number
+ * of items ever appended and evictedCount() the number that are no longer in
+ * the model.
+ *
+ * Appended items are not inserted into the model immediately. Instead they are
+ * committed in batches a short time later, or when commit() is called.
+ */
+
+/**
+ * @brief Create an empty chunk with storage for a full set of items.
+ */
+TransferLogModel::Chunk::Chunk()
+:   paths(),
+    sizes()
+{
+    paths.reserve(Detail::TransferLogModel::ChunkSize);
+    sizes.reserve(Detail::TransferLogModel::ChunkSize);
+}
+
+/**
+ * @brief Append the paths of all the items in the chunk to a buffer, one per
+ * line.
+ *
+ * @param store The store that holds the paths.
+ * @param out The buffer.
+ */
+void TransferLogModel::Chunk::appendLines(const PathStore & store, QByteArray & out) const
+{
+    for(const auto path : paths) {
+        out.append(store.utf8Path(path));
+        out.append('\n');
+    }
+}
+
+/**
+ * @brief Create a new, empty, transfer log.
+ *
+ * @param parent The parent object.
+ *
+ * The capacity is initially GuiPreferences::DefaultTransferLogCapacity.
+ */
+TransferLogModel::TransferLogModel(QObject * parent)
+:   QAbstractListModel(parent),
+    m_paths(),
+    m_chunks(),
+    m_capacity(GuiPreferences::DefaultTransferLogCapacity),
+    m_rowCount(0),
+    m_storedCount(0),
+    m_evictedCount(0),
+    m_spill(),
+    m_spillFailed(false),
+    m_commitTimer()
+{
+    m_commitTimer.setSingleShot(true);
+    m_commitTimer.setTimerType(Qt::CoarseTimer);
+    m_commitTimer.setInterval(Detail::TransferLogModel::CommitInterval);
+    connect(&m_commitTimer, &QTimer::timeout, this, &TransferLogModel::commit);
+}
+
+/**
+ * @brief Destroy the transfer log.
+ *
+ * The paths of the items it holds are released and the temporary file for
+ * evicted items is removed.
+ */
+TransferLogModel::~TransferLogModel()
+{
+    for(const auto & chunk : m_chunks) {
+        release(chunk);
+    }
+}
+
+/**
+ * @brief Fetch the number of items in the model.
+ *
+ * @param parent The parent index. It must be invalid since this is a list model.
+ *
+ * @return The number of items.
+ */
+int TransferLogModel::rowCount(const QModelIndex & parent) const
+{
+    if(parent.isValid()) {
+        return 0;
+    }
+
+    return m_rowCount;
+}
+
+/**
+ * @brief Fetch the data for an item.
+ *
+ * @param index The index of the item.
+ * @param role The role for which the data is required.
+ *
+ * The display role provides the item's path; SizeRole provides its size in
+ * bytes and the tooltip role a description of its size.
+ *
+ * @return The data, or an invalid QVariant if the index or role is not valid.
+ */
+QVariant TransferLogModel::data(const QModelIndex & index, int role) const
+{
+    if(!index.isValid() || index.parent().isValid() || 0 != index.column() || 0 > index.row() || m_rowCount <= index.row()) {
+        return {};
+    }
+
+    // only the last chunk can be partly full, so rows map directly to chunks
+    const auto & chunk = m_chunks[static_cast<std::size_t>(index.row() / Detail::TransferLogModel::ChunkSize)];
+    int item = index.row() % Detail::TransferLogModel::ChunkSize;
+
+    switch(role) {
+        case Qt::DisplayRole:
+            return (m_paths ? m_paths->path(chunk.paths[static_cast<std::size_t>(item)]) : QString());
+
+        case SizeRole:
+            return chunk.sizes[static_cast<std::size_t>(item)];
+
+        case Qt::ToolTipRole:
+            return tr("%1 bytes").arg(chunk.sizes[static_cast<std::size_t>(item)]);
+    }
+
+    return {};
+}
+
+/**
+ * @brief Set the maximum number of items to keep in the model.
+ *
+ * @param capacity The number of items. Values outside the range accepted by
+ * GuiPreferences are clamped.
+ *
+ * If the model contains more items than the new capacity, the excess is
+ * evicted the next time items are committed.
+ */
+void TransferLogModel::setCapacity(int capacity)
+{
+    m_capacity = qBound(GuiPreferences::MinimumTransferLogCapacity, capacity, GuiPreferences::MaximumTransferLogCapacity);
+}
+
+/**
+ * @brief Set the store that holds the paths of the items.
+ *
+ * @param paths The store.
+ *
+ * The log is cleared, since the Ids of its items are only meaningful in the
+ * store they came from.
+ */
+void TransferLogModel::setPathStore(std::shared_ptr<const PathStore> paths)
+{
+    clear();
+    m_paths = std::move(paths);
+}
+
+/**
+ * @brief Add an item to the log.
+ *
+ * @param path The Id of the path of the item in the path store.
+ * @param size The size of the item in bytes.
+ */
+void TransferLogModel::append(PathStore::Id path, quint64 size)
+{
+    if(m_chunks.empty() || Detail::TransferLogModel::ChunkSize == m_chunks.back().count()) {
+        m_chunks.emplace_back();
+    }
+
+    if(m_paths) {
+        m_paths->retain(path);
+    }
+
+    auto & chunk = m_chunks.back();
+    chunk.paths.push_back(path);
+    chunk.sizes.push_back(size);
+    ++m_storedCount;
+
+    if(!m_commitTimer.isActive()) {
+        m_commitTimer.start();
+    }
+}
+
+/**
+ * @brief Insert all the appended items into the model.
+ *
+ * If the model then holds more items than its capacity, the oldest are
+ * evicted.
+ */
+void TransferLogModel::commit()
+{
+    m_commitTimer.stop();
+
+    if(m_storedCount > m_rowCount) {
+        beginInsertRows({}, m_rowCount, m_storedCount - 1);
+        m_rowCount = m_storedCount;
+        endInsertRows();
+    }
+
+    evictChunks();
+}
+
+/**
+ * @brief Remove all items from the log, including any that have been evicted.
+ */
+void TransferLogModel::clear()
+{
+    m_commitTimer.stop();
+    beginResetModel();
+
+    for(const auto & chunk : m_chunks) {
+        release(chunk);
+    }
+
+    m_chunks.clear();
+    m_rowCount = 0;
+    m_storedCount = 0;
+    m_evictedCount = 0;
+    m_spill.reset();
+    m_spillFailed = false;
+    endResetModel();
+}
+
+/**
+ * @brief Write the paths of all the items ever appended to a device, one per
+ * line.
+ *
+ * @param out The device to write to. It must be open for writing.
+ *
+ * The data is streamed a chunk at a time, so the amount of memory required
+ * does not depend on the number of items. If some evicted items could not be
+ * written to the temporary file, they are missing from the output.
+ *
+ * @return @b true if the items were written, @b false otherwise.
+ */
+bool TransferLogModel::writeTo(QIODevice & out)
+{
+    if(m_spill) {
+        if(!m_spill->flush() || !m_spill->seek(0)) {
+            qWarning() << __PRETTY_FUNCTION__ << "failed to rewind the file of evicted items";
+            return false;
+        }
+
+        QByteArray block;
+        bool ok = true;
+
+        while(ok && !m_spill->atEnd()) {
+            block = m_spill->read(Detail::TransferLogModel::CopyBlockSize);
+            ok = !block.isEmpty() && block.size() == out.write(block);
+        }
+
+        // appends always go to the end
+        m_spill->seek(m_spill->size());
+
+        if(!ok) {
+            qWarning() << __PRETTY_FUNCTION__ << "failed to copy the evicted items";
+            return false;
+        }
+    }
+
+    if(!m_paths) {
+        return m_chunks.empty();
+    }
+
+    QByteArray lines;
+
+    for(const auto & chunk : m_chunks) {
+        lines.resize(0);
+        chunk.appendLines(*m_paths, lines);
+
+        if(lines.size() != out.write(lines)) {
+            qWarning() << __PRETTY_FUNCTION__ << "failed to write the items";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Remove the oldest chunks from the model while it is over capacity.
+ */
+void TransferLogModel::evictChunks()
+{
+    // never evict the last chunk, it's the one being appended to
+    while(1 < m_chunks.size() && m_rowCount - m_chunks.front().count() >= m_capacity) {
+        const auto & chunk = m_chunks.front();
+        int count = chunk.count();
+        Q_ASSERT_X(Detail::TransferLogModel::ChunkSize == count, __PRETTY_FUNCTION__, "only the last chunk can be partly full");
+        spill(chunk);
+        release(chunk);
+
+        beginRemoveRows({}, 0, count - 1);
+        m_chunks.pop_front();
+        m_rowCount -= count;
+        m_storedCount -= count;
+        m_evictedCount += static_cast<quint64>(count);
+        endRemoveRows();
+    }
+}
+
+/**
+ * @brief Write the items in a chunk to the end of the temporary file.
+ *
+ * @param chunk The chunk to write.
+ *
+ * The temporary file is created the first time it is needed. If it can't be
+ * created or written, a warning is issued once and evicted items are then
+ * discarded.
+ *
+ * @return @b true if the items were written, @b false otherwise.
+ */
+bool TransferLogModel::spill(const Chunk & chunk)
+{
+    if(m_spillFailed || !m_paths) {
+        return false;
+    }
+
+    if(!m_spill) {
+        m_spill = std::make_unique<QTemporaryFile>(QDir::tempPath() + QStringLiteral("/qync-transferlog-XXXXXX"));
+
+        if(!m_spill->open()) {
+            qWarning() << __PRETTY_FUNCTION__ << "failed to create a temporary file for evicted items; they will not be saved";
+            m_spill.reset();
+            m_spillFailed = true;
+            return false;
+        }
+    }
+
+    QByteArray lines;
+    chunk.appendLines(*m_paths, lines);
+
+    if(lines.size() != m_spill->write(lines)) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to write evicted items to" << m_spill->fileName() << "; further evicted items will not be saved";
+        m_spillFailed = true;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Release the paths of the items in a chunk.
+ *
+ * @param chunk The chunk. Its Ids must not be used again.
+ *
+ * The log keeps a reference to the path of each item it holds, so that the
+ * path store only holds the paths of the items that haven't been evicted.
+ */
+void TransferLogModel::release(const Chunk & chunk)
+{
+    if(!m_paths) {
+        return;
+    }
+
+    for(const auto path : chunk.paths) {
+        m_paths->release(path);
+    }
+}
+
+/**
+ * @fn TransferLogModel::pathStore()
+ * @brief Fetch the store that holds the paths of the items.
+ *
+ * @return The store, or @b nullptr if it hasn't been set.
+ */
+
+/**
+ * @fn TransferLogModel::capacity()
+ * @brief Fetch the maximum number of items to keep in the model.
+ *
+ * The model can hold up to one chunk of items more than its capacity.
+ *
+ * @return The capacity.
+ */
+
+/**
+ * @fn TransferLogModel::totalCount()
+ * @brief Fetch the number of items that have been appended to the log.
+ *
+ * This includes items that have been evicted and items that have not yet been
+ * committed.
+ *
+ * @return The number of items.
+ */
+
+/**
+ * @fn TransferLogModel::evictedCount()
+ * @brief Fetch the number of items that have been removed from the model
+ * because it was over capacity.
+ *
+ * @return The number of items.
+ */
@@ -0,0 +1,102 @@
+/**
+ * @file transferlogmodel.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the TransferLogModel class.
+ */
+
+#ifndef QYNC_TRANSFERLOGMODEL_H
+#define QYNC_TRANSFERLOGMODEL_H
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QByteArray>
+#include <QtCore/QTimer>
+
+#include "pathstore.h"
+
+class QIODevice;
+class QTemporaryFile;
+
+namespace Qync {
+
+	class TransferLogModel
+	: public QAbstractListModel {
+		Q_OBJECT
+
+	public:
+		static constexpr const int SizeRole = Qt::UserRole;
+
+		explicit TransferLogModel(QObject * parent = nullptr);
+		~TransferLogModel() override;
+
+		[[nodiscard]] int rowCount(const QModelIndex & parent = {}) const override;
+		[[nodiscard]] QVariant data(const QModelIndex & index, int role = Qt::DisplayRole) const override;
+
+		[[nodiscard]] inline int capacity() const {
+			return m_capacity;
+		}
+
+		void setCapacity(int capacity);
+
+		[[nodiscard]] inline quint64 totalCount() const {
+			return m_evictedCount + static_cast<quint64>(m_storedCount);
+		}
+
+		[[nodiscard]] inline quint64 evictedCount() const {
+			return m_evictedCount;
+		}
+
+		[[nodiscard]] inline const std::shared_ptr<const PathStore> & pathStore() const {
+			return m_paths;
+		}
+
+		void setPathStore(std::shared_ptr<const PathStore> paths);
+
+		bool writeTo(QIODevice & out);
+		void clear();
+
+	public Q_SLOTS:
+		void append(PathStore::Id path, quint64 size);
+		void commit();
+
+	private:
+		struct Chunk {
+			Chunk();
+
+			[[nodiscard]] inline int count() const {
+				return static_cast<int>(sizes.size());
+			}
+
+			void appendLines(const PathStore & store, QByteArray & out) const;
+
+			std::vector<PathStore::Id> paths;
+			std::vector<quint64> sizes;
+		};
+
+		void evictChunks();
+		bool spill(const Chunk & chunk);
+		void release(const Chunk & chunk);
+
+		std::shared_ptr<const PathStore> m_paths;
+		std::deque<Chunk> m_chunks;
+		int m_capacity;
+
+		/* rows the views know about; stored rows beyond this are waiting for commit() */
+		int m_rowCount;
+		int m_storedCount;
+		quint64 m_evictedCount;
+
+		std::unique_ptr<QTemporaryFile> m_spill;
+		bool m_spillFailed;
+		QTimer m_commitTimer;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_TRANSFERLOGMODEL_H
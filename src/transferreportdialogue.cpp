@@ -0,0 +1,252 @@
+/**
+ * @file transferreportdialogue.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the TransferReportDialogue class.
+ */
+
+#include "transferreportdialogue.h"
+#include "ui_transferreportdialogue.h"
+
+#include <algorithm>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QLocale>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include "functions.h"
+#include "transfertelemetry.h"
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::TransferReportDialogue class.
+ */
+namespace Qync::Detail::TransferReportDialogue {
+    // how many of the slowest directories the report lists
+    static constexpr const std::size_t SlowestDirectoryCount = 10;
+
+    /**
+     * @brief Format a duration for display.
+     *
+     * @param msecs The duration, in milliseconds.
+     *
+     * @return The duration as hours, minutes and seconds.
+     */
+    static QString formatDuration(quint64 msecs)
+    {
+        const auto seconds = msecs / 1000;
+
+        if(3600 <= seconds) {
+            return QStringLiteral("%1:%2:%3").arg(seconds / 3600).arg((seconds / 60) % 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
+        }
+
+        if(60 <= seconds) {
+            return QStringLiteral("%1:%2").arg(seconds / 60).arg(seconds % 60, 2, 10, QChar('0'));
+        }
+
+        return QLocale().toString(static_cast<double>(msecs) / 1000.0, 'f', 1) + " s";
+    }
+
+    /**
+     * @brief Work out the average transfer speed of a run.
+     *
+     * @param summary The run's totals.
+     *
+     * @return The speed in bytes per second, or 0 if the run took no time.
+     */
+    static long double averageSpeed(const Qync::TransferTelemetry::Summary & summary)
+    {
+        if(0 == summary.duration) {
+            return 0.0L;
+        }
+
+        return static_cast<long double>(summary.transferredBytes) * 1000.0L / summary.duration;
+    }
+
+    /**
+     * @brief Build a row of an HTML table.
+     *
+     * @param label The heading for the row.
+     * @param value The content of the row.
+     *
+     * @return The HTML.
+     */
+    static QString tableRow(const QString & label, const QString & value)
+    {
+        return QStringLiteral("<tr><th align=\"left\">%1</th><td>%2</td></tr>").arg(label, value);
+    }
+}  // namespace Qync::Detail::TransferReportDialogue
+
+/**
+ * @class TransferReportDialogue
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Dialogue showing how the synchronisations of a source and destination
+ * went.
+ *
+ * The report is built from the TransferTelemetry saved by Process for each
+ * run. It shows the totals and throughput of the most recent run, the
+ * directories rsync spent most time in, and the totals of each of the runs
+ * kept so that a run that was unusually slow stands out. Only the summaries of
+ * the earlier runs are read.
+ */
+
+/**
+ * @brief Create a new TransferReportDialogue.
+ *
+ * @param parent The owner of the dialogue.
+ */
+TransferReportDialogue::TransferReportDialogue(QWidget * parent)
+:   QDialog(parent),
+    m_ui(std::make_unique<Ui::TransferReportDialogue>())
+{
+    m_ui->setupUi(this);
+    connect(m_ui->controls, &QDialogButtonBox::accepted, this, &QDialog::close);
+    connect(m_ui->controls, &QDialogButtonBox::rejected, this, &QDialog::close);
+}
+
+/**
+ * @brief Destroy the TransferReportDialogue.
+ */
+TransferReportDialogue::~TransferReportDialogue() = default;
+
+/**
+ * @brief Show the report for a source and destination.
+ *
+ * @param source The source of the synchronisations.
+ * @param destination The destination of the synchronisations.
+ */
+void TransferReportDialogue::showReport(const QString & source, const QString & destination)
+{
+    const auto runFiles = TransferTelemetry::runFiles(TransferTelemetry::directoryFor(source, destination));
+    QString html = QStringLiteral("<h3>%1</h3><p>%2</p>").arg(tr("Transfer report"), tr("%1 to %2").arg(source.toHtmlEscaped(), destination.toHtmlEscaped()));
+    TransferTelemetry latest;
+
+    if(runFiles.isEmpty()) {
+        html += QStringLiteral("<p>%1</p>").arg(tr("No synchronisation of this source and destination has been recorded yet."));
+    }
+    else if(!latest.load(runFiles.last())) {
+        html += QStringLiteral("<p>%1</p>").arg(tr("The record of the most recent synchronisation could not be read."));
+    }
+    else {
+        html += runReport(latest);
+        html += trendReport(runFiles);
+    }
+
+    m_ui->report->setHtml(html);
+}
+
+/**
+ * @brief Build the part of the report for one run.
+ *
+ * @param telemetry The run.
+ *
+ * @return The HTML.
+ */
+QString TransferReportDialogue::runReport(const TransferTelemetry & telemetry)
+{
+    using namespace Detail::TransferReportDialogue;
+    const auto & summary = telemetry.summary();
+    const QLocale locale;
+
+    QString html = QStringLiteral("<h4>%1</h4><table cellspacing=\"2\" cellpadding=\"2\">").arg(tr("Most recent synchronisation"));
+    html += tableRow(tr("Started"), locale.toString(QDateTime::fromMSecsSinceEpoch(summary.startTime), QLocale::ShortFormat));
+    html += tableRow(tr("Duration"), formatDuration(summary.duration));
+    html += tableRow(tr("rsync exit code"), QString::number(summary.exitCode));
+    html += tableRow(tr("Items listed"), locale.toString(static_cast<qulonglong>(summary.itemCount)));
+    html += tableRow(tr("Size of items listed"), formatSize(summary.listedBytes));
+    html += tableRow(tr("Transferred"), formatSize(summary.transferredBytes));
+
+    // the source scan is the only way of knowing what rsync didn't list
+    if(summary.sourceBytes >= summary.listedBytes && 0 < summary.sourceBytes) {
+        html += tableRow(tr("Skipped as up to date"), formatSize(summary.sourceBytes - summary.listedBytes));
+    }
+
+    if(0 < summary.sentBytes || 0 < summary.receivedBytes) {
+        html += tableRow(tr("Sent / received"), formatSize(summary.sentBytes) + " / " + formatSize(summary.receivedBytes));
+    }
+
+    const auto & rates = telemetry.sampleRates();
+
+    if(rates.empty()) {
+        html += tableRow(tr("Average speed"), formatSpeed(averageSpeed(summary)));
+    }
+    else {
+        const auto [minimum, maximum] = std::minmax_element(rates.cbegin(), rates.cend());
+        long double total = 0.0L;
+
+        for(const auto rate : rates) {
+            total += rate;
+        }
+
+        html += tableRow(tr("Speed (lowest / average / peak)"), formatSpeed(*minimum) + " / " + formatSpeed(total / rates.size()) + " / " + formatSpeed(*maximum));
+    }
+
+    html += QStringLiteral("</table>");
+    const auto directories = telemetry.slowestDirectories(SlowestDirectoryCount);
+
+    if(directories.empty()) {
+        return html;
+    }
+
+    html += QStringLiteral("<h4>%1</h4><table cellspacing=\"2\" cellpadding=\"2\"><tr><th align=\"left\">%2</th><th align=\"right\">%3</th><th align=\"right\">%4</th><th align=\"right\">%5</th></tr>")
+            .arg(tr("Slowest directories"), tr("Directory"), tr("Time"), tr("Items"), tr("Transferred"));
+
+    for(const auto & directory : directories) {
+        html += QStringLiteral("<tr><td>%1</td><td align=\"right\">%2</td><td align=\"right\">%3</td><td align=\"right\">%4</td></tr>")
+                .arg(directory.path.isEmpty() ? QStringLiteral(".") : directory.path.toHtmlEscaped(),
+                     formatDuration(directory.duration),
+                     locale.toString(static_cast<qulonglong>(directory.items)),
+                     formatSize(directory.bytes));
+    }
+
+    html += QStringLiteral("</table>");
+    return html;
+}
+
+/**
+ * @brief Build the part of the report comparing the runs.
+ *
+ * @param runFiles The files the runs are saved in, oldest first.
+ *
+ * @return The HTML. It's empty if there is only one run.
+ */
+QString TransferReportDialogue::trendReport(const QStringList & runFiles)
+{
+    using namespace Detail::TransferReportDialogue;
+
+    if(2 > runFiles.size()) {
+        return {};
+    }
+
+    const QLocale locale;
+    QString html = QStringLiteral("<h4>%1</h4><table cellspacing=\"2\" cellpadding=\"2\"><tr><th align=\"left\">%2</th><th align=\"right\">%3</th><th align=\"right\">%4</th><th align=\"right\">%5</th><th align=\"right\">%6</th><th align=\"right\">%7</th></tr>")
+            .arg(tr("Recent synchronisations"), tr("Started"), tr("Duration"), tr("Items"), tr("Transferred"), tr("Average speed"), tr("Exit code"));
+
+    // most recent first
+    for(auto fileName = runFiles.crbegin(); fileName != runFiles.crend(); ++fileName) {
+        TransferTelemetry run;
+
+        if(!run.load(*fileName, true)) {
+            continue;
+        }
+
+        const auto & summary = run.summary();
+        html += QStringLiteral("<tr><td>%1</td><td align=\"right\">%2</td><td align=\"right\">%3</td><td align=\"right\">%4</td><td align=\"right\">%5</td><td align=\"right\">%6</td></tr>")
+                .arg(locale.toString(QDateTime::fromMSecsSinceEpoch(summary.startTime), QLocale::ShortFormat),
+                     formatDuration(summary.duration),
+                     locale.toString(static_cast<qulonglong>(summary.itemCount)),
+                     formatSize(summary.transferredBytes),
+                     formatSpeed(averageSpeed(summary)),
+                     QString::number(summary.exitCode));
+    }
+
+    html += QStringLiteral("</table>");
+    return html;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file transferreportdialogue.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the TransferReportDialogue class.
+ */
+
+#ifndef QYNC_TRANSFERREPORTDIALOGUE_H
+#define QYNC_TRANSFERREPORTDIALOGUE_H
+
+#include <memory>
+
+#include <QtWidgets/QDialog>
+
+class QString;
+class QStringList;
+
+namespace Qync {
+
+	namespace Ui {
+		class TransferReportDialogue;
+	}
+
+	class TransferTelemetry;
+
+	class TransferReportDialogue
+	: public QDialog {
+		Q_OBJECT
+
+	public:
+		explicit TransferReportDialogue(QWidget * parent = nullptr);
+		~TransferReportDialogue() override;
+
+		void showReport(const QString & source, const QString & destination);
+
+	private:
+		[[nodiscard]] static QString runReport(const TransferTelemetry & telemetry);
+		[[nodiscard]] static QString trendReport(const QStringList & runFiles);
+
+		std::unique_ptr<Ui::TransferReportDialogue> m_ui;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_TRANSFERREPORTDIALOGUE_H
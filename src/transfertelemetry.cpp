@@ -0,0 +1,608 @@
+/**
+ * @file transfertelemetry.cpp
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Implementation of the TransferTelemetry class.
+ */
+
+#include "transfertelemetry.h"
+
+#include <algorithm>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QStringBuilder>
+
+using namespace Qync;
+
+/**
+ * @brief Implementation details for the Qync::TransferTelemetry class.
+ */
+namespace Qync::Detail::TransferTelemetry {
+    static constexpr const quint32 Magic = 0x51594e54;  // "QYNT"
+    static constexpr const quint32 Version = 2;
+
+    // version 1 has no directory totals, so they're worked out from the items
+    static constexpr const quint32 VersionWithoutDirectoryTotals = 1;
+
+    // the most items recorded individually. past this, items only count
+    // towards the summary and the totals for their directories
+    static constexpr const std::size_t MaximumItems = 100000;
+    static constexpr const QDataStream::Version StreamVersion = QDataStream::Qt_5_9;
+    static constexpr const char * const FileSuffix = ".qtl";
+
+    template<typename T>
+    static void writeColumn(QDataStream & out, const std::vector<T> & column)
+    {
+        for(const auto & value : column) {
+            out << value;
+        }
+    }
+
+    template<typename T>
+    static bool readColumn(QDataStream & in, std::vector<T> & column, quint32 count)
+    {
+        column.resize(count);
+
+        for(auto & value : column) {
+            in >> value;
+        }
+
+        return QDataStream::Ok == in.status();
+    }
+}  // namespace Qync::Detail::TransferTelemetry
+
+/**
+ * @class TransferTelemetry
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief A record of where the time and bytes went in one synchronisation.
+ *
+ * Process records one of these for every synchronisation that isn't a dry
+ * run: for each item rsync lists, its size, how many bytes of it were
+ * transferred and how long rsync spent on it, and a time series of the
+ * aggregate transfer speed. When the run finishes the totals reported by rsync
+ * are added and the record is saved in the directory for the preset's source
+ * and destination (see directoryFor()), where the most recent few runs are
+ * kept so that runs can be compared.
+ *
+ * The record is stored by column rather than by item: the directory names are
+ * stored once and each item refers to its directory by index, so the file is
+ * little more than the item names and a few numbers per item. The summary()
+ * comes first in the file, so load() can read just the summary of each run for
+ * a trend without reading any of the items.
+ *
+ * Each directory's totals are kept for all the items directly in it, but only
+ * the first Detail::TransferTelemetry::MaximumItems items of a run are
+ * recorded individually, so a run of millions of items takes a bounded amount
+ * of memory and disk space. itemCount() is the number recorded; the summary()
+ * has the number rsync listed.
+ *
+ * While the run is being recorded the items' paths are held as Ids in the
+ * Process's PathStore (see setPathStore()), which has them anyway for the
+ * process's views, rather than as strings of their own; the record keeps a
+ * reference to each one. finish() fills in the names and gives the references
+ * back.
+ *
+ * How long an item took is the time from rsync listing it to rsync listing the
+ * next one (or the end of the run), which is the only timing rsync's output
+ * gives. With Process::OutputFormat::Text the bytes transferred are the bytes
+ * of the file rsync reports having gone through, and a file that was updated
+ * with the delta-transfer algorithm counts in full; with
+ * Process::OutputFormat::Structured they are the bytes actually sent for it.
+ */
+
+/**
+ * @brief Create an empty record.
+ */
+TransferTelemetry::TransferTelemetry()
+:   m_summary(),
+    m_paths(),
+    m_directories(),
+    m_directoryItems(),
+    m_directoryTransferred(),
+    m_directoryDurations(),
+    m_itemDirectories(),
+    m_itemNames(),
+    m_itemSizes(),
+    m_itemTransferred(),
+    m_itemDurations(),
+    m_sampleTimes(),
+    m_sampleRates()
+{
+}
+
+/**
+ * @brief Work out the directory for the records of a synchronisation.
+ *
+ * @param source The source of the synchronisation.
+ * @param destination The destination of the synchronisation.
+ *
+ * Records are kept for each source and destination rather than each preset, so
+ * they survive the preset being renamed or its other settings being changed
+ * (which is usually what is worth comparing). The name is a hash of the source
+ * and destination, in the "telemetry" directory under the application's data
+ * location.
+ *
+ * @return The path to the directory.
+ */
+QString TransferTelemetry::directoryFor(const QString & source, const QString & destination)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(source.toUtf8());
+    hash.addData("\0", 1);
+    hash.addData(destination.toUtf8());
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) % "/telemetry/" % QString::fromLatin1(hash.result().toHex());
+}
+
+/**
+ * @brief List the records in a directory.
+ *
+ * @param directory The directory, as given by directoryFor().
+ *
+ * @return The absolute paths to the record files, oldest first.
+ */
+QStringList TransferTelemetry::runFiles(const QString & directory)
+{
+    const QDir dir(directory);
+    QStringList files;
+
+    // the names are the zero-padded start times, so name order is time order
+    for(const auto & name : dir.entryList({QStringLiteral("*") + Detail::TransferTelemetry::FileSuffix}, QDir::Files, QDir::Name)) {
+        files.push_back(dir.absoluteFilePath(name));
+    }
+
+    return files;
+}
+
+/**
+ * @brief Work out the file the record is saved in.
+ *
+ * @param directory The directory, as given by directoryFor().
+ *
+ * The name is the time the run started, so setStartTime() must have been
+ * called.
+ *
+ * @return The path to the file.
+ */
+QString TransferTelemetry::fileNameIn(const QString & directory) const
+{
+    return directory % '/' % QStringLiteral("%1").arg(m_summary.startTime, 13, 10, QLatin1Char('0')) % Detail::TransferTelemetry::FileSuffix;
+}
+
+/**
+ * @brief Set when the synchronisation started.
+ *
+ * @param msecsSinceEpoch The time, in milliseconds since the epoch.
+ */
+void TransferTelemetry::setStartTime(qint64 msecsSinceEpoch)
+{
+    m_summary.startTime = msecsSinceEpoch;
+}
+
+/**
+ * @brief Set the store that holds the paths of the items.
+ *
+ * @param paths The store.
+ *
+ * It must be set before any items are added. The record keeps the store until
+ * finish() is called.
+ */
+void TransferTelemetry::setPathStore(std::shared_ptr<const PathStore> paths)
+{
+    Q_ASSERT_X(0 == itemCount(), __PRETTY_FUNCTION__, "items have already been recorded");
+    m_paths.release();
+    m_paths.store = std::move(paths);
+}
+
+/**
+ * @brief Record an item rsync has dealt with.
+ *
+ * @param path The Id of the path of the item in the path store. The record
+ * takes its own reference to it.
+ * @param size The size of the item.
+ * @param transferred How many bytes of it were transferred.
+ * @param duration How long rsync spent on it, in milliseconds.
+ *
+ * An item whose path isn't in the store (e.g. because the store is full)
+ * only counts towards the summary(). Once MaximumItems have been recorded,
+ * items count towards the totals for their directory as well, but aren't
+ * recorded individually.
+ */
+void TransferTelemetry::addItem(PathStore::Id path, quint64 size, quint64 transferred, quint32 duration)
+{
+    ++m_summary.itemCount;
+    m_summary.listedBytes += size;
+    m_summary.transferredBytes += transferred;
+    const auto & store = m_paths.store;
+
+    if(!store || !store->contains(path)) {
+        return;
+    }
+
+    // a directory's own entry counts towards its parent
+    const auto parent = store->parent(path);
+    auto it = m_paths.directories.constFind(parent);
+
+    if(m_paths.directories.cend() == it) {
+        it = m_paths.directories.insert(parent, static_cast<quint32>(m_directories.size()));
+        auto directory = (PathStore::NoPath == parent ? QString() : store->path(parent));
+        directory.chop(1);
+        m_directories.push_back(directory);
+        m_directoryItems.push_back(0);
+        m_directoryTransferred.push_back(0);
+        m_directoryDurations.push_back(0);
+    }
+
+    ++m_directoryItems[*it];
+    m_directoryTransferred[*it] += transferred;
+    m_directoryDurations[*it] += duration;
+
+    if(Detail::TransferTelemetry::MaximumItems <= itemCount()) {
+        return;
+    }
+
+    store->retain(path);
+    m_paths.ids.push_back(path);
+    m_itemDirectories.push_back(*it);
+    m_itemSizes.push_back(size);
+    m_itemTransferred.push_back(transferred);
+    m_itemDurations.push_back(duration);
+}
+
+/**
+ * @brief Record the aggregate transfer speed at a point in the run.
+ *
+ * @param elapsed The time since the start of the run, in milliseconds.
+ * @param bytesPerSecond The speed.
+ */
+void TransferTelemetry::addSample(quint32 elapsed, double bytesPerSecond)
+{
+    m_sampleTimes.push_back(elapsed);
+    m_sampleRates.push_back(static_cast<float>(bytesPerSecond));
+}
+
+/**
+ * @brief Record how the synchronisation ended.
+ *
+ * @param duration How long it took, in milliseconds.
+ * @param exitCode rsync's exit code.
+ * @param sentBytes The bytes rsync reported sending.
+ * @param receivedBytes The bytes rsync reported receiving.
+ * @param sourceBytes The size of the whole source, if it was scanned, 0
+ * otherwise.
+ */
+void TransferTelemetry::finish(quint32 duration, int exitCode, quint64 sentBytes, quint64 receivedBytes, quint64 sourceBytes)
+{
+    m_summary.duration = duration;
+    m_summary.exitCode = exitCode;
+    m_summary.sentBytes = sentBytes;
+    m_summary.receivedBytes = receivedBytes;
+    m_summary.sourceBytes = sourceBytes;
+
+    if(!m_paths.store) {
+        return;
+    }
+
+    // rsync lists directories with a trailing /, and so does the record
+    m_itemNames.reserve(static_cast<int>(m_paths.ids.size()));
+
+    for(const auto path : m_paths.ids) {
+        const auto name = m_paths.store->name(path);
+        auto itemName = QString::fromUtf8(name.data(), static_cast<int>(name.size()));
+
+        if(m_paths.store->isDirectory(path)) {
+            itemName.append('/');
+        }
+
+        m_itemNames.push_back(itemName);
+    }
+
+    m_paths.release();
+}
+
+/**
+ * @brief Fetch the path of an item.
+ *
+ * @param index The index of the item, in the order they were added.
+ *
+ * The record must have been finished or loaded.
+ *
+ * @return The path, relative to the source.
+ */
+QString TransferTelemetry::itemPath(std::size_t index) const
+{
+    Q_ASSERT_X(index < itemCount(), __PRETTY_FUNCTION__, "index out of bounds");
+    const auto & directory = m_directories[static_cast<int>(m_itemDirectories[index])];
+    const auto & name = m_itemNames[static_cast<int>(index)];
+    return (directory.isEmpty() ? name : directory % '/' % name);
+}
+
+/**
+ * @brief Find the directories rsync spent the most time in.
+ *
+ * @param count The most directories to return.
+ *
+ * Only the items directly in each directory count towards it, including those
+ * that weren't recorded individually.
+ *
+ * @return The directories, slowest first.
+ */
+std::vector<TransferTelemetry::DirectoryTotals> TransferTelemetry::slowestDirectories(std::size_t count) const
+{
+    std::vector<DirectoryTotals> totals(static_cast<std::size_t>(m_directories.size()));
+
+    for(std::size_t index = 0; index < totals.size(); ++index) {
+        totals[index] = {m_directories[static_cast<int>(index)], m_directoryItems[index], m_directoryTransferred[index], m_directoryDurations[index]};
+    }
+
+    count = std::min(count, totals.size());
+
+    std::partial_sort(totals.begin(), totals.begin() + static_cast<std::ptrdiff_t>(count), totals.end(), [](const auto & first, const auto & second) {
+        return first.duration > second.duration;
+    });
+
+    totals.resize(count);
+    return totals;
+}
+
+/**
+ * @brief Save the record to a file.
+ *
+ * @param fileName The file. Its directory is created if necessary.
+ *
+ * A record that is being recorded must have been finished.
+ *
+ * @return @b true if the record was saved, @b false otherwise.
+ */
+bool TransferTelemetry::save(const QString & fileName) const
+{
+    if(!QDir().mkpath(QFileInfo(fileName).absolutePath())) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to create directory for" << fileName;
+        return false;
+    }
+
+    QSaveFile file(fileName);
+
+    if(!file.open(QIODevice::WriteOnly)) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to open" << fileName << ":" << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(Detail::TransferTelemetry::StreamVersion);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    out << Detail::TransferTelemetry::Magic << Detail::TransferTelemetry::Version;
+    out << m_summary.startTime << m_summary.duration << static_cast<qint32>(m_summary.exitCode) << m_summary.itemCount << m_summary.listedBytes << m_summary.transferredBytes << m_summary.sentBytes << m_summary.receivedBytes << m_summary.sourceBytes;
+    out << m_directories;
+    out << static_cast<quint32>(itemCount());
+    Detail::TransferTelemetry::writeColumn(out, m_itemDirectories);
+
+    for(const auto & name : m_itemNames) {
+        out << name;
+    }
+
+    Detail::TransferTelemetry::writeColumn(out, m_itemSizes);
+    Detail::TransferTelemetry::writeColumn(out, m_itemTransferred);
+    Detail::TransferTelemetry::writeColumn(out, m_itemDurations);
+    out << static_cast<quint32>(sampleCount());
+    Detail::TransferTelemetry::writeColumn(out, m_sampleTimes);
+    Detail::TransferTelemetry::writeColumn(out, m_sampleRates);
+    Detail::TransferTelemetry::writeColumn(out, m_directoryItems);
+    Detail::TransferTelemetry::writeColumn(out, m_directoryTransferred);
+    Detail::TransferTelemetry::writeColumn(out, m_directoryDurations);
+
+    if(QDataStream::Ok != out.status() || !file.commit()) {
+        qWarning() << __PRETTY_FUNCTION__ << "failed to write" << fileName << ":" << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Load a record from a file.
+ *
+ * @param fileName The file.
+ * @param summaryOnly @b true to read only the summary(), leaving the record
+ * without items or samples.
+ *
+ * @return @b true if the record was loaded, @b false if the file could not be
+ * read or is not a valid record, in which case the record is empty.
+ */
+bool TransferTelemetry::load(const QString & fileName, bool summaryOnly)
+{
+    *this = TransferTelemetry();
+    QFile file(fileName);
+
+    if(!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(Detail::TransferTelemetry::StreamVersion);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    quint32 magic;
+    quint32 version;
+    qint32 exitCode;
+    in >> magic >> version;
+
+    if(QDataStream::Ok != in.status() || Detail::TransferTelemetry::Magic != magic || (Detail::TransferTelemetry::Version != version && Detail::TransferTelemetry::VersionWithoutDirectoryTotals != version)) {
+        qWarning() << __PRETTY_FUNCTION__ << fileName << "is not a valid telemetry file";
+        return false;
+    }
+
+    in >> m_summary.startTime >> m_summary.duration >> exitCode >> m_summary.itemCount >> m_summary.listedBytes >> m_summary.transferredBytes >> m_summary.sentBytes >> m_summary.receivedBytes >> m_summary.sourceBytes;
+    m_summary.exitCode = exitCode;
+
+    if(QDataStream::Ok != in.status()) {
+        qWarning() << __PRETTY_FUNCTION__ << fileName << "is truncated or corrupt";
+        *this = TransferTelemetry();
+        return false;
+    }
+
+    if(summaryOnly) {
+        return true;
+    }
+
+    quint32 items;
+    quint32 samples;
+    in >> m_directories >> items;
+    bool ok = Detail::TransferTelemetry::readColumn(in, m_itemDirectories, items);
+
+    for(quint32 index = 0; ok && index < items; ++index) {
+        QString name;
+        in >> name;
+        m_itemNames.push_back(name);
+        ok = (QDataStream::Ok == in.status());
+    }
+
+    ok = ok && Detail::TransferTelemetry::readColumn(in, m_itemSizes, items)
+         && Detail::TransferTelemetry::readColumn(in, m_itemTransferred, items)
+         && Detail::TransferTelemetry::readColumn(in, m_itemDurations, items);
+
+    if(ok) {
+        in >> samples;
+        ok = Detail::TransferTelemetry::readColumn(in, m_sampleTimes, samples) && Detail::TransferTelemetry::readColumn(in, m_sampleRates, samples);
+    }
+
+    const auto directoryCount = static_cast<quint32>(m_directories.size());
+
+    if(ok && Detail::TransferTelemetry::Version == version) {
+        ok = Detail::TransferTelemetry::readColumn(in, m_directoryItems, directoryCount)
+             && Detail::TransferTelemetry::readColumn(in, m_directoryTransferred, directoryCount)
+             && Detail::TransferTelemetry::readColumn(in, m_directoryDurations, directoryCount);
+    }
+
+    if(!ok || std::any_of(m_itemDirectories.cbegin(), m_itemDirectories.cend(), [directoryCount](quint32 directory) { return directory >= directoryCount; })) {
+        qWarning() << __PRETTY_FUNCTION__ << fileName << "is truncated or corrupt";
+        *this = TransferTelemetry();
+        return false;
+    }
+
+    if(Detail::TransferTelemetry::VersionWithoutDirectoryTotals == version) {
+        m_directoryItems.assign(directoryCount, 0);
+        m_directoryTransferred.assign(directoryCount, 0);
+        m_directoryDurations.assign(directoryCount, 0);
+
+        for(std::size_t index = 0; index < itemCount(); ++index) {
+            const auto directory = m_itemDirectories[index];
+            ++m_directoryItems[directory];
+            m_directoryTransferred[directory] += m_itemTransferred[index];
+            m_directoryDurations[directory] += m_itemDurations[index];
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Remove all but the most recent records from a directory.
+ *
+ * @param directory The directory, as given by directoryFor().
+ * @param keep How many records to keep.
+ */
+void TransferTelemetry::prune(const QString & directory, int keep)
+{
+    const auto files = runFiles(directory);
+
+    for(int index = 0; index < files.size() - keep; ++index) {
+        if(!QFile::remove(files[index])) {
+            qWarning() << __PRETTY_FUNCTION__ << "failed to remove old telemetry file" << files[index];
+        }
+    }
+}
+
+/**
+ * @brief Move the item paths from another record.
+ *
+ * @param other The record to move them from.
+ *
+ * The references held for the paths being replaced are released.
+ *
+ * @return The paths.
+ */
+TransferTelemetry::ItemPaths & TransferTelemetry::ItemPaths::operator=(ItemPaths && other)
+{
+    release();
+    store = std::move(other.store);
+    ids = std::move(other.ids);
+    directories = std::move(other.directories);
+    return *this;
+}
+
+/**
+ * @brief Destroy the item paths, releasing the references held for them.
+ */
+TransferTelemetry::ItemPaths::~ItemPaths()
+{
+    release();
+}
+
+/**
+ * @brief Release the references held for the paths and forget the store.
+ */
+void TransferTelemetry::ItemPaths::release()
+{
+    if(store) {
+        for(const auto id : ids) {
+            store->release(id);
+        }
+    }
+
+    store.reset();
+    ids.clear();
+    directories.clear();
+}
+
+/**
+ * @fn TransferTelemetry::summary()
+ * @brief Fetch the totals for the run.
+ *
+ * The times are in milliseconds. sourceBytes is 0 unless the source was
+ * scanned; when it is known, the bytes rsync skipped because they were already
+ * up to date are sourceBytes less listedBytes.
+ *
+ * @return The summary.
+ */
+
+/**
+ * @fn TransferTelemetry::itemCount()
+ * @brief Fetch the number of items recorded individually.
+ *
+ * This is at most Detail::TransferTelemetry::MaximumItems; summary() has the
+ * number of items in the run.
+ *
+ * @return The number of items.
+ */
+
+/**
+ * @fn TransferTelemetry::sampleCount()
+ * @brief Fetch the number of transfer speed samples in the record.
+ *
+ * @return The number of samples.
+ */
+
+/**
+ * @fn TransferTelemetry::sampleTimes()
+ * @brief Fetch the time of each transfer speed sample.
+ *
+ * @return The times since the start of the run, in milliseconds.
+ */
+
+/**
+ * @fn TransferTelemetry::sampleRates()
+ * @brief Fetch the speed at each sample.
+ *
+ * @return The speeds, in bytes per second.
+ */
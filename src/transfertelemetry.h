@@ -0,0 +1,124 @@
+/**
+ * @file transfertelemetry.h
+ * @author Darren Edale
+ * @date October 2026
+ * @version 1.1.1
+ *
+ * @brief Declaration of the TransferTelemetry class.
+ */
+
+#ifndef QYNC_TRANSFERTELEMETRY_H
+#define QYNC_TRANSFERTELEMETRY_H
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include "pathstore.h"
+
+namespace Qync {
+
+	class TransferTelemetry {
+	public:
+		struct Summary {
+			qint64 startTime = 0;
+			quint32 duration = 0;
+			int exitCode = 0;
+			quint64 itemCount = 0;
+			quint64 listedBytes = 0;
+			quint64 transferredBytes = 0;
+			quint64 sentBytes = 0;
+			quint64 receivedBytes = 0;
+			quint64 sourceBytes = 0;
+		};
+
+		struct DirectoryTotals {
+			QString path;
+			quint64 items = 0;
+			quint64 bytes = 0;
+			quint64 duration = 0;
+		};
+
+		TransferTelemetry();
+
+		[[nodiscard]] static QString directoryFor(const QString & source, const QString & destination);
+		[[nodiscard]] static QStringList runFiles(const QString & directory);
+		[[nodiscard]] QString fileNameIn(const QString & directory) const;
+
+		[[nodiscard]] inline const Summary & summary() const {
+			return m_summary;
+		}
+
+		[[nodiscard]] inline std::size_t itemCount() const {
+			return m_itemSizes.size();
+		}
+
+		[[nodiscard]] inline std::size_t sampleCount() const {
+			return m_sampleTimes.size();
+		}
+
+		[[nodiscard]] inline const std::vector<quint32> & sampleTimes() const {
+			return m_sampleTimes;
+		}
+
+		[[nodiscard]] inline const std::vector<float> & sampleRates() const {
+			return m_sampleRates;
+		}
+
+		void setStartTime(qint64 msecsSinceEpoch);
+		void setPathStore(std::shared_ptr<const PathStore> paths);
+		void addItem(PathStore::Id path, quint64 size, quint64 transferred, quint32 duration);
+		void addSample(quint32 elapsed, double bytesPerSecond);
+		void finish(quint32 duration, int exitCode, quint64 sentBytes, quint64 receivedBytes, quint64 sourceBytes);
+
+		[[nodiscard]] QString itemPath(std::size_t index) const;
+		[[nodiscard]] std::vector<DirectoryTotals> slowestDirectories(std::size_t count) const;
+
+		bool save(const QString & fileName) const;
+		bool load(const QString & fileName, bool summaryOnly = false);
+		static void prune(const QString & directory, int keep);
+
+	private:
+		/* the items' paths while the run is being recorded, with a reference
+		 * to each */
+		struct ItemPaths {
+			ItemPaths() = default;
+			ItemPaths(const ItemPaths &) = delete;
+			ItemPaths(ItemPaths &&) = default;
+			ItemPaths & operator=(const ItemPaths &) = delete;
+			ItemPaths & operator=(ItemPaths && other);
+			~ItemPaths();
+
+			void release();
+
+			std::shared_ptr<const PathStore> store;
+			std::vector<PathStore::Id> ids;
+			QHash<PathStore::Id, quint32> directories;
+		};
+
+		Summary m_summary;
+		ItemPaths m_paths;
+
+		// one entry per directory in the first four columns, and one entry per
+		// recorded item in the others. the item names are only filled in by
+		// finish() or load()
+		QStringList m_directories;
+		std::vector<quint64> m_directoryItems;
+		std::vector<quint64> m_directoryTransferred;
+		std::vector<quint64> m_directoryDurations;
+		std::vector<quint32> m_itemDirectories;
+		QStringList m_itemNames;
+		std::vector<quint64> m_itemSizes;
+		std::vector<quint64> m_itemTransferred;
+		std::vector<quint32> m_itemDurations;
+
+		std::vector<quint32> m_sampleTimes;
+		std::vector<float> m_sampleRates;
+	};
+
+}  // namespace Qync
+
+#endif  // QYNC_TRANSFERTELEMETRY_H